@@ -37,11 +37,18 @@
 #include "llimagebmp.h"
 #include "llimagetga.h"
 #include "llimagej2c.h"
+#include "llimageworker.h"
 #include "lldir.h"
 #include "lldiriterator.h"
+#include "lluuid.h"
 
 // system libraries
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
 
 // doc string provided when invoking the program with --help 
 static const char USAGE[] = "\n"
@@ -86,6 +93,17 @@ static const char USAGE[] = "\n"
 "        Results in <metric>_report.csv\n"
 " -s, --image-stats\n"
 "        Output stats for each input and output image.\n"
+" -rp, --replay <trace>\n"
+"        Replay a recorded texture workload without a window. Each line of the trace is\n"
+"        <uuid> <discard> <priority> <arrival_ms>. The j2c data for each uuid is read from\n"
+"        <uuid>.j2c in the replay directory. Reports time-to-full-res percentiles, decode\n"
+"        throughput per decoder thread and cache hit rate. No input file needed.\n"
+" -rd, --replay-dir <dir>\n"
+"        Directory holding the j2c files of the replay. Default is the trace's directory.\n"
+" -t, --threads <n>\n"
+"        Number of decoder threads used by the replay. Default is 1.\n"
+" -c, --cache-size <MB>\n"
+"        Size of the cache emulated by the replay. Default is 0 (unlimited).\n"
 "\n";
 
 // true when all image loading is done. Used by metric logging thread to know when to stop the thread.
@@ -300,6 +318,303 @@ public:
 	}		
 };
 
+//----------------------------------------------------------------------------
+// Texture workload replay
+//----------------------------------------------------------------------------
+
+// One line of a replay trace
+struct ReplayRequest
+{
+	LLUUID mID;
+	S32 mDiscard;
+	F32 mPriority;
+	F64 mArrival;		// seconds since the start of the replay
+};
+
+bool replay_request_earlier(const ReplayRequest& a, const ReplayRequest& b)
+{
+	return a.mArrival < b.mArrival;
+}
+
+// Load a trace file, sorted by arrival time
+bool load_replay_trace(const std::string &trace_filename, std::vector<ReplayRequest> &requests)
+{
+	std::ifstream is(trace_filename.c_str());
+	if (!is.is_open())
+	{
+		return false;
+	}
+	std::string line;
+	S32 line_num = 0;
+	while (std::getline(is, line))
+	{
+		++line_num;
+		if (line.empty() || (line[0] == '#'))
+		{
+			continue;
+		}
+		std::istringstream fields(line);
+		std::string uuid;
+		ReplayRequest request;
+		F64 arrival_ms = 0.0;
+		if (!(fields >> uuid >> request.mDiscard >> request.mPriority >> arrival_ms) || !request.mID.set(uuid, FALSE))
+		{
+			std::cout << "Skipping malformed line " << line_num << " in " << trace_filename << std::endl;
+			continue;
+		}
+		request.mDiscard = llclamp(request.mDiscard, 0, 5);
+		request.mArrival = arrival_ms / 1000.0;
+		requests.push_back(request);
+	}
+	std::stable_sort(requests.begin(), requests.end(), replay_request_earlier);
+	return true;
+}
+
+// Byte budgeted LRU standing in for the viewer's texture cache: a request hits
+// when the bytes needed for its discard level are already held for that uuid.
+class ReplayCache
+{
+public:
+	ReplayCache(S64 max_bytes) : mMaxBytes(max_bytes), mTotalBytes(0) { }
+
+	bool fetch(const LLUUID& id, S32 bytes)
+	{
+		entry_map_t::iterator iter = mEntries.find(id);
+		if (iter != mEntries.end())
+		{
+			mLRU.splice(mLRU.end(), mLRU, iter->second.mLRU);
+			if (iter->second.mBytes >= bytes)
+			{
+				return true;
+			}
+			mTotalBytes += bytes - iter->second.mBytes;
+			iter->second.mBytes = bytes;
+		}
+		else
+		{
+			Entry& entry = mEntries[id];
+			entry.mBytes = bytes;
+			entry.mLRU = mLRU.insert(mLRU.end(), id);
+			mTotalBytes += bytes;
+		}
+		while (mMaxBytes > 0 && mTotalBytes > mMaxBytes && mLRU.size() > 1)
+		{
+			entry_map_t::iterator oldest = mEntries.find(mLRU.front());
+			mTotalBytes -= oldest->second.mBytes;
+			mEntries.erase(oldest);
+			mLRU.pop_front();
+		}
+		return false;
+	}
+
+private:
+	typedef std::list<LLUUID> lru_list_t;
+	struct Entry
+	{
+		S32 mBytes;
+		lru_list_t::iterator mLRU;
+	};
+	typedef std::map<LLUUID, Entry> entry_map_t;
+	entry_map_t mEntries;
+	lru_list_t mLRU;
+	S64 mMaxBytes;
+	S64 mTotalBytes;
+};
+
+// Decode completions, filled in by the decoder threads
+class ReplayResults
+{
+public:
+	ReplayResults(size_t count, F64 start) : mMutex(NULL), mStart(start), mCompleted(0)
+	{
+		mDone.resize(count, -1.0);
+		mPixels.resize(count, 0);
+	}
+
+	void complete(size_t index, bool success, S32 pixels)
+	{
+		F64 now = LLTimer::getTotalSeconds() - mStart;
+		LLMutexLock lock(&mMutex);
+		mDone[index] = success ? now : -1.0;
+		mPixels[index] = success ? pixels : 0;
+		++mCompleted;
+	}
+
+	size_t getCompleted()
+	{
+		LLMutexLock lock(&mMutex);
+		return mCompleted;
+	}
+
+	// Call only once all decodes have completed
+	F64 getDone(size_t index) const	{ return mDone[index]; }
+	S32 getPixels(size_t index) const	{ return mPixels[index]; }
+
+private:
+	LLMutex mMutex;
+	F64 mStart;
+	size_t mCompleted;
+	std::vector<F64> mDone;		// completion time, -1 when the decode failed
+	std::vector<S32> mPixels;
+};
+
+class ReplayResponder : public LLImageDecodeThread::Responder
+{
+public:
+	ReplayResponder(ReplayResults& results, size_t index) : mResults(results), mIndex(index) { }
+
+	virtual void completed(bool success, LLImageRaw* raw, LLImageRaw* aux)
+	{
+		S32 pixels = (success && raw) ? raw->getWidth() * raw->getHeight() : 0;
+		mResults.complete(mIndex, success, pixels);
+	}
+
+private:
+	ReplayResults& mResults;
+	size_t mIndex;
+};
+
+F64 replay_percentile(const std::vector<F64> &sorted, F32 fraction)
+{
+	if (sorted.empty())
+	{
+		return 0.0;
+	}
+	size_t index = llmin((size_t)(fraction * (sorted.size() - 1) + 0.5f), sorted.size() - 1);
+	return sorted[index];
+}
+
+// Replay a trace through LLImageJ2C and LLImageDecodeThread and print the report
+bool replay_trace(const std::string &trace_filename, const std::string &replay_dir, S32 threads, S64 cache_bytes)
+{
+	std::vector<ReplayRequest> requests;
+	if (!load_replay_trace(trace_filename, requests))
+	{
+		std::cout << "Error: Replay trace " << trace_filename << " could not be read" << std::endl;
+		return false;
+	}
+	if (requests.empty())
+	{
+		std::cout << "Replay trace " << trace_filename << " has no request" << std::endl;
+		return false;
+	}
+
+	// Read all the j2c data up front so that disk access is not part of the timing
+	std::string dir = replay_dir.empty() ? gDirUtilp->getDirName(trace_filename) : replay_dir;
+	std::string delim = gDirUtilp->getDirDelimiter();
+	typedef std::map<LLUUID, LLPointer<LLImageJ2C> > image_map_t;
+	image_map_t images;
+	std::map<LLUUID, F64> first_arrival;
+	F32 max_priority = 0.f;
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		const LLUUID& id = requests[i].mID;
+		max_priority = llmax(max_priority, requests[i].mPriority);
+		if (first_arrival.find(id) == first_arrival.end())
+		{
+			first_arrival[id] = requests[i].mArrival;
+		}
+		if (images.find(id) == images.end())
+		{
+			std::string file_name = id.asString() + ".j2c";
+			if (!dir.empty())
+			{
+				file_name = dir + delim + file_name;
+			}
+			LLPointer<LLImageJ2C> image = new LLImageJ2C;
+			if (!image->load(file_name))
+			{
+				std::cout << "Warning: " << file_name << " could not be loaded, its requests are skipped" << std::endl;
+				image = NULL;
+			}
+			images[id] = image;
+		}
+	}
+
+	threads = llmax(threads, 1);
+	LLImageDecodeThread* decode_thread = new LLImageDecodeThread(true, threads);
+	ReplayCache cache(cache_bytes);
+	const F64 start = LLTimer::getTotalSeconds();
+	ReplayResults results(requests.size(), start);
+
+	size_t next = 0;
+	size_t issued = 0;
+	S32 hits = 0;
+	while ((next < requests.size()) || (results.getCompleted() < issued))
+	{
+		F64 now = LLTimer::getTotalSeconds() - start;
+		while ((next < requests.size()) && (requests[next].mArrival <= now))
+		{
+			const ReplayRequest& request = requests[next];
+			LLImageJ2C* source = images[request.mID];
+			if (source)
+			{
+				S32 bytes = llmin(source->calcDataSize(request.mDiscard), source->getDataSize());
+				if (cache.fetch(request.mID, bytes))
+				{
+					++hits;
+				}
+				LLPointer<LLImageJ2C> image = new LLImageJ2C;
+				image->copyData(source->getData(), bytes);
+				image->updateData();
+				F32 priority = (max_priority > 0.f) ? request.mPriority / max_priority : 1.f;
+				U32 work_priority = LLQueuedThread::PRIORITY_NORMAL | (U32)(llclamp(priority, 0.f, 1.f) * LLQueuedThread::PRIORITY_LOWBITS);
+				decode_thread->decodeImage(image, work_priority, request.mDiscard, FALSE, new ReplayResponder(results, next));
+				++issued;
+			}
+			++next;
+		}
+		decode_thread->update(1.f);
+		ms_sleep(1);
+	}
+	const F64 elapsed = LLTimer::getTotalSeconds() - start;
+	decode_thread->shutdown();
+	delete decode_thread;
+
+	// Time to full res: from the first request for a texture to its first successful discard 0 decode
+	std::map<LLUUID, F64> full_res;
+	F64 total_pixels = 0.0;
+	S32 decodes = 0;
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		if (images[requests[i].mID].isNull() || (results.getDone(i) < 0.0))
+		{
+			continue;
+		}
+		++decodes;
+		total_pixels += results.getPixels(i);
+		if (requests[i].mDiscard == 0)
+		{
+			F64 latency = results.getDone(i) - first_arrival[requests[i].mID];
+			std::map<LLUUID, F64>::iterator iter = full_res.find(requests[i].mID);
+			if ((iter == full_res.end()) || (latency < iter->second))
+			{
+				full_res[requests[i].mID] = latency;
+			}
+		}
+	}
+	std::vector<F64> latencies;
+	for (std::map<LLUUID, F64>::iterator iter = full_res.begin(); iter != full_res.end(); ++iter)
+	{
+		latencies.push_back(iter->second);
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	std::cout << "Replay of " << trace_filename << " : " << issued << " requests, " << images.size() << " textures, "
+			  << threads << " decoder thread(s), " << elapsed << " s" << std::endl;
+	std::cout << "    time to full res (ms) : " << latencies.size() << " textures"
+			  << ", p50 : " << replay_percentile(latencies, 0.5f) * 1000.0
+			  << ", p90 : " << replay_percentile(latencies, 0.9f) * 1000.0
+			  << ", p99 : " << replay_percentile(latencies, 0.99f) * 1000.0
+			  << ", max : " << (latencies.empty() ? 0.0 : latencies.back() * 1000.0) << std::endl;
+	std::cout << "    decode throughput per thread : " << (decodes / elapsed / threads) << " decodes/s, "
+			  << (total_pixels / 1000000.0 / elapsed / threads) << " Mpixels/s ("
+			  << (issued - decodes) << " failed)" << std::endl;
+	std::cout << "    cache hit rate : " << (issued ? 100.0 * hits / issued : 0.0) << "%" << std::endl;
+
+	return true;
+}
+
 int main(int argc, char** argv)
 {
 	// List of input and output files
@@ -314,6 +629,10 @@ int main(int argc, char** argv)
 	int blocks_size = -1;
 	int levels = 0;
 	bool reversible = false;
+	std::string replay_filename;
+	std::string replay_dir;
+	int threads = 1;
+	int cache_size = 0;
 
 	// Init whatever is necessary
 	ll_init_apr();
@@ -479,6 +798,56 @@ int main(int argc, char** argv)
 		{
 			image_stats = true;
 		}
+		else if ((!strcmp(argv[arg], "--replay") || !strcmp(argv[arg], "-rp")) && arg < argc-1)
+		{
+			replay_filename = argv[arg+1];
+			arg += 1;
+		}
+		else if ((!strcmp(argv[arg], "--replay-dir") || !strcmp(argv[arg], "-rd")) && arg < argc-1)
+		{
+			replay_dir = argv[arg+1];
+			arg += 1;
+		}
+		else if (!strcmp(argv[arg], "--threads") || !strcmp(argv[arg], "-t"))
+		{
+			std::string value_str;
+			if ((arg + 1) < argc)
+			{
+				value_str = argv[arg+1];
+			}
+			if (((arg + 1) >= argc) || (value_str[0] == '-'))
+			{
+				std::cout << "No valid --threads argument given, default (1) will be used" << std::endl;
+			}
+			else
+			{
+				threads = llclamp(atoi(value_str.c_str()), 1, 32);
+			}
+		}
+		else if (!strcmp(argv[arg], "--cache-size") || !strcmp(argv[arg], "-c"))
+		{
+			std::string value_str;
+			if ((arg + 1) < argc)
+			{
+				value_str = argv[arg+1];
+			}
+			if (((arg + 1) >= argc) || (value_str[0] == '-'))
+			{
+				std::cout << "No valid --cache-size argument given, cache will be unlimited" << std::endl;
+			}
+			else
+			{
+				cache_size = llmax(atoi(value_str.c_str()), 0);
+			}
+		}
+	}
+
+	// The replay doesn't use the input and output files
+	if (!replay_filename.empty())
+	{
+		replay_trace(replay_filename, replay_dir, threads, (S64)cache_size * 1024 * 1024);
+		LLImage::cleanupClass();
+		return 0;
 	}
 		
 	// Check arguments consistency. Exit with proper message if inconsistent.
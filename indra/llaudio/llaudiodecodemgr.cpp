@@ -41,6 +41,8 @@
 #include "vorbis/codec.h"
 #include "vorbis/vorbisfile.h"
 
+#include <list>
+
 extern LLAudioEngine *gAudiop;
 
 LLAudioDecodeMgr *gAudioDecodeMgrp = NULL;
@@ -541,17 +543,74 @@ public:
 	void processQueue(const F32 num_secs = 0.005);
 
 protected:
+	// Returns TRUE once the decode's WAV has been written (or failed).
+	BOOL finishDecode(LLVorbisDecodeState* decodep);
+
+	bool isWritePending(const LLUUID& uuid) const;
+
 	LLLinkedQueue<LLUUID> mDecodeQueue;
 	LLPointer<LLVorbisDecodeState> mCurrentDecodep;
+
+	// Decoded sounds waiting on their WAV file write, so the next sound
+	// can decode in the meantime.
+	typedef std::list<LLPointer<LLVorbisDecodeState> > decode_list_t;
+	decode_list_t mWritesPending;
 };
 
 
+BOOL LLAudioDecodeMgr::Impl::finishDecode(LLVorbisDecodeState* decodep)
+{
+	if (!decodep->finishDecode())
+	{
+		return FALSE;
+	}
+
+	// We finished!
+	if (decodep->isValid() && decodep->isDone())
+	{
+		LLAudioData *adp = gAudiop->getAudioData(decodep->getUUID());
+		adp->setHasDecodedData(TRUE);
+		adp->setHasValidData(TRUE);
+
+		// At this point, we could see if anyone needs this sound immediately, but
+		// I'm not sure that there's a reason to - we need to poll all of the playing
+		// sounds anyway.
+		//llinfos << "Finished the vorbis decode, now what?" << llendl;
+	}
+	else
+	{
+		llinfos << "Vorbis decode failed!!!" << llendl;
+	}
+	return TRUE;
+}
+
+bool LLAudioDecodeMgr::Impl::isWritePending(const LLUUID& uuid) const
+{
+	for (decode_list_t::const_iterator iter = mWritesPending.begin(); iter != mWritesPending.end(); ++iter)
+	{
+		if ((*iter)->getUUID() == uuid)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 void LLAudioDecodeMgr::Impl::processQueue(const F32 num_secs)
 {
 	LLUUID uuid;
 
 	LLTimer decode_timer;
 
+	for (decode_list_t::iterator iter = mWritesPending.begin(); iter != mWritesPending.end(); )
+	{
+		decode_list_t::iterator cur = iter++;
+		if (finishDecode(*cur))
+		{
+			mWritesPending.erase(cur);
+		}
+	}
+
 	BOOL done = FALSE;
 	while (!done)
 	{
@@ -573,7 +632,6 @@ void LLAudioDecodeMgr::Impl::processQueue(const F32 num_secs)
 				LLAudioData *adp = gAudiop->getAudioData(mCurrentDecodep->getUUID());
 				adp->setHasValidData(FALSE);
 				mCurrentDecodep = NULL;
-				done = TRUE;
 			}
 
 			if (!res)
@@ -583,27 +641,17 @@ void LLAudioDecodeMgr::Impl::processQueue(const F32 num_secs)
 			}
 			else if (mCurrentDecodep)
 			{
-				if (mCurrentDecodep->finishDecode())
+				if (!finishDecode(mCurrentDecodep))
 				{
-					// We finished!
-					if (mCurrentDecodep->isValid() && mCurrentDecodep->isDone())
-					{
-						LLAudioData *adp = gAudiop->getAudioData(mCurrentDecodep->getUUID());
-						adp->setHasDecodedData(TRUE);
-						adp->setHasValidData(TRUE);
-
-						// At this point, we could see if anyone needs this sound immediately, but
-						// I'm not sure that there's a reason to - we need to poll all of the playing
-						// sounds anyway.
-						//llinfos << "Finished the vorbis decode, now what?" << llendl;
-					}
-					else
-					{
-						llinfos << "Vorbis decode failed!!!" << llendl;
-					}
-					mCurrentDecodep = NULL;
+					// the WAV is still being written, don't hold up the queue for it
+					mWritesPending.push_back(mCurrentDecodep);
 				}
-				done = TRUE; // done for now
+				mCurrentDecodep = NULL;
+			}
+
+			if (decode_timer.getElapsedTimeF32() >= num_secs)
+			{
+				done = TRUE;
 			}
 		}
 
@@ -618,7 +666,7 @@ void LLAudioDecodeMgr::Impl::processQueue(const F32 num_secs)
 			{
 				LLUUID uuid;
 				mDecodeQueue.pop(uuid);
-				if (gAudiop->hasDecodedFile(uuid))
+				if (gAudiop->hasDecodedFile(uuid) || isWritePending(uuid))
 				{
 					// This file has already been decoded, don't decode it again.
 					continue;
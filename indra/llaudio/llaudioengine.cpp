@@ -40,6 +40,9 @@
 #include "llaudiodecodemgr.h"
 #include "llassetstorage.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
 
 // necessary for grabbing sounds from sim (implemented in viewer)	
 extern void request_sound(const LLUUID &sound_guid);
@@ -261,8 +264,8 @@ void LLAudioEngine::idle(F32 max_decode_time)
 		}
 	}
 
-	F32 max_priority = -1.f;
-	LLAudioSource *max_sourcep = NULL; // Maximum priority source without a channel
+	// Sources without a channel that could play, by priority
+	std::vector<std::pair<F32, LLAudioSource*> > waiting_sources;
 	source_map::iterator iter;
 	for (iter = mAllSources.begin(); iter != mAllSources.end();)
 	{
@@ -289,11 +292,7 @@ void LLAudioEngine::idle(F32 max_decode_time)
 		if (!sourcep->getChannel() && sourcep->getCurrentBuffer())
 		{
 			// We could potentially play this sound if its priority is high enough.
-			if (sourcep->getPriority() > max_priority)
-			{
-				max_priority = sourcep->getPriority();
-				max_sourcep = sourcep;
-			}
+			waiting_sources.push_back(std::make_pair(sourcep->getPriority(), sourcep));
 		}
 
 		// Move on to the next source
@@ -301,11 +300,22 @@ void LLAudioEngine::idle(F32 max_decode_time)
 	}
 
 	// Now, do priority-based organization of audio sources.
-	// All channels used, check priorities.
-	// Find channel with lowest priority
-	if (max_sourcep)
-	{
-		LLAudioChannel *channelp = getFreeChannel(max_priority);
+	// Hand out idle channels highest priority first; once they're all in
+	// use, let the best remaining source replace the lowest priority one.
+	std::sort(waiting_sources.begin(), waiting_sources.end(), std::greater<std::pair<F32, LLAudioSource*> >());
+	for (std::vector<std::pair<F32, LLAudioSource*> >::iterator waiting_iter = waiting_sources.begin();
+		 waiting_iter != waiting_sources.end();
+		 ++waiting_iter)
+	{
+		LLAudioSource *max_sourcep = waiting_iter->second;
+		LLAudioChannel *channelp = getIdleChannel();
+		bool replaced = false;
+		if (!channelp)
+		{
+			channelp = getFreeChannel(waiting_iter->first);
+			replaced = true;
+		}
+
 		if (channelp)
 		{
 			//llinfos << "Replacing source in channel due to priority!" << llendl;
@@ -323,6 +333,13 @@ void LLAudioEngine::idle(F32 max_decode_time)
 				channelp->play();
 			}
 		}
+
+		if (replaced)
+		{
+			// the rest have lower priority still, and one replacement per
+			// frame keeps sounds of equal priority from trading channels
+			break;
+		}
 	}
 
 	
@@ -558,6 +575,21 @@ void LLAudioEngine::enableWind(bool enable)
 }
 
 
+U32 LLAudioEngine::getBufferBytes()
+{
+	U32 bytes = 0;
+	for (S32 i = 0; i < MAX_BUFFERS; i++)
+	{
+		if (mBuffers[i])
+		{
+			// lengths are in samples of 16 bit mono
+			bytes += mBuffers[i]->getLength() * 2;
+		}
+	}
+	return bytes;
+}
+
+
 LLAudioBuffer * LLAudioEngine::getFreeBuffer()
 {
 	S32 i;
@@ -604,28 +636,10 @@ LLAudioBuffer * LLAudioEngine::getFreeBuffer()
 
 LLAudioChannel * LLAudioEngine::getFreeChannel(const F32 priority)
 {
-	S32 i;
-	for (i = 0; i < mNumChannels; i++)
+	LLAudioChannel *idle_channelp = getIdleChannel();
+	if (idle_channelp)
 	{
-		if (!mChannels[i])
-		{
-			// No channel allocated here, use it.
-			mChannels[i] = createChannel();
-			return mChannels[i];
-		}
-		else
-		{
-			// Channel is allocated but not playing right now, use it.
-			if (!mChannels[i]->isPlaying() && !mChannels[i]->isWaiting())
-			{
-				mChannels[i]->cleanup();
-				if (mChannels[i]->getSource())
-				{
-					mChannels[i]->getSource()->setChannel(NULL);
-				}
-				return mChannels[i];
-			}
-		}
+		return idle_channelp;
 	}
 
 	// All channels used, check priorities.
@@ -633,6 +647,7 @@ LLAudioChannel * LLAudioEngine::getFreeChannel(const F32 priority)
 	F32 min_priority = 10000.f;
 	LLAudioChannel *min_channelp = NULL;
 
+	S32 i;
 	for (i = 0; i < mNumChannels; i++)
 	{
 		LLAudioChannel *channelp = mChannels[i];
@@ -657,6 +672,36 @@ LLAudioChannel * LLAudioEngine::getFreeChannel(const F32 priority)
 }
 
 
+LLAudioChannel * LLAudioEngine::getIdleChannel()
+{
+	S32 i;
+	for (i = 0; i < mNumChannels; i++)
+	{
+		if (!mChannels[i])
+		{
+			// No channel allocated here, use it.
+			mChannels[i] = createChannel();
+			return mChannels[i];
+		}
+		else
+		{
+			// Channel is allocated but not playing right now, use it.
+			if (!mChannels[i]->isPlaying() && !mChannels[i]->isWaiting())
+			{
+				mChannels[i]->cleanup();
+				if (mChannels[i]->getSource())
+				{
+					mChannels[i]->getSource()->setChannel(NULL);
+				}
+				return mChannels[i];
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
 void LLAudioEngine::cleanupBuffer(LLAudioBuffer *bufferp)
 {
 	S32 i;
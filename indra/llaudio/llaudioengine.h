@@ -170,7 +170,9 @@ public:
 
 	LLAudioBuffer *getFreeBuffer(); // Get a free buffer, or flush an existing one if you have to.
 	LLAudioChannel *getFreeChannel(const F32 priority); // Get a free channel or flush an existing one if your priority is higher
+	LLAudioChannel *getIdleChannel(); // Get a channel that isn't playing anything, or NULL
 	void cleanupBuffer(LLAudioBuffer *bufferp);
+	U32 getBufferBytes(); // decoded sound held by all buffers
 
 	bool hasDecodedFile(const LLUUID &uuid);
 	bool hasLocalFile(const LLUUID &uuid);
@@ -355,9 +355,10 @@ const char *LLAnimationLibrary::animStateToString( const LLUUID& state )
 	{
 		return NULL;
 	}
-	if (mAnimMap.count(state))
+	anim_map_t::const_iterator iter = mAnimMap.find(state);
+	if (iter != mAnimMap.end())
 	{
-		return mAnimMap[state];
+		return iter->second;
 	}
 
 	return NULL;
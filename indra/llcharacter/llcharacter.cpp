@@ -35,7 +35,7 @@
 
 #define SKEL_HEADER "Linden Skeleton 1.0"
 
-LLStringTable LLCharacter::sVisualParamNames(1024);
+LLStringInterner LLCharacter::sVisualParamNames(1024);
 
 std::vector< LLCharacter* > LLCharacter::sInstances;
 BOOL LLCharacter::sAllowInstancesChange = TRUE ;
@@ -49,7 +49,8 @@ LLCharacter::LLCharacter()
 	mPreferredPelvisHeight( 0.f ),
 	mSex( SEX_FEMALE ),
 	mAppearanceSerialNum( 0 ),
-	mSkeletonSerialNum( 0 )
+	mSkeletonSerialNum( 0 ),
+	mAnimationLOD( ANIM_LOD_FULL )
 {
 	llassert_always(sAllowInstancesChange) ;
 	sInstances.push_back(this);
@@ -190,7 +191,7 @@ void LLCharacter::requestStopMotion( LLMotion* motion)
 static LLFastTimer::DeclareTimer FTM_UPDATE_ANIMATION("Update Animation");
 static LLFastTimer::DeclareTimer FTM_UPDATE_HIDDEN_ANIMATION("Update Hidden Anim");
 
-void LLCharacter::updateMotions(e_update_t update_type)
+void LLCharacter::updateMotions(e_update_t update_type, bool defer_blend)
 {
 	if (update_type == HIDDEN_UPDATE)
 	{
@@ -206,7 +207,7 @@ void LLCharacter::updateMotions(e_update_t update_type)
 			mMotionController.unpauseAllMotions();
 		}
 		bool force_update = (update_type == FORCE_UPDATE);
-		mMotionController.updateMotions(force_update);
+		mMotionController.updateMotions(force_update, defer_blend);
 	}
 }
 
@@ -301,7 +302,7 @@ BOOL LLCharacter::setVisualParamWeight(const char* param_name, F32 weight, BOOL
 {
 	std::string tname(param_name);
 	LLStringUtil::toLower(tname);
-	char *tableptr = sVisualParamNames.checkString(tname);
+	const char *tableptr = sVisualParamNames.find(tname);
 	visual_param_name_map_t::iterator name_iter = mVisualParamNameMap.find(tableptr);
 	if (name_iter != mVisualParamNameMap.end())
 	{
@@ -352,7 +353,7 @@ F32 LLCharacter::getVisualParamWeight(const char* param_name)
 {
 	std::string tname(param_name);
 	LLStringUtil::toLower(tname);
-	char *tableptr = sVisualParamNames.checkString(tname);
+	const char *tableptr = sVisualParamNames.find(tname);
 	visual_param_name_map_t::iterator name_iter = mVisualParamNameMap.find(tableptr);
 	if (name_iter != mVisualParamNameMap.end())
 	{
@@ -402,7 +403,7 @@ LLVisualParam*	LLCharacter::getVisualParam(const char *param_name)
 {
 	std::string tname(param_name);
 	LLStringUtil::toLower(tname);
-	char *tableptr = sVisualParamNames.checkString(tname);
+	const char *tableptr = sVisualParamNames.find(tname);
 	visual_param_name_map_t::iterator name_iter = mVisualParamNameMap.find(tableptr);
 	if (name_iter != mVisualParamNameMap.end())
 	{
@@ -460,7 +461,7 @@ void LLCharacter::addVisualParam(LLVisualParam *param)
 		// Add name map
 		std::string tname(param->getName());
 		LLStringUtil::toLower(tname);
-		char *tableptr = sVisualParamNames.addString(tname);
+		const char *tableptr = sVisualParamNames.intern(tname);
 		std::pair<visual_param_name_map_t::iterator, bool> nameres;
 		nameres = mVisualParamNameMap.insert(visual_param_name_map_t::value_type(tableptr, param));
 		if (!nameres.second)
@@ -160,7 +160,8 @@ public:
 	
 	// periodic update function, steps the motion controller
 	enum e_update_t { NORMAL_UPDATE, HIDDEN_UPDATE, FORCE_UPDATE };
-	void updateMotions(e_update_t update_type);
+	// defer_blend leaves the final pose blend to the motion controller's applyPendingBlend()
+	void updateMotions(e_update_t update_type, bool defer_blend = false);
 
 	LLAnimPauseRequest requestPause();
 	BOOL areAnimationsPaused() const { return mMotionController.isPaused(); }
@@ -265,6 +266,13 @@ public:
 	U32				getSkeletonSerialNum() const		{ return mSkeletonSerialNum; }
 	void			setSkeletonSerialNum( U32 num )	{ mSkeletonSerialNum = num; }
 
+	// animation level of detail, chosen by the owner from screen size
+	// ANIM_LOD_REDUCED and up drop detail motions (LLMotion::isDetailMotion)
+	// ANIM_LOD_CORE and up only evaluate keyframe rotations and the root joint
+	enum { ANIM_LOD_FULL = 0, ANIM_LOD_REDUCED, ANIM_LOD_CORE, ANIM_LOD_LOWEST };
+	S32				getAnimationLOD() const				{ return mAnimationLOD; }
+	void			setAnimationLOD( S32 lod )			{ mAnimationLOD = lod; }
+
 	static std::vector< LLCharacter* > sInstances;
 	static BOOL sAllowInstancesChange ; //debug use
 
@@ -278,19 +286,20 @@ protected:
 	ESex				mSex;
 	U32					mAppearanceSerialNum;
 	U32					mSkeletonSerialNum;
+	S32					mAnimationLOD;
 	LLAnimPauseRequest	mPauseRequest;
 
 
 private:
 	// visual parameter stuff
 	typedef std::map<S32, LLVisualParam *> 		visual_param_index_map_t;
-	typedef std::map<char *, LLVisualParam *> 	visual_param_name_map_t;
+	typedef std::map<const char *, LLVisualParam *> 	visual_param_name_map_t;
 
 	visual_param_index_map_t::iterator 			mCurIterator;
 	visual_param_index_map_t 					mVisualParamIndexMap;
 	visual_param_name_map_t  					mVisualParamNameMap;
 
-	static LLStringTable sVisualParamNames;	
+	static LLStringInterner sVisualParamNames;	
 };
 
 #endif // LL_LLCHARACTER_H
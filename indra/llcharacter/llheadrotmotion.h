@@ -78,6 +78,8 @@ public:
 	// called to determine when a motion should be activated/deactivated based on avatar pixel coverage
 	virtual F32 getMinPixelArea() { return MIN_REQUIRED_PIXEL_AREA_HEAD_ROT; }
 
+	virtual BOOL isDetailMotion() { return TRUE; }
+
 	// motions must report their priority
 	virtual LLJoint::JointPriority getPriority() { return LLJoint::MEDIUM_PRIORITY; }
 
@@ -161,6 +163,8 @@ public:
 	// called to determine when a motion should be activated/deactivated based on avatar pixel coverage
 	virtual F32 getMinPixelArea() { return MIN_REQUIRED_PIXEL_AREA_EYE; }
 
+	virtual BOOL isDetailMotion() { return TRUE; }
+
 	// motions must report their priority
 	virtual LLJoint::JointPriority getPriority() { return LLJoint::MEDIUM_PRIORITY; }
 
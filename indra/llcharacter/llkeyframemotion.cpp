@@ -37,8 +37,10 @@
 #include "llcriticaldamp.h"
 #include "lldir.h"
 #include "llendianswizzle.h"
+#include "llframetimer.h"
 #include "llkeyframemotion.h"
 #include "llquantize.h"
+#include "llvector4a.h"
 #include "llvfile.h"
 #include "m3math.h"
 #include "message.h"
@@ -47,6 +49,8 @@
 // Static Definitions
 //-----------------------------------------------------------------------------
 LLVFS*				LLKeyframeMotion::sVFS = NULL;
+U32					LLKeyframeMotion::sDecodeFrame = 0;
+F32					LLKeyframeMotion::sDecodeTime = 0.f;
 LLKeyframeDataCache::keyframe_data_map_t	LLKeyframeDataCache::sKeyframeDataMap;
 
 //-----------------------------------------------------------------------------
@@ -57,6 +61,7 @@ static S32 MAX_ITERATIONS = 20;
 static S32 MIN_ITERATIONS = 1;
 static S32 MIN_ITERATION_COUNT = 2;
 static F32 MAX_PIXEL_AREA_CONSTRAINTS = 80000.f;
+static F32 MAX_DECODE_TIME_PER_FRAME = 0.002f;
 static F32 MIN_PIXEL_AREA_CONSTRAINTS = 1000.f;
 static F32 MIN_ACCELERATION_SQUARED = 0.0005f * 0.0005f;
 
@@ -371,6 +376,148 @@ LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, Po
 }
 
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// CompiledCurves class
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+LLKeyframeMotion::CompiledCurves::CompiledCurves()
+	: mPelvisIndex(-1)
+{
+	for (U32 i = 0; i < NUM_CURVE_TYPES; i++)
+	{
+		mValues[i] = NULL;
+	}
+}
+
+LLKeyframeMotion::CompiledCurves::~CompiledCurves()
+{
+	for (U32 i = 0; i < NUM_CURVE_TYPES; i++)
+	{
+		ll_aligned_free_16(mValues[i]);
+		mValues[i] = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// CompiledCurves::compile()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::CompiledCurves::compile(const std::vector<JointMotion*>& joint_motions)
+{
+	U32 num_keys[NUM_CURVE_TYPES] = { 0, 0, 0 };
+	for (U32 i = 0; i < joint_motions.size(); i++)
+	{
+		num_keys[CURVE_POSITION] += joint_motions[i]->mPositionCurve.mKeys.size();
+		num_keys[CURVE_ROTATION] += joint_motions[i]->mRotationCurve.mKeys.size();
+		num_keys[CURVE_SCALE] += joint_motions[i]->mScaleCurve.mKeys.size();
+	}
+
+	for (U32 type = 0; type < NUM_CURVE_TYPES; type++)
+	{
+		ll_aligned_free_16(mValues[type]);
+		mValues[type] = num_keys[type] ? (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a) * num_keys[type]) : NULL;
+
+		mCurves[type].resize(joint_motions.size());
+		mTimes[type].clear();
+		mTimes[type].reserve(num_keys[type]);
+	}
+
+	mPelvisIndex = -1;
+
+	for (U32 i = 0; i < joint_motions.size(); i++)
+	{
+		const JointMotion* joint_motion = joint_motions[i];
+
+		if (joint_motion->mJointName == "mPelvis")
+		{
+			mPelvisIndex = i;
+		}
+
+		Curve& pos = mCurves[CURVE_POSITION][i];
+		pos.mFirstKey = mTimes[CURVE_POSITION].size();
+		pos.mNumKeys = joint_motion->mPositionCurve.mKeys.size();
+		pos.mInterpolationType = joint_motion->mPositionCurve.mInterpolationType;
+		for (PositionCurve::key_map_t::const_iterator iter = joint_motion->mPositionCurve.mKeys.begin();
+			 iter != joint_motion->mPositionCurve.mKeys.end(); ++iter)
+		{
+			mValues[CURVE_POSITION][mTimes[CURVE_POSITION].size()].load3(iter->second.mPosition.mV);
+			mTimes[CURVE_POSITION].push_back(iter->first);
+		}
+
+		Curve& rot = mCurves[CURVE_ROTATION][i];
+		rot.mFirstKey = mTimes[CURVE_ROTATION].size();
+		rot.mNumKeys = joint_motion->mRotationCurve.mKeys.size();
+		rot.mInterpolationType = joint_motion->mRotationCurve.mInterpolationType;
+		for (RotationCurve::key_map_t::const_iterator iter = joint_motion->mRotationCurve.mKeys.begin();
+			 iter != joint_motion->mRotationCurve.mKeys.end(); ++iter)
+		{
+			mValues[CURVE_ROTATION][mTimes[CURVE_ROTATION].size()].loadua(iter->second.mRotation.mQ);
+			mTimes[CURVE_ROTATION].push_back(iter->first);
+		}
+
+		Curve& scale = mCurves[CURVE_SCALE][i];
+		scale.mFirstKey = mTimes[CURVE_SCALE].size();
+		scale.mNumKeys = joint_motion->mScaleCurve.mKeys.size();
+		scale.mInterpolationType = joint_motion->mScaleCurve.mInterpolationType;
+		for (ScaleCurve::key_map_t::const_iterator iter = joint_motion->mScaleCurve.mKeys.begin();
+			 iter != joint_motion->mScaleCurve.mKeys.end(); ++iter)
+		{
+			mValues[CURVE_SCALE][mTimes[CURVE_SCALE].size()].load3(iter->second.mScale.mV);
+			mTimes[CURVE_SCALE].push_back(iter->first);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// CompiledCurves::sample()
+// same results as the Curve::getValue() functions without the map lookups
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::CompiledCurves::sample(U32 type, U32 index, F32 time, U32& cursor, LLVector4a& value) const
+{
+	const Curve& curve = mCurves[type][index];
+	const F32* times = &mTimes[type][curve.mFirstKey];
+	const LLVector4a* values = mValues[type] + curve.mFirstKey;
+	U32 count = curve.mNumKeys;
+
+	// find the last key at or before time, starting from where the last sample
+	// left off since animations almost always move forward by a key or less
+	if (cursor >= count || times[cursor] > time)
+	{
+		cursor = 0;
+	}
+	while (cursor+1 < count && times[cursor+1] <= time)
+	{
+		cursor++;
+	}
+
+	if (cursor+1 >= count || times[cursor] >= time || curve.mInterpolationType == IT_STEP)
+	{ // before the first key, past the last, exactly on one or stepped
+		value = values[cursor];
+		return;
+	}
+
+	const LLVector4a& before = values[cursor];
+	LLVector4a after = values[cursor+1];
+	F32 u = (time - times[cursor]) / (times[cursor+1] - times[cursor]);
+
+	if (type == CURVE_ROTATION && before.dot4(after).getF32() < 0.f)
+	{ // take the short way around
+		after.mul(-1.f);
+	}
+
+	LLVector4a delta;
+	delta.setSub(after, before);
+	delta.mul(u);
+	value.setAdd(before, delta);
+
+	if (type == CURVE_ROTATION)
+	{
+		value.normalize4();
+	}
+}
+
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 // JointMotion class
@@ -457,6 +604,24 @@ LLMotion *LLKeyframeMotion::create(const LLUUID &id)
 	return new LLKeyframeMotion(id);
 }
 
+//-----------------------------------------------------------------------------
+// canDecodeThisFrame()
+// Animations arrive in bursts (an AO set, a crowd teleporting in), so their
+// decode time is capped per frame.  Playing motions share the budget, ones
+// nobody has started yet only get a frame nothing else decoded in.
+//-----------------------------------------------------------------------------
+//static
+bool LLKeyframeMotion::canDecodeThisFrame(bool playing)
+{
+	U32 frame = LLFrameTimer::getFrameCount();
+	if (frame != sDecodeFrame)
+	{
+		sDecodeFrame = frame;
+		sDecodeTime = 0.f;
+	}
+	return playing ? sDecodeTime < MAX_DECODE_TIME_PER_FRAME : sDecodeTime == 0.f;
+}
+
 //-----------------------------------------------------------------------------
 // getJointState()
 //-----------------------------------------------------------------------------
@@ -509,6 +674,9 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 		return STATUS_FAILURE;
 	case ASSET_LOADED:
 		return STATUS_SUCCESS;
+	case ASSET_DECODE_PENDING:
+		// fetched, decode below when this frame has time for it
+		break;
 	default:
 		// we don't know what state the asset is in yet, so keep going
 		// check keyframe cache first then static vfs then asset request
@@ -552,36 +720,33 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 	// Load named file by concatenating the character prefix with the motion name.
 	// Load data into a buffer to be parsed.
 	//-------------------------------------------------------------------------
-	U8 *anim_data;
+	const U8 *anim_data = NULL;
 	S32 anim_file_size;
 
+	if (!canDecodeThisFrame(!isStopped()))
+	{
+		mAssetStatus = ASSET_DECODE_PENDING;
+		return STATUS_HOLD;
+	}
+
 	if (!sVFS)
 	{
 		llerrs << "Must call LLKeyframeMotion::setVFS() first before loading a keyframe file!" << llendl;
 	}
 
-	BOOL success = FALSE;
-	LLVFile* anim_file = new LLVFile(sVFS, mID, LLAssetType::AT_ANIMATION);
-	if (!anim_file || !anim_file->getSize())
+	// parse straight out of the VFS instead of a copy
+	LLVFile anim_file(sVFS, mID, LLAssetType::AT_ANIMATION);
+	anim_file_size = anim_file.getSize();
+	if (!anim_file_size)
 	{
-		delete anim_file;
-		anim_file = NULL;
-		
 		// request asset over network on next call to load
 		mAssetStatus = ASSET_NEEDS_FETCH;
 
 		return STATUS_HOLD;
 	}
-	else
-	{
-		anim_file_size = anim_file->getSize();
-		anim_data = new U8[anim_file_size];
-		success = anim_file->read(anim_data, anim_file_size);	/*Flawfinder: ignore*/
-		delete anim_file;
-		anim_file = NULL;
-	}
 
-	if (!success)
+	anim_data = anim_file.map(anim_file_size);
+	if (!anim_data || anim_file.getLastBytesRead() != anim_file_size)
 	{
 		llwarns << "Can't open animation file " << mID << llendl;
 		mAssetStatus = ASSET_FETCH_FAILED;
@@ -590,17 +755,20 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 
 	lldebugs << "Loading keyframe data for: " << getName() << ":" << getID() << " (" << anim_file_size << " bytes)" << llendl;
 
-	LLDataPackerBinaryBuffer dp(anim_data, anim_file_size);
+	// the packer is only unpacked from, it never writes to the mapping
+	LLDataPackerBinaryBuffer dp(const_cast<U8*>(anim_data), anim_file_size);
 
-	if (!deserialize(dp))
+	LLTimer decode_timer;
+	BOOL decoded = deserialize(dp);
+	sDecodeTime += decode_timer.getElapsedTimeF32();
+
+	if (!decoded)
 	{
 		llwarns << "Failed to decode asset for animation " << getName() << ":" << getID() << llendl;
 		mAssetStatus = ASSET_FETCH_FAILED;
 		return STATUS_FAILURE;
 	}
 
-	delete []anim_data;
-
 	mAssetStatus = ASSET_LOADED;
 	return STATUS_SUCCESS;
 }
@@ -710,7 +878,10 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 
 	applyKeyframes(mLastLoopedTime);
 
-	applyConstraints(mLastLoopedTime, joint_mask);
+	if (mCharacter->getAnimationLOD() < LLCharacter::ANIM_LOD_CORE)
+	{
+		applyConstraints(mLastLoopedTime, joint_mask);
+	}
 
 	mLastUpdateTime = time;
 
@@ -723,11 +894,60 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 void LLKeyframeMotion::applyKeyframes(F32 time)
 {
 	llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
-	for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
+
+	const CompiledCurves& curves = mJointMotionList->mCompiledCurves;
+	U32 num_joint_motions = mJointMotionList->getNumJointMotions();
+	if (mKeyCursors.size() != num_joint_motions * CompiledCurves::NUM_CURVE_TYPES)
 	{
-		mJointMotionList->getJointMotion(i)->update(mJointStates[i],
-													  time, 
-													  mJointMotionList->mDuration );
+		mKeyCursors.assign(num_joint_motions * CompiledCurves::NUM_CURVE_TYPES, 0);
+	}
+
+	// at low animation LOD only rotations and the pelvis are evaluated
+	bool core_only = mCharacter->getAnimationLOD() >= LLCharacter::ANIM_LOD_CORE;
+
+	LLVector4a value;
+	LL_ALIGN_16(F32 out[4]);
+
+	for (U32 i=0; i<num_joint_motions; i++)
+	{
+		LLJointState* joint_state = mJointStates[i];
+		if (joint_state == NULL)
+		{
+			continue;
+		}
+
+		U32 usage = joint_state->getUsage();
+		U32* cursors = &mKeyCursors[i * CompiledCurves::NUM_CURVE_TYPES];
+
+		if (core_only && (S32) i != curves.mPelvisIndex)
+		{
+			usage &= LLJointState::ROT;
+		}
+
+		if ((usage & LLJointState::SCALE) && curves.hasKeys(CompiledCurves::CURVE_SCALE, i))
+		{
+			curves.sample(CompiledCurves::CURVE_SCALE, i, time, cursors[CompiledCurves::CURVE_SCALE], value);
+			joint_state->setScale(LLVector3(value.getF32ptr()));
+		}
+
+		if ((usage & LLJointState::ROT) && curves.hasKeys(CompiledCurves::CURVE_ROTATION, i))
+		{
+			curves.sample(CompiledCurves::CURVE_ROTATION, i, time, cursors[CompiledCurves::CURVE_ROTATION], value);
+			value.store4a(out);
+			LLQuaternion rot;
+			rot.mQ[VX] = out[0];
+			rot.mQ[VY] = out[1];
+			rot.mQ[VZ] = out[2];
+			rot.mQ[VW] = out[3];
+			joint_state->setRotation(rot);
+		}
+
+		if ((usage & LLJointState::POS) && curves.hasKeys(CompiledCurves::CURVE_POSITION, i))
+		{
+			curves.sample(CompiledCurves::CURVE_POSITION, i, time, cursors[CompiledCurves::CURVE_POSITION], value);
+			llassert(value.isFinite3());
+			joint_state->setPosition(LLVector3(value.getF32ptr()));
+		}
 	}
 
 	LLJoint::JointPriority* pose_priority = (LLJoint::JointPriority* )mCharacter->getAnimationData("Hand Pose Priority");
@@ -1848,6 +2068,8 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 		}
 	}
 
+	mJointMotionList->mCompiledCurves.compile(mJointMotionList->mJointMotionArray);
+
 	// *FIX: support cleanup of old keyframe data
 	LLKeyframeDataCache::addKeyframeData(getID(),  mJointMotionList);
 	mAssetStatus = ASSET_LOADED;
@@ -2155,26 +2377,11 @@ void LLKeyframeMotion::onLoadComplete(LLVFS *vfs,
 				// asset already loaded
 				return;
 			}
-			LLVFile file(vfs, asset_uuid, type, LLVFile::READ);
-			S32 size = file.getSize();
-			
-			U8* buffer = new U8[size];
-			file.read((U8*)buffer, size);	/*Flawfinder: ignore*/
-			
-			lldebugs << "Loading keyframe data for: " << motionp->getName() << ":" << motionp->getID() << " (" << size << " bytes)" << llendl;
-			
-			LLDataPackerBinaryBuffer dp(buffer, size);
-			if (motionp->deserialize(dp))
-			{
-				motionp->mAssetStatus = ASSET_LOADED;
-			}
-			else
-			{
-				llwarns << "Failed to decode asset for animation " << motionp->getName() << ":" << motionp->getID() << llendl;
-				motionp->mAssetStatus = ASSET_FETCH_FAILED;
-			}
-			
-			delete[] buffer;
+			// The asset is in the VFS now.  Leave the decode to onInitialize(),
+			// which shares a list another avatar already decoded and otherwise
+			// parses within the per frame budget instead of right here, where
+			// a burst of callbacks would all decode at once.
+			motionp->mAssetStatus = ASSET_DECODE_PENDING;
 		}
 		else
 		{
@@ -46,6 +46,7 @@
 class LLKeyframeDataCache;
 class LLVFS;
 class LLDataPacker;
+class LLVector4a;
 
 #define MIN_REQUIRED_PIXEL_AREA_KEYFRAME (40.f)
 #define MAX_CHAIN_LENGTH (4)
@@ -268,7 +269,8 @@ protected:
 	BOOL	setupPose();
 
 public:
-	enum AssetStatus { ASSET_LOADED, ASSET_FETCHED, ASSET_NEEDS_FETCH, ASSET_FETCH_FAILED, ASSET_UNDEFINED };
+	// ASSET_DECODE_PENDING: the asset is in the VFS, waiting for a frame with decode time left
+	enum AssetStatus { ASSET_LOADED, ASSET_FETCHED, ASSET_NEEDS_FETCH, ASSET_FETCH_FAILED, ASSET_UNDEFINED, ASSET_DECODE_PENDING };
 
 	enum InterpolationType { IT_STEP, IT_LINEAR, IT_SPLINE };
 
@@ -384,6 +386,45 @@ public:
 		void update(LLJointState* joint_state, F32 time, F32 duration);
 	};
 	
+	//-------------------------------------------------------------------------
+	// CompiledCurves
+	// All curves of a JointMotionList packed into contiguous key arrays, built
+	// once at load and shared through LLKeyframeDataCache by every instance
+	//-------------------------------------------------------------------------
+	class CompiledCurves
+	{
+	public:
+		enum { CURVE_POSITION = 0, CURVE_ROTATION, CURVE_SCALE, NUM_CURVE_TYPES };
+
+		struct Curve
+		{
+			U32					mFirstKey;
+			U32					mNumKeys;
+			InterpolationType	mInterpolationType;
+		};
+
+		CompiledCurves();
+		~CompiledCurves();
+
+		void compile(const std::vector<JointMotion*>& joint_motions);
+
+		// Sample curve type/index at time into value. cursor is the key the
+		// previous sample of this curve started from and is updated in place.
+		void sample(U32 type, U32 index, F32 time, U32& cursor, LLVector4a& value) const;
+
+		bool hasKeys(U32 type, U32 index) const { return mCurves[type][index].mNumKeys > 0; }
+
+		S32					mPelvisIndex;	// joint motion driving mPelvis, or -1
+
+		std::vector<Curve>	mCurves[NUM_CURVE_TYPES];	// one per joint motion
+		std::vector<F32>	mTimes[NUM_CURVE_TYPES];
+		LLVector4a*			mValues[NUM_CURVE_TYPES];	// positions and scales as xyz0, rotations as xyzw
+
+	private:
+		CompiledCurves(const CompiledCurves&);
+		CompiledCurves& operator=(const CompiledCurves&);
+	};
+
 	//-------------------------------------------------------------------------
 	// JointMotionList
 	//-------------------------------------------------------------------------
@@ -391,6 +432,7 @@ public:
 	{
 	public:
 		std::vector<JointMotion*> mJointMotionArray;
+		CompiledCurves			mCompiledCurves;
 		F32						mDuration;
 		BOOL					mLoop;
 		F32						mLoopInPoint;
@@ -417,13 +459,18 @@ public:
 
 
 protected:
+	static bool canDecodeThisFrame(bool playing);
+
 	static LLVFS*				sVFS;
+	static U32					sDecodeFrame;	// frame sDecodeTime was spent in
+	static F32					sDecodeTime;	// seconds spent deserializing this frame
 
 	//-------------------------------------------------------------------------
 	// Member Data
 	//-------------------------------------------------------------------------
 	JointMotionList*				mJointMotionList;
 	std::vector<LLPointer<LLJointState> > mJointStates;
+	std::vector<U32>				mKeyCursors;	// last key sampled per compiled curve
 	LLJoint*						mPelvisp;
 	LLCharacter*					mCharacter;
 	typedef std::list<JointConstraint*>	constraint_list_t;
@@ -135,6 +135,9 @@ public:
 	// called to determine when a motion should be activated/deactivated based on avatar pixel coverage
 	virtual F32 getMinPixelArea() = 0;
 
+	// motions that only add secondary detail, dropped once the character's animation LOD is reduced
+	virtual BOOL isDetailMotion() { return getBlendType() == ADDITIVE_BLEND; }
+
 	// run-time (post constructor) initialization,
 	// called after parameters have been set
 	// must return true to indicate success and be available for activation
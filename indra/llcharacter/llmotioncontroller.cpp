@@ -138,6 +138,8 @@ LLMotionController::LLMotionController()
 	  mTimeStep(0.f),
 	  mTimeStepCount(0),
 	  mLastInterp(0.f),
+	  mPendingBlend(BLEND_NONE),
+	  mPendingInterp(0.f),
 	  mIsSelf(FALSE)
 {
 }
@@ -601,7 +603,8 @@ void LLMotionController::updateMotionsByType(LLMotion::LLMotionBlendType anim_ty
 		LLPose *posep = motionp->getPose();
 
 		// only filter by LOD after running every animation at least once (to prime the avatar state)
-		if (mHasRunOnce && motionp->getMinPixelArea() > mCharacter->getPixelArea())
+		if (mHasRunOnce && (motionp->getMinPixelArea() > mCharacter->getPixelArea() ||
+			(mCharacter->getAnimationLOD() >= LLCharacter::ANIM_LOD_REDUCED && motionp->isDetailMotion())))
 		{
 			motionp->fadeOut();
 
@@ -798,8 +801,11 @@ void LLMotionController::updateLoadingMotions()
 //-----------------------------------------------------------------------------
 // updateMotion()
 //-----------------------------------------------------------------------------
-void LLMotionController::updateMotions(bool force_update)
+void LLMotionController::updateMotions(bool force_update, bool defer_blend)
 {
+	//a deferred blend that was never applied has to land before the motions move on
+	applyPendingBlend();
+
 	BOOL use_quantum = (mTimeStep != 0.f);
 
 	// Always update mPrevTimerElapsed
@@ -827,7 +833,15 @@ void LLMotionController::updateMotions(bool force_update)
 				if (!mPaused)
 				{
 					F32 interp = time_interval / mTimeStep;
-					mPoseBlender.interpolate(interp - mLastInterp);
+					if (defer_blend)
+					{
+						mPendingBlend = BLEND_INTERPOLATE;
+						mPendingInterp = interp - mLastInterp;
+					}
+					else
+					{
+						mPoseBlender.interpolate(interp - mLastInterp);
+					}
 					mLastInterp = interp;
 				}
 
@@ -866,7 +880,11 @@ void LLMotionController::updateMotions(bool force_update)
 		// update all regular motions
 		updateRegularMotions();
 
-		if (use_quantum)
+		if (defer_blend)
+		{
+			mPendingBlend = use_quantum ? BLEND_CACHE : BLEND_APPLY;
+		}
+		else if (use_quantum)
 		{
 			mPoseBlender.blendAndCache(TRUE);
 		}
@@ -880,12 +898,37 @@ void LLMotionController::updateMotions(bool force_update)
 //	llinfos << "Motion controller time " << motionTimer.getElapsedTimeF32() << llendl;
 }
 
+//-----------------------------------------------------------------------------
+// applyPendingBlend()
+//-----------------------------------------------------------------------------
+void LLMotionController::applyPendingBlend()
+{
+	switch (mPendingBlend)
+	{
+	case BLEND_INTERPOLATE:
+		mPoseBlender.interpolate(mPendingInterp);
+		break;
+	case BLEND_CACHE:
+		mPoseBlender.blendAndCache(TRUE);
+		break;
+	case BLEND_APPLY:
+		mPoseBlender.blendAndApply();
+		break;
+	default:
+		break;
+	}
+
+	mPendingBlend = BLEND_NONE;
+}
+
 //-----------------------------------------------------------------------------
 // updateMotionsMinimal()
 // minimal update (e.g. while hidden)
 //-----------------------------------------------------------------------------
 void LLMotionController::updateMotionsMinimal()
 {
+	applyPendingBlend();
+
 	// Always update mPrevTimerElapsed
 	mPrevTimerElapsed = mTimer.getElapsedTimeF32();
 
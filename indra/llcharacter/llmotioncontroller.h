@@ -131,7 +131,13 @@ public:
 	// invokes the update handlers for each active motion
 	// activates sequenced motions
 	// deactivates terminated motions`
-	void updateMotions(bool force_update = false);
+	// with defer_blend the final pose blend is left for applyPendingBlend()
+	void updateMotions(bool force_update = false, bool defer_blend = false);
+
+	// applies the pose blend skipped by a deferred updateMotions, touches
+	// nothing but this controller's joints so may run off the main thread
+	void applyPendingBlend();
+	bool hasPendingBlend() const { return mPendingBlend != BLEND_NONE; }
 
 	// minimal update (e.g. while hidden)
 	void updateMotionsMinimal();
@@ -220,6 +226,16 @@ protected:
 	S32					mTimeStepCount;
 	F32					mLastInterp;
 
+	enum
+	{
+		BLEND_NONE = 0,
+		BLEND_INTERPOLATE,
+		BLEND_CACHE,
+		BLEND_APPLY
+	};
+	U8					mPendingBlend;
+	F32					mPendingInterp;
+
 	U8					mJointSignature[2][LL_CHARACTER_MAX_JOINTS];
 };
 
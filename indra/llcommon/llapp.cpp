@@ -379,10 +379,14 @@ void LLApp::setErrorHandler(LLAppErrorHandler handler)
 // static
 void LLApp::runErrorHandler()
 {
+	// get the lines leading up to the crash on disk before anything else
+	LLError::flushLog();
+
 	if (LLApp::sErrorHandler)
 	{
 		LLApp::sErrorHandler();
 	}
+	LLError::flushLog();
 
 	//llinfos << "App status now STOPPED" << llendl;
 	LLApp::setStopped();
@@ -83,6 +83,8 @@ namespace {
 			
 			syslog(syslogPriority, "%s", message.c_str());
 		}
+
+		virtual bool wantsAsync() { return true; }
 	private:
 		std::string mIdentity;
 	};
@@ -108,13 +110,18 @@ namespace {
 		bool okay() { return mFile; }
 		
 		virtual bool wantsTime() { return true; }
+
+		virtual bool wantsAsync() { return true; }
 		
 		virtual void recordMessage(LLError::ELevel level,
 									const std::string& message)
 		{
-			mFile << message << std::endl;
-			// mFile.flush();
-				// *FIX: should we do this? 
+			mFile << message << '\n';
+		}
+
+		virtual void flush()
+		{
+			mFile.flush();
 		}
 	
 	private:
@@ -128,6 +135,8 @@ namespace {
 		RecordToStderr(bool timestamp) : mTimestamp(timestamp), mUseANSI(ANSI_PROBE) { }
 
 		virtual bool wantsTime() { return mTimestamp; }
+
+		virtual bool wantsAsync() { return true; }
 		
 		virtual void recordMessage(LLError::ELevel level,
 					   const std::string& message)
@@ -337,6 +346,15 @@ namespace
 	typedef std::vector<LLError::Recorder*> Recorders;
 	typedef std::vector<LLError::CallSite*> CallSiteVector;
 
+	struct TagRate
+	{
+		TagRate() : mWindowStart(0), mCount(0), mSuppressed(0) { }
+
+		U64	mWindowStart;	// microseconds
+		U32	mCount;			// lines logged in this window
+		U32	mSuppressed;	// lines held back in this window
+	};
+
 	class Globals
 	{
 	public:
@@ -386,6 +404,269 @@ namespace
 		static Globals* globals = new Globals;		
 		return *globals;
 	}
+
+
+	// Writes messages to the recorders that do blocking I/O from its own
+	// thread, so logging costs the caller a string copy instead of a write.
+	// Messages are queued while the writer is busy and written as one batch
+	// with a single flush of each recorder.
+	//
+	// queue() is only called from Log::flush(), which already holds the log
+	// lock, so the queue itself needs no more than a plain mutex.
+	// Uses raw APR rather than LLThread and LLMutex since those log.
+	class LogWriter
+	{
+	public:
+		LogWriter(U32 max_queued);
+		~LogWriter();	// writes whatever is still queued
+
+		void addTarget(LLError::Recorder* recorder);
+		void removeTarget(LLError::Recorder* recorder);
+		bool isTarget(LLError::Recorder* recorder) const;
+		const Recorders& getTargets() const { return mTargets; }
+
+		void queue(LLError::ELevel level, const std::string& time,
+				   const std::string& message);
+
+		void flush(bool wait);
+			// writes the queue from the calling thread.  Unless wait is set,
+			// gives up if the writer thread is stuck mid batch.
+
+	private:
+		struct Entry
+		{
+			LLError::ELevel	mLevel;
+			std::string		mTime;
+			std::string		mMessage;
+		};
+		typedef std::vector<Entry> Entries;
+
+		static void* APR_THREAD_FUNC run(apr_thread_t* thread, void* data);
+
+		void takeQueue(Entries& batch, U32& dropped);
+		void writeBatch(const Entries& batch, U32 dropped);	// needs mWriteMutex
+
+		apr_pool_t*				mPool;
+		apr_thread_t*			mThread;
+		apr_thread_mutex_t*		mQueueMutex;	// guards mQueue, mDropped, mQuit
+		apr_thread_cond_t*		mQueueCond;
+		apr_thread_mutex_t*		mWriteMutex;	// held while writing, guards mTargets
+
+		Entries		mQueue;
+		Entries		mBatch;			// only touched by the writer thread
+		U32			mMaxQueued;
+		U32			mDropped;		// lines dropped since the last batch
+		bool		mQuit;
+		Recorders	mTargets;
+	};
+
+	LogWriter::LogWriter(U32 max_queued)
+		:	mPool(NULL),
+			mThread(NULL),
+			mQueueMutex(NULL),
+			mQueueCond(NULL),
+			mWriteMutex(NULL),
+			mMaxQueued(llmax(max_queued, (U32)1)),
+			mDropped(0),
+			mQuit(false)
+	{
+		apr_pool_create(&mPool, NULL);
+		apr_thread_mutex_create(&mQueueMutex, APR_THREAD_MUTEX_UNNESTED, mPool);
+		apr_thread_mutex_create(&mWriteMutex, APR_THREAD_MUTEX_UNNESTED, mPool);
+		apr_thread_cond_create(&mQueueCond, mPool);
+		mQueue.reserve(mMaxQueued);
+		mBatch.reserve(mMaxQueued);
+
+		if (apr_thread_create(&mThread, NULL, run, this, mPool) != APR_SUCCESS)
+		{
+			// queue() writes synchronously without a thread
+			mThread = NULL;
+		}
+	}
+
+	LogWriter::~LogWriter()
+	{
+		if (mThread)
+		{
+			apr_thread_mutex_lock(mQueueMutex);
+			mQuit = true;
+			apr_thread_cond_signal(mQueueCond);
+			apr_thread_mutex_unlock(mQueueMutex);
+
+			apr_status_t status;
+			apr_thread_join(&status, mThread);
+		}
+		flush(true);
+
+		apr_thread_cond_destroy(mQueueCond);
+		apr_thread_mutex_destroy(mWriteMutex);
+		apr_thread_mutex_destroy(mQueueMutex);
+		apr_pool_destroy(mPool);
+	}
+
+	void LogWriter::addTarget(LLError::Recorder* recorder)
+	{
+		LLScopedLock lock(mWriteMutex);
+		mTargets.push_back(recorder);
+	}
+
+	void LogWriter::removeTarget(LLError::Recorder* recorder)
+	{
+		// anything already queued was meant for this recorder too
+		flush(true);
+
+		LLScopedLock lock(mWriteMutex);
+		mTargets.erase(std::remove(mTargets.begin(), mTargets.end(), recorder),
+					   mTargets.end());
+	}
+
+	bool LogWriter::isTarget(LLError::Recorder* recorder) const
+	{
+		return std::find(mTargets.begin(), mTargets.end(), recorder) != mTargets.end();
+	}
+
+	void LogWriter::queue(LLError::ELevel level, const std::string& time,
+						  const std::string& message)
+	{
+		apr_thread_mutex_lock(mQueueMutex);
+		if (mThread && mQueue.size() >= mMaxQueued)
+		{
+			if (level < LLError::LEVEL_WARN)
+			{
+				mDropped++;
+				apr_thread_mutex_unlock(mQueueMutex);
+				return;
+			}
+
+			// the writer can't keep up: do its work rather than lose this
+			apr_thread_mutex_unlock(mQueueMutex);
+			flush(true);
+			apr_thread_mutex_lock(mQueueMutex);
+		}
+
+		bool was_empty = mQueue.empty();
+		mQueue.push_back(Entry());
+		Entry& entry = mQueue.back();
+		entry.mLevel = level;
+		entry.mTime = time;
+		entry.mMessage = message;
+		if (was_empty)
+		{
+			// the writer only sleeps on an empty queue
+			apr_thread_cond_signal(mQueueCond);
+		}
+		apr_thread_mutex_unlock(mQueueMutex);
+
+		if (!mThread)
+		{
+			flush(true);
+		}
+	}
+
+	void LogWriter::flush(bool wait)
+	{
+		if (wait)
+		{
+			apr_thread_mutex_lock(mWriteMutex);
+		}
+		else
+		{
+			// same policy as LogLock: a few tries, then give up
+			const S32 MAX_RETRIES = 5;
+			S32 attempts = 0;
+			while (APR_STATUS_IS_EBUSY(apr_thread_mutex_trylock(mWriteMutex)))
+			{
+				if (++attempts >= MAX_RETRIES)
+				{
+					return;
+				}
+				ms_sleep(1);
+			}
+		}
+
+		Entries batch;
+		U32 dropped;
+		takeQueue(batch, dropped);
+		writeBatch(batch, dropped);
+		apr_thread_mutex_unlock(mWriteMutex);
+	}
+
+	void LogWriter::takeQueue(Entries& batch, U32& dropped)
+	{
+		apr_thread_mutex_lock(mQueueMutex);
+		batch.swap(mQueue);
+		dropped = mDropped;
+		mDropped = 0;
+		apr_thread_mutex_unlock(mQueueMutex);
+	}
+
+	void LogWriter::writeBatch(const Entries& batch, U32 dropped)
+	{
+		if (batch.empty() && !dropped)
+		{
+			return;
+		}
+
+		for (Recorders::const_iterator i = mTargets.begin(); i != mTargets.end(); ++i)
+		{
+			LLError::Recorder* r = *i;
+			bool wants_time = r->wantsTime();
+
+			for (Entries::const_iterator e = batch.begin(); e != batch.end(); ++e)
+			{
+				if (wants_time && !e->mTime.empty())
+				{
+					r->recordMessage(e->mLevel, e->mTime + " " + e->mMessage);
+				}
+				else
+				{
+					r->recordMessage(e->mLevel, e->mMessage);
+				}
+			}
+
+			if (dropped)
+			{
+				std::ostringstream out;
+				out << "WARNING: LogWriter: dropped " << dropped
+					<< " log messages, queue full";
+				r->recordMessage(LLError::LEVEL_WARN, out.str());
+			}
+
+			r->flush();
+		}
+	}
+
+	//static
+	void* APR_THREAD_FUNC LogWriter::run(apr_thread_t* thread, void* data)
+	{
+		LogWriter* self = (LogWriter*)data;
+
+		apr_thread_mutex_lock(self->mQueueMutex);
+		while (!self->mQuit)
+		{
+			if (self->mQueue.empty() && !self->mDropped)
+			{
+				apr_thread_cond_wait(self->mQueueCond, self->mQueueMutex);
+				continue;
+			}
+			apr_thread_mutex_unlock(self->mQueueMutex);
+
+			// take the queue under the write lock so a concurrent flush()
+			// can't write newer lines ahead of these
+			apr_thread_mutex_lock(self->mWriteMutex);
+			U32 dropped;
+			self->mBatch.clear();
+			self->takeQueue(self->mBatch, dropped);
+			self->writeBatch(self->mBatch, dropped);
+			apr_thread_mutex_unlock(self->mWriteMutex);
+
+			apr_thread_mutex_lock(self->mQueueMutex);
+		}
+		apr_thread_mutex_unlock(self->mQueueMutex);
+
+		apr_thread_exit(thread, APR_SUCCESS);
+		return NULL;
+	}
 }
 
 namespace LLError
@@ -410,6 +691,11 @@ namespace LLError
 		Recorder* fileRecorder;
 		Recorder* fixedBufferRecorder;
 		std::string fileRecorderFileName;
+
+		LogWriter* asyncWriter;
+			// NULL unless async logging is on
+		U32 tagRateLimit;
+		std::map<std::string, TagRate> tagRates;
 		
 		int shouldLogCallCounter;
 		
@@ -427,11 +713,15 @@ namespace LLError
 				timeFunction(NULL),
 				fileRecorder(NULL),
 				fixedBufferRecorder(NULL),
+				asyncWriter(NULL),
+				tagRateLimit(0),
 				shouldLogCallCounter(0)
 			{ }
 		
 		~Settings()
 		{
+			// the writer thread must be done with the recorders first
+			delete asyncWriter;
 			for_each(recorders.begin(), recorders.end(),
 					 DeletePointer());
 		}
@@ -708,6 +998,12 @@ namespace LLError
 		
 		setPrintLocation(config["print-location"]);
 		setDefaultLevel(decodeLevel(config["default-level"]));
+		setTagRateLimit(config["tag-rate-limit"].asInteger());
+		if (config.has("async"))
+		{
+			setAsyncLogging(config["async"].asBoolean(),
+				config.has("async-queue-size") ? config["async-queue-size"].asInteger() : 8192);
+		}
 		
 		LLSD sets = config["settings"];
 		LLSD::array_const_iterator a, end;
@@ -735,6 +1031,14 @@ namespace LLError
 	bool Recorder::wantsTime()
 		{ return false; }
 
+	// virtual
+	bool Recorder::wantsAsync()
+		{ return false; }
+
+	// virtual
+	void Recorder::flush()
+		{ }
+
 
 
 	void addRecorder(Recorder* recorder)
@@ -745,6 +1049,10 @@ namespace LLError
 		}
 		Settings& s = Settings::get();
 		s.recorders.push_back(recorder);
+		if (s.asyncWriter && recorder->wantsAsync())
+		{
+			s.asyncWriter->addTarget(recorder);
+		}
 	}
 
 	void removeRecorder(Recorder* recorder)
@@ -754,6 +1062,11 @@ namespace LLError
 			return;
 		}
 		Settings& s = Settings::get();
+		if (s.asyncWriter && s.asyncWriter->isTarget(recorder))
+		{
+			// waits for the writer, so the caller may delete the recorder
+			s.asyncWriter->removeTarget(recorder);
+		}
 		s.recorders.erase(
 			std::remove(s.recorders.begin(), s.recorders.end(), recorder),
 			s.recorders.end());
@@ -825,6 +1138,11 @@ namespace
 			++i)
 		{
 			LLError::Recorder* r = *i;
+
+			if (s.asyncWriter && s.asyncWriter->isTarget(r))
+			{
+				continue;
+			}
 			
 			if (r->wantsTime()  &&  s.timeFunction != NULL)
 			{
@@ -839,7 +1157,52 @@ namespace
 			{
 				r->recordMessage(level, message);
 			}
+			r->flush();
+		}
+
+		if (s.asyncWriter && !s.asyncWriter->getTargets().empty())
+		{
+			s.asyncWriter->queue(level,
+				s.timeFunction != NULL ? s.timeFunction() : std::string(),
+				message);
+		}
+	}
+
+	// Returns false if a DEBUG or INFO line for this tag is over the rate
+	// limit.  The first line of a new window reports what was held back.
+	bool checkTagRate(const LLError::CallSite& site)
+	{
+		LLError::Settings& s = LLError::Settings::get();
+		const char* tag = site.mNarrowTag ? site.mNarrowTag : site.mBroadTag;
+		if (!s.tagRateLimit || !tag || site.mLevel >= LLError::LEVEL_WARN)
+		{
+			return true;
+		}
+
+		const U64 WINDOW = 1000000;	// one second
+		TagRate& rate = s.tagRates[tag];
+		U64 now = totalTime();
+		if (now - rate.mWindowStart >= WINDOW)
+		{
+			if (rate.mSuppressed)
+			{
+				std::ostringstream out;
+				out << "INFO: " << tag << ": suppressed " << rate.mSuppressed
+					<< " messages over the limit of " << s.tagRateLimit << " per second";
+				writeToRecorders(LLError::LEVEL_INFO, out.str());
+			}
+			rate.mWindowStart = now;
+			rate.mCount = 0;
+			rate.mSuppressed = 0;
+		}
+
+		if (rate.mCount >= s.tagRateLimit)
+		{
+			rate.mSuppressed++;
+			return false;
 		}
+		rate.mCount++;
+		return true;
 	}
 }
 
@@ -1054,6 +1417,11 @@ namespace LLError
 			delete out;
 		}
 
+		if (!checkTagRate(site))
+		{
+			return;
+		}
+
 		if (site.mLevel == LEVEL_ERROR)
 		{
 			std::ostringstream fatalMessage;
@@ -1126,11 +1494,67 @@ namespace LLError
 		
 		if (site.mLevel == LEVEL_ERROR  &&  s.crashFunction)
 		{
+			// the crash function may never return
+			if (s.asyncWriter)
+			{
+				s.asyncWriter->flush(false);
+			}
 			s.crashFunction(message);
 		}
 	}
 }
 
+namespace LLError
+{
+	void setAsyncLogging(bool async, U32 max_queued)
+	{
+		LogLock lock;
+		if (!lock.ok())
+		{
+			return;
+		}
+
+		Settings& s = Settings::get();
+		if (async == (s.asyncWriter != NULL))
+		{
+			return;
+		}
+
+		if (!async)
+		{
+			LogWriter* writer = s.asyncWriter;
+			s.asyncWriter = NULL;
+			delete writer;
+			return;
+		}
+
+		s.asyncWriter = new LogWriter(max_queued);
+		for (Recorders::const_iterator i = s.recorders.begin(); i != s.recorders.end(); ++i)
+		{
+			if ((*i)->wantsAsync())
+			{
+				s.asyncWriter->addTarget(*i);
+			}
+		}
+	}
+
+	void setTagRateLimit(U32 lines_per_second)
+	{
+		Settings& s = Settings::get();
+		s.tagRateLimit = lines_per_second;
+		s.tagRates.clear();
+	}
+
+	void flushLog()
+	{
+		Settings& s = Settings::get();
+		if (s.asyncWriter)
+		{
+			s.asyncWriter->flush(false);
+		}
+	}
+}
+
 
 
 
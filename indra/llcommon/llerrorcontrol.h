@@ -85,6 +85,23 @@ namespace LLError
 		// the LLSD can configure all of the settings
 		// usually read automatically from the live errorlog.xml file
 
+	LL_COMMON_API void setAsyncLogging(bool async, U32 max_queued = 8192);
+		// when on, recorders that want it (the log file, stderr, syslog)
+		// are written by a background thread instead of the logging thread.
+		// Once max_queued lines are waiting, DEBUG and INFO lines are
+		// dropped (and counted) while WARN and ERROR lines are written out
+		// by the logging thread itself.
+
+	LL_COMMON_API void setTagRateLimit(U32 lines_per_second);
+		// DEBUG and INFO lines beyond this many per second for one tag are
+		// suppressed, with a count of them logged once the second is up.
+		// Zero, the default, means no limit.
+
+	LL_COMMON_API void flushLog();
+		// writes out anything the background writer still has queued, from
+		// the calling thread.  Doesn't wait long for the writer, so it is
+		// safe to call from crash handlers.
+
 
 	/*
 		Control functions.
@@ -143,6 +160,14 @@ namespace LLError
 		virtual bool wantsTime(); // default returns false
 			// override and return true if the recorder wants the time string
 			// included in the text of the message
+
+		virtual bool wantsAsync(); // default returns false
+			// override and return true if the recorder does blocking I/O
+			// and may be called from the background log writer thread
+
+		virtual void flush(); // default does nothing
+			// called after each message, or after each batch of messages
+			// when written from the background thread
 	};
 	
 	LL_COMMON_API void addRecorder(Recorder*);
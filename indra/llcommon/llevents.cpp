@@ -295,6 +295,7 @@ std::string LLEventPump::inventName(const std::string& pfx)
 void LLEventPump::reset()
 {
     mSignal.reset();
+    mListenerCache.reset();
     mConnections.clear();
     //mDeps.clear();
 }
@@ -442,9 +443,77 @@ LLBoundListener LLEventPump::listen_impl(const std::string& name, const LLEventL
     // connect it.
     LLBoundListener bound = mSignal->connect(newNode, listener);
     mConnections[name] = bound;
+    CachedListener cached(newNode, bound, listener);
+    updateListenerCache(&cached);
     return bound;
 }
 
+void LLEventPump::updateListenerCache(const CachedListener* added)
+{
+    boost::shared_ptr<ListenerCache> cache(new ListenerCache);
+    if (mListenerCache)
+    {
+        cache->mListeners.reserve(mListenerCache->mListeners.size() + 1);
+        for (std::vector<CachedListener>::const_iterator li(mListenerCache->mListeners.begin()),
+                 lend(mListenerCache->mListeners.end());
+             li != lend; ++li)
+        {
+            // drops listeners disconnected by stopListening() as well as
+            // those disconnected through their LLBoundListener
+            if (li->mConnection.connected())
+            {
+                cache->mListeners.push_back(*li);
+            }
+        }
+    }
+    if (added)
+    {
+        std::vector<CachedListener>::iterator li(cache->mListeners.begin());
+        while (li != cache->mListeners.end() && li->mNode <= added->mNode)
+        {
+            ++li;
+        }
+        cache->mListeners.insert(li, *added);
+    }
+    for (std::vector<CachedListener>::const_iterator li(cache->mListeners.begin()),
+             lend(cache->mListeners.end());
+         li != lend; ++li)
+    {
+        if (! li->mListener.tracked_objects().empty())
+        {
+            cache->mTracked = true;
+            break;
+        }
+    }
+    mListenerCache = cache;
+}
+
+bool LLEventPump::dispatch(const LLSD& event)
+{
+    // DEV-43463: a listener may end up destroying 'this' (see
+    // LLEventStream::post()), so work only from stack copies.
+    boost::shared_ptr<LLStandardSignal> signal(mSignal);
+    boost::shared_ptr<const ListenerCache> cache(mListenerCache);
+    if (! cache || cache->mTracked)
+    {
+        return (*signal)(event);
+    }
+    for (std::vector<CachedListener>::const_iterator li(cache->mListeners.begin()),
+             lend(cache->mListeners.end());
+         li != lend; ++li)
+    {
+        // checked per call: an earlier listener may have disconnected or
+        // blocked this one
+        if (li->mConnection.connected() && ! li->mConnection.blocked()
+            && li->mListener(event))
+        {
+            // LLStopWhenHandled
+            return true;
+        }
+    }
+    return false;
+}
+
 LLBoundListener LLEventPump::getListener(const std::string& name) const
 {
     ConnectionMap::const_iterator found = mConnections.find(name);
@@ -463,6 +532,7 @@ void LLEventPump::stopListening(const std::string& name)
     {
         found->second.disconnect();
         mConnections.erase(found);
+        updateListenerCache(NULL);
     }
     // We intentionally do NOT remove this name from mDeps. It may happen that
     // the same listener with the same name and dependencies will jump on and
@@ -483,18 +553,17 @@ bool LLEventStream::post(const LLSD& event)
     // cause us to move our LLStandardSignal object to a pimpl class along
     // with said member data. Then the local shared_ptr will preserve both.
 
-    // DEV-43463: capture a local copy of mSignal. We've turned up a
-    // cross-coroutine scenario (described in the Jira) in which this post()
-    // call could end up destroying 'this', the LLEventPump subclass instance
-    // containing mSignal, during the call through *mSignal. So -- capture a
-    // *stack* instance of the shared_ptr, ensuring that our heap
-    // LLStandardSignal object will live at least until post() returns, even
-    // if 'this' gets destroyed during the call.
-    boost::shared_ptr<LLStandardSignal> signal(mSignal);
+    // DEV-43463: We've turned up a cross-coroutine scenario (described in
+    // the Jira) in which this post() call could end up destroying 'this',
+    // the LLEventPump subclass instance containing mSignal, during the call
+    // through *mSignal. dispatch() captures *stack* instances of the
+    // shared_ptrs it uses, ensuring that our heap LLStandardSignal object
+    // and listener list will live at least until post() returns, even if
+    // 'this' gets destroyed during the call.
     // Let caller know if any one listener handled the event. This is mostly
     // useful when using LLEventStream as a listener for an upstream
     // LLEventPump.
-    return (*signal)(event);
+    return dispatch(event);
 }
 
 /*****************************************************************************
@@ -523,8 +592,9 @@ void LLEventQueue::flush()
     // -- rather like an EventStream. Instead, copy mEventQueue and clear it,
     // so that any new events posted to this LLEventQueue during flush() will
     // be processed in the *next* flush() call.
-    EventQueue queue(mEventQueue);
-    mEventQueue.clear();
+    // Swapping, rather than copying, saves copying each event.
+    EventQueue queue;
+    queue.swap(mEventQueue);
     // NOTE NOTE NOTE: Any new access to member data beyond this point should
     // cause us to move our LLStandardSignal object to a pimpl class along
     // with said member data. Then the local shared_ptr will preserve both.
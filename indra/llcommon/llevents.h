@@ -542,14 +542,46 @@ private:
     virtual void reset();
 
 private:
+    struct CachedListener
+    {
+        CachedListener(float node, const LLBoundListener& connection, const LLEventListener& listener):
+            mNode(node),
+            mConnection(connection),
+            mListener(listener)
+        {}
+        float mNode;
+        LLBoundListener mConnection;
+        LLEventListener mListener;
+    };
+    struct ListenerCache
+    {
+        ListenerCache(): mTracked(false) {}
+        /// in mSignal's call order
+        std::vector<CachedListener> mListeners;
+        /// a listener that tracks some object has to go through mSignal,
+        /// which notices when that object goes away
+        bool mTracked;
+    };
+    /// copy mListenerCache without the disconnected listeners, plus @a added
+    void updateListenerCache(const CachedListener* added);
+
     virtual LLBoundListener listen_impl(const std::string& name, const LLEventListener&,
                                         const NameList& after,
                                         const NameList& before);
     std::string mName;
 
 protected:
+    /// Call the listeners. In the usual case where no listener tracks an
+    /// object this walks mListenerCache, skipping mSignal's locking and
+    /// bookkeeping, with the same order and LLStopWhenHandled result.
+    bool dispatch(const LLSD& event);
+
     /// implement the dispatching
     boost::shared_ptr<LLStandardSignal> mSignal;
+    /// Snapshot of the connected listeners. It's replaced rather than
+    /// modified, so a dispatch keeps the one it started with even if a
+    /// listener connects or disconnects others.
+    boost::shared_ptr<const ListenerCache> mListenerCache;
 
     /// valve open?
     bool mEnabled;
@@ -32,6 +32,7 @@
 #include "llsingleton.h"
 #include "lltreeiterators.h"
 #include "llsdserialize.h"
+#include "llthread.h"
 
 #include <boost/bind.hpp>
 
@@ -61,6 +62,8 @@ LLFastTimer::CurTimerData LLFastTimer::sCurTimerData;
 BOOL LLFastTimer::sLog = FALSE;
 std::string LLFastTimer::sLogName = "";
 BOOL LLFastTimer::sMetricLog = FALSE;
+LLFastTimer::frame_log_callback_t LLFastTimer::sFrameLogCallback = NULL;
+bool LLFastTimer::sTraceActive = false;
 LLMutex* LLFastTimer::sLogLock = NULL;
 std::queue<LLSD> LLFastTimer::sLogQueue;
 
@@ -538,6 +541,11 @@ void LLFastTimer::NamedTimer::resetFrame()
 		sd["Total"]["Time"] = (LLSD::Real) total_time;
 		sd["Total"]["Calls"] = (LLSD::Integer) 1;
 
+		if (sFrameLogCallback)
+		{
+			sFrameLogCallback(sd);
+		}
+
 		{		
 			LLMutexLock lock(sLogLock);
 			sLogQueue.push(sd);
@@ -703,6 +711,16 @@ void LLFastTimer::nextFrame()
 	// get ready for next frame
 	NamedTimer::resetFrame();
 	sLastFrameTime = frame_time;
+
+	if (sTraceActive)
+	{
+		sTraceFrameTimes.push_back(frame_time);
+		if (--sTraceFramesLeft <= 0)
+		{
+			sTraceActive = false;
+			writeTrace();
+		}
+	}
 }
 
 //static
@@ -764,11 +782,199 @@ const LLFastTimer::NamedTimer* LLFastTimer::getTimerByName(const std::string& na
 	return NamedTimerFactory::instance().getTimerByName(name);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// Trace capture
+//
+// Each thread records completed timer scopes into its own ring of events.
+// Only the owning thread writes to a ring, and rings are only read once the
+// capture is over, so recording never takes a lock.
+//
+
+struct LLFastTimerTraceEvent
+{
+	const LLFastTimer::NamedTimer*	mTimer;
+	U64								mStart;
+	U64								mEnd;
+};
+
+struct LLFastTimerTraceBuffer
+{
+	enum { MAX_EVENTS = 1 << 16 };	// older events are overwritten
+
+	LLFastTimerTraceBuffer()
+	:	mThreadID(LLThread::currentID()),
+		mGeneration(0),
+		mCount(0),
+		mEvents(NULL)
+	{
+	}
+
+	std::string				mName;
+	U32						mThreadID;
+	U32						mGeneration;	// capture the events belong to
+	LLAtomicU32				mCount;			// published after each event is written
+	LLFastTimerTraceEvent*	mEvents;		// allocated on the first traced event
+};
+
+// buffers outlive their threads so a finished capture can still be written
+static ll_thread_local LLFastTimerTraceBuffer* sTraceBuffer = NULL;
+static std::vector<LLFastTimerTraceBuffer*> sTraceBuffers;
+static LLMutex* sTraceBufferMutex = NULL;
+static U32 sTraceGeneration = 0;
+static S32 sTraceFramesLeft = 0;
+static std::string sTraceFileName;
+static std::vector<U64> sTraceFrameTimes;
+
+static LLFastTimerTraceBuffer* get_trace_buffer()
+{
+	if (!sTraceBuffer)
+	{
+		sTraceBuffer = new LLFastTimerTraceBuffer();
+	}
+	return sTraceBuffer;
+}
+
+//static
+void LLFastTimer::setThreadName(const std::string& name)
+{
+	get_trace_buffer()->mName = name;
+}
+
+//static
+void LLFastTimer::startTrace(S32 frames, const std::string& filename)
+{
+	assert_main_thread();
+	if (sTraceActive || frames <= 0)
+	{
+		return;
+	}
+
+	if (!sTraceBufferMutex)
+	{
+		sTraceBufferMutex = new LLMutex(NULL);
+	}
+
+	if (get_trace_buffer()->mName.empty())
+	{
+		sTraceBuffer->mName = "main";
+	}
+
+	sTraceFileName = filename;
+	sTraceFramesLeft = frames;
+	sTraceFrameTimes.clear();
+	sTraceFrameTimes.push_back(getCPUClockCount64());
+	sTraceGeneration++;
+	sTraceActive = true;
+
+	llinfos << "Capturing fast timer trace for " << frames << " frames to " << filename << llendl;
+}
+
+//static
+void LLFastTimer::recordTraceEvent(const DeclareTimer& timer, U64 start_time)
+{
+	recordTraceEvent(&timer.mTimer, start_time);
+}
+
+//static
+void LLFastTimer::recordTraceEvent(const NamedTimer* timer, U64 start_time)
+{
+	U64 end_time = getCPUClockCount64();
+
+	LLFastTimerTraceBuffer* buffer = get_trace_buffer();
+	if (!buffer->mEvents)
+	{
+		buffer->mEvents = new LLFastTimerTraceEvent[LLFastTimerTraceBuffer::MAX_EVENTS];
+
+		LLMutexLock lock(sTraceBufferMutex);
+		sTraceBuffers.push_back(buffer);
+	}
+
+	if (buffer->mGeneration != sTraceGeneration)
+	{
+		// first event of a new capture on this thread
+		buffer->mGeneration = sTraceGeneration;
+		buffer->mCount = 0;
+	}
+
+	U32 index = buffer->mCount;
+	LLFastTimerTraceEvent& event = buffer->mEvents[index & (LLFastTimerTraceBuffer::MAX_EVENTS - 1)];
+	event.mTimer = timer;
+	event.mStart = start_time;
+	event.mEnd = end_time;
+	buffer->mCount = index + 1;
+}
+
+//static
+void LLFastTimer::writeTrace()
+{
+	llofstream os(sTraceFileName);
+	if (!os.is_open())
+	{
+		llwarns << "Unable to write fast timer trace to " << sTraceFileName << llendl;
+		return;
+	}
+
+	// 64 bit clock counts to microseconds
+	F64 usec_per_count = 1000000.0 / (F64)(countsPerSecond() << 8);
+	U64 base_time = sTraceFrameTimes.front();
+
+	os << "{\"traceEvents\":[\n";
+	os << std::fixed << std::setprecision(3);
+
+	bool first = true;
+	for (U32 i = 1; i < sTraceFrameTimes.size(); ++i)
+	{
+		os << (first ? "" : ",\n")
+			<< "{\"name\":\"Frame " << i << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":"
+			<< (F64)(sTraceFrameTimes[i] - base_time) * usec_per_count << "}";
+		first = false;
+	}
+
+	LLMutexLock lock(sTraceBufferMutex);
+	S32 total_events = 0;
+	for (U32 i = 0; i < sTraceBuffers.size(); ++i)
+	{
+		LLFastTimerTraceBuffer* buffer = sTraceBuffers[i];
+		if (buffer->mGeneration != sTraceGeneration)
+		{
+			continue;
+		}
+
+		std::string name = buffer->mName.empty() ? llformat("thread %d", buffer->mThreadID) : buffer->mName;
+		os << (first ? "" : ",\n")
+			<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->mThreadID
+			<< ",\"args\":{\"name\":\"" << name << "\"}}";
+		first = false;
+
+		U32 count = buffer->mCount;
+		U32 start = count > LLFastTimerTraceBuffer::MAX_EVENTS ? count - LLFastTimerTraceBuffer::MAX_EVENTS : 0;
+		for (U32 j = start; j < count; ++j)
+		{
+			const LLFastTimerTraceEvent& event = buffer->mEvents[j & (LLFastTimerTraceBuffer::MAX_EVENTS - 1)];
+			if (event.mStart < base_time)
+			{
+				continue;
+			}
+			os << ",\n{\"name\":\"" << event.mTimer->getName()
+				<< "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->mThreadID
+				<< ",\"ts\":" << (F64)(event.mStart - base_time) * usec_per_count
+				<< ",\"dur\":" << (F64)(event.mEnd - event.mStart) * usec_per_count << "}";
+			total_events++;
+		}
+	}
+
+	os << "\n]}\n";
+
+	llinfos << "Wrote " << total_events << " fast timer trace events to " << sTraceFileName << llendl;
+}
+
 LLFastTimer::LLFastTimer(LLFastTimer::FrameState* state)
 :	mFrameState(state)
 {
 	U32 start_time = getCPUClockCount32();
 	mStartTime = start_time;
+	mTraceStart = 0;
 	mFrameState->mActiveCount++;
 	LLFastTimer::sCurTimerData.mCurTimer = this;
 	LLFastTimer::sCurTimerData.mFrameState = mFrameState;
@@ -151,6 +151,30 @@ public:
 		FrameState*		mFrameState;
 	};
 
+	// times a scope on a thread other than the main one, which has no timer
+	// stack of its own; only shows up in a trace capture (see startTrace())
+	class LL_COMMON_API ThreadTimer
+	{
+	public:
+		LL_FORCE_INLINE ThreadTimer(DeclareTimer& timer)
+		:	mTimer(timer),
+			mTraceStart(LLFastTimer::sTraceActive ? LLFastTimer::getCPUClockCount64() : 0)
+		{
+		}
+
+		LL_FORCE_INLINE ~ThreadTimer()
+		{
+			if (mTraceStart)
+			{
+				LLFastTimer::recordTraceEvent(mTimer, mTraceStart);
+			}
+		}
+
+	private:
+		DeclareTimer&	mTimer;
+		U64				mTraceStart;
+	};
+
 public:
 	LLFastTimer(LLFastTimer::FrameState* state);
 
@@ -174,6 +198,8 @@ public:
 		cur_timer_data->mCurTimer = this;
 		cur_timer_data->mFrameState = frame_state;
 		cur_timer_data->mChildTime = 0;
+
+		mTraceStart = sTraceActive ? getCPUClockCount64() : 0;
 #endif
 #if TIME_FAST_TIMERS
 		U64 timer_end = getCPUClockCount64();
@@ -206,6 +232,11 @@ public:
 		mLastTimerData.mChildTime += total_time;
 
 		LLFastTimer::sCurTimerData = mLastTimerData;
+
+		if (mTraceStart)
+		{
+			recordTraceEvent(frame_state->mTimer, mTraceStart);
+		}
 #endif
 #if TIME_FAST_TIMERS
 		U64 timer_end = getCPUClockCount64();
@@ -220,6 +251,9 @@ public:
 	static BOOL				sLog;
 	static BOOL				sMetricLog;
 	static std::string		sLogName;
+	// adds entries to each frame record of the performance log (e.g. GPU times)
+	typedef void (*frame_log_callback_t)(LLSD& frame);
+	static frame_log_callback_t	sFrameLogCallback;
 	static bool 			sPauseHistory;
 	static bool 			sResetHistory;
 	static U64				sTimerCycles;
@@ -246,6 +280,16 @@ public:
 	static void writeLog(std::ostream& os);
 	static const NamedTimer* getTimerByName(const std::string& name);
 
+	// records every timer scope on every thread for the next frames frames,
+	// then writes them to filename in Chrome trace event (JSON) format
+	static void startTrace(S32 frames, const std::string& filename);
+	static bool isTracing() { return sTraceActive; }
+
+	// labels the calling thread in exported traces
+	static void setThreadName(const std::string& name);
+
+	static bool				sTraceActive;
+
 	struct CurTimerData
 	{
 		LLFastTimer*	mCurTimer;
@@ -260,12 +304,17 @@ private:
 	static U64 getCPUClockCount64();
 	static U64 sClockResolution;
 
+	static void recordTraceEvent(const NamedTimer* timer, U64 start_time);
+	static void recordTraceEvent(const DeclareTimer& timer, U64 start_time);
+	static void writeTrace();
+
 	static S32				sCurFrameIndex;
 	static S32				sLastFrameIndex;
 	static U64				sLastFrameTime;
 	static info_list_t*		sTimerInfos;
 
 	U32							mStartTime;
+	U64							mTraceStart;	// 0 unless a trace is being captured
 	LLFastTimer::FrameState*	mFrameState;
 	LLFastTimer::CurTimerData	mLastTimerData;
 
@@ -0,0 +1,390 @@
+/**
+ * @file llflathashmap.h
+ * @brief An open addressing hash map with its entries kept in one array.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFLATHASHMAP_H
+#define LL_LLFLATHASHMAP_H
+
+#include <cstring>
+#include <utility>
+#include <new>
+#include <boost/functional/hash.hpp>
+
+#include "stdtypes.h"
+#include "lldefs.h"
+#include "lluuid.h"
+
+// Hash used by LLFlatHashMap.  Falls back on boost::hash, which finds
+// hash_value() through ADL.
+template <typename Key>
+struct LLFlatHash
+{
+	size_t operator()(const Key& key) const
+	{
+		return boost::hash<Key>()(key);
+	}
+};
+
+// UUIDs are already random, so two of their words are as good as any mix.
+template <>
+struct LLFlatHash<LLUUID>
+{
+	size_t operator()(const LLUUID& id) const
+	{
+		const U32* words = (const U32*)id.mData;
+		return words[0] ^ (words[3] * 0x9E3779B9);
+	}
+};
+
+// Drop-in for the std::map and boost::unordered_map uses where order does
+// not matter:
+//   LLFlatHashMap<LLUUID, LLPointer<LLViewerObject> > objects;
+//
+// Entries live in one array with a byte of state per slot, and probing is
+// linear, so a lookup usually touches one or two cache lines instead of
+// walking tree nodes.  The state byte also holds 7 bits of the hash, which
+// rejects most mismatched slots without comparing keys.
+//
+// As with boost::unordered_map, inserting may invalidate all iterators;
+// erasing only invalidates the erased one, so map.erase(iter++) is safe.
+template <typename Key, typename T, typename Hash = LLFlatHash<Key> >
+class LLFlatHashMap
+{
+public:
+	typedef Key key_type;
+	typedef T mapped_type;
+	typedef std::pair<const Key, T> value_type;
+	typedef size_t size_type;
+
+private:
+	enum
+	{
+		SLOT_EMPTY = 0,
+		SLOT_DELETED = 1,
+		SLOT_FULL = 0x80	// low 7 bits hold part of the hash
+	};
+
+	template <typename MapT, typename ValueT>
+	class iterator_base
+	{
+		friend class LLFlatHashMap;
+	public:
+		iterator_base() : mMap(NULL), mIndex(0) {}
+		iterator_base(MapT* map, size_type index) : mMap(map), mIndex(index) {}
+
+		// iterator converts to const_iterator
+		template <typename OtherMapT, typename OtherValueT>
+		iterator_base(const iterator_base<OtherMapT, OtherValueT>& other)
+		:	mMap(other.mMap), mIndex(other.mIndex) {}
+
+		ValueT& operator*() const { return *mMap->slot(mIndex); }
+		ValueT* operator->() const { return mMap->slot(mIndex); }
+
+		iterator_base& operator++()
+		{
+			mIndex = mMap->nextFull(mIndex + 1);
+			return *this;
+		}
+
+		iterator_base operator++(int)
+		{
+			iterator_base tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		template <typename OtherMapT, typename OtherValueT>
+		bool operator==(const iterator_base<OtherMapT, OtherValueT>& other) const { return mIndex == other.mIndex; }
+		template <typename OtherMapT, typename OtherValueT>
+		bool operator!=(const iterator_base<OtherMapT, OtherValueT>& other) const { return mIndex != other.mIndex; }
+
+		MapT*		mMap;
+		size_type	mIndex;
+	};
+
+public:
+	typedef iterator_base<LLFlatHashMap, value_type> iterator;
+	typedef iterator_base<const LLFlatHashMap, const value_type> const_iterator;
+
+	LLFlatHashMap()
+	:	mSlots(NULL), mStates(NULL), mCapacity(0), mSize(0), mDeleted(0)
+	{
+	}
+
+	LLFlatHashMap(const LLFlatHashMap& other)
+	:	mSlots(NULL), mStates(NULL), mCapacity(0), mSize(0), mDeleted(0)
+	{
+		*this = other;
+	}
+
+	~LLFlatHashMap()
+	{
+		clear();
+		freeStorage();
+	}
+
+	LLFlatHashMap& operator=(const LLFlatHashMap& other)
+	{
+		if (this != &other)
+		{
+			clear();
+			reserve(other.mSize);
+			for (const_iterator iter = other.begin(); iter != other.end(); ++iter)
+			{
+				insert(*iter);
+			}
+		}
+		return *this;
+	}
+
+	void swap(LLFlatHashMap& other)
+	{
+		std::swap(mSlots, other.mSlots);
+		std::swap(mStates, other.mStates);
+		std::swap(mCapacity, other.mCapacity);
+		std::swap(mSize, other.mSize);
+		std::swap(mDeleted, other.mDeleted);
+	}
+
+	iterator begin() { return iterator(this, nextFull(0)); }
+	iterator end() { return iterator(this, mCapacity); }
+	const_iterator begin() const { return const_iterator(this, nextFull(0)); }
+	const_iterator end() const { return const_iterator(this, mCapacity); }
+
+	bool empty() const { return mSize == 0; }
+	size_type size() const { return mSize; }
+
+	iterator find(const Key& key) { return iterator(this, findIndex(key)); }
+	const_iterator find(const Key& key) const { return const_iterator(this, findIndex(key)); }
+	size_type count(const Key& key) const { return findIndex(key) != mCapacity ? 1 : 0; }
+
+	std::pair<iterator, bool> insert(const value_type& value)
+	{
+		size_t hash = Hash()(value.first);
+		size_type index = findIndex(value.first, hash);
+		if (index != mCapacity)
+		{
+			return std::make_pair(iterator(this, index), false);
+		}
+
+		index = insertIndex(hash);
+		new (slot(index)) value_type(value);
+		return std::make_pair(iterator(this, index), true);
+	}
+
+	T& operator[](const Key& key)
+	{
+		size_t hash = Hash()(key);
+		size_type index = findIndex(key, hash);
+		if (index == mCapacity)
+		{
+			index = insertIndex(hash);
+			new (slot(index)) value_type(key, T());
+		}
+		return slot(index)->second;
+	}
+
+	void erase(iterator iter)
+	{
+		eraseIndex(iter.mIndex);
+	}
+
+	size_type erase(const Key& key)
+	{
+		size_type index = findIndex(key);
+		if (index == mCapacity)
+		{
+			return 0;
+		}
+		eraseIndex(index);
+		return 1;
+	}
+
+	void clear()
+	{
+		for (size_type i = 0; i < mCapacity; i++)
+		{
+			if (mStates[i] & SLOT_FULL)
+			{
+				slot(i)->~value_type();
+			}
+			mStates[i] = SLOT_EMPTY;
+		}
+		mSize = 0;
+		mDeleted = 0;
+	}
+
+	// makes room for count entries without growing again
+	void reserve(size_type count)
+	{
+		size_type capacity = 8;
+		while (capacity * 7 < count * 8)
+		{
+			capacity *= 2;
+		}
+		if (capacity > mCapacity)
+		{
+			rehash(capacity);
+		}
+	}
+
+private:
+	value_type* slot(size_type index) const
+	{
+		return reinterpret_cast<value_type*>(mSlots) + index;
+	}
+
+	static U8 tag(size_t hash)
+	{
+		return SLOT_FULL | (U8)((hash >> 25) & 0x7F);
+	}
+
+	// Fibonacci hashing spreads weak hashes (like boost's for integers)
+	// across the whole table.
+	size_type home(size_t hash) const
+	{
+		return (size_type)(((U32)hash * 2654435769u) >> 8) & (mCapacity - 1);
+	}
+
+	size_type nextFull(size_type index) const
+	{
+		while (index < mCapacity && !(mStates[index] & SLOT_FULL))
+		{
+			index++;
+		}
+		return index;
+	}
+
+	size_type findIndex(const Key& key) const
+	{
+		return findIndex(key, Hash()(key));
+	}
+
+	size_type findIndex(const Key& key, size_t hash) const
+	{
+		if (!mSize)
+		{
+			return mCapacity;
+		}
+
+		U8 state = tag(hash);
+		for (size_type i = home(hash); ; i = (i + 1) & (mCapacity - 1))
+		{
+			if (mStates[i] == SLOT_EMPTY)
+			{
+				return mCapacity;
+			}
+			if (mStates[i] == state && slot(i)->first == key)
+			{
+				return i;
+			}
+		}
+	}
+
+	// claims a slot for a key known not to be in the map
+	size_type insertIndex(size_t hash)
+	{
+		if ((mSize + mDeleted + 1) * 8 > mCapacity * 7)
+		{
+			// only grow when it's live entries filling the table, not tombstones
+			rehash((mSize + 1) * 2 > mCapacity ? llmax(mCapacity * 2, (size_type)8) : mCapacity);
+		}
+
+		size_type i = home(hash);
+		while (mStates[i] & SLOT_FULL)
+		{
+			i = (i + 1) & (mCapacity - 1);
+		}
+		if (mStates[i] == SLOT_DELETED)
+		{
+			mDeleted--;
+		}
+		mStates[i] = tag(hash);
+		mSize++;
+		return i;
+	}
+
+	void eraseIndex(size_type index)
+	{
+		slot(index)->~value_type();
+		mSize--;
+
+		// a tombstone is only needed when a probe can run past this slot
+		if (mStates[(index + 1) & (mCapacity - 1)] == SLOT_EMPTY)
+		{
+			mStates[index] = SLOT_EMPTY;
+		}
+		else
+		{
+			mStates[index] = SLOT_DELETED;
+			mDeleted++;
+		}
+	}
+
+	void rehash(size_type capacity)
+	{
+		char* old_slots = mSlots;
+		U8* old_states = mStates;
+		size_type old_capacity = mCapacity;
+
+		mSlots = new char[capacity * sizeof(value_type)];
+		mStates = new U8[capacity];
+		memset(mStates, SLOT_EMPTY, capacity);
+		mCapacity = capacity;
+		mSize = 0;
+		mDeleted = 0;
+
+		for (size_type i = 0; i < old_capacity; i++)
+		{
+			if (old_states[i] & SLOT_FULL)
+			{
+				value_type* value = reinterpret_cast<value_type*>(old_slots) + i;
+				size_type index = insertIndex(Hash()(value->first));
+				new (slot(index)) value_type(*value);
+				value->~value_type();
+			}
+		}
+
+		delete [] old_slots;
+		delete [] old_states;
+	}
+
+	void freeStorage()
+	{
+		delete [] mSlots;
+		delete [] mStates;
+		mSlots = NULL;
+		mStates = NULL;
+		mCapacity = 0;
+	}
+
+	char*		mSlots;		// raw storage for mCapacity value_types
+	U8*			mStates;
+	size_type	mCapacity;	// always 0 or a power of two
+	size_type	mSize;
+	size_type	mDeleted;	// tombstones, counted against the load factor
+};
+
+#endif // LL_LLFLATHASHMAP_H
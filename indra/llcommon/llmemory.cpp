@@ -1335,6 +1335,9 @@ LLPrivateMemoryPool::LLPrivateMemoryPool(S32 type, U32 max_pool_size) :
 	}	
 	
 	mNumOfChunks = 0 ;
+
+	memset(mCacheHits, 0, sizeof(mCacheHits)) ;
+	memset(mCacheMisses, 0, sizeof(mCacheMisses)) ;
 }
 
 LLPrivateMemoryPool::~LLPrivateMemoryPool()
@@ -1344,12 +1347,34 @@ LLPrivateMemoryPool::~LLPrivateMemoryPool()
 }
 
 char* LLPrivateMemoryPool::allocate(U32 size)
-{	
+{
 	if(!size)
 	{
 		return NULL ;
 	}
 
+	return mMutexp ? allocateThreaded(size) : allocateInternal(size) ;
+}
+
+void LLPrivateMemoryPool::freeMem(void* addr)
+{
+	if(!addr)
+	{
+		return ;
+	}
+
+	if(mMutexp)
+	{
+		freeThreaded(addr) ;
+	}
+	else
+	{
+		freeInternal(addr) ;
+	}
+}
+
+char* LLPrivateMemoryPool::allocateInternal(U32 size)
+{	
 	//if the asked size larger than MAX_BLOCK_SIZE, fetch from heap directly, the pool does not manage it
 	if(size >= CHUNK_SIZE)
 	{
@@ -1416,13 +1441,8 @@ char* LLPrivateMemoryPool::allocate(U32 size)
 	return p ;
 }
 
-void LLPrivateMemoryPool::freeMem(void* addr)
+void LLPrivateMemoryPool::freeInternal(void* addr)
 {
-	if(!addr)
-	{
-		return ;
-	}
-	
 	lock() ;
 	
 	LLMemoryChunk* chunk = findChunk((char*)addr) ;
@@ -1444,8 +1464,238 @@ void LLPrivateMemoryPool::freeMem(void* addr)
 	unlock() ;
 }
 
+//-------------------------------------------------------------------
+//the threaded pools keep a per-thread cache of freed blocks by size class,
+//so allocations and frees on the same thread do not touch the mutex.
+//every block handed out carries a header with its class, which lets a free
+//park the block without looking up its chunk.
+//-------------------------------------------------------------------
+const U32 CACHE_HEADER_SIZE = 16 ; //keeps the 16 byte slot alignment
+const U8  UNCACHED_CLASS = 0xFF ;
+const U32 MAX_CACHED_SIZE = 64 << 10 ;
+const U32 MAX_CACHED_BYTES_PER_CLASS = 256 << 10 ;
+const U32 MAX_CACHED_BLOCKS_PER_CLASS = 64 ;
+const U32 MIN_CACHED_BLOCKS_PER_CLASS = 4 ;
+const U32 CACHE_REFILL_COUNT = 4 ;
+
+struct LLPrivateMemoryPool::LLThreadCache
+{
+	LLPrivateMemoryPool* mPool ;
+	char* mFreeList[NUM_CACHE_CLASSES] ;
+	U32   mCount[NUM_CACHE_CLASSES] ;
+	U32   mHits[NUM_CACHE_CLASSES] ;
+};
+
+//one per threaded pool type: STATIC_THREADED and VOLATILE_THREADED
+static ll_thread_local LLPrivateMemoryPool::LLThreadCache* sThreadCaches[2] ;
+
+//16 to 64 bytes in 16 byte steps, then four steps per power of two
+static S32 get_cache_class(U32 size)
+{
+	if(size > MAX_CACHED_SIZE)
+	{
+		return -1 ;
+	}
+	if(size <= 64)
+	{
+		return (size + 15) / 16 - 1 ;
+	}
+
+	U32 octave = 64 ;
+	S32 idx = 4 ;
+	while(size > octave * 2)
+	{
+		octave *= 2 ;
+		idx += 4 ;
+	}
+	U32 step = octave / 4 ;
+	return idx + (size - octave + step - 1) / step - 1 ;
+}
+
+static U32 get_cache_class_size(S32 idx)
+{
+	if(idx < 4)
+	{
+		return (idx + 1) * 16 ;
+	}
+	U32 octave = 64 << ((idx - 4) / 4) ;
+	return octave + ((idx - 4) % 4 + 1) * (octave / 4) ;
+}
+
+static U32 get_cache_class_limit(S32 idx)
+{
+	return llclamp(MAX_CACHED_BYTES_PER_CLASS / get_cache_class_size(idx), MIN_CACHED_BLOCKS_PER_CLASS, MAX_CACHED_BLOCKS_PER_CLASS) ;
+}
+
+//the next pointer of a cached block lives in its header, after the class byte
+static char*& cached_next(char* block)
+{
+	return *(char**)(block + sizeof(char*)) ;
+}
+
+LLPrivateMemoryPool::LLThreadCache* LLPrivateMemoryPool::getThreadCache()
+{
+	LLThreadCache*& cache = sThreadCaches[mType - STATIC_THREADED] ;
+	if(!cache)
+	{
+		cache = new LLThreadCache ;
+		memset(cache, 0, sizeof(LLThreadCache)) ;
+	}
+	if(cache->mPool != this)
+	{
+		//the pool of this type was recreated, give the old one its blocks back
+		flushCache(cache) ;
+		cache->mPool = this ;
+	}
+	return cache ;
+}
+
+//static
+void LLPrivateMemoryPool::flushCache(LLThreadCache* cache)
+{
+	LLPrivateMemoryPool* pool = cache->mPool ;
+	if(!pool)
+	{
+		return ;
+	}
+
+	pool->lock() ;
+	for(S32 i = 0 ; i < NUM_CACHE_CLASSES ; i++)
+	{
+		pool->mCacheHits[i] += cache->mHits[i] ;
+		cache->mHits[i] = 0 ;
+
+		while(cache->mFreeList[i])
+		{
+			char* block = cache->mFreeList[i] ;
+			cache->mFreeList[i] = cached_next(block) ;
+			pool->freeInternal(block) ;
+		}
+		cache->mCount[i] = 0 ;
+	}
+	pool->unlock() ;
+}
+
+//static
+void LLPrivateMemoryPool::flushThreadCache()
+{
+	for(S32 i = 0 ; i < 2 ; i++)
+	{
+		if(sThreadCaches[i])
+		{
+			flushCache(sThreadCaches[i]) ;
+			delete sThreadCaches[i] ;
+			sThreadCaches[i] = NULL ;
+		}
+	}
+}
+
+char* LLPrivateMemoryPool::allocateThreaded(U32 size)
+{
+	S32 cls = get_cache_class(size) ;
+	if(cls < 0)
+	{
+		char* p = allocateInternal(size + CACHE_HEADER_SIZE) ;
+		if(!p)
+		{
+			return NULL ;
+		}
+		p[0] = UNCACHED_CLASS ;
+		return p + CACHE_HEADER_SIZE ;
+	}
+
+	LLThreadCache* cache = getThreadCache() ;
+	char* block = cache->mFreeList[cls] ;
+	if(block)
+	{
+		cache->mFreeList[cls] = cached_next(block) ;
+		cache->mCount[cls]-- ;
+		cache->mHits[cls]++ ;
+		return block + CACHE_HEADER_SIZE ;
+	}
+
+	//refill a few blocks under one lock
+	U32 block_size = get_cache_class_size(cls) + CACHE_HEADER_SIZE ;
+
+	lock() ;
+	mCacheMisses[cls]++ ;
+	mCacheHits[cls] += cache->mHits[cls] ;
+	cache->mHits[cls] = 0 ;
+
+	block = allocateInternal(block_size) ;
+	for(U32 i = 1 ; block && i < CACHE_REFILL_COUNT ; i++)
+	{
+		char* extra = allocateInternal(block_size) ;
+		if(!extra)
+		{
+			break ;
+		}
+		extra[0] = (char)cls ;
+		cached_next(extra) = cache->mFreeList[cls] ;
+		cache->mFreeList[cls] = extra ;
+		cache->mCount[cls]++ ;
+	}
+	unlock() ;
+
+	if(!block)
+	{
+		return NULL ;
+	}
+	block[0] = (char)cls ;
+	return block + CACHE_HEADER_SIZE ;
+}
+
+void LLPrivateMemoryPool::freeThreaded(void* addr)
+{
+	char* block = (char*)addr - CACHE_HEADER_SIZE ;
+	U8 cls = (U8)block[0] ;
+
+	//a pool left dangling by the manager should drain, not cache
+	if(cls == UNCACHED_CLASS || !LLPrivateMemoryPoolManager::getInstance())
+	{
+		freeInternal(block) ;
+		return ;
+	}
+
+	LLThreadCache* cache = getThreadCache() ;
+	cached_next(block) = cache->mFreeList[cls] ;
+	cache->mFreeList[cls] = block ;
+
+	U32 limit = get_cache_class_limit(cls) ;
+	if(++cache->mCount[cls] > limit)
+	{
+		//give half back so a thread that only frees does not hoard memory
+		lock() ;
+		mCacheHits[cls] += cache->mHits[cls] ;
+		cache->mHits[cls] = 0 ;
+		while(cache->mCount[cls] > limit / 2)
+		{
+			block = cache->mFreeList[cls] ;
+			cache->mFreeList[cls] = cached_next(block) ;
+			cache->mCount[cls]-- ;
+			freeInternal(block) ;
+		}
+		unlock() ;
+	}
+}
+
 void LLPrivateMemoryPool::dump()
 {
+	if(!mMutexp)
+	{
+		return ;
+	}
+
+	lock() ;
+	llinfos << "private pool type " << mType << " thread cache, class size: hits / misses" << llendl ;
+	for(S32 i = 0 ; i < NUM_CACHE_CLASSES ; i++)
+	{
+		if(mCacheHits[i] || mCacheMisses[i])
+		{
+			llinfos << get_cache_class_size(i) << ": " << mCacheHits[i] << " / " << mCacheMisses[i] << llendl ;
+		}
+	}
+	unlock() ;
 }
 
 U32 LLPrivateMemoryPool::getTotalAllocatedSize()
@@ -1842,6 +2092,8 @@ LLPrivateMemoryPoolManager::LLPrivateMemoryPoolManager(BOOL enabled, U32 max_poo
 
 LLPrivateMemoryPoolManager::~LLPrivateMemoryPoolManager() 
 {
+	//blocks parked in the main thread's cache would keep the pools from emptying
+	LLPrivateMemoryPool::flushThreadCache() ;
 
 #if __DEBUG_PRIVATE_MEM__
 	if(!sMemAllocationTracker.empty())
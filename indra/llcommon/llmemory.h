@@ -302,12 +302,25 @@ public:
 		LLMemoryChunk* mPrev ;
 	} ;
 
+	//per-thread cache of freed blocks in front of the threaded pools
+	struct LLThreadCache ;
+	enum { NUM_CACHE_CLASSES = 44 } ; //16 bytes to 64KB, four classes per power of two
+
+	//returns the calling thread's cached blocks to their pools, called when a thread exits.
+	static void flushThreadCache() ;
+
 private:
 	LLPrivateMemoryPool(S32 type, U32 max_pool_size) ;
 	~LLPrivateMemoryPool() ;
 
 	char *allocate(U32 size) ;
 	void  freeMem(void* addr) ;
+	char *allocateInternal(U32 size) ;
+	void  freeInternal(void* addr) ;
+	char *allocateThreaded(U32 size) ;
+	void  freeThreaded(void* addr) ;
+	LLThreadCache* getThreadCache() ;
+	static void flushCache(LLThreadCache* cache) ;
 	
 	void  dump() ;
 	U32   getTotalAllocatedSize() ;
@@ -360,6 +373,10 @@ private:
 
 	S32 mType ;
 
+	//thread cache statistics by size class, folded in whenever a thread takes the mutex
+	U32 mCacheHits[NUM_CACHE_CLASSES] ;
+	U32 mCacheMisses[NUM_CACHE_CLASSES] ;
+
 	class LLChunkHashElement
 	{
 	public:
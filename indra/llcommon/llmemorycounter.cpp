@@ -0,0 +1,50 @@
+/**
+ * @file llmemorycounter.cpp
+ * @brief Named byte counts of what each subsystem holds.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llmemorycounter.h"
+
+LLMemoryCounter::LLMemoryCounter(const char* name, sample_func_t sample)
+:	mName(name),
+	mSample(sample)
+{
+	counterList().push_back(this);
+}
+
+S64 LLMemoryCounter::getBytes() const
+{
+	return mSample ? mSample() : (S64)(S32)mBytes;
+}
+
+//static
+LLMemoryCounter::counter_list_t& LLMemoryCounter::counterList()
+{
+	// counters are statics in other translation units
+	static counter_list_t counters;
+	return counters;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file llmemorycounter.h
+ * @brief Named byte counts of what each subsystem holds.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLMEMORYCOUNTER_H
+#define LL_LLMEMORYCOUNTER_H
+
+#include <vector>
+
+#include "llapr.h"
+
+// Bytes held by one subsystem, for the memory usage floater and log.
+// Either counted as the memory comes and goes:
+//
+//   static LLMemoryCounter MEM_LLSD("LLSD");
+//   MEM_LLSD.add(size);
+//   ...
+//   MEM_LLSD.sub(size);
+//
+// or read from a total the subsystem already keeps:
+//
+//   static LLMemoryCounter MEM_GL_TEXTURES("GL Textures", &get_gl_texture_bytes);
+//
+// Counters must be statics, like LLFastTimer::DeclareTimer.  add() and sub()
+// are safe from any thread, sampled counters are only read on the main thread.
+class LL_COMMON_API LLMemoryCounter
+{
+public:
+	typedef S64 (*sample_func_t)();
+
+	LLMemoryCounter(const char* name, sample_func_t sample = NULL);
+
+	void add(S32 bytes) { mBytes += bytes; }
+	void sub(S32 bytes) { mBytes -= bytes; }
+
+	const char* getName() const { return mName; }
+	S64 getBytes() const;
+
+	typedef std::vector<LLMemoryCounter*> counter_list_t;
+	static const counter_list_t& getCounters() { return counterList(); }
+
+private:
+	static counter_list_t& counterList();
+
+	const char*			mName;
+	sample_func_t		mSample;
+	// left to static zero initialization, other statics may count before
+	// this one is constructed
+	mutable LLAtomicS32	mBytes;
+};
+
+#endif // LL_LLMEMORYCOUNTER_H
@@ -0,0 +1,145 @@
+/**
+ * @file llparallelfor.cpp
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llparallelfor.h"
+
+#include "lltimer.h"	// ms_sleep()
+
+//============================================================================
+
+LLParallelFor::LLParallelFor(const std::string& name, U32 num_threads)
+:	mQuitting(false),
+	mBody(NULL),
+	mCount(0),
+	mNextJob(0),
+	mJobsDone(0)
+{
+	mSignal = new LLCondition(NULL);
+
+	for (U32 i = 0; i < num_threads; ++i)
+	{
+		Worker* worker = new Worker(name, this);
+		mWorkers.push_back(worker);
+		worker->start();
+	}
+}
+
+LLParallelFor::~LLParallelFor()
+{
+	mSignal->lock();
+	mQuitting = true;
+	mSignal->broadcast();
+	mSignal->unlock();
+
+	for (U32 i = 0; i < mWorkers.size(); ++i)
+	{
+		while (!mWorkers[i]->isStopped())
+		{
+			ms_sleep(1);
+		}
+		delete mWorkers[i];
+	}
+	mWorkers.clear();
+
+	delete mSignal;
+	mSignal = NULL;
+}
+
+void LLParallelFor::run(Body& body, U32 count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (mWorkers.empty() || count == 1)
+	{
+		for (U32 i = 0; i < count; ++i)
+		{
+			body.run(i);
+		}
+		return;
+	}
+
+	mSignal->lock();
+	mBody = &body;
+	mCount = count;
+	mNextJob = 0;
+	mJobsDone = 0;
+	mSignal->broadcast();
+
+	processJobs();
+
+	while (mJobsDone < mCount)
+	{
+		mSignal->wait();
+	}
+
+	mBody = NULL;
+	mCount = 0;
+	mSignal->unlock();
+}
+
+void LLParallelFor::processJobs()
+{
+	while (mNextJob < mCount)
+	{
+		U32 job = mNextJob++;
+		Body* body = mBody;
+		mSignal->unlock();
+
+		body->run(job);
+
+		mSignal->lock();
+		if (++mJobsDone == mCount)
+		{
+			mSignal->broadcast();
+		}
+	}
+}
+
+//============================================================================
+
+LLParallelFor::Worker::Worker(const std::string& name, LLParallelFor* pool)
+:	LLThread(name),
+	mPool(pool)
+{
+}
+
+//virtual
+void LLParallelFor::Worker::run()
+{
+	mPool->mSignal->lock();
+	while (!mPool->mQuitting)
+	{
+		mPool->processJobs();
+		if (!mPool->mQuitting)
+		{
+			mPool->mSignal->wait();
+		}
+	}
+	mPool->mSignal->unlock();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file llparallelfor.h
+ * @brief Runs a batch of independent indexed jobs across a fixed set of worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLPARALLELFOR_H
+#define LL_LLPARALLELFOR_H
+
+#include <string>
+#include <vector>
+
+#include "llthread.h"
+
+//============================================================================
+// Fork/join helper for per-frame work: run() hands out indices [0, count) to
+// the worker threads and the calling thread, and returns once every index
+// has been processed. Bodies must not use LLFastTimer or anything else that
+// is main thread only.
+
+class LL_COMMON_API LLParallelFor
+{
+public:
+	class Body
+	{
+	public:
+		virtual ~Body() {}
+		virtual void run(U32 index) = 0;
+	};
+
+	LLParallelFor(const std::string& name, U32 num_threads);
+	~LLParallelFor();
+
+	// Blocks until body.run() has returned for every index
+	void run(Body& body, U32 count);
+
+	U32 getNumThreads() const	{ return mWorkers.size(); }
+
+private:
+	class Worker : public LLThread
+	{
+	public:
+		Worker(const std::string& name, LLParallelFor* pool);
+		/*virtual*/ void run();
+
+	private:
+		LLParallelFor* mPool;
+	};
+
+	// Run indices until none are left, called with mSignal locked
+	void processJobs();
+
+	LLCondition* mSignal;
+	std::vector<Worker*> mWorkers;
+	bool mQuitting;
+
+	Body* mBody;
+	U32 mCount;
+	U32 mNextJob;
+	U32 mJobsDone;
+};
+
+#endif // LL_LLPARALLELFOR_H
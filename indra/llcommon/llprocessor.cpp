@@ -132,7 +132,8 @@ namespace
 		eMONTIOR_MWAIT=33,
 		eCPLDebugStore=34,
 		eThermalMonitor2=35,
-		eAltivec=36
+		eAltivec=36,
+		eAVX=37
 	};
 
 	const char* cpu_feature_names[] =
@@ -175,7 +176,8 @@ namespace
 		"CPL Qualified Debug Store",
 		"Thermal Monitor 2",
 
-		"Altivec"
+		"Altivec",
+		"AVX"
 	};
 
 	std::string intel_CPUFamilyName(int composed_family) 
@@ -275,6 +277,11 @@ public:
 		return hasExtension("Altivec"); 
 	}
 
+	bool hasAVX() const
+	{
+		return hasExtension(cpu_feature_names[eAVX]);
+	}
+
 	std::string getCPUFamilyName() const { return getInfo(eFamilyName, "Unknown").asString(); }
 	std::string getCPUBrandName() const { return getInfo(eBrandName, "Unknown").asString(); }
 
@@ -462,6 +469,21 @@ static F64 calculate_cpu_frequency(U32 measure_msecs)
 	return frequency  / (F64)1000000;
 }
 
+#if _MSC_FULL_VER >= 160040219
+#include <immintrin.h>	// _xgetbv(), from VS2010 SP1 on
+#endif
+
+// The CPU reporting AVX isn't enough, the OS also has to save the upper
+// halves of the registers on a context switch.
+static bool os_saves_avx_state()
+{
+#if _MSC_FULL_VER >= 160040219
+	return (_xgetbv(0) & 0x6) == 0x6;
+#else
+	return false;
+#endif
+}
+
 // Windows implementation
 class LLProcessorInfoWindowsImpl : public LLProcessorInfoImpl
 {
@@ -536,6 +558,12 @@ private:
 				{
 					setExtension(cpu_feature_names[eThermalMonitor2]);
 				}
+
+				// AVX and OSXSAVE
+				if((cpu_info[2] & 0x18000000) == 0x18000000 && os_saves_avx_state())
+				{
+					setExtension(cpu_feature_names[eAVX]);
+				}
 						
 				unsigned int feature_info = (unsigned int) cpu_info[3];
 				for(unsigned int index = 0, bit = 1; index < eSSE3_Features; ++index, bit <<= 1)
@@ -707,6 +735,14 @@ private:
 #endif // LL_RELEASE_FOR_DOWNLOAD 	
 
 
+		// the high word holds the ecx feature bits, and OSXSAVE is only set
+		// once the kernel saves the extended register state
+		U32 ecx_feature_info = (U32)(feature_info >> 32);
+		if((ecx_feature_info & 0x18000000) == 0x18000000)
+		{
+			setExtension(cpu_feature_names[eAVX]);
+		}
+
 		uint64_t ext_feature_info = getSysctlInt64("machdep.cpu.extfeature_bits");
 		S32 *ext_feature_infos = (S32*)(&ext_feature_info);
 		setConfig(eExtFeatureBits, ext_feature_infos[0]);
@@ -820,6 +856,12 @@ private:
 		{
 			setExtension(cpu_feature_names[eSSE2_Ext]);
 		}
+
+		// the kernel leaves this out when it doesn't save the AVX state
+		if( flags.find( " avx " ) != std::string::npos )
+		{
+			setExtension(cpu_feature_names[eAVX]);
+		}
 	
 # endif // LL_X86
 	}
@@ -881,6 +923,7 @@ F64 LLProcessorInfo::getCPUFrequency() const { return mImpl->getCPUFrequency();
 bool LLProcessorInfo::hasSSE() const { return mImpl->hasSSE(); }
 bool LLProcessorInfo::hasSSE2() const { return mImpl->hasSSE2(); }
 bool LLProcessorInfo::hasAltivec() const { return mImpl->hasAltivec(); }
+bool LLProcessorInfo::hasAVX() const { return mImpl->hasAVX(); }
 std::string LLProcessorInfo::getCPUFamilyName() const { return mImpl->getCPUFamilyName(); }
 std::string LLProcessorInfo::getCPUBrandName() const { return mImpl->getCPUBrandName(); }
 std::string LLProcessorInfo::getCPUFeatureDescription() const { return mImpl->getCPUFeatureDescription(); }
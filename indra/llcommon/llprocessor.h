@@ -39,6 +39,7 @@ public:
 	bool hasSSE() const;
 	bool hasSSE2() const;
 	bool hasAltivec() const;
+	bool hasAVX() const;
 	std::string getCPUFamilyName() const;
 	std::string getCPUBrandName() const;
 	std::string getCPUFeatureDescription() const;
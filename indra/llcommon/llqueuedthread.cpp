@@ -28,6 +28,10 @@
 
 #include "llstl.h"
 #include "lltimer.h"	// ms_sleep()
+#include "llfasttimer.h"
+
+static LLFastTimer::DeclareTimer FTM_QUEUED_REQUEST_LOCK("Queued Request Lock");
+static LLFastTimer::DeclareTimer FTM_PROCESS_QUEUED_REQUEST("Process Queued Request");
 
 //============================================================================
 
@@ -63,6 +67,10 @@ LLQueuedThread::~LLQueuedThread()
 
 void LLQueuedThread::shutdown()
 {
+	// Stop the pool first, a pool worker may be in the middle of a request
+	// that is about to be deleted below
+	stopPool();
+
 	setQuitting();
 
 	unpause(); // MAIN THREAD
@@ -159,6 +167,38 @@ void LLQueuedThread::incQueue()
 			wake(); // Wake the thread up if necessary.
 		}
 	}
+	for (pool_worker_list_t::iterator iter = mPoolWorkers.begin();
+		 iter != mPoolWorkers.end(); ++iter)
+	{
+		(*iter)->wake();
+	}
+}
+
+// MAIN thread
+void LLQueuedThread::startPool(U32 pool_size)
+{
+	if (!mThreaded)
+	{
+		return;
+	}
+	for (U32 i = mPoolWorkers.size() + 1; i < pool_size; ++i)
+	{
+		PoolWorker* worker = new PoolWorker(llformat("%s %d", mName.c_str(), i), this);
+		mPoolWorkers.push_back(worker);
+		worker->start();
+	}
+}
+
+// MAIN thread
+void LLQueuedThread::stopPool()
+{
+	for (pool_worker_list_t::iterator iter = mPoolWorkers.begin();
+		 iter != mPoolWorkers.end(); ++iter)
+	{
+		(*iter)->shutdown();
+		delete *iter;
+	}
+	mPoolWorkers.clear();
 }
 
 //virtual
@@ -402,7 +442,10 @@ S32 LLQueuedThread::processNextRequest()
 {
 	QueuedRequest *req;
 	// Get next request from pool
-	lockData();
+	{
+		LLFastTimer::ThreadTimer t(FTM_QUEUED_REQUEST_LOCK);
+		lockData();
+	}
 	while(1)
 	{
 		req = NULL;
@@ -441,7 +484,11 @@ S32 LLQueuedThread::processNextRequest()
 	if (req)
 	{
 		// process request		
-		bool complete = req->processRequest();
+		bool complete;
+		{
+			LLFastTimer::ThreadTimer t(FTM_PROCESS_QUEUED_REQUEST);
+			complete = req->processRequest();
+		}
 
 		if (complete)
 		{
@@ -535,6 +582,41 @@ void LLQueuedThread::threadedUpdate()
 
 //============================================================================
 
+LLQueuedThread::PoolWorker::PoolWorker(const std::string& name, LLQueuedThread* owner)
+	: LLThread(name),
+	  mOwner(owner)
+{
+}
+
+// POOL WORKER THREAD
+//virtual
+void LLQueuedThread::PoolWorker::run()
+{
+	while (!isQuitting())
+	{
+		// sleeps until the owner has queued requests
+		checkPause();
+		if (isQuitting() || mOwner->isQuitting())
+		{
+			break;
+		}
+
+		if (mOwner->processNextRequest() == 0)
+		{
+			ms_sleep(1);
+		}
+	}
+}
+
+//virtual
+bool LLQueuedThread::PoolWorker::runCondition()
+{
+	// mRunCondition is locked here; getPending() only takes the owner's lock
+	return mOwner->getPending() > 0;
+}
+
+//============================================================================
+
 LLQueuedThread::QueuedRequest::QueuedRequest(LLQueuedThread::handle_t handle, U32 priority, U32 flags) :
 	LLSimpleHashEntry<LLQueuedThread::handle_t>(handle),
 	mStatus(STATUS_UNKNOWN),
@@ -28,6 +28,7 @@
 #define LL_LLQUEUEDTHREAD_H
 
 #include <queue>
+#include <vector>
 #include <string>
 #include <map>
 #include <set>
@@ -182,6 +183,12 @@ public:
 	virtual S32 getPending();
 	bool getThreaded() { return mThreaded ? true : false; }
 
+	// Adds threads that service this queue alongside the owning thread, so
+	// up to pool_size requests are processed at once. Only for subclasses
+	// whose requests are independent of each other. MAIN THREAD.
+	void startPool(U32 pool_size);
+	S32 getPoolSize() const { return (S32)mPoolWorkers.size() + 1; }
+
 	// Request accessors
 	status_t getRequestStatus(handle_t handle);
 	void abortRequest(handle_t handle, bool autocomplete);
@@ -195,6 +202,26 @@ public:
 	// debug (see source)
 	bool check();
 	
+private:
+	// Additional thread that takes the highest priority request off the
+	// owner's queue whenever it is free
+	class PoolWorker : public LLThread
+	{
+	public:
+		PoolWorker(const std::string& name, LLQueuedThread* owner);
+
+	protected:
+		/*virtual*/ void run();
+		/*virtual*/ bool runCondition();
+
+	private:
+		LLQueuedThread* mOwner;
+	};
+	typedef std::vector<PoolWorker*> pool_worker_list_t;
+	pool_worker_list_t mPoolWorkers;
+
+	void stopPool();
+
 protected:
 	BOOL mThreaded;  // if false, run on main thread and do updates during update()
 	BOOL mStarted;  // required when mThreaded is false to call startThread() from update()
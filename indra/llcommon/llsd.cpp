@@ -33,8 +33,10 @@
 #include "llerror.h"
 #include "../llmath/llmath.h"
 #include "llformat.h"
+#include "llmemorycounter.h"
 #include "llsdserialize.h"
 #include "stringize.h"
+#include "llthread.h"	// ll_thread_local
 
 #ifndef LL_RELEASE_FOR_DOWNLOAD
 #define NAME_UNNAMED_NAMESPACE
@@ -48,6 +50,27 @@ namespace
 {
 	class ImplMap;
 	class ImplArray;
+
+	// Impl nodes are recycled per thread in IMPL_POOL_GRANULE size classes so
+	// that building and tearing down big documents (inventory skeletons, mesh
+	// headers, login responses) does not go through the heap for every value.
+	// A node freed on another thread than the one that made it simply joins
+	// the freeing thread's list.
+	const size_t IMPL_POOL_GRANULE = 16;
+	const U32 IMPL_POOL_CLASSES = 6;		// nodes up to 96 bytes
+	const U32 IMPL_POOL_MAX_FREE = 8192;	// per class, per thread
+
+	struct FreeImpl
+	{
+		FreeImpl* mNext;
+	};
+
+	ll_thread_local FreeImpl* sFreeImpls[IMPL_POOL_CLASSES];
+	ll_thread_local U32 sFreeImplCount[IMPL_POOL_CLASSES];
+
+	// heap bytes behind Impl nodes, free lists included; the strings and
+	// containers inside them are not counted
+	LLMemoryCounter MEM_LLSD("LLSD");
 }
 
 #ifdef NAME_UNNAMED_NAMESPACE
@@ -156,6 +179,9 @@ public:
 	static Impl& getImpl(LLSD& llsd)				{ return safe(llsd.impl); }
 
 	static const LLSD& undef();
+
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
 	
 	static U32 sAllocationCount;
 	static U32 sOutstandingCount;
@@ -636,6 +662,51 @@ LLSD::Impl::~Impl()
 	--sOutstandingCount;
 }
 
+//static
+void* LLSD::Impl::operator new(size_t size)
+{
+	U32 size_class = (size + IMPL_POOL_GRANULE - 1) / IMPL_POOL_GRANULE - 1;
+	if (size_class >= IMPL_POOL_CLASSES)
+	{
+		MEM_LLSD.add(size);
+		return ::operator new(size);
+	}
+
+	FreeImpl* node = sFreeImpls[size_class];
+	if (node)
+	{
+		sFreeImpls[size_class] = node->mNext;
+		--sFreeImplCount[size_class];
+		return node;
+	}
+
+	// always the full class size so any free node of the class can be reused
+	MEM_LLSD.add((size_class + 1) * IMPL_POOL_GRANULE);
+	return ::operator new((size_class + 1) * IMPL_POOL_GRANULE);
+}
+
+//static
+void LLSD::Impl::operator delete(void* ptr, size_t size)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	U32 size_class = (size + IMPL_POOL_GRANULE - 1) / IMPL_POOL_GRANULE - 1;
+	if (size_class >= IMPL_POOL_CLASSES || sFreeImplCount[size_class] >= IMPL_POOL_MAX_FREE)
+	{
+		MEM_LLSD.sub(size_class >= IMPL_POOL_CLASSES ? size : (size_class + 1) * IMPL_POOL_GRANULE);
+		::operator delete(ptr);
+		return;
+	}
+
+	FreeImpl* node = static_cast<FreeImpl*>(ptr);
+	node->mNext = sFreeImpls[size_class];
+	sFreeImpls[size_class] = node;
+	++sFreeImplCount[size_class];
+}
+
 void LLSD::Impl::reset(Impl*& var, Impl* impl)
 {
 	if (impl && impl->mUseCount != STATIC_USAGE_COUNT) 
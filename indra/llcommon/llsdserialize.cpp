@@ -32,6 +32,7 @@
 #include "llstreamtools.h" // for fullread
 
 #include <iostream>
+#include <sstream>
 #include "apr_base64.h"
 
 #ifdef LL_STANDALONE
@@ -313,6 +314,23 @@ LLSDParser::LLSDParser()
 LLSDParser::~LLSDParser()
 { }
 
+// Documents keyed by id would otherwise grow the cache without bound
+static const size_t MAX_INTERNED_KEYS = 1024;
+
+const std::string& LLSDParser::internKey(const std::string& key) const
+{
+	std::set<std::string>::const_iterator it = mKeyCache.find(key);
+	if (it != mKeyCache.end())
+	{
+		return *it;
+	}
+	if (mKeyCache.size() >= MAX_INTERNED_KEYS)
+	{
+		return key;
+	}
+	return *mKeyCache.insert(key).first;
+}
+
 S32 LLSDParser::parse(std::istream& istr, LLSD& data, S32 max_bytes)
 {
 	mCheckLimits = (LLSDSerialize::SIZE_UNLIMITED == max_bytes) ? false : true;
@@ -695,7 +713,7 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map) const
 					// There must be a value for every key, thus
 					// child_count must be greater than 0.
 					parse_count += count;
-					map.insert(name, child);
+					map.insert(internKey(name), child);
 				}
 				else
 				{
@@ -1130,7 +1148,7 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map) const
 			// There must be a value for every key, thus child_count
 			// must be greater than 0.
 			parse_count += child_count;
-			map.insert(name, child);
+			map.insert(internKey(name), child);
 		}
 		else
 		{
@@ -1497,6 +1515,426 @@ void LLSDBinaryFormatter::formatString(
 	ostr.write(string.c_str(), string.size());
 }
 
+/**
+ * Binary buffer codec
+ */
+namespace
+{
+	inline void put_u32_nbo(std::vector<U8>& out, U32 value)
+	{
+		U32 value_nbo = htonl(value);
+		const U8* bytes = (const U8*)&value_nbo;
+		out.insert(out.end(), bytes, bytes + sizeof(U32));
+	}
+
+	inline void put_bytes(std::vector<U8>& out, const void* data, size_t size)
+	{
+		const U8* bytes = (const U8*)data;
+		out.insert(out.end(), bytes, bytes + size);
+	}
+
+	inline void put_string(std::vector<U8>& out, const std::string& string)
+	{
+		put_u32_nbo(out, string.size());
+		put_bytes(out, string.data(), string.size());
+	}
+
+	// Same output as LLSDBinaryFormatter::format()
+	void format_binary_buffer(const LLSD& data, std::vector<U8>& out)
+	{
+		switch(data.type())
+		{
+		case LLSD::TypeMap:
+		{
+			out.push_back('{');
+			put_u32_nbo(out, data.size());
+			LLSD::map_const_iterator iter = data.beginMap();
+			LLSD::map_const_iterator end = data.endMap();
+			for(; iter != end; ++iter)
+			{
+				out.push_back('k');
+				put_string(out, (*iter).first);
+				format_binary_buffer((*iter).second, out);
+			}
+			out.push_back('}');
+			break;
+		}
+
+		case LLSD::TypeArray:
+		{
+			out.push_back('[');
+			put_u32_nbo(out, data.size());
+			LLSD::array_const_iterator iter = data.beginArray();
+			LLSD::array_const_iterator end = data.endArray();
+			for(; iter != end; ++iter)
+			{
+				format_binary_buffer(*iter, out);
+			}
+			out.push_back(']');
+			break;
+		}
+
+		case LLSD::TypeBoolean:
+			out.push_back(data.asBoolean() ? BINARY_TRUE_SERIAL : BINARY_FALSE_SERIAL);
+			break;
+
+		case LLSD::TypeInteger:
+			out.push_back('i');
+			put_u32_nbo(out, data.asInteger());
+			break;
+
+		case LLSD::TypeReal:
+		{
+			out.push_back('r');
+			F64 value_nbo = ll_htond(data.asReal());
+			put_bytes(out, &value_nbo, sizeof(F64));
+			break;
+		}
+
+		case LLSD::TypeUUID:
+			out.push_back('u');
+			put_bytes(out, data.asUUID().mData, UUID_BYTES);
+			break;
+
+		case LLSD::TypeString:
+			out.push_back('s');
+			put_string(out, data.asString());
+			break;
+
+		case LLSD::TypeDate:
+		{
+			out.push_back('d');
+			F64 value = data.asReal();
+			put_bytes(out, &value, sizeof(F64));
+			break;
+		}
+
+		case LLSD::TypeURI:
+			out.push_back('l');
+			put_string(out, data.asString());
+			break;
+
+		case LLSD::TypeBinary:
+		{
+			out.push_back('b');
+			const LLSD::Binary& buffer = data.asBinary();
+			put_u32_nbo(out, buffer.size());
+			if(buffer.size()) put_bytes(out, &buffer[0], buffer.size());
+			break;
+		}
+
+		case LLSD::TypeUndefined:
+		default:
+			out.push_back('!');
+			break;
+		}
+	}
+
+	// Reads what LLSDBinaryParser reads, straight out of memory. Every
+	// read is checked against the end of the buffer instead of a stream
+	// state. Notation style quoted strings are left to the stream parser.
+	class LLSDBinaryBufferReader
+	{
+	public:
+		LLSDBinaryBufferReader(const U8* data, S32 size)
+		:	mBegin(data), mPos(data), mEnd(data + size), mNeedsStream(false)
+		{ }
+
+		S32 parse(LLSD& data);
+
+		S32 bytesRead() const	{ return mPos - mBegin; }
+		bool needsStream() const	{ return mNeedsStream; }
+
+	private:
+		bool read(void* dst, size_t size)
+		{
+			if ((size_t)(mEnd - mPos) < size)
+			{
+				return false;
+			}
+			memcpy(dst, mPos, size);
+			mPos += size;
+			return true;
+		}
+
+		bool readSize(S32& size)
+		{
+			U32 value_nbo = 0;
+			if (!read(&value_nbo, sizeof(U32)))
+			{
+				return false;
+			}
+			size = (S32)ntohl(value_nbo);
+			return size >= 0;
+		}
+
+		bool readString(std::string& value)
+		{
+			S32 size;
+			if (!readSize(size) || (mEnd - mPos) < size)
+			{
+				return false;
+			}
+			value.assign((const char*)mPos, size);
+			mPos += size;
+			return true;
+		}
+
+		S32 parseMap(LLSD& map);
+		S32 parseArray(LLSD& array);
+
+		const U8* mBegin;
+		const U8* mPos;
+		const U8* mEnd;
+		bool mNeedsStream;
+	};
+
+	S32 LLSDBinaryBufferReader::parse(LLSD& data)
+	{
+		if (mPos >= mEnd)
+		{
+			return 0;
+		}
+
+		S32 parse_count = 1;
+		char c = *mPos++;
+		switch(c)
+		{
+		case '{':
+		case '[':
+		{
+			S32 child_count = (c == '{') ? parseMap(data) : parseArray(data);
+			if (LLSDParser::PARSE_FAILURE == child_count)
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+			}
+			else
+			{
+				parse_count += child_count;
+			}
+			break;
+		}
+
+		case '!':
+			data.clear();
+			break;
+
+		case '0':
+			data = false;
+			break;
+
+		case '1':
+			data = true;
+			break;
+
+		case 'i':
+		{
+			U32 value_nbo = 0;
+			if (!read(&value_nbo, sizeof(U32)))
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+				break;
+			}
+			data = (S32)ntohl(value_nbo);
+			break;
+		}
+
+		case 'r':
+		{
+			F64 real_nbo = 0.0;
+			if (!read(&real_nbo, sizeof(F64)))
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+				break;
+			}
+			data = ll_ntohd(real_nbo);
+			break;
+		}
+
+		case 'u':
+		{
+			LLUUID id;
+			if (!read(id.mData, UUID_BYTES))
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+				break;
+			}
+			data = id;
+			break;
+		}
+
+		case 's':
+		case 'l':
+		{
+			std::string value;
+			if (!readString(value))
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+				break;
+			}
+			if (c == 's')
+			{
+				data = value;
+			}
+			else
+			{
+				data = LLURI(value);
+			}
+			break;
+		}
+
+		case 'd':
+		{
+			F64 real = 0.0;
+			if (!read(&real, sizeof(F64)))
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+				break;
+			}
+			data = LLDate(real);
+			break;
+		}
+
+		case 'b':
+		{
+			S32 size;
+			if (!readSize(size) || (mEnd - mPos) < size)
+			{
+				parse_count = LLSDParser::PARSE_FAILURE;
+				break;
+			}
+			data = LLSD::Binary(mPos, mPos + size);
+			mPos += size;
+			break;
+		}
+
+		case '\'':
+		case '"':
+			mNeedsStream = true;
+			parse_count = LLSDParser::PARSE_FAILURE;
+			break;
+
+		default:
+			parse_count = LLSDParser::PARSE_FAILURE;
+			llinfos << "Unrecognized character while parsing: int(" << (int)c
+				<< ")" << llendl;
+			break;
+		}
+
+		if (LLSDParser::PARSE_FAILURE == parse_count)
+		{
+			data.clear();
+		}
+		return parse_count;
+	}
+
+	S32 LLSDBinaryBufferReader::parseMap(LLSD& map)
+	{
+		map = LLSD::emptyMap();
+		S32 size;
+		if (!readSize(size))
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+
+		S32 parse_count = 0;
+		std::string name;
+		for (S32 count = 0; count < size; ++count)
+		{
+			if (mPos >= mEnd)
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			char c = *mPos++;
+			if (c == '\'' || c == '"')
+			{
+				mNeedsStream = true;
+				return LLSDParser::PARSE_FAILURE;
+			}
+			// any other marker means an empty name, as in LLSDBinaryParser
+			name.clear();
+			if (c == 'k' && !readString(name))
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+
+			// There must be a value for every key
+			S32 child_count = parse(map[name]);
+			if (child_count <= 0)
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			parse_count += child_count;
+		}
+
+		if (mPos >= mEnd || *mPos++ != '}')
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		return parse_count;
+	}
+
+	S32 LLSDBinaryBufferReader::parseArray(LLSD& array)
+	{
+		array = LLSD::emptyArray();
+		S32 size;
+		if (!readSize(size))
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+
+		S32 parse_count = 0;
+		for (S32 count = 0; count < size; ++count)
+		{
+			if (mPos >= mEnd || *mPos == ']')
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			array.append(LLSD());
+			S32 child_count = parse(array[array.size() - 1]);
+			if (child_count <= 0)
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			parse_count += child_count;
+		}
+
+		if (mPos >= mEnd || *mPos++ != ']')
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		return parse_count;
+	}
+}
+
+//static
+void LLSDSerialize::toBinaryBuffer(const LLSD& sd, std::vector<U8>& buffer)
+{
+	format_binary_buffer(sd, buffer);
+}
+
+//static
+S32 LLSDSerialize::fromBinaryBuffer(LLSD& sd, const U8* data, S32 size, S32* bytes_read)
+{
+	LLSDBinaryBufferReader reader(data, size);
+	S32 count = reader.parse(sd);
+	S32 consumed = reader.bytesRead();
+
+	if (reader.needsStream())
+	{
+		std::string str((const char*)data, size);
+		std::istringstream istr(str);
+		count = fromBinary(sd, istr, size);
+		consumed = istr.good() ? (S32)istr.tellg() : size;
+	}
+
+	if (bytes_read)
+	{
+		*bytes_read = consumed;
+	}
+	return count;
+}
+
 /**
  * local functions
  */
@@ -30,6 +30,8 @@
 #define LL_LLSDSERIALIZE_H
 
 #include <iosfwd>
+#include <set>
+#include <string>
 #include "llpointer.h"
 #include "llrefcount.h"
 #include "llsd.h"
@@ -194,6 +196,16 @@ protected:
 	 */
 	void account(S32 bytes) const;
 
+	/**
+	 * @brief Returns a shared copy of a map key.
+	 *
+	 * Bulk documents repeat the same handful of keys in every map, so
+	 * inserting through the cached copy lets them share one buffer.
+	 * @param key The key just read off the stream.
+	 * @return Returns the cached key, or key itself once the cache is full.
+	 */
+	const std::string& internKey(const std::string& key) const;
+
 protected:
 	/**
 	 * @brief boolean to set if byte counts should be checked during parsing.
@@ -209,6 +221,11 @@ protected:
 	 * @brief Use line-based reading to get text
 	 */
 	bool mParseLines;
+
+	/**
+	 * @brief Map keys seen by this parser, see internKey().
+	 */
+	mutable std::set<std::string> mKeyCache;
 };
 
 /** 
@@ -302,6 +319,25 @@ public:
 	 */
 	LLSDXMLParser();
 
+	/** 
+	 * @brief Feeds the next piece of a document that arrives in pieces.
+	 *
+	 * Pieces may split the XML anywhere. Once the last one is in, call
+	 * finishChunks() for the same result parse() gives on the whole.
+	 * @param buf The next bytes of the document.
+	 * @param len The number of bytes in buf.
+	 */
+	void parseChunk(const char* buf, S32 len);
+
+	/** 
+	 * @brief Completes a run of parseChunk() calls and resets the parser.
+	 *
+	 * @param data[out] The newly parse structured data.
+	 * @return Returns the number of LLSD objects parsed into
+	 * data. Returns PARSE_FAILURE (-1) on parse failure.
+	 */
+	S32 finishChunks(LLSD& data);
+
 protected:
 	/** 
 	 * @brief Call this method to parse a stream for LLSD.
@@ -788,6 +824,16 @@ public:
 		(void)p->parse(str, sd, max_bytes);
 		return sd;
 	}
+
+	/*
+	 * Binary buffer methods, the same format as toBinary() and
+	 * fromBinary() without a stream call per element.
+	 */
+	// Appends sd to buffer
+	static void toBinaryBuffer(const LLSD& sd, std::vector<U8>& buffer);
+	// Parses one value from data, bytes_read (if given) gets how much of
+	// data it took. Returns the parse count or LLSDParser::PARSE_FAILURE.
+	static S32 fromBinaryBuffer(LLSD& sd, const U8* data, S32 size, S32* bytes_read = NULL);
 };
 
 //dirty little zip functions -- yell at davep
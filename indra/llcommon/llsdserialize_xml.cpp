@@ -29,10 +29,19 @@
 
 #include <iostream>
 #include <deque>
+#include <set>
 
 #include "apr_base64.h"
 #include <boost/regex.hpp>
 
+#if LL_WINDOWS || __SSE2__
+#include <emmintrin.h>
+#define LL_XML_SCAN_SSE2 1
+#if LL_WINDOWS
+#include <intrin.h>
+#endif
+#endif
+
 extern "C"
 {
 #ifdef LL_STANDALONE
@@ -257,6 +266,9 @@ public:
 	S32 parseLines(std::istream& input, LLSD& data);
 
 	void parsePart(const char *buf, int len);
+
+	void parseChunk(const char* buf, S32 len);
+	S32 finishChunks(LLSD& data);
 	
 	void reset();
 
@@ -293,6 +305,16 @@ private:
 	static Element readElement(const XML_Char* name);
 	
 	static const XML_Char* findAttribute(const XML_Char* name, const XML_Char** pairs);
+
+	// Sets a scalar value from element text, shared by expat and the fast path
+	static void assignScalar(Element element, const std::string& content, LLSD& value);
+
+	// Fast path for documents that stick to what LLSDXMLFormatter writes.
+	// Returns FAST_PARSE_DECLINED, with nothing changed, for anything
+	// else so that expat can have the final say on it.
+	enum { FAST_PARSE_DECLINED = -2 };
+	S32 parseFast(const char* begin, const char* end, LLSD& data);
+	bool parseFastValue(const char*& p, const char* end, LLSD& value);
 	
 
 	XML_Parser	mParser;
@@ -302,6 +324,7 @@ private:
 	
 	bool mInLLSDElement;			// true if we're on LLSD
 	bool mGracefullStop;			// true if we found the </llsd
+	bool mChunkFailed;				// true if a parseChunk() piece was bad
 	
 	typedef std::deque<LLSD*> LLSDRefStack;
 	LLSDRefStack mStack;
@@ -312,6 +335,11 @@ private:
 	
 	std::string mCurrentKey;		// Current XML <tag>
 	std::string mCurrentContent;	// String data between <tag> and </tag>
+
+	// Keys repeat in every map of a bulk document, inserting through one
+	// cached copy lets them share a buffer. Kept across reset().
+	const std::string& internKey(const std::string& key);
+	std::set<std::string> mKeyCache;
 };
 
 
@@ -326,6 +354,20 @@ LLSDXMLParser::Impl::~Impl()
 	XML_ParserFree(mParser);
 }
 
+const std::string& LLSDXMLParser::Impl::internKey(const std::string& key)
+{
+	std::set<std::string>::const_iterator it = mKeyCache.find(key);
+	if (it != mKeyCache.end())
+	{
+		return *it;
+	}
+	if (mKeyCache.size() >= 1024)
+	{ //probably keyed by id, not worth caching
+		return key;
+	}
+	return *mKeyCache.insert(key).first;
+}
+
 inline bool is_eol(char c)
 {
 	return (c == '\n' || c == '\r');
@@ -354,14 +396,576 @@ static unsigned get_till_eol(std::istream& input, char *buf, unsigned bufsize)
 	return count;
 }
 
+//============================================================================
+// Fast path helpers. Text runs are scanned 16 bytes at a time for the
+// characters that end them: '<', '&' and control characters (CR and
+// stray controls need expat, tab and LF are taken as they are).
+
+static inline bool is_xml_space(char c)
+{
+	return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+static inline void skip_xml_space(const char*& p, const char* end)
+{
+	while (p < end && is_xml_space(*p))
+	{
+		++p;
+	}
+}
+
+static inline const char* find_text_end(const char* p, const char* end)
+{
+#if LL_XML_SCAN_SSE2
+	const __m128i lt = _mm_set1_epi8('<');
+	const __m128i amp = _mm_set1_epi8('&');
+	const __m128i ctrl = _mm_set1_epi8(0x1f);
+	while (end - p >= 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*) p);
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, lt), _mm_cmpeq_epi8(v, amp)),
+								   _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));
+		U32 mask = (U32) _mm_movemask_epi8(hit);
+		if (mask)
+		{
+#if LL_WINDOWS
+			unsigned long first;
+			_BitScanForward(&first, mask);
+			return p + first;
+#else
+			return p + __builtin_ctz(mask);
+#endif
+		}
+		p += 16;
+	}
+#endif
+	while (p < end && *p != '<' && *p != '&' && (U8) *p > 0x1f)
+	{
+		++p;
+	}
+	return p;
+}
+
+static void append_utf8(U32 code, std::string& out)
+{
+	if (code < 0x80)
+	{
+		out += (char) code;
+	}
+	else if (code < 0x800)
+	{
+		out += (char) (0xc0 | (code >> 6));
+		out += (char) (0x80 | (code & 0x3f));
+	}
+	else if (code < 0x10000)
+	{
+		out += (char) (0xe0 | (code >> 12));
+		out += (char) (0x80 | ((code >> 6) & 0x3f));
+		out += (char) (0x80 | (code & 0x3f));
+	}
+	else
+	{
+		out += (char) (0xf0 | (code >> 18));
+		out += (char) (0x80 | ((code >> 12) & 0x3f));
+		out += (char) (0x80 | ((code >> 6) & 0x3f));
+		out += (char) (0x80 | (code & 0x3f));
+	}
+}
+
+// p is on the '&', leaves p after the ';'
+static bool decode_xml_entity(const char*& p, const char* end, std::string& out)
+{
+	const char* name = p + 1;
+	const char* semi = name;
+	while (semi < end && semi - name < 10 && *semi != ';')
+	{
+		++semi;
+	}
+	if (semi >= end || *semi != ';' || semi == name)
+	{
+		return false;
+	}
+
+	std::string entity(name, semi);
+	if (entity == "lt")			out += '<';
+	else if (entity == "gt")	out += '>';
+	else if (entity == "amp")	out += '&';
+	else if (entity == "quot")	out += '"';
+	else if (entity == "apos")	out += '\'';
+	else if (entity[0] == '#' && entity.size() > 1)
+	{
+		bool hex = (entity[1] == 'x');
+		const char* digits = entity.c_str() + (hex ? 2 : 1);
+		if (!*digits)
+		{
+			return false;
+		}
+		char* digits_end = NULL;
+		unsigned long code = strtoul(digits, &digits_end, hex ? 16 : 10);
+		if (*digits_end || code == 0 || code > 0x10ffff ||
+			(code >= 0xd800 && code <= 0xdfff) ||
+			(code < 0x20 && code != '\t' && code != '\n' && code != '\r'))
+		{
+			return false;
+		}
+		append_utf8((U32) code, out);
+	}
+	else
+	{
+		return false;
+	}
+
+	p = semi + 1;
+	return true;
+}
+
+// Reads character data up to the next '<', decoding entities
+static bool read_xml_text(const char*& p, const char* end, std::string& out)
+{
+	while (true)
+	{
+		const char* run_end = find_text_end(p, end);
+		out.append(p, run_end);
+		p = run_end;
+		if (p >= end)
+		{
+			return false;
+		}
+
+		char c = *p;
+		if (c == '<')
+		{
+			return true;
+		}
+		else if (c == '&')
+		{
+			if (!decode_xml_entity(p, end, out))
+			{
+				return false;
+			}
+		}
+		else if (c == '\t' || c == '\n')
+		{
+			out += c;
+			++p;
+		}
+		else
+		{ //CR needs line end normalization, anything else is an expat error
+			return false;
+		}
+	}
+}
+
+struct LLSDXMLFastTag
+{
+	char mName[8];
+	bool mClose;
+	bool mEmpty;
+	bool mBase64;
+};
+
+// Reads a tag starting at p, only encoding="base64" is accepted as an attribute
+static bool read_xml_tag(const char*& p, const char* end, LLSDXMLFastTag& tag)
+{
+	if (p >= end || *p != '<')
+	{
+		return false;
+	}
+	++p;
+
+	tag.mClose = (p < end && *p == '/');
+	tag.mEmpty = false;
+	tag.mBase64 = false;
+	if (tag.mClose)
+	{
+		++p;
+	}
+
+	const char* name = p;
+	while (p < end && !is_xml_space(*p) && *p != '/' && *p != '>')
+	{
+		++p;
+	}
+	size_t len = p - name;
+	if (len == 0 || len >= sizeof(tag.mName))
+	{
+		return false;
+	}
+	memcpy(tag.mName, name, len);
+	tag.mName[len] = '\0';
+
+	while (true)
+	{
+		skip_xml_space(p, end);
+		if (p >= end)
+		{
+			return false;
+		}
+		if (*p == '>')
+		{
+			++p;
+			return true;
+		}
+		if (*p == '/' && !tag.mClose)
+		{
+			if (p + 1 >= end || p[1] != '>')
+			{
+				return false;
+			}
+			p += 2;
+			tag.mEmpty = true;
+			return true;
+		}
+
+		if (tag.mClose || tag.mBase64 || end - p < 8 || strncmp(p, "encoding", 8) != 0)
+		{
+			return false;
+		}
+		p += 8;
+		skip_xml_space(p, end);
+		if (p >= end || *p != '=')
+		{
+			return false;
+		}
+		++p;
+		skip_xml_space(p, end);
+		if (end - p < 8 || (*p != '"' && *p != '\'') ||
+			strncmp(p + 1, "base64", 6) != 0 || p[7] != *p)
+		{
+			return false;
+		}
+		p += 8;
+		tag.mBase64 = true;
+	}
+}
+
+static const U8 BASE64_INVALID = 0xff;
+static const U8 BASE64_SKIP = 0xfe;
+
+struct LLSDXMLBase64Table
+{
+	LLSDXMLBase64Table()
+	{
+		const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		memset(mValue, BASE64_INVALID, sizeof(mValue));
+		for (U8 i = 0; i < 64; ++i)
+		{
+			mValue[(U8) alphabet[i]] = i;
+		}
+		mValue[(U8) ' '] = mValue[(U8) '\t'] = mValue[(U8) '\n'] = mValue[(U8) '\r'] = BASE64_SKIP;
+	}
+
+	U8 mValue[256];
+};
+static const LLSDXMLBase64Table sBase64Table;
+
+// Whitespace is skipped and decoding stops at the '=' padding. Returns
+// false on anything apr_base64 would have stopped early on.
+static bool decode_xml_base64(const std::string& text, LLSD::Binary& out)
+{
+	const U8* table = sBase64Table.mValue;
+	const U8* p = (const U8*) text.data();
+	const U8* end = p + text.size();
+
+	out.resize((text.size() / 4) * 3 + 3);
+	U8* dst = out.empty() ? NULL : &out[0];
+	U32 bits = 0;
+	S32 count = 0;
+
+	while (p < end)
+	{
+#if LL_XML_SCAN_SSE2
+		// runs of 16 plain alphabet characters, the common case for
+		// formatter output, skip the per character whitespace checks
+		if (count == 0 && end - p >= 16)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*) p);
+			__m128i special = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x20)), v),
+										   _mm_cmpeq_epi8(v, _mm_set1_epi8('=')));
+			if (!_mm_movemask_epi8(special))
+			{
+				for (S32 i = 0; i < 16; i += 4)
+				{
+					U8 a = table[p[i]], b = table[p[i+1]], c = table[p[i+2]], d = table[p[i+3]];
+					if ((a | b | c | d) & 0xc0)
+					{
+						return false;
+					}
+					U32 quad = (a << 18) | (b << 12) | (c << 6) | d;
+					*dst++ = (U8) (quad >> 16);
+					*dst++ = (U8) (quad >> 8);
+					*dst++ = (U8) quad;
+				}
+				p += 16;
+				continue;
+			}
+		}
+#endif
+		U8 c = *p++;
+		if (c == '=')
+		{
+			break;
+		}
+		U8 v = table[c];
+		if (v == BASE64_SKIP)
+		{
+			continue;
+		}
+		if (v == BASE64_INVALID)
+		{
+			return false;
+		}
+
+		bits = (bits << 6) | v;
+		if (++count == 4)
+		{
+			*dst++ = (U8) (bits >> 16);
+			*dst++ = (U8) (bits >> 8);
+			*dst++ = (U8) bits;
+			bits = 0;
+			count = 0;
+		}
+	}
+
+	if (count == 1)
+	{
+		return false;
+	}
+	if (count == 2)
+	{
+		*dst++ = (U8) (bits >> 4);
+	}
+	else if (count == 3)
+	{
+		*dst++ = (U8) (bits >> 10);
+		*dst++ = (U8) (bits >> 2);
+	}
+
+	out.resize(out.empty() ? 0 : dst - &out[0]);
+	return true;
+}
+
+S32 LLSDXMLParser::Impl::parseFast(const char* begin, const char* end, LLSD& data)
+{
+	const char* p = begin;
+	if (end - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)
+	{
+		p += 3;
+	}
+	skip_xml_space(p, end);
+
+	if (end - p >= 5 && strncmp(p, "<?xml", 5) == 0)
+	{
+		while (p + 1 < end && !(p[0] == '?' && p[1] == '>'))
+		{
+			++p;
+		}
+		if (p + 1 >= end)
+		{
+			return FAST_PARSE_DECLINED;
+		}
+		p += 2;
+		skip_xml_space(p, end);
+	}
+
+	LLSDXMLFastTag tag;
+	if (!read_xml_tag(p, end, tag) || tag.mClose || tag.mBase64 ||
+		readElement(tag.mName) != ELEMENT_LLSD)
+	{
+		return FAST_PARSE_DECLINED;
+	}
+
+	S32 start_count = mParseCount;
+	LLSD result;
+	if (!tag.mEmpty)
+	{
+		skip_xml_space(p, end);
+		if (p + 1 < end && p[1] != '/' && !parseFastValue(p, end, result))
+		{
+			mParseCount = start_count;
+			return FAST_PARSE_DECLINED;
+		}
+
+		skip_xml_space(p, end);
+		if (!read_xml_tag(p, end, tag) || !tag.mClose || readElement(tag.mName) != ELEMENT_LLSD)
+		{
+			mParseCount = start_count;
+			return FAST_PARSE_DECLINED;
+		}
+	}
+
+	data = result;
+	return mParseCount;
+}
+
+bool LLSDXMLParser::Impl::parseFastValue(const char*& p, const char* end, LLSD& value)
+{
+	LLSDXMLFastTag tag;
+	if (!read_xml_tag(p, end, tag) || tag.mClose)
+	{
+		return false;
+	}
+
+	Element element = readElement(tag.mName);
+	if (element == ELEMENT_UNKNOWN || element == ELEMENT_LLSD || element == ELEMENT_KEY ||
+		(tag.mBase64 && element != ELEMENT_BINARY))
+	{
+		return false;
+	}
+
+	++mParseCount;
+
+	if (element == ELEMENT_MAP)
+	{
+		value = LLSD::emptyMap();
+		if (tag.mEmpty)
+		{
+			return true;
+		}
+
+		std::string key;
+		while (true)
+		{
+			skip_xml_space(p, end);
+			if (!read_xml_tag(p, end, tag))
+			{
+				return false;
+			}
+			Element next = readElement(tag.mName);
+			if (tag.mClose)
+			{
+				return next == ELEMENT_MAP;
+			}
+			if (next != ELEMENT_KEY || tag.mEmpty || tag.mBase64)
+			{
+				return false;
+			}
+
+			key.clear();
+			if (!read_xml_text(p, end, key) ||
+				!read_xml_tag(p, end, tag) || !tag.mClose || readElement(tag.mName) != ELEMENT_KEY ||
+				key.empty())
+			{ //an empty key makes expat skip the value
+				return false;
+			}
+
+			skip_xml_space(p, end);
+			if (!parseFastValue(p, end, value[internKey(key)]))
+			{
+				return false;
+			}
+		}
+	}
+
+	if (element == ELEMENT_ARRAY)
+	{
+		value = LLSD::emptyArray();
+		if (tag.mEmpty)
+		{
+			return true;
+		}
+
+		while (true)
+		{
+			skip_xml_space(p, end);
+			if (p + 1 < end && p[0] == '<' && p[1] == '/')
+			{
+				return read_xml_tag(p, end, tag) && readElement(tag.mName) == ELEMENT_ARRAY;
+			}
+
+			value.append(LLSD());
+			if (!parseFastValue(p, end, value[value.size()-1]))
+			{
+				return false;
+			}
+		}
+	}
+
+	std::string& content = mCurrentContent;
+	content.clear();
+	if (!tag.mEmpty)
+	{
+		LLSDXMLFastTag close;
+		if (!read_xml_text(p, end, content) ||
+			!read_xml_tag(p, end, close) || !close.mClose || readElement(close.mName) != element)
+		{
+			return false;
+		}
+	}
+
+	switch (element)
+	{
+		case ELEMENT_UNDEF:
+			value.clear();
+			break;
+
+		case ELEMENT_BINARY:
+		{
+			LLSD::Binary binary;
+			if (!decode_xml_base64(content, binary))
+			{
+				return false;
+			}
+			value = binary;
+			break;
+		}
+
+		default:
+			assignScalar(element, content, value);
+			break;
+	}
+	content.clear();
+	return true;
+}
+
+// Reads input up to and including the line holding </llsd>, which is
+// about where the expat loop used to stop consuming the stream
+static void read_xml_document(std::istream& input, std::string& document)
+{
+	static const int BUFFER_SIZE = 1024;
+	char buffer[BUFFER_SIZE];
+	while (input.good() && !input.eof())
+	{
+		unsigned count = get_till_eol(input, buffer, BUFFER_SIZE);
+		if (!count)
+		{
+			break;
+		}
+		size_t old_size = document.size();
+		document.append(buffer, count);
+
+		size_t search_from = old_size > 7 ? old_size - 7 : 0;
+		if (document.find("</llsd>", search_from) != std::string::npos)
+		{
+			break;
+		}
+	}
+}
+
 S32 LLSDXMLParser::Impl::parse(std::istream& input, LLSD& data)
 {
-	XML_Status status;
+	std::string document;
+	read_xml_document(input, document);
+
+	S32 fast_count = parseFast(document.data(), document.data() + document.size(), data);
+	if (fast_count != FAST_PARSE_DECLINED)
+	{
+		clear_eol(input);
+		return fast_count;
+	}
+
+	// Not something the fast path knows, give expat what was read so far
+	// and carry on with the rest of the stream as before
+	XML_Status status = XML_STATUS_OK;
+	if (!document.empty())
+	{
+		status = XML_Parse(mParser, document.data(), document.size(), false);
+	}
 	
 	static const int BUFFER_SIZE = 1024;
 	void* buffer = NULL;	
 	int count = 0;
-	while (input.good() && !input.eof())
+	while (status != XML_STATUS_ERROR && !mGracefullStop && input.good() && !input.eof())
 	{
 		buffer = XML_GetBuffer(mParser, BUFFER_SIZE);
 
@@ -402,7 +1006,9 @@ S32 LLSDXMLParser::Impl::parse(std::istream& input, LLSD& data)
 		{
 			((char*) buffer)[count ? count - 1 : 0] = '\0';
 		}
-		llinfos << "LLSDXMLParser::Impl::parse: XML_STATUS_ERROR parsing:" << (char*) buffer << llendl;
+		// the whole document may have gone through XML_Parse() above
+		const char* context = buffer ? (const char*) buffer : document.c_str();
+		llinfos << "LLSDXMLParser::Impl::parse: XML_STATUS_ERROR parsing:" << context << llendl;
 		data = LLSD();
 		return LLSDParser::PARSE_FAILURE;
 	}
@@ -499,6 +1105,7 @@ void LLSDXMLParser::Impl::reset()
 	mDepth = 0;
 
 	mGracefullStop = false;
+	mChunkFailed = false;
 
 	mStack.clear();
 	
@@ -546,6 +1153,48 @@ void LLSDXMLParser::Impl::parsePart(const char* buf, int len)
 	}
 }
 
+void LLSDXMLParser::Impl::parseChunk(const char* buf, S32 len)
+{
+	// Anything after </llsd> is ignored, as parse() does
+	if (mChunkFailed || mGracefullStop || buf == NULL || len <= 0)
+	{
+		return;
+	}
+
+	XML_Status status = XML_Parse(mParser, buf, len, false);
+	if (status == XML_STATUS_ERROR && !mGracefullStop)
+	{
+		mChunkFailed = true;
+	}
+}
+
+S32 LLSDXMLParser::Impl::finishChunks(LLSD& data)
+{
+	if (!mChunkFailed && !mGracefullStop)
+	{
+		XML_Status status = XML_Parse(mParser, NULL, 0, true);
+		if (status == XML_STATUS_ERROR && !mGracefullStop)
+		{
+			mChunkFailed = true;
+		}
+	}
+
+	S32 count = LLSDParser::PARSE_FAILURE;
+	if (mChunkFailed)
+	{
+		llinfos << "LLSDXMLParser::Impl::finishChunks: XML_STATUS_ERROR" << llendl;
+		data = LLSD();
+	}
+	else
+	{
+		data = mResult;
+		count = mParseCount;
+	}
+
+	reset();
+	return count;
+}
+
 // Performance testing code
 //#define	XML_PARSER_PERFORMANCE_TESTS
 
@@ -629,7 +1278,7 @@ void LLSDXMLParser::Impl::startElementHandler(const XML_Char* name, const XML_Ch
 		if (mCurrentKey.empty()) { return startSkipping(); }
 		
 		LLSD& map = *mStack.back();
-		LLSD& newElement = map[mCurrentKey];
+		LLSD& newElement = map[internKey(mCurrentKey)];
 		mStack.push_back(&newElement);		
 
 		mCurrentKey.clear();
@@ -713,86 +1362,107 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
 			break;
 		
 		case ELEMENT_BOOL:
-			value = (mCurrentContent == "true" || mCurrentContent == "1");
+		case ELEMENT_INTEGER:
+		case ELEMENT_REAL:
+		case ELEMENT_STRING:
+		case ELEMENT_UUID:
+		case ELEMENT_DATE:
+		case ELEMENT_URI:
+			assignScalar(element, mCurrentContent, value);
+			break;
+		
+		case ELEMENT_BINARY:
+		{
+			// Regex is expensive, but only fix for whitespace in base64,
+			// created by python and other non-linden systems - DEV-39358
+			// Fortunately we have very little binary passing now,
+			// so performance impact shold be negligible. + poppy 2009-09-04
+			boost::regex r;
+			r.assign("\\s");
+			std::string stripped = boost::regex_replace(mCurrentContent, r, "");
+			S32 len = apr_base64_decode_len(stripped.c_str());
+			std::vector<U8> data;
+			data.resize(len);
+			len = apr_base64_decode_binary(&data[0], stripped.c_str());
+			data.resize(len);
+			value = data;
+			break;
+		}
+		
+		case ELEMENT_UNKNOWN:
+			value.clear();
+			break;
+			
+		default:
+			// other values, map and array, have already been set
+			break;
+	}
+
+	mCurrentContent.clear();
+}
+
+//static
+void LLSDXMLParser::Impl::assignScalar(Element element, const std::string& content, LLSD& value)
+{
+	switch (element)
+	{
+		case ELEMENT_BOOL:
+			value = (content == "true" || content == "1");
 			break;
 		
 		case ELEMENT_INTEGER:
 			{
 				S32 i;
 				// sscanf okay here with different locales - ints don't change for different locale settings like floats do.
-				if ( sscanf(mCurrentContent.c_str(), "%d", &i ) == 1 )
+				if ( sscanf(content.c_str(), "%d", &i ) == 1 )
 				{	// See if sscanf works - it's faster
 					value = i;
 				}
 				else
 				{
-					value = LLSD(mCurrentContent).asInteger();
+					value = LLSD(content).asInteger();
 				}
 			}
 			break;
 		
 		case ELEMENT_REAL:
 			{
-				value = LLSD(mCurrentContent).asReal();
+				value = LLSD(content).asReal();
 				// removed since this breaks when locale has decimal separator that isn't '.'
 				// investigated changing local to something compatible each time but deemed higher
 				// risk that just using LLSD.asReal() each time.
 				//F64 r;
-				//if ( sscanf(mCurrentContent.c_str(), "%lf", &r ) == 1 )
+				//if ( sscanf(content.c_str(), "%lf", &r ) == 1 )
 				//{	// See if sscanf works - it's faster
 				//	value = r;
 				//}
 				//else
 				//{
-				//	value = LLSD(mCurrentContent).asReal();
+				//	value = LLSD(content).asReal();
 				//}
 			}
 			break;
 		
 		case ELEMENT_STRING:
-			value = mCurrentContent;
+			value = content;
 			break;
 		
 		case ELEMENT_UUID:
-			value = LLSD(mCurrentContent).asUUID();
+			value = LLSD(content).asUUID();
 			break;
 		
 		case ELEMENT_DATE:
-			value = LLSD(mCurrentContent).asDate();
+			value = LLSD(content).asDate();
 			break;
 		
 		case ELEMENT_URI:
-			value = LLSD(mCurrentContent).asURI();
-			break;
-		
-		case ELEMENT_BINARY:
-		{
-			// Regex is expensive, but only fix for whitespace in base64,
-			// created by python and other non-linden systems - DEV-39358
-			// Fortunately we have very little binary passing now,
-			// so performance impact shold be negligible. + poppy 2009-09-04
-			boost::regex r;
-			r.assign("\\s");
-			std::string stripped = boost::regex_replace(mCurrentContent, r, "");
-			S32 len = apr_base64_decode_len(stripped.c_str());
-			std::vector<U8> data;
-			data.resize(len);
-			len = apr_base64_decode_binary(&data[0], stripped.c_str());
-			data.resize(len);
-			value = data;
+			value = LLSD(content).asURI();
 			break;
-		}
-		
-		case ELEMENT_UNKNOWN:
-			value.clear();
-			break;
-			
+
 		default:
-			// other values, map and array, have already been set
+			value.clear();
 			break;
 	}
-
-	mCurrentContent.clear();
 }
 
 void LLSDXMLParser::Impl::characterDataHandler(const XML_Char* data, int length)
@@ -911,6 +1581,16 @@ void LLSDXMLParser::parsePart(const char *buf, int len)
 	impl.parsePart(buf, len);
 }
 
+void LLSDXMLParser::parseChunk(const char* buf, S32 len)
+{
+	impl.parseChunk(buf, len);
+}
+
+S32 LLSDXMLParser::finishChunks(LLSD& data)
+{
+	return impl.finishChunks(data);
+}
+
 // virtual
 S32 LLSDXMLParser::doParse(std::istream& input, LLSD& data) const
 {
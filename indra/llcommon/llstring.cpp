@@ -36,6 +36,11 @@
 #include <winnls.h> // for WideCharToMultiByte
 #endif
 
+#if LL_WINDOWS || __SSE2__
+#include <emmintrin.h>
+#define LL_STRING_SSE2 1
+#endif
+
 LLFastTimer::DeclareTimer FT_STRING_FORMAT("String Format");
 
 
@@ -374,15 +379,64 @@ S32 wstring_utf8_length(const LLWString& wstr)
 }
 
 
-LLWString utf8str_to_wstring(const std::string& utf8str, S32 len)
+static bool is_ascii(const char* p, size_t len)
 {
-	LLWString wout;
+	size_t i = 0;
+#if LL_STRING_SSE2
+	for (; i + 16 <= len; i += 16)
+	{
+		if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*) (p + i))))
+		{
+			return false;
+		}
+	}
+#endif
+	for (; i < len; ++i)
+	{
+		if ((U8) p[i] >= 0x80)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Decodes len bytes of utf8 into out, which must have room for len
+// characters.  Returns the number of characters written.  Reads up to
+// utf8[len], so utf8 has to be null terminated like std::string data.
+static S32 utf8_to_wchars(const char* utf8, S32 len, llwchar* out)
+{
+	llwchar* out_start = out;
 
 	S32 i = 0;
 	while (i < len)
 	{
+#if LL_STRING_SSE2
+		// widen runs of ascii 16 bytes at a time
+		while (len - i >= 16)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*) (utf8 + i));
+			if (_mm_movemask_epi8(v))
+			{
+				break;
+			}
+			const __m128i zero = _mm_setzero_si128();
+			__m128i lo = _mm_unpacklo_epi8(v, zero);
+			__m128i hi = _mm_unpackhi_epi8(v, zero);
+			_mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128((__m128i*) (out + 4), _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128((__m128i*) (out + 8), _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128((__m128i*) (out + 12), _mm_unpackhi_epi16(hi, zero));
+			out += 16;
+			i += 16;
+		}
+		if (i >= len)
+		{
+			break;
+		}
+#endif
 		llwchar unichar;
-		U8 cur_char = utf8str[i];
+		U8 cur_char = utf8[i];
 
 		if (cur_char < 0x80)
 		{
@@ -419,7 +473,7 @@ LLWString utf8str_to_wstring(const std::string& utf8str, S32 len)
 			}
 			else
 			{
-				wout += LL_UNKNOWN_CHAR;
+				*out++ = LL_UNKNOWN_CHAR;
 				++i;
 				continue;
 			}
@@ -430,7 +484,7 @@ LLWString utf8str_to_wstring(const std::string& utf8str, S32 len)
 			{
 				++i;
 
-				cur_char = utf8str[i];
+				cur_char = utf8[i];
 				if ( (cur_char >> 6) == 0x2 )
 				{
 					unichar <<= 6;
@@ -456,9 +510,21 @@ LLWString utf8str_to_wstring(const std::string& utf8str, S32 len)
 			}
 		}
 
-		wout += unichar;
+		*out++ = unichar;
 		++i;
 	}
+	return (S32) (out - out_start);
+}
+
+LLWString utf8str_to_wstring(const std::string& utf8str, S32 len)
+{
+	LLWString wout;
+	if (len > 0)
+	{
+		// a character never takes fewer than one byte, so len is enough room
+		wout.resize(len);
+		wout.resize(utf8_to_wchars(utf8str.c_str(), len, &wout[0]));
+	}
 	return wout;
 }
 
@@ -468,19 +534,85 @@ LLWString utf8str_to_wstring(const std::string& utf8str)
 	return utf8str_to_wstring(utf8str, len);
 }
 
-std::string wstring_to_utf8str(const LLWString& utf32str, S32 len)
+void utf8str_to_wstring(const std::string& utf8str, LLWString& out)
 {
-	std::string out;
+	const S32 len = (S32)utf8str.length();
+	out.resize(len);
+	if (len > 0)
+	{
+		out.resize(utf8_to_wchars(utf8str.c_str(), len, &out[0]));
+	}
+}
+
+// Encodes len characters of utf32 into out, starting at out[0].  Like the
+// old += of a null terminated buffer, null characters are dropped.
+static void wchars_to_utf8(const llwchar* utf32, S32 len, std::string& out)
+{
+	// out always has at least one byte for every character left to encode
+	out.resize(len);
+	S32 pos = 0;
 
 	S32 i = 0;
 	while (i < len)
 	{
-		char tchars[8];		/* Flawfinder: ignore */
-		S32 n = wchar_to_utf8chars(utf32str[i], tchars);
-		tchars[n] = 0;
-		out += tchars;
+#if LL_STRING_SSE2
+		// narrow runs of ascii 16 characters at a time
+		const __m128i not_ascii = _mm_set1_epi32(~0x7F);
+		const __m128i zero = _mm_setzero_si128();
+		while (len - i >= 16)
+		{
+			__m128i a = _mm_loadu_si128((const __m128i*) (utf32 + i));
+			__m128i b = _mm_loadu_si128((const __m128i*) (utf32 + i + 4));
+			__m128i c = _mm_loadu_si128((const __m128i*) (utf32 + i + 8));
+			__m128i d = _mm_loadu_si128((const __m128i*) (utf32 + i + 12));
+			__m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+			__m128i ascii = _mm_cmpeq_epi32(_mm_and_si128(any, not_ascii), zero);
+			__m128i nul = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(a, zero), _mm_cmpeq_epi32(b, zero)),
+									   _mm_or_si128(_mm_cmpeq_epi32(c, zero), _mm_cmpeq_epi32(d, zero)));
+			if (_mm_movemask_epi8(ascii) != 0xFFFF || _mm_movemask_epi8(nul))
+			{
+				break;
+			}
+			__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+			_mm_storeu_si128((__m128i*) &out[pos], packed);
+			pos += 16;
+			i += 16;
+		}
+		if (i >= len)
+		{
+			break;
+		}
+#endif
+		llwchar cur_char = utf32[i];
+		if (cur_char < 0x80)
+		{
+			if (cur_char)
+			{
+				out[pos++] = (char) cur_char;
+			}
+		}
+		else
+		{
+			// room for the longest sequence plus a byte for each character after this one
+			S32 needed = pos + 6 + (len - i - 1);
+			if ((S32) out.size() < needed)
+			{
+				out.resize(needed + (len - i));
+			}
+			pos += wchar_to_utf8chars(cur_char, &out[pos]);
+		}
 		i++;
 	}
+	out.resize(pos);
+}
+
+std::string wstring_to_utf8str(const LLWString& utf32str, S32 len)
+{
+	std::string out;
+	if (len > 0)
+	{
+		wchars_to_utf8(utf32str.c_str(), len, out);
+	}
 	return out;
 }
 
@@ -490,6 +622,11 @@ std::string wstring_to_utf8str(const LLWString& utf32str)
 	return wstring_to_utf8str(utf32str, len);
 }
 
+void wstring_to_utf8str(const LLWString& utf32str, std::string& out)
+{
+	wchars_to_utf8(utf32str.c_str(), (S32)utf32str.length(), out);
+}
+
 std::string utf16str_to_utf8str(const llutf16string& utf16str)
 {
 	return wstring_to_utf8str(utf16str_to_wstring(utf16str));
@@ -510,6 +647,13 @@ std::string utf8str_trim(const std::string& utf8str)
 
 std::string utf8str_tolower(const std::string& utf8str)
 {
+	if (is_ascii(utf8str.data(), utf8str.size()))
+	{ //no multibyte characters, fold the bytes directly
+		std::string out_str(utf8str);
+		LLStringUtil::toLower(out_str);
+		return out_str;
+	}
+
 	LLWString out_str = utf8str_to_wstring(utf8str);
 	LLWStringUtil::toLower(out_str);
 	return wstring_to_utf8str(out_str);
@@ -904,6 +1048,60 @@ namespace LLStringFn
 
 ////////////////////////////////////////////////////////////
 
+// Flips the case of 'A'-'Z' (or 'a'-'z' for UPPER) 16 bytes at a time.
+// Blocks with anything outside ascii go through toupper/tolower so the
+// locale still decides what happens to those bytes.
+template <bool UPPER>
+static void fold_case(std::string& string)
+{
+	char* p = &string[0];
+	const size_t len = string.size();
+	size_t i = 0;
+#if LL_STRING_SSE2
+	const __m128i first = _mm_set1_epi8(UPPER ? 'a' - 1 : 'A' - 1);
+	const __m128i last = _mm_set1_epi8(UPPER ? 'z' + 1 : 'Z' + 1);
+	const __m128i flip = _mm_set1_epi8(0x20);
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*) (p + i));
+		if (_mm_movemask_epi8(v))
+		{
+			for (size_t j = i; j < i + 16; ++j)
+			{
+				p[j] = UPPER ? LLStringOps::toUpper(p[j]) : LLStringOps::toLower(p[j]);
+			}
+			continue;
+		}
+		__m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, first), _mm_cmplt_epi8(v, last));
+		_mm_storeu_si128((__m128i*) (p + i), _mm_xor_si128(v, _mm_and_si128(in_range, flip)));
+	}
+#endif
+	for (; i < len; ++i)
+	{
+		p[i] = UPPER ? LLStringOps::toUpper(p[i]) : LLStringOps::toLower(p[i]);
+	}
+}
+
+//static
+template<>
+void LLStringUtil::toUpper(std::string& string)
+{
+	if (!string.empty())
+	{
+		fold_case<true>(string);
+	}
+}
+
+//static
+template<>
+void LLStringUtil::toLower(std::string& string)
+{
+	if (!string.empty())
+	{
+		fold_case<false>(string);
+	}
+}
+
 // Forward specialization of LLStringUtil::format before use in LLStringUtil::formatDatetime.
 template<>
 S32 LLStringUtil::format(std::string& s, const format_map_t& substitutions);
@@ -455,6 +455,9 @@ LL_COMMON_API llutf16string utf8str_to_utf16str ( const std::string& utf8str );
 
 LL_COMMON_API LLWString utf8str_to_wstring(const std::string &utf8str, S32 len);
 LL_COMMON_API LLWString utf8str_to_wstring(const std::string &utf8str);
+// Converts into out, replacing its contents.  Reusing one string across
+// calls keeps its buffer, so steady state conversions don't allocate.
+LL_COMMON_API void utf8str_to_wstring(const std::string &utf8str, LLWString& out);
 // Same function, better name. JC
 inline LLWString utf8string_to_wstring(const std::string& utf8_string) { return utf8str_to_wstring(utf8_string); }
 
@@ -463,6 +466,8 @@ LL_COMMON_API S32 wchar_to_utf8chars(llwchar inchar, char* outchars);
 
 LL_COMMON_API std::string wstring_to_utf8str(const LLWString &utf32str, S32 len);
 LL_COMMON_API std::string wstring_to_utf8str(const LLWString &utf32str);
+// Converts into out, replacing its contents, see utf8str_to_wstring above.
+LL_COMMON_API void wstring_to_utf8str(const LLWString &utf32str, std::string& out);
 
 LL_COMMON_API std::string utf16str_to_utf8str(const llutf16string &utf16str, S32 len);
 LL_COMMON_API std::string utf16str_to_utf8str(const llutf16string &utf16str);
@@ -836,6 +841,10 @@ void LLStringUtilBase<T>::toLower(std::basic_string<T>& string)
 	}
 }
 
+// the char versions fold ascii 16 bytes at a time, see llstring.cpp
+template<> LL_COMMON_API void LLStringUtilBase<char>::toUpper(std::basic_string<char>& string);
+template<> LL_COMMON_API void LLStringUtilBase<char>::toLower(std::basic_string<char>& string);
+
 //static
 template<class T> 
 void LLStringUtilBase<T>::trimHead(std::basic_string<T>& string)
@@ -29,6 +29,8 @@
 
 #include "llstringtable.h"
 #include "llstl.h"
+#include "llthread.h"
+#include "apr_atomic.h"
 
 LLStringTable gStringTable(32768);
 
@@ -356,3 +358,161 @@ void LLStringTable::removeString(const char *str)
 	}
 }
 
+
+//============================================================================
+// LLStringInterner
+
+LLStringInterner::LLStringInterner(U32 tablesize)
+:	mTable(NULL),
+	mLock(0),
+	mCount(0)
+{
+	U32 size = 16;
+	while (size < tablesize)
+	{
+		size <<= 1;
+	}
+
+	Table* table = new Table;
+	table->mMask = size - 1;
+	table->mSlots = new Slot[size];
+	table->mPrev = NULL;
+	memset((void*)table->mSlots, 0, size * sizeof(Slot));
+	mTable = table;
+}
+
+LLStringInterner::~LLStringInterner()
+{
+	Table* table = mTable;
+	for (U32 i = 0; i <= table->mMask; i++)
+	{
+		delete [] table->mSlots[i].mString;
+	}
+
+	while (table)
+	{
+		Table* prev = table->mPrev;
+		delete [] table->mSlots;
+		delete table;
+		table = prev;
+	}
+}
+
+//static
+U32 LLStringInterner::hash(const char* str)
+{
+	// FNV-1a
+	U32 hashval = 2166136261u;
+	while (*str)
+	{
+		hashval = (hashval ^ (U8)*str++) * 16777619u;
+	}
+	return hashval;
+}
+
+//static
+const char* LLStringInterner::find(const Table* table, const char* str, U32 hashval)
+{
+	for (U32 i = hashval & table->mMask; ; i = (i + 1) & table->mMask)
+	{
+		const Slot& slot = table->mSlots[i];
+		const char* entry = slot.mString;
+		if (!entry)
+		{
+			return NULL;
+		}
+		if (slot.mHash == hashval && !strcmp(entry, str))
+		{
+			return entry;
+		}
+	}
+}
+
+const char* LLStringInterner::find(const char* str) const
+{
+	if (!str)
+	{
+		return NULL;
+	}
+	return find(mTable, str, hash(str));
+}
+
+void LLStringInterner::insert(Table* table, const char* str, U32 hashval)
+{
+	U32 i = hashval & table->mMask;
+	while (table->mSlots[i].mString)
+	{
+		i = (i + 1) & table->mMask;
+	}
+	// readers check the pointer first, so it has to land after the hash
+	table->mSlots[i].mHash = hashval;
+	apr_atomic_xchgptr((volatile void**)&table->mSlots[i].mString, (void*)str);
+}
+
+const char* LLStringInterner::intern(const char* str)
+{
+	if (!str)
+	{
+		return NULL;
+	}
+
+	U32 hashval = hash(str);
+	const char* result = find(mTable, str, hashval);
+	if (result)
+	{
+		return result;
+	}
+
+	while (apr_atomic_cas32(&mLock, 1, 0) != 0)
+	{
+		LLThread::yield();
+	}
+
+	// someone may have added it while we waited
+	Table* table = mTable;
+	result = find(table, str, hashval);
+	if (!result)
+	{
+		if ((mCount + 1) * 2 > table->mMask + 1)
+		{
+			U32 size = (table->mMask + 1) * 2;
+			Table* grown = new Table;
+			grown->mMask = size - 1;
+			grown->mSlots = new Slot[size];
+			grown->mPrev = table;
+			memset((void*)grown->mSlots, 0, size * sizeof(Slot));
+			for (U32 i = 0; i <= table->mMask; i++)
+			{
+				if (table->mSlots[i].mString)
+				{
+					insert(grown, table->mSlots[i].mString, table->mSlots[i].mHash);
+				}
+			}
+			apr_atomic_xchgptr((volatile void**)&mTable, grown);
+			table = grown;
+		}
+
+		size_t length = strlen(str) + 1;	/* Flawfinder: ignore */
+		char* copy = new char[length];
+		memcpy(copy, str, length);	/* Flawfinder: ignore */
+		insert(table, copy, hashval);
+		mCount++;
+		result = copy;
+	}
+
+	apr_atomic_set32(&mLock, 0);
+	return result;
+}
+
+void LLStringInterner::getStrings(std::vector<const char*>& strings) const
+{
+	const Table* table = mTable;
+	for (U32 i = 0; i <= table->mMask; i++)
+	{
+		const char* entry = table->mSlots[i].mString;
+		if (entry)
+		{
+			strings.push_back(entry);
+		}
+	}
+}
@@ -33,6 +33,7 @@
 #include "llstl.h"
 #include <list>
 #include <set>
+#include <vector>
 
 #if LL_WINDOWS
 # if (_MSC_VER >= 1300 && _MSC_VER < 1400)
@@ -213,5 +214,53 @@ private:
 	string_set_t* mStringList; // [mTableSize]
 };
 
+//============================================================================
+
+// Interns strings so they can be compared by pointer.
+// Strings are never removed, so returned pointers stay valid for the life
+// of the table.  Lookups never lock and may run on any thread; adding a new
+// string takes a short spin lock.  Open addressing, kept at most half full.
+class LL_COMMON_API LLStringInterner
+{
+public:
+	LLStringInterner(U32 tablesize = 1024);
+	~LLStringInterner();
+
+	// returns the interned copy of str, or NULL if it was never added
+	const char* find(const char* str) const;
+	const char* find(const std::string& str) const { return find(str.c_str()); }
+
+	// returns the interned copy of str, adding it if needed
+	const char* intern(const char* str);
+	const char* intern(const std::string& str) { return intern(str.c_str()); }
+
+	U32 size() const { return mCount; }
+
+	// snapshot of every interned string, in no particular order
+	void getStrings(std::vector<const char*>& strings) const;
+
+private:
+	struct Slot
+	{
+		volatile U32	mHash;
+		const char* volatile mString;	// published after mHash
+	};
+
+	struct Table
+	{
+		U32		mMask;
+		Slot*	mSlots;
+		Table*	mPrev;	// outgrown tables stay alive for readers still probing them
+	};
+
+	static U32 hash(const char* str);
+	static const char* find(const Table* table, const char* str, U32 hashval);
+	void insert(Table* table, const char* str, U32 hashval);
+
+	Table* volatile mTable;
+	volatile U32	mLock;
+	U32				mCount;
+};
+
 
 #endif
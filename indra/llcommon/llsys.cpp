@@ -597,11 +597,33 @@ LLCPUInfo::LLCPUInfo()
 	// proc.WriteInfoTextFile("procInfo.txt");
 	mHasSSE = proc.hasSSE();
 	mHasSSE2 = proc.hasSSE2();
+	mHasAVX = proc.hasAVX();
 	mHasAltivec = proc.hasAltivec();
 	mCPUMHz = (F64)proc.getCPUFrequency();
 	mFamily = proc.getCPUFamilyName();
 	mCPUString = "Unknown";
 
+	mProcessorCount = 1;
+#if LL_WINDOWS
+	SYSTEM_INFO sys_info;
+	GetSystemInfo(&sys_info);
+	mProcessorCount = (S32)sys_info.dwNumberOfProcessors;
+#elif LL_DARWIN
+	int cpu_count = 0;
+	size_t len = sizeof(cpu_count);
+	if (sysctlbyname("hw.logicalcpu", &cpu_count, &len, NULL, 0) == 0)
+	{
+		mProcessorCount = cpu_count;
+	}
+#else
+	long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpu_count > 0)
+	{
+		mProcessorCount = (S32)cpu_count;
+	}
+#endif
+	mProcessorCount = llmax(mProcessorCount, 1);
+
 	out << proc.getCPUBrandName();
 	if (200 < mCPUMHz && mCPUMHz < 10000)           // *NOTE: cpu speed is often way wrong, do a sanity check
 	{
@@ -626,6 +648,11 @@ bool LLCPUInfo::hasSSE2() const
 	return mHasSSE2;
 }
 
+bool LLCPUInfo::hasAVX() const
+{
+	return mHasAVX;
+}
+
 F64 LLCPUInfo::getMHz() const
 {
 	return mCPUMHz;
@@ -645,8 +672,10 @@ void LLCPUInfo::stream(std::ostream& s) const
 	// CPU's attributes regardless of platform
 	s << "->mHasSSE:     " << (U32)mHasSSE << std::endl;
 	s << "->mHasSSE2:    " << (U32)mHasSSE2 << std::endl;
+	s << "->mHasAVX:     " << (U32)mHasAVX << std::endl;
 	s << "->mHasAltivec: " << (U32)mHasAltivec << std::endl;
 	s << "->mCPUMHz:     " << mCPUMHz << std::endl;
+	s << "->mProcessorCount: " << mProcessorCount << std::endl;
 	s << "->mCPUString:  " << mCPUString << std::endl;
 }
 
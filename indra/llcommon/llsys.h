@@ -76,7 +76,10 @@ public:
 	bool hasAltivec() const;
 	bool hasSSE() const;
 	bool hasSSE2() const;
+	bool hasAVX() const;
 	F64 getMHz() const;
+	// Number of logical processors available to the process (at least 1).
+	S32 getProcessorCount() const { return mProcessorCount; }
 
 	// Family is "AMD Duron" or "Intel Pentium Pro"
 	const std::string& getFamily() const { return mFamily; }
@@ -84,8 +87,10 @@ public:
 private:
 	bool mHasSSE;
 	bool mHasSSE2;
+	bool mHasAVX;
 	bool mHasAltivec;
 	F64 mCPUMHz;
+	S32 mProcessorCount;
 	std::string mFamily;
 	std::string mCPUString;
 };
@@ -31,6 +31,8 @@
 #include "llthread.h"
 
 #include "lltimer.h"
+#include "llmemory.h"
+#include "llfasttimer.h"
 
 #if LL_LINUX || LL_SOLARIS
 #include <sched.h>
@@ -82,9 +84,14 @@ void *APR_THREAD_FUNC LLThread::staticRun(apr_thread_t *apr_threadp, void *datap
 	sThreadID = threadp->mID;
 #endif
 
+	LLFastTimer::setThreadName(threadp->mName);
+
 	// Run the user supplied function
 	threadp->run();
 
+	// Hand blocks cached by this thread back to the private pools
+	LLPrivateMemoryPool::flushThreadCache();
+
 	//llinfos << "LLThread::staticRun() Exiting: " << threadp->mName << llendl;
 	
 	// We're done with the run function, this thread is done executing now.
@@ -25,8 +25,23 @@
 
 #include "linden_common.h"
 #include <apr_pools.h>
-#include <apr_queue.h>
+#include <apr_atomic.h>
 #include "llthreadsafequeue.h"
+#include "llthread.h"
+
+
+namespace
+{
+	// Attempts a blocking call makes on the lock free path before parking.
+	const S32 SPIN_COUNT = 64;
+	
+	// A locked add of zero: reads the counter and acts as a full fence, so a
+	// store to the ring can't pass the check for parked threads.
+	inline U32 fenced_read(volatile U32 & value)
+	{
+		return apr_atomic_add32(&value, 0);
+	}
+}
 
 
 
@@ -37,7 +52,14 @@
 LLThreadSafeQueueImplementation::LLThreadSafeQueueImplementation(apr_pool_t * pool, unsigned int capacity):
 	mOwnsPool(pool == 0),
 	mPool(pool),
-	mQueue(0)
+	mCells(0),
+	mMask(0),
+	mPushPosition(0),
+	mPopPosition(0),
+	mWaitingPushers(0),
+	mWaitingPoppers(0),
+	mInterrupted(0),
+	mCondition(0)
 {
 	if(mOwnsPool) {
 		apr_status_t status = apr_pool_create(&mPool, 0);
@@ -46,18 +68,40 @@ LLThreadSafeQueueImplementation::LLThreadSafeQueueImplementation(apr_pool_t * po
 		; // No op.
 	}
 	
-	apr_status_t status = apr_queue_create(&mQueue, capacity, mPool);
-	if(status != APR_SUCCESS) throw LLThreadSafeQueueError("failed to allocate queue");
+	// Round up to a power of two so positions map to cells with a mask.
+	U32 cellCount = 2;
+	while(cellCount < capacity) cellCount <<= 1;
+	mMask = cellCount - 1;
+	
+	mCells = new Cell[cellCount];
+	for(U32 i = 0; i < cellCount; ++i) {
+		mCells[i].mSequence = i;
+		mCells[i].mElement = 0;
+	}
+	
+	mCondition = new LLCondition(mPool);
 }
 
 
 LLThreadSafeQueueImplementation::~LLThreadSafeQueueImplementation()
 {
-	if(mQueue != 0) {
-		if(apr_queue_size(mQueue) != 0) llwarns << 
-			"terminating queue which still contains " << apr_queue_size(mQueue) <<
+	if(mCondition != 0) {
+		mCondition->lock();
+		apr_atomic_set32(&mInterrupted, 1);
+		mCondition->broadcast();
+		mCondition->unlock();
+		
+		// Let interrupted callers get off the condition before it goes away.
+		while(fenced_read(mWaitingPushers) != 0 || fenced_read(mWaitingPoppers) != 0) {
+			LLThread::yield();
+		}
+		delete mCondition;
+	}
+	if(mCells != 0) {
+		if(size() != 0) llwarns << 
+			"terminating queue which still contains " << size() <<
 			" elements;" << "memory will be leaked" << LL_ENDL;
-		apr_queue_term(mQueue);
+		delete [] mCells;
 	}
 	if(mOwnsPool && (mPool != 0)) apr_pool_destroy(mPool);
 }
@@ -65,45 +109,126 @@ LLThreadSafeQueueImplementation::~LLThreadSafeQueueImplementation()
 
 void LLThreadSafeQueueImplementation::pushFront(void * element)
 {
-	apr_status_t status = apr_queue_push(mQueue, element);
+	for(S32 i = 0; i < SPIN_COUNT; ++i) {
+		if(tryPushFront(element)) return;
+	}
 	
-	if(status == APR_EINTR) {
-		throw LLThreadSafeQueueInterrupt();
-	} else if(status != APR_SUCCESS) {
-		throw LLThreadSafeQueueError("push failed");
-	} else {
-		; // Success.
+	mCondition->lock();
+	apr_atomic_inc32(&mWaitingPushers);
+	bool pushed = false;
+	while(!(pushed = doPush(element)) && !apr_atomic_read32(&mInterrupted)) {
+		mCondition->wait();
 	}
+	apr_atomic_dec32(&mWaitingPushers);
+	mCondition->unlock();
+	
+	if(!pushed) throw LLThreadSafeQueueInterrupt();
+	wake(mWaitingPoppers);
 }
 
 
 bool LLThreadSafeQueueImplementation::tryPushFront(void * element){
-	return apr_queue_trypush(mQueue, element) == APR_SUCCESS;
+	if(!doPush(element)) return false;
+	wake(mWaitingPoppers);
+	return true;
 }
 
 
 void * LLThreadSafeQueueImplementation::popBack(void)
 {
 	void * element;
-	apr_status_t status = apr_queue_pop(mQueue, &element);
-
-	if(status == APR_EINTR) {
-		throw LLThreadSafeQueueInterrupt();
-	} else if(status != APR_SUCCESS) {
-		throw LLThreadSafeQueueError("pop failed");
-	} else {
-		return element;
+	for(S32 i = 0; i < SPIN_COUNT; ++i) {
+		if(tryPopBack(element)) return element;
+	}
+	
+	mCondition->lock();
+	apr_atomic_inc32(&mWaitingPoppers);
+	bool popped = false;
+	while(!(popped = doPop(element)) && !apr_atomic_read32(&mInterrupted)) {
+		mCondition->wait();
 	}
+	apr_atomic_dec32(&mWaitingPoppers);
+	mCondition->unlock();
+
+	if(!popped) throw LLThreadSafeQueueInterrupt();
+	wake(mWaitingPushers);
+	return element;
 }
 
 
 bool LLThreadSafeQueueImplementation::tryPopBack(void *& element)
 {
-	return apr_queue_trypop(mQueue, &element) == APR_SUCCESS;
+	if(!doPop(element)) return false;
+	wake(mWaitingPushers);
+	return true;
 }
 
 
 size_t LLThreadSafeQueueImplementation::size()
 {
-	return apr_queue_size(mQueue);
+	U32 popPosition = apr_atomic_read32(&mPopPosition);
+	U32 pushPosition = apr_atomic_read32(&mPushPosition);
+	S32 count = (S32)(pushPosition - popPosition);
+	return count > 0 ? count : 0;
+}
+
+
+// A cell whose sequence equals the push position is free for that push; one
+// past the pop position holds an element for that pop.  Whoever wins the
+// compare and swap on the position owns the cell until it bumps the sequence.
+bool LLThreadSafeQueueImplementation::doPush(void * element)
+{
+	U32 position = apr_atomic_read32(&mPushPosition);
+	for(;;) {
+		Cell & cell = mCells[position & mMask];
+		S32 difference = (S32)(apr_atomic_read32(&cell.mSequence) - position);
+		if(difference == 0) {
+			U32 previous = apr_atomic_cas32(&mPushPosition, position + 1, position);
+			if(previous == position) {
+				cell.mElement = element;
+				apr_atomic_set32(&cell.mSequence, position + 1);
+				return true;
+			}
+			position = previous;
+		} else if(difference < 0) {
+			return false; // Full.
+		} else {
+			position = apr_atomic_read32(&mPushPosition);
+		}
+	}
+}
+
+
+bool LLThreadSafeQueueImplementation::doPop(void *& element)
+{
+	U32 position = apr_atomic_read32(&mPopPosition);
+	for(;;) {
+		Cell & cell = mCells[position & mMask];
+		S32 difference = (S32)(apr_atomic_read32(&cell.mSequence) - (position + 1));
+		if(difference == 0) {
+			U32 previous = apr_atomic_cas32(&mPopPosition, position + 1, position);
+			if(previous == position) {
+				element = cell.mElement;
+				apr_atomic_set32(&cell.mSequence, position + mMask + 1);
+				return true;
+			}
+			position = previous;
+		} else if(difference < 0) {
+			return false; // Empty.
+		} else {
+			position = apr_atomic_read32(&mPopPosition);
+		}
+	}
+}
+
+
+// Parked threads bump their counter under the condition's mutex before
+// checking the ring one last time, so taking the mutex here is enough to
+// make sure the signal isn't lost.
+void LLThreadSafeQueueImplementation::wake(volatile U32 & waiters)
+{
+	if(fenced_read(waiters) == 0) return;
+	mCondition->lock();
+	mCondition->broadcast();
+	mCondition->unlock();
 }
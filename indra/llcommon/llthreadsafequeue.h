@@ -30,6 +30,7 @@
 
 #include <string>
 #include <stdexcept>
+#include "stdtypes.h"
 
 
 struct apr_pool_t; // From apr_pools.h
@@ -66,12 +67,18 @@ public:
 };
 
 
-struct apr_queue_t; // From apr_queue.h
+class LLCondition; // From llthread.h
 
 
 //
 // Implementation details. 
 //
+// Elements live in a fixed ring of cells, each stamped with a sequence
+// number, so producers and consumers claim slots with a single compare and
+// swap and never take a lock on the fast path.  Blocking calls spin briefly
+// and then park on a condition, which is only signalled when someone is
+// actually parked.
+//
 class LL_COMMON_API LLThreadSafeQueueImplementation
 {
 public:
@@ -84,9 +91,32 @@ public:
 	size_t size();
 	
 private:
+	struct Cell
+	{
+		volatile U32 mSequence;
+		void * volatile mElement;
+	};
+
+	bool doPush(void * element);
+	bool doPop(void *& element);
+	void wake(volatile U32 & waiters);
+
 	bool mOwnsPool;
 	apr_pool_t * mPool;
-	apr_queue_t * mQueue;
+	Cell * mCells;
+	U32 mMask;
+	
+	// Producers and consumers each get their own cache line.
+	char mPad0[64];
+	volatile U32 mPushPosition;
+	char mPad1[64];
+	volatile U32 mPopPosition;
+	char mPad2[64];
+	
+	volatile U32 mWaitingPushers;
+	volatile U32 mWaitingPoppers;
+	volatile U32 mInterrupted;
+	LLCondition * mCondition;
 };
 
 
@@ -313,6 +313,13 @@ struct lluuid_less
 
 typedef std::set<LLUUID, lluuid_less> uuid_list_t;
 
+// Hash for lluuids in boost unordered containers, found through ADL.
+// eg: 	boost::unordered_map<LLUUID, LLWidget*> widget_map;
+inline std::size_t hash_value(const LLUUID& id)
+{
+	return (std::size_t) id.getCRC32();
+}
+
 /*
  * Sub-classes for keeping transaction IDs and asset IDs
  * straight.
@@ -55,7 +55,7 @@ namespace tut
 	class TestRecorder : public LLError::Recorder
 	{
 	public:
-		TestRecorder() : mWantsTime(false) { }
+		TestRecorder() : mWantsTime(false), mWantsAsync(false) { }
 		~TestRecorder() { LLError::removeRecorder(this); }
 		
 		void recordMessage(LLError::ELevel level,
@@ -69,6 +69,9 @@ namespace tut
 		
 		void setWantsTime(bool t)	{ mWantsTime = t; }
 		bool wantsTime()			{ return mWantsTime; }
+
+		void setWantsAsync(bool a)	{ mWantsAsync = a; }
+		bool wantsAsync()			{ return mWantsAsync; }
 		
 		std::string message(int n)
 		{
@@ -84,6 +87,7 @@ namespace tut
 		MessageVector mMessages;
 		
 		bool mWantsTime;
+		bool mWantsAsync;
 	};
 
 	struct ErrorTestData
@@ -744,6 +748,50 @@ namespace tut
 		ensure_message_contains(8, "big easy");
 		ensure_message_count(9);
 	}
+
+	template<> template<>
+		// async recorders get every message, in order
+	void ErrorTestObject::test<17>()
+	{
+		TestRecorder asyncRecorder;
+		asyncRecorder.setWantsAsync(true);
+		LLError::addRecorder(&asyncRecorder);
+		LLError::setAsyncLogging(true, 4);
+
+		for (int i = 0; i < 20; ++i)
+		{
+			llinfos << "line " << i << llendl;
+		}
+		ensure_message_count(20);
+
+		// turning it off waits for the writer
+		LLError::setAsyncLogging(false);
+		ensure("lines may be dropped past the queue size", asyncRecorder.countMessages() >= 4);
+		ensure_contains("first line", asyncRecorder.message(0), "line 0");
+
+		asyncRecorder.clearMessages();
+		llwarns << "must arrive" << llendl;
+		ensure_contains("sync again", asyncRecorder.message(0), "must arrive");
+	}
+
+	template<> template<>
+		// per tag rate limit
+	void ErrorTestObject::test<18>()
+	{
+		LLError::setTagRateLimit(3);
+		for (int i = 0; i < 10; ++i)
+		{
+			LL_INFOS("RateTest") << "chatty " << i << LL_ENDL;
+		}
+		ensure_message_count(3);
+
+		LL_WARNS("RateTest") << "warnings are never held back" << LL_ENDL;
+		ensure_message_count(4);
+
+		LLError::setTagRateLimit(0);
+		LL_INFOS("RateTest") << "unlimited" << LL_ENDL;
+		ensure_message_count(5);
+	}
 }	
 
 /* Tests left:
@@ -0,0 +1,122 @@
+/** 
+ * @file llflathashmap_test.cpp
+ * @date 2026-10-14
+ * @brief Checks LLFlatHashMap against std::map.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include <map>
+#include "../llflathashmap.h"
+#include "../llrand.h"
+
+
+namespace tut
+{
+	struct flathashmap
+	{
+	};
+
+	typedef test_group<flathashmap> flathashmap_t;
+	typedef flathashmap_t::object flathashmap_object_t;
+	tut::flathashmap_t tut_flathashmap("LLFlatHashMap");
+
+	template<> template<>
+	void flathashmap_object_t::test<1>()
+	{
+		// random inserts, erases and lookups, mirrored in a std::map
+		LLFlatHashMap<S32, S32> map;
+		std::map<S32, S32> expected;
+		for (S32 i = 0; i < 50000; ++i)
+		{
+			S32 key = ll_rand(2000);
+			switch (ll_rand(3))
+			{
+			case 0:
+				map[key] = i;
+				expected[key] = i;
+				break;
+			case 1:
+				ensure_equals("erase", map.erase(key), expected.erase(key));
+				break;
+			default:
+				{
+					LLFlatHashMap<S32, S32>::iterator it = map.find(key);
+					std::map<S32, S32>::iterator exp_it = expected.find(key);
+					ensure_equals("found", it != map.end(), exp_it != expected.end());
+					if (exp_it != expected.end())
+					{
+						ensure_equals("value", it->second, exp_it->second);
+					}
+				}
+			}
+		}
+		ensure_equals("size", map.size(), expected.size());
+
+		size_t visited = 0;
+		for (LLFlatHashMap<S32, S32>::const_iterator it = map.begin(); it != map.end(); ++it)
+		{
+			ensure_equals("iterated value", it->second, expected[it->first]);
+			visited++;
+		}
+		ensure_equals("iterated count", visited, expected.size());
+	}
+
+	template<> template<>
+	void flathashmap_object_t::test<2>()
+	{
+		// erasing while iterating visits every entry exactly once
+		LLFlatHashMap<LLUUID, S32> map;
+		for (S32 i = 0; i < 1000; ++i)
+		{
+			LLUUID id;
+			id.generate();
+			map[id] = i;
+		}
+
+		S32 visited = 0;
+		for (LLFlatHashMap<LLUUID, S32>::iterator it = map.begin(); it != map.end(); )
+		{
+			visited++;
+			if (it->second % 2)
+			{
+				map.erase(it++);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		ensure_equals("visited", visited, 1000);
+		ensure_equals("remaining", map.size(), (size_t)500);
+
+		LLFlatHashMap<LLUUID, S32> copy(map);
+		for (LLFlatHashMap<LLUUID, S32>::iterator it = map.begin(); it != map.end(); ++it)
+		{
+			ensure_equals("copied", copy[it->first], it->second);
+		}
+		ensure_equals("copy size", copy.size(), (size_t)500);
+	}
+}
@@ -80,6 +80,7 @@ namespace lambda = boost::lambda;
 #include "../llsdserialize.h"
 #include "llsdutil.h"
 #include "../llformat.h"
+#include "../lltimer.h"
 
 #include "../test/lltut.h"
 #include "stringize.h"
@@ -961,6 +962,100 @@ namespace tut
 			expected,
 			1);
 	}
+
+	template<> template<> 
+	void TestLLSDXMLParsingObject::test<5>()
+	{
+		// test that a document fed in small pieces parses the same as a whole one
+		LLSD expected;
+		expected["name"] = "an inventory folder";
+		expected["items"][0]["id"] = LLUUID("60e44ec5-305c-43c2-9a19-b4b89b1ae2a6");
+		expected["items"][1]["count"] = 42;
+		expected["items"][2]["price"] = 1.5;
+
+		std::ostringstream ostr;
+		LLSDSerialize::toXML(expected, ostr);
+		std::string xml = ostr.str();
+
+		for (S32 piece = 1; piece < 40; piece += 7)
+		{
+			for (S32 pos = 0; pos < (S32)xml.size(); pos += piece)
+			{
+				mParser->parseChunk(xml.data() + pos, llmin(piece, (S32)xml.size() - pos));
+			}
+
+			LLSD parsed_result;
+			S32 parsed_count = mParser->finishChunks(parsed_result);
+			ensure_equals("chunked parse", parsed_result, expected);
+			ensure_equals("chunked parse (count)", parsed_count, 1);
+		}
+
+		// truncated documents fail like parse() does, and the parser resets
+		std::string truncated = xml.substr(0, xml.size() / 2);
+		mParser->parseChunk(truncated.data(), truncated.size());
+		LLSD parsed_result;
+		ensure_equals("truncated chunked parse", mParser->finishChunks(parsed_result), (S32)LLSDParser::PARSE_FAILURE);
+		ensure("truncated chunked parse result", parsed_result.isUndefined());
+
+		mParser->parseChunk(xml.data(), xml.size());
+		ensure_equals("chunked parse after failure", mParser->finishChunks(parsed_result), 1);
+		ensure_equals("chunked parse after failure result", parsed_result, expected);
+	}
+
+	template<> template<> 
+	void TestLLSDXMLParsingObject::test<6>()
+	{
+		// the whole document parse matches expat (chunked parse), timing in the test log
+		LLSD folder;
+		folder["name"] = "Clothing & <stuff> \"quoted\"";
+		folder["empty"] = LLSD::emptyMap();
+		folder["blob"] = string_to_vector("some binary bytes that are longer than sixteen");
+		for (S32 i = 0; i < 5000; ++i)
+		{
+			LLSD item;
+			item["item_id"] = LLUUID::generateNewID();
+			item["name"] = llformat("item %d", i);
+			item["type"] = i % 20;
+			item["sale_price"] = i * 0.25;
+			item["flags"] = (i % 2) == 0;
+			item["desc"] = "";
+			folder["items"].append(item);
+		}
+
+		std::ostringstream ostr;
+		LLSDSerialize::toPrettyXML(folder, ostr);
+		std::string xml = "<?xml version=\"1.0\" ?>\n" + ostr.str();
+
+		LLTimer timer;
+		mParser->reset();
+		std::istringstream istr(xml);
+		LLSD fast_result;
+		S32 fast_count = mParser->parse(istr, fast_result, LLSDSerialize::SIZE_UNLIMITED);
+		F32 fast_time = timer.getElapsedTimeAndResetF32();
+
+		mParser->parseChunk(xml.data(), xml.size());
+		LLSD expat_result;
+		S32 expat_count = mParser->finishChunks(expat_result);
+		F32 expat_time = timer.getElapsedTimeF32();
+
+		llinfos << "Parsed " << xml.size() << " bytes of LLSD XML in " << fast_time * 1000.f
+				<< " ms, expat took " << expat_time * 1000.f << " ms" << llendl;
+
+		ensure_equals("whole document parse", fast_result, expat_result);
+		ensure_equals("whole document parse (count)", fast_count, expat_count);
+		ensure_equals("entities decoded", fast_result["name"].asString(), folder["name"].asString());
+
+		ensureParse(
+			"character references",
+			"<llsd><string>&#65;&#x42;&#xe9;</string></llsd>",
+			LLSD("AB\xc3\xa9"),
+			1);
+		ensureParse(
+			"comment is left to expat",
+			"<llsd><!-- note --><integer>7</integer></llsd>",
+			LLSD(7),
+			1);
+	}
 	/*
 	TODO:
 		test XML parsing
@@ -1547,12 +1642,48 @@ namespace tut
 			1);
 	}
 
-/*
 	template<> template<> 
 	void TestLLSDBinaryParsingObject::test<11>()
 	{
+		// buffer codec writes what the formatter writes and reads it back
+		LLSD sd;
+		sd["name"] = "mesh header";
+		sd["version"] = 3;
+		sd["scale"] = 0.5;
+		sd["id"] = LLUUID("60e44ec5-305c-43c2-9a19-b4b89b1ae2a6");
+		sd["when"] = LLDate(1234567.0);
+		sd["where"] = LLURI("http://example.com/");
+		sd["blob"] = string_to_vector("bytes");
+		sd["list"].append(true);
+		sd["list"].append(LLSD());
+		sd["list"].append(LLSD::emptyMap());
+
+		std::ostringstream ostr;
+		S32 format_count = LLSDSerialize::toBinary(sd, ostr);
+		std::string streamed = ostr.str();
+
+		std::vector<U8> buffer;
+		LLSDSerialize::toBinaryBuffer(sd, buffer);
+		ensure_equals("same bytes as the formatter",
+					  std::string(buffer.begin(), buffer.end()), streamed);
+
+		// trailing data is left alone, as with fromBinary() on a stream
+		buffer.push_back('x');
+		LLSD parsed;
+		S32 bytes_read = 0;
+		S32 count = LLSDSerialize::fromBinaryBuffer(parsed, &buffer[0], buffer.size(), &bytes_read);
+		ensure_equals("buffer parse", parsed, sd);
+		ensure_equals("buffer parse count", count, format_count);
+		ensure_equals("buffer parse bytes", bytes_read, (S32)streamed.size());
+
+		count = LLSDSerialize::fromBinaryBuffer(parsed, &buffer[0], streamed.size() / 2);
+		ensure_equals("truncated buffer parse", count, (S32)LLSDParser::PARSE_FAILURE);
+		ensure("truncated buffer parse result", parsed.isUndefined());
+
+		const char notation_style[] = "{\0\0\0\1'key'i\0\0\0\7}";
+		count = LLSDSerialize::fromBinaryBuffer(parsed, (const U8*)notation_style, sizeof(notation_style) - 1);
+		ensure_equals("quoted key falls back to the stream parser", parsed["key"].asInteger(), 7);
 	}
-*/
 
    /**
 	 * @class TestLLSDCrossCompatible
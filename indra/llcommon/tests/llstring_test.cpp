@@ -750,4 +750,36 @@ namespace tut
 		ensure("empty substr.", !LLStringUtil::endsWith(empty, value));
 		ensure("empty everything.", !LLStringUtil::endsWith(empty, empty));
 	}
+	template<> template<>
+	void string_index_object_t::test<41>()
+	{
+		// utf8 <-> utf32 across the 16 byte ascii blocks and multibyte characters
+		std::string utf8("0123456789abcdefghijklmnop caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 0123456789abcdef");
+		LLWString wstr = utf8str_to_wstring(utf8);
+		ensure_equals("utf8str_to_wstring length", wstr.size(), (size_t) 52);
+		ensure_equals("utf8str_to_wstring 2 byte", (U32) wstr[30], (U32) 0xE9);
+		ensure_equals("utf8str_to_wstring 3 byte", (U32) wstr[32], (U32) 0x20AC);
+		ensure_equals("utf8str_to_wstring 4 byte", (U32) wstr[34], (U32) 0x1F600);
+		ensure_equals("wstring_to_utf8str round trip", wstring_to_utf8str(wstr), utf8);
+
+		LLWString wout;
+		std::string out("left over");
+		utf8str_to_wstring(utf8, wout);
+		wstring_to_utf8str(wout, out);
+		ensure("utf8str_to_wstring into buffer", wout == wstr);
+		ensure_equals("wstring_to_utf8str into buffer", out, utf8);
+
+		ensure_equals("bad lead byte", wstring_to_utf8str(utf8str_to_wstring(std::string("ab\xff" "cd"))), std::string("ab?cd"));
+	}
+
+	template<> template<>
+	void string_index_object_t::test<42>()
+	{
+		std::string str("The Quick Brown Fox Jumps Over The Lazy Dog @[`{");
+		LLStringUtil::toLower(str);
+		ensure_equals("toLower long", str, std::string("the quick brown fox jumps over the lazy dog @[`{"));
+		LLStringUtil::toUpper(str);
+		ensure_equals("toUpper long", str, std::string("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG @[`{"));
+		ensure_equals("utf8str_tolower ascii", utf8str_tolower("Mixed CASE Name Resident"), std::string("mixed case name resident"));
+	}
 }
@@ -28,19 +28,29 @@
 
 #include "llimageworker.h"
 #include "llimagedxt.h"
+#include "llimagej2c.h"
+#include "lltimer.h"
+#include "llfasttimer.h"
 
+static LLFastTimer::DeclareTimer FTM_IMAGE_DECODE_REQUEST("Image Decode Request");
+static LLFastTimer::DeclareTimer FTM_IMAGE_ENCODE_REQUEST("Image Encode Request");
 //----------------------------------------------------------------------------
 
 // MAIN THREAD
-LLImageDecodeThread::LLImageDecodeThread(bool threaded)
+LLImageDecodeThread::LLImageDecodeThread(bool threaded, U32 pool_size)
 	: LLQueuedThread("imagedecode", threaded)
 {
 	mCreationMutex = new LLMutex(getAPRPool());
+
+	// decodes only touch their own request, any free decoder can take one
+	startPool(pool_size);
 }
 
 //virtual 
 LLImageDecodeThread::~LLImageDecodeThread()
 {
+	// Pool workers must be gone before ~LLQueuedThread() deletes the requests
+	shutdown();
 	delete mCreationMutex ;
 }
 
@@ -77,6 +87,20 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(LLImageFormatted*
 	return handle;
 }
 
+// MAIN THREAD
+LLImageDecodeThread::handle_t LLImageDecodeThread::encodeImage(LLImageRaw* raw, LLImageJ2C* image,
+	const std::string& comment, U32 priority, EncodeResponder* responder)
+{
+	if (isQuitting())
+	{
+		llwarns << "encode request added after shutdown" << llendl;
+		return nullHandle();
+	}
+	handle_t handle = generateHandle();
+	addRequest(new EncodeRequest(handle, raw, image, comment, priority, responder));
+	return handle;
+}
+
 // Used by unit test only
 // Returns the size of the mutex guarded list as an indication of sanity
 S32 LLImageDecodeThread::tut_size()
@@ -90,6 +114,10 @@ LLImageDecodeThread::Responder::~Responder()
 {
 }
 
+LLImageDecodeThread::EncodeResponder::~EncodeResponder()
+{
+}
+
 //----------------------------------------------------------------------------
 
 LLImageDecodeThread::ImageRequest::ImageRequest(handle_t handle, LLImageFormatted* image, 
@@ -118,6 +146,7 @@ LLImageDecodeThread::ImageRequest::~ImageRequest()
 // Returns true when done, whether or not decode was successful.
 bool LLImageDecodeThread::ImageRequest::processRequest()
 {
+	LLFastTimer::ThreadTimer t(FTM_IMAGE_DECODE_REQUEST);
 	const F32 decode_time_slice = .1f;
 	bool done = true;
 	if (!mDecodedRaw && mFormattedImage.notNull())
@@ -177,3 +206,43 @@ bool LLImageDecodeThread::ImageRequest::tut_isOK()
 {
 	return mResponder.notNull();
 }
+
+//----------------------------------------------------------------------------
+
+LLImageDecodeThread::EncodeRequest::EncodeRequest(handle_t handle, LLImageRaw* raw, LLImageJ2C* image,
+												  const std::string& comment, U32 priority,
+												  LLImageDecodeThread::EncodeResponder* responder)
+	: LLQueuedThread::QueuedRequest(handle, priority, FLAG_AUTO_COMPLETE),
+	  mRawImage(raw),
+	  mFormattedImage(image),
+	  mComment(comment),
+	  mEncoded(FALSE),
+	  mResponder(responder)
+{
+}
+
+LLImageDecodeThread::EncodeRequest::~EncodeRequest()
+{
+	mRawImage = NULL;
+	mFormattedImage = NULL;
+}
+
+// Returns true when done, whether or not encode was successful.
+bool LLImageDecodeThread::EncodeRequest::processRequest()
+{
+	LLFastTimer::ThreadTimer t(FTM_IMAGE_ENCODE_REQUEST);
+	if (mRawImage.notNull() && mFormattedImage.notNull())
+	{
+		mEncoded = mFormattedImage->encode(mRawImage, mComment.empty() ? NULL : mComment.c_str());
+	}
+	return true;
+}
+
+void LLImageDecodeThread::EncodeRequest::finishRequest(bool completed)
+{
+	if (mResponder.notNull())
+	{
+		mResponder->completed(completed && mEncoded, mFormattedImage);
+	}
+	// Will automatically be deleted
+}
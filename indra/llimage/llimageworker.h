@@ -31,6 +31,8 @@
 #include "llpointer.h"
 #include "llworkerthread.h"
 
+class LLImageJ2C;
+
 class LLImageDecodeThread : public LLQueuedThread
 {
 public:
@@ -42,6 +44,15 @@ public:
 		virtual void completed(bool success, LLImageRaw* raw, LLImageRaw* aux) = 0;
 	};
 
+	class EncodeResponder : public LLThreadSafeRefCount
+	{
+	protected:
+		virtual ~EncodeResponder();
+	public:
+		// Called on the decode thread that ran the encode
+		virtual void completed(bool success, LLImageJ2C* image) = 0;
+	};
+
 	class ImageRequest : public LLQueuedThread::QueuedRequest
 	{
 	protected:
@@ -70,14 +81,40 @@ public:
 		BOOL mDecodedAux;
 		LLPointer<LLImageDecodeThread::Responder> mResponder;
 	};
+
+	class EncodeRequest : public LLQueuedThread::QueuedRequest
+	{
+	protected:
+		virtual ~EncodeRequest(); // use deleteRequest()
+
+	public:
+		EncodeRequest(handle_t handle, LLImageRaw* raw, LLImageJ2C* image,
+					  const std::string& comment, U32 priority,
+					  LLImageDecodeThread::EncodeResponder* responder);
+
+		/*virtual*/ bool processRequest();
+		/*virtual*/ void finishRequest(bool completed);
+
+	private:
+		LLPointer<LLImageRaw> mRawImage;
+		LLPointer<LLImageJ2C> mFormattedImage;
+		std::string mComment;
+		BOOL mEncoded;
+		LLPointer<LLImageDecodeThread::EncodeResponder> mResponder;
+	};
 	
 public:
-	LLImageDecodeThread(bool threaded = true);
+	// pool_size is the total number of decoder threads, including this one.
+	LLImageDecodeThread(bool threaded = true, U32 pool_size = 1);
 	virtual ~LLImageDecodeThread();
 
 	handle_t decodeImage(LLImageFormatted* image,
 						 U32 priority, S32 discard, BOOL needs_aux,
 						 Responder* responder);
+	// MAIN THREAD. raw must not be modified until the responder is called.
+	handle_t encodeImage(LLImageRaw* raw, LLImageJ2C* image,
+						 const std::string& comment, U32 priority,
+						 EncodeResponder* responder);
 	S32 update(F32 max_time_ms);
 
 	// Used by unit tests to check the consistency of the thread instance
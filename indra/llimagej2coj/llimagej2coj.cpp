@@ -96,6 +96,36 @@ int ceildivpow2(int a, int b)
 	return (a + (1 << b) - 1) >> b;
 }
 
+// Decode size bytes of a J2K codestream, returns NULL on failure.
+static opj_image_t* decode_codestream(opj_dparameters_t& parameters, opj_event_mgr_t& event_mgr, U8* data, S32 size)
+{
+	/* get a decoder handle */
+	opj_dinfo_t* dinfo = opj_create_decompress(CODEC_J2K);
+
+	/* catch events using our callbacks and give a local context */
+	opj_set_event_mgr((opj_common_ptr)dinfo, &event_mgr, stderr);			
+
+	/* setup the decoder decoding parameters using user parameters */
+	opj_setup_decoder(dinfo, &parameters);
+
+	/* open a byte stream */
+	opj_cio_t* cio = opj_cio_open((opj_common_ptr)dinfo, data, size);
+
+	/* decode the stream and fill the image structure */
+	opj_image_t* image = opj_decode(dinfo, cio);
+
+	/* close the byte stream */
+	opj_cio_close(cio);
+
+	/* free remaining structures */
+	if(dinfo)
+	{
+		opj_destroy_decompress(dinfo);
+	}
+
+	return image;
+}
+
 
 LLImageJ2COJ::LLImageJ2COJ()
 	: LLImageJ2CImpl()
@@ -131,9 +161,6 @@ BOOL LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
 	opj_event_mgr_t event_mgr;		/* event manager */
 	opj_image_t *image = NULL;
 
-	opj_dinfo_t* dinfo = NULL;	/* handle to a decompressor */
-	opj_cio_t *cio = NULL;
-
 
 	/* configure the event callbacks (not required) */
 	memset(&event_mgr, 0, sizeof(opj_event_mgr_t));
@@ -151,28 +178,32 @@ BOOL LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
 
 	/* JPEG-2000 codestream */
 
-	/* get a decoder handle */
-	dinfo = opj_create_decompress(CODEC_J2K);
-
-	/* catch events using our callbacks and give a local context */
-	opj_set_event_mgr((opj_common_ptr)dinfo, &event_mgr, stderr);			
-
-	/* setup the decoder decoding parameters using user parameters */
-	opj_setup_decoder(dinfo, &parameters);
-
-	/* open a byte stream */
-	cio = opj_cio_open((opj_common_ptr)dinfo, base.getData(), base.getDataSize());
-
-	/* decode the stream and fill the image structure */
-	image = opj_decode(dinfo, cio);
-
-	/* close the byte stream */
-	opj_cio_close(cio);
-
-	/* free remaining structures */
-	if(dinfo)
+	// OpenJPEG entropy decodes every code block it is given, including the
+	// ones belonging to resolution levels that cp_reduce then throws away.
+	// When the buffer holds more than the requested discard level needs
+	// (e.g. a full image decoded at a coarser level) only hand it the
+	// leading bytes, and fall back to the whole buffer if that fails.
+	S32 data_size = base.getDataSize();
+	if (parameters.cp_reduce > 0)
 	{
-		opj_destroy_decompress(dinfo);
+		S32 needed_size = base.calcDataSize(parameters.cp_reduce);
+		if (needed_size > 0 && needed_size < data_size)
+		{
+			image = decode_codestream(parameters, event_mgr, base.getData(), needed_size);
+			if (!image || !image->numcomps)
+			{
+				if (image)
+				{
+					opj_image_destroy(image);
+					image = NULL;
+				}
+				LL_DEBUGS("Texture") << "decodeImpl: partial stream decode failed, using all " << data_size << " bytes" << LL_ENDL;
+			}
+		}
+	}
+	if (!image)
+	{
+		image = decode_codestream(parameters, event_mgr, base.getData(), data_size);
 	}
 
 	// The image decode failed if the return was NULL or the component
@@ -163,89 +163,93 @@ size_t LLCamera::readFrustumFromBuffer(const char *buffer)
 
 S32 LLCamera::AABBInFrustum(const LLVector4a &center, const LLVector4a& radius) 
 {
-	static const LLVector4a scaler[] = {
-		LLVector4a(-1,-1,-1),
-		LLVector4a( 1,-1,-1),
-		LLVector4a(-1, 1,-1),
-		LLVector4a( 1, 1,-1),
-		LLVector4a(-1,-1, 1),
-		LLVector4a( 1,-1, 1),
-		LLVector4a(-1, 1, 1),
-		LLVector4a( 1, 1, 1)
-	};
-
-	U8 mask = 0;
-	bool result = false;
-	LLVector4a rscale, maxp, minp;
-	LLSimdScalar d;
+	return AABBInPlanes(center, radius, getActivePlaneBits());
+}
+
+
+S32 LLCamera::AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius) 
+{
+	return AABBInPlanes(center, radius, getActivePlaneBits() & ~(1 << AGENT_PLANE_FAR));
+}
+
+U32 LLCamera::getActivePlaneBits() const
+{
+	U32 bits = 0;
 	for (U32 i = 0; i < mPlaneCount; i++)
 	{
-		mask = mPlaneMask[i];
-		if (mask != 0xff)
+		if (mPlaneMask[i] != 0xff)
 		{
-			const LLPlane& p(mAgentPlanes[i]);
-			p.getAt<3>(d);
-			rscale.setMul(radius, scaler[mask]);
-			minp.setSub(center, rscale);
-			d = -d;
-			if (p.dot3(minp).getF32() > d) 
-			{
-				return 0;
-			}
-			
-			if(!result)
-			{
-				maxp.setAdd(center, rscale);
-				result = (p.dot3(maxp).getF32() > d);
-			}
+			bits |= 1 << i;
 		}
 	}
-
-	return result?1:2;
+	return bits;
 }
 
-
-S32 LLCamera::AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius) 
+// Tests the box against four planes at a time.  The planes are transposed
+// so each register holds one component of four planes, then for each plane
+// the box center's distance is compared against the box's extent along the
+// plane normal:
+//   dist > extent   -> entirely on the outside of that plane
+//   dist > -extent  -> straddles it
+// which is the same as testing the corners picked by mPlaneMask, without a
+// branch per plane.
+S32 LLCamera::AABBInPlanes(const LLVector4a& center, const LLVector4a& radius, U32 plane_bits) const
 {
-	static const LLVector4a scaler[] = {
-		LLVector4a(-1,-1,-1),
-		LLVector4a( 1,-1,-1),
-		LLVector4a(-1, 1,-1),
-		LLVector4a( 1, 1,-1),
-		LLVector4a(-1,-1, 1),
-		LLVector4a( 1,-1, 1),
-		LLVector4a(-1, 1, 1),
-		LLVector4a( 1, 1, 1)
-	};
-
-	U8 mask = 0;
-	bool result = false;
-	LLVector4a rscale, maxp, minp;
-	LLSimdScalar d;
-	for (U32 i = 0; i < mPlaneCount; i++)
+	LLVector4a cx, cy, cz;
+	cx.splat<0>(center);
+	cy.splat<1>(center);
+	cz.splat<2>(center);
+
+	LLVector4a rx, ry, rz;
+	rx.splat<0>(radius);
+	ry.splat<1>(radius);
+	rz.splat<2>(radius);
+
+	U32 partial = 0;
+	for (U32 base = 0; base < mPlaneCount; base += 4)
 	{
-		mask = mPlaneMask[i];
-		if ((i != 5) && (mask != 0xff))
+		LLQuad row[4];
+		for (U32 j = 0; j < 4; j++)
 		{
-			const LLPlane& p(mAgentPlanes[i]);
-			p.getAt<3>(d);
-			rscale.setMul(radius, scaler[mask]);
-			minp.setSub(center, rscale);
-			d = -d;
-			if (p.dot3(minp).getF32() > d) 
-			{
-				return 0;
-			}
-			
-			if(!result)
-			{
-				maxp.setAdd(center, rscale);
-				result = (p.dot3(maxp).getF32() > d);
-			}
+			// mAgentPlanes only holds 7 planes, the last lane is padding
+			row[j] = base + j < AGENT_PLANE_COUNT ? (LLQuad) mAgentPlanes[base + j].getVector4a() : _mm_setzero_ps();
 		}
+		_MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+
+		LLVector4a nx, ny, nz, dist, tmp;
+		nx = row[0];
+		ny = row[1];
+		nz = row[2];
+		dist = row[3];
+
+		tmp.setMul(nx, cx);
+		dist.add(tmp);
+		tmp.setMul(ny, cy);
+		dist.add(tmp);
+		tmp.setMul(nz, cz);
+		dist.add(tmp);
+
+		LLVector4a extent;
+		nx.setAbs(nx);
+		ny.setAbs(ny);
+		nz.setAbs(nz);
+		extent.setMul(nx, rx);
+		tmp.setMul(ny, ry);
+		extent.add(tmp);
+		tmp.setMul(nz, rz);
+		extent.add(tmp);
+
+		U32 lanes = (plane_bits >> base) & 0xF;
+		if (dist.greaterThan(extent).getGatheredBits() & lanes)
+		{
+			return 0;
+		}
+
+		tmp.setAdd(dist, extent);
+		partial |= tmp.greaterThan(LLVector4a::getZero()).getGatheredBits() & lanes;
 	}
 
-	return result?1:2;
+	return partial ? 1 : 2;
 }
 
 int LLCamera::sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius) 
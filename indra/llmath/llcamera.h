@@ -94,6 +94,8 @@ public:
 		AGENT_PLANE_BOTTOM,
 		AGENT_PLANE_TOP,
 		AGENT_PLANE_FAR,
+		AGENT_PLANE_USER_CLIP,
+		AGENT_PLANE_COUNT
 	};
 
 	enum {
@@ -108,7 +110,7 @@ public:
 	};
 
 private:
-	LLPlane mAgentPlanes[7];  //frustum planes in agent space a la gluUnproject (I'm a bastard, I know) - DaveP
+	LLPlane mAgentPlanes[AGENT_PLANE_COUNT];  //frustum planes in agent space a la gluUnproject (I'm a bastard, I know) - DaveP
 	U8 mPlaneMask[8];         // 8 for alignment	
 	
 	F32 mView;					// angle between top and bottom frustum planes in radians.
@@ -208,6 +210,10 @@ protected:
 	void calculateFrustumPlanes(F32 left, F32 right, F32 top, F32 bottom);
 	void calculateFrustumPlanesFromWindow(F32 x1, F32 y1, F32 x2, F32 y2);
 	void calculateWorldFrustumPlanes();
+
+	// bit i set for each agent plane that is in use and not ignored
+	U32 getActivePlaneBits() const;
+	S32 AABBInPlanes(const LLVector4a& center, const LLVector4a& radius, U32 plane_bits) const;
 };
 
 
@@ -83,7 +83,6 @@ public:
 	typedef typename element_list::iterator						element_iter;
 	typedef typename element_list::const_iterator	const_element_iter;
 	typedef typename std::vector<LLTreeListener<T>*>::iterator	tree_listener_iter;
-	typedef typename std::vector<LLOctreeNode<T>* >				child_list;
 	typedef LLTreeNode<T>		BaseType;
 	typedef LLOctreeNode<T>		oct_node;
 	typedef LLOctreeListener<T>	oct_listener;
@@ -219,7 +218,7 @@ public:
 	}
 
 	void accept(oct_traveler* visitor)				{ visitor->visit(this); }
-	virtual bool isLeaf() const						{ return mChild.empty(); }
+	virtual bool isLeaf() const						{ return mChildCount == 0; }
 	
 	U32 getElementCount() const						{ return mElementCount; }
 	element_list& getData()							{ return mData; }
@@ -228,8 +227,6 @@ public:
 	U32 getChildCount()	const						{ return mChildCount; }
 	oct_node* getChild(U32 index)					{ return mChild[index]; }
 	const oct_node* getChild(U32 index) const		{ return mChild[index]; }
-	child_list& getChildren()						{ return mChild; }
-	const child_list& getChildren() const			{ return mChild; }
 	
 	void accept(tree_traveler* visitor) const		{ visitor->visit(this); }
 	void accept(oct_traveler* visitor) const		{ visitor->visit(this); }
@@ -396,9 +393,8 @@ public:
 
 	bool remove(T* data)
 	{
-		if (mData.find(data) != mData.end())
+		if (mData.erase(data))
 		{	//we have data
-			mData.erase(data);
 			mElementCount = mData.size();
 			notifyRemoval(data);
 			checkAlive();
@@ -453,7 +449,6 @@ public:
 
 	void clearChildren()
 	{
-		mChild.clear();
 		mChildCount = 0;
 		U32* foo = (U32*) mChildMap;
 		foo[0] = foo[1] = 0xFFFFFFFF;
@@ -508,7 +503,7 @@ public:
 			}
 		}
 
-		if (mChild.size() >= 8)
+		if (mChildCount >= 8)
 		{
 			OCT_ERRS <<"Octree node has too many children... why?" << llendl;
 		}
@@ -516,7 +511,7 @@ public:
 
 		mChildMap[child->getOctant()] = mChildCount;
 
-		mChild.push_back(child);
+		mChild[mChildCount] = child;
 		++mChildCount;
 		child->setParent(this);
 
@@ -543,8 +538,11 @@ public:
 			mChild[index]->destroy();
 			delete mChild[index];
 		}
-		mChild.erase(mChild.begin() + index);
 		--mChildCount;
+		for (U32 i = index; i < mChildCount; ++i)
+		{
+			mChild[i] = mChild[i + 1];
+		}
 
 		//rebuild child map
 		U32* foo = (U32*) mChildMap;
@@ -601,7 +599,9 @@ protected:
 	oct_node* mParent;
 	U8 mOctant;
 
-	child_list mChild;
+	// at most one child per octant, kept inline so walking the tree doesn't
+	// chase a separate allocation per node
+	oct_node* mChild[8];
 	U8 mChildMap[8];
 	U32 mChildCount;
 
@@ -85,6 +85,8 @@ public:
 	inline void clear() { mV.set(0, 0, 0, 1); }
 	
 	inline void getVector3(LLVector3& vec) const { vec.set(mV[0], mV[1], mV[2]); }
+
+	inline const LLVector4a& getVector4a() const { return mV; }
 	
 	// Retrieve the mask indicating which of the x, y, or z axis are greater or equal to zero.
 	inline U8 calcPlaneMask() 
@@ -0,0 +1,186 @@
+/** 
+ * @file llsimdkernels.cpp
+ * @brief Batch math kernels with a version per instruction set
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llsimdkernels.h"
+#include "llprocessor.h"
+
+// AVX intrinsics need either MSVC, which allows them anywhere, or a GCC or
+// clang that can enable AVX for single functions.  The rest of the file
+// stays SSE2 so the viewer still runs on older CPUs.
+#if LL_MSVC
+#define LL_SIMD_AVX 1
+#define LL_AVX_FUNCTION
+#elif (defined(__i386__) || defined(__x86_64__)) && \
+	(defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define LL_SIMD_AVX 1
+#define LL_AVX_FUNCTION __attribute__((target("avx")))
+#else
+#define LL_SIMD_AVX 0
+#endif
+
+#if LL_SIMD_AVX
+#include <immintrin.h>
+#endif
+
+bool ll_simd_use_avx()
+{
+#if LL_SIMD_AVX
+	static const bool use_avx = LLProcessorInfo().hasAVX();
+	return use_avx;
+#else
+	return false;
+#endif
+}
+
+// Splits a packed joint weight into palette indices and normalized weights.
+static inline void unpack_weights(const LLVector4a& packed, S32 max_index, S32 idx[4], F32 wght[4])
+{
+	F32 scale = 0.f;
+	for (U32 k = 0; k < 4; k++)
+	{
+		F32 w = packed[k];
+
+		idx[k] = llclamp((S32) floorf(w), 0, max_index);
+		wght[k] = w - floorf(w);
+		scale += wght[k];
+	}
+
+	scale = 1.f/scale;
+	for (U32 k = 0; k < 4; k++)
+	{
+		wght[k] *= scale;
+	}
+}
+
+void ll_skin_vertices(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+					  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+					  LLVector4a* out_positions, LLVector4a* out_normals, U32 count)
+{
+	if (ll_simd_use_avx())
+	{
+		ll_skin_vertices_avx(palette, palette_size, bind_shape, weights, positions, normals, out_positions, out_normals, count);
+	}
+	else
+	{
+		ll_skin_vertices_sse(palette, palette_size, bind_shape, weights, positions, normals, out_positions, out_normals, count);
+	}
+}
+
+void ll_skin_vertices_sse(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+						  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+						  LLVector4a* out_positions, LLVector4a* out_normals, U32 count)
+{
+	LLMatrix4a bind_shape_matrix = bind_shape;
+	bool do_normals = normals && out_normals;
+
+	for (U32 j = 0; j < count; ++j)
+	{
+		S32 idx[4];
+		F32 wght[4];
+		unpack_weights(weights[j], palette_size - 1, idx, wght);
+
+		LLMatrix4a final_mat;
+		final_mat.clear();
+		for (U32 k = 0; k < 4; k++)
+		{
+			LLMatrix4a src;
+			src.setMul(palette[idx[k]], wght[k]);
+			final_mat.add(src);
+		}
+
+		LLVector4a t;
+		bind_shape_matrix.affineTransform(positions[j], t);
+		final_mat.affineTransform(t, out_positions[j]);
+
+		if (do_normals)
+		{
+			bind_shape_matrix.rotate(normals[j], t);
+			final_mat.rotate(t, out_normals[j]);
+		}
+	}
+}
+
+#if LL_SIMD_AVX
+// Blends the weighted matrices two rows at a time.  LLMatrix4a rows are
+// contiguous, so rows 0-1 and 2-3 each load as one 256 bit vector.
+LL_AVX_FUNCTION
+static void skin_vertices_avx(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+							  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+							  LLVector4a* out_positions, LLVector4a* out_normals, U32 count)
+{
+	LLMatrix4a bind_shape_matrix = bind_shape;
+	bool do_normals = normals && out_normals;
+
+	for (U32 j = 0; j < count; ++j)
+	{
+		S32 idx[4];
+		F32 wght[4];
+		unpack_weights(weights[j], palette_size - 1, idx, wght);
+
+		__m256 rows01 = _mm256_setzero_ps();
+		__m256 rows23 = _mm256_setzero_ps();
+		for (U32 k = 0; k < 4; k++)
+		{
+			const F32* src = palette[idx[k]].mMatrix[0].getF32ptr();
+			__m256 w = _mm256_set1_ps(wght[k]);
+			rows01 = _mm256_add_ps(rows01, _mm256_mul_ps(_mm256_loadu_ps(src), w));
+			rows23 = _mm256_add_ps(rows23, _mm256_mul_ps(_mm256_loadu_ps(src + 8), w));
+		}
+
+		LLMatrix4a final_mat;
+		_mm256_storeu_ps(final_mat.mMatrix[0].getF32ptr(), rows01);
+		_mm256_storeu_ps(final_mat.mMatrix[2].getF32ptr(), rows23);
+
+		LLVector4a t;
+		bind_shape_matrix.affineTransform(positions[j], t);
+		final_mat.affineTransform(t, out_positions[j]);
+
+		if (do_normals)
+		{
+			bind_shape_matrix.rotate(normals[j], t);
+			final_mat.rotate(t, out_normals[j]);
+		}
+	}
+
+	_mm256_zeroupper();
+}
+#endif
+
+void ll_skin_vertices_avx(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+						  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+						  LLVector4a* out_positions, LLVector4a* out_normals, U32 count)
+{
+#if LL_SIMD_AVX
+	if (ll_simd_use_avx())
+	{
+		skin_vertices_avx(palette, palette_size, bind_shape, weights, positions, normals, out_positions, out_normals, count);
+		return;
+	}
+#endif
+	ll_skin_vertices_sse(palette, palette_size, bind_shape, weights, positions, normals, out_positions, out_normals, count);
+}
@@ -0,0 +1,57 @@
+/** 
+ * @file llsimdkernels.h
+ * @brief Batch math kernels with a version per instruction set
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSIMDKERNELS_H
+#define LL_LLSIMDKERNELS_H
+
+#include "llmath.h"
+#include "llmatrix4a.h"
+
+// The plain entry points pick the widest version the CPU supports, decided
+// once from LLProcessorInfo.  Every version performs the same operations in
+// the same order (no fused multiply-add), so results match bit for bit.
+// The suffixed versions are for tests and benchmarks.
+
+// true when the CPU and OS both support AVX and the AVX kernels were built
+bool ll_simd_use_avx();
+
+// Four bone skinning, as done in software for rigged meshes.  Each weight
+// holds a palette index in its integer part and the weight in its fraction.
+// normals and out_normals may be NULL.
+void ll_skin_vertices(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+					  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+					  LLVector4a* out_positions, LLVector4a* out_normals, U32 count);
+
+void ll_skin_vertices_sse(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+						  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+						  LLVector4a* out_positions, LLVector4a* out_normals, U32 count);
+
+// falls back on the SSE version when AVX isn't available
+void ll_skin_vertices_avx(const LLMatrix4a* palette, U32 palette_size, const LLMatrix4a& bind_shape,
+						  const LLVector4a* weights, const LLVector4a* positions, const LLVector4a* normals,
+						  LLVector4a* out_positions, LLVector4a* out_normals, U32 count);
+
+#endif // LL_LLSIMDKERNELS_H
@@ -2224,26 +2224,7 @@ BOOL LLVolume::generate()
 		sNumMeshPoints += mMesh.size();		
 
 		//generate vertex positions
-
-		// Run along the path.
-		for (S32 s = 0; s < sizeS; ++s)
-		{
-			LLVector2  scale = mPathp->mPath[s].mScale;
-			LLQuaternion rot = mPathp->mPath[s].mRot;
-
-			// Run along the profile.
-			for (S32 t = 0; t < sizeT; ++t)
-			{
-				S32 m = s*sizeT + t;
-				Point& pt = mMesh[m];
-				
-				pt.mPos.mV[0] = mProfilep->mProfile[t].mV[0] * scale.mV[0];
-				pt.mPos.mV[1] = mProfilep->mProfile[t].mV[1] * scale.mV[1];
-				pt.mPos.mV[2] = 0.0f;
-				pt.mPos       = pt.mPos * rot;
-				pt.mPos      += mPathp->mPath[s].mPos;
-			}
-		}
+		generateMeshPositions();
 
 		for (std::vector<LLProfile::Face>::iterator iter = mProfilep->mFaces.begin();
 			 iter != mProfilep->mFaces.end(); ++iter)
@@ -2257,6 +2238,48 @@ BOOL LLVolume::generate()
 	return FALSE;
 }
 
+void LLVolume::generateMeshPositions()
+{
+	S32 sizeS = mPathp->mPath.size();
+	S32 sizeT = mProfilep->mProfile.size();
+
+	if (!sizeS || !sizeT)
+	{
+		return;
+	}
+
+	// Profile points are flat (z == 0), so each path point reduces to two scaled
+	// rotation rows plus a translation; apply them four lanes at a time.
+	for (S32 s = 0; s < sizeS; ++s)
+	{
+		const LLPath::PathPt& path_pt = mPathp->mPath[s];
+
+		LLMatrix4a rot;
+		rot.loadu(path_pt.mRot.getMatrix3());
+
+		LLVector4a row_x, row_y, offset;
+		row_x.setMul(rot.mMatrix[0], path_pt.mScale.mV[0]);
+		row_y.setMul(rot.mMatrix[1], path_pt.mScale.mV[1]);
+		offset.load3(path_pt.mPos.mV);
+
+		Point* pt = &mMesh[s*sizeT];
+
+		// Run along the profile.
+		for (S32 t = 0; t < sizeT; ++t)
+		{
+			const LLVector3& profile_pt = mProfilep->mProfile[t];
+
+			LLVector4a x, y, pos;
+			x.setMul(row_x, profile_pt.mV[0]);
+			y.setMul(row_y, profile_pt.mV[1]);
+			pos.setAdd(x, y);
+			pos.add(offset);
+
+			pt[t].mPos.set(pos.getF32ptr());
+		}
+	}
+}
+
 void LLVolumeFace::VertexData::init()
 {
 	if (!mData)
@@ -2724,6 +2747,185 @@ void LLVolume::copyVolumeFaces(const LLVolume* volume)
 	mSculptLevel = 0;
 }
 
+void LLVolume::swapVolumeFaces(LLVolume* volume)
+{
+	// Elements keep their addresses, so each face's octree stays valid
+	mVolumeFaces.swap(volume->mVolumeFaces);
+	mSculptLevel = 0;
+}
+
+// Raw face layout, bump the version whenever it changes
+static const U32 RAW_VOLUME_FACES_MAGIC = 0x464d4c4c; // "LLMF"
+static const U32 RAW_VOLUME_FACES_VERSION = 1;
+
+struct RawVolumeFacesHeader
+{
+	U32 mMagic;
+	U32 mVersion;
+	U32 mFaceCount;
+	U32 mPad;
+};
+
+struct RawVolumeFaceHeader
+{
+	LLVector4a mExtents[2];
+	LLVector2 mTexCoordExtents[2];
+	S32 mNumVertices;
+	S32 mNumIndices;
+	U32 mHasWeights;
+	U32 mPad;
+};
+
+// Bytes of each block of a face, padded to 16 like the face's own arrays
+static S32 raw_face_block_sizes(S32 num_verts, S32 num_indices, bool weights, S32& tc_size, S32& idx_size)
+{
+	S32 vert_size = num_verts * sizeof(LLVector4a);
+	tc_size = ((num_verts * sizeof(LLVector2)) + 0xF) & ~0xF;
+	idx_size = ((num_indices * sizeof(U16)) + 0xF) & ~0xF;
+	return sizeof(RawVolumeFaceHeader) + vert_size * (weights ? 3 : 2) + tc_size + idx_size;
+}
+
+S32 LLVolume::getRawVolumeFacesSize() const
+{
+	S32 size = sizeof(RawVolumeFacesHeader);
+	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
+	{
+		const LLVolumeFace& face = mVolumeFaces[i];
+		S32 tc_size, idx_size;
+		size += raw_face_block_sizes(face.mNumVertices, face.mNumIndices, face.mWeights != NULL, tc_size, idx_size);
+	}
+	return size;
+}
+
+void LLVolume::packRawVolumeFaces(U8* data) const
+{
+	RawVolumeFacesHeader* header = (RawVolumeFacesHeader*) data;
+	memset(header, 0, sizeof(RawVolumeFacesHeader));
+	header->mMagic = RAW_VOLUME_FACES_MAGIC;
+	header->mVersion = RAW_VOLUME_FACES_VERSION;
+	header->mFaceCount = mVolumeFaces.size();
+	data += sizeof(RawVolumeFacesHeader);
+
+	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
+	{
+		const LLVolumeFace& face = mVolumeFaces[i];
+		S32 tc_size, idx_size;
+		raw_face_block_sizes(face.mNumVertices, face.mNumIndices, face.mWeights != NULL, tc_size, idx_size);
+		S32 vert_size = face.mNumVertices * sizeof(LLVector4a);
+
+		RawVolumeFaceHeader* face_header = (RawVolumeFaceHeader*) data;
+		memset(face_header, 0, sizeof(RawVolumeFaceHeader));
+		face_header->mExtents[0] = face.mExtents[0];
+		face_header->mExtents[1] = face.mExtents[1];
+		face_header->mTexCoordExtents[0] = face.mTexCoordExtents[0];
+		face_header->mTexCoordExtents[1] = face.mTexCoordExtents[1];
+		face_header->mNumVertices = face.mNumVertices;
+		face_header->mNumIndices = face.mNumIndices;
+		face_header->mHasWeights = face.mWeights ? 1 : 0;
+		data += sizeof(RawVolumeFaceHeader);
+
+		memcpy(data, face.mPositions, vert_size);
+		data += vert_size;
+		memcpy(data, face.mNormals, vert_size);
+		data += vert_size;
+		if (face.mTexCoords)
+		{
+			memcpy(data, face.mTexCoords, tc_size);
+		}
+		else
+		{
+			memset(data, 0, tc_size);
+		}
+		data += tc_size;
+		if (face.mWeights)
+		{
+			memcpy(data, face.mWeights, vert_size);
+			data += vert_size;
+		}
+		memcpy(data, face.mIndices, idx_size);
+		data += idx_size;
+	}
+}
+
+bool LLVolume::unpackRawVolumeFaces(const U8* data, S32 size)
+{
+	const U8* end = data + size;
+	const RawVolumeFacesHeader* header = (const RawVolumeFacesHeader*) data;
+	if (size < (S32) sizeof(RawVolumeFacesHeader) ||
+		header->mMagic != RAW_VOLUME_FACES_MAGIC ||
+		header->mVersion != RAW_VOLUME_FACES_VERSION ||
+		header->mFaceCount == 0)
+	{
+		return false;
+	}
+	data += sizeof(RawVolumeFacesHeader);
+
+	face_list_t faces(header->mFaceCount);
+	for (U32 i = 0; i < header->mFaceCount; ++i)
+	{
+		if (end - data < (S32) sizeof(RawVolumeFaceHeader))
+		{
+			return false;
+		}
+		const RawVolumeFaceHeader* face_header = (const RawVolumeFaceHeader*) data;
+		S32 num_verts = face_header->mNumVertices;
+		S32 num_indices = face_header->mNumIndices;
+		if (num_verts <= 0 || num_verts > 65536 || num_indices <= 0 || num_indices % 3 != 0)
+		{
+			return false;
+		}
+		S32 tc_size, idx_size;
+		if (end - data < raw_face_block_sizes(num_verts, num_indices, face_header->mHasWeights != 0, tc_size, idx_size))
+		{
+			return false;
+		}
+		S32 vert_size = num_verts * sizeof(LLVector4a);
+
+		LLVolumeFace& face = faces[i];
+		face.mExtents[0] = face_header->mExtents[0];
+		face.mExtents[1] = face_header->mExtents[1];
+		face.mCenter->setAdd(face.mExtents[0], face.mExtents[1]);
+		face.mCenter->mul(0.5f);
+		face.mTexCoordExtents[0] = face_header->mTexCoordExtents[0];
+		face.mTexCoordExtents[1] = face_header->mTexCoordExtents[1];
+		data += sizeof(RawVolumeFaceHeader);
+
+		face.resizeVertices(num_verts);
+		face.resizeIndices(num_indices);
+		LLVector4a::memcpyNonAliased16((F32*) face.mPositions, (const F32*) data, vert_size);
+		data += vert_size;
+		LLVector4a::memcpyNonAliased16((F32*) face.mNormals, (const F32*) data, vert_size);
+		data += vert_size;
+		LLVector4a::memcpyNonAliased16((F32*) face.mTexCoords, (const F32*) data, tc_size);
+		data += tc_size;
+		if (face_header->mHasWeights)
+		{
+			face.allocateWeights(num_verts);
+			LLVector4a::memcpyNonAliased16((F32*) face.mWeights, (const F32*) data, vert_size);
+			data += vert_size;
+		}
+		LLVector4a::memcpyNonAliased16((F32*) face.mIndices, (const F32*) data, idx_size);
+		data += idx_size;
+	}
+
+	mVolumeFaces.swap(faces);
+	mSculptLevel = 0;
+	return true;
+}
+
+void LLVolume::prepareVolumeFaces()
+{
+	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
+	{
+		LLVolumeFace& face = mVolumeFaces[i];
+		if (face.mTexCoords)
+		{
+			face.createBinormals();
+		}
+		face.createOctree();
+	}
+}
+
 void LLVolume::cacheOptimize()
 {
 	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
@@ -4599,6 +4801,9 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
 	dir.setSub(end, start);
 
 	F32 closest_t = 2.f; // must be larger than 1
+
+	// pulled in to the closest hit so far, faces beyond it can't be closer
+	LLVector4a seg_end = end;
 	
 	end_face = llmin(end_face, getNumVolumeFaces()-1);
 
@@ -4613,7 +4818,7 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
 		LLVector4a box_size;
 		box_size.setSub(face.mExtents[1], face.mExtents[0]);
 
-        if (LLLineSegmentBoxIntersect(start, end, box_center, box_size))
+        if (LLLineSegmentBoxIntersect(start, seg_end, box_center, box_size))
 		{
 			if (bi_normal != NULL) // if the caller wants binormals, we may need to generate them
 			{
@@ -4698,6 +4903,13 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
 					hit_face = i;
 				}
 			}
+
+			if (closest_t < 1.f)
+			{
+				seg_end = dir;
+				seg_end.mul(closest_t);
+				seg_end.add(start);
+			}
 		}		
 	}
 	
@@ -1044,7 +1044,9 @@ public:
 	
 	void sculpt(U16 sculpt_width, U16 sculpt_height, S8 sculpt_components, const U8* sculpt_data, S32 sculpt_level);
 	void copyVolumeFaces(const LLVolume* volume);
+	void swapVolumeFaces(LLVolume* volume); // takes volume's faces, volume gets ours
 	void cacheOptimize();
+	void prepareVolumeFaces(); // builds binormals and octrees up front, e.g. on a loader thread
 
 private:
 	void sculptGenerateMapVertices(U16 sculpt_width, U16 sculpt_height, S8 sculpt_components, const U8* sculpt_data, U8 sculpt_type);
@@ -1055,10 +1057,20 @@ private:
 	
 protected:
 	BOOL generate();
+	void generateMeshPositions();
 	void createVolumeFaces();
 public:
 	virtual bool unpackVolumeFaces(std::istream& is, S32 size);
 
+	// Fixed layout copy of the unpacked faces (positions, normals, texture
+	// coordinates, weights and indices, every block 16 byte aligned) for
+	// local caching.  Loading it back is a straight copy, no parsing.
+	// data for packRawVolumeFaces() must hold getRawVolumeFacesSize() bytes,
+	// data for unpackRawVolumeFaces() must be 16 byte aligned.
+	S32 getRawVolumeFacesSize() const;
+	void packRawVolumeFaces(U8* data) const;
+	bool unpackRawVolumeFaces(const U8* data, S32 size);
+
 	virtual void setMeshAssetLoaded(BOOL loaded);
 	virtual BOOL isMeshAssetLoaded();
 
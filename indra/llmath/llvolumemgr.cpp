@@ -210,6 +210,71 @@ void LLVolumeMgr::dump()
 		mDataMutex->unlock();
 	}
 	llinfos << "Average usage of LODs " << avg << llendl;
+
+	U32 shared_lods, instances, duplicate_vertices;
+	getInstanceStats(shared_lods, instances, duplicate_vertices);
+	llinfos << "Shared LODs " << shared_lods << " used by " << instances
+			<< " objects, duplicating " << duplicate_vertices << " vertices" << llendl;
+}
+
+void LLVolumeMgr::getInstanceStats(U32& shared_lods, U32& instances, U32& duplicate_vertices) const
+{
+	shared_lods = 0;
+	instances = 0;
+	duplicate_vertices = 0;
+
+	if (mDataMutex)
+	{
+		mDataMutex->lock();
+	}
+	for (volume_lod_group_map_t::const_iterator iter = mVolumeLODGroups.begin(),
+			 end = mVolumeLODGroups.end();
+		 iter != end; iter++)
+	{
+		const LLVolumeLODGroup* volgroupp = iter->second;
+		for (S32 i = 0; i < LLVolumeLODGroup::NUM_LODS; i++)
+		{
+			if (volgroupp->getNumLODRefs(i) > 1)
+			{
+				shared_lods++;
+				instances += volgroupp->getNumLODRefs(i);
+			}
+		}
+		duplicate_vertices += volgroupp->getDuplicateVertexCount();
+	}
+	if (mDataMutex)
+	{
+		mDataMutex->unlock();
+	}
+}
+
+void LLVolumeMgr::getMemoryStats(U32& prim_bytes, U32& mesh_bytes) const
+{
+	prim_bytes = 0;
+	mesh_bytes = 0;
+
+	if (mDataMutex)
+	{
+		mDataMutex->lock();
+	}
+	for (volume_lod_group_map_t::const_iterator iter = mVolumeLODGroups.begin(),
+			 end = mVolumeLODGroups.end();
+		 iter != end; iter++)
+	{
+		const LLVolumeLODGroup* volgroupp = iter->second;
+		if ((volgroupp->getVolumeParams()->getSculptType() & LL_SCULPT_TYPE_MASK) == LL_SCULPT_TYPE_MESH)
+		{
+			mesh_bytes += volgroupp->getFaceBytes();
+		}
+		else
+		{
+			prim_bytes += volgroupp->getFaceBytes();
+		}
+	}
+	if (mDataMutex)
+	{
+		mDataMutex->unlock();
+	}
 }
 
 void LLVolumeMgr::useMutex()
@@ -327,6 +392,51 @@ BOOL LLVolumeLODGroup::derefLOD(LLVolume *volumep)
 	return FALSE;
 }
 
+U32 LLVolumeLODGroup::getDuplicateVertexCount() const
+{
+	U32 count = 0;
+	for (S32 i = 0; i < NUM_LODS; i++)
+	{
+		if (mLODRefs[i] > 1 && mVolumeLODs[i].notNull())
+		{
+			U32 vertices = 0;
+			for (S32 j = 0; j < mVolumeLODs[i]->getNumVolumeFaces(); j++)
+			{
+				vertices += mVolumeLODs[i]->getVolumeFace(j).mNumVertices;
+			}
+			count += vertices * (mLODRefs[i] - 1);
+		}
+	}
+	return count;
+}
+
+U32 LLVolumeLODGroup::getFaceBytes() const
+{
+	U32 bytes = 0;
+	for (S32 i = 0; i < NUM_LODS; i++)
+	{
+		if (mVolumeLODs[i].isNull())
+		{
+			continue;
+		}
+		for (S32 j = 0; j < mVolumeLODs[i]->getNumVolumeFaces(); j++)
+		{
+			const LLVolumeFace& face = mVolumeLODs[i]->getVolumeFace(j);
+			U32 vertex_size = sizeof(LLVector4a) * 2 + sizeof(LLVector2);
+			if (face.mBinormals)
+			{
+				vertex_size += sizeof(LLVector4a);
+			}
+			if (face.mWeights)
+			{
+				vertex_size += sizeof(LLVector4a);
+			}
+			bytes += face.mNumVertices * vertex_size + face.mNumIndices * sizeof(U16);
+		}
+	}
+	return bytes;
+}
+
 S32 LLVolumeLODGroup::getDetailFromTan(const F32 tan_angle)
 {
 	S32 i = 0;
@@ -58,6 +58,13 @@ public:
 	LLVolume* refLOD(const S32 detail);
 	BOOL derefLOD(LLVolume *volumep);
 	S32 getNumRefs() const { return mRefs; }
+	S32 getNumLODRefs(const S32 detail) const { return mLODRefs[detail]; }
+	LLVolume* getLOD(const S32 detail) const { return mVolumeLODs[detail]; }
+	// Vertices that would go away if every extra user of a shared LOD drew the
+	// one copy instead of baking its own into a group vertex buffer
+	U32 getDuplicateVertexCount() const;
+	// Heap bytes held by the faces of all loaded LODs
+	U32 getFaceBytes() const;
 	
 	const LLVolumeParams* getVolumeParams() const { return &mVolumeParams; };
 
@@ -92,6 +99,13 @@ public:
 
 	void dump();
 
+	// Volume/LOD pairs referenced by more than one object, the objects using them,
+	// and the vertices those extra objects duplicate
+	void getInstanceStats(U32& shared_lods, U32& instances, U32& duplicate_vertices) const;
+
+	// Face data held by prim and sculpt volumes, and by mesh volumes
+	void getMemoryStats(U32& prim_bytes, U32& mesh_bytes) const;
+
 	// manually call this for mutex magic
 	void useMutex();
 
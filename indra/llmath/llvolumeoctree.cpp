@@ -105,7 +105,11 @@ LLOctreeTriangleRayIntersect::LLOctreeTriangleRayIntersect(const LLVector4a& sta
 	 mClosestT(closest_t),
 	 mHitFace(false)
 {
-	mEnd.setAdd(mStart, mDir);
+	// nothing past an earlier face's hit can be closer, so the segment
+	// only needs to reach that far
+	mEnd = mDir;
+	mEnd.mul(llmin(*mClosestT, 1.f));
+	mEnd.add(mStart);
 }
 
 void LLOctreeTriangleRayIntersect::traverse(const LLOctreeNode<LLVolumeTriangle>* node)
@@ -147,12 +151,14 @@ void LLOctreeTriangleRayIntersect::visit(const LLOctreeNode<LLVolumeTriangle>* n
 				*mClosestT = t;
 				mHitFace = true;
 
+				// shorten the segment so nodes beyond this hit are skipped
+				mEnd = mDir;
+				mEnd.mul(t);
+				mEnd.add(mStart);
+
 				if (mIntersection != NULL)
 				{
-					LLVector4a intersect = mDir;
-					intersect.mul(*mClosestT);
-					intersect.add(mStart);
-					mIntersection->set(intersect.getF32ptr());
+					mIntersection->set(mEnd.getF32ptr());
 				}
 
 
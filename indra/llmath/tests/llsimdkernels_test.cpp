@@ -0,0 +1,133 @@
+/** 
+ * @file llsimdkernels_test.cpp
+ * @brief Checks that every version of the SIMD kernels gives the same results
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llsimdkernels.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct llsimdkernels_data
+	{
+		enum { NUM_VERTS = 257, PALETTE_SIZE = 8 };
+
+		llsimdkernels_data()
+		{
+			mBuffer = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a) * NUM_VERTS * 7);
+			mWeights = mBuffer;
+			mPositions = mWeights + NUM_VERTS;
+			mNormals = mPositions + NUM_VERTS;
+			for (U32 i = 0; i < 4; i++)
+			{
+				mOut[i] = mNormals + NUM_VERTS * (i + 1);
+			}
+
+			for (U32 i = 0; i < PALETTE_SIZE; i++)
+			{
+				for (U32 j = 0; j < 4; j++)
+				{
+					mPalette[i].mMatrix[j].set(frand(), frand(), frand(), j == 3 ? 1.f : 0.f);
+				}
+			}
+			for (U32 j = 0; j < 4; j++)
+			{
+				mBindShape.mMatrix[j].set(frand(), frand(), frand(), j == 3 ? 1.f : 0.f);
+			}
+
+			for (U32 i = 0; i < NUM_VERTS; i++)
+			{
+				// the integer part picks the joint, indices past the end get clamped
+				mWeights[i].set((i % PALETTE_SIZE) + 0.5f,
+								((i * 3) % (PALETTE_SIZE + 2)) + 0.25f,
+								((i * 5) % PALETTE_SIZE) + 0.125f,
+								((i * 7) % PALETTE_SIZE) + 0.0625f);
+				mPositions[i].set(frand(), frand(), frand(), 1.f);
+				mNormals[i].set(frand(), frand(), frand(), 0.f);
+			}
+		}
+
+		~llsimdkernels_data()
+		{
+			ll_aligned_free_16(mBuffer);
+		}
+
+		// deterministic values in [-1, 1)
+		F32 frand()
+		{
+			sSeed = sSeed * 1103515245 + 12345;
+			return ((sSeed >> 8) & 0xFFFF) / 32768.f - 1.f;
+		}
+
+		static U32 sSeed;
+		LLMatrix4a mPalette[PALETTE_SIZE];
+		LLMatrix4a mBindShape;
+		LLVector4a* mBuffer;
+		LLVector4a* mWeights;
+		LLVector4a* mPositions;
+		LLVector4a* mNormals;
+		LLVector4a* mOut[4];
+	};
+	U32 llsimdkernels_data::sSeed = 1;
+
+	typedef test_group<llsimdkernels_data> llsimdkernels_test;
+	typedef llsimdkernels_test::object llsimdkernels_object;
+	tut::llsimdkernels_test llsimdkernels_testcase("llsimdkernels");
+
+	template<> template<>
+	void llsimdkernels_object::test<1>()
+	{
+		// a vertex fully weighted to one joint just gets that joint's transform
+		mWeights[0].set(2.5f, 2.5f, 2.5f, 2.5f);
+		ll_skin_vertices_sse(mPalette, PALETTE_SIZE, mBindShape, mWeights, mPositions, mNormals, mOut[0], mOut[1], 1);
+
+		LLVector4a t, expected;
+		mBindShape.affineTransform(mPositions[0], t);
+		mPalette[2].affineTransform(t, expected);
+		ensure("single joint position", mOut[0][0].equals3(expected, 0.0001f));
+	}
+
+	template<> template<>
+	void llsimdkernels_object::test<2>()
+	{
+		ll_skin_vertices_sse(mPalette, PALETTE_SIZE, mBindShape, mWeights, mPositions, mNormals, mOut[0], mOut[1], NUM_VERTS);
+		ll_skin_vertices_avx(mPalette, PALETTE_SIZE, mBindShape, mWeights, mPositions, mNormals, mOut[2], mOut[3], NUM_VERTS);
+
+		ensure("avx positions match sse", memcmp(mOut[0], mOut[2], sizeof(LLVector4a) * NUM_VERTS) == 0);
+		ensure("avx normals match sse", memcmp(mOut[1], mOut[3], sizeof(LLVector4a) * NUM_VERTS) == 0);
+	}
+
+	template<> template<>
+	void llsimdkernels_object::test<3>()
+	{
+		// normals are optional
+		ll_skin_vertices_sse(mPalette, PALETTE_SIZE, mBindShape, mWeights, mPositions, mNormals, mOut[0], mOut[1], NUM_VERTS);
+		ll_skin_vertices(mPalette, PALETTE_SIZE, mBindShape, mWeights, mPositions, NULL, mOut[2], NULL, NUM_VERTS);
+
+		ensure("positions without normals", memcmp(mOut[0], mOut[2], sizeof(LLVector4a) * NUM_VERTS) == 0);
+	}
+}
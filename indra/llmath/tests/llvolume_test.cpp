@@ -0,0 +1,129 @@
+/**
+ * @file llvolume_test.cpp
+ * @date October 2026
+ * @brief Test cases and timing for LLVolume prim generation
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "../llvolume.h"
+#include "../llquaternion.h"
+#include "llpointer.h"
+#include "lltimer.h"
+
+namespace
+{
+	LLVolumeParams make_params(U8 profile, U8 path, F32 twist, F32 taper)
+	{
+		LLVolumeParams params;
+		params.setType(profile, path);
+		params.setBeginAndEndS(0.f, 1.f);
+		params.setBeginAndEndT(0.f, 1.f);
+		params.setRatio(taper, taper);
+		params.setShear(0.f, 0.f);
+		params.setTwistBegin(0.f);
+		params.setTwistEnd(twist);
+		return params;
+	}
+
+	// scalar reference for LLVolume::generateMeshPositions
+	F32 max_mesh_error(const LLVolume& volume)
+	{
+		const std::vector<LLVector3>& profile = volume.getProfile().mProfile;
+		const std::vector<LLPath::PathPt>& path = volume.getPath().mPath;
+		const std::vector<LLVolume::Point>& mesh = volume.getMesh();
+
+		F32 max_err = 0.f;
+		for (U32 s = 0; s < path.size(); ++s)
+		{
+			for (U32 t = 0; t < profile.size(); ++t)
+			{
+				LLVector3 pos(profile[t].mV[0] * path[s].mScale.mV[0],
+							  profile[t].mV[1] * path[s].mScale.mV[1],
+							  0.f);
+				pos = pos * path[s].mRot;
+				pos += path[s].mPos;
+
+				max_err = llmax(max_err, dist_vec(pos, mesh[s*profile.size() + t].mPos));
+			}
+		}
+		return max_err;
+	}
+}
+
+namespace tut
+{
+	struct llvolume_test
+	{
+	};
+	typedef test_group<llvolume_test> llvolume_test_t;
+	typedef llvolume_test_t::object llvolume_test_object_t;
+	tut::llvolume_test_t tut_llvolume_test("LLVolume");
+
+	// vectorized mesh positions match the scalar quaternion path
+	template<> template<>
+	void llvolume_test_object_t::test<1>()
+	{
+		const U8 types[][2] =
+		{
+			{ LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE },
+			{ LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_LINE },
+			{ LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_CIRCLE },
+			{ LL_PCODE_PROFILE_EQUALTRI, LL_PCODE_PATH_CIRCLE },
+		};
+
+		for (U32 i = 0; i < LL_ARRAY_SIZE(types); ++i)
+		{
+			LLVolumeParams params = make_params(types[i][0], types[i][1], 0.5f, 0.75f);
+			LLPointer<LLVolume> volume = new LLVolume(params, 3.f);
+
+			ensure("mesh generated", !volume->getMesh().empty());
+			ensure("mesh positions match scalar generation", max_mesh_error(*volume) < 0.0001f);
+		}
+	}
+
+	// regeneration timing, tracked in the test log
+	template<> template<>
+	void llvolume_test_object_t::test<2>()
+	{
+		const U32 COUNT = 500;
+
+		LLVolumeParams params = make_params(LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_CIRCLE, 1.f, 0.5f);
+
+		LLTimer timer;
+		U32 vertices = 0;
+		for (U32 i = 0; i < COUNT; ++i)
+		{
+			LLPointer<LLVolume> volume = new LLVolume(params, 4.f);
+			vertices += volume->getMesh().size();
+		}
+		F32 elapsed = timer.getElapsedTimeF32();
+
+		llinfos << "Generated " << COUNT << " tori (" << vertices << " mesh points) in "
+				<< elapsed * 1000.f << " ms" << llendl;
+
+		ensure("generated mesh points", vertices > 0);
+	}
+}
@@ -29,6 +29,7 @@
 #include "llavatarnamecache.h"
 
 #include "llcachename.h"		// we wrap this system
+#include "llflathashmap.h"
 #include "llframetimer.h"
 #include "llhttpclient.h"
 #include "llsd.h"
@@ -79,13 +80,22 @@ namespace LLAvatarNameCache
 	signal_map_t sSignalMap;
 
 	// names we know about
-	typedef std::map<LLUUID, LLAvatarName> cache_t;
+	typedef LLFlatHashMap<LLUUID, LLAvatarName> cache_t;
 	cache_t sCache;
 
 	// Send bulk lookup requests a few times a second at most
 	// only need per-frame timing resolution
 	LLFrameTimer sRequestTimer;
 
+	// 100 ms is the threshold for "user speed" operations, so asks wait
+	// about that long for others to share their request with
+	const F32 SECS_BETWEEN_REQUESTS = 0.1f;
+
+	// Apache can handle URLs of 4096 chars, leave some room for the rest
+	// of the request line
+	const U32 NAME_URL_MAX = 4000;
+	const U32 NAME_URL_ID_SIZE = 41;	// "&ids=" plus a UUID
+
     /// Maximum time an unrefreshed cache entry is allowed
     const F64 MAX_UNREFRESHED_TIME = 20.0 * 60.0;
 
@@ -103,6 +113,12 @@ namespace LLAvatarNameCache
 					 const LLAvatarName& av_name,
 					 bool add_to_cache);
 
+	// Queue an agent for the next batched request
+	void askName(const LLUUID& agent_id);
+
+	// How many IDs fit in one capability request URL
+	U32 getIdsPerRequest();
+
 	void requestNamesViaCapability();
 
 	// Legacy name system callback
@@ -274,7 +290,7 @@ public:
 // Provide some fallback for agents that return errors
 void LLAvatarNameCache::handleAgentError(const LLUUID& agent_id)
 {
-	std::map<LLUUID,LLAvatarName>::iterator existing = sCache.find(agent_id);
+	cache_t::iterator existing = sCache.find(agent_id);
 	if (existing == sCache.end())
     {
         // there is no existing cache entry, so make a temporary name from legacy
@@ -333,10 +349,6 @@ void LLAvatarNameCache::requestNamesViaCapability()
 
 	// URL format is like:
 	// http://pdp60.lindenlab.com:8000/agents/?ids=3941037e-78ab-45f0-b421-bd6e77c1804d&ids=0012809d-7d2d-4c24-9609-af1230a37715&ids=0019aaba-24af-4f0a-aa72-6457953cf7f0
-	//
-	// Apache can handle URLs of 4096 chars, but let's be conservative
-	const U32 NAME_URL_MAX = 4096;
-	const U32 NAME_URL_SEND_THRESHOLD = 3000;
 	std::string url;
 	url.reserve(NAME_URL_MAX);
 
@@ -368,7 +380,8 @@ void LLAvatarNameCache::requestNamesViaCapability()
 		// mark request as pending
 		sPendingQueue[agent_id] = now;
 
-		if (url.size() > NAME_URL_SEND_THRESHOLD)
+		// send once another ID would not fit
+		if (url.size() + NAME_URL_ID_SIZE > NAME_URL_MAX)
 		{
 			LL_DEBUGS("AvNameCache") << "LLAvatarNameCache::requestNamesViaCapability first "
 									 << ids << " ids"
@@ -393,6 +406,22 @@ void LLAvatarNameCache::requestNamesViaCapability()
 	sAskQueue.clear();
 }
 
+void LLAvatarNameCache::askName(const LLUUID& agent_id)
+{
+	if (sAskQueue.empty())
+	{
+		// the coalescing window starts with the first ask
+		sRequestTimer.reset();
+	}
+	sAskQueue.insert(agent_id);
+}
+
+U32 LLAvatarNameCache::getIdsPerRequest()
+{
+	U32 base = sNameLookupURL.size();
+	return base + NAME_URL_ID_SIZE < NAME_URL_MAX ? (NAME_URL_MAX - base) / NAME_URL_ID_SIZE : 1;
+}
+
 void LLAvatarNameCache::legacyNameCallback(const LLUUID& agent_id,
 										   const std::string& full_name,
 										   bool is_group)
@@ -509,16 +538,12 @@ void LLAvatarNameCache::idle()
 	// By convention, start running at first idle() call
 	sRunning = true;
 
-	// *TODO: Possibly re-enabled this based on People API load measurements
-	// 100 ms is the threshold for "user speed" operations, so we can
-	// stall for about that long to batch up requests.
-	//const F32 SECS_BETWEEN_REQUESTS = 0.1f;
-	//if (!sRequestTimer.checkExpirationAndReset(SECS_BETWEEN_REQUESTS))
-	//{
-	//	return;
-	//}
-
-	if (!sAskQueue.empty())
+	// Asks arrive a few at a time as UI and objects come in, hold them
+	// briefly so they go out in full requests instead of one per frame.
+	// Legacy lookups are coalesced again by LLCacheName.
+	if (!sAskQueue.empty()
+		&& (sRequestTimer.getElapsedTimeF32() >= SECS_BETWEEN_REQUESTS
+			|| sAskQueue.size() >= getIdsPerRequest()))
 	{
         if (useDisplayNames())
         {
@@ -604,7 +629,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 		if (useDisplayNames())
 		{
 			// ...use display names cache
-			std::map<LLUUID,LLAvatarName>::iterator it = sCache.find(agent_id);
+			cache_t::iterator it = sCache.find(agent_id);
 			if (it != sCache.end())
 			{
 				*av_name = it->second;
@@ -617,7 +642,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 						LL_DEBUGS("AvNameCache") << "LLAvatarNameCache::get "
 												 << "refresh agent " << agent_id
 												 << LL_ENDL;
-						sAskQueue.insert(agent_id);
+						askName(agent_id);
 					}
 				}
 				
@@ -641,7 +666,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 		LL_DEBUGS("AvNameCache") << "LLAvatarNameCache::get "
 								 << "queue request for agent " << agent_id
 								 << LL_ENDL;
-		sAskQueue.insert(agent_id);
+		askName(agent_id);
 	}
 
 	return false;
@@ -664,7 +689,7 @@ void LLAvatarNameCache::get(const LLUUID& agent_id, callback_slot_t slot)
 		if (useDisplayNames())
 		{
 			// ...use new cache
-			std::map<LLUUID,LLAvatarName>::iterator it = sCache.find(agent_id);
+			cache_t::iterator it = sCache.find(agent_id);
 			if (it != sCache.end())
 			{
 				const LLAvatarName& av_name = it->second;
@@ -694,7 +719,7 @@ void LLAvatarNameCache::get(const LLUUID& agent_id, callback_slot_t slot)
 	// schedule a request
 	if (!isRequestPending(agent_id))
 	{
-		sAskQueue.insert(agent_id);
+		askName(agent_id);
 	}
 
 	// always store additional callback, even if request is pending
@@ -760,7 +785,7 @@ void LLAvatarNameCache::erase(const LLUUID& agent_id)
 void LLAvatarNameCache::fetch(const LLUUID& agent_id)
 {
 	// re-request, even if request is already pending
-	sAskQueue.insert(agent_id);
+	askName(agent_id);
 }
 
 void LLAvatarNameCache::insert(const LLUUID& agent_id, const LLAvatarName& av_name)
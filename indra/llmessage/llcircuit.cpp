@@ -64,6 +64,13 @@ const F32 TARGET_PERIOD_LENGTH = 5.f;	// seconds
 const F32 LL_DUPLICATE_SUPPRESSION_TIMEOUT = 60.f; //seconds - this can be long, as time-based cleanup is
 													// only done when wrapping packetids, now...
 
+// Standalone PacketAck messages are held back for a fraction of the ping so
+// outgoing traffic gets a chance to carry the acks instead. This has to stay
+// well under LL_MINIMUM_RELIABLE_TIMEOUT_SECONDS or the far end will resend.
+const F32 LL_ACK_DELAY_PING_FRACTION = 0.25f;
+const F32 LL_MAX_ACK_DELAY_SECONDS = 0.05f;
+const S32 LL_MAX_ACKS_PER_PACKET = 250;
+
 LLCircuitData::LLCircuitData(const LLHost &host, TPACKETID in_id, 
 							 const F32 circuit_heartbeat_interval, const F32 circuit_timeout)
 :	mHost (host),
@@ -87,6 +94,8 @@ LLCircuitData::LLCircuitData(const LLHost &host, TPACKETID in_id,
 	mPingDelayAveraged((F32)INITIAL_PING_VALUE_MSEC), 
 	mUnackedPacketCount(0),
 	mUnackedPacketBytes(0),
+	mNextResendTime(0.0),
+	mFirstAckTime(0.0),
 	mLastPacketInTime(0.0),
 	mLocalEndPointID(),
 	mPacketsOut(0),
@@ -270,8 +279,15 @@ void LLCircuitData::ackReliablePacket(TPACKETID packet_num)
 
 S32 LLCircuitData::resendUnackedPackets(const F64 now)
 {
+	if (now < mNextResendTime)
+	{
+		// Nothing on either list can have expired yet
+		return mUnackedPacketCount;
+	}
+
 	S32 resent_packets = 0;
 	LLReliablePacket *packetp;
+	F64 next_resend_time = F64_MAX;
 
 
 	//
@@ -311,6 +327,7 @@ S32 LLCircuitData::resendUnackedPackets(const F64 now)
 				}
 				else
 				{
+					next_resend_time = llmin(next_resend_time, packetp->mExpirationTime);
 					++iter;
 				}
 				// Move on to the next unacked packet.
@@ -324,6 +341,8 @@ S32 LLCircuitData::resendUnackedPackets(const F64 now)
 						<< " bytes of reliable messages waiting" << llendl;
 			}
 			// Stop resending.  There are less than 512000 unacked packets.
+			// The rest of the list hasn't been looked at, so scan again next time.
+			next_resend_time = now;
 			break;
 		}
 
@@ -362,6 +381,7 @@ S32 LLCircuitData::resendUnackedPackets(const F64 now)
 				// custom, constant retry time
 				packetp->mExpirationTime = now + packetp->mTimeout;
 			}
+			next_resend_time = llmin(next_resend_time, packetp->mExpirationTime);
 
 			if (!packetp->mRetries)
 			{
@@ -379,6 +399,7 @@ S32 LLCircuitData::resendUnackedPackets(const F64 now)
 		else
 		{
 			// Don't need to do anything with this packet, keep iterating.
+			next_resend_time = llmin(next_resend_time, packetp->mExpirationTime);
 			++iter;
 		}
 	}
@@ -419,10 +440,13 @@ S32 LLCircuitData::resendUnackedPackets(const F64 now)
 		}
 		else
 		{
+			next_resend_time = llmin(next_resend_time, packetp->mExpirationTime);
 			++iter;
 		}
 	}
 
+	mNextResendTime = next_resend_time;
+
 	return mUnackedPacketCount;
 }
 
@@ -579,6 +603,8 @@ void LLCircuitData::addReliablePacket(S32 mSocket, U8 *buf_ptr, S32 buf_len, LLR
 	{
 		mFinalRetryPackets[packet_info->mPacketID] = packet_info;
 	}
+
+	mNextResendTime = llmin(mNextResendTime, packet_info->mExpirationTime);
 }
 
 
@@ -1076,6 +1102,7 @@ BOOL LLCircuitData::collectRAck(TPACKETID packet_num)
 	{
 		// First extra ack, we need to add ourselves to the list of circuits that need to send acks
 		gMessageSystem->mCircuitInfo.mSendAckMap[mHost] = this;
+		mFirstAckTime = LLMessageSystem::getMessageTimeSeconds();
 	}
 
 	mAcks.push_back(packet_num);
@@ -1086,13 +1113,23 @@ BOOL LLCircuitData::collectRAck(TPACKETID packet_num)
 // send out any acks that did not get sent already.
 void LLCircuit::sendAcks()
 {
+	F64 now = LLMessageSystem::getMessageTimeSeconds();
+
 	LLCircuitData* cd;
-	circuit_data_map::iterator end = mSendAckMap.end();
-	for(circuit_data_map::iterator it = mSendAckMap.begin(); it != end; ++it)
+	for(circuit_data_map::iterator it = mSendAckMap.begin(); it != mSendAckMap.end(); )
 	{
 		cd = (*it).second;
 
 		S32 count = (S32)cd->mAcks.size();
+		F32 ack_delay = llmin(LL_MAX_ACK_DELAY_SECONDS, 
+							  LL_ACK_DELAY_PING_FRACTION * 0.001f * cd->getPingDelayAveraged());
+		if(count > 0 && count <= LL_MAX_ACKS_PER_PACKET && now - cd->mFirstAckTime < ack_delay)
+		{
+			// Young enough to wait for an outgoing packet to piggyback on
+			++it;
+			continue;
+		}
+
 		if(count > 0)
 		{
 			// send the packet acks
@@ -1106,7 +1143,7 @@ void LLCircuit::sendAcks()
 				gMessageSystem->nextBlockFast(_PREHASH_Packets);
 				gMessageSystem->addU32Fast(_PREHASH_ID, cd->mAcks[i]);
 				++acks_this_packet;
-				if(acks_this_packet > 250)
+				if(acks_this_packet > LL_MAX_ACKS_PER_PACKET)
 				{
 					gMessageSystem->sendMessage(cd->mHost);
 					acks_this_packet = 0;
@@ -1129,10 +1166,9 @@ void LLCircuit::sendAcks()
 			// empty out the acks list
 			cd->mAcks.clear();
 		}
-	}
 
-	// All acks have been sent, clear the map
-	mSendAckMap.clear();
+		mSendAckMap.erase(it++);
+	}
 }
 
 
@@ -248,6 +248,8 @@ protected:
 
 	S32										mUnackedPacketCount;
 	S32										mUnackedPacketBytes;
+	F64										mNextResendTime;		// Earliest expiration on either unacked list
+	F64										mFirstAckTime;			// When the oldest entry in mAcks was collected
 
 	F64										mLastPacketInTime;		// Time of last packet arrival
 
@@ -0,0 +1,94 @@
+/**
+ * @file llcorohttp.cpp
+ * @brief HTTP requests that suspend the calling coroutine until they finish.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llcorohttp.h"
+#include "llhttpstatuscodes.h"
+
+LLCoroHTTPRequests::State::State()
+:	mPending(0),
+	mDonePump("LLCoroHTTPRequests", true) // tweak name for uniqueness
+{
+}
+
+LLCoroHTTPRequests::LLCoroHTTPRequests()
+:	mState(new State)
+{
+}
+
+S32 LLCoroHTTPRequests::addRequest()
+{
+	mState->mResults.push_back(Result());
+	mState->mPending++;
+	return (S32)mState->mResults.size() - 1;
+}
+
+S32 LLCoroHTTPRequests::get(const std::string& url, F32 timeout)
+{
+	S32 index = addRequest();
+	LLHTTPClient::get(url, new Responder(mState, index), LLSD(), timeout);
+	return index;
+}
+
+S32 LLCoroHTTPRequests::post(const std::string& url, const LLSD& body, F32 timeout)
+{
+	S32 index = addRequest();
+	LLHTTPClient::post(url, body, new Responder(mState, index), LLSD(), timeout);
+	return index;
+}
+
+//virtual
+void LLCoroHTTPRequests::Responder::result(const LLSD& content)
+{
+	finish(true, HTTP_OK, std::string(), content);
+}
+
+//virtual
+void LLCoroHTTPRequests::Responder::errorWithContent(U32 status, const std::string& reason, const LLSD& content)
+{
+	finish(false, status, reason, content);
+}
+
+void LLCoroHTTPRequests::Responder::finish(bool success, U32 status, const std::string& reason, const LLSD& content)
+{
+	Result& result = mState->mResults[mIndex];
+	if (result.mDone)
+	{
+		return;
+	}
+	result.mDone = true;
+	result.mSuccess = success;
+	result.mStatus = status;
+	result.mReason = reason;
+	result.mContent = content;
+
+	if (--mState->mPending == 0)
+	{
+		// wakes a coroutine in waitAll(), if there is one
+		mState->mDonePump.post(LLSD());
+	}
+}
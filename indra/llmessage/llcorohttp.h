@@ -0,0 +1,147 @@
+/**
+ * @file llcorohttp.h
+ * @brief HTTP requests that suspend the calling coroutine until they finish.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLCOROHTTP_H
+#define LL_LLCOROHTTP_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "llevents.h"
+#include "lleventcoro.h"
+#include "llhttpclient.h"
+#include "llsd.h"
+
+// A set of HTTP requests started from a coroutine, which can then wait for
+// all of them at once.  Requests go out as soon as they are added, so
+// independent requests run side by side instead of one after another:
+//
+//	LLCoroHTTPRequests requests;
+//	S32 caps = requests.post(seed_url, cap_names);
+//	S32 features = requests.get(features_url);
+//	requests.waitAll(self);
+//	if (requests.succeeded(caps)) ... requests.getContent(caps) ...
+//
+// The responders only hold on to shared state, so the coroutine (and this
+// object) may go away before the replies come in.
+class LLCoroHTTPRequests
+{
+public:
+	LLCoroHTTPRequests();
+
+	// Each returns the index to ask about the result with
+	S32 get(const std::string& url, F32 timeout = HTTP_REQUEST_EXPIRY_SECS);
+	S32 post(const std::string& url, const LLSD& body, F32 timeout = HTTP_REQUEST_EXPIRY_SECS);
+
+	// Suspends the calling coroutine until every request added so far is done.
+	template <typename SELF>
+	void waitAll(SELF& self)
+	{
+		while (mState->mPending > 0)
+		{
+			waitForEventOn(self, mState->mDonePump);
+		}
+	}
+
+	S32 getCount() const						{ return (S32)mState->mResults.size(); }
+	bool isDone(S32 index) const				{ return mState->mResults[index].mDone; }
+	bool succeeded(S32 index) const				{ return mState->mResults[index].mSuccess; }
+	U32 getStatus(S32 index) const				{ return mState->mResults[index].mStatus; }
+	const std::string& getReason(S32 index) const	{ return mState->mResults[index].mReason; }
+	const LLSD& getContent(S32 index) const		{ return mState->mResults[index].mContent; }
+
+private:
+	struct Result
+	{
+		Result() : mDone(false), mSuccess(false), mStatus(0) {}
+
+		bool		mDone;
+		bool		mSuccess;
+		U32			mStatus;
+		std::string	mReason;
+		LLSD		mContent;
+	};
+
+	struct State
+	{
+		State();
+
+		std::vector<Result>	mResults;
+		S32					mPending;
+		// gets an event each time the last pending request finishes
+		LLEventStream		mDonePump;
+	};
+	typedef boost::shared_ptr<State> state_ptr_t;
+
+	class Responder : public LLHTTPClient::Responder
+	{
+	public:
+		Responder(const state_ptr_t& state, S32 index) : mState(state), mIndex(index) {}
+
+		virtual void result(const LLSD& content);
+		virtual void errorWithContent(U32 status, const std::string& reason, const LLSD& content);
+
+	private:
+		void finish(bool success, U32 status, const std::string& reason, const LLSD& content);
+
+		state_ptr_t	mState;
+		S32			mIndex;
+	};
+
+	S32 addRequest();
+
+	state_ptr_t mState;
+};
+
+// Single request forms, for a coroutine that has nothing else to do while
+// it waits.  Both return the reply body; on failure they return an
+// undefined LLSD and fill in status and reason if asked.
+template <typename SELF>
+LLSD httpGetAndWait(SELF& self, const std::string& url, F32 timeout = HTTP_REQUEST_EXPIRY_SECS,
+					U32* status = NULL, std::string* reason = NULL)
+{
+	LLCoroHTTPRequests request;
+	S32 index = request.get(url, timeout);
+	request.waitAll(self);
+	if (status) *status = request.getStatus(index);
+	if (reason) *reason = request.getReason(index);
+	return request.succeeded(index) ? request.getContent(index) : LLSD();
+}
+
+template <typename SELF>
+LLSD httpPostAndWait(SELF& self, const std::string& url, const LLSD& body, F32 timeout = HTTP_REQUEST_EXPIRY_SECS,
+					 U32* status = NULL, std::string* reason = NULL)
+{
+	LLCoroHTTPRequests request;
+	S32 index = request.post(url, body, timeout);
+	request.waitAll(self);
+	if (status) *status = request.getStatus(index);
+	if (reason) *reason = request.getReason(index);
+	return request.succeeded(index) ? request.getContent(index) : LLSD();
+}
+
+#endif // LL_LLCOROHTTP_H
@@ -41,13 +41,19 @@
 #include <algorithm>
 #include <iomanip>
 #include <curl/curl.h>
+#if !LL_WINDOWS
+#include <sys/select.h>
+#include <arpa/inet.h>
+#endif
 #if SAFE_SSL
 #include <openssl/crypto.h>
 #endif
 
+#include "llares.h"
 #include "llbufferstream.h"
 #include "llproxy.h"
 #include "llsdserialize.h"
+#include "lluri.h"
 #include "llstl.h"
 #include "llthread.h"
 #include "lltimer.h"
@@ -72,6 +78,7 @@
 
 static const U32 EASY_HANDLE_POOL_SIZE		= 5;
 static const S32 MULTI_PERFORM_CALL_REPEAT	= 5;
+static const long MULTI_SOCKET_WAIT_MS		= 5; // longest the curl thread sleeps on one multi's sockets
 static const S32 CURL_REQUEST_TIMEOUT = 30; // seconds per operation
 static const S32 MAX_ACTIVE_REQUEST_COUNT = 100;
 
@@ -91,6 +98,14 @@ S32      LLCurl::sTotalHandles = 0 ;
 bool     LLCurl::sNotQuitting = true;
 F32      LLCurl::sCurlRequestTimeOut = 120.f; //seonds
 S32      LLCurl::sMaxHandles = 256; //max number of handles, (multi handles and easy handles combined).
+S32      LLCurl::sMaxHostConnections = 0;
+CURLSH*  LLCurl::sCurlShare = NULL;
+LLMutex* LLCurl::sShareMutexp = NULL;
+LLCurl::resolved_host_map_t LLCurl::sResolvedHosts;
+LLMutex* LLCurl::sResolveMutexp = NULL;
+
+static const F64 RESOLVED_HOST_TTL = 300.0;		// seconds a prefetched address is used
+static const F64 RESOLVE_PENDING_TIMEOUT = 30.0;	// seconds before a lost lookup is retried
 
 void check_curl_code(CURLcode code)
 {
@@ -286,6 +301,7 @@ void LLCurl::Easy::releaseEasyHandle(CURL* handle)
 
 LLCurl::Easy::Easy()
 	: mHeaders(NULL),
+	  mResolve(NULL),
 	  mCurlEasyHandle(NULL)
 {
 	mErrorBuffer[0] = 0;
@@ -304,9 +320,18 @@ LLCurl::Easy* LLCurl::Easy::getEasy()
 		return NULL;
 	}
 	
-	// set no DNS caching as default for all easy handles. This prevents them adopting a
-	// multi handles cache if they are added to one.
-	CURLcode result = curl_easy_setopt(easy->mCurlEasyHandle, CURLOPT_DNS_CACHE_TIMEOUT, 0);
+	CURLcode result;
+	if (LLCurl::sCurlShare)
+	{
+		// use the shared DNS and SSL session caches, curl_easy_reset() clears this
+		result = curl_easy_setopt(easy->mCurlEasyHandle, CURLOPT_SHARE, LLCurl::sCurlShare);
+	}
+	else
+	{
+		// set no DNS caching as default for all easy handles. This prevents them adopting a
+		// multi handles cache if they are added to one.
+		result = curl_easy_setopt(easy->mCurlEasyHandle, CURLOPT_DNS_CACHE_TIMEOUT, 0);
+	}
 	check_curl_code(result);
 	
 	++gCurlEasyCount;
@@ -318,6 +343,7 @@ LLCurl::Easy::~Easy()
 	releaseEasyHandle(mCurlEasyHandle);
 	--gCurlEasyCount;
 	curl_slist_free_all(mHeaders);
+	curl_slist_free_all(mResolve);
 	for_each(mStrings.begin(), mStrings.end(), DeletePointerArray());
 
 	if (mResponder && LLCurl::sNotQuitting) //aborted
@@ -333,12 +359,24 @@ void LLCurl::Easy::resetState()
 {
  	curl_easy_reset(mCurlEasyHandle);
 
+	// the reset dropped the shared DNS and SSL session caches
+	if (LLCurl::sCurlShare)
+	{
+		check_curl_code(curl_easy_setopt(mCurlEasyHandle, CURLOPT_SHARE, LLCurl::sCurlShare));
+	}
+
 	if (mHeaders)
 	{
 		curl_slist_free_all(mHeaders);
 		mHeaders = NULL;
 	}
 
+	if (mResolve)
+	{
+		curl_slist_free_all(mResolve);
+		mResolve = NULL;
+	}
+
 	mRequest.str("");
 	mRequest.clear();
 
@@ -353,6 +391,19 @@ void LLCurl::Easy::resetState()
 	mHeaderOutput.clear();
 }
 
+void LLCurl::Easy::useResolvedHost(const std::string& url)
+{
+#if LIBCURL_VERSION_NUM >= 0x071503
+	std::string entry;
+	if (LLCurl::getResolveEntry(url, entry))
+	{
+		curl_slist_free_all(mResolve);
+		mResolve = curl_slist_append(NULL, entry.c_str());
+		check_curl_code(curl_easy_setopt(mCurlEasyHandle, CURLOPT_RESOLVE, mResolve));
+	}
+#endif
+}
+
 void LLCurl::Easy::setErrorBuffer()
 {
 	setopt(CURLOPT_ERRORBUFFER, &mErrorBuffer);
@@ -526,6 +577,7 @@ void LLCurl::Easy::prepRequest(const std::string& url,
 	setopt(CURLOPT_TIMEOUT, llmax(time_out, CURL_REQUEST_TIMEOUT));
 
 	setoptString(CURLOPT_URL, url);
+	useResolvedHost(url);
 
 	mResponder = responder;
 
@@ -571,6 +623,14 @@ LLCurl::Multi::Multi(F32 idle_time_out)
 	}
 	LLCurl::getCurlThread()->addMulti(this) ;
 
+#if LIBCURL_VERSION_NUM >= 0x071e00
+		if (LLCurl::getMaxHostConnections() > 0)
+		{
+			check_curl_multi_code(curl_multi_setopt(mCurlMultiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, 
+													(long)LLCurl::getMaxHostConnections()));
+		}
+#endif
+
 		mIdleTimeOut = idle_time_out ;
 		if(mIdleTimeOut < LLCurl::sCurlRequestTimeOut)
 		{
@@ -737,6 +797,16 @@ bool LLCurl::Multi::doPerform()
 			}
 		}
 
+		if (mMutexp && q > 0 && q == mQueued)
+		{
+			// Nothing finished. Sleep on the sockets briefly instead of handing back
+			// empty-handed, so a reply arriving now is seen this frame, not the next.
+			waitForSockets();
+
+			LLMutexLock lock(mMutexp) ;
+			check_curl_multi_code(curl_multi_perform(mCurlMultiHandle, &q));
+		}
+
 		mQueued = q;	
 		setState(STATE_COMPLETED) ;
 		mIdleTimer.reset() ;
@@ -749,6 +819,62 @@ bool LLCurl::Multi::doPerform()
 	return dead ;
 }
 
+//only called from the curl thread, never with mMutexp held
+void LLCurl::Multi::waitForSockets()
+{
+	fd_set read_fds;
+	fd_set write_fds;
+	fd_set exc_fds;
+	FD_ZERO(&read_fds);
+	FD_ZERO(&write_fds);
+	FD_ZERO(&exc_fds);
+
+	int max_fd = -1;
+	long timeout_ms = -1;
+	{
+		LLMutexLock lock(mMutexp) ;
+		if (curl_multi_fdset(mCurlMultiHandle, &read_fds, &write_fds, &exc_fds, &max_fd) != CURLM_OK)
+		{
+			return;
+		}
+		curl_multi_timeout(mCurlMultiHandle, &timeout_ms);
+	}
+
+	if (max_fd < 0)
+	{
+		// no sockets yet (resolving or between retries), nothing to wait on
+		return;
+	}
+
+	if (timeout_ms < 0 || timeout_ms > MULTI_SOCKET_WAIT_MS)
+	{
+		timeout_ms = MULTI_SOCKET_WAIT_MS;
+	}
+	if (timeout_ms == 0)
+	{
+		return;
+	}
+
+	struct timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = timeout_ms * 1000;
+	select(max_fd + 1, &read_fds, &write_fds, &exc_fds, &timeout);
+}
+
+void LLCurl::Multi::setConnectionPolicy(S32 max_connects, bool pipelining)
+{
+	if (!mCurlMultiHandle)
+	{
+		return;
+	}
+
+	if (max_connects > 0)
+	{
+		check_curl_multi_code(curl_multi_setopt(mCurlMultiHandle, CURLMOPT_MAXCONNECTS, (long)max_connects));
+	}
+	check_curl_multi_code(curl_multi_setopt(mCurlMultiHandle, CURLMOPT_PIPELINING, pipelining ? 1L : 0L));
+}
+
 S32 LLCurl::Multi::process()
 {
 	if(!isValid())
@@ -1008,7 +1134,9 @@ std::string LLCurl::strerror(CURLcode errorcode)
 
 LLCurlRequest::LLCurlRequest() :
 	mActiveMulti(NULL),
-	mActiveRequestCount(0)
+	mActiveRequestCount(0),
+	mMaxConnects(0),
+	mPipelining(false)
 {
 	mProcessing = FALSE;
 }
@@ -1034,11 +1162,26 @@ void LLCurlRequest::addMulti()
 		return;
 	}
 	
+	if (mMaxConnects > 0 || mPipelining)
+	{
+		multi->setConnectionPolicy(mMaxConnects, mPipelining);
+	}
+
 	mMultiSet.insert(multi);
 	mActiveMulti = multi;
 	mActiveRequestCount = 0;
 }
 
+void LLCurlRequest::setConnectionPolicy(S32 max_connects, bool pipelining)
+{
+	mMaxConnects = max_connects;
+	mPipelining = pipelining;
+	if (mActiveMulti)
+	{
+		mActiveMulti->setConnectionPolicy(mMaxConnects, mPipelining);
+	}
+}
+
 LLCurl::Easy* LLCurlRequest::allocEasy()
 {
 	if (!mActiveMulti ||
@@ -1330,6 +1473,7 @@ void LLCurlEasyRequest::sendRequest(const std::string& url)
 	{
 		mEasy->setHeaders();
 		mEasy->setoptString(CURLOPT_URL, url);
+		mEasy->useResolvedHost(url);
 		mMulti->addEasy(mEasy);
 	}
 }
@@ -1468,6 +1612,177 @@ void LLCurl::initClass(F32 curl_reuest_timeout, S32 max_number_handles, bool mul
 	{
 		sHandleMutexp = new LLMutex(NULL) ;
 		Easy::sHandleMutexp = new LLMutex(NULL) ;
+		sShareMutexp = new LLMutex(NULL) ;
+	}
+
+	sResolveMutexp = new LLMutex(NULL) ;
+
+	sCurlShare = curl_share_init();
+	if (sCurlShare)
+	{
+		curl_share_setopt(sCurlShare, CURLSHOPT_LOCKFUNC, &LLCurl::share_lock);
+		curl_share_setopt(sCurlShare, CURLSHOPT_UNLOCKFUNC, &LLCurl::share_unlock);
+		curl_share_setopt(sCurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		curl_share_setopt(sCurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+		// open connections too, so they outlive the multi handle that made them
+		curl_share_setopt(sCurlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+	}
+	else
+	{
+		llwarns << "curl_share_init failed, DNS and SSL sessions won't be shared." << llendl;
+	}
+}
+
+namespace
+{
+	class LLCurlPrefetchResponder : public LLAres::HostResponder
+	{
+	public:
+		LLCurlPrefetchResponder(const std::string& host_port)
+			: mHostPort(host_port)
+		{
+		}
+
+		/*virtual*/ void hostResult(const hostent* ent)
+		{
+			if (ent && ent->h_addrtype == AF_INET && ent->h_addr_list[0])
+			{
+				LLCurl::addResolvedHost(mHostPort, inet_ntoa(*(struct in_addr*)ent->h_addr_list[0]));
+			}
+			else
+			{
+				LLCurl::removeResolvedHost(mHostPort);
+			}
+		}
+
+		/*virtual*/ void hostError(int code)
+		{
+			lldebugs << "Prefetch of " << mHostPort << " failed: " << code << llendl;
+			LLCurl::removeResolvedHost(mHostPort);
+		}
+
+	private:
+		std::string mHostPort;
+	};
+
+	// "host:port" for url, or empty if there's nothing worth resolving
+	std::string resolve_key(const std::string& url, std::string& host)
+	{
+		LLURI uri(url);
+		host = uri.hostName();
+		if (host.empty() || host.find_first_not_of("0123456789.") == std::string::npos)
+		{
+			return std::string();
+		}
+		return llformat("%s:%d", host.c_str(), (S32)uri.hostPort());
+	}
+}
+
+//static
+void LLCurl::prefetchHost(const std::string& url)
+{
+	if (!gAres || !gAres->isInitialized())
+	{
+		return;
+	}
+
+	std::string host;
+	std::string key = resolve_key(url, host);
+	if (key.empty())
+	{
+		return;
+	}
+
+	F64 now = LLTimer::getTotalSeconds();
+	{
+		LLMutexLock lock(sResolveMutexp);
+		resolved_host_map_t::iterator iter = sResolvedHosts.find(key);
+		if (iter != sResolvedHosts.end() && iter->second.mExpires > now)
+		{
+			// resolved and fresh, or already being looked up
+			return;
+		}
+
+		ResolvedHost& entry = sResolvedHosts[key];
+		entry.mAddress.clear();
+		entry.mExpires = now + RESOLVE_PENDING_TIMEOUT;
+	}
+
+	gAres->getHostByName(host, new LLCurlPrefetchResponder(key));
+}
+
+//static
+void LLCurl::addResolvedHost(const std::string& host_port, const std::string& address)
+{
+	LLMutexLock lock(sResolveMutexp);
+	ResolvedHost& entry = sResolvedHosts[host_port];
+	entry.mAddress = address;
+	entry.mExpires = LLTimer::getTotalSeconds() + RESOLVED_HOST_TTL;
+}
+
+//static
+void LLCurl::removeResolvedHost(const std::string& host_port)
+{
+	LLMutexLock lock(sResolveMutexp);
+	sResolvedHosts.erase(host_port);
+}
+
+//static
+bool LLCurl::getResolveEntry(const std::string& url, std::string& entry)
+{
+	{
+		LLMutexLock lock(sResolveMutexp);
+		if (sResolvedHosts.empty())
+		{
+			return false;
+		}
+	}
+
+	std::string host;
+	std::string key = resolve_key(url, host);
+	if (key.empty())
+	{
+		return false;
+	}
+
+	LLMutexLock lock(sResolveMutexp);
+	resolved_host_map_t::iterator iter = sResolvedHosts.find(key);
+	if (iter == sResolvedHosts.end() || iter->second.mAddress.empty())
+	{
+		return false;
+	}
+
+	if (iter->second.mExpires < LLTimer::getTotalSeconds())
+	{
+		// CURLOPT_RESOLVE entries never age out of curl's cache, so take it
+		// back out and let curl's own lookup handle the host until the next
+		// prefetch
+		entry = "-" + key;
+		sResolvedHosts.erase(iter);
+		return true;
+	}
+
+	entry = key + ":" + iter->second.mAddress;
+	return true;
+}
+
+//static
+void LLCurl::share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+	if (sShareMutexp)
+	{
+		sShareMutexp->lock();
+	}
+}
+
+//static
+void LLCurl::share_unlock(CURL* handle, curl_lock_data data, void* userptr)
+{
+	if (sShareMutexp)
+	{
+		sShareMutexp->unlock();
 	}
 }
 
@@ -1500,6 +1815,19 @@ void LLCurl::cleanupClass()
 
 	Easy::sFreeHandles.clear();
 
+	// only safe once no easy handle refers to it
+	if (sCurlShare)
+	{
+		curl_share_cleanup(sCurlShare);
+		sCurlShare = NULL;
+	}
+	delete sShareMutexp ;
+	sShareMutexp = NULL ;
+
+	delete sResolveMutexp ;
+	sResolveMutexp = NULL ;
+	sResolvedHosts.clear();
+
 	delete Easy::sHandleMutexp ;
 	Easy::sHandleMutexp = NULL ;
 
@@ -31,6 +31,7 @@
 
 #include "linden_common.h"
 
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -126,6 +127,14 @@ public:
 				return false;
 			}
 
+			// Return true to have an LLSD body parsed as it downloads instead of
+			// buffered whole and parsed at the end. completedRaw() is then
+			// skipped and completed() gets the content directly.
+			virtual bool parseWhileReceiving() const
+			{
+				return false;
+			}
+
 	public: /* but not really -- don't touch this */
 		U32 mReferenceCount;
 
@@ -184,6 +193,19 @@ public:
 
 	static LLCurlThread* getCurlThread() { return sCurlThread ;}
 
+	// Starts resolving url's host in the background. Requests to it over the
+	// next few minutes then go straight to the address and skip the lookup.
+	static void prefetchHost(const std::string& url);
+	// Records a finished prefetch, host_port is "host:port"
+	static void addResolvedHost(const std::string& host_port, const std::string& address);
+	static void removeResolvedHost(const std::string& host_port);
+	// CURLOPT_RESOLVE entry for url's host, false if there is nothing to apply
+	static bool getResolveEntry(const std::string& url, std::string& entry);
+
+	// Per host connection limit for multi handles created from now on, 0 for none
+	static void setMaxHostConnections(S32 max_connections) { sMaxHostConnections = max_connections; }
+	static S32 getMaxHostConnections() { return sMaxHostConnections; }
+
 	static CURLM* newMultiHandle() ;
 	static CURLMcode deleteMultiHandle(CURLM* handle) ;
 	static CURL*  newEasyHandle() ;
@@ -198,6 +220,23 @@ private:
 	static LLMutex* sHandleMutexp ;
 	static S32      sTotalHandles ;
 	static S32      sMaxHandles;
+	static S32      sMaxHostConnections;
+
+	// DNS results and TLS sessions shared by every easy handle, so a new
+	// request to a cap host doesn't repeat the lookup and full handshake
+	static CURLSH*  sCurlShare;
+	static LLMutex* sShareMutexp;
+	static void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+	static void share_unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+	struct ResolvedHost
+	{
+		std::string mAddress;	// empty while the lookup is in flight
+		F64 mExpires;
+	};
+	typedef std::map<std::string, ResolvedHost> resolved_host_map_t;
+	static resolved_host_map_t sResolvedHosts;
+	static LLMutex* sResolveMutexp;
 public:
 	static bool     sNotQuitting;
 	static F32      sCurlRequestTimeOut;	
@@ -243,6 +282,9 @@ public:
 
 	void resetState();
 
+	// Points curl at a prefetched address for url's host, if there is one
+	void useResolvedHost(const std::string& url);
+
 	static CURL* allocEasyHandle();
 	static void releaseEasyHandle(CURL* handle);
 
@@ -252,6 +294,7 @@ private:
 
 	CURL*				mCurlEasyHandle;
 	struct curl_slist*	mHeaders;
+	struct curl_slist*	mResolve;
 
 	std::stringstream	mRequest;
 	LLChannelDescriptors mChannels;
@@ -281,6 +324,8 @@ private:
 
 	void markDead() ;
 	bool doPerform();
+	// Blocks until one of the transfers' sockets is ready or a few ms pass
+	void waitForSockets();
 
 public:
 
@@ -309,6 +354,10 @@ public:
 
 	bool waitToComplete() ;
 
+	// Size of the keep-alive connection cache and whether requests to the
+	// same host may be pipelined on one connection.
+	void setConnectionPolicy(S32 max_connects, bool pipelining);
+
 	S32 process();
 	
 	CURLMsg* info_read(S32* msgs_in_queue);
@@ -400,6 +449,10 @@ public:
 	S32  process();
 	S32  getQueued();
 
+	// Applied to every multi handle this request creates, so connections
+	// to a host stay open for reuse by subsequent requests.
+	void setConnectionPolicy(S32 max_connects, bool pipelining);
+
 private:
 	void addMulti();
 	LLCurl::Easy* allocEasy();
@@ -411,6 +464,8 @@ private:
 	LLCurl::Multi* mActiveMulti;
 	S32 mActiveRequestCount;
 	BOOL mProcessing;
+	S32 mMaxConnects;
+	bool mPipelining;
 };
 
 class LLCurlEasyRequest
@@ -53,9 +53,10 @@ namespace
 	class LLHTTPClientURLAdaptor : public LLURLRequestComplete
 	{
 	public:
-		LLHTTPClientURLAdaptor(LLCurl::ResponderPtr responder)
+		LLHTTPClientURLAdaptor(LLCurl::ResponderPtr responder, LLSDXMLParser* stream_parser = NULL)
 			: LLURLRequestComplete(), mResponder(responder), mStatus(499),
-			  mReason("LLURLRequest complete w/no status")
+			  mReason("LLURLRequest complete w/no status"),
+			  mStreamParser(stream_parser)
 		{
 		}
 		
@@ -79,7 +80,20 @@ namespace
 				// Allow clients to parse headers before we attempt to parse
 				// the body and provide completed/result/error calls.
 				mResponder->completedHeader(mStatus, mReason, mHeaderOutput);
-				mResponder->completedRaw(mStatus, mReason, channels, buffer);
+				if (mStreamParser.notNull())
+				{
+					// the body went to the parser as it arrived
+					LLSD content;
+					if (mStreamParser->finishChunks(content) == LLSDParser::PARSE_FAILURE)
+					{
+						llinfos << "Failed to deserialize streamed LLSD [" << mStatus << "]: " << mReason << llendl;
+					}
+					mResponder->completed(mStatus, mReason, content);
+				}
+				else
+				{
+					mResponder->completedRaw(mStatus, mReason, channels, buffer);
+				}
 			}
 		}
 		virtual void header(const std::string& header, const std::string& value)
@@ -92,6 +106,7 @@ namespace
 		U32 mStatus;
 		std::string mReason;
 		LLSD mHeaderOutput;
+		LLPointer<LLSDXMLParser> mStreamParser;
 	};
 	
 	class Injector : public LLIOPipe
@@ -293,7 +308,13 @@ static void request(
 		responder->setURL(url);
 	}
 
-	req->setCallback(new LLHTTPClientURLAdaptor(responder));
+	LLSDXMLParser* stream_parser = NULL;
+	if (responder && responder->parseWhileReceiving())
+	{
+		stream_parser = new LLSDXMLParser();
+		req->setStreamParser(stream_parser);
+	}
+	req->setCallback(new LLHTTPClientURLAdaptor(responder, stream_parser));
 
 	if (method == LLURLRequest::HTTP_POST  &&  gMessageSystem)
 	{
@@ -45,12 +45,66 @@ void LLMsgVarData::addData(const void *data, S32 size, EMsgVariableType type, S3
 	}
 	if(size)
 	{
-		delete[] mData; // Delete it if it already exists
-		mData = new U8[size];
+		deleteData(); // Delete it if it already exists
+		if (size <= INLINE_DATA_SIZE)
+		{
+			mData = mInlineData;
+		}
+		else
+		{
+			mData = new U8[size];
+			mOwnsData = TRUE;
+		}
 		htonmemcpy(mData, data, mType, size);
 	}
 }
 
+void LLMsgVarData::addDataRef(const void *data, S32 size, S32 data_size)
+{
+#if LL_BIG_ENDIAN
+	addData(data, size, mType, data_size);
+#else
+	// wire order is little endian, htonmemcpy would be a plain copy
+	deleteData();
+	mSize = size;
+	mDataSize = data_size;
+	if (size)
+	{
+		mData = (U8 *)data;
+	}
+#endif
+}
+
+//static
+void* LLMsgBlkData::sFreeList = NULL;
+
+//static
+void* LLMsgBlkData::operator new(size_t size)
+{
+	if (size != sizeof(LLMsgBlkData) || !sFreeList)
+	{
+		return ::operator new(size);
+	}
+
+	void* ptr = sFreeList;
+	sFreeList = *(void**) ptr;
+	return ptr;
+}
+
+//static
+void LLMsgBlkData::operator delete(void* ptr, size_t size)
+{
+	if (size != sizeof(LLMsgBlkData))
+	{
+		::operator delete(ptr);
+	}
+	else if (ptr)
+	{
+		*(void**) ptr = sFreeList;
+		sFreeList = ptr;
+	}
+}
+
 void LLMsgData::addDataFast(char *blockname, char *varname, const void *data, S32 size, EMsgVariableType type, S32 data_size)
 {
 	// remember that if the blocknumber is > 0 then the number is appended to the name
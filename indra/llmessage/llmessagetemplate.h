@@ -35,28 +35,62 @@
 class LLMsgVarData
 {
 public:
-	LLMsgVarData() : mName(NULL), mSize(-1), mDataSize(-1), mData(NULL), mType(MVT_U8)
+	LLMsgVarData() : mName(NULL), mSize(-1), mDataSize(-1), mData(NULL), mOwnsData(FALSE), mType(MVT_U8)
 	{
 	}
 
-	LLMsgVarData(const char *name, EMsgVariableType type) : mSize(-1), mDataSize(-1), mData(NULL), mType(type)
+	LLMsgVarData(const char *name, EMsgVariableType type) : mSize(-1), mDataSize(-1), mData(NULL), mOwnsData(FALSE), mType(type)
 	{
 		mName = (char *)name; 
 	}
 
+	LLMsgVarData(const LLMsgVarData& rhs)
+	{
+		*this = rhs;
+	}
+
 	~LLMsgVarData() 
 	{
 		// copy constructor just copies the mData pointer, so only delete mData explicitly
 	}
+
+	// Heap data is shared with the copy, inline data is duplicated
+	LLMsgVarData& operator=(const LLMsgVarData& rhs)
+	{
+		mName = rhs.mName;
+		mSize = rhs.mSize;
+		mDataSize = rhs.mDataSize;
+		mOwnsData = rhs.mOwnsData;
+		mType = rhs.mType;
+		if (rhs.mData == rhs.mInlineData)
+		{
+			memcpy(mInlineData, rhs.mInlineData, sizeof(mInlineData));		/* Flawfinder: ignore */
+			mData = mInlineData;
+		}
+		else
+		{
+			mData = rhs.mData;
+		}
+		return *this;
+	}
 	
 	void deleteData() 
 	{
-		delete[] mData;
+		if (mOwnsData)
+		{
+			delete[] mData;
+		}
 		mData = NULL;
+		mOwnsData = FALSE;
 	}
 	
 	void addData(const void *indata, S32 size, EMsgVariableType type, S32 data_size = -1);
 
+	// Points at indata rather than copying it, so indata must outlive this
+	// variable. Used when decoding straight out of a receive buffer; falls
+	// back to a copy where the wire order needs swapping.
+	void addDataRef(const void *indata, S32 size, S32 data_size = -1);
+
 	char *getName() const	{ return mName; }
 	S32 getSize() const		{ return mSize; }
 	void *getData()			{ return (void*)mData; }
@@ -70,7 +104,12 @@ protected:
 	S32					mDataSize;
 
 	U8					*mData;
+	BOOL				mOwnsData;
 	EMsgVariableType	mType;
+
+	// Scalars, vectors, quaternions and UUIDs fit here without an allocation
+	enum { INLINE_DATA_SIZE = 16 };
+	U8					mInlineData[INLINE_DATA_SIZE];
 };
 
 class LLMsgBlkData
@@ -90,6 +129,11 @@ public:
 		}
 	}
 
+	// Every message built or decoded news and deletes its blocks, so freed
+	// blocks are kept on a free list for the next message.
+	void* operator new(size_t size);
+	void operator delete(void* ptr, size_t size);
+
 	void addVariable(const char *name, EMsgVariableType type)
 	{
 		LLMsgVarData tmp(name,type);
@@ -102,11 +146,20 @@ public:
 		temp->addData(data, size, type, data_size);
 	}
 
+	void addDataRef(char *name, const void *data, S32 size, S32 data_size = -1)
+	{
+		LLMsgVarData* temp = &mMemberVarData[name];
+		temp->addDataRef(data, size, data_size);
+	}
+
 	S32									mBlockNumber;
 	typedef LLDynamicArrayIndexed<LLMsgVarData, const char *, 8> msg_var_data_map_t;
 	msg_var_data_map_t					mMemberVarData;
 	char								*mName;
 	S32									mTotalSize;
+
+private:
+	static void*						sFreeList;
 };
 
 class LLMsgData
@@ -32,11 +32,13 @@
 	#include <winsock2.h>
 #else
 	#include <sys/socket.h>
+	#include <sys/select.h>
 	#include <netinet/in.h>
 #endif
 
 // linden library includes
 #include "llerror.h"
+#include "llthread.h"
 #include "lltimer.h"
 #include "llproxy.h"
 #include "llrand.h"
@@ -44,6 +46,121 @@
 #include "timing.h"
 #include "u64.h"
 
+///////////////////////////////////////////////////////////
+// Single producer, single consumer: the thread fills slots at mHead, the
+// main thread drains them at mTail, and mCount hands slots across.
+class LLPacketRing::ReceiveThread : public LLThread
+{
+public:
+	ReceiveThread(S32 socket);
+	~ReceiveThread();
+
+	// Returns the oldest received packet or NULL, main thread only
+	LLPacketBuffer* popPacket();
+
+	/*virtual*/ void run();
+
+private:
+	enum { RING_SIZE = 2048 };
+
+	S32 mSocket;
+	LLPacketBuffer* mRing[RING_SIZE];
+	U32 mHead;
+	U32 mTail;
+	LLAtomicU32 mCount;
+};
+
+LLPacketRing::ReceiveThread::ReceiveThread(S32 socket)
+:	LLThread("Packet Receive"),
+	mSocket(socket),
+	mHead(0),
+	mTail(0),
+	mCount(0)
+{
+	memset(mRing, 0, sizeof(mRing));
+}
+
+LLPacketRing::ReceiveThread::~ReceiveThread()
+{
+	shutdown();
+
+	LLPacketBuffer* packetp;
+	while ((packetp = popPacket()) != NULL)
+	{
+		delete packetp;
+	}
+}
+
+LLPacketBuffer* LLPacketRing::ReceiveThread::popPacket()
+{
+	if (mCount == 0)
+	{
+		return NULL;
+	}
+
+	LLPacketBuffer* packetp = mRing[mTail];
+	mRing[mTail] = NULL;
+	mTail = (mTail + 1) % RING_SIZE;
+	mCount--;
+	return packetp;
+}
+
+//virtual
+void LLPacketRing::ReceiveThread::run()
+{
+	LLPacketBuffer* packetp = NULL;
+
+	while (!isQuitting())
+	{
+		if (mCount >= RING_SIZE)
+		{
+			// main thread is behind, leave the rest in the socket buffer
+			ms_sleep(1);
+			continue;
+		}
+
+		fd_set read_fds;
+		FD_ZERO(&read_fds);
+		FD_SET(mSocket, &read_fds);
+		struct timeval timeout;
+		timeout.tv_sec = 0;
+		timeout.tv_usec = 10000;	// wake up regularly to check for shutdown
+		if (select(mSocket + 1, &read_fds, NULL, NULL, &timeout) <= 0)
+		{
+			continue;
+		}
+
+		while (mCount < RING_SIZE)
+		{
+			if (packetp)
+			{
+				packetp->init(mSocket);
+			}
+			else
+			{
+				packetp = new LLPacketBuffer(mSocket);
+			}
+
+			if (!packetp->getSize())
+			{
+				break;
+			}
+
+			mRing[mHead] = packetp;
+			mHead = (mHead + 1) % RING_SIZE;
+			packetp = NULL;
+			mCount++;
+		}
+	}
+
+	delete packetp;
+}
+
+// Depth of the outbound token bucket. Kept to a few milliseconds so a
+// backlog drains as a steady stream of packets instead of a burst that
+// overruns small router queues.
+const F32 OUT_THROTTLE_BURST_SECS = 0.005f;
+
 ///////////////////////////////////////////////////////////
 LLPacketRing::LLPacketRing () :
 	mUseInThrottle(FALSE),
@@ -56,8 +173,10 @@ LLPacketRing::LLPacketRing () :
 	mInBufferLength(0),
 	mOutBufferLength(0),
 	mDropPercentage(0.0f),
-	mPacketsToDrop(0x0)
+	mPacketsToDrop(0x0),
+	mReceiveThread(NULL)
 {
+	mOutThrottle.setLookahead(OUT_THROTTLE_BURST_SECS);
 }
 
 ///////////////////////////////////////////////////////////
@@ -69,6 +188,8 @@ LLPacketRing::~LLPacketRing ()
 ///////////////////////////////////////////////////////////
 void LLPacketRing::cleanup ()
 {
+	stopReceiveThread();
+
 	LLPacketBuffer *packetp;
 
 	while (!mReceiveQueue.empty())
@@ -86,6 +207,76 @@ void LLPacketRing::cleanup ()
 	}
 }
 
+///////////////////////////////////////////////////////////
+void LLPacketRing::startReceiveThread(S32 socket)
+{
+	if (!mReceiveThread)
+	{
+		llinfos << "Starting packet receive thread" << llendl;
+		mReceiveThread = new ReceiveThread(socket);
+		mReceiveThread->start();
+	}
+}
+
+void LLPacketRing::stopReceiveThread()
+{
+	delete mReceiveThread;
+	mReceiveThread = NULL;
+}
+
+LLPacketBuffer* LLPacketRing::readPacket(S32 socket)
+{
+	if (!mReceiveThread)
+	{
+		return new LLPacketBuffer(socket);
+	}
+
+	LLPacketBuffer* packetp = mReceiveThread->popPacket();
+	if (!packetp)
+	{
+		packetp = new LLPacketBuffer(LLHost(), NULL, 0);
+	}
+	return packetp;
+}
+
+S32 LLPacketRing::receiveFromThread(char *datap)
+{
+	LLPacketBuffer* packetp = mReceiveThread->popPacket();
+	if (!packetp)
+	{
+		return 0;
+	}
+
+	S32 packet_size = packetp->getSize();
+	mLastSender = packetp->getHost();
+	mLastReceivingIF = packetp->getReceivingInterface();
+
+	if (LLProxy::isSOCKSProxyEnabled())
+	{
+		if (packet_size > SOCKS_HEADER_SIZE)
+		{
+			// *FIX We are assuming ATYP is 0x01 (IPv4), not 0x03 (hostname) or 0x04 (IPv6)
+			memcpy(datap, packetp->getData() + SOCKS_HEADER_SIZE, packet_size - SOCKS_HEADER_SIZE);
+			const proxywrap_t * header = static_cast<const proxywrap_t*>(static_cast<const void*>(packetp->getData()));
+			mLastSender.setAddress(header->addr);
+			mLastSender.setPort(ntohs(header->port));
+
+			packet_size -= SOCKS_HEADER_SIZE; // The unwrapped packet size
+		}
+		else
+		{
+			packet_size = 0;
+		}
+	}
+	else
+	{
+		memcpy(datap, packetp->getData(), packet_size);	/*Flawfinder: ignore*/
+	}
+
+	delete packetp;
+	return packet_size;
+}
+
 ///////////////////////////////////////////////////////////
 void LLPacketRing::dropPackets (U32 num_to_drop)
 {
@@ -167,8 +358,7 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 		// push any current net packet (if any) onto delay ring
 		while (!done)
 		{
-			LLPacketBuffer *packetp;
-			packetp = new LLPacketBuffer(socket);
+			LLPacketBuffer *packetp = readPacket(socket);
 
 			if (packetp->getSize())
 			{
@@ -225,7 +415,11 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 	else
 	{
 		// no delay, pull straight from net
-		if (LLProxy::isSOCKSProxyEnabled())
+		if (mReceiveThread)
+		{
+			packet_size = receiveFromThread(datap);
+		}
+		else if (LLProxy::isSOCKSProxyEnabled())
 		{
 			U8 buffer[NET_BUFFER_SIZE + SOCKS_HEADER_SIZE];
 			packet_size = receive_packet(socket, static_cast<char*>(static_cast<void*>(buffer)));
@@ -251,7 +445,10 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 			mLastSender = ::get_sender();
 		}
 
-		mLastReceivingIF = ::get_receiving_interface();
+		if (!mReceiveThread)
+		{
+			mLastReceivingIF = ::get_receiving_interface();
+		}
 
 		if (packet_size)  // did we actually get a packet?
 		{
@@ -282,41 +479,18 @@ BOOL LLPacketRing::sendPacket(int h_socket, char * send_buffer, S32 buf_size, LL
 	{
 		mActualBitsOut += buf_size * 8;
 		LLPacketBuffer *packetp = NULL;
-		// See if we've got enough throttle to send a packet.
-		while (!mOutThrottle.checkOverflow(0.f))
-		{
-			// While we have enough bandwidth, send a packet from the queue or the current packet
 
-			S32 packet_size = 0;
-			if (!mSendQueue.empty())
-			{
-				// Send a packet off of the queue
-				LLPacketBuffer *packetp = mSendQueue.front();
-				mSendQueue.pop();
-
-				mOutBufferLength -= packetp->getSize();
-				packet_size = packetp->getSize();
-
-				status = sendPacketImpl(h_socket, packetp->getData(), packet_size, packetp->getHost());
-				
-				delete packetp;
-				// Update the throttle
-				mOutThrottle.throttleOverflow(packet_size * 8.f);
-			}
-			else
-			{
-				// If the queue's empty, we can just send this packet right away.
-				status =  sendPacketImpl(h_socket, send_buffer, buf_size, host );
-				packet_size = buf_size;
+		// Anything already waiting goes first
+		flushSendQueue(h_socket);
 
-				// Update the throttle
-				mOutThrottle.throttleOverflow(packet_size * 8.f);
-
-				// This was the packet we're sending now, there are no other packets
-				// that we need to send
-				return status;
-			}
+		if (mSendQueue.empty() && !mOutThrottle.checkOverflow(0.f))
+		{
+			// If the queue's empty, we can just send this packet right away.
+			status =  sendPacketImpl(h_socket, send_buffer, buf_size, host );
 
+			// Update the throttle
+			mOutThrottle.throttleOverflow(buf_size * 8.f);
+			return status;
 		}
 
 		// We haven't sent the incoming packet, add it to the queue
@@ -345,6 +519,25 @@ BOOL LLPacketRing::sendPacket(int h_socket, char * send_buffer, S32 buf_size, LL
 	return status;
 }
 
+void LLPacketRing::flushSendQueue(int h_socket)
+{
+	// While we have enough bandwidth, send packets off of the queue
+	while (!mSendQueue.empty() && !mOutThrottle.checkOverflow(0.f))
+	{
+		LLPacketBuffer *packetp = mSendQueue.front();
+		mSendQueue.pop();
+
+		S32 packet_size = packetp->getSize();
+		mOutBufferLength -= packet_size;
+
+		sendPacketImpl(h_socket, packetp->getData(), packet_size, packetp->getHost());
+		delete packetp;
+
+		// Update the throttle
+		mOutThrottle.throttleOverflow(packet_size * 8.f);
+	}
+}
+
 BOOL LLPacketRing::sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host)
 {
 	
@@ -53,7 +53,17 @@ public:
 	S32  receivePacket (S32 socket, char *datap);
 	S32  receiveFromRing (S32 socket, char *datap);
 
+	// Reads the socket on a worker thread from now on, so packets don't sit
+	// in the kernel buffer (and get dropped) while the main thread is busy
+	// with a frame. Decoding and dispatch stay on the caller's thread.
+	void startReceiveThread(S32 socket);
+	void stopReceiveThread();
+	BOOL hasReceiveThread() const				{ return mReceiveThread != NULL; }
+
 	BOOL sendPacket(int h_socket, char * send_buffer, S32 buf_size, LLHost host);
+	// Sends whatever the out throttle allows from the send queue. Called once
+	// a frame so queued packets go out evenly rather than behind the next send.
+	void flushSendQueue(int h_socket);
 
 	inline LLHost getLastSender();
 	inline LLHost getLastReceivingInterface();
@@ -84,7 +94,15 @@ protected:
 	LLHost mLastReceivingIF;
 
 private:
+	class ReceiveThread;
+
 	BOOL sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
+
+	// Next packet off the socket or the receive thread, size 0 if none
+	LLPacketBuffer* readPacket(S32 socket);
+	S32 receiveFromThread(char *datap);
+
+	ReceiveThread* mReceiveThread;
 };
 
 
@@ -43,7 +43,8 @@ LLTemplateMessageReader::LLTemplateMessageReader(message_template_number_map_t&
 	mReceiveSize(0),
 	mCurrentRMessageTemplate(NULL),
 	mCurrentRMessageData(NULL),
-	mMessageNumbers(number_template_map)
+	mMessageNumbers(number_template_map),
+	mCurrentDispatch(NULL)
 {
 }
 
@@ -52,6 +53,16 @@ LLTemplateMessageReader::~LLTemplateMessageReader()
 {
 	delete mCurrentRMessageData;
 	mCurrentRMessageData = NULL;
+
+	for (U32 i = 0; i < 256; ++i)
+	{
+		delete mHighDispatch[i].mTimer;
+		delete mMediumDispatch[i].mTimer;
+	}
+	for (dispatch_map_t::iterator iter = mLowDispatch.begin(); iter != mLowDispatch.end(); ++iter)
+	{
+		delete iter->second.mTimer;
+	}
 }
 
 //virtual
@@ -59,6 +70,7 @@ void LLTemplateMessageReader::clearMessage()
 {
 	mReceiveSize = -1;
 	mCurrentRMessageTemplate = NULL;
+	mCurrentDispatch = NULL;
 	delete mCurrentRMessageData;
 	mCurrentRMessageData = NULL;
 }
@@ -440,6 +452,46 @@ S32 LLTemplateMessageReader::getMessageSize() const
 	return mReceiveSize;
 }
 
+LLTemplateMessageReader::DispatchEntry* LLTemplateMessageReader::findDispatchEntry(U32 num)
+{
+	DispatchEntry* entry = NULL;
+	if (num < 256)
+	{
+		entry = &mHighDispatch[num];
+	}
+	else if ((num & 0xFFFFFF00) == (255 << 8))
+	{
+		entry = &mMediumDispatch[num & 0xFF];
+	}
+	else
+	{
+		dispatch_map_t::iterator iter = mLowDispatch.find(num);
+		if (iter != mLowDispatch.end())
+		{
+			return &iter->second;
+		}
+
+		LLMessageTemplate* temp = get_ptr_in_map(mMessageNumbers, num);
+		if (!temp)
+		{
+			return NULL;
+		}
+		entry = &mLowDispatch[num];
+		entry->mTemplate = temp;
+		return entry;
+	}
+
+	if (!entry->mTemplate)
+	{
+		entry->mTemplate = get_ptr_in_map(mMessageNumbers, num);
+		if (!entry->mTemplate)
+		{
+			return NULL;
+		}
+	}
+	return entry;
+}
+
 // Returns template for the message contained in buffer
 BOOL LLTemplateMessageReader::decodeTemplate(  
 		const U8* buffer, S32 buffer_size,  // inputs
@@ -490,10 +542,10 @@ BOOL LLTemplateMessageReader::decodeTemplate(
 		return(FALSE);
 	}
 
-	LLMessageTemplate* temp = get_ptr_in_map(mMessageNumbers,num);
-	if (temp)
+	mCurrentDispatch = findDispatchEntry(num);
+	if (mCurrentDispatch)
 	{
-		*msg_template = temp;
+		*msg_template = mCurrentDispatch->mTemplate;
 	}
 	else
 	{
@@ -535,6 +587,14 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 	llassert( !mCurrentRMessageData );
 	delete mCurrentRMessageData; // just to make sure
 
+	// one copy of the whole packet instead of one allocation per variable,
+	// the capacity sticks around so this doesn't allocate after the first few
+	if (mReceiveSize > 0)
+	{
+		mMessageBuffer.assign(buffer, buffer + mReceiveSize);
+		buffer = &mMessageBuffer[0];
+	}
+
 	// The offset tells us how may bytes to skip after the end of the
 	// message name.
 	U8 offset = buffer[PHL_OFFSET];
@@ -659,7 +719,7 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 					}
 					decode_pos += data_size;
 
-					cur_data_block->addData(mvci.getName(), &buffer[decode_pos], tsize, mvci.getType());
+					cur_data_block->addDataRef(mvci.getName(), &buffer[decode_pos], tsize);
 					decode_pos += tsize;
 				}
 				else
@@ -678,10 +738,9 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 					}
 					else
 					{
-						cur_data_block->addData(mvci.getName(), 
-												&buffer[decode_pos], 
-												mvci.getSize(), 
-												mvci.getType());
+						cur_data_block->addDataRef(mvci.getName(), 
+												   &buffer[decode_pos], 
+												   mvci.getSize());
 					}
 					decode_pos += mvci.getSize();
 				}
@@ -706,6 +765,15 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 
 		{
 			LLFastTimer t(FTM_PROCESS_MESSAGES);
+
+			// Every message type gets its own timer under Process Messages,
+			// created the first time one arrives
+			if (!mCurrentDispatch->mTimer)
+			{
+				mCurrentDispatch->mTimer = new LLFastTimer::DeclareTimer(mCurrentRMessageTemplate->mName);
+			}
+			LLFastTimer handler_timer(*mCurrentDispatch->mTimer);
+
 			if( !mCurrentRMessageTemplate->callHandlerFunc(gMessageSystem) )
 			{
 				llwarns << "Message from " << sender << " with no handler function received: " << mCurrentRMessageTemplate->mName << llendl;
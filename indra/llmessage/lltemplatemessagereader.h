@@ -27,9 +27,12 @@
 #ifndef LL_LLTEMPLATEMESSAGEREADER_H
 #define LL_LLTEMPLATEMESSAGEREADER_H
 
+#include "llfasttimer.h"
 #include "llmessagereader.h"
 
 #include <map>
+#include <vector>
+#include <boost/unordered_map.hpp>
 
 class LLMessageTemplate;
 class LLMsgData;
@@ -118,7 +121,32 @@ private:
 
 	BOOL decodeData(const U8* buffer, const LLHost& sender );
 
+	// Template and handler timer for one message number, filled in from
+	// mMessageNumbers the first time that number is seen.
+	struct DispatchEntry
+	{
+		DispatchEntry() : mTemplate(NULL), mTimer(NULL) {}
+
+		LLMessageTemplate* mTemplate;
+		LLFastTimer::DeclareTimer* mTimer;
+	};
+
+	DispatchEntry* findDispatchEntry(U32 num);
+
 	S32	mReceiveSize;
+
+	// High and medium frequency numbers index straight into these by their
+	// last byte, low frequency ones are hashed.
+	DispatchEntry mHighDispatch[256];
+	DispatchEntry mMediumDispatch[256];
+	typedef boost::unordered_map<U32, DispatchEntry> dispatch_map_t;
+	dispatch_map_t mLowDispatch;
+	DispatchEntry* mCurrentDispatch;
+
+	// Private copy of the packet being decoded. Decoded variables point
+	// into it, so it lives exactly as long as mCurrentRMessageData.
+	std::vector<U8> mMessageBuffer;
+
 	LLMessageTemplate* mCurrentRMessageTemplate;
 	LLMsgData* mCurrentRMessageData;
 	message_template_number_map_t& mMessageNumbers;
@@ -41,6 +41,8 @@ public:
 	~LLThrottle() { }
 
 	void setRate(const F32 rate);
+	// How many seconds of rate may be sent back to back, i.e. the bucket depth
+	void setLookahead(const F32 secs)	{ mLookaheadSecs = secs; }
 	BOOL checkOverflow(const F32 amount); // I'm about to add an amount, TRUE if would overflow throttle
 	BOOL throttleOverflow(const F32 amount); // I just sent amount, TRUE if that overflowed the throttle
 
@@ -38,6 +38,7 @@
 #include "llproxy.h"
 #include "llpumpio.h"
 #include "llsd.h"
+#include "llsdserialize.h"
 #include "llstring.h"
 #include "apr_env.h"
 #include "llapr.h"
@@ -71,6 +72,7 @@ public:
 	S32 mByteAccumulator;
 	bool mIsBodyLimitSet;
 	LLURLRequest::SSLCertVerifyCallback mSSLVerifyCallback;
+	LLPointer<LLSDXMLParser> mStreamParser;
 };
 
 LLURLRequestDetail::LLURLRequestDetail() :
@@ -200,6 +202,11 @@ void LLURLRequest::setBodyLimit(U32 size)
 	mDetail->mIsBodyLimitSet = true;
 }
 
+void LLURLRequest::setStreamParser(LLSDXMLParser* parser)
+{
+	mDetail->mStreamParser = parser;
+}
+
 void LLURLRequest::setCallback(LLURLRequestComplete* callback)
 {
 	LLMemType m1(LLMemType::MTYPE_IO_URL_REQUEST);
@@ -586,10 +593,17 @@ size_t LLURLRequest::downCallback(
 		}
 	}
 
-	req->mDetail->mResponseBuffer->append(
-		req->mDetail->mChannels.out(),
-		(U8*)data,
-		bytes);
+	if (req->mDetail->mStreamParser.notNull())
+	{
+		req->mDetail->mStreamParser->parseChunk(data, bytes);
+	}
+	else
+	{
+		req->mDetail->mResponseBuffer->append(
+			req->mDetail->mChannels.out(),
+			(U8*)data,
+			bytes);
+	}
 	req->mResponseTransferedBytes += bytes;
 	req->mDetail->mByteAccumulator += bytes;
 	return bytes;
@@ -50,6 +50,7 @@ extern const std::string CONTEXT_TRANSFERED_BYTES;
 class LLURLRequestDetail;
 
 class LLURLRequestComplete;
+class LLSDXMLParser;
 
 /** 
  * @class LLURLRequest
@@ -163,6 +164,12 @@ public:
 	 */
 	void setBodyLimit(U32 size);
 
+	/** 
+	 * @brief Feed the response body to parser as it arrives rather than
+	 * building up the response buffer.
+	 */
+	void setStreamParser(LLSDXMLParser* parser);
+
 	/** 
 	 * @brief Set a completion callback for this URLRequest.
 	 *
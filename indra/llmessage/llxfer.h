@@ -31,8 +31,14 @@
 #include "lltimer.h"
 #include "llextendedstatus.h"
 
+#include <map>
+#include <vector>
+
 const S32 LL_XFER_LARGE_PAYLOAD = 7680;
 
+// How far past the expected packet a download keeps what it is sent
+const S32 LL_XFER_RECEIVE_WINDOW = 16;
+
 typedef enum ELLXferStatus {
 	e_LL_XFER_UNINITIALIZED,
 	e_LL_XFER_REGISTERED,         // a buffer which has been registered as available for a request
@@ -73,6 +79,15 @@ class LLXfer
 	LLTimer ACKTimer;
 	S32 mRetries;
 
+	// Packets that arrived ahead of mPacketNum, held until the gap is filled
+	struct LLFuturePacket
+	{
+		std::vector<char> mData;
+		BOOL mIsLast;
+	};
+	typedef std::map<S32, LLFuturePacket> future_packet_map_t;
+	future_packet_map_t mFuturePackets;
+
 	static const U32 XFER_FILE;
 	static const U32 XFER_VFILE;
 	static const U32 XFER_MEM;
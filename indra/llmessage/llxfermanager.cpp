@@ -626,11 +626,22 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
 
 	if (decodePacketNum(packetnum) != xferp->mPacketNum) // is the packet different from what we were expecting?
 	{
+		S32 ahead = decodePacketNum(packetnum) - xferp->mPacketNum;
+
 		// confirm it if it was a resend of the last one, since the confirmation might have gotten dropped
 		if (decodePacketNum(packetnum) == (xferp->mPacketNum - 1))
 		{
 			llinfos << "Reconfirming xfer " << xferp->mRemoteHost << ":" << xferp->getFileName() << " packet " << packetnum << llendl; 			sendConfirmPacket(mesgsys, id, decodePacketNum(packetnum), mesgsys->getSender());
 		}
+		else if (ahead > 0 && ahead < LL_XFER_RECEIVE_WINDOW && xferp->mPacketNum > 0)
+		{
+			// A sender with several packets in flight lost one. Keep and confirm
+			// this one so only the missing packet has to be resent.
+			LLXfer::LLFuturePacket& future = xferp->mFuturePackets[decodePacketNum(packetnum)];
+			future.mData.assign(fdata_buf, fdata_buf + fdata_size);
+			future.mIsLast = isLastPacket(packetnum);
+			confirmReceivedPacket(mesgsys, id, decodePacketNum(packetnum), mesgsys->getSender());
+		}
 		else
 		{
 			llinfos << "Ignoring xfer " << xferp->mRemoteHost << ":" << xferp->getFileName() << " recv'd packet " << packetnum << "; expecting " << xferp->mPacketNum << llendl;
@@ -665,27 +676,63 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
 
 	xferp->mPacketNum++;  // expect next packet
 
+	confirmReceivedPacket(mesgsys, id, decodePacketNum(packetnum), mesgsys->getSender());
+
+	BOOL last_packet = isLastPacket(packetnum);
+
+	// Deliver whatever was held waiting for this packet
+	LLXfer::future_packet_map_t::iterator future_iter;
+	while (!last_packet
+		   && (future_iter = xferp->mFuturePackets.find(xferp->mPacketNum)) != xferp->mFuturePackets.end())
+	{
+		std::vector<char>& data = future_iter->second.mData;
+		result = xferp->receiveData(data.empty() ? NULL : &data[0], (S32)data.size());
+		if (result == LL_ERR_CANNOT_OPEN_FILE)
+		{
+			xferp->abort(LL_ERR_CANNOT_OPEN_FILE);
+			removeXfer(xferp,&mReceiveList);
+			startPendingDownloads();
+			return;
+		}
+
+		last_packet = future_iter->second.mIsLast;
+		xferp->mFuturePackets.erase(future_iter);
+		xferp->mPacketNum++;
+	}
+
+	if (last_packet)
+	{
+		xferp->processEOF();
+		removeXfer(xferp,&mReceiveList);
+		startPendingDownloads();
+	}
+}
+
+///////////////////////////////////////////////////////////
+
+void LLXferManager::confirmReceivedPacket(LLMessageSystem *mesgsys, U64 id, S32 packetnum, const LLHost &remote_host)
+{
 	if (!mUseAckThrottling)
 	{
 		// No throttling, confirm right away
-		sendConfirmPacket(mesgsys, id, decodePacketNum(packetnum), mesgsys->getSender());
+		sendConfirmPacket(mesgsys, id, packetnum, remote_host);
+	}
+	else if (!mXferAckQueue.getLength() && !mAckThrottle.checkOverflow(1000.0f*8.0f))
+	{
+		// Nothing queued and room in the throttle. The sender is waiting on this
+		// confirm, so don't hold it until the next retransmitUnackedPackets().
+		sendConfirmPacket(mesgsys, id, packetnum, remote_host);
+		mAckThrottle.throttleOverflow(1000.f*8.f); // Assume 1000 bytes/packet
 	}
 	else
 	{
 		// Throttling, put on queue to be confirmed later.
 		LLXferAckInfo ack_info;
 		ack_info.mID = id;
-		ack_info.mPacketNum = decodePacketNum(packetnum);
-		ack_info.mRemoteHost = mesgsys->getSender();
+		ack_info.mPacketNum = packetnum;
+		ack_info.mRemoteHost = remote_host;
 		mXferAckQueue.push(ack_info);
 	}
-
-	if (isLastPacket(packetnum))
-	{
-		xferp->processEOF();
-		removeXfer(xferp,&mReceiveList);
-		startPendingDownloads();
-	}
 }
 
 ///////////////////////////////////////////////////////////
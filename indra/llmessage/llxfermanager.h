@@ -195,6 +195,8 @@ class LLXferManager
 
 	virtual void processReceiveData (LLMessageSystem *mesgsys, void **user_data);
 	virtual void sendConfirmPacket (LLMessageSystem *mesgsys, U64 id, S32 packetnum, const LLHost &remote_host);
+	// Confirms now or through the ack throttle queue
+	void confirmReceivedPacket(LLMessageSystem *mesgsys, U64 id, S32 packetnum, const LLHost &remote_host);
 
 // file sending routines
 	virtual void processFileRequest (LLMessageSystem *mesgsys, void **user_data);
@@ -205,6 +205,7 @@ void LLMessageSystem::init()
 	mNumberLowFreqMessages = 0;
 	mPacketsIn = mPacketsOut = 0;
 	mBytesIn = mBytesOut = 0;
+	mRecentMessageCount = 0;
 	mCompressedPacketsIn = mCompressedPacketsOut = 0;
 	mReliablePacketsIn = mReliablePacketsOut = 0;
 
@@ -365,6 +366,9 @@ LLMessageSystem::~LLMessageSystem()
 	for_each(mMessageNumbers.begin(), mMessageNumbers.end(), DeletePairedPointer());
 	mMessageNumbers.clear();
 	
+	// the receive thread must be done with the socket before it closes
+	mPacketRing.stopReceiveThread();
+
 	if (!mbError)
 	{
 		end_net(mSocket);
@@ -723,7 +727,12 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 			if( valid_packet )
 			{
 				logValidMsg(cdp, host, recv_reliable, recv_resent, (BOOL)(acks>0) );
+				U64 read_start = totalTime();
 				valid_packet = mTemplateMessageReader->readMessage(buffer, host);
+
+				RecentMessage& recent = mRecentMessages[mRecentMessageCount++ % RECENT_MESSAGE_COUNT];
+				recent.mName = mTemplateMessageReader->getMessageName();
+				recent.mHandlerMS = (F32)(totalTime() - read_start) / 1000.f;
 			}
 
 			// It's possible that the circuit went away, because ANY message can disable the circuit
@@ -790,6 +799,16 @@ S32	LLMessageSystem::getReceiveBytes() const
 	}
 }
 
+void LLMessageSystem::getRecentMessages(recent_message_list_t& messages) const
+{
+	messages.clear();
+	U32 count = llmin(mRecentMessageCount, (U32)RECENT_MESSAGE_COUNT);
+	for (U32 i = mRecentMessageCount - count; i < mRecentMessageCount; i++)
+	{
+		messages.push_back(mRecentMessages[i % RECENT_MESSAGE_COUNT]);
+	}
+}
+
 
 void LLMessageSystem::processAcks()
 {
@@ -820,6 +839,9 @@ void LLMessageSystem::processAcks()
 		//cycle through ack list for each host we need to send acks to
 		mCircuitInfo.sendAcks();
 
+		//let out-throttled packets drain even on frames with nothing new to send
+		mPacketRing.flushSendQueue(mSocket);
+
 		if (!mDenyTrustedCircuitSet.empty())
 		{
 			LL_INFOS("Messaging") << "Sending queued DenyTrustedCircuit messages." << llendl;
@@ -2213,16 +2235,14 @@ S32 LLMessageSystem::sendError(
 	temp = message;
 	if(temp.size() > (size_t)MTUBYTES) temp.resize((size_t)MTUBYTES);
 	addString("Message", message);
-	LLPointer<LLSDBinaryFormatter> formatter = new LLSDBinaryFormatter;
-	std::ostringstream ostr;
-	formatter->format(data, ostr);
-	temp = ostr.str();
+	std::vector<U8> packed;
+	LLSDSerialize::toBinaryBuffer(data, packed);
 	bool pack_data = true;
 	static const std::string ERROR_MESSAGE_NAME("Error");
 	if (LLMessageConfig::getMessageFlavor(ERROR_MESSAGE_NAME) ==
 		LLMessageConfig::TEMPLATE_FLAVOR)
 	{
-		S32 msg_size = temp.size() + mMessageBuilder->getMessageSize();
+		S32 msg_size = packed.size() + mMessageBuilder->getMessageSize();
 		if(msg_size >= ETHERNET_MTU_BYTES)
 		{
 			pack_data = false;
@@ -2230,7 +2250,7 @@ S32 LLMessageSystem::sendError(
 	}
 	if(pack_data)
 	{
-		addBinaryData("Data", (void*)temp.c_str(), temp.size());
+		addBinaryData("Data", packed.empty() ? NULL : &packed[0], packed.size());
 	}
 	else
 	{
@@ -2421,6 +2441,8 @@ void process_deny_trusted_circuit(LLMessageSystem *msg, void **)
 void dump_prehash_files()
 {
 	U32 i;
+	std::vector<std::string> names;
+	LLMessageStringTable::getInstance()->getStrings(names);
 	std::string filename("../../indra/llmessage/message_prehash.h");
 	LLFILE* fp = LLFile::fopen(filename, "w");	/* Flawfinder: ignore */
 	if (fp)
@@ -2442,11 +2464,11 @@ void dump_prehash_files()
 			" */\n",
 			gMessageSystem->mMessageFileVersionNumber);
 		fprintf(fp, "\n\nextern F32 const gPrehashVersionNumber;\n\n");
-		for (i = 0; i < MESSAGE_NUMBER_OF_HASH_BUCKETS; i++)
+		for (i = 0; i < names.size(); i++)
 		{
-			if (!LLMessageStringTable::getInstance()->mEmpty[i] && LLMessageStringTable::getInstance()->mString[i][0] != '.')
+			if (names[i][0] != '.')
 			{
-				fprintf(fp, "extern char const* const _PREHASH_%s;\n", LLMessageStringTable::getInstance()->mString[i]);
+				fprintf(fp, "extern char const* const _PREHASH_%s;\n", names[i].c_str());
 			}
 		}
 		fprintf(fp, "\n\n#endif\n");
@@ -2472,11 +2494,11 @@ void dump_prehash_files()
 		fprintf(fp, "#include \"linden_common.h\"\n");
 		fprintf(fp, "#include \"message.h\"\n\n");
 		fprintf(fp, "\n\nF32 const gPrehashVersionNumber = %.3ff;\n\n", gMessageSystem->mMessageFileVersionNumber);
-		for (i = 0; i < MESSAGE_NUMBER_OF_HASH_BUCKETS; i++)
+		for (i = 0; i < names.size(); i++)
 		{
-			if (!LLMessageStringTable::getInstance()->mEmpty[i] && LLMessageStringTable::getInstance()->mString[i][0] != '.')
+			if (names[i][0] != '.')
 			{
-				fprintf(fp, "char const* const _PREHASH_%s = LLMessageStringTable::getInstance()->getString(\"%s\");\n", LLMessageStringTable::getInstance()->mString[i], LLMessageStringTable::getInstance()->mString[i]);
+				fprintf(fp, "char const* const _PREHASH_%s = LLMessageStringTable::getInstance()->getString(\"%s\");\n", names[i].c_str(), names[i].c_str());
 			}
 		}
 		fclose(fp);
@@ -29,6 +29,7 @@
 
 #include <cstring>
 #include <set>
+#include <vector>
 
 #if LL_LINUX
 #include <endian.h>
@@ -56,13 +57,13 @@
 #include "llsingleton.h"
 #include "message_prehash.h"
 #include "llstl.h"
+#include "llstringtable.h"
 #include "llmsgvariabletype.h"
 #include "llmessagesenderinterface.h"
 
 #include "llstoredmessage.h"
 
 const U32 MESSAGE_MAX_STRINGS_LENGTH = 64;
-const U32 MESSAGE_NUMBER_OF_HASH_BUCKETS = 8192;
 
 const S32 MESSAGE_MAX_PER_FRAME = 400;
 
@@ -72,11 +73,14 @@ public:
 	LLMessageStringTable();
 	~LLMessageStringTable();
 
+	// safe to call from any thread, lookups of known names don't lock
 	char *getString(const char *str);
 
-	U32	 mUsed;
-	BOOL mEmpty[MESSAGE_NUMBER_OF_HASH_BUCKETS];
-	char mString[MESSAGE_NUMBER_OF_HASH_BUCKETS][MESSAGE_MAX_STRINGS_LENGTH];	/* Flawfinder: ignore */
+	// every name in the table, sorted
+	void getStrings(std::vector<std::string>& strings) const;
+
+private:
+	LLStringInterner mStrings;
 };
 
 
@@ -675,6 +679,15 @@ public:
 
 	S32		getUnackedListSize() const			{ return mUnackedListSize; }
 
+	// Last messages read off the wire, oldest first, for hitch reports
+	struct RecentMessage
+	{
+		const char*	mName;			// from the message template, never freed
+		F32			mHandlerMS;		// time to decode and handle it
+	};
+	typedef std::vector<RecentMessage> recent_message_list_t;
+	void	getRecentMessages(recent_message_list_t& messages) const;
+
 	//const char* getCurrentSMessageName() const { return mCurrentSMessageName; }
 	//const char* getCurrentSBlockName() const { return mCurrentSBlockName; }
 
@@ -747,6 +760,10 @@ public:
 private:
 
 	bool mLastMessageFromTrustedMessageService;
+
+	enum { RECENT_MESSAGE_COUNT = 64 };
+	RecentMessage mRecentMessages[RECENT_MESSAGE_COUNT];	// ring
+	U32 mRecentMessageCount;
 	
 	// The mCircuitCodes is a map from circuit codes to session
 	// ids. This allows us to verify sessions on connect.
@@ -26,30 +26,14 @@
 
 #include "linden_common.h"
 
+#include <algorithm>
+
 #include "llerror.h"
 #include "message.h"
 
-inline U32	message_hash_my_string(const char *str)
-{
-	U32 retval = 0;
-	while (*str++)
-	{
-		retval += *str;
-		retval <<= 1;
-	}
-	return (retval % MESSAGE_NUMBER_OF_HASH_BUCKETS);
-}
-
-
-
 LLMessageStringTable::LLMessageStringTable()
-:	mUsed(0)
+:	mStrings(8192)
 {
-	for (U32 i = 0; i < MESSAGE_NUMBER_OF_HASH_BUCKETS; i++)
-	{
-		mEmpty[i] = TRUE;
-		mString[i][0] = 0;
-	}
 }
 
 
@@ -59,33 +43,24 @@ LLMessageStringTable::~LLMessageStringTable()
 
 char* LLMessageStringTable::getString(const char *str)
 {
-	U32 hash_value = message_hash_my_string(str);
-	while (!mEmpty[hash_value])
-	{
-		if (!strncmp(str, mString[hash_value], MESSAGE_MAX_STRINGS_LENGTH))
-		{
-			return mString[hash_value];
-		}
-		else
-		{
-			hash_value++;
-			hash_value %= MESSAGE_NUMBER_OF_HASH_BUCKETS;
-		}
-	}
-	// not found, so add!
-	strncpy(mString[hash_value], str, MESSAGE_MAX_STRINGS_LENGTH);	/* Flawfinder: ignore */
-	mString[hash_value][MESSAGE_MAX_STRINGS_LENGTH - 1] = 0;
-	mEmpty[hash_value] = FALSE;
-	mUsed++;
-	if (mUsed >= MESSAGE_NUMBER_OF_HASH_BUCKETS - 1)
+	// names are compared by pointer, never written through
+	char* result = (char*)mStrings.find(str);
+	if (result)
 	{
-		U32 i;
-		llinfos << "Dumping string table before crashing on HashTable full!" << llendl;
-		for (i = 0; i < MESSAGE_NUMBER_OF_HASH_BUCKETS; i++)
-		{
-			llinfos << "Entry #" << i << ": " << mString[i] << llendl;
-		}
+		return result;
 	}
-	return mString[hash_value];
+
+	char truncated[MESSAGE_MAX_STRINGS_LENGTH];	/* Flawfinder: ignore */
+	strncpy(truncated, str, MESSAGE_MAX_STRINGS_LENGTH);	/* Flawfinder: ignore */
+	truncated[MESSAGE_MAX_STRINGS_LENGTH - 1] = 0;
+	return (char*)mStrings.intern(truncated);
 }
 
+
+void LLMessageStringTable::getStrings(std::vector<std::string>& strings) const
+{
+	std::vector<const char*> entries;
+	mStrings.getStrings(entries);
+	strings.assign(entries.begin(), entries.end());
+	std::sort(strings.begin(), strings.end());
+}
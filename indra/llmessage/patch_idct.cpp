@@ -29,6 +29,7 @@
 #include "llmath.h"
 //#include "vmath.h"
 #include "v3math.h"
+#include "llvector4a.h"
 #include "patch_dct.h"
 
 LLGroupHeader	*gGOPP;
@@ -55,6 +56,9 @@ S32	gCurrentDeSize = 0;
 
 F32	gPatchICosines[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
 
+// gPatchICosines with the DC row replaced by OO_SQRT2, for idct_patch_vectorized
+LL_ALIGN_16(F32 gPatchIDCTWeights[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+
 void setup_patch_icosines(S32 size)
 {
 	S32 n, u;
@@ -65,6 +69,7 @@ void setup_patch_icosines(S32 size)
 		for (n = 0; n < size; n++)
 		{
 			gPatchICosines[u*size+n] = cosf((2.f*n+1.f)*u*oosob);
+			gPatchIDCTWeights[u*size+n] = u ? gPatchICosines[u*size+n] : OO_SQRT2;
 		}
 	}
 }
@@ -146,122 +151,6 @@ void init_patch_decompressor(S32 size)
 	}
 }
 
-inline void idct_line(F32 *linein, F32 *lineout, S32 line)
-{
-	S32 n;
-	F32 total;
-	F32 *pcp = gPatchICosines;
-
-#ifdef _PATCH_SIZE_16_AND_32_ONLY
-	F32 oosob = 2.f/16.f;
-	S32	line_size = line*NORMAL_PATCH_SIZE;
-	F32 *tlinein, *tpcp;
-
-
-	for (n = 0; n < NORMAL_PATCH_SIZE; n++)
-	{
-		tpcp = pcp + n;
-		tlinein = linein + line_size;
-	
-		total = OO_SQRT2*(*(tlinein++));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		*(lineout + line_size + n) = total*oosob;
-	}
-#else
-	F32 oosob = 2.f/size;
-	S32	size = gGOPP->patch_size;
-	S32	line_size = line*size;
-	S32 u;
-	for (n = 0; n < size; n++)
-	{
-		total = OO_SQRT2*linein[line_size];
-		for (u = 1; u < size; u++)
-		{
-			total += linein[line_size + u]*pcp[u*size+n];
-		}
-		lineout[line_size + n] = total*oosob;
-	}
-#endif
-}
-
-inline void idct_line_large_slow(F32 *linein, F32 *lineout, S32 line)
-{
-	S32 n;
-	F32 total;
-	F32 *pcp = gPatchICosines;
-
-	F32 oosob = 2.f/32.f;
-	S32	line_size = line*LARGE_PATCH_SIZE;
-	F32 *tlinein, *tpcp;
-
-
-	for (n = 0; n < LARGE_PATCH_SIZE; n++)
-	{
-		tpcp = pcp + n;
-		tlinein = linein + line_size;
-	
-		total = OO_SQRT2*(*(tlinein++));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		*(lineout + line_size + n) = total*oosob;
-	}
-}
-
 // Nota Bene: assumes that coefficients beyond 128 are 0!
 
 void idct_line_large(F32 *linein, F32 *lineout, S32 line)
@@ -306,118 +195,6 @@ void idct_line_large(F32 *linein, F32 *lineout, S32 line)
 	}
 }
 
-inline void idct_column(F32 *linein, F32 *lineout, S32 column)
-{
-	S32 n;
-	F32 total;
-	F32 *pcp = gPatchICosines;
-
-#ifdef _PATCH_SIZE_16_AND_32_ONLY
-	F32 *tlinein, *tpcp;
-
-	for (n = 0; n < NORMAL_PATCH_SIZE; n++)
-	{
-		tpcp = pcp + n;
-		tlinein = linein + column;
-
-		total = OO_SQRT2*(*tlinein);
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-		total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-		*(lineout + (n<<4) + column) = total;
-	}
-
-#else
-	S32	size = gGOPP->patch_size;
-	S32 u;
-	S32 u_size;
-
-	for (n = 0; n < size; n++)
-	{
-		total = OO_SQRT2*linein[column];
-		for (u = 1; u < size; u++)
-		{
-			u_size = u*size;
-			total += linein[u_size + column]*pcp[u_size+n];
-		}
-		lineout[size*n + column] = total;
-	}
-#endif
-}
-
-inline void idct_column_large_slow(F32 *linein, F32 *lineout, S32 column)
-{
-	S32 n;
-	F32 total;
-	F32 *pcp = gPatchICosines;
-
-	F32 *tlinein, *tpcp;
-
-	for (n = 0; n < LARGE_PATCH_SIZE; n++)
-	{
-		tpcp = pcp + n;
-		tlinein = linein + column;
-
-		total = OO_SQRT2*(*tlinein);
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-		total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-		*(lineout + (n<<5) + column) = total;
-	}
-}
-
 // Nota Bene: assumes that coefficients beyond 128 are 0!
 
 void idct_column_large(F32 *linein, F32 *lineout, S32 column)
@@ -443,157 +220,83 @@ void idct_column_large(F32 *linein, F32 *lineout, S32 column)
 	}
 }
 
-inline void idct_patch(F32 *block)
+// Both passes of the 2D IDCT are sums of whole rows scaled by a single
+// weight, so they run four columns at a time. The second pass also applies
+// the dequantize scale and offset and writes straight into out, whose rows
+// are out_stride apart and need not be aligned. block must be 16 byte aligned
+// and size a multiple of 4.
+void idct_patch_vectorized(F32 *block, F32 *out, S32 out_stride, S32 size, F32 mult, F32 addval)
 {
-	F32 temp[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-
-#ifdef _PATCH_SIZE_16_AND_32_ONLY
-	idct_column(block, temp, 0);	
-	idct_column(block, temp, 1);	
-	idct_column(block, temp, 2);	
-	idct_column(block, temp, 3);	
-
-	idct_column(block, temp, 4);	
-	idct_column(block, temp, 5);	
-	idct_column(block, temp, 6);	
-	idct_column(block, temp, 7);	
-
-	idct_column(block, temp, 8);	
-	idct_column(block, temp, 9);	
-	idct_column(block, temp, 10);	
-	idct_column(block, temp, 11);	
-
-	idct_column(block, temp, 12);	
-	idct_column(block, temp, 13);	
-	idct_column(block, temp, 14);	
-	idct_column(block, temp, 15);	
-
-	idct_line(temp, block, 0);	
-	idct_line(temp, block, 1);	
-	idct_line(temp, block, 2);	
-	idct_line(temp, block, 3);	
-
-	idct_line(temp, block, 4);	
-	idct_line(temp, block, 5);	
-	idct_line(temp, block, 6);	
-	idct_line(temp, block, 7);	
-
-	idct_line(temp, block, 8);	
-	idct_line(temp, block, 9);	
-	idct_line(temp, block, 10);	
-	idct_line(temp, block, 11);	
-
-	idct_line(temp, block, 12);	
-	idct_line(temp, block, 13);	
-	idct_line(temp, block, 14);	
-	idct_line(temp, block, 15);	
-#else
-	S32 i;
-	S32	size = gGOPP->patch_size;
-	for (i = 0; i < size; i++)
+	LL_ALIGN_16(F32 temp[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+	LLVector4a acc[LARGE_PATCH_SIZE/4];
+	LLVector4a weight, v;
+	const F32 *w = gPatchIDCTWeights;
+	const S32 quads = size/4;
+	S32 n, u, q;
+
+	// columns: row n of temp is the sum over u of row u of block times w[u][n]
+	for (n = 0; n < size; n++)
 	{
-		idct_column(block, temp, i);	
+		for (q = 0; q < quads; q++)
+		{
+			acc[q].clear();
+		}
+		for (u = 0; u < size; u++)
+		{
+			weight.splat(w[u*size + n]);
+			const F32 *row = block + u*size;
+			for (q = 0; q < quads; q++)
+			{
+				v.load4a(row + q*4);
+				v.mul(weight);
+				acc[q].add(v);
+			}
+		}
+		for (q = 0; q < quads; q++)
+		{
+			acc[q].store4a(temp + n*size + q*4);
+		}
 	}
-	for (i = 0; i < size; i++)
+
+	// lines: row n of the output is the sum over u of row u of w times temp[n][u]
+	LLVector4a scale, offset;
+	scale.splat(mult*2.f/size);
+	offset.splat(addval);
+	for (n = 0; n < size; n++)
 	{
-		idct_line(temp, block, i);	
+		for (q = 0; q < quads; q++)
+		{
+			acc[q].clear();
+		}
+		for (u = 0; u < size; u++)
+		{
+			weight.splat(temp[n*size + u]);
+			const F32 *row = w + u*size;
+			for (q = 0; q < quads; q++)
+			{
+				v.load4a(row + q*4);
+				v.mul(weight);
+				acc[q].add(v);
+			}
+		}
+		F32 *out_row = out + n*out_stride;
+		for (q = 0; q < quads; q++)
+		{
+			acc[q].mul(scale);
+			acc[q].add(offset);
+			_mm_storeu_ps(out_row + q*4, acc[q]);
+		}
 	}
-#endif
-}
-
-inline void idct_patch_large(F32 *block)
-{
-	F32 temp[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-
-	idct_column_large_slow(block, temp, 0);	
-	idct_column_large_slow(block, temp, 1);	
-	idct_column_large_slow(block, temp, 2);	
-	idct_column_large_slow(block, temp, 3);	
-
-	idct_column_large_slow(block, temp, 4);	
-	idct_column_large_slow(block, temp, 5);	
-	idct_column_large_slow(block, temp, 6);	
-	idct_column_large_slow(block, temp, 7);	
-
-	idct_column_large_slow(block, temp, 8);	
-	idct_column_large_slow(block, temp, 9);	
-	idct_column_large_slow(block, temp, 10);	
-	idct_column_large_slow(block, temp, 11);	
-
-	idct_column_large_slow(block, temp, 12);	
-	idct_column_large_slow(block, temp, 13);	
-	idct_column_large_slow(block, temp, 14);	
-	idct_column_large_slow(block, temp, 15);	
-
-	idct_column_large_slow(block, temp, 16);	
-	idct_column_large_slow(block, temp, 17);	
-	idct_column_large_slow(block, temp, 18);	
-	idct_column_large_slow(block, temp, 19);	
-
-	idct_column_large_slow(block, temp, 20);	
-	idct_column_large_slow(block, temp, 21);	
-	idct_column_large_slow(block, temp, 22);	
-	idct_column_large_slow(block, temp, 23);	
-
-	idct_column_large_slow(block, temp, 24);	
-	idct_column_large_slow(block, temp, 25);	
-	idct_column_large_slow(block, temp, 26);	
-	idct_column_large_slow(block, temp, 27);	
-
-	idct_column_large_slow(block, temp, 28);	
-	idct_column_large_slow(block, temp, 29);	
-	idct_column_large_slow(block, temp, 30);	
-	idct_column_large_slow(block, temp, 31);	
-
-	idct_line_large_slow(temp, block, 0);	
-	idct_line_large_slow(temp, block, 1);	
-	idct_line_large_slow(temp, block, 2);	
-	idct_line_large_slow(temp, block, 3);	
-
-	idct_line_large_slow(temp, block, 4);	
-	idct_line_large_slow(temp, block, 5);	
-	idct_line_large_slow(temp, block, 6);	
-	idct_line_large_slow(temp, block, 7);	
-
-	idct_line_large_slow(temp, block, 8);	
-	idct_line_large_slow(temp, block, 9);	
-	idct_line_large_slow(temp, block, 10);	
-	idct_line_large_slow(temp, block, 11);	
-
-	idct_line_large_slow(temp, block, 12);	
-	idct_line_large_slow(temp, block, 13);	
-	idct_line_large_slow(temp, block, 14);	
-	idct_line_large_slow(temp, block, 15);	
-
-	idct_line_large_slow(temp, block, 16);	
-	idct_line_large_slow(temp, block, 17);	
-	idct_line_large_slow(temp, block, 18);	
-	idct_line_large_slow(temp, block, 19);	
-
-	idct_line_large_slow(temp, block, 20);	
-	idct_line_large_slow(temp, block, 21);	
-	idct_line_large_slow(temp, block, 22);	
-	idct_line_large_slow(temp, block, 23);	
-
-	idct_line_large_slow(temp, block, 24);	
-	idct_line_large_slow(temp, block, 25);	
-	idct_line_large_slow(temp, block, 26);	
-	idct_line_large_slow(temp, block, 27);	
-
-	idct_line_large_slow(temp, block, 28);	
-	idct_line_large_slow(temp, block, 29);	
-	idct_line_large_slow(temp, block, 30);	
-	idct_line_large_slow(temp, block, 31);	
 }
 
 S32	gDitherNoise = 128;
 
 void decompress_patch(F32 *patch, S32 *cpatch, LLPatchHeader *ph)
 {
-	S32		i, j;
+	S32		i;
 
-	F32		block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE], *tblock = block;
-	F32		*tpatch;
+	LL_ALIGN_16(F32 block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+	F32		*tblock = block;
 
 	LLGroupHeader	*gopp = gGOPP;
 	S32		size = gopp->patch_size;
@@ -615,24 +318,7 @@ void decompress_patch(F32 *patch, S32 *cpatch, LLPatchHeader *ph)
 		*(tblock++) = *(cpatch + *(decopy_matrix++))*(*dq++);
 	}
 
-	if (size == 16)
-	{
-		idct_patch(block);
-	}
-	else
-	{
-		idct_patch_large(block);
-	}
-
-	for (j = 0; j < size; j++)
-	{
-		tpatch = patch + j*stride;
-		tblock = block + j*size;
-		for (i = 0; i < size; i++)
-		{
-			*(tpatch++) = *(tblock++)*mult+addval;
-		}
-	}
+	idct_patch_vectorized(block, patch, stride, size, mult, addval);
 }
 
 
@@ -640,7 +326,9 @@ void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph)
 {
 	S32		i, j;
 
-	F32			block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE], *tblock = block;
+	LL_ALIGN_16(F32 block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+	LL_ALIGN_16(F32 heights[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+	F32			*tblock = block;
 	LLVector3	*tvec;
 
 	LLGroupHeader	*gopp = gGOPP;
@@ -666,18 +354,15 @@ void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph)
 		*(tblock++) = *(cpatch + *(decopy_matrix++))*(*dq++);
 	}
 
-	if (size == 16)
-		idct_patch(block);
-	else
-		idct_patch_large(block);
+	idct_patch_vectorized(block, heights, size, size, mult, addval);
 
 	for (j = 0; j < size; j++)
 	{
 		tvec = v + j*stride;
-		tblock = block + j*size;
+		tblock = heights + j*size;
 		for (i = 0; i < size; i++)
 		{
-			(*tvec++).mV[VZ] = *(tblock++)*mult+addval;
+			(*tvec++).mV[VZ] = *(tblock++);
 		}
 	}
 }
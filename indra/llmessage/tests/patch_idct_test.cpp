@@ -0,0 +1,131 @@
+/**
+ * @file patch_idct_test.cpp
+ * @date October 2026
+ * @brief Round trip tests for the terrain patch DCT
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmath.h"
+#include "lltimer.h"
+#include "../patch_dct.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	// compress then decompress a smooth height field, returns the largest error
+	F32 round_trip(S32 size, S32 stride, F32* out_patch)
+	{
+		std::vector<F32> patch(size*stride, 0.f);
+		for (S32 j = 0; j < size; j++)
+		{
+			for (S32 i = 0; i < size; i++)
+			{
+				patch[j*stride + i] = 20.f + 5.f*sinf(i*0.2f) + 3.f*cosf(j*0.25f);
+			}
+		}
+
+		LLPatchHeader ph;
+		F32 zmax, zmin;
+		S32 cpatch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+		init_patch_compressor(size, stride, 0);
+		prescan_patch(&patch[0], &ph, zmax, zmin);
+		compress_patch(&patch[0], cpatch, &ph, 10);
+
+		LLGroupHeader gop;
+		get_patch_group_header(&gop);
+		set_group_of_patch_header(&gop);
+		init_patch_decompressor(size);
+		decompress_patch(out_patch, cpatch, &ph);
+
+		F32 max_err = 0.f;
+		for (S32 j = 0; j < size; j++)
+		{
+			for (S32 i = 0; i < size; i++)
+			{
+				max_err = llmax(max_err, fabsf(out_patch[j*stride + i] - patch[j*stride + i]));
+			}
+		}
+		return max_err;
+	}
+}
+
+namespace tut
+{
+	struct patch_idct_data
+	{
+	};
+	typedef test_group<patch_idct_data> patch_idct_test;
+	typedef patch_idct_test::object patch_idct_object;
+	tut::patch_idct_test patch_idct_testcase("patch_idct");
+
+	// normal patches written into a wider surface grid
+	template<> template<>
+	void patch_idct_object::test<1>()
+	{
+		const S32 stride = 3*NORMAL_PATCH_SIZE + 1;
+		std::vector<F32> out(NORMAL_PATCH_SIZE*stride, -1.f);
+		F32 err = round_trip(NORMAL_PATCH_SIZE, stride, &out[0]);
+		ensure("16x16 patch survives the round trip", err < 0.5f);
+		ensure_equals("columns past the patch are untouched", out[NORMAL_PATCH_SIZE], -1.f);
+	}
+
+	template<> template<>
+	void patch_idct_object::test<2>()
+	{
+		std::vector<F32> out(LARGE_PATCH_SIZE*LARGE_PATCH_SIZE);
+		F32 err = round_trip(LARGE_PATCH_SIZE, LARGE_PATCH_SIZE, &out[0]);
+		ensure("32x32 patch survives the round trip", err < 0.5f);
+	}
+
+	// decompression timing, tracked in the test log
+	template<> template<>
+	void patch_idct_object::test<3>()
+	{
+		const S32 COUNT = 4096;
+		std::vector<F32> out(NORMAL_PATCH_SIZE*NORMAL_PATCH_SIZE);
+		round_trip(NORMAL_PATCH_SIZE, NORMAL_PATCH_SIZE, &out[0]);
+
+		S32 cpatch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+		for (S32 i = 0; i < NORMAL_PATCH_SIZE*NORMAL_PATCH_SIZE; i++)
+		{
+			cpatch[i] = (i % 7) - 3;
+		}
+		LLPatchHeader ph;
+		ph.dc_offset = 20.f;
+		ph.range = 10;
+		ph.quant_wbits = (10 - 2) << 4;
+
+		LLTimer timer;
+		for (S32 i = 0; i < COUNT; i++)
+		{
+			decompress_patch(&out[0], cpatch, &ph);
+		}
+		F32 elapsed = timer.getElapsedTimeF32();
+
+		llinfos << "Decompressed " << COUNT << " terrain patches in " << elapsed * 1000.f << " ms" << llendl;
+		ensure("decoded heights are finite", llfinite(out[0]));
+	}
+}
@@ -357,9 +357,11 @@ std::string LLPluginMessage::generate(void) const
 {
 	std::ostringstream result;
 	
-	// Pretty XML may be slightly easier to deal with while debugging...
-//	LLSDSerialize::toXML(mMessage, result);
-	LLSDSerialize::toPrettyXML(mMessage, result);
+	// Pretty XML may be slightly easier to deal with while debugging, but
+	// mouse moves and dirty rects go through here many times a frame and
+	// the indentation more than doubles what both ends have to push and parse.
+	LLSDSerialize::toXML(mMessage, result);
+//	LLSDSerialize::toPrettyXML(mMessage, result);
 	
 	return result.str();
 }
@@ -804,16 +804,11 @@ BOOL LLModel::createVolumeFacesFromDomMesh(domMesh* mesh)
 		mMaterialList.clear();
 
 		addVolumeFacesFromDomMesh(mesh);
+		finishVolumeFaces();
 		
 		if (getNumVolumeFaces() > 0)
 		{
-			normalizeVolumeFaces();
-			optimizeVolumeFaces();
-			
-			if (getNumVolumeFaces() > 0)
-			{
-				return TRUE;
-			}
+			return TRUE;
 		}
 	}
 	else
@@ -841,6 +836,15 @@ void LLModel::offsetMesh( const LLVector3& pivotPoint )
 	}
 }
 
+void LLModel::finishVolumeFaces()
+{
+	if (getNumVolumeFaces() > 0)
+	{
+		normalizeVolumeFaces();
+		optimizeVolumeFaces();
+	}
+}
+
 void LLModel::optimizeVolumeFaces()
 {
 	for (U32 i = 0; i < getNumVolumeFaces(); ++i)
@@ -1338,12 +1342,19 @@ std::string LLModel::getElementLabel(daeElement *element)
 }
 
 //static 
-LLModel* LLModel::loadModelFromDomMesh(domMesh *mesh)
+LLModel* LLModel::loadModelFromDomMesh(domMesh *mesh, bool finish)
 {
 	LLVolumeParams volume_params;
 	volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
 	LLModel* ret = new LLModel(volume_params, 0.f); 
-	ret->createVolumeFacesFromDomMesh(mesh);
+	if (finish)
+	{
+		ret->createVolumeFacesFromDomMesh(mesh);
+	}
+	else
+	{
+		ret->addVolumeFacesFromDomMesh(mesh);
+	}
 	ret->mLabel = getElementLabel(mesh);
 	return ret;
 }
@@ -145,7 +145,10 @@ public:
 		LLSD& mdl,
 		BOOL nowrite = FALSE, BOOL as_slm = FALSE);
 
-	static LLModel* loadModelFromDomMesh(domMesh* mesh);
+	// With finish false the normalize and optimize passes are skipped and
+	// left to finishVolumeFaces(), which reads nothing from the DOM and so
+	// may run on another thread.
+	static LLModel* loadModelFromDomMesh(domMesh* mesh, bool finish = true);
 	static std::string getElementLabel(daeElement* element);
 	std::string getName() const;
 	std::string getMetric() const {return mMetric;}
@@ -171,6 +174,7 @@ public:
 
 	void normalizeVolumeFaces();
 	void optimizeVolumeFaces();
+	void finishVolumeFaces();
 	void offsetMesh( const LLVector3& pivotPoint );
 	void getNormalizedScaleTranslation(LLVector3& scale_out, LLVector3& translation_out);
 	
@@ -445,9 +445,12 @@ LLFontGlyphInfo* LLFontFreetype::addGlyphFromFont(const LLFontFreetype *fontp, l
 		// omit it from the font-image.
 	}
 	
+	// Only send the new glyph's texels.  Re-sending the whole bitmap page
+	// for every glyph made each first-seen CJK character a full texture
+	// upload; the rest of the page is already on the GPU.
 	LLImageGL *image_gl = mFontBitmapCachep->getImageGL(bitmap_num);
 	LLImageRaw *image_raw = mFontBitmapCachep->getImageRaw(bitmap_num);
-	image_gl->setSubImage(image_raw, 0, 0, image_gl->getWidth(), image_gl->getHeight());
+	image_gl->setSubImage(image_raw, pos_x, pos_y, width, height, TRUE);
 
 	return gi;
 }
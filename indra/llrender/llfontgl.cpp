@@ -167,8 +167,13 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 	LLVector2 origin(floorf(sCurOrigin.mX*sScaleX), floorf(sCurOrigin.mY*sScaleY));
 
 	// Depth translation, so that floating text appears 'in-world'
-	// and is correctly occluded.
-	gGL.translatef(0.f,0.f,sCurDepth);
+	// and is correctly occluded.  Skipped for flat UI text: translatef()
+	// flushes, and without it consecutive strings on the same bitmap page
+	// share one draw call in gGL's stream buffer.
+	if (sCurDepth != 0.f)
+	{
+		gGL.translatef(0.f,0.f,sCurDepth);
+	}
 
 	S32 chars_drawn = 0;
 	S32 i;
@@ -254,10 +259,12 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 
 	const LLFontGlyphInfo* next_glyph = NULL;
 
+	// drawGlyph() writes up to 6 quads (soft shadow) past the batch check
 	const S32 GLYPH_BATCH_SIZE = 30;
-	LLVector3 vertices[GLYPH_BATCH_SIZE * 4];
-	LLVector2 uvs[GLYPH_BATCH_SIZE * 4];
-	LLColor4U colors[GLYPH_BATCH_SIZE * 4];
+	const S32 MAX_QUADS_PER_GLYPH = 6;
+	LLVector3 vertices[(GLYPH_BATCH_SIZE + MAX_QUADS_PER_GLYPH) * 4];
+	LLVector2 uvs[(GLYPH_BATCH_SIZE + MAX_QUADS_PER_GLYPH) * 4];
+	LLColor4U colors[(GLYPH_BATCH_SIZE + MAX_QUADS_PER_GLYPH) * 4];
 
 	LLColor4U text_color(color);
 
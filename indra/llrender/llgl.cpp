@@ -254,6 +254,14 @@ PFNGLGETDEBUGMESSAGELOGARBPROC glGetDebugMessageLogARB = NULL;
 // GL_EXT_blend_func_separate
 PFNGLBLENDFUNCSEPARATEEXTPROC glBlendFuncSeparateEXT = NULL;
 
+// GL_EXT_multi_draw_arrays
+PFNGLMULTIDRAWELEMENTSEXTPROC glMultiDrawElementsEXT = NULL;
+
+// GL_ARB_get_program_binary
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = NULL;
+
 // GL_ARB_draw_buffers
 PFNGLDRAWBUFFERSARBPROC glDrawBuffersARB = NULL;
 
@@ -398,14 +406,18 @@ LLGLManager::LLGLManager() :
 	mNumTextureUnits(1),
 	mHasMipMapGeneration(FALSE),
 	mHasCompressedTextures(FALSE),
+	mHasTextureCompressionS3TC(FALSE),
 	mHasFramebufferObject(FALSE),
 	mMaxSamples(0),
 	mHasBlendFuncSeparate(FALSE),
+	mHasMultiDrawArrays(FALSE),
+	mHasProgramBinary(FALSE),
 	mHasSync(FALSE),
 	mHasVertexBufferObject(FALSE),
 	mHasVertexArrayObject(FALSE),
 	mHasMapBufferRange(FALSE),
 	mHasFlushBufferRange(FALSE),
+	mHasPixelBufferObject(FALSE),
 	mHasPBuffer(FALSE),
 	mHasShaderObjects(FALSE),
 	mHasVertexShader(FALSE),
@@ -413,6 +425,7 @@ LLGLManager::LLGLManager() :
 	mNumTextureImageUnits(0),
 	mHasOcclusionQuery(FALSE),
 	mHasOcclusionQuery2(FALSE),
+	mHasTimerQuery(FALSE),
 	mHasPointParameters(FALSE),
 	mHasDrawBuffers(FALSE),
 	mHasTextureRectangle(FALSE),
@@ -884,11 +897,21 @@ void LLGLManager::initExtensions()
 # else
 	mHasCompressedTextures = FALSE;
 # endif // GL_ARB_texture_compression
+# ifdef GL_EXT_texture_compression_s3tc
+	mHasTextureCompressionS3TC = TRUE;
+# else
+	mHasTextureCompressionS3TC = FALSE;
+# endif // GL_EXT_texture_compression_s3tc
 # ifdef GL_ARB_vertex_buffer_object
 	mHasVertexBufferObject = TRUE;
 # else
 	mHasVertexBufferObject = FALSE;
 # endif // GL_ARB_vertex_buffer_object
+# ifdef GL_ARB_pixel_buffer_object
+	mHasPixelBufferObject = TRUE;
+# else
+	mHasPixelBufferObject = FALSE;
+# endif // GL_ARB_pixel_buffer_object
 # ifdef GL_EXT_framebuffer_object
 	mHasFramebufferObject = TRUE;
 # else
@@ -909,11 +932,14 @@ void LLGLManager::initExtensions()
 #else
 	mHasBlendFuncSeparate = FALSE;
 # endif // GL_EXT_blend_func_separate
+	mHasMultiDrawArrays = FALSE;
+	mHasProgramBinary = FALSE;
 	mHasMipMapGeneration = FALSE;
 	mHasSeparateSpecularColor = FALSE;
 	mHasAnisotropic = FALSE;
 	mHasCubeMap = FALSE;
 	mHasOcclusionQuery = FALSE;
+	mHasTimerQuery = FALSE;
 	mHasPointParameters = FALSE;
 	mHasShaderObjects = FALSE;
 	mHasVertexShader = FALSE;
@@ -930,13 +956,16 @@ void LLGLManager::initExtensions()
 	mHasCubeMap = ExtensionExists("GL_ARB_texture_cube_map", gGLHExts.mSysExts);
 	mHasARBEnvCombine = ExtensionExists("GL_ARB_texture_env_combine", gGLHExts.mSysExts);
 	mHasCompressedTextures = glh_init_extensions("GL_ARB_texture_compression");
+	mHasTextureCompressionS3TC = ExtensionExists("GL_EXT_texture_compression_s3tc", gGLHExts.mSysExts);
 	mHasOcclusionQuery = ExtensionExists("GL_ARB_occlusion_query", gGLHExts.mSysExts);
 	mHasOcclusionQuery2 = ExtensionExists("GL_ARB_occlusion_query2", gGLHExts.mSysExts);
+	mHasTimerQuery = ExtensionExists("GL_ARB_timer_query", gGLHExts.mSysExts);
 	mHasVertexBufferObject = ExtensionExists("GL_ARB_vertex_buffer_object", gGLHExts.mSysExts);
 	mHasVertexArrayObject = ExtensionExists("GL_ARB_vertex_array_object", gGLHExts.mSysExts);
 	mHasSync = ExtensionExists("GL_ARB_sync", gGLHExts.mSysExts);
 	mHasMapBufferRange = ExtensionExists("GL_ARB_map_buffer_range", gGLHExts.mSysExts);
 	mHasFlushBufferRange = ExtensionExists("GL_APPLE_flush_buffer_range", gGLHExts.mSysExts);
+	mHasPixelBufferObject = ExtensionExists("GL_ARB_pixel_buffer_object", gGLHExts.mSysExts);
 	mHasDepthClamp = ExtensionExists("GL_ARB_depth_clamp", gGLHExts.mSysExts) || ExtensionExists("GL_NV_depth_clamp", gGLHExts.mSysExts);
 	// mask out FBO support when packed_depth_stencil isn't there 'cause we need it for LLRenderTarget -Brad
 #ifdef GL_ARB_framebuffer_object
@@ -955,6 +984,8 @@ void LLGLManager::initExtensions()
 	mHasDebugOutput = ExtensionExists("GL_ARB_debug_output", gGLHExts.mSysExts);
 #if !LL_DARWIN
 	mHasPointParameters = !mIsATI && ExtensionExists("GL_ARB_point_parameters", gGLHExts.mSysExts);
+	mHasMultiDrawArrays = ExtensionExists("GL_EXT_multi_draw_arrays", gGLHExts.mSysExts);
+	mHasProgramBinary = ExtensionExists("GL_ARB_get_program_binary", gGLHExts.mSysExts);
 #endif
 	mHasShaderObjects = ExtensionExists("GL_ARB_shader_objects", gGLHExts.mSysExts) && (LLRender::sGLCoreProfile || ExtensionExists("GL_ARB_shading_language_100", gGLHExts.mSysExts));
 	mHasVertexShader = ExtensionExists("GL_ARB_vertex_program", gGLHExts.mSysExts) && ExtensionExists("GL_ARB_vertex_shader", gGLHExts.mSysExts)
@@ -972,10 +1003,14 @@ void LLGLManager::initExtensions()
 		mHasDepthClamp = FALSE;
 		mHasARBEnvCombine = FALSE;
 		mHasCompressedTextures = FALSE;
+		mHasTextureCompressionS3TC = FALSE;
 		mHasVertexBufferObject = FALSE;
+		mHasPixelBufferObject = FALSE;
 		mHasFramebufferObject = FALSE;
 		mHasDrawBuffers = FALSE;
 		mHasBlendFuncSeparate = FALSE;
+		mHasMultiDrawArrays = FALSE;
+		mHasProgramBinary = FALSE;
 		mHasMipMapGeneration = FALSE;
 		mHasSeparateSpecularColor = FALSE;
 		mHasAnisotropic = FALSE;
@@ -1011,7 +1046,7 @@ void LLGLManager::initExtensions()
 		const char *const blacklist = getenv("LL_GL_BLACKLIST");	/* Flawfinder: ignore */
 		LL_WARNS("RenderInit") << "GL extension support partially disabled via LL_GL_BLACKLIST: " << blacklist << LL_ENDL;
 		if (strchr(blacklist,'a')) mHasARBEnvCombine = FALSE;
-		if (strchr(blacklist,'b')) mHasCompressedTextures = FALSE;
+		if (strchr(blacklist,'b')) { mHasCompressedTextures = FALSE; mHasTextureCompressionS3TC = FALSE; }
 		if (strchr(blacklist,'c')) mHasVertexBufferObject = FALSE;
 		if (strchr(blacklist,'d')) mHasMipMapGeneration = FALSE;//S
 // 		if (strchr(blacklist,'f')) mHasNVVertexArrayRange = FALSE;//S
@@ -1066,6 +1101,15 @@ void LLGLManager::initExtensions()
 	{
 		LL_INFOS("RenderInit") << "Couldn't initialize GL_ARB_occlusion_query2" << LL_ENDL;
 	}
+	if (!mHasOcclusionQuery)
+	{
+		// timer queries go through the occlusion query entry points
+		mHasTimerQuery = FALSE;
+	}
+	if (!mHasTimerQuery)
+	{
+		LL_INFOS("RenderInit") << "Couldn't initialize GL_ARB_timer_query" << LL_ENDL;
+	}
 	if (!mHasPointParameters)
 	{
 		LL_INFOS("RenderInit") << "Couldn't initialize GL_ARB_point_parameters" << LL_ENDL;
@@ -1186,6 +1230,24 @@ void LLGLManager::initExtensions()
 	{
 		glBlendFuncSeparateEXT = (PFNGLBLENDFUNCSEPARATEEXTPROC) GLH_EXT_GET_PROC_ADDRESS("glBlendFuncSeparateEXT");
 	}
+	if (mHasMultiDrawArrays)
+	{
+		glMultiDrawElementsEXT = (PFNGLMULTIDRAWELEMENTSEXTPROC) GLH_EXT_GET_PROC_ADDRESS("glMultiDrawElementsEXT");
+		if (!glMultiDrawElementsEXT)
+		{
+			mHasMultiDrawArrays = FALSE;
+		}
+	}
+	if (mHasProgramBinary)
+	{
+		glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC) GLH_EXT_GET_PROC_ADDRESS("glGetProgramBinary");
+		glProgramBinary = (PFNGLPROGRAMBINARYPROC) GLH_EXT_GET_PROC_ADDRESS("glProgramBinary");
+		glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC) GLH_EXT_GET_PROC_ADDRESS("glProgramParameteri");
+		if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri)
+		{
+			mHasProgramBinary = FALSE;
+		}
+	}
 	if (mHasTextureMultisample)
 	{
 		glTexImage2DMultisample = (PFNGLTEXIMAGE2DMULTISAMPLEPROC) GLH_EXT_GET_PROC_ADDRESS("glTexImage2DMultisample");
@@ -1469,7 +1531,8 @@ void clear_glerror()
 //
 
 // Static members
-boost::unordered_map<LLGLenum, LLGLboolean> LLGLState::sStateMap;
+LLGLState::state_map_t LLGLState::sStateMap;
+U32 LLGLState::sStateChanges = 0;
 
 GLboolean LLGLDepthTest::sDepthEnabled = GL_FALSE; // OpenGL default
 GLenum LLGLDepthTest::sDepthFunc = GL_LESS; // OpenGL default
@@ -1512,7 +1575,7 @@ void LLGLState::resetTextureStates()
 void LLGLState::dumpStates() 
 {
 	LL_INFOS("RenderState") << "GL States:" << LL_ENDL;
-	for (boost::unordered_map<LLGLenum, LLGLboolean>::iterator iter = sStateMap.begin();
+	for (state_map_t::const_iterator iter = sStateMap.begin();
 		 iter != sStateMap.end(); ++iter)
 	{
 		LL_INFOS("RenderState") << llformat(" 0x%04x : %s",(S32)iter->first,iter->second?"TRUE":"FALSE") << LL_ENDL;
@@ -1550,7 +1613,7 @@ void LLGLState::checkStates(const std::string& msg)
 		}
 	}
 	
-	for (boost::unordered_map<LLGLenum, LLGLboolean>::iterator iter = sStateMap.begin();
+	for (state_map_t::const_iterator iter = sStateMap.begin();
 		 iter != sStateMap.end(); ++iter)
 	{
 		LLGLenum state = iter->first;
@@ -1970,21 +2033,24 @@ void LLGLState::setEnabled(S32 enabled)
 	{
 		return;
 	}
+	LLGLboolean& cur_state = sStateMap[mState];
 	if (enabled == CURRENT_STATE)
 	{
-		enabled = sStateMap[mState] == GL_TRUE ? TRUE : FALSE;
+		enabled = cur_state == GL_TRUE ? TRUE : FALSE;
 	}
-	else if (enabled == TRUE && sStateMap[mState] != GL_TRUE)
+	else if (enabled == TRUE && cur_state != GL_TRUE)
 	{
 		gGL.flush();
 		glEnable(mState);
-		sStateMap[mState] = GL_TRUE;
+		cur_state = GL_TRUE;
+		sStateChanges++;
 	}
-	else if (enabled == FALSE && sStateMap[mState] != GL_FALSE)
+	else if (enabled == FALSE && cur_state != GL_FALSE)
 	{
 		gGL.flush();
 		glDisable(mState);
-		sStateMap[mState] = GL_FALSE;
+		cur_state = GL_FALSE;
+		sStateChanges++;
 	}
 	mIsEnabled = enabled;
 }
@@ -2022,6 +2088,7 @@ LLGLState::~LLGLState()
 				glDisable(mState);
 				sStateMap[mState] = GL_FALSE;
 			}
+			sStateChanges++;
 		}
 	}
 	stop_glerror();
@@ -2311,7 +2378,10 @@ LLGLDepthTest::LLGLDepthTest(GLboolean depth_enabled, GLboolean write_enabled, G
 {
 	stop_glerror();
 	
-	checkState();
+	if (gDebugGL)
+	{
+		checkState();
+	}
 
 	if (!depth_enabled)
 	{ // always disable depth writes if depth testing is disabled
@@ -2326,42 +2396,51 @@ LLGLDepthTest::LLGLDepthTest(GLboolean depth_enabled, GLboolean write_enabled, G
 		if (depth_enabled) glEnable(GL_DEPTH_TEST);
 		else glDisable(GL_DEPTH_TEST);
 		sDepthEnabled = depth_enabled;
+		LLGLState::sStateChanges++;
 	}
 	if (depth_func != sDepthFunc)
 	{
 		gGL.flush();
 		glDepthFunc(depth_func);
 		sDepthFunc = depth_func;
+		LLGLState::sStateChanges++;
 	}
 	if (write_enabled != sWriteEnabled)
 	{
 		gGL.flush();
 		glDepthMask(write_enabled);
 		sWriteEnabled = write_enabled;
+		LLGLState::sStateChanges++;
 	}
 }
 
 LLGLDepthTest::~LLGLDepthTest()
 {
-	checkState();
+	if (gDebugGL)
+	{
+		checkState();
+	}
 	if (sDepthEnabled != mPrevDepthEnabled )
 	{
 		gGL.flush();
 		if (mPrevDepthEnabled) glEnable(GL_DEPTH_TEST);
 		else glDisable(GL_DEPTH_TEST);
 		sDepthEnabled = mPrevDepthEnabled;
+		LLGLState::sStateChanges++;
 	}
 	if (sDepthFunc != mPrevDepthFunc)
 	{
 		gGL.flush();
 		glDepthFunc(mPrevDepthFunc);
 		sDepthFunc = mPrevDepthFunc;
+		LLGLState::sStateChanges++;
 	}
 	if (sWriteEnabled != mPrevWriteEnabled )
 	{
 		gGL.flush();
 		glDepthMask(mPrevWriteEnabled);
 		sWriteEnabled = mPrevWriteEnabled;
+		LLGLState::sStateChanges++;
 	}
 }
 
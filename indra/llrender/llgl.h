@@ -33,6 +33,8 @@
 #include <boost/unordered_map.hpp>
 #include <list>
 
+#include "llflathashmap.h"
+
 #include "llerror.h"
 #include "v4color.h"
 #include "llstring.h"
@@ -82,9 +84,12 @@ public:
 	S32	 mNumTextureUnits;
 	BOOL mHasMipMapGeneration;
 	BOOL mHasCompressedTextures;
+	BOOL mHasTextureCompressionS3TC;
 	BOOL mHasFramebufferObject;
 	S32 mMaxSamples;
 	BOOL mHasBlendFuncSeparate;
+	BOOL mHasMultiDrawArrays;
+	BOOL mHasProgramBinary;
 		
 	// ARB Extensions
 	BOOL mHasVertexBufferObject;
@@ -92,6 +97,7 @@ public:
 	BOOL mHasSync;
 	BOOL mHasMapBufferRange;
 	BOOL mHasFlushBufferRange;
+	BOOL mHasPixelBufferObject;
 	BOOL mHasPBuffer;
 	BOOL mHasShaderObjects;
 	BOOL mHasVertexShader;
@@ -99,6 +105,7 @@ public:
 	S32  mNumTextureImageUnits;
 	BOOL mHasOcclusionQuery;
 	BOOL mHasOcclusionQuery2;
+	BOOL mHasTimerQuery;
 	BOOL mHasPointParameters;
 	BOOL mHasDrawBuffers;
 	BOOL mHasDepthClamp;
@@ -253,12 +260,21 @@ public:
 
 	static void resetTextureStates();
 	static void dumpStates();
-	static void checkStates(const std::string& msg = "");
-	static void checkTextureChannels(const std::string& msg = "");
-	static void checkClientArrays(const std::string& msg = "", U32 data_mask = 0);
+
+	// The checks only do anything with gDebugGL set; the argument-less
+	// forms test it inline so release frames don't pay for the call.
+	static void checkStates() { if (gDebugGL) checkStates(LLStringUtil::null); }
+	static void checkStates(const std::string& msg);
+	static void checkTextureChannels() { if (gDebugGL) checkTextureChannels(LLStringUtil::null); }
+	static void checkTextureChannels(const std::string& msg);
+	static void checkClientArrays() { if (gDebugGL) checkClientArrays(LLStringUtil::null); }
+	static void checkClientArrays(const std::string& msg, U32 data_mask = 0);
+
+	static U32 sStateChanges;	// GL state calls actually issued this frame
 	
 protected:
-	static boost::unordered_map<LLGLenum, LLGLboolean> sStateMap;
+	typedef LLFlatHashMap<LLGLenum, LLGLboolean> state_map_t;
+	static state_map_t sStateMap;
 	
 public:
 	enum { CURRENT_STATE = -2 };
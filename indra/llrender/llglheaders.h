@@ -237,6 +237,14 @@ extern PFNGLCOLORTABLEEXTPROC glColorTableEXT;
 //GL_EXT_blend_func_separate
 extern PFNGLBLENDFUNCSEPARATEEXTPROC glBlendFuncSeparateEXT;
 
+//GL_EXT_multi_draw_arrays
+extern PFNGLMULTIDRAWELEMENTSEXTPROC glMultiDrawElementsEXT;
+
+//GL_ARB_get_program_binary
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
 //GL_EXT_framebuffer_object
 extern PFNGLISRENDERBUFFEREXTPROC glIsRenderbufferEXT;
 extern PFNGLBINDRENDERBUFFEREXTPROC glBindRenderbufferEXT;
@@ -497,6 +505,14 @@ extern PFNGLGETCOMPRESSEDTEXIMAGEARBPROC glGetCompressedTexImageARB;
 //GL_EXT_blend_func_separate
 extern PFNGLBLENDFUNCSEPARATEEXTPROC glBlendFuncSeparateEXT;
 
+//GL_EXT_multi_draw_arrays
+extern PFNGLMULTIDRAWELEMENTSEXTPROC glMultiDrawElementsEXT;
+
+//GL_ARB_get_program_binary
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
 //GL_ARB_framebuffer_object
 extern PFNGLISRENDERBUFFERPROC glIsRenderbuffer;
 extern PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer;
@@ -728,6 +744,14 @@ extern PFNGLGETATTRIBLOCATIONARBPROC glGetAttribLocationARB;
 //GL_EXT_blend_func_separate
 extern PFNGLBLENDFUNCSEPARATEEXTPROC glBlendFuncSeparateEXT;
 
+//GL_EXT_multi_draw_arrays
+extern PFNGLMULTIDRAWELEMENTSEXTPROC glMultiDrawElementsEXT;
+
+//GL_ARB_get_program_binary
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
 //GL_ARB_framebuffer_object
 extern PFNGLISRENDERBUFFERPROC glIsRenderbuffer;
 extern PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer;
@@ -990,6 +1014,13 @@ extern void glGetBufferPointervARB (GLenum, GLenum, GLvoid* *);
 // use the known numeric.
 //
 // To avoid #ifdef's in the code. Just define this here.
+#ifndef GL_ARB_get_program_binary
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
 #ifndef GL_DEPTH_CLAMP
 // Probably (still) called GL_DEPTH_CLAMP_NV.
 #define GL_DEPTH_CLAMP 0x864F
@@ -143,29 +143,39 @@ BOOL LLGLSLShader::createShader(vector<string> * attributes,
 
 	// Create program
 	mProgramObject = glCreateProgramObjectARB();
-	
-	//compile new source
-	vector< pair<string,GLenum> >::iterator fileIter = mShaderFiles.begin();
-	for ( ; fileIter != mShaderFiles.end(); fileIter++ )
+	// a new program has none of the environment uniforms set yet
+	mUniformsDirty = TRUE;
+
+	//try the program binary cache before compiling anything
+	S32 cache_level = mShaderLevel;
+	std::string cache_hash = LLShaderMgr::instance()->getProgramHash(this);
+	BOOL cached = !cache_hash.empty() && LLShaderMgr::instance()->loadCachedProgram(this, cache_hash);
+
+	if (!cached)
 	{
-		GLhandleARB shaderhandle = LLShaderMgr::instance()->loadShaderFile((*fileIter).first, mShaderLevel, (*fileIter).second, mFeatures.mIndexedTextureChannels);
-		LL_DEBUGS("ShaderLoading") << "SHADER FILE: " << (*fileIter).first << " mShaderLevel=" << mShaderLevel << LL_ENDL;
-		if (shaderhandle > 0)
+		//compile new source
+		vector< pair<string,GLenum> >::iterator fileIter = mShaderFiles.begin();
+		for ( ; fileIter != mShaderFiles.end(); fileIter++ )
 		{
-			attachObject(shaderhandle);
+			GLhandleARB shaderhandle = LLShaderMgr::instance()->loadShaderFile((*fileIter).first, mShaderLevel, (*fileIter).second, mFeatures.mIndexedTextureChannels);
+			LL_DEBUGS("ShaderLoading") << "SHADER FILE: " << (*fileIter).first << " mShaderLevel=" << mShaderLevel << LL_ENDL;
+			if (shaderhandle > 0)
+			{
+				attachObject(shaderhandle);
+			}
+			else
+			{
+				success = FALSE;
+			}
 		}
-		else
+
+		// Attach existing objects
+		if (!LLShaderMgr::instance()->attachShaderFeatures(this))
 		{
-			success = FALSE;
+			return FALSE;
 		}
 	}
 
-	// Attach existing objects
-	if (!LLShaderMgr::instance()->attachShaderFeatures(this))
-	{
-		return FALSE;
-	}
-
 	if (gGLManager.mGLSLVersionMajor < 2 && gGLManager.mGLSLVersionMinor < 3)
 	{ //indexed texture rendering requires GLSL 1.3 or later
 		//attachShaderFeatures may have set the number of indexed texture channels, so set to 1 again
@@ -175,12 +185,16 @@ BOOL LLGLSLShader::createShader(vector<string> * attributes,
 	// Map attributes and uniforms
 	if (success)
 	{
-		success = mapAttributes(attributes);
+		success = cached ? readAttributeLocations(attributes) : mapAttributes(attributes);
 	}
 	if (success)
 	{
 		success = mapUniforms(uniforms);
 	}
+	if (success && !cached && !cache_hash.empty() && mShaderLevel == cache_level)
+	{ //only cache programs that linked at the level they were hashed for
+		LLShaderMgr::instance()->saveCachedProgram(this, cache_hash);
+	}
 	if( !success )
 	{
 		LL_WARNS("ShaderLoading") << "Failed to link shader: " << mName << LL_ENDL;
@@ -269,42 +283,50 @@ BOOL LLGLSLShader::mapAttributes(const vector<string> * attributes)
 	//link the program
 	BOOL res = link();
 
+	if (res)
+	{ //read back channel locations
+		return readAttributeLocations(attributes);
+	}
+
 	mAttribute.clear();
 	U32 numAttributes = (attributes == NULL) ? 0 : attributes->size();
 	mAttribute.resize(LLShaderMgr::instance()->mReservedAttribs.size() + numAttributes, -1);
 	
-	if (res)
-	{ //read back channel locations
+	return FALSE;
+}
 
-		//read back reserved channels first
-		for (U32 i = 0; i < LLShaderMgr::instance()->mReservedAttribs.size(); i++)
+BOOL LLGLSLShader::readAttributeLocations(const vector<string> * attributes)
+{
+	mAttribute.clear();
+	U32 numAttributes = (attributes == NULL) ? 0 : attributes->size();
+	mAttribute.resize(LLShaderMgr::instance()->mReservedAttribs.size() + numAttributes, -1);
+
+	//read back reserved channels first
+	for (U32 i = 0; i < LLShaderMgr::instance()->mReservedAttribs.size(); i++)
+	{
+		const char* name = LLShaderMgr::instance()->mReservedAttribs[i].c_str();
+		S32 index = glGetAttribLocationARB(mProgramObject, (const GLcharARB *)name);
+		if (index != -1)
 		{
-			const char* name = LLShaderMgr::instance()->mReservedAttribs[i].c_str();
-			S32 index = glGetAttribLocationARB(mProgramObject, (const GLcharARB *)name);
-			if (index != -1)
-			{
-				mAttribute[i] = index;
-				LL_DEBUGS("ShaderLoading") << "Attribute " << name << " assigned to channel " << index << LL_ENDL;
-			}
+			mAttribute[i] = index;
+			LL_DEBUGS("ShaderLoading") << "Attribute " << name << " assigned to channel " << index << LL_ENDL;
 		}
-		if (attributes != NULL)
+	}
+	if (attributes != NULL)
+	{
+		for (U32 i = 0; i < numAttributes; i++)
 		{
-			for (U32 i = 0; i < numAttributes; i++)
+			const char* name = (*attributes)[i].c_str();
+			S32 index = glGetAttribLocationARB(mProgramObject, name);
+			if (index != -1)
 			{
-				const char* name = (*attributes)[i].c_str();
-				S32 index = glGetAttribLocationARB(mProgramObject, name);
-				if (index != -1)
-				{
-					mAttribute[LLShaderMgr::instance()->mReservedAttribs.size() + i] = index;
-					LL_DEBUGS("ShaderLoading") << "Attribute " << name << " assigned to channel " << index << LL_ENDL;
-				}
+				mAttribute[LLShaderMgr::instance()->mReservedAttribs.size() + i] = index;
+				LL_DEBUGS("ShaderLoading") << "Attribute " << name << " assigned to channel " << index << LL_ENDL;
 			}
 		}
-
-		return TRUE;
 	}
-	
-	return FALSE;
+
+	return TRUE;
 }
 
 void LLGLSLShader::mapUniform(GLint index, const vector<string> * uniforms)
@@ -81,6 +81,8 @@ public:
 	void attachObject(GLhandleARB object);
 	void attachObjects(GLhandleARB* objects = NULL, S32 count = 0);
 	BOOL mapAttributes(const std::vector<std::string> * attributes);
+	//read attribute channels back from an already linked program
+	BOOL readAttributeLocations(const std::vector<std::string> * attributes);
 	BOOL mapUniforms(const std::vector<std::string> * uniforms);
 	void mapUniform(GLint index, const std::vector<std::string> * uniforms);
 	void uniform1i(U32 index, GLint i);
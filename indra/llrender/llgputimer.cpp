@@ -0,0 +1,218 @@
+/** 
+ * @file llgputimer.cpp
+ * @brief GL timer queries around render passes
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llgputimer.h"
+
+#include "llfasttimer.h"
+#include "llmath.h"
+#include "llsd.h"
+
+#include "llglheaders.h"
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+
+bool LLGPUTimer::sEnabled = false;
+bool LLGPUTimer::sWantEnabled = false;
+LLGPUTimer::segment_list_t LLGPUTimer::sFrames[LLGPUTimer::FRAME_LAG];
+U32 LLGPUTimer::sCurFrame = 0;
+std::vector<GLuint> LLGPUTimer::sFreeQueries;
+std::vector<LLGPUTimer*> LLGPUTimer::sStack;
+
+LLGPUTimer::LLGPUTimer(const std::string& name)
+:	mName(name),
+	mFrameNS(0),
+	mFrameSegments(0),
+	mTimeMS(0.f),
+	mAverageMS(0.f),
+	mSegments(0)
+{
+	timerList().push_back(this);
+}
+
+//static
+LLGPUTimer::timer_list_t& LLGPUTimer::timerList()
+{
+	// timers are statics in other translation units
+	static timer_list_t timers;
+	return timers;
+}
+
+LLGPUTimer::Scope::Scope(LLGPUTimer& timer)
+:	mActive(sEnabled)
+{
+	if (mActive)
+	{
+		if (!sStack.empty())
+		{
+			endSegment(); // pause the enclosing pass
+		}
+		sStack.push_back(&timer);
+		beginSegment(&timer);
+	}
+}
+
+LLGPUTimer::Scope::~Scope()
+{
+	if (mActive)
+	{
+		endSegment();
+		sStack.pop_back();
+		if (!sStack.empty())
+		{
+			beginSegment(sStack.back());
+		}
+	}
+}
+
+//static
+void LLGPUTimer::beginSegment(LLGPUTimer* timer)
+{
+	Segment segment;
+	segment.mTimer = timer;
+	if (sFreeQueries.empty())
+	{
+		glGenQueriesARB(1, &segment.mQuery);
+	}
+	else
+	{
+		segment.mQuery = sFreeQueries.back();
+		sFreeQueries.pop_back();
+	}
+	sFrames[sCurFrame].push_back(segment);
+	glBeginQueryARB(GL_TIME_ELAPSED, segment.mQuery);
+}
+
+//static
+void LLGPUTimer::endSegment()
+{
+	glEndQueryARB(GL_TIME_ELAPSED);
+}
+
+//static
+void LLGPUTimer::nextFrame()
+{
+	llassert(sStack.empty());
+
+	sCurFrame = (sCurFrame + 1) % FRAME_LAG;
+
+	// this slot is the oldest frame still waiting on the GPU
+	resolveFrame(sFrames[sCurFrame]);
+
+	sEnabled = sWantEnabled && gGLManager.mHasTimerQuery;
+}
+
+//static
+void LLGPUTimer::resolveFrame(segment_list_t& segments)
+{
+	if (segments.empty())
+	{
+		return;
+	}
+
+	// queries finish in order, so the last one tells for the whole frame
+	GLuint available = 0;
+	glGetQueryObjectuivARB(segments.back().mQuery, GL_QUERY_RESULT_AVAILABLE_ARB, &available);
+	if (available)
+	{
+		timer_list_t& timers = timerList();
+		for (timer_list_t::iterator iter = timers.begin(); iter != timers.end(); ++iter)
+		{
+			(*iter)->mFrameNS = 0;
+			(*iter)->mFrameSegments = 0;
+		}
+
+		for (segment_list_t::iterator iter = segments.begin(); iter != segments.end(); ++iter)
+		{
+			// 32 bits of nanoseconds is over 4 seconds, plenty for one pass
+			GLuint ns = 0;
+			glGetQueryObjectuivARB(iter->mQuery, GL_QUERY_RESULT_ARB, &ns);
+			iter->mTimer->mFrameNS += ns;
+			iter->mTimer->mFrameSegments++;
+		}
+
+		for (timer_list_t::iterator iter = timers.begin(); iter != timers.end(); ++iter)
+		{
+			LLGPUTimer* timer = *iter;
+			timer->mTimeMS = (F32)(timer->mFrameNS / 1000000.0);
+			timer->mAverageMS = lerp(timer->mAverageMS, timer->mTimeMS, 0.1f);
+			timer->mSegments = timer->mFrameSegments;
+		}
+	}
+	// else the GPU is more than FRAME_LAG frames behind, skip this frame rather than wait
+
+	for (segment_list_t::iterator iter = segments.begin(); iter != segments.end(); ++iter)
+	{
+		sFreeQueries.push_back(iter->mQuery);
+	}
+	segments.clear();
+}
+
+//static
+void LLGPUTimer::initClass()
+{
+	LLFastTimer::sFrameLogCallback = &LLGPUTimer::logFrame;
+}
+
+//static
+void LLGPUTimer::destroyGL()
+{
+	for (U32 i = 0; i < FRAME_LAG; i++)
+	{
+		for (segment_list_t::iterator iter = sFrames[i].begin(); iter != sFrames[i].end(); ++iter)
+		{
+			sFreeQueries.push_back(iter->mQuery);
+		}
+		sFrames[i].clear();
+	}
+
+	if (!sFreeQueries.empty())
+	{
+		glDeleteQueriesARB(sFreeQueries.size(), &sFreeQueries[0]);
+		sFreeQueries.clear();
+	}
+}
+
+//static
+void LLGPUTimer::logFrame(LLSD& frame)
+{
+	if (!sEnabled)
+	{
+		return;
+	}
+
+	const timer_list_t& timers = timerList();
+	for (timer_list_t::const_iterator iter = timers.begin(); iter != timers.end(); ++iter)
+	{
+		const LLGPUTimer* timer = *iter;
+		std::string name = "GPU " + timer->mName;
+		frame[name]["Time"] = (LLSD::Real)timer->mTimeMS;
+		frame[name]["Calls"] = (LLSD::Integer)timer->mSegments;
+	}
+}
@@ -0,0 +1,109 @@
+/** 
+ * @file llgputimer.h
+ * @brief GL timer queries around render passes
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLGPUTIMER_H
+#define LL_LLGPUTIMER_H
+
+#include <vector>
+
+#include "llgl.h"
+
+class LLSD;
+
+// GPU time of a render pass, measured with GL_ARB_timer_query:
+//
+//   static LLGPUTimer GPU_SHADOWS("Shadows");
+//   ...
+//   LLGPUTimer::Scope gpu_timer(GPU_SHADOWS);
+//
+// GL allows one time elapsed query at a time, so a nested scope pauses the
+// one around it and each timer ends up with its self time, as in
+// LLFastTimerView.  Results are read FRAME_LAG frames later so the CPU never
+// waits on the GPU for them.  Timers must be static, like
+// LLFastTimer::DeclareTimer, and only used on the GL thread.
+class LLGPUTimer
+{
+public:
+	LLGPUTimer(const std::string& name);
+
+	const std::string& getName() const { return mName; }
+	F32 getTimeMS() const { return mTimeMS; }			// last resolved frame
+	F32 getAverageMS() const { return mAverageMS; }
+
+	class Scope
+	{
+	public:
+		Scope(LLGPUTimer& timer);
+		~Scope();
+	private:
+		bool mActive;
+	};
+
+	typedef std::vector<LLGPUTimer*> timer_list_t;
+	static const timer_list_t& getTimers() { return timerList(); }
+
+	static void initClass();	// hooks GPU times into LLFastTimer's performance log
+	static void destroyGL();	// before the context goes away
+
+	// Takes effect from the next frame, and only if the driver has timer queries
+	static void setEnabled(bool enabled) { sWantEnabled = enabled; }
+	static bool isEnabled() { return sEnabled; }
+
+	// call once a frame, after the swap
+	static void nextFrame();
+
+private:
+	enum { FRAME_LAG = 3 };
+
+	struct Segment
+	{
+		LLGPUTimer*	mTimer;
+		GLuint		mQuery;
+	};
+	typedef std::vector<Segment> segment_list_t;
+
+	static timer_list_t& timerList();
+	static void beginSegment(LLGPUTimer* timer);
+	static void endSegment();
+	static void resolveFrame(segment_list_t& segments);
+	static void logFrame(LLSD& frame);
+
+	std::string	mName;
+	U64			mFrameNS;	// accumulated while resolving
+	U32			mFrameSegments;
+	F32			mTimeMS;
+	F32			mAverageMS;
+	U32			mSegments;
+
+	static bool				sEnabled;
+	static bool				sWantEnabled;
+	static segment_list_t	sFrames[FRAME_LAG];
+	static U32				sCurFrame;
+	static std::vector<GLuint>		sFreeQueries;
+	static std::vector<LLGPUTimer*>	sStack;	// open scopes, innermost last
+};
+
+#endif // LL_LLGPUTIMER_H
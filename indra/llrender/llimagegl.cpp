@@ -54,12 +54,17 @@ S32 LLImageGL::sCount					= 0;
 std::list<U32> LLImageGL::sDeadTextureList;
 
 BOOL LLImageGL::sGlobalUseAnisotropic	= FALSE;
+BOOL LLImageGL::sUsePixelBufferUpload	= FALSE;
+BOOL LLImageGL::sCompressTextures		= FALSE;
 F32 LLImageGL::sLastFrameTime			= 0.f;
 BOOL LLImageGL::sAllowReadBackRaw       = FALSE ;
 LLImageGL* LLImageGL::sDefaultGLTexture = NULL ;
 
 std::set<LLImageGL*> LLImageGL::sImageList;
 
+// Pixel unpack buffer shared by all uploads, orphaned on every use
+static U32 sUploadPBO = 0;
+
 //****************************************************************************************************
 //The below for texture auditing use only
 //****************************************************************************************************
@@ -225,6 +230,7 @@ S32 LLImageGL::dataFormatBits(S32 dataformat)
 {
 	switch (dataformat)
 	{
+	  case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:		return 4;
 	  case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:	return 4;
 	  case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:	return 8;
 	  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:	return 8;
@@ -324,6 +330,8 @@ void LLImageGL::destroyGL(BOOL save_state)
 		gGL.getTexUnit(stage)->unbind(LLTexUnit::TT_TEXTURE);
 	}
 	
+	releaseUploadBuffer();
+
 	sAllowReadBackRaw = true ;
 	for (std::set<LLImageGL*>::iterator iter = sImageList.begin();
 		 iter != sImageList.end(); iter++)
@@ -462,6 +470,7 @@ void LLImageGL::init(BOOL usemipmaps)
 	mUseMipMaps = usemipmaps;
 	mHasExplicitFormat = FALSE;
 	mAutoGenMips = FALSE;
+	mAllowCompression = FALSE;
 
 	mIsMask = FALSE;
 	mNeedsAlphaAndPickMask = TRUE ;
@@ -1050,8 +1059,21 @@ BOOL LLImageGL::setSubImage(const U8* datap, S32 data_width, S32 data_height, S3
 		if (!res) llerrs << "LLImageGL::setSubImage(): bindTexture failed" << llendl;
 		stop_glerror();
 
+		// Media textures come through here every frame, straight out of the
+		// plugin's shared memory.  Only the rows of the rect are staged; the
+		// row length set above still applies to the buffer.
+		bool use_pbo = false;
+		if (sUsePixelBufferUpload && mFormatType == GL_UNSIGNED_BYTE)
+		{
+			use_pbo = stageUploadPixels(datap, ((height - 1) * data_width + width) * getComponents());
+		}
+
 		glTexSubImage2D(mTarget, 0, x_pos, y_pos, 
-						width, height, mFormatPrimary, mFormatType, datap);
+						width, height, mFormatPrimary, mFormatType, use_pbo ? NULL : datap);
+		if (use_pbo)
+		{
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		}
 		gGL.getTexUnit(0)->disable();
 		stop_glerror();
 
@@ -1173,16 +1195,85 @@ void LLImageGL::setManualImage(U32 target, S32 miplevel, S32 intformat, S32 widt
 		}
 	}
 
+	const void* src = use_scratch ? scratch : pixels;
+	bool use_pbo = false;
+	if (sUsePixelBufferUpload && src && pixtype == GL_UNSIGNED_BYTE)
+	{
+		S32 bits = 0;
+		switch (pixformat)
+		{
+		  case GL_ALPHA:
+		  case GL_LUMINANCE:		bits = 8; break;
+		  case GL_LUMINANCE_ALPHA:	bits = 16; break;
+		  case GL_RGB:				bits = 24; break;
+		  case GL_RGBA:
+		  case GL_BGRA:				bits = 32; break;
+		  default:					break;
+		}
+		if (bits)
+		{
+			use_pbo = stageUploadPixels(src, (width * height * bits + 7) >> 3);
+		}
+	}
+
 	stop_glerror();
-	glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat, pixtype, use_scratch ? scratch : pixels);
+	glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat, pixtype, use_pbo ? NULL : src);
 	stop_glerror();
 
+	if (use_pbo)
+	{
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+	}
+
 	if (use_scratch)
 	{
 		delete [] scratch;
 	}
 }
 
+//static
+// Copies pixels into the upload PBO and leaves it bound to GL_PIXEL_UNPACK_BUFFER.
+// The buffer is orphaned first, so the copy never waits for the driver to finish
+// the previous transfer and glTexImage2D() can return before the data reaches VRAM.
+bool LLImageGL::stageUploadPixels(const void* pixels, S32 bytes)
+{
+	if (!gGLManager.mHasPixelBufferObject || !gGLManager.mHasVertexBufferObject || bytes <= 0)
+	{
+		return false;
+	}
+
+	if (!sUploadPBO)
+	{
+		glGenBuffersARB(1, &sUploadPBO);
+	}
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, sUploadPBO);
+	glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, bytes, NULL, GL_STREAM_DRAW_ARB);
+	void* dst = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+	if (!dst)
+	{
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		return false;
+	}
+	memcpy(dst, pixels, bytes);
+	if (!glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB))
+	{
+		// contents were lost (e.g. mode switch), upload from client memory instead
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		return false;
+	}
+	return true;
+}
+
+//static
+void LLImageGL::releaseUploadBuffer()
+{
+	if (sUploadPBO)
+	{
+		glDeleteBuffersARB(1, &sUploadPBO);
+		sUploadPBO = 0;
+	}
+}
+
 //create an empty GL texture: just create a texture name
 //the texture is assiciate with some image by calling glTexImage outside LLImageGL
 BOOL LLImageGL::createGLTexture()
@@ -1273,6 +1364,20 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S
 			llerrs << "Bad number of components for texture: " << (U32)getComponents() << llendl;
 		}
 
+		if (sCompressTextures && mAllowCompression &&
+			gGLManager.mHasCompressedTextures && gGLManager.mHasTextureCompressionS3TC)
+		{
+			// Pixel data stays uncompressed, the driver encodes it on upload
+			if (mComponents == 3)
+			{
+				mFormatInternal = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			}
+			else if (mComponents == 4)
+			{
+				mFormatInternal = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			}
+		}
+
 		calcAlphaChannelOffsetAndStride() ;
 	}
 
@@ -1644,16 +1749,22 @@ S32 LLImageGL::getMipBytes(S32 discard_level) const
 	{
 		discard_level = mCurrentDiscardLevel;
 	}
+	// Account for what the texture occupies in video memory, not the pixel data handed to GL
+	LLGLenum format = mFormatPrimary;
+	if (mFormatInternal >= GL_COMPRESSED_RGB_S3TC_DXT1_EXT && mFormatInternal <= GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+	{
+		format = mFormatInternal;
+	}
 	S32 w = mWidth>>discard_level;
 	S32 h = mHeight>>discard_level;
-	S32 res = dataFormatBytes(mFormatPrimary, w, h);
+	S32 res = dataFormatBytes(format, w, h);
 	if (mUseMipMaps)
 	{
 		while (w > 1 && h > 1)
 		{
 			w >>= 1; if (w == 0) w = 1;
 			h >>= 1; if (h == 0) h = 1;
-			res += dataFormatBytes(mFormatPrimary, w, h);
+			res += dataFormatBytes(format, w, h);
 		}
 	}
 	return res;
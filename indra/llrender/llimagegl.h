@@ -100,6 +100,8 @@ public:
 	static void generateTextures(S32 numTextures, U32 *textures);
 	static void deleteTextures(S32 numTextures, U32 *textures, bool immediate = false);
 	static void setManualImage(U32 target, S32 miplevel, S32 intformat, S32 width, S32 height, U32 pixformat, U32 pixtype, const void *pixels);
+	static bool stageUploadPixels(const void* pixels, S32 bytes);
+	static void releaseUploadBuffer();
 
 	BOOL createGLTexture() ;
 	BOOL createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename = 0, BOOL to_create = TRUE, 
@@ -149,6 +151,10 @@ public:
 	BOOL getUseMipMaps() const { return mUseMipMaps; }
 	void setUseMipMaps(BOOL usemips) { mUseMipMaps = usemips; }	
 
+	// Allow the driver to store this texture S3TC compressed when sCompressTextures is on
+	BOOL getAllowCompression() const { return mAllowCompression; }
+	void setAllowCompression(BOOL allow) { mAllowCompression = allow; }
+
 	void updatePickMask(S32 width, S32 height, const U8* data_in);
 	BOOL getMask(const LLVector2 &tc);
 
@@ -193,6 +199,7 @@ private:
 	S8 mUseMipMaps;
 	S8 mHasExplicitFormat; // If false (default), GL format is f(mComponents)
 	S8 mAutoGenMips;
+	S8 mAllowCompression;
 
 	BOOL mIsMask;
 	BOOL mNeedsAlphaAndPickMask;
@@ -244,6 +251,8 @@ public:
 	static U32 sBindCount;					// Tracks number of texture binds for current frame
 	static U32 sUniqueCount;				// Tracks number of unique texture binds for current frame
 	static BOOL sGlobalUseAnisotropic;
+	static BOOL sUsePixelBufferUpload;	// stage texture uploads through a pixel buffer object
+	static BOOL sCompressTextures;		// keep textures that allow it S3TC compressed in video memory
 	static LLImageGL* sDefaultGLTexture ;	
 	static BOOL sAutomatedTest;
 
@@ -171,6 +171,7 @@ void LLTexUnit::activate(void)
 		gGL.flush();
 		glActiveTextureARB(GL_TEXTURE0_ARB + mIndex);
 		gGL.mCurrTextureUnitIndex = mIndex;
+		LLGLState::sStateChanges++;
 	}
 }
 
@@ -197,6 +198,7 @@ void LLTexUnit::enable(eTextureType type)
 		{
 			stop_glerror();
 			glEnable(sGLTextureType[type]);
+			LLGLState::sStateChanges++;
 			stop_glerror();
 		}
 	}
@@ -216,6 +218,7 @@ void LLTexUnit::disable(void)
 			mIndex < gGLManager.mNumTextureUnits)
 		{
 			glDisable(sGLTextureType[mCurrTexType]);
+			LLGLState::sStateChanges++;
 		}
 		
 		mCurrTexType = TT_NONE;
@@ -1007,6 +1010,7 @@ LLRender::LLRender()
 	mQuadCycle(0),
     mMode(LLRender::TRIANGLES),
     mCurrTextureUnitIndex(0),
+    mCoverageAlphaBlend(false),
     mMaxAnisotropy(0.f) 
 {	
 	mTexUnits.reserve(LL_NUM_TEXTURE_LAYERS);
@@ -1592,16 +1596,19 @@ void LLRender::setSceneBlendType(eBlendType type)
 
 void LLRender::setAlphaRejectSettings(eCompareFunc func, F32 value)
 {
-	flush();
-
 	if (LLGLSLShader::sNoFixedFunction)
 	{ //glAlphaFunc is deprecated in OpenGL 3.3
+		// callers follow this with a shader alpha cutoff change
+		flush();
 		return;
 	}
 
 	if (mCurrAlphaFunc != func ||
 		mCurrAlphaFuncVal != value)
 	{
+		// only batched geometry drawn under the old settings needs flushing
+		flush();
+		LLGLState::sStateChanges++;
 		mCurrAlphaFunc = func;
 		mCurrAlphaFuncVal = value;
 		if (func == CF_DEFAULT)
@@ -1643,6 +1650,18 @@ void LLRender::blendFunc(eBlendFactor sfactor, eBlendFactor dfactor)
 {
 	llassert(sfactor < BF_UNDEF);
 	llassert(dfactor < BF_UNDEF);
+	if (mCoverageAlphaBlend && gGLManager.mHasBlendFuncSeparate)
+	{ //additive blends add no coverage, everything else is "over"
+		if (dfactor == BF_ONE)
+		{
+			blendFunc(sfactor, dfactor, BF_ZERO, BF_ONE);
+		}
+		else
+		{
+			blendFunc(sfactor, dfactor, BF_ONE, BF_ONE_MINUS_SOURCE_ALPHA);
+		}
+		return;
+	}
 	if (mCurrBlendColorSFactor != sfactor || mCurrBlendColorDFactor != dfactor ||
 	    mCurrBlendAlphaSFactor != sfactor || mCurrBlendAlphaDFactor != dfactor)
 	{
@@ -1652,6 +1671,7 @@ void LLRender::blendFunc(eBlendFactor sfactor, eBlendFactor dfactor)
 		mCurrBlendAlphaDFactor = dfactor;
 		flush();
 		glBlendFunc(sGLBlendFactor[sfactor], sGLBlendFactor[dfactor]);
+		LLGLState::sStateChanges++;
 	}
 }
 
@@ -1678,6 +1698,20 @@ void LLRender::blendFunc(eBlendFactor color_sfactor, eBlendFactor color_dfactor,
 		flush();
 		glBlendFuncSeparateEXT(sGLBlendFactor[color_sfactor], sGLBlendFactor[color_dfactor],
 				       sGLBlendFactor[alpha_sfactor], sGLBlendFactor[alpha_dfactor]);
+		LLGLState::sStateChanges++;
+	}
+}
+
+void LLRender::setCoverageAlphaBlend(bool enable)
+{
+	if (mCoverageAlphaBlend != enable)
+	{
+		mCoverageAlphaBlend = enable;
+		// make the next blendFunc() set the alpha factors again
+		mCurrBlendColorSFactor = BF_UNDEF;
+		mCurrBlendAlphaSFactor = BF_UNDEF;
+		mCurrBlendColorDFactor = BF_UNDEF;
+		mCurrBlendAlphaDFactor = BF_UNDEF;
 	}
 }
 
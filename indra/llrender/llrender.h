@@ -403,6 +403,10 @@ public:
 	// applies separate blend functions to color and alpha
 	void blendFunc(eBlendFactor color_sfactor, eBlendFactor color_dfactor,
 		       eBlendFactor alpha_sfactor, eBlendFactor alpha_dfactor);
+	// while set, the two factor blendFunc() accumulates coverage in alpha
+	// instead of blending it like color, so drawing into a target cleared
+	// to 0 leaves premultiplied color that composites like the direct draw
+	void setCoverageAlphaBlend(bool enable);
 
 	LLLightState* getLight(U32 index);
 	void setAmbientLightColor(const LLColor4& color);
@@ -461,6 +465,7 @@ private:
 	eBlendFactor mCurrBlendColorDFactor;
 	eBlendFactor mCurrBlendAlphaSFactor;
 	eBlendFactor mCurrBlendAlphaDFactor;
+	bool			mCoverageAlphaBlend;
 
 	F32				mMaxAnisotropy;
 
@@ -28,7 +28,9 @@
 
 #include "llshadermgr.h"
 
+#include "lldir.h"
 #include "llfile.h"
+#include "llmd5.h"
 #include "llrender.h"
 
 #if LL_DARWIN
@@ -47,6 +49,9 @@ using std::pair;
 using std::make_pair;
 using std::string;
 
+//bump whenever the preamble loadShaderFile generates changes, so stale program binaries are ignored
+static const U32 PROGRAM_CACHE_VERSION = 1;
+
 LLShaderMgr * LLShaderMgr::sInstance = NULL;
 
 LLShaderMgr::LLShaderMgr()
@@ -823,6 +828,19 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 	}
 	stop_glerror();
 
+	//digest the full source for the program binary cache
+	char hex[MD5HEX_STR_SIZE];
+	if (ret)
+	{
+		LLMD5 md5;
+		for (GLuint i = 0; i < count; i++)
+		{
+			md5.update((const unsigned char*) text[i], strlen(text[i]));
+		}
+		md5.finalize();
+		md5.hex_digest(hex);
+	}
+
 	//free memory
 	for (GLuint i = 0; i < count; i++)
 	{
@@ -834,6 +852,7 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 	{
 		// Add shader file to map
 		mShaderObjects[filename] = ret;
+		mShaderSourceHashes[filename] = hex;
 		shader_level = try_gpu_class;
 	}
 	else
@@ -848,6 +867,170 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 	return ret;
 }
 
+void LLShaderMgr::updateFeatureHash()
+{
+	LLMD5 md5;
+	for (std::map<std::string, GLhandleARB>::iterator iter = mShaderObjects.begin(); iter != mShaderObjects.end(); ++iter)
+	{
+		md5.update(iter->first);
+		md5.update(mShaderSourceHashes[iter->first]);
+	}
+	md5.finalize();
+
+	char hex[MD5HEX_STR_SIZE];
+	md5.hex_digest(hex);
+	mFeatureHash = hex;
+}
+
+std::string LLShaderMgr::getProgramHash(LLGLSLShader * shader)
+{
+	if (mProgramCacheDir.empty() || !gGLManager.mHasProgramBinary)
+	{
+		return std::string();
+	}
+
+	LLMD5 md5;
+	md5.update(llformat("%d ", PROGRAM_CACHE_VERSION));
+	md5.update(gGLManager.mGLVendor);
+	md5.update(gGLManager.mGLRenderer);
+	md5.update(gGLManager.getRawGLString());
+	md5.update(mFeatureHash);
+
+	md5.update(shader->mName);
+	const LLShaderFeatures& f = shader->mFeatures;
+	md5.update(llformat("%d %d %d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d", shader->mShaderLevel, f.mIndexedTextureChannels,
+		f.atmosphericHelpers, f.calculatesLighting, f.calculatesAtmospherics, f.hasLighting, f.isAlphaLighting, f.isShiny,
+		f.isFullbright, f.isSpecular, f.hasWaterFog, f.hasTransport, f.hasSkinning, f.hasObjectSkinning, f.hasAtmospherics,
+		f.hasGamma, f.disableTextureIndex, f.hasAlphaMask));
+
+	for (std::map<std::string,std::string>::iterator iter = mDefinitions.begin(); iter != mDefinitions.end(); ++iter)
+	{
+		md5.update(iter->first + " " + iter->second);
+	}
+
+	for (U32 i = 0; i < mReservedAttribs.size(); ++i)
+	{
+		md5.update(mReservedAttribs[i]);
+	}
+
+	//hash the same files loadShaderFile would pick for this shader level
+	for (U32 i = 0; i < shader->mShaderFiles.size(); ++i)
+	{
+		const std::string& filename = shader->mShaderFiles[i].first;
+		LLFILE* file = NULL;
+		S32 gpu_class;
+		for (gpu_class = shader->mShaderLevel; gpu_class > 0; gpu_class--)
+		{
+			std::stringstream fname;
+			fname << getShaderDirPrefix();
+			fname << gpu_class << "/" << filename;
+			file = LLFile::fopen(fname.str(), "rb");		/* Flawfinder: ignore */
+			if (file)
+			{
+				break;
+			}
+		}
+
+		if (file == NULL)
+		{ //let the normal compile path report the missing file
+			return std::string();
+		}
+
+		md5.update(llformat("%s %d %d", filename.c_str(), shader->mShaderFiles[i].second, gpu_class));
+		md5.update(file); // closes file
+	}
+
+	md5.finalize();
+	char hex[MD5HEX_STR_SIZE];
+	md5.hex_digest(hex);
+	return hex;
+}
+
+BOOL LLShaderMgr::loadCachedProgram(LLGLSLShader * shader, const std::string& hash)
+{
+#if !LL_DARWIN
+	std::string filename = mProgramCacheDir + gDirUtilp->getDirDelimiter() + hash + ".bin";
+
+	BOOL success = FALSE;
+	LLFILE* file = LLFile::fopen(filename, "rb");		/* Flawfinder: ignore */
+	if (file)
+	{
+		U32 header[4]; // version, binary format, indexed texture channels, binary size
+		if (fread(header, sizeof(U32), 4, file) == 4 &&
+			header[0] == PROGRAM_CACHE_VERSION && header[3] > 0)
+		{
+			std::vector<U8> data(header[3]);
+			if (fread(&data[0], 1, header[3], file) == header[3])
+			{
+				glProgramBinary(shader->mProgramObject, header[1], &data[0], header[3]);
+
+				GLint linked = GL_FALSE;
+				glGetObjectParameterivARB(shader->mProgramObject, GL_OBJECT_LINK_STATUS_ARB, &linked);
+				if (linked == GL_TRUE)
+				{
+					shader->mFeatures.mIndexedTextureChannels = (S32) header[2];
+					success = TRUE;
+				}
+			}
+		}
+		fclose(file);
+
+		if (!success)
+		{ //driver or source changed underneath this binary, it will be replaced after linking
+			LL_INFOS("ShaderLoading") << "Discarding cached program binary for " << shader->mName << LL_ENDL;
+			LLFile::remove(filename);
+		}
+	}
+
+	//clear any error left by a rejected binary
+	glGetError();
+
+	if (!success)
+	{
+		glProgramParameteri(shader->mProgramObject, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	return success;
+#else
+	return FALSE;
+#endif
+}
+
+void LLShaderMgr::saveCachedProgram(LLGLSLShader * shader, const std::string& hash)
+{
+#if !LL_DARWIN
+	GLint length = 0;
+	glGetObjectParameterivARB(shader->mProgramObject, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<U8> data(length);
+	GLenum format = 0;
+	glGetProgramBinary(shader->mProgramObject, length, NULL, &format, &data[0]);
+	if (glGetError() != GL_NO_ERROR)
+	{
+		return;
+	}
+
+	std::string filename = mProgramCacheDir + gDirUtilp->getDirDelimiter() + hash + ".bin";
+	LLFILE* file = LLFile::fopen(filename, "wb");		/* Flawfinder: ignore */
+	if (file)
+	{
+		U32 header[4] = { PROGRAM_CACHE_VERSION, format, (U32) shader->mFeatures.mIndexedTextureChannels, (U32) length };
+		if (fwrite(header, sizeof(U32), 4, file) != 4 ||
+			fwrite(&data[0], 1, length, file) != (size_t) length)
+		{
+			fclose(file);
+			LLFile::remove(filename);
+			return;
+		}
+		fclose(file);
+	}
+#endif
+}
+
 BOOL LLShaderMgr::linkProgramObject(GLhandleARB obj, BOOL suppress_errors) 
 {
 	//check for errors
@@ -175,6 +175,16 @@ public:
 	BOOL	validateProgramObject(GLhandleARB obj);
 	GLhandleARB loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, S32 texture_index_channels = -1);
 
+	// Linked program binary cache, keyed by getProgramHash().  The hash is empty
+	// when the cache is disabled or the driver can't hand back program binaries.
+	std::string getProgramHash(LLGLSLShader * shader);
+	// Returns TRUE if shader's program object was linked from the cache.  On a miss
+	// the program is flagged so saveCachedProgram can read its binary after linking.
+	BOOL	loadCachedProgram(LLGLSLShader * shader, const std::string& hash);
+	void	saveCachedProgram(LLGLSLShader * shader, const std::string& hash);
+	// Digest the shader objects compiled so far, call once the shared feature objects are loaded
+	void	updateFeatureHash();
+
 	// Implemented in the application to actually point to the shader directory.
 	virtual std::string getShaderDirPrefix(void) = 0; // Pure Virtual
 
@@ -193,6 +203,15 @@ public:
 	//preprocessor definitions (name/value)
 	std::map<std::string, std::string> mDefinitions;
 
+	//source digest of each compiled shader object, by file name
+	std::map<std::string, std::string> mShaderSourceHashes;
+
+	//digest of the shared feature objects every program links against
+	std::string mFeatureHash;
+
+	//directory linked program binaries are kept in, empty disables the cache
+	std::string mProgramCacheDir;
+
 protected:
 
 	// our parameter manager singleton instance
@@ -59,6 +59,9 @@ LLVBOPool LLVertexBuffer::sStreamIBOPool(GL_STREAM_DRAW_ARB, GL_ELEMENT_ARRAY_BU
 LLVBOPool LLVertexBuffer::sDynamicIBOPool(GL_DYNAMIC_DRAW_ARB, GL_ELEMENT_ARRAY_BUFFER_ARB);
 U32 LLVBOPool::sBytesPooled = 0;
 
+LLVBORing LLVertexBuffer::sStreamVBORing(GL_ARRAY_BUFFER_ARB, 4*1024*1024);
+LLVBORing LLVertexBuffer::sStreamIBORing(GL_ELEMENT_ARRAY_BUFFER_ARB, 1024*1024);
+
 LLPrivateMemoryPool* LLVertexBuffer::sPrivatePoolp = NULL;
 U32 LLVertexBuffer::sBindCount = 0;
 U32 LLVertexBuffer::sSetCount = 0;
@@ -76,6 +79,7 @@ bool LLVertexBuffer::sIBOActive = false;
 U32 LLVertexBuffer::sAllocatedBytes = 0;
 bool LLVertexBuffer::sMapped = false;
 bool LLVertexBuffer::sUseStreamDraw = true;
+bool LLVertexBuffer::sUseStreamRing = true;
 bool LLVertexBuffer::sUseVAO = false;
 bool LLVertexBuffer::sPreferStreamDraw = false;
 
@@ -121,7 +125,7 @@ public:
 #ifdef GL_ARB_sync
 		if (mSync)
 		{
-			while (glClientWaitSync(mSync, 0, FENCE_WAIT_TIME_NANOSECONDS) == GL_TIMEOUT_EXPIRED)
+			while (glClientWaitSync(mSync, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIME_NANOSECONDS) == GL_TIMEOUT_EXPIRED)
 			{ //track the number of times we've waited here
 				static S32 waits = 0;
 				waits++;
@@ -245,6 +249,145 @@ void LLVBOPool::cleanup()
 	}
 }
 
+//============================================================================
+
+LLVBORing::LLVBORing(U32 vboType, U32 size)
+	: mType(vboType),
+	mSize(size),
+	mName(0),
+	mHead(0),
+	mSegment(0),
+	mSerial(0),
+	mValidSerial(0)
+{
+	for (U32 i = 0; i < NUM_SEGMENTS; ++i)
+	{
+		mFences[i] = NULL;
+	}
+}
+
+bool LLVBORing::init()
+{
+	if (mName)
+	{
+		return true;
+	}
+
+	if (!gGLManager.mHasVertexBufferObject)
+	{
+		return false;
+	}
+
+	glGenBuffersARB(1, &mName);
+	glBindBufferARB(mType, mName);
+	glBufferDataARB(mType, mSize, 0, GL_STREAM_DRAW_ARB);
+	glBindBufferARB(mType, 0);
+	LLVertexBuffer::sAllocatedBytes += mSize;
+
+	if (gGLManager.mHasSync)
+	{
+		for (U32 i = 0; i < NUM_SEGMENTS; ++i)
+		{
+			mFences[i] = new LLGLSyncFence();
+		}
+	}
+
+	mHead = 0;
+	mSegment = 0;
+	mValidSerial = mSerial;
+
+	return true;
+}
+
+void LLVBORing::cleanup()
+{
+	if (mName)
+	{
+		glDeleteBuffersARB(1, &mName);
+		LLVertexBuffer::sAllocatedBytes -= mSize;
+		mName = 0;
+	}
+
+	for (U32 i = 0; i < NUM_SEGMENTS; ++i)
+	{
+		delete mFences[i];
+		mFences[i] = NULL;
+	}
+
+	//anything uploaded to the old buffer is gone
+	mValidSerial = mSerial;
+}
+
+U32 LLVBORing::allocate(U32 size, U64& serial)
+{
+	llassert(size <= getMaxUpload());
+
+	U32 segment_size = mSize / NUM_SEGMENTS;
+	U32 segment_end = (mSegment + 1) * segment_size;
+
+	if (mHead + size > segment_end)
+	{ //uploads never straddle segments, skip to the start of the next one
+		mSerial += segment_end - mHead;
+		mHead = segment_end % mSize;
+
+		//fence off draws that read the segment we're leaving
+		if (mFences[mSegment])
+		{
+			mFences[mSegment]->placeFence();
+		}
+
+		mSegment = (mSegment + 1) % NUM_SEGMENTS;
+
+		//make sure the GPU is done with the one we're entering
+		if (mFences[mSegment])
+		{
+			mFences[mSegment]->wait();
+		}
+		else if (mSegment == 0)
+		{ //no sync objects, orphan the whole buffer on wrap
+			glBufferDataARB(mType, mSize, 0, GL_STREAM_DRAW_ARB);
+		}
+
+		//only the current segment may be drawn from, anything older than this
+		//must be uploaded again so the fence above covers every draw that reads it
+		mValidSerial = mSerial;
+	}
+
+	U32 offset = mHead;
+	serial = mSerial;
+
+	mHead += size;
+	mSerial += size;
+
+	return offset;
+}
+
+U32 LLVBORing::upload(const volatile U8* data, U32 size, U64& serial)
+{
+	//keep every upload 16 byte aligned
+	U32 offset = allocate((size + 0xF) & ~0xF, serial);
+
+#ifdef GL_ARB_map_buffer_range
+	if (gGLManager.mHasMapBufferRange)
+	{ //range is fenced (or freshly orphaned), so no need for the driver to sync
+		U8* dst = (U8*) glMapBufferRange(mType, offset, size, 
+			GL_MAP_WRITE_BIT | 
+			GL_MAP_INVALIDATE_RANGE_BIT |
+			GL_MAP_UNSYNCHRONIZED_BIT);
+
+		if (dst)
+		{
+			memcpy(dst, (U8*) data, size);
+			glUnmapBufferARB(mType);
+			return offset;
+		}
+	}
+#endif
+
+	glBufferSubDataARB(mType, offset, size, (U8*) data);
+	return offset;
+}
+
 
 //NOTE: each component must be AT LEAST 4 bytes in size to avoid a performance penalty on AMD hardware
 S32 LLVertexBuffer::sTypeSize[LLVertexBuffer::TYPE_MAX] =
@@ -605,6 +748,73 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indi
 	placeFence();
 }
 
+void LLVertexBuffer::multiDrawRange(U32 mode, U32 start, U32 end, const U32* counts, const U32* indices_offsets, U32 draw_count) const
+{
+	if (draw_count == 1 || !gGLManager.mHasMultiDrawArrays)
+	{
+		for (U32 i = 0; i < draw_count; ++i)
+		{
+			drawRange(mode, start, end, counts[i], indices_offsets[i]);
+		}
+		return;
+	}
+
+	for (U32 i = 0; i < draw_count; ++i)
+	{
+		validateRange(start, end, counts[i], indices_offsets[i]);
+	}
+
+	mMappable = false;
+	gGL.syncMatrices();
+
+	llassert(!LLGLSLShader::sNoFixedFunction || LLGLSLShader::sCurBoundShaderPtr != NULL);
+
+	if (mGLArray)
+	{
+		if (mGLArray != sGLRenderArray)
+		{
+			llerrs << "Wrong vertex array bound." << llendl;
+		}
+	}
+	else
+	{
+		if (mGLIndices != sGLRenderIndices)
+		{
+			llerrs << "Wrong index buffer bound." << llendl;
+		}
+
+		if (mGLBuffer != sGLRenderBuffer)
+		{
+			llerrs << "Wrong vertex buffer bound." << llendl;
+		}
+	}
+
+	if (mode >= LLRender::NUM_MODES)
+	{
+		llerrs << "Invalid draw mode: " << mode << llendl;
+		return;
+	}
+
+	static std::vector<GLsizei> gl_counts;
+	static std::vector<const GLvoid*> gl_indices;
+
+	gl_counts.resize(draw_count);
+	gl_indices.resize(draw_count);
+
+	for (U32 i = 0; i < draw_count; ++i)
+	{
+		gl_counts[i] = counts[i];
+		gl_indices[i] = ((U16*) getIndicesPointer()) + indices_offsets[i];
+	}
+
+	stop_glerror();
+#if !LL_DARWIN
+	glMultiDrawElementsEXT(sGLMode[mode], &gl_counts[0], GL_UNSIGNED_SHORT, &gl_indices[0], draw_count);
+#endif
+	stop_glerror();
+	placeFence();
+}
+
 void LLVertexBuffer::draw(U32 mode, U32 count, U32 indices_offset) const
 {
 	llassert(!LLGLSLShader::sNoFixedFunction || LLGLSLShader::sCurBoundShaderPtr != NULL);
@@ -743,6 +953,8 @@ void LLVertexBuffer::cleanupClass()
 	sDynamicIBOPool.cleanup();
 	sStreamVBOPool.cleanup();
 	sDynamicVBOPool.cleanup();
+	sStreamVBORing.cleanup();
+	sStreamIBORing.cleanup();
 
 	if(sPrivatePoolp)
 	{
@@ -814,7 +1026,12 @@ LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage) :
 	mIndexLocked(false),
 	mFinal(false),
 	mEmpty(true),
+	mRingVertices(false),
+	mRingIndices(false),
+	mRingArrayDirty(false),
 	mMappable(false),
+	mRingSerial(0),
+	mRingIndexSerial(0),
 	mFence(NULL)
 {
 	LLMemType mt2(LLMemType::MTYPE_VERTEX_CONSTRUCTOR);
@@ -927,11 +1144,27 @@ void LLVertexBuffer::waitFence() const
 
 //----------------------------------------------------------------------------
 
+bool LLVertexBuffer::useStreamRing(const LLVBORing& ring, U32 size) const
+{
+	return sUseStreamRing && 
+		mUsage == GL_STREAM_DRAW_ARB && 
+		size <= ring.getMaxUpload();
+}
+
 void LLVertexBuffer::genBuffer(U32 size)
 {
 	mSize = nhpo2(size);
 
-	if (mUsage == GL_STREAM_DRAW_ARB)
+	mRingVertices = useStreamRing(sStreamVBORing, mSize) && sStreamVBORing.init();
+
+	if (mRingVertices)
+	{ //client copy only, uploads go to the shared ring
+		mGLBuffer = sStreamVBORing.getName();
+		mMappedData = (U8*) ll_aligned_malloc_16(mSize);
+		mAlignedOffset = 0;
+		mRingSerial = 0;
+	}
+	else if (mUsage == GL_STREAM_DRAW_ARB)
 	{
 		mMappedData = sStreamVBOPool.allocate(mGLBuffer, mSize);
 	}
@@ -947,7 +1180,16 @@ void LLVertexBuffer::genIndices(U32 size)
 {
 	mIndicesSize = nhpo2(size);
 
-	if (mUsage == GL_STREAM_DRAW_ARB)
+	mRingIndices = useStreamRing(sStreamIBORing, mIndicesSize) && sStreamIBORing.init();
+
+	if (mRingIndices)
+	{
+		mGLIndices = sStreamIBORing.getName();
+		mMappedIndexData = (U8*) ll_aligned_malloc_16(mIndicesSize);
+		mAlignedIndexOffset = 0;
+		mRingIndexSerial = 0;
+	}
+	else if (mUsage == GL_STREAM_DRAW_ARB)
 	{
 		mMappedIndexData = sStreamIBOPool.allocate(mGLIndices, mIndicesSize);
 	}
@@ -961,7 +1203,13 @@ void LLVertexBuffer::genIndices(U32 size)
 
 void LLVertexBuffer::releaseBuffer()
 {
-	if (mUsage == GL_STREAM_DRAW_ARB)
+	if (mRingVertices)
+	{
+		ll_aligned_free_16((void*) mMappedData);
+		mRingVertices = false;
+		mAlignedOffset = 0;
+	}
+	else if (mUsage == GL_STREAM_DRAW_ARB)
 	{
 		sStreamVBOPool.release(mGLBuffer, mMappedData, mSize);
 	}
@@ -978,7 +1226,13 @@ void LLVertexBuffer::releaseBuffer()
 
 void LLVertexBuffer::releaseIndices()
 {
-	if (mUsage == GL_STREAM_DRAW_ARB)
+	if (mRingIndices)
+	{
+		ll_aligned_free_16((void*) mMappedIndexData);
+		mRingIndices = false;
+		mAlignedIndexOffset = 0;
+	}
+	else if (mUsage == GL_STREAM_DRAW_ARB)
 	{
 		sStreamIBOPool.release(mGLIndices, mMappedIndexData, mIndicesSize);
 	}
@@ -1256,6 +1510,10 @@ void LLVertexBuffer::setupVertexArray()
 	bindGLBuffer(true);
 	bindGLIndices(true);
 
+	//stream ring buffers keep their vertex data at mAlignedOffset in the shared buffer
+	ptrdiff_t base = mRingVertices ? mAlignedOffset : 0;
+	mRingArrayDirty = false;
+
 	for (U32 i = 0; i < TYPE_MAX; ++i)
 	{
 		if (mTypeMask & (1 << i))
@@ -1268,13 +1526,13 @@ void LLVertexBuffer::setupVertexArray()
 				//glVertexattribIPointer requires GLSL 1.30 or later
 				if (gGLManager.mGLSLVersionMajor > 1 || gGLManager.mGLSLVersionMinor >= 30)
 				{
-					glVertexAttribIPointer(i, attrib_size[i], attrib_type[i], sTypeSize[i], (void*) mOffsets[i]); 
+					glVertexAttribIPointer(i, attrib_size[i], attrib_type[i], sTypeSize[i], (void*) (base + mOffsets[i])); 
 				}
 #endif
 			}
 			else
 			{
-				glVertexAttribPointerARB(i, attrib_size[i], attrib_type[i], attrib_normalized[i], sTypeSize[i], (void*) mOffsets[i]); 
+				glVertexAttribPointerARB(i, attrib_size[i], attrib_type[i], attrib_normalized[i], sTypeSize[i], (void*) (base + mOffsets[i])); 
 			}
 		}
 		else
@@ -1708,7 +1966,12 @@ void LLVertexBuffer::unmapBuffer()
 		bindGLBuffer(true);
 		updated_all = mIndexLocked; //both vertex and index buffers done updating
 
-		if(!mMappable)
+		if (mRingVertices)
+		{ //client copy holds the whole buffer, put all of it in a fresh range of the ring
+			uploadVerticesToRing();
+			mMappedVertexRegions.clear();
+		}
+		else if(!mMappable)
 		{
 			if (!mMappedVertexRegions.empty())
 			{
@@ -1775,7 +2038,12 @@ void LLVertexBuffer::unmapBuffer()
 	{
 		LLFastTimer t(FTM_IBO_UNMAP);
 		bindGLIndices();
-		if(!mMappable)
+		if (mRingIndices)
+		{
+			uploadIndicesToRing();
+			mMappedIndexRegions.clear();
+		}
+		else if(!mMappable)
 		{
 			if (!mMappedIndexRegions.empty())
 			{
@@ -1844,6 +2112,60 @@ void LLVertexBuffer::unmapBuffer()
 	}
 }
 
+void LLVertexBuffer::uploadVerticesToRing()
+{
+	S32 offsets[TYPE_MAX];
+	U32 size = calcOffsets(mTypeMask, offsets, mNumVerts);
+
+	if (sStreamVBORing.init() && mGLBuffer != sStreamVBORing.getName())
+	{ //ring was recreated by cleanupClass
+		mGLBuffer = sStreamVBORing.getName();
+		bindGLBuffer(true);
+	}
+
+	stop_glerror();
+	mAlignedOffset = sStreamVBORing.upload(mMappedData, llmin(size, (U32) mSize), mRingSerial);
+	stop_glerror();
+
+	mRingArrayDirty = true;
+}
+
+void LLVertexBuffer::uploadIndicesToRing()
+{
+	U32 size = llmin((U32) (sizeof(U16) * mNumIndices), (U32) mIndicesSize);
+
+	if (sStreamIBORing.init() && mGLIndices != sStreamIBORing.getName())
+	{
+		mGLIndices = sStreamIBORing.getName();
+		bindGLIndices(true);
+	}
+
+	stop_glerror();
+	mAlignedIndexOffset = sStreamIBORing.upload(mMappedIndexData, size, mRingIndexSerial);
+	stop_glerror();
+}
+
+void LLVertexBuffer::refreshStreamRing()
+{
+	//draws may only read from the ring segment being filled, copy data from older segments forward
+	if (mRingVertices && !sStreamVBORing.isValid(mRingSerial))
+	{
+		bindGLBuffer(true);
+		uploadVerticesToRing();
+	}
+
+	if (mRingIndices && !sStreamIBORing.isValid(mRingIndexSerial))
+	{
+		bindGLIndices(true);
+		uploadIndicesToRing();
+	}
+
+	if (mGLArray && mRingArrayDirty)
+	{ //VAO attribute pointers are relative to the vertex data's place in the ring
+		setupVertexArray();
+	}
+}
+
 //----------------------------------------------------------------------------
 
 template <class T,S32 type> struct VertexBufferStrider
@@ -2038,6 +2360,11 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 {
 	flush();
 
+	if (mRingVertices || mRingIndices)
+	{
+		refreshStreamRing();
+	}
+
 	LLMemType mt2(LLMemType::MTYPE_VERTEX_SET_BUFFER);
 	//set up pointers if the data mask is different ...
 	bool setup = (sLastMask != data_mask);
@@ -2081,7 +2408,8 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 			const bool bindBuffer = bindGLBuffer();
 			const bool bindIndices = bindGLIndices();
 			
-			setup = setup || bindBuffer || bindIndices;
+			//buffers in the stream ring share a GL name, so a bind doesn't tell us the pointers are current
+			setup = setup || bindBuffer || bindIndices || mRingVertices;
 		}
 
 		bool error = false;
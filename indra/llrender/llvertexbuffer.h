@@ -87,10 +87,61 @@ public:
 class LLGLFence
 {
 public:
+	virtual ~LLGLFence() {}
 	virtual void placeFence() = 0;
 	virtual void wait() = 0;
 };
 
+//============================================================================
+// one large GL buffer shared by small streaming buffers
+// each upload takes the next range of the ring instead of respecifying a buffer
+// the GPU may still be reading from; a fence is placed as each segment is
+// filled and waited on before that segment is written again (without sync
+// objects the whole buffer is orphaned on wrap instead)
+// draws only read from the segment being filled, buffers whose data is in an
+// older segment upload it again before drawing (see isValid)
+class LLVBORing
+{
+public:
+	enum
+	{
+		NUM_SEGMENTS = 4
+	};
+
+	LLVBORing(U32 vboType, U32 size);
+	
+	const U32 mType;
+	const U32 mSize;
+
+	//create the GL buffer if needed, returns false if the ring can't be used
+	bool init();
+
+	//destroy the GL buffer and fences
+	void cleanup();
+
+	U32 getName() const						{ return mName; }
+
+	//largest upload that may be placed in the ring
+	U32 getMaxUpload() const				{ return mSize / NUM_SEGMENTS; }
+
+	//copy size bytes into the ring, ring buffer must be bound to mType
+	//returns offset of the copy in the ring buffer, serial identifies the upload for isValid
+	U32 upload(const volatile U8* data, U32 size, U64& serial);
+
+	//true if the upload identified by serial is in the segment being filled
+	bool isValid(U64 serial) const			{ return serial >= mValidSerial; }
+
+private:
+	U32 allocate(U32 size, U64& serial);
+
+	U32 mName;
+	U32 mHead;
+	U32 mSegment;
+	U64 mSerial; //total bytes consumed (including skipped tail bytes)
+	U64 mValidSerial; //uploads before this serial may have been overwritten
+	LLGLFence* mFences[NUM_SEGMENTS];
+};
+
 //============================================================================
 // base class 
 class LLPrivateMemoryPool;
@@ -124,7 +175,11 @@ public:
 	static LLVBOPool sStreamIBOPool;
 	static LLVBOPool sDynamicIBOPool;
 
+	static LLVBORing sStreamVBORing;
+	static LLVBORing sStreamIBORing;
+
 	static bool	sUseStreamDraw;
+	static bool sUseStreamRing;
 	static bool sUseVAO;
 	static bool	sPreferStreamDraw;
 
@@ -209,6 +264,10 @@ protected:
 	void	updateNumIndices(S32 nindices); 
 	bool	useVBOs() const;
 	void	unmapBuffer();
+	bool	useStreamRing(const LLVBORing& ring, U32 size) const;
+	void	uploadVerticesToRing();
+	void	uploadIndicesToRing();
+	void	refreshStreamRing();
 		
 public:
 	LLVertexBuffer(U32 typemask, S32 usage);
@@ -265,6 +324,8 @@ public:
 	void draw(U32 mode, U32 count, U32 indices_offset) const;
 	void drawArrays(U32 mode, U32 offset, U32 count) const;
 	void drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const;
+	//draw several index ranges that all reference vertices in [start, end] with one call where supported
+	void multiDrawRange(U32 mode, U32 start, U32 end, const U32* counts, const U32* indices_offsets, U32 draw_count) const;
 
 	//for debugging, validate data in given range is valid
 	void validateRange(U32 start, U32 end, U32 count, U32 offset) const;
@@ -296,11 +357,17 @@ protected:
 	U32		mIndexLocked : 1;			// if true, index buffer is being or has been written to in client memory
 	U32		mFinal : 1;			// if true, buffer can not be mapped again
 	U32		mEmpty : 1;			// if true, client buffer is empty (or NULL). Old values have been discarded.	
+	U32		mRingVertices : 1;	// if true, mGLBuffer is sStreamVBORing and vertex data lives at mAlignedOffset
+	U32		mRingIndices : 1;	// if true, mGLIndices is sStreamIBORing and index data lives at mAlignedIndexOffset
+	U32		mRingArrayDirty : 1; // if true, VAO pointers do not match mAlignedOffset
 	
 	mutable bool	mMappable;     // if true, use memory mapping to upload data (otherwise doublebuffer and use glBufferSubData)
 
 	S32		mOffsets[TYPE_MAX];
 
+	U64		mRingSerial;		// serial of the last vertex upload to sStreamVBORing
+	U64		mRingIndexSerial;	// serial of the last index upload to sStreamIBORing
+
 	std::vector<MappedRegion> mMappedVertexRegions;
 	std::vector<MappedRegion> mMappedIndexRegions;
 
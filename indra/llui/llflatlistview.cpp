@@ -351,7 +351,28 @@ void LLFlatListView::sort()
 		return;
 	}
 
-	mItemPairs.sort(ComparatorAdaptor(*mItemComparator));
+	// Periodic re-sorts mostly find the items already in order, and the
+	// relayout is the expensive part, so skip both when nothing is out of place.
+	ComparatorAdaptor comparator(*mItemComparator);
+	pairs_iterator_t prev_it = mItemPairs.begin();
+	pairs_iterator_t it = prev_it;
+	if (it != mItemPairs.end())
+	{
+		++it;
+	}
+	for (; it != mItemPairs.end(); prev_it = it++)
+	{
+		if (comparator(*it, *prev_it))
+		{
+			break;
+		}
+	}
+	if (it == mItemPairs.end())
+	{
+		return;
+	}
+
+	mItemPairs.sort(comparator);
 	rearrangeItems();
 }
 
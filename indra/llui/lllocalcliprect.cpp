@@ -71,6 +71,12 @@ void LLScreenClipRect::pushClipRect(const LLRect& rect)
 	sClipRectStack.push(combined_clip_rect);
 }
 
+//static 
+BOOL LLScreenClipRect::isVisible(const LLRect& screen_rect)
+{
+	return sClipRectStack.empty() || sClipRectStack.top().overlaps(screen_rect);
+}
+
 //static 
 void LLScreenClipRect::popClipRect()
 {
@@ -41,6 +41,10 @@ public:
 	LLScreenClipRect(const LLRect& rect, BOOL enabled = TRUE);
 	virtual ~LLScreenClipRect();
 
+	// FALSE if screen_rect lies entirely outside the current clip region,
+	// so nothing drawn in it could show
+	static BOOL isVisible(const LLRect& screen_rect);
+
 private:
 	static void pushClipRect(const LLRect& rect);
 	static void popClipRect();
@@ -1578,7 +1578,15 @@ void LLNotifications::add(const LLNotificationPtr pNotif)
 		llerrs << "Notification added a second time to the master notification channel." << llendl;
 	}
 
+	// channels find() the notification while the add is still going
+	// through, so it has to be in the index first
+	mItemsByID[pNotif->id()] = pNotif;
 	updateItem(LLSD().with("sigtype", "add").with("id", pNotif->id()), pNotif);
+	if (mItems.find(pNotif) == mItems.end())
+	{
+		// a handler rejected it, e.g. a duplicate of a unique notification
+		mItemsByID.erase(pNotif->id());
+	}
 }
 
 void LLNotifications::cancel(LLNotificationPtr pNotif)
@@ -1630,19 +1638,24 @@ void LLNotifications::update(const LLNotificationPtr pNotif)
 
 LLNotificationPtr LLNotifications::find(LLUUID uuid)
 {
-	LLNotificationPtr target = LLNotificationPtr(new LLNotification(uuid));
-	LLNotificationSet::iterator it=mItems.find(target);
-	if (it == mItems.end())
+	notification_id_map_t::iterator it = mItemsByID.find(uuid);
+	if (it == mItemsByID.end())
 	{
 		LL_DEBUGS("Notifications") << "Tried to dereference uuid '" << uuid << "' as a notification key but didn't find it." << llendl;
 		return LLNotificationPtr((LLNotification*)NULL);
 	}
 	else
 	{
-		return *it;
+		return it->second;
 	}
 }
 
+//virtual
+void LLNotifications::onDelete(LLNotificationPtr p)
+{
+	mItemsByID.erase(p->id());
+}
+
 void LLNotifications::forEachNotification(NotificationProcess process)
 {
 	std::for_each(mItems.begin(), mItems.end(), process);
@@ -95,6 +95,7 @@
 #include "llevents.h"
 #include "llfunctorregistry.h"
 #include "llpointer.h"
+#include "llflathashmap.h"
 #include "llinitparam.h"
 #include "llnotificationslistener.h"
 #include "llnotificationptr.h"
@@ -952,6 +953,9 @@ private:
 	bool uniqueFilter(LLNotificationPtr pNotification);
 	bool uniqueHandler(const LLSD& payload);
 	bool failedUniquenessTest(const LLSD& payload);
+
+	/*virtual*/ void onDelete(LLNotificationPtr p);
+
 	LLNotificationChannelPtr pHistoryChannel;
 	LLNotificationChannelPtr pExpirationChannel;
 	
@@ -962,6 +966,11 @@ private:
 	std::string mFileName;
 	
 	LLNotificationMap mUniqueNotifications;
+
+	// every channel looks its notification up by id on every change, so
+	// find() uses this instead of building a key to search mItems with
+	typedef LLFlatHashMap<LLUUID, LLNotificationPtr> notification_id_map_t;
+	notification_id_map_t mItemsByID;
 	
 	typedef std::map<std::string, std::string> GlobalStringMap;
 	GlobalStringMap mGlobalStrings;
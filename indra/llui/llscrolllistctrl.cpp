@@ -110,6 +110,89 @@ struct SortScrollListItem
 	const sort_order_t& mSortOrders;
 };
 
+// Same ordering as SortScrollListItem without a sort signal, but on cell
+// values fetched once per row rather than converted from LLSD twice per
+// comparison.  Sorts row indices; the keys for row i, column k are at
+// i * sort_orders.size() + k.
+struct SortScrollListKeys
+{
+	typedef std::vector<std::pair<S32, BOOL> > sort_order_t;
+
+	SortScrollListKeys(const sort_order_t& sort_orders, const std::vector<std::string>& keys, const std::vector<bool>& has_keys)
+	:	mSortOrders(sort_orders),
+		mKeys(keys),
+		mHasKeys(has_keys)
+	{}
+
+	bool operator()(S32 i1, S32 i2) const
+	{
+		const S32 num_keys = mSortOrders.size();
+		S32 sort_result = 0;
+		for (S32 k = num_keys - 1; k >= 0; --k)
+		{
+			S32 key1 = i1 * num_keys + k;
+			S32 key2 = i2 * num_keys + k;
+			if (mHasKeys[key1] && mHasKeys[key2])
+			{
+				S32 order = mSortOrders[k].second ? 1 : -1;
+				sort_result = order * LLStringUtil::compareDict(mKeys[key1], mKeys[key2]);
+				if (sort_result != 0)
+				{
+					break;
+				}
+			}
+		}
+		return sort_result < 0;
+	}
+
+	const sort_order_t& mSortOrders;
+	const std::vector<std::string>& mKeys;
+	const std::vector<bool>& mHasKeys;
+};
+
+static void sort_scroll_list(std::deque<LLScrollListItem*>& items,
+							 const std::vector<std::pair<S32, BOOL> >& sort_orders,
+							 const LLScrollListCtrl::sort_signal_t* sort_signal)
+{
+	// do stable sort to preserve any previous sorts
+	if (sort_signal)
+	{
+		std::stable_sort(items.begin(), items.end(), SortScrollListItem(sort_orders, sort_signal));
+		return;
+	}
+
+	const S32 num_items = items.size();
+	const S32 num_keys = sort_orders.size();
+	std::vector<std::string> keys(num_items * num_keys);
+	std::vector<bool> has_keys(num_items * num_keys, false);
+	for (S32 i = 0; i < num_items; i++)
+	{
+		for (S32 k = 0; k < num_keys; k++)
+		{
+			const LLScrollListCell* cell = items[i]->getColumn(sort_orders[k].first);
+			if (cell)
+			{
+				keys[i * num_keys + k] = cell->getValue().asString();
+				has_keys[i * num_keys + k] = true;
+			}
+		}
+	}
+
+	std::vector<S32> order(num_items);
+	for (S32 i = 0; i < num_items; i++)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), SortScrollListKeys(sort_orders, keys, has_keys));
+
+	std::deque<LLScrollListItem*> sorted(num_items);
+	for (S32 i = 0; i < num_items; i++)
+	{
+		sorted[i] = items[order[i]];
+	}
+	items.swap(sorted);
+}
+
 //---------------------------------------------------------------------------
 // LLScrollListCtrl
 //---------------------------------------------------------------------------
@@ -1390,7 +1473,10 @@ void LLScrollListCtrl::drawItems()
 
 		S32 cur_y = y;
 		
-		S32 line = 0;
+		// only the rows on the page get drawn, so start there instead of
+		// walking every item of a long list
+		S32 line = llclamp(mScrollLines, 0, (S32)mItemList.size());
+		S32 last_line = llmin(line + num_page_lines, (S32)mItemList.size());
 		S32 max_columns = 0;
 
 		LLColor4 highlight_color = LLColor4::white;
@@ -1398,7 +1484,7 @@ void LLScrollListCtrl::drawItems()
 		highlight_color.mV[VALPHA] = clamp_rescale(mSearchTimer.getElapsedTimeF32(), type_ahead_timeout * 0.7f, type_ahead_timeout, 0.4f, 0.f);
 
 		item_list::iterator iter;
-		for (iter = mItemList.begin(); iter != mItemList.end(); iter++)
+		for (iter = mItemList.begin() + line; line < last_line; iter++)
 		{
 			LLScrollListItem* item = *iter;
 			
@@ -2393,11 +2479,7 @@ void LLScrollListCtrl::updateSort() const
 {
 	if (hasSortOrder() && !isSorted())
 	{
-		// do stable sort to preserve any previous sorts
-		std::stable_sort(
-			mItemList.begin(), 
-			mItemList.end(), 
-			SortScrollListItem(mSortColumns,mSortCallback));
+		sort_scroll_list(mItemList, mSortColumns, mSortCallback);
 
 		mSorted = true;
 	}
@@ -2409,11 +2491,7 @@ void LLScrollListCtrl::sortOnce(S32 column, BOOL ascending)
 	std::vector<std::pair<S32, BOOL> > sort_column;
 	sort_column.push_back(std::make_pair(column, ascending));
 
-	// do stable sort to preserve any previous sorts
-	std::stable_sort(
-		mItemList.begin(), 
-		mItemList.end(), 
-		SortScrollListItem(sort_column,mSortCallback));
+	sort_scroll_list(mItemList, sort_column, mSortCallback);
 }
 
 void LLScrollListCtrl::dirtyColumns() 
@@ -592,8 +592,7 @@ void LLTextBase::drawText()
 
 S32 LLTextBase::insertStringNoUndo(S32 pos, const LLWString &wstr, LLTextBase::segment_vec_t* segments )
 {
-	LLWString text(getWText());
-	S32 old_len = text.length();		// length() returns character length
+	S32 old_len = getLength();		// length() returns character length
 	S32 insert_len = wstr.length();
 
 	pos = getEditableIndex(pos, true);
@@ -653,8 +652,7 @@ S32 LLTextBase::insertStringNoUndo(S32 pos, const LLWString &wstr, LLTextBase::s
 		}
 	}
 
-	text.insert(pos, wstr);
-	getViewModel()->setDisplay(text);
+	getViewModel()->insertDisplay(pos, wstr);
 
 	if ( truncate() )
 	{
@@ -669,7 +667,6 @@ S32 LLTextBase::insertStringNoUndo(S32 pos, const LLWString &wstr, LLTextBase::s
 
 S32 LLTextBase::removeStringNoUndo(S32 pos, S32 length)
 {
-	LLWString text(getWText());
 	segment_set_t::iterator seg_iter = getSegIterContaining(pos);
 	while(seg_iter != mSegments.end())
 	{
@@ -715,8 +712,7 @@ S32 LLTextBase::removeStringNoUndo(S32 pos, S32 length)
 		++seg_iter;
 	}
 
-	text.erase(pos, length);
-	getViewModel()->setDisplay(text);
+	getViewModel()->eraseDisplay(pos, length);
 
 	// recreate default segment in case we erased everything
 	createDefaultSegment();
@@ -733,9 +729,7 @@ S32 LLTextBase::overwriteCharNoUndo(S32 pos, llwchar wc)
 	{
 		return 0;
 	}
-	LLWString text(getWText());
-	text[pos] = wc;
-	getViewModel()->setDisplay(text);
+	getViewModel()->setDisplayChar(pos, wc);
 
 	onValueChange(pos, pos + 1);
 	needsReflow(pos);
@@ -1173,6 +1167,10 @@ void LLTextBase::reflow()
 	first_char_rect.mTop = mVisibleTextRect.mTop - first_char_rect.mTop;
 	first_char_rect.mBottom = mVisibleTextRect.mTop - first_char_rect.mBottom;
 
+	// lines ending before this were kept as they were, and so were the
+	// positions of any inline widgets on them
+	S32 layout_start_index = S32_MAX;
+
 	S32 reflow_count = 0;
 	while(mReflowIndex < S32_MAX)
 	{
@@ -1217,6 +1215,8 @@ void LLTextBase::reflow()
 			getSegmentAndOffset(iter->mDocIndexStart, &seg_iter, &seg_offset);
 			mLineInfoList.erase(iter, mLineInfoList.end());
 		}
+		layout_start_index = llmin(layout_start_index, line_start_index);
+		S32 old_first_line_top = mLineInfoList.empty() ? 0 : mLineInfoList.front().mRect.mTop;
 
 		S32 line_height = 0;
 
@@ -1304,7 +1304,14 @@ void LLTextBase::reflow()
 		// calculate visible region for diplaying text
 		updateRects();
 
-		for (segment_set_t::iterator segment_it = mSegments.begin();
+		// vertical alignment can move the lines that were kept, too
+		if (mLineInfoList.empty() || (mLineInfoList.front().mRect.mTop != old_first_line_top))
+		{
+			layout_start_index = 0;
+		}
+
+		segment_set_t::iterator segment_it = layout_start_index > 0 ? getSegIterContaining(layout_start_index) : mSegments.begin();
+		for (;
 			segment_it != mSegments.end();
 			++segment_it)
 		{
@@ -494,10 +494,12 @@ void gl_draw_scaled_image_with_border(S32 x, S32 y, S32 width, S32 height, LLTex
 	S32 image_natural_width = llround(image_width * uv_width);
 	S32 image_natural_height = llround(image_height * uv_height);
 
-	LLRectf draw_center_rect(	uv_center_rect.mLeft * image_width,
-								uv_center_rect.mTop * image_height,
-								uv_center_rect.mRight * image_width,
-								uv_center_rect.mBottom * image_height);
+	// measured from the corner of the clipped region, which need not be the
+	// corner of the texture (e.g. an image packed into an atlas)
+	LLRectf draw_center_rect(	(uv_center_rect.mLeft - uv_outer_rect.mLeft) * image_width,
+								(uv_center_rect.mTop - uv_outer_rect.mBottom) * image_height,
+								(uv_center_rect.mRight - uv_outer_rect.mLeft) * image_width,
+								(uv_center_rect.mBottom - uv_outer_rect.mBottom) * image_height);
 
 	{	// scale fixed region of image to drawn region
 		draw_center_rect.mRight += width - image_natural_width;
@@ -77,7 +77,8 @@ template class LLUICtrlFactory* LLSingleton<class LLUICtrlFactory>::getInstance(
 // LLUICtrlFactory()
 //-----------------------------------------------------------------------------
 LLUICtrlFactory::LLUICtrlFactory()
-	: mDummyPanel(NULL) // instantiated when first needed
+	: mDummyPanel(NULL), // instantiated when first needed
+	mXMLNodeCacheTick(0)
 {
 }
 
@@ -172,7 +173,61 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
 		paths.push_back(xui_filename);
 	}
 
-	return LLXMLNode::getLayeredXMLNode(root, paths);
+	// Floaters and panels get rebuilt from the same few files over and
+	// over, keep their trees around instead of reparsing each time
+	std::string key;
+	std::vector<S64> modified;
+	for (std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		llstat stat_data;
+		modified.push_back(LLFile::stat(*it, &stat_data) == 0 ? (S64) stat_data.st_mtime : -1);
+		key += *it;
+		key += '\n';
+	}
+
+	LLUICtrlFactory& factory = instance();
+	xml_node_cache_t::iterator found = factory.mXMLNodeCache.find(key);
+	if (found != factory.mXMLNodeCache.end() && found->second.mModified == modified)
+	{
+		found->second.mLastUsed = ++factory.mXMLNodeCacheTick;
+		root = found->second.mRoot;
+		return true;
+	}
+
+	if (!LLXMLNode::getLayeredXMLNode(root, paths))
+	{
+		if (found != factory.mXMLNodeCache.end())
+		{
+			factory.mXMLNodeCache.erase(found);
+		}
+		return false;
+	}
+
+	static const U32 MAX_CACHED_XML_NODES = 128;
+	if (found == factory.mXMLNodeCache.end() && factory.mXMLNodeCache.size() >= MAX_CACHED_XML_NODES)
+	{
+		xml_node_cache_t::iterator oldest = factory.mXMLNodeCache.begin();
+		for (xml_node_cache_t::iterator it = factory.mXMLNodeCache.begin(); it != factory.mXMLNodeCache.end(); ++it)
+		{
+			if (it->second.mLastUsed < oldest->second.mLastUsed)
+			{
+				oldest = it;
+			}
+		}
+		factory.mXMLNodeCache.erase(oldest);
+	}
+
+	CachedXMLNode& entry = factory.mXMLNodeCache[key];
+	entry.mRoot = root;
+	entry.mModified = modified;
+	entry.mLastUsed = ++factory.mXMLNodeCacheTick;
+	return true;
+}
+
+//static
+void LLUICtrlFactory::clearXMLNodeCache()
+{
+	instance().mXMLNodeCache.clear();
 }
 
 
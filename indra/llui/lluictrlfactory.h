@@ -32,6 +32,8 @@
 #include "llregistry.h"
 #include "llxuiparser.h"
 
+#include <map>
+
 class LLView;
 
 // sort functor for typeid maps
@@ -222,8 +224,10 @@ fail:
 
 	static void createChildren(LLView* viewp, LLXMLNodePtr node, const widget_registry_t&, LLXMLNodePtr output_node = NULL);
 
+	// Parsed trees are cached per file and shared, treat root as read only
 	static bool getLayeredXMLNode(const std::string &filename, LLXMLNodePtr& root);
 	static bool getLocalizedXMLNode(const std::string &xui_filename, LLXMLNodePtr& root);
+	static void clearXMLNodeCache();
 
 private:
 	//NOTE: both friend declarations are necessary to keep both gcc and msvc happy
@@ -313,6 +317,16 @@ private:
 
 	class LLPanel*		mDummyPanel;
 	std::vector<std::string>	mFileNames;
+
+	struct CachedXMLNode
+	{
+		LLXMLNodePtr		mRoot;
+		std::vector<S64>	mModified;	// per layered file, to catch edits
+		U32					mLastUsed;
+	};
+	typedef std::map<std::string, CachedXMLNode> xml_node_cache_t;
+	xml_node_cache_t	mXMLNodeCache;
+	U32					mXMLNodeCacheTick;
 };
 
 // this is here to make gcc happy with reference to LLUICtrlFactory
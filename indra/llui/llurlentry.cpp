@@ -195,6 +195,7 @@ static std::string getStringAfterToken(const std::string str, const std::string
 //
 LLUrlEntryHTTP::LLUrlEntryHTTP()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("https?://([-\\w\\.]+)+(:\\d+)?(:\\w+)?(@\\d+)?(@\\w+)?/?\\S*",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_http.xml";
@@ -212,6 +213,7 @@ std::string LLUrlEntryHTTP::getLabel(const std::string &url, const LLUrlLabelCal
 //
 LLUrlEntryHTTPLabel::LLUrlEntryHTTPLabel()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("\\[https?://\\S+[ \t]+[^\\]]+\\]",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_http.xml";
@@ -239,6 +241,7 @@ std::string LLUrlEntryHTTPLabel::getUrl(const std::string &string) const
 //
 LLUrlEntryHTTPNoProtocol::LLUrlEntryHTTPNoProtocol()
 {
+	mRequiredText = ".";
 	mPattern = boost::regex("("
 				"\\bwww\\.\\S+\\.\\S+" // i.e. www.FOO.BAR
 				"|" // or
@@ -269,6 +272,7 @@ std::string LLUrlEntryHTTPNoProtocol::getUrl(const std::string &string) const
 LLUrlEntrySLURL::LLUrlEntrySLURL()
 {
 	// see http://slurl.com/about.php for details on the SLURL format
+	mRequiredText = "://";
 	mPattern = boost::regex("http://(maps.secondlife.com|slurl.com)/secondlife/[^ /]+(/\\d+){0,3}(/?(\\?title|\\?img|\\?msg)=\\S*)?/?",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_slurl.xml";
@@ -349,6 +353,7 @@ std::string LLUrlEntrySLURL::getLocation(const std::string &url) const
 //
 LLUrlEntryAgent::LLUrlEntryAgent()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/\\w+",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_agent.xml";
@@ -582,6 +587,7 @@ LLStyle::Params LLUrlEntryAgentName::getStyle() const
 //
 LLUrlEntryAgentCompleteName::LLUrlEntryAgentCompleteName()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/completename",
 							boost::regex::perl|boost::regex::icase);
 }
@@ -598,6 +604,7 @@ std::string LLUrlEntryAgentCompleteName::getName(const LLAvatarName& avatar_name
 //
 LLUrlEntryAgentDisplayName::LLUrlEntryAgentDisplayName()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/displayname",
 							boost::regex::perl|boost::regex::icase);
 }
@@ -614,6 +621,7 @@ std::string LLUrlEntryAgentDisplayName::getName(const LLAvatarName& avatar_name)
 //
 LLUrlEntryAgentUserName::LLUrlEntryAgentUserName()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/username",
 							boost::regex::perl|boost::regex::icase);
 }
@@ -635,6 +643,7 @@ extern const std::string& rlvGetAnonym(const LLAvatarName& avName);
 //
 LLUrlEntryAgentRLVAnonymizedName::LLUrlEntryAgentRLVAnonymizedName()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/rlvanonym", boost::regex::perl|boost::regex::icase);
 }
 
@@ -652,6 +661,7 @@ std::string LLUrlEntryAgentRLVAnonymizedName::getName(const LLAvatarName& avatar
 //
 LLUrlEntryGroup::LLUrlEntryGroup()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/group/[\\da-f-]+/\\w+",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_group.xml";
@@ -729,6 +739,7 @@ LLUrlEntryInventory::LLUrlEntryInventory()
 	//this pattern cann't parse for example 
 	//secondlife:///app/inventory/0e346d8b-4433-4d66-a6b0-fd37083abc4c/select?name=name with spaces&param2=value
 	//x-grid-location-info://lincoln.lindenlab.com/app/inventory/0e346d8b-4433-4d66-a6b0-fd37083abc4c/select?name=name with spaces&param2=value
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/inventory/[\\da-f-]+/\\w+\\S*",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_inventory.xml";
@@ -746,6 +757,7 @@ std::string LLUrlEntryInventory::getLabel(const std::string &url, const LLUrlLab
 //
 LLUrlEntryObjectIM::LLUrlEntryObjectIM()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("(hop|secondlife):///app/objectim/[\\da-f-]+\?.*",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_objectim.xml";
@@ -791,6 +803,7 @@ std::set<LLUrlEntryParcel*> LLUrlEntryParcel::sParcelInfoObservers;
 ///
 LLUrlEntryParcel::LLUrlEntryParcel()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/parcel/[\\da-f-]+/about",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_parcel.xml";
@@ -882,6 +895,7 @@ void LLUrlEntryParcel::processParcelInfo(const LLParcelData& parcel_data)
 //
 LLUrlEntryPlace::LLUrlEntryPlace()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("((hop://[-\\w\\.\\:\\@]+/)|((x-grid-location-info://[-\\w\\.]+/region/)|(secondlife://)))\\S+/?(\\d+/\\d+/\\d+|\\d+/\\d+)/?",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_slurl.xml";
@@ -932,6 +946,7 @@ std::string LLUrlEntryPlace::getLocation(const std::string &url) const
 //
 LLUrlEntryRegion::LLUrlEntryRegion()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("secondlife:///app/region/[^/\\s]+(/\\d+)?(/\\d+)?(/\\d+)?/?",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_slurl.xml";
@@ -997,6 +1012,7 @@ std::string LLUrlEntryRegion::getLocation(const std::string &url) const
 //
 LLUrlEntryTeleport::LLUrlEntryTeleport()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/teleport/\\S+(/\\d+)?(/\\d+)?(/\\d+)?/?\\S*",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_teleport.xml";
@@ -1070,6 +1086,7 @@ std::string LLUrlEntryTeleport::getLocation(const std::string &url) const
 //
 LLUrlEntrySL::LLUrlEntrySL()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("(hop|secondlife)://(\\w+)?(:\\d+)?/\\S+",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_slapp.xml";
@@ -1089,6 +1106,7 @@ std::string LLUrlEntrySL::getLabel(const std::string &url, const LLUrlLabelCallb
 //
 LLUrlEntrySLLabel::LLUrlEntrySLLabel()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex("\\[(hop|secondlife)://\\S+[ \t]+[^\\]]+\\]",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_slapp.xml";
@@ -1141,6 +1159,7 @@ bool LLUrlEntrySLLabel::underlineOnHoverOnly(const std::string &string) const
 //
 LLUrlEntryWorldMap::LLUrlEntryWorldMap()
 {
+	mRequiredText = "://";
 	mPattern = boost::regex(APP_HEADER_REGEX "/worldmap/\\S+/?(\\d+)?/?(\\d+)?/?(\\d+)?/?\\S*",
 							boost::regex::perl|boost::regex::icase);
 	mMenuName = "menu_url_map.xml";
@@ -1187,6 +1206,7 @@ std::string LLUrlEntryWorldMap::getLocation(const std::string &url) const
 //
 LLUrlEntryNoLink::LLUrlEntryNoLink()
 {
+	mRequiredText = "<";
 	mPattern = boost::regex("<nolink>.*?</nolink>",
 							boost::regex::perl|boost::regex::icase);
 }
@@ -1214,6 +1234,7 @@ LLStyle::Params LLUrlEntryNoLink::getStyle() const
 //
 LLUrlEntryIcon::LLUrlEntryIcon()
 {
+	mRequiredText = "<";
 	mPattern = boost::regex("<icon\\s*>\\s*([^<]*)?\\s*</icon\\s*>",
 							boost::regex::perl|boost::regex::icase);
 }
@@ -69,7 +69,14 @@ public:
 	virtual ~LLUrlEntryBase();
 	
 	/// Return the regex pattern that matches this Url 
-	boost::regex getPattern() const { return mPattern; }
+	const boost::regex& getPattern() const { return mPattern; }
+
+	/// Cheap test for whether the pattern could match anywhere in text.
+	/// Lets the registry skip the regex for entries that clearly can't.
+	bool mayMatch(const std::string &text) const
+	{
+		return mRequiredText.empty() || text.find(mRequiredText) != std::string::npos;
+	}
 
 	/// Return the url from a string that matched the regex
 	virtual std::string getUrl(const std::string &string) const;
@@ -114,6 +121,7 @@ protected:
 	} LLUrlEntryObserver;
 
 	boost::regex                                   	mPattern;
+	std::string                                    	mRequiredText;	// substring every match must contain
 	std::string                                    	mIcon;
 	std::string                                    	mMenuName;
 	std::string                                    	mTooltip;
@@ -96,7 +96,7 @@ void LLUrlRegistry::registerUrl(LLUrlEntryBase *url, bool force_front)
 	}
 }
 
-static bool matchRegex(const char *text, boost::regex regex, U32 &start, U32 &end)
+static bool matchRegex(const char *text, const boost::regex &regex, U32 &start, U32 &end)
 {
 	boost::cmatch result;
 	bool found;
@@ -168,6 +168,12 @@ bool LLUrlRegistry::findUrl(const std::string &text, LLUrlMatch &match, const LL
 	{
 		LLUrlEntryBase *url_entry = *it;
 
+		// most entries need a "://" or a tag that isn't in the text at all
+		if (! url_entry->mayMatch(text))
+		{
+			continue;
+		}
+
 		U32 start = 0, end = 0;
 		if (matchRegex(text.c_str(), url_entry->getPattern(), start, end))
 		{
@@ -178,6 +184,11 @@ bool LLUrlRegistry::findUrl(const std::string &text, LLUrlMatch &match, const LL
 				match_end = end;
 				match_entry = url_entry;
 			}
+			if (match_start == 0)
+			{
+				// nothing later in the list can start any earlier
+				break;
+			}
 		}
 	}
 	
@@ -39,6 +39,7 @@
 #include "llrender.h"
 #include "llevent.h"
 #include "llfocusmgr.h"
+#include "lllocalcliprect.h"
 #include "llrect.h"
 #include "llstl.h"
 #include "llui.h"
@@ -48,6 +49,7 @@
 #include "lluictrlfactory.h"
 #include "lltooltip.h"
 #include "llsdutil.h"
+#include "llmemorycounter.h"
 
 // for ui edit hack
 #include "llbutton.h"
@@ -83,6 +85,8 @@ template class LLView* LLView::getChild<class LLView>(
 
 static LLDefaultChildRegistry::Register<LLView> r("view");
 
+static LLMemoryCounter MEM_UI("UI");
+
 LLView::Follows::Follows()
 :   string(""),
 	flags("flags", FOLLOWS_LEFT | FOLLOWS_TOP)
@@ -144,6 +148,23 @@ LLView::LLView(const LLView::Params& p)
 	parseFollowsFlags(p);
 }
 
+//static
+void* LLView::operator new(size_t size)
+{
+	MEM_UI.add(size);
+	return ::operator new(size);
+}
+
+//static
+void LLView::operator delete(void* ptr, size_t size)
+{
+	if (ptr)
+	{
+		MEM_UI.sub(size);
+		::operator delete(ptr);
+	}
+}
+
 LLView::~LLView()
 {
 	dirtyRect();
@@ -1102,7 +1123,12 @@ void LLView::drawChildren()
 			if (viewp->getVisible() && viewp->getRect().isValid())
 			{
 				LLRect screen_rect = viewp->calcScreenRect();
-				if ( rootp->getLocalRect().overlaps(screen_rect)  && LLUI::sDirtyRect.overlaps(screen_rect))
+				// where it will actually be drawn, in the clip rect's frame
+				LLRect draw_rect = viewp->getRect();
+				draw_rect.translate(LLFontGL::sCurOrigin.mX, LLFontGL::sCurOrigin.mY);
+				if ( rootp->getLocalRect().overlaps(screen_rect)  && LLUI::sDirtyRect.overlaps(screen_rect)
+					// e.g. rows scrolled out of a scroll container
+					&& LLScreenClipRect::isVisible(draw_rect))
 				{
 					LLUI::pushMatrix();
 					{
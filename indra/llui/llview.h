@@ -210,6 +210,11 @@ public:
 
 	virtual ~LLView();
 
+	// counted as "UI" in the memory usage floater; the virtual destructor
+	// makes delete pass the size of the whole widget
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 	// Some UI widgets need to be added as controls.  Others need to
 	// be added as regular view children.  isCtrl should return TRUE
 	// if a widget needs to be added as a ctrl
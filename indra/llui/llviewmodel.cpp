@@ -99,6 +99,27 @@ void LLTextViewModel::setDisplay(const LLWString& value)
     mUpdateFromDisplay = true;
 }
 
+void LLTextViewModel::insertDisplay(S32 pos, const LLWString& text)
+{
+    mDisplay.insert(pos, text);
+    mDirty = true;
+    mUpdateFromDisplay = true;
+}
+
+void LLTextViewModel::eraseDisplay(S32 pos, S32 length)
+{
+    mDisplay.erase(pos, length);
+    mDirty = true;
+    mUpdateFromDisplay = true;
+}
+
+void LLTextViewModel::setDisplayChar(S32 pos, llwchar wc)
+{
+    mDisplay[pos] = wc;
+    mDirty = true;
+    mUpdateFromDisplay = true;
+}
+
 LLSD LLTextViewModel::getValue() const
 {
     // Has anyone called setDisplay() since the last setValue()? If so, have
@@ -109,6 +109,11 @@ public:
      * UTF-8 value.
      */
     void setDisplay(const LLWString& value);
+    /// Same as setDisplay() on an edited copy, without copying the whole
+    /// string -- appending to a long chat history shouldn't be O(history).
+    void insertDisplay(S32 pos, const LLWString& text);
+    void eraseDisplay(S32 pos, S32 length);
+    void setDisplayChar(S32 pos, llwchar wc);
 	
 private:
     /// To avoid converting every widget's stored value from LLSD to LLWString
@@ -36,10 +36,10 @@
 //============================================================================
 // Run on MAIN thread
 //static
-void LLLFSThread::initClass(bool local_is_threaded)
+void LLLFSThread::initClass(bool local_is_threaded, U32 pool_size)
 {
 	llassert(sLocal == NULL);
-	sLocal = new LLLFSThread(local_is_threaded);
+	sLocal = new LLLFSThread(local_is_threaded, pool_size);
 }
 
 //static
@@ -63,21 +63,39 @@ void LLLFSThread::cleanupClass()
 
 //----------------------------------------------------------------------------
 
-LLLFSThread::LLLFSThread(bool threaded) :
+LLLFSThread::LLLFSThread(bool threaded, U32 pool_size) :
 	LLQueuedThread("LFS", threaded),
-	mPriorityCounter(PRIORITY_LOWBITS)
+	mPriorityCounter(PRIORITY_LOWBITS),
+	mBusyFilesMutex(NULL)
 {
 	if(!mLocalAPRFilePoolp)
 	{
-		mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
+		// shared by the pool threads, so not a local pool
+		mLocalAPRFilePoolp = new LLVolatileAPRPool(pool_size <= 1) ;
 	}
+	startPool(pool_size);
 }
 
 LLLFSThread::~LLLFSThread()
 {
+	// Pool workers must be gone before mBusyFilesMutex
+	shutdown();
 	// ~LLQueuedThread() will be called here
 }
 
+// Called from any pool thread
+bool LLLFSThread::lockFile(const std::string& filename)
+{
+	LLMutexLock lock(&mBusyFilesMutex);
+	return mBusyFiles.insert(filename).second;
+}
+
+void LLLFSThread::unlockFile(const std::string& filename)
+{
+	LLMutexLock lock(&mBusyFilesMutex);
+	mBusyFiles.erase(filename);
+}
+
 //----------------------------------------------------------------------------
 
 LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,	/* Flawfinder: ignore */ 
@@ -178,7 +196,18 @@ void LLLFSThread::Request::deleteRequest()
 
 bool LLLFSThread::Request::processRequest()
 {
-	bool complete = false;
+	if (!mThread->lockFile(mFileName))
+	{
+		// another pool thread has this file, requeue at the same priority
+		return false;
+	}
+	processFileRequest();
+	mThread->unlockFile(mFileName);
+	return true;
+}
+
+void LLLFSThread::Request::processFileRequest()
+{
 	if (mOperation ==  FILE_READ)
 	{
 		llassert(mOffset >= 0);
@@ -188,7 +217,7 @@ bool LLLFSThread::Request::processRequest()
 		{
 			llwarns << "LLLFS: Unable to read file: " << mFileName << llendl;
 			mBytesRead = 0; // fail
-			return true;
+			return;
 		}
 		S32 off;
 		if (mOffset < 0)
@@ -197,7 +226,6 @@ bool LLLFSThread::Request::processRequest()
 			off = infile.seek(APR_SET, mOffset);
 		llassert_always(off >= 0);
 		mBytesRead = infile.read(mBuffer, mBytes );
-		complete = true;
 // 		llinfos << "LLLFSThread::READ:" << mFileName << " Bytes: " << mBytesRead << llendl;
 	}
 	else if (mOperation ==  FILE_WRITE)
@@ -211,7 +239,7 @@ bool LLLFSThread::Request::processRequest()
 		{
 			llwarns << "LLLFS: Unable to write file: " << mFileName << llendl;
 			mBytesRead = 0; // fail
-			return true;
+			return;
 		}
 		if (mOffset >= 0)
 		{
@@ -220,18 +248,16 @@ bool LLLFSThread::Request::processRequest()
 			{
 				llwarns << "LLLFS: Unable to write file (seek failed): " << mFileName << llendl;
 				mBytesRead = 0; // fail
-				return true;
+				return;
 			}
 		}
 		mBytesRead = outfile.write(mBuffer, mBytes );
-		complete = true;
 // 		llinfos << "LLLFSThread::WRITE:" << mFileName << " Bytes: " << mBytesRead << "/" << mBytes << " Offset:" << mOffset << llendl;
 	}
 	else
 	{
 		llerrs << "LLLFSThread::unknown operation: " << (S32)mOperation << llendl;
 	}
-	return complete;
 }
 
 //============================================================================
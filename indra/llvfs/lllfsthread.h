@@ -100,6 +100,8 @@ public:
 		/*virtual*/ void deleteRequest();
 		
 	private:
+		void processFileRequest();
+
 		LLLFSThread* mThread;
 		operation_t mOperation;
 		
@@ -115,7 +117,7 @@ public:
 
 	//------------------------------------------------------------------------
 public:
-	LLLFSThread(bool threaded = TRUE);
+	LLLFSThread(bool threaded = TRUE, U32 pool_size = 1);
 	~LLLFSThread();	
 
 	// Return a Request handle
@@ -130,13 +132,22 @@ public:
 	U32 priorityCounter() { return mPriorityCounter-- & PRIORITY_LOWBITS; } // Use to order IO operations
 	
 	// static initializers
-	static void initClass(bool local_is_threaded = TRUE); // Setup sLocal
+	static void initClass(bool local_is_threaded = TRUE, U32 pool_size = 1); // Setup sLocal
 	static S32 updateClass(U32 ms_elapsed);
 	static void cleanupClass();		// Delete sLocal
 
 	
 private:
+	// Requests for different files run on any free pool thread. Requests
+	// for the same file wait their turn, so a read never overtakes the
+	// write it follows.
+	bool lockFile(const std::string& filename);
+	void unlockFile(const std::string& filename);
+
 	U32 mPriorityCounter;
+
+	LLMutex mBusyFilesMutex;
+	std::set<std::string> mBusyFiles;
 	
 public:
 	static LLLFSThread* sLocal;		// Default local file thread
@@ -38,6 +38,9 @@ const S32 LLVFile::WRITE		= 0x00000002;
 const S32 LLVFile::READ_WRITE	= 0x00000003;  // LLVFile::READ & LLVFile::WRITE
 const S32 LLVFile::APPEND		= 0x00000006;  // 0x00000004 & LLVFile::WRITE
 
+// Past this, mapping costs more in page faults than a read costs in copying
+const S32 LLVFile::MAX_MAP_SIZE	= 4 * 1024 * 1024;
+
 static LLFastTimer::DeclareTimer FTM_VFILE_WAIT("VFile Wait");
 
 //----------------------------------------------------------------------------
@@ -80,6 +83,7 @@ LLVFile::~LLVFile()
 			}
 		}
 	}
+	unmap();
 	mVFS->decLock(mFileID, mFileType, VFSLOCK_OPEN);
 }
 
@@ -122,6 +126,49 @@ BOOL LLVFile::read(U8 *buffer, S32 bytes, BOOL async, F32 priority)
 	return success;
 }
 
+const U8* LLVFile::map(S32 bytes)
+{
+	unmap();
+
+	if (! (mMode & READ))
+	{
+		llwarns << "Attempt to map file " << mFileID << " opened with mode " << std::hex << mMode << std::dec << llendl;
+		return NULL;
+	}
+
+	if (mHandle != LLVFSThread::nullHandle())
+	{
+		llwarns << "Attempt to map vfile object " << mFileID << " with pending async operation" << llendl;
+		return NULL;
+	}
+
+	if (bytes <= 0)
+	{
+		return NULL;
+	}
+
+	// same as read(), pending appends have to land first
+	waitForLock(VFSLOCK_APPEND);
+
+	if (bytes <= MAX_MAP_SIZE && mVFS->mapData(mFileID, mFileType, mPosition, bytes, mMapping))
+	{
+		mBytesRead = mMapping.mLength;
+		mPosition += mBytesRead;
+		return mMapping.mData;
+	}
+
+	mMapBuffer.resize(bytes);
+	mBytesRead = sVFSThread->readImmediate(mVFS, mFileID, mFileType, &mMapBuffer[0], mPosition, bytes);
+	mPosition += mBytesRead;
+	return mBytesRead ? &mMapBuffer[0] : NULL;
+}
+
+void LLVFile::unmap()
+{
+	mVFS->unmapData(mMapping);
+	std::vector<U8>().swap(mMapBuffer);
+}
+
 //static
 U8* LLVFile::readFile(LLVFS *vfs, const LLUUID &uuid, LLAssetType::EType type, S32* bytes_read)
 {
@@ -27,6 +27,7 @@
 #ifndef LL_LLVFILE_H
 #define LL_LLVFILE_H
 
+#include <vector>
 #include "lluuid.h"
 #include "llassettype.h"
 #include "llvfs.h"
@@ -39,6 +40,13 @@ public:
 	~LLVFile();
 
 	BOOL read(U8 *buffer, S32 bytes, BOOL async = FALSE, F32 priority = 128.f);	/* Flawfinder: ignore */ 
+
+	// Like a synchronous read() but returns the bytes in place, mapped
+	// from the VFS data file when it's no bigger than MAX_MAP_SIZE.  The
+	// pointer is good until the next map(), unmap() or the LLVFile going
+	// away.  getLastBytesRead() says how many bytes it covers.
+	const U8* map(S32 bytes);
+	void unmap();
 	static U8* readFile(LLVFS *vfs, const LLUUID &uuid, LLAssetType::EType type, S32* bytes_read = 0);
 	void setReadPriority(const F32 priority);
 	BOOL isReadComplete();
@@ -73,6 +81,8 @@ public:
 	static const S32 WRITE;
 	static const S32 READ_WRITE;
 	static const S32 APPEND;
+
+	static const S32 MAX_MAP_SIZE;
 	
 protected:
 	LLAssetType::EType mFileType;
@@ -85,6 +95,9 @@ protected:
 
 	S32		mBytesRead;
 	LLVFSThread::handle_t mHandle;
+
+	LLVFSMapping mMapping;
+	std::vector<U8> mMapBuffer;	// used instead of mMapping above MAX_MAP_SIZE
 };
 
 #endif
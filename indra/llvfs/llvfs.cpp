@@ -33,12 +33,17 @@
 #include <map>
 #if LL_WINDOWS
 #include <share.h>
+#include <io.h>
+#include <windows.h>
 #elif LL_SOLARIS
 #include <sys/types.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #else
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
     
 #include "llstl.h"
@@ -50,6 +55,48 @@ const S32 BLOCK_LENGTH_INVALID = -1;	// mLength for invalid LLVFSFileBlocks
 
 LLVFS *gVFS = NULL;
 
+// Positional reads and writes of the data file.  They don't touch the
+// shared file position, so getData() can read without holding mDataMutex.
+// All data file writes go through here too, rather than through stdio,
+// so there is no stdio buffer for the unlocked reads to miss.
+static S32 read_at(LLFILE* fp, U8* buffer, S32 length, U32 location)
+{
+#if LL_WINDOWS
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(fp));
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.Offset = location;
+	DWORD bytes_read = 0;
+	if (!ReadFile(handle, buffer, length, &bytes_read, &overlapped))
+	{
+		return 0;
+	}
+	return (S32)bytes_read;
+#else
+	ssize_t bytes_read = pread(fileno(fp), buffer, length, location);
+	return bytes_read > 0 ? (S32)bytes_read : 0;
+#endif
+}
+
+static S32 write_at(LLFILE* fp, const U8* buffer, S32 length, U32 location)
+{
+#if LL_WINDOWS
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(fp));
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.Offset = location;
+	DWORD bytes_written = 0;
+	if (!WriteFile(handle, buffer, length, &bytes_written, &overlapped))
+	{
+		return 0;
+	}
+	return (S32)bytes_written;
+#else
+	ssize_t bytes_written = pwrite(fileno(fp), buffer, length, location);
+	return bytes_written > 0 ? (S32)bytes_written : 0;
+#endif
+}
+
 // internal class definitions
 class LLVFSBlock
 {
@@ -232,7 +279,8 @@ const S32 LLVFSFileBlock::SERIAL_SIZE = 34;
 LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename, const BOOL read_only, const U32 presize, const BOOL remove_after_crash)
 :	mRemoveAfterCrash(remove_after_crash),
 	mDataFP(NULL),
-	mIndexFP(NULL)
+	mIndexFP(NULL),
+	mReadGeneration(0)
 {
 	mDataMutex = new LLMutex(0);
 
@@ -345,6 +393,7 @@ LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename
 			if (block->mLength > 0 &&
 				(U32)block->mLength <= data_size &&
 				block->mLocation < data_size &&
+				(U32)block->mLength <= data_size - block->mLocation &&
 				block->mSize > 0 &&
 				block->mSize <= block->mLength &&
 				block->mFileType >= LLAssetType::AT_NONE &&
@@ -356,29 +405,14 @@ LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename
 			else
 			if (block->mLength && block->mSize > 0)
 			{
-				// this is corrupt, not empty
+				// this is corrupt, not empty.  Only this file is lost, its index
+				// slot is reused and its data is free space to the blocks around it.
 				LL_WARNS("VFS") << "VFS corruption: " << block->mFileID << " (" << block->mFileType << ") at index " << block->mIndexLocation << " DS: " << data_size << LL_ENDL;
 				LL_WARNS("VFS") << "Length: " << block->mLength << "\tLocation: " << block->mLocation << "\tSize: " << block->mSize << LL_ENDL;
-				LL_WARNS("VFS") << "File has bad data - VFS removed" << LL_ENDL;
+				LL_WARNS("VFS") << "File has bad data - entry dropped" << LL_ENDL;
 
+				mIndexHoles.push_back(buf_offset);
 				delete block;
-
-				unlockAndClose( mIndexFP );
-				mIndexFP = NULL;
-				LLFile::remove( mIndexFilename );
-
-				unlockAndClose( mDataFP );
-				mDataFP = NULL;
-				LLFile::remove( mDataFilename );
-
-				LL_WARNS("VFS") << "Deleted corrupt VFS files " 
-					<< mDataFilename 
-					<< " and "
-					<< mIndexFilename
-					<< LL_ENDL;
-
-				mValid = VFSVALID_BAD_CORRUPT;
-				return;
 			}
 			else
 			{
@@ -463,32 +497,25 @@ LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename
     
 				// Check for more errors...  Seeing if the current
 				// entry and the last entry make sense together.
-				if (length < 0 || loc < 0 || (U32)loc > data_size)
+				// Blocks are known to lie inside the data file, so
+				// this can only be an overlap.
+				if (length < 0)
 				{
-					// Invalid VFS
-					unlockAndClose( mIndexFP );
-					mIndexFP = NULL;
-					LLFile::remove( mIndexFilename );
-
-					unlockAndClose( mDataFP );
-					mDataFP = NULL;
-					LLFile::remove( mDataFilename );
-
-					LL_WARNS("VFS") << "VFS: overlapping entries"
+					LL_WARNS("VFS") << "VFS: removing overlapping entry"
 						<< " at " << cur_file_block->mLocation 
 						<< " length " << cur_file_block->mLength 
 						<< " ID " << cur_file_block->mFileID 
 						<< " type " << cur_file_block->mFileType 
 						<< LL_ENDL;
 
-					LL_WARNS("VFS") << "Deleted corrupt VFS files " 
-						<< mDataFilename 
-						<< " and "
-						<< mIndexFilename
-						<< LL_ENDL;
-
-					mValid = VFSVALID_BAD_CORRUPT;
-					return;
+					// Keep the earlier file, drop this one
+					mFileBlocks.erase(*cur_file_block);
+					lockData();						// needed for sync()
+					sync(cur_file_block, TRUE);		// remove on disk
+					unlockData();					// needed for sync()
+					delete cur_file_block;
+					++cur;
+					continue;
 				}
 
 				// we don't want to add empty blocks to the list...
@@ -578,6 +605,7 @@ LLVFS::~LLVFS()
 	mFreeBlocksByLength.clear();
 
 	for_each(mFreeBlocksByLocation.begin(), mFreeBlocksByLocation.end(), DeletePairedPointer());
+	for_each(mDeferredFree.begin(), mDeferredFree.end(), DeletePairedPointer());
     
 	unlockAndClose(mDataFP);
 	mDataFP = NULL;
@@ -645,7 +673,8 @@ void LLVFS::presizeDataFile(const U32 size)
 	fseek(mDataFP, size-1, SEEK_SET);
 	S32 tmp = 0;
 	tmp = (S32)fwrite(&tmp, 1, 1, mDataFP);
-	// fflush(mDataFP);
+	// later writes bypass stdio, don't let this byte land on top of them
+	fflush(mDataFP);
 
 	// also remove any index, since this vfs is now blank
 	LLFile::remove(mIndexFilename);
@@ -803,7 +832,7 @@ BOOL LLVFS::setMaxSize(const LLUUID &file_id, const LLAssetType::EType file_type
 			// this file is shrinking
 			LLVFSBlock *free_block = new LLVFSBlock(block->mLocation + max_size, block->mLength - max_size);
 
-			addFreeBlock(free_block);
+			releaseSpace(free_block);
     
 			block->mLength = max_size;
     
@@ -866,17 +895,15 @@ BOOL LLVFS::setMaxSize(const LLUUID &file_id, const LLAssetType::EType file_type
 					// create a new free block where this file used to be
 					LLVFSBlock *new_free_block = new LLVFSBlock(block->mLocation, block->mLength);
 
-					addFreeBlock(new_free_block);
+					releaseSpace(new_free_block);
 					
 					if (block->mSize > 0)
 					{
 						// move the file into the new block
 						std::vector<U8> buffer(block->mSize);
-						fseek(mDataFP, block->mLocation, SEEK_SET);
-						if (fread(&buffer[0], block->mSize, 1, mDataFP) == 1)
+						if (read_at(mDataFP, &buffer[0], block->mSize, block->mLocation) == block->mSize)
 						{
-							fseek(mDataFP, new_data_location, SEEK_SET);
-							if (fwrite(&buffer[0], block->mSize, 1, mDataFP) != 1)
+							if (write_at(mDataFP, &buffer[0], block->mSize, new_data_location) != block->mSize)
 							{
 								llwarns << "Short write" << llendl;
 							}
@@ -1026,7 +1053,7 @@ void LLVFS::removeFileBlock(LLVFSFileBlock *fileblock)
 		// turn this file into an empty block
 		LLVFSBlock *free_block = new LLVFSBlock(fileblock->mLocation, fileblock->mLength);
 		
-		addFreeBlock(free_block);
+		releaseSpace(free_block);
 	}
 	
 	fileblock->mLocation = 0;
@@ -1078,6 +1105,7 @@ S32 LLVFS::getData(const LLUUID &file_id, const LLAssetType::EType file_type, U8
 	llassert(length >= 0);
 
 	BOOL do_read = FALSE;
+	U32 generation = 0;
 	
     lockData();
 	
@@ -1101,20 +1129,122 @@ S32 LLVFS::getData(const LLUUID &file_id, const LLAssetType::EType file_type, U8
 			}
 			location += block->mLocation;
 			do_read = TRUE;
+			generation = beginRead();
 		}
 	}
 
+	unlockData();
+
 	if (do_read)
 	{
-		fseek(mDataFP, location, SEEK_SET);
-		bytesread = (S32)fread(buffer, 1, length, mDataFP);
+		// the space can't be handed to another file until endRead()
+		bytesread = read_at(mDataFP, buffer, length, location);
+
+		lockData();
+		endRead(generation);
+		unlockData();
 	}
-	
-	unlockData();
 
 	return bytesread;
 }
     
+BOOL LLVFS::mapData(const LLUUID &file_id, const LLAssetType::EType file_type, S32 location, S32 length, LLVFSMapping& mapping)
+{
+	if (!isValid())
+	{
+		llerrs << "Attempting to use invalid VFS!" << llendl;
+	}
+	llassert(location >= 0);
+	llassert(!mapping.mAddress);
+
+	U32 file_location = 0;
+	U32 generation = 0;
+
+	lockData();
+
+	LLVFSFileSpecifier spec(file_id, file_type);
+	fileblock_map::iterator it = mFileBlocks.find(spec);
+	if (it == mFileBlocks.end() || location >= it->second->mSize)
+	{
+		unlockData();
+		return FALSE;
+	}
+
+	LLVFSFileBlock *block = it->second;
+	block->mAccessTime = (U32)time(NULL);
+	length = llmin(length, block->mSize - location);
+	if (length <= 0)
+	{
+		unlockData();
+		return FALSE;
+	}
+	file_location = block->mLocation + location;
+	generation = beginRead();
+
+	unlockData();
+
+	void* address = NULL;
+#if LL_WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	U32 offset = file_location % info.dwAllocationGranularity;
+	size_t address_length = offset + length;
+
+	HANDLE file_mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(mDataFP)), NULL, PAGE_READONLY, 0, 0, NULL);
+	if (file_mapping)
+	{
+		address = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, file_location - offset, address_length);
+		// the view holds its own reference
+		CloseHandle(file_mapping);
+	}
+#else
+	static const U32 page_size = (U32)sysconf(_SC_PAGESIZE);
+	U32 offset = file_location % page_size;
+	size_t address_length = offset + length;
+
+	address = mmap(NULL, address_length, PROT_READ, MAP_SHARED, fileno(mDataFP), file_location - offset);
+	if (address == MAP_FAILED)
+	{
+		address = NULL;
+	}
+#endif
+
+	if (!address)
+	{
+		lockData();
+		endRead(generation);
+		unlockData();
+		return FALSE;
+	}
+
+	mapping.mAddress = address;
+	mapping.mAddressLength = address_length;
+	mapping.mData = (const U8*)address + offset;
+	mapping.mLength = length;
+	mapping.mGeneration = generation;
+	return TRUE;
+}
+
+void LLVFS::unmapData(LLVFSMapping& mapping)
+{
+	if (!mapping.mAddress)
+	{
+		return;
+	}
+
+#if LL_WINDOWS
+	UnmapViewOfFile(mapping.mAddress);
+#else
+	munmap(mapping.mAddress, mapping.mAddressLength);
+#endif
+
+	lockData();
+	endRead(mapping.mGeneration);
+	unlockData();
+
+	mapping = LLVFSMapping();
+}
+
 S32 LLVFS::storeData(const LLUUID &file_id, const LLAssetType::EType file_type, const U8 *buffer, S32 location, S32 length)
 {
 	if (!isValid())
@@ -1176,13 +1306,11 @@ S32 LLVFS::storeData(const LLUUID &file_id, const LLAssetType::EType file_type,
 			}
 			U32 file_location = location + block->mLocation;
 			
-			fseek(mDataFP, file_location, SEEK_SET);
-			S32 write_len = (S32)fwrite(buffer, 1, length, mDataFP);
+			S32 write_len = write_at(mDataFP, buffer, length, file_location);
 			if (write_len != length)
 			{
 				llwarns << llformat("VFS Write Error: %d != %d",write_len,length) << llendl;
 			}
-			// fflush(mDataFP);
 			
 			if (location + length > block->mSize)
 			{
@@ -1433,6 +1561,47 @@ void LLVFS::addFreeBlock(LLVFSBlock *block)
 //}
 	
 // length bytes from free_block are going to be used (so they are no longer free)
+// mDataMutex must be LOCKED before calling this
+U32 LLVFS::beginRead()
+{
+	mReadsInFlight[mReadGeneration]++;
+	return mReadGeneration;
+}
+
+// mDataMutex must be LOCKED before calling this
+void LLVFS::endRead(U32 generation)
+{
+	reads_in_flight_map_t::iterator it = mReadsInFlight.find(generation);
+	llassert(it != mReadsInFlight.end());
+	if (--it->second > 0)
+	{
+		return;
+	}
+	mReadsInFlight.erase(it);
+
+	// hand back space no remaining read can still be looking at
+	while (!mDeferredFree.empty() &&
+		   (mReadsInFlight.empty() || mReadsInFlight.begin()->first > mDeferredFree.front().first))
+	{
+		addFreeBlock(mDeferredFree.front().second);
+		mDeferredFree.pop_front();
+	}
+}
+
+// mDataMutex must be LOCKED before calling this
+void LLVFS::releaseSpace(LLVFSBlock *block)
+{
+	if (mReadsInFlight.empty())
+	{
+		addFreeBlock(block);
+		return;
+	}
+
+	// reads that start from now on can't see this space
+	mDeferredFree.push_back(std::make_pair(mReadGeneration, block));
+	mReadGeneration++;
+}
+
 void LLVFS::useFreeSpace(LLVFSBlock *free_block, S32 length)
 {
 	if (free_block->mLength == length)
@@ -69,6 +69,19 @@ public:
 	LLAssetType::EType mFileType;
 };
 
+// A read-only view of part of a vfile, filled in by LLVFS::mapData().
+// The space it looks at stays with the file until LLVFS::unmapData().
+struct LLVFSMapping
+{
+	LLVFSMapping() : mData(NULL), mLength(0), mAddress(NULL), mAddressLength(0), mGeneration(0) { }
+
+	const U8*	mData;
+	S32			mLength;
+	void*		mAddress;		// start of the page aligned OS mapping
+	size_t		mAddressLength;
+	U32			mGeneration;	// read generation holding the space
+};
+
 class LLVFS
 {
 private:
@@ -109,6 +122,12 @@ public:
 	S32 getData(const LLUUID &file_id, const LLAssetType::EType file_type, U8 *buffer, S32 location, S32 length);
 	S32 storeData(const LLUUID &file_id, const LLAssetType::EType file_type, const U8 *buffer, S32 location, S32 length);
 
+	// Maps length bytes of a file from location instead of copying them.
+	// Returns FALSE if there is nothing there or the OS won't map it.
+	// length is trimmed to the end of the file, as with getData().
+	BOOL mapData(const LLUUID &file_id, const LLAssetType::EType file_type, S32 location, S32 length, LLVFSMapping& mapping);
+	void unmapData(LLVFSMapping& mapping);
+
 	void incLock(const LLUUID &file_id, const LLAssetType::EType file_type, EVFSLock lock);
 	void decLock(const LLUUID &file_id, const LLAssetType::EType file_type, EVFSLock lock);
 	BOOL isLocked(const LLUUID &file_id, const LLAssetType::EType file_type, EVFSLock lock);
@@ -136,6 +155,13 @@ protected:
 	void eraseBlock(LLVFSBlock *block);
 	void addFreeBlock(LLVFSBlock *block);
 	//void mergeFreeBlocks();
+
+	// getData() reads without mDataMutex held.  Space given up while a read
+	// is in flight waits in mDeferredFree until every read that started
+	// before it has finished.
+	U32 beginRead();
+	void endRead(U32 generation);
+	void releaseSpace(LLVFSBlock *block);	// addFreeBlock() once it's safe
 	void useFreeSpace(LLVFSBlock *free_block, S32 length);
 	void sync(LLVFSFileBlock *block, BOOL remove = FALSE);
 	void presizeDataFile(const U32 size);
@@ -167,6 +193,12 @@ protected:
 
 	std::deque<S32> mIndexHoles;
 
+	U32 mReadGeneration;
+	typedef std::map<U32, S32> reads_in_flight_map_t;
+	reads_in_flight_map_t mReadsInFlight;	// by generation
+	typedef std::deque<std::pair<U32, LLVFSBlock*> > deferred_free_list_t;
+	deferred_free_list_t mDeferredFree;		// generation when freed, block
+
 	std::string mIndexFilename;
 	std::string mDataFilename;
 	BOOL mReadOnly;
@@ -27,9 +27,13 @@
 #include "linden_common.h"
 #include "llvfsthread.h"
 #include "llstl.h"
+#include "llmemorycounter.h"
 
 //============================================================================
 
+// copies of appended data waiting to be written
+static LLMemoryCounter MEM_VFS_BUFFERS("VFS Buffers");
+
 /*static*/ std::string LLVFSThread::sDataPath = "";
 
 /*static*/ LLVFSThread* LLVFSThread::sLocal = NULL;
@@ -210,6 +214,10 @@ LLVFSThread::Request::Request(handle_t handle, U32 priority, U32 flags,
 	}
 	if (mOperation == FILE_WRITE)
 	{
+		if (mFlags & FLAG_AUTO_DELETE)
+		{
+			MEM_VFS_BUFFERS.add(mBytes);
+		}
 		S32 blocksize =  mVFS->getMaxSize(mFileID, mFileType);
 		if (blocksize < 0)
 		{
@@ -254,6 +262,7 @@ void LLVFSThread::Request::deleteRequest()
 	{
 		if (mFlags & FLAG_AUTO_DELETE)
 		{
+			MEM_VFS_BUFFERS.sub(mBytes);
 			delete [] mBuffer;
 		}
 	}
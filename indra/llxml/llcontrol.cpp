@@ -43,6 +43,8 @@
 #include "llrect.h"
 #include "llxmltree.h"
 #include "llsdserialize.h"
+#include "llmd5.h"
+#include "lldir.h"
 
 #if LL_RELEASE_WITH_DEBUG_INFO || LL_DEBUG
 #define CONTROL_ERRS LL_ERRS("ControlErrors")
@@ -835,22 +837,75 @@ U32 LLControlGroup::saveToFile(const std::string& filename, BOOL nondefault_only
 	return num_saved;
 }
 
-U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_values, bool save_values)
+//static
+std::string LLControlGroup::sCompiledSettingsDir;
+
+//static
+bool LLControlGroup::readSettingsFile(const std::string& filename, bool use_compiled, LLSD& settings)
 {
-	LLSD settings;
-	llifstream infile;
-	infile.open(filename);
-	if(!infile.is_open())
+	llifstream infile(filename, std::ios::in | std::ios::binary);
+	if (!infile.is_open())
 	{
 		llwarns << "Cannot find file " << filename << " to load." << llendl;
-		return 0;
+		return false;
+	}
+
+	if (!use_compiled || sCompiledSettingsDir.empty())
+	{
+		return LLSDSerialize::fromXML(settings, infile) > 0;
 	}
 
-	S32 ret = LLSDSerialize::fromXML(settings, infile);
+	std::string xml((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+	infile.close();
+
+	// only the XML decides whether a compiled copy is current
+	char digest[33];
+	LLMD5 md5((const unsigned char*) xml.data(), xml.size());
+	md5.hex_digest(digest);
+
+	std::string base_name = gDirUtilp->getBaseFileName(filename, true);
+	std::string compiled_name = sCompiledSettingsDir + gDirUtilp->getDirDelimiter() + base_name + "." + digest + ".llsd";
+
+	llifstream compiled(compiled_name, std::ios::in | std::ios::binary);
+	if (compiled.is_open())
+	{
+		std::vector<U8> buffer((std::istreambuf_iterator<char>(compiled)), std::istreambuf_iterator<char>());
+		compiled.close();
+		if (!buffer.empty() && LLSDSerialize::fromBinaryBuffer(settings, &buffer[0], buffer.size()) > 0 && settings.isMap())
+		{
+			return true;
+		}
+		llwarns << "Ignoring unreadable compiled settings " << compiled_name << llendl;
+	}
 
-	if (ret <= 0)
+	std::istringstream istr(xml);
+	if (LLSDSerialize::fromXML(settings, istr) <= 0)
 	{
-		infile.close();
+		return false;
+	}
+
+	// drop copies made from older versions of the file
+	gDirUtilp->deleteFilesInDir(sCompiledSettingsDir, base_name + ".*.llsd");
+
+	std::vector<U8> buffer;
+	LLSDSerialize::toBinaryBuffer(settings, buffer);
+	llofstream out(compiled_name, std::ios::out | std::ios::binary);
+	if (out.is_open())
+	{
+		out.write((const char*) &buffer[0], buffer.size());
+	}
+	return true;
+}
+
+U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_values, bool save_values)
+{
+	LLSD settings;
+	if (!readSettingsFile(filename, set_default_values, settings))
+	{
+		if (!LLFile::isfile(filename))
+		{
+			return 0;
+		}
 		llwarns << "Unable to open LLSD control file " << filename << ". Trying Legacy Method." << llendl;		
 		return loadFromFileLegacy(filename, TRUE, TYPE_STRING);
 	}
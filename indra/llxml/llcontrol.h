@@ -296,6 +296,17 @@ public:
  	U32 saveToFile(const std::string& filename, BOOL nondefault_only);
  	U32	loadFromFile(const std::string& filename, bool default_values = false, bool save_values = true);
 	void	resetToDefaults();
+
+	// Defaults files are kept here as binary LLSD, named by the hash of
+	// the XML they came from, and read back instead of reparsing the XML.
+	// Empty (the default) turns this off.
+	static void setCompiledSettingsDir(const std::string& dir)	{ sCompiledSettingsDir = dir; }
+
+private:
+	// Reads filename as LLSD XML, through the compiled copy when there is one
+	static bool readSettingsFile(const std::string& filename, bool use_compiled, LLSD& settings);
+
+	static std::string sCompiledSettingsDir;
 };
 
 
@@ -27,6 +27,9 @@
 #ifndef LL_LSCRIPT_RT_INTERFACE_H
 #define LL_LSCRIPT_RT_INTERFACE_H
 
+// Not reentrant: the flex/bison front end and every compile pass share
+// globals (yyin/yyout, gScriptp, gErrorToText, gAllocationManager,
+// gScopeStringTable), so only one compile may run at a time, on one thread.
 BOOL lscript_compile(char *filename, BOOL compile_to_mono, BOOL is_god_like = FALSE);
 BOOL lscript_compile(const char* src_filename, const char* dst_filename,
 					 const char* err_filename, BOOL compile_to_mono, const char* class_name, BOOL is_god_like = FALSE);
@@ -117,6 +117,9 @@ AOSet::AOSet(const LLUUID inventoryID)
 		mStates[index].mCycleTime=0.0f;
 		mStates[index].mDirty=FALSE;
 		mStateNames.push_back(stateNameList[0]);
+
+		// the swimming states reuse flying motions, keep the first state for each
+		mRemapIDMap.insert(std::make_pair(stateUUIDs[index],index));
 	}
 	stopTimer();
 }
@@ -149,12 +152,10 @@ AOSet::AOState* AOSet::getStateByName(const std::string& name)
 
 AOSet::AOState* AOSet::getStateByRemapID(const LLUUID& id)
 {
-	for(S32 index=0;index<AOSTATES_MAX;index++)
+	remap_map_t::const_iterator iter=mRemapIDMap.find(id);
+	if(iter!=mRemapIDMap.end())
 	{
-		if(mStates[index].mRemapID==id)
-		{
-			return &mStates[index];
-		}
+		return &mStates[iter->second];
 	}
 	return NULL;
 }
@@ -27,6 +27,8 @@
 #include "llcommon.h"
 #include "lleventtimer.h"
 
+#include <map>
+
 class AOSet
 :	public LLEventTimer
 {
@@ -136,6 +138,10 @@ class AOSet
 		BOOL mDirty;
 
 		AOState mStates[AOSTATES_MAX];
+
+		// motion UUID to index in mStates, called for every animation start and stop
+		typedef std::map<LLUUID,S32> remap_map_t;
+		remap_map_t mRemapIDMap;
 };
 
 #endif // AOSET_H
@@ -25,6 +25,7 @@
 
 uniform mat4 modelview_matrix;
 uniform mat4 modelview_projection_matrix;
+uniform mat4 reflection_reproject;
 
 ATTRIBUTE vec3 position;
 
@@ -74,7 +75,7 @@ void main()
 	vary_position = modelview_matrix * oPosition;
 	oPosition = modelViewProj * oPosition;
 	
-	refCoord.xyz = oPosition.xyz + vec3(0,0,0.2);
+	refCoord.xyz = (reflection_reproject * oPosition).xyz + vec3(0,0,0.2);
 	
 	//get wave position parameter (create sweeping horizontal waves)
 	vec3 v = pos.xyz;
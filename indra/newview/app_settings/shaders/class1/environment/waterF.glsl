@@ -48,6 +48,8 @@ uniform vec3 normScale;
 uniform float fresnelScale;
 uniform float fresnelOffset;
 uniform float blurMultiplier;
+uniform float refractionDistance;
+uniform vec4 waterFogColor;
 
 
 //bigWave is (refCoord.w, view.w);
@@ -126,7 +128,14 @@ void main()
 	//figure out distortion vector (ripply)   
 	vec2 distort2 = distort+wavef.xy*refScale/max(dmod*df1, 1.0);
 		
-	vec4 fb = texture2D(screenTex, distort2);
+	//past refractionDistance the distortion map is left alone, fade to fog color
+	//over the last 10% of the distance to hide the edge
+	float refract = clamp((refractionDistance - dist2) / (refractionDistance * 0.1), 0.0, 1.0);
+	vec4 fb = waterFogColor;
+	if (refract > 0.0)
+	{
+		fb = mix(waterFogColor, texture2D(screenTex, distort2), refract);
+	}
 	
 	//mix with reflection
 	// Note we actually want to use just df1, but multiplying by 0.999999 gets around and nvidia compiler bug
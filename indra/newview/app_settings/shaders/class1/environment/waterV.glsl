@@ -25,6 +25,7 @@
 
 uniform mat4 modelview_matrix;
 uniform mat4 modelview_projection_matrix;
+uniform mat4 reflection_reproject;
 
 ATTRIBUTE vec3 position;
 
@@ -69,7 +70,7 @@ void main()
 	oPosition = vec4(lpos, 1.0);
 	oPosition.z = mix(oPosition.z, max(eyeVec.z*0.75, 0.0), d);
 	oPosition = modelViewProj * oPosition;
-	refCoord.xyz = oPosition.xyz + vec3(0,0,0.2);
+	refCoord.xyz = (reflection_reproject * oPosition).xyz + vec3(0,0,0.2);
 	
 	//get wave position parameter (create sweeping horizontal waves)
 	vec3 v = lpos;
@@ -1102,16 +1102,10 @@ bool JCExportTracker::getAsyncData(LLViewerObject * obj)
 			llinfos << "Skipping requesting properties on " << obj->getID() << ", we already have them." << llendl;
 			already_requested_prop = true;
 		}*/
-		std::list<PropertiesRequest_t *>::iterator iter=requested_properties.begin();
-		for(;iter!=requested_properties.end();iter++)
+		if(mPendingPropertyIDs.count(obj->getLocalID()))
 		{
-			PropertiesRequest_t * req=(*iter);
-			if(req->localID==obj->getLocalID())
-			{
-				//cmdline_printchat("BREAK: have properties for: " + llformat("%d",obj->getLocalID()));
-				already_requested_prop = true;
-				break;	
-			}
+			//cmdline_printchat("BREAK: have properties for: " + llformat("%d",obj->getLocalID()));
+			already_requested_prop = true;
 		}
 			
 		if(already_requested_prop == false)
@@ -1123,6 +1117,7 @@ bool JCExportTracker::getAsyncData(LLViewerObject * obj)
 			req->num_retries = 0;	
 			req->localID=obj->getLocalID();
 			requested_properties.push_back(req);
+			mPendingPropertyIDs.insert(req->localID);
 			//cmdline_printchat("queued property request for: " + llformat("%d",obj->getLocalID()));
 
 		}
@@ -1282,16 +1277,33 @@ void JCExportTracker::removeObject(LLViewerObject* obj)
 	gMessageSystem->sendReliable(gAgent.getRegionHost());
 }
 
-void JCExportTracker::requestPrimProperties(U32 localID)
+// Selects the prims in as few ObjectSelect messages as will hold them,
+// rather than one message per prim.
+void JCExportTracker::requestPrimProperties(const std::vector<U32>& local_ids)
 {
-	gMessageSystem->newMessageFast(_PREHASH_ObjectSelect);
-	gMessageSystem->nextBlockFast(_PREHASH_AgentData);
-	gMessageSystem->addUUIDFast(_PREHASH_AgentID, gAgent.getID());
-	gMessageSystem->addUUIDFast(_PREHASH_SessionID, gAgent.getSessionID());
-	gMessageSystem->nextBlockFast(_PREHASH_ObjectData);
-    gMessageSystem->addU32Fast(_PREHASH_ObjectLocalID, localID);
-
-    gMessageSystem->sendReliable(gAgent.getRegionHost());
+	const U32 MAX_OBJECTS_PER_PACKET = 254;
+	U32 in_packet = 0;
+	for (std::vector<U32>::const_iterator iter = local_ids.begin(); iter != local_ids.end(); ++iter)
+	{
+		if (in_packet == 0)
+		{
+			gMessageSystem->newMessageFast(_PREHASH_ObjectSelect);
+			gMessageSystem->nextBlockFast(_PREHASH_AgentData);
+			gMessageSystem->addUUIDFast(_PREHASH_AgentID, gAgent.getID());
+			gMessageSystem->addUUIDFast(_PREHASH_SessionID, gAgent.getSessionID());
+		}
+		gMessageSystem->nextBlockFast(_PREHASH_ObjectData);
+		gMessageSystem->addU32Fast(_PREHASH_ObjectLocalID, *iter);
+		if (++in_packet >= MAX_OBJECTS_PER_PACKET || gMessageSystem->isSendFull(NULL))
+		{
+			gMessageSystem->sendReliable(gAgent.getRegionHost());
+			in_packet = 0;
+		}
+	}
+	if (in_packet > 0)
+	{
+		gMessageSystem->sendReliable(gAgent.getRegionHost());
+	}
 }
 
 class CacheReadResponder : public LLTextureCache::ReadResponder
@@ -1582,11 +1594,13 @@ void JCExportTracker::doexportworker(void *userdata)
 	
 	int kick_count=0;
 	int total=requested_properties.size();
+	std::vector<U32> kicked_ids;
+	time_t tnow=time(NULL);
+	U32 max_retries = gSavedSettings.getU32("ExporterNumberRetrys");
 	// Check for requested properties that are taking too long
 	while(total!=0)
 	{
 		std::list<PropertiesRequest_t*>::iterator iter;
-		time_t tnow=time(NULL);
 		
 		PropertiesRequest_t * req;
 		iter=requested_properties.begin();
@@ -1595,17 +1609,18 @@ void JCExportTracker::doexportworker(void *userdata)
 		
 		if( (req->request_time+PROP_REQUEST_KICK)< tnow)
 		{
-			req->request_time=time(NULL);
+			req->request_time=tnow;
 			req->num_retries++;
 
-			requestPrimProperties(req->localID);
+			kicked_ids.push_back(req->localID);
 			kick_count++;
 			//cmdline_printchat("requested property for: " + llformat("%d",req->localID));
 		}
-		if (req->num_retries < gSavedSettings.getU32("ExporterNumberRetrys"))
+		if (req->num_retries < max_retries)
 			requested_properties.push_back(req);
 		else
 		{
+			mPendingPropertyIDs.erase(req->localID);
 			//req->localID->mPropertiesRecieved = true;		
 			cmdline_printchat("failed to retrieve properties for ");// + req->localID);
 			//mPropertiesReceived++;
@@ -1622,6 +1637,7 @@ void JCExportTracker::doexportworker(void *userdata)
 
 		total--;
 	}
+	requestPrimProperties(kicked_ids);
 
 	kick_count=0;
 	total=requested_inventory.size();
@@ -1856,11 +1872,13 @@ void JCExportTracker::dopropertyworker(void *userdata)
 	
 	int kick_count=0;
 	int total = requested_properties.size();
+	std::vector<U32> kicked_ids;
+	time_t tnow=time(NULL);
+	U32 max_retries = gSavedSettings.getU32("ExporterNumberRetrys");
 	// Check for requested properties that are taking too long
 	while(total!=0)
 	{
 		std::list<PropertiesRequest_t*>::iterator iter;
-		time_t tnow=time(NULL);
 		
 		PropertiesRequest_t * req;
 		iter=requested_properties.begin();
@@ -1869,17 +1887,18 @@ void JCExportTracker::dopropertyworker(void *userdata)
 		
 		if( (req->request_time+PROP_REQUEST_KICK) < tnow)
 		{
-			req->request_time=time(NULL);
+			req->request_time=tnow;
 			req->num_retries++;
 
-			requestPrimProperties(req->localID);
+			kicked_ids.push_back(req->localID);
 			kick_count++;
 			//cmdline_printchat("requested property for: " + llformat("%d",req->localID));
 		}
-		if (req->num_retries < gSavedSettings.getU32("ExporterNumberRetrys"))
+		if (req->num_retries < max_retries)
 			requested_properties.push_back(req);
 		else
 		{
+			mPendingPropertyIDs.erase(req->localID);
 			//req->localID->mPropertiesRecieved = true;		
 			cmdline_printchat("failed to retrieve properties for ");// + req->localID);
 			//mPropertiesReceived++;
@@ -1901,6 +1920,7 @@ void JCExportTracker::dopropertyworker(void *userdata)
 
 		total--;
 	}
+	requestPrimProperties(kicked_ids);
 }
 
 void JCExportTracker::finalize()
@@ -2563,6 +2583,7 @@ void JCExportTracker::actuallyprocessObjectProperties(LLMessageSystem* msg)
 			req=(*iter);
 			if(id==req->target_prim)
 			{
+				mPendingPropertyIDs.erase(req->localID);
 				free(req);
 				requested_properties.erase(iter);
 				if(mStatus == EXPORTING)
@@ -3124,6 +3145,7 @@ void JCExportTracker::cleanup()
 	
 	mRequestedTextures.clear();
 	requested_properties.clear();
+	mPendingPropertyIDs.clear();
 
 	std::list<InventoryRequest_t*>::iterator iter3=requested_inventory.begin();
 	for(;iter3!=requested_inventory.end();iter3++)
@@ -176,7 +176,7 @@ public:
 	static BOOL mirror(LLInventoryObject* item, LLViewerObject* container = NULL, std::string root = "", std::string iname = "");
 private:
 	LLSD* subserialize(LLViewerObject* linkset);
-	static void requestPrimProperties(U32 localID);
+	static void requestPrimProperties(const std::vector<U32>& local_ids);
 	void download(LLInventoryObject* item, LLViewerObject* container = NULL, std::string root = "", std::string iname = ""); //for adding to export floater and download using mirror
 
 	U32 mStatus;
@@ -213,6 +213,7 @@ public:
 	std::set<LLUUID> mRequestedTextures;
 
 	std::list<PropertiesRequest_t*> requested_properties;
+	std::set<U32> mPendingPropertyIDs;	// local ids in requested_properties, for quick duplicate checks
 	std::list<InventoryRequest_t*> requested_inventory;
 
 	std::list<LLSD *> processed_prims;
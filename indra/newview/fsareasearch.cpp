@@ -50,6 +50,7 @@
 
 const std::string request_string = "FSAreaSearch::Requested_";
 const F32 min_refresh_interval = 0.25f;	// Minimum interval between list refreshes in seconds.
+const S32 max_requests_per_refresh = 64;	// Property requests sent per refresh, so a big sim isn't flooded.
 
 
 class FSAreaSearch::FSParcelChangeObserver : public LLParcelObserver
@@ -72,7 +73,8 @@ private:
 FSAreaSearch::FSAreaSearch(const LLSD& key) :  
 LLFloater(key),
 mCounterText(0),
-mResultList(0)
+mResultList(0),
+mRefreshPending(false)
 {
 	mLastUpdateTimer.reset();
 }
@@ -108,6 +110,18 @@ BOOL FSAreaSearch::postBuild()
 	return TRUE;
 }
 
+//virtual
+void FSAreaSearch::draw()
+{
+	// name and property replies arrive one object at a time; fold them
+	// into one list refresh per interval
+	if (mRefreshPending && mLastUpdateTimer.getElapsedTimeF32() >= min_refresh_interval)
+	{
+		results();
+	}
+	LLFloater::draw();
+}
+
 void FSAreaSearch::checkRegion()
 {
 	// Check if we changed region, and if we did, clear the object details cache.
@@ -196,7 +210,13 @@ void FSAreaSearch::requestIfNeeded(LLViewerObject *objectp)
 void FSAreaSearch::results()
 {
 	if (!getVisible()) return;
-	if (mRequested > 0 && mLastUpdateTimer.getElapsedTimeF32() < min_refresh_interval) return;
+	if (mRequested > 0 && mLastUpdateTimer.getElapsedTimeF32() < min_refresh_interval)
+	{
+		mRefreshPending = true;
+		return;
+	}
+	mRefreshPending = false;
+	S32 requests_left = max_requests_per_refresh;
 
 	const LLUUID selected = mResultList->getCurrentID();
 	const S32 scrollpos = mResultList->getScrollPos();
@@ -214,13 +234,23 @@ void FSAreaSearch::results()
 				!objectp->flagTemporary() && !objectp->flagTemporaryOnRez())
 			{
 				LLUUID object_id = objectp->getID();
-				if (mObjectDetails.count(object_id) == 0)
+				LLFlatHashMap<LLUUID, AObjectDetails>::iterator found = mObjectDetails.find(object_id);
+				if (found == mObjectDetails.end())
 				{
-					requestIfNeeded(objectp);
+					if (requests_left > 0)
+					{
+						requestIfNeeded(objectp);
+						requests_left--;
+					}
+					else
+					{
+						// ask for the rest on the next pass
+						mRefreshPending = true;
+					}
 				}
 				else
 				{
-					AObjectDetails* details = &mObjectDetails[object_id];
+					AObjectDetails* details = &found->second;
 					std::string object_name = details->name;
 					std::string object_desc = details->desc;
 					std::string object_owner;
@@ -266,7 +296,7 @@ void FSAreaSearch::results()
 
 void FSAreaSearch::callbackLoadOwnerName(const LLUUID& id, const std::string& full_name)
 {
-	results();
+	mRefreshPending = true;
 }
 
 void FSAreaSearch::processObjectPropertiesFamily(LLMessageSystem* msg)
@@ -276,8 +306,9 @@ void FSAreaSearch::processObjectPropertiesFamily(LLMessageSystem* msg)
 	LLUUID object_id;
 	msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_ObjectID, object_id);
 
-	bool exists = (mObjectDetails.count(object_id) != 0);
-	AObjectDetails* details = &mObjectDetails[object_id];
+	LLFlatHashMap<LLUUID, AObjectDetails>::iterator found = mObjectDetails.find(object_id);
+	bool exists = (found != mObjectDetails.end());
+	AObjectDetails* details = exists ? &found->second : &mObjectDetails[object_id];
 	if (!exists || details->name == request_string)
 	{
 		// We cache unknown objects (to avoid having to request them later)
@@ -37,6 +37,7 @@
 #include "lluuid.h"
 #include "llstring.h"
 #include "llframetimer.h"
+#include "llflathashmap.h"
 
 class LLTextBox;
 class LLScrollListCtrl;
@@ -58,6 +59,7 @@ public:
 	virtual ~FSAreaSearch();
 
 	/*virtual*/ BOOL postBuild();
+	/*virtual*/ void draw();
 
 	void callbackLoadOwnerName(const LLUUID& id, const std::string& full_name);
 	void processObjectPropertiesFamily(LLMessageSystem* msg);
@@ -84,8 +86,9 @@ private:
 	LLTextBox* mCounterText;
 	LLScrollListCtrl* mResultList;
 	LLFrameTimer mLastUpdateTimer;
+	bool mRefreshPending;	// results() wanted again once min_refresh_interval has passed
 
-	std::map<LLUUID, AObjectDetails> mObjectDetails;
+	LLFlatHashMap<LLUUID, AObjectDetails> mObjectDetails;
 
 	std::string mSearchedName;
 	std::string mSearchedDesc;
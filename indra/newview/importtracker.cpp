@@ -1475,7 +1475,9 @@ void ImportTracker::plywoodtracker(void *userdata)
 	if( (gImportTracker.idle_time+MAX_IDLE_TIME)< tnow)
 	{
 		cmdline_printchat("timed out, rezzing new block");
-		gImportTracker.plywood_above_head();
+		// whatever was in flight isn't coming
+		gImportTracker.rez_in_flight = 0;
+		gImportTracker.rez_more();
 		gImportTracker.idle_time = tnow;
 	}
 }
@@ -1499,7 +1501,21 @@ void ImportTracker::import(LLSD& ls_data)
 	time_t tnow=time(NULL);
 	idle_time = tnow;
 
-	plywood_above_head();
+	rez_in_flight = 0;
+	rez_more();
+}
+
+// Keeps up to MAX_REZ_IN_FLIGHT blocks on their way from the sim, so the
+// build isn't paced by one round trip per prim.  Each block that arrives
+// takes the next prim in the linkset, whatever order they come back in.
+void ImportTracker::rez_more()
+{
+	while (rez_in_flight < MAX_REZ_IN_FLIGHT
+		   && (int)localids.size() + rez_in_flight < linkset.size())
+	{
+		plywood_above_head();
+		rez_in_flight++;
+	}
 }
 
 void ImportTracker::expectRez()
@@ -1640,6 +1656,10 @@ void ImportTracker::get_update(S32 newid, BOOL justCreated, BOOL createSelected)
 			
 			if (justCreated && (int)localids.size() < linkset.size())
 			{
+				if (rez_in_flight > 0)
+				{
+					rez_in_flight--;
+				}
 				localids.push_back(newid);
 				localids.sort();
 				localids.unique();
@@ -1730,7 +1750,7 @@ void ImportTracker::get_update(S32 newid, BOOL justCreated, BOOL createSelected)
 					time_t tnow=time(NULL);
 					idle_time = tnow;
 
-					plywood_above_head();
+					rez_more();
 					return;
 				}
 				else
@@ -8,6 +8,7 @@
 #define IMPORTTRACKER_H
 
 #define MAX_IDLE_TIME 20
+#define MAX_REZ_IN_FLIGHT 8	// plywood blocks asked for before the first one arrives
 
 #include "llchat.h"
 #include "llviewerobject.h"
@@ -93,9 +94,10 @@ class ImportTracker
 		state(IDLE),
 		last(0),
 		groupcounter(0),
-		updated(0)
+		updated(0),
+		rez_in_flight(0)
 		{ }
-		ImportTracker(LLSD &data) { state = IDLE; linkset = data; numberExpected=0;}
+		ImportTracker(LLSD &data) { state = IDLE; linkset = data; numberExpected=0; rez_in_flight=0;}
 		~ImportTracker() { localids.clear(); linkset.clear(); }
 	
 		//Chalice - support import of linkset groups
@@ -155,6 +157,7 @@ class ImportTracker
 		void link();
 		void wear(LLSD &prim);
 		void position(LLSD &prim);
+		void rez_more();
 	public:
 		void plywood_above_head();
 
@@ -170,6 +173,7 @@ class ImportTracker
 		LLQuaternion		rootrot;
 		std::list<S32>			localids;
 		int					updated;
+		int					rez_in_flight;	// plywood blocks requested but not yet created
 		LLVector3			linksetoffset;
 		LLVector3			initialPos;
 
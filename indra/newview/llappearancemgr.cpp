@@ -244,7 +244,9 @@ struct LLFoundData
 	LLFoundData() :
 		mAssetType(LLAssetType::AT_NONE),
 		mWearableType(LLWearableType::WT_INVALID),
-		mWearable(NULL) {}
+		mWearable(NULL),
+		mIsReplacement(false),
+		mFetchDone(false) {}
 
 	LLFoundData(const LLUUID& item_id,
 				const LLUUID& asset_id,
@@ -259,7 +261,8 @@ struct LLFoundData
 		mAssetType(asset_type),
 		mWearableType(wearable_type),
 		mIsReplacement(is_replacement),
-		mWearable( NULL ) {}
+		mWearable( NULL ),
+		mFetchDone(false) {}
 	
 	LLUUID mItemID;
 	LLUUID mAssetID;
@@ -268,6 +271,7 @@ struct LLFoundData
 	LLWearableType::EType mWearableType;
 	LLWearable* mWearable;
 	bool mIsReplacement;
+	bool mFetchDone;	// asset callback has come back, successful or not
 };
 
 	
@@ -288,9 +292,10 @@ public:
 	bool pollMissingWearables();
 	bool isMissingCompleted();
 	void recoverMissingWearable(LLWearableType::EType type);
+	void recoverFailedWearable(LLWearableType::EType type);
 	void clearCOFLinksForMissingWearables();
 	
-	void onWearableAssetFetch(LLWearable *wearable);
+	void onWearableAssetFetch(const LLUUID& asset_id, LLWearable *wearable);
 	void onAllComplete();
 
 // [SL:KB] - Patch: Appearance-COFCorruption | Checked: 2010-04-14 (Catznip-3.0.0a) | Added: Catznip-2.0.0a
@@ -302,7 +307,6 @@ public:
 	void eraseTypeToLink(LLWearableType::EType type);
 	void eraseTypeToRecover(LLWearableType::EType type);
 //	void setObjItems(const LLInventoryModel::item_array_t& items);
-	void setGestItems(const LLInventoryModel::item_array_t& items);
 	bool isMostRecent();
 	void handleLateArrivals();
 	void resetTime(F32 timeout);
@@ -310,7 +314,6 @@ public:
 private:
 	found_list_t mFoundList;
 //	LLInventoryModel::item_array_t mObjItems;
-	LLInventoryModel::item_array_t mGestItems;
 	typedef std::set<S32> type_set_t;
 	type_set_t mTypesToRecover;
 	type_set_t mTypesToLink;
@@ -381,11 +384,6 @@ void LLWearableHoldingPattern::eraseTypeToRecover(LLWearableType::EType type)
 //	mObjItems = items;
 //}
 
-void LLWearableHoldingPattern::setGestItems(const LLInventoryModel::item_array_t& items)
-{
-	mGestItems = items;
-}
-
 bool LLWearableHoldingPattern::isFetchCompleted()
 {
 	return (mResolved >= (S32)getFoundList().size()); // have everything we were waiting for?
@@ -396,6 +394,17 @@ bool LLWearableHoldingPattern::isTimedOut()
 	return mWaitTime.hasExpired();
 }
 
+// If at least one wearable of certain types (pants/shirt/skirt)
+// was requested but none was found, create a default asset as a replacement.
+// In all other cases, don't do anything.
+// For critical types (shape/hair/skin/eyes), this will keep the avatar as a cloud 
+// due to logic in LLVOAvatarSelf::getIsCloud().
+// For non-critical types (tatoo, socks, etc.) the wearable will just be missing.
+static bool is_recoverable_type(S32 type)
+{
+	return (type == LLWearableType::WT_PANTS) || (type == LLWearableType::WT_SHIRT) || (type == LLWearableType::WT_SKIRT);
+}
+
 void LLWearableHoldingPattern::checkMissingWearables()
 {
 	if (!isMostRecent())
@@ -422,15 +431,9 @@ void LLWearableHoldingPattern::checkMissingWearables()
 		}
 		if (found_by_type[type] > 0)
 			continue;
-		if (
-			// If at least one wearable of certain types (pants/shirt/skirt)
-			// was requested but none was found, create a default asset as a replacement.
-			// In all other cases, don't do anything.
-			// For critical types (shape/hair/skin/eyes), this will keep the avatar as a cloud 
-			// due to logic in LLVOAvatarSelf::getIsCloud().
-			// For non-critical types (tatoo, socks, etc.) the wearable will just be missing.
-			(requested_by_type[type] > 0) &&  
-			((type == LLWearableType::WT_PANTS) || (type == LLWearableType::WT_SHIRT) || (type == LLWearableType::WT_SKIRT)))
+		// recoverFailedWearable() may already have started on this one
+		if ((requested_by_type[type] > 0) && is_recoverable_type(type) &&
+			(mTypesToLink.find(type) == mTypesToLink.end()))
 		{
 			mTypesToRecover.insert(type);
 			mTypesToLink.insert(type);
@@ -458,25 +461,6 @@ void LLWearableHoldingPattern::onAllComplete()
 		llwarns << "skipping because LLWearableHolding pattern is invalid (superceded by later outfit request)" << llendl;
 	}
 
-	// Activate all gestures in this folder
-	if (mGestItems.count() > 0)
-	{
-		llinfos << "Activating " << mGestItems.count() << " gestures" << llendl;
-		
-		LLGestureMgr::instance().activateGestures(mGestItems);
-		
-		// Update the inventory item labels to reflect the fact
-		// they are active.
-		LLViewerInventoryCategory* catp =
-			gInventory.getCategory(LLAppearanceMgr::instance().getCOF());
-		
-		if (catp)
-		{
-			gInventory.updateCategory(catp);
-			gInventory.notifyObservers();
-		}
-	}
-
 	// Update wearables.
 	llinfos << "Updating agent wearables with " << mResolved << " wearable items " << llendl;
 	LLAppearanceMgr::instance().updateAgentWearables(this, false);
@@ -674,6 +658,33 @@ void LLWearableHoldingPattern::recoverMissingWearable(LLWearableType::EType type
 						  cb);
 }
 
+// Starts the replacement for a type as soon as every fetch for it has
+// failed, so the inventory round trips overlap the rest of the fetch
+// instead of waiting behind the slowest wearable.
+void LLWearableHoldingPattern::recoverFailedWearable(LLWearableType::EType type)
+{
+	if (!isMostRecent() || !is_recoverable_type(type) ||
+		(mTypesToLink.find(type) != mTypesToLink.end()))
+	{
+		return;
+	}
+
+	for (found_list_t::iterator it = getFoundList().begin(); it != getFoundList().end(); ++it)
+	{
+		LLFoundData &data = *it;
+		if ((data.mWearableType == type) && (data.mWearable || !data.mFetchDone))
+		{
+			// still possible to get one of these
+			return;
+		}
+	}
+
+	llwarns << "all fetches failed for type " << type << ", replacing early" << llendl;
+	mTypesToRecover.insert(type);
+	mTypesToLink.insert(type);
+	recoverMissingWearable(type);
+}
+
 bool LLWearableHoldingPattern::isMissingCompleted()
 {
 	return mTypesToLink.size()==0 && mTypesToRecover.size()==0;
@@ -842,7 +853,7 @@ void LLWearableHoldingPattern::resetTime(F32 timeout)
 	mWaitTime.setTimerExpirySec(timeout);
 }
 
-void LLWearableHoldingPattern::onWearableAssetFetch(LLWearable *wearable)
+void LLWearableHoldingPattern::onWearableAssetFetch(const LLUUID& asset_id, LLWearable *wearable)
 {
 	if (!isMostRecent())
 	{
@@ -870,17 +881,20 @@ void LLWearableHoldingPattern::onWearableAssetFetch(LLWearable *wearable)
 		return;
 	}
 
-	if (!wearable)
-	{
-		return;
-	}
-
+	LLWearableType::EType failed_type = LLWearableType::WT_INVALID;
 	for (LLWearableHoldingPattern::found_list_t::iterator iter = getFoundList().begin();
 		 iter != getFoundList().end(); ++iter)
 	{
 		LLFoundData& data = *iter;
-		if(wearable->getAssetID() == data.mAssetID)
+		if(asset_id == data.mAssetID)
 		{
+			data.mFetchDone = true;
+			if (!wearable)
+			{
+				failed_type = data.mWearableType;
+				continue;
+			}
+
 			// Failing this means inventory or asset server are corrupted in a way we don't handle.
 			if ((data.mWearableType >= LLWearableType::WT_COUNT) || (wearable->getType() != data.mWearableType))
 			{
@@ -891,12 +905,30 @@ void LLWearableHoldingPattern::onWearableAssetFetch(LLWearable *wearable)
 			data.mWearable = wearable;
 		}
 	}
+
+	if (failed_type < LLWearableType::WT_COUNT)
+	{
+		recoverFailedWearable(failed_type);
+	}
 }
 
+// The asset callback only hands back the wearable, which is NULL on failure,
+// so each request carries the asset it was for.
+struct LLWearableFetchData
+{
+	LLWearableFetchData(LLWearableHoldingPattern* holder, const LLUUID& asset_id) :
+		mHolder(holder),
+		mAssetID(asset_id) {}
+
+	LLWearableHoldingPattern* mHolder;
+	LLUUID mAssetID;
+};
+
 static void onWearableAssetFetch(LLWearable* wearable, void* data)
 {
-	LLWearableHoldingPattern* holder = (LLWearableHoldingPattern*)data;
-	holder->onWearableAssetFetch(wearable);
+	LLWearableFetchData* fetch_data = (LLWearableFetchData*)data;
+	fetch_data->mHolder->onWearableAssetFetch(fetch_data->mAssetID, wearable);
+	delete fetch_data;
 }
 
 
@@ -2040,10 +2072,27 @@ void LLAppearanceMgr::updateAppearanceFromCOF(bool update_base_outfit_ordering)
 	sortItemsByActualDescription(wear_items);
 
 
+	// Gestures don't depend on any wearable, so start them now and let their
+	// assets load alongside the wearables rather than after them.
+	if (gest_items.count() > 0)
+	{
+		llinfos << "Activating " << gest_items.count() << " gestures" << llendl;
+		
+		LLGestureMgr::instance().activateGestures(gest_items);
+		
+		// Update the inventory item labels to reflect the fact
+		// they are active.  The idle notify picks this up, notifying
+		// from in here would re-enter updateAppearanceFromCOF().
+		LLViewerInventoryCategory* catp = gInventory.getCategory(getCOF());
+		if (catp)
+		{
+			gInventory.updateCategory(catp);
+		}
+	}
+
 	LLWearableHoldingPattern* holder = new LLWearableHoldingPattern;
 
 //	holder->setObjItems(obj_items);
-	holder->setGestItems(gest_items);
 		
 	// Note: can't do normal iteration, because if all the
 	// wearables can be resolved immediately, then the
@@ -2119,7 +2168,7 @@ void LLAppearanceMgr::updateAppearanceFromCOF(bool update_base_outfit_ordering)
 											found.mName,
 											found.mAssetType,
 											onWearableAssetFetch,
-											(void*)holder);
+											(void*)new LLWearableFetchData(holder, found.mAssetID));
 
 	}
 
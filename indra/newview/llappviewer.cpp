@@ -183,6 +183,9 @@
 #include "llvoavatar.h"
 #include "llfolderview.h"
 #include "llagentpilot.h"
+#include "llbenchmarktester.h"
+#include "llhitchdetector.h"
+#include "llmemoryusage.h"
 #include "llvovolume.h"
 #include "llflexibleobject.h" 
 #include "llvosurfacepatch.h"
@@ -192,6 +195,7 @@
 #include "llfloaterreg.h"
 #include "llfloatersnapshot.h"
 #include "llfloaterinventory.h"
+#include "llframebudget.h"
 
 // includes for idle() idleShutdown()
 #include "llviewercontrol.h"
@@ -286,6 +290,9 @@ LLFrameTimer gForegroundTime;
 LLFrameTimer gLoggedInTime;
 LLTimer gLogoutTimer;
 static const F32 LOGOUT_REQUEST_TIME = 6.f;  // this will be cut short by the LogoutReply msg.
+
+// Above this region ping (ms) camera-only agent updates go out at half rate
+static const U32 SLOW_LINK_PING_MS = 400;
 F32 gLogoutMaxTime = LOGOUT_REQUEST_TIME;
 
 BOOL				gDisconnected = FALSE;
@@ -541,6 +548,8 @@ static void settings_to_globals()
 	LLRender::sGLCoreProfile = gSavedSettings.getBOOL("RenderGLCoreProfile");
 
 	LLImageGL::sGlobalUseAnisotropic	= gSavedSettings.getBOOL("RenderAnisotropic");
+	LLImageGL::sUsePixelBufferUpload	= gSavedSettings.getBOOL("RenderTextureUploadPBO");
+	LLImageGL::sCompressTextures		= gSavedSettings.getBOOL("RenderCompressTextures");
 	LLVOVolume::sLODFactor				= gSavedSettings.getF32("RenderVolumeLODFactor");
 	LLVOVolume::sDistanceFactor			= 1.f-LLVOVolume::sLODFactor * 0.1f;
 	LLVolumeImplFlexible::sUpdateFactor = gSavedSettings.getF32("RenderFlexTimeFactor");
@@ -738,6 +747,7 @@ bool LLAppViewer::init()
     LLCurl::initClass(gSavedSettings.getF32("CurlRequestTimeOut"), 
 						gSavedSettings.getS32("CurlMaximumNumberOfHandles"), 
 						gSavedSettings.getBOOL("CurlUseMultipleThreads"));
+	LLCurl::setMaxHostConnections(gSavedSettings.getS32("CurlMaxConnectionsPerHost"));
 	LL_INFOS("InitInfo") << "LLCurl initialized." << LL_ENDL ;
 
     LLMachineID::init();
@@ -921,6 +931,8 @@ bool LLAppViewer::init()
 	initWindow();
 	LL_INFOS("InitInfo") << "Window is initialized." << LL_ENDL ;
 
+	LLBenchmarkTester::initClass();
+
 	// initWindow also initializes the Feature List, so now we can initialize this global.
 	LLCubeMap::sUseCubeMaps = LLFeatureManager::getInstance()->isFeatureAvailable("RenderCubeMap");
 
@@ -1148,6 +1160,7 @@ static LLFastTimer::DeclareTimer FTM_PUMP_SERVICE("Service");
 static LLFastTimer::DeclareTimer FTM_SERVICE_CALLBACK("Callback");
 static LLFastTimer::DeclareTimer FTM_AGENT_AUTOPILOT("Autopilot");
 static LLFastTimer::DeclareTimer FTM_AGENT_UPDATE("Update");
+static LLFastTimer::DeclareTimer FTM_MAINLOOP_LISTENERS("Mainloop Listeners");
 
 bool LLAppViewer::mainLoop()
 {
@@ -1188,6 +1201,7 @@ bool LLAppViewer::mainLoop()
 	while (!LLApp::isExiting())
 	{
 		LLFastTimer::nextFrame(); // Should be outside of any timer instances
+		LLHitchDetector::frameStarted();
 
 		//clear call stack records
 		llclearcallstacks;
@@ -1235,7 +1249,10 @@ bool LLAppViewer::mainLoop()
 			}			
 
             // canonical per-frame event
-            mainloop.post(newFrame);
+			{
+				LLFastTimer t2(FTM_MAINLOOP_LISTENERS);
+				mainloop.post(newFrame);
+			}
 
 			if (!LLApp::isExiting())
 			{
@@ -1301,7 +1318,9 @@ bool LLAppViewer::mainLoop()
 				{
 					pingMainloopTimeout("Main:Display");
 					gGLActive = TRUE;
+					LLTimer display_timer;
 					display();
+					gPipeline.updateDynamicResolution(display_timer.getElapsedTimeF32());
 					pingMainloopTimeout("Main:Snapshot");
 					LLFloaterSnapshot::update(); // take snapshots
 					gGLActive = FALSE;
@@ -1419,6 +1438,22 @@ bool LLAppViewer::mainLoop()
 					LLLFSThread::sLocal->pause(); 
 				}									
 
+				LLHitchDetector::frameEnded(frameTimer.getElapsedTimeF64());
+
+				//frame pacing, hold every frame to the same length instead of letting it swing with load
+				static LLCachedControl<U32> frame_rate_limit(gSavedSettings, "FrameRateLimit");
+				if (frame_rate_limit > 0)
+				{
+					const F64 frame_length = 1.0 / (F64) (U32) frame_rate_limit;
+					while (frameTimer.getElapsedTimeF64() < frame_length - 0.002)
+					{
+						ms_sleep(1);
+					}
+					while (frameTimer.getElapsedTimeF64() < frame_length)
+					{ //spin out the last couple of milliseconds, sleep granularity is too coarse for this
+					}
+				}
+
 				if ((LLStartUp::getStartupState() >= STATE_CLEANUP) &&
 					(frameTimer.getElapsedTimeF64() > FRAME_STALL_THRESHOLD))
 				{
@@ -1519,6 +1554,7 @@ bool LLAppViewer::cleanup()
 			gDirUtilp->getExpandedFilename(LL_PATH_LOGS, report_name));		
 	}
 	LLMetricPerformanceTesterBasic::cleanClass();
+	LLHitchDetector::cleanupClass();
 
 	// remove any old breakpad minidump files from the log directory
 	if (! isError())
@@ -1967,10 +2003,18 @@ bool LLAppViewer::initThreads()
 	LLImage::initClass();
 
 	LLVFSThread::initClass(enable_threads && false);
-	LLLFSThread::initClass(enable_threads && false);
+	// Local file reads and writes (texture cache local files, decoded sounds)
+	U32 lfs_threads = gSavedSettings.getU32("LocalFileIOThreads");
+	LLLFSThread::initClass(enable_threads && lfs_threads > 0, lfs_threads);
 
 	// Image decoding
-	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true);
+	S32 decode_threads = (S32)gSavedSettings.getU32("ImageDecodeThreads");
+	if (decode_threads <= 0)
+	{
+		decode_threads = llclamp(gSysCPU.getProcessorCount() - 1, 1, 8);
+	}
+	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true, decode_threads);
+	llinfos << "Image decode threads: " << LLAppViewer::sImageDecodeThread->getPoolSize() << llendl;
 	LLAppViewer::sTextureCache = new LLTextureCache(enable_threads && true);
 	LLAppViewer::sTextureFetch = new LLTextureFetch(LLAppViewer::getTextureCache(),
 													sImageDecodeThread,
@@ -2184,6 +2228,11 @@ bool LLAppViewer::initConfiguration()
 	// - load per account settings (happens in llstartup
 	
 	// - load defaults
+	// defaults are read back from a binary copy once they have been parsed
+	std::string compiled_settings_dir = gDirUtilp->getExpandedFilename(LL_PATH_USER_SETTINGS, "compiled_settings");
+	LLFile::mkdir(compiled_settings_dir);
+	LLControlGroup::setCompiledSettingsDir(compiled_settings_dir);
+
 	bool set_defaults = true;
 	if(!loadSettingsFromDirectory("Default", set_defaults))
 	{
@@ -2464,6 +2513,25 @@ bool LLAppViewer::initConfiguration()
 		gAgentPilot.setReplaySession(TRUE);
 	}
 
+	if (clp.hasOption("benchmark"))
+	{
+		const LLCommandLineParser::token_vector_t& value = clp.getOption("benchmark");
+		std::string cache_mode = value.empty() ? std::string() : value.front();
+		if (cache_mode == "cold")
+		{
+			// initCache() has not run yet
+			gSavedSettings.setBOOL("PurgeCacheOnNextStartup", TRUE);
+		}
+		else if (cache_mode != "warm")
+		{
+			llwarns << "Usage: -benchmark <cold|warm>" << llendl;
+		}
+
+		gAgentPilot.setReplaySession(TRUE);
+		LLFastTimer::sMetricLog = TRUE;
+		LLFastTimer::sLogName = LLBenchmarkTester::sTesterName;
+	}
+
 	if (clp.hasOption("nonotifications"))
 	{
 		gSavedSettings.getControl("IgnoreAllNotifications")->setValue(true, false);
@@ -3014,7 +3082,8 @@ void LLAppViewer::cleanupSavedSettings()
 	gSavedSettings.setF32("MapScale", LLWorldMapView::sMapScale );
 
 	// Some things are cached in LLAgent.
-	if (gAgent.isInitialized())
+	// Adaptive quality only lowers the cached draw distance, keep the user's.
+	if (gAgent.isInitialized() && !LLFrameBudget::getInstance()->isReducing())
 	{
 		gSavedSettings.setF32("RenderFarClip", gAgentCamera.mDrawDistance);
 	}
@@ -3628,7 +3697,7 @@ U32 LLAppViewer::getObjectCacheVersion()
 {
 	// Viewer object cache version, change if object update
 	// format changes. JC
-	const U32 INDRA_OBJECT_CACHE_VERSION = 14;
+	const U32 INDRA_OBJECT_CACHE_VERSION = 15;
 
 	return INDRA_OBJECT_CACHE_VERSION;
 }
@@ -3716,6 +3785,9 @@ bool LLAppViewer::initCache()
 	S64 extra = LLAppViewer::getTextureCache()->initCache(LL_PATH_CACHE, texture_cache_size, texture_cache_mismatch);
 	texture_cache_size -= extra;
 
+	// Decoded mips are sized separately, 0 disables the tier
+	LLAppViewer::getTextureCache()->initDecodedCache((S64)gSavedSettings.getU32("TextureDecodedCacheSize") * MB);
+
 	LLVOCache::getInstance()->initCache(LL_PATH_CACHE, gSavedSettings.getU32("CacheNumberOfRegionsForObjects"), getObjectCacheVersion()) ;
 
 	LLSplashScreen::update(LLTrans::getString("StartupInitializingVFS"));
@@ -3883,6 +3955,7 @@ void LLAppViewer::purgeCache()
 	LLAppViewer::getTextureCache()->purgeCache(LL_PATH_CACHE);
 	LLVOCache::getInstance()->removeCache(LL_PATH_CACHE);
 	std::string mask = "*.*";
+	gDirUtilp->deleteFilesInDir(LLMeshRepoThread::getDecodedCacheDir(), mask);
 	gDirUtilp->deleteFilesInDir(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, ""), mask);
 }
 
@@ -4094,6 +4167,7 @@ void LLAppViewer::idle()
 	LLCriticalDamp::updateInterpolants();
 	LLMortician::updateClass();
 	LLFilePickerThread::clearDead();  //calls LLFilePickerThread::notify()
+	LLMemoryUsage::idle();
 
 	F32 dt_raw = idle_timer.getElapsedTimeAndResetF32();
 
@@ -4140,6 +4214,7 @@ void LLAppViewer::idle()
 		gGLActive = FALSE;
 	}
 
+	LLFrameBudget::getInstance()->update(dt_raw);
 	
     F32 yaw = 0.f;				// radians
 
@@ -4166,21 +4241,43 @@ void LLAppViewer::idle()
 			gAgentPilot.updateTarget();
 			gAgent.autoPilot(&yaw);
 		}
+
+		LLBenchmarkTester::updateClass();
     
 	    static LLFrameTimer agent_update_timer;
+	    static LLFrameTimer agent_force_update_timer;
 	    static U32 				last_control_flags;
     
 	    //	When appropriate, update agent location to the simulator.
 	    F32 agent_update_time = agent_update_timer.getElapsedTimeF32();
 	    BOOL flags_changed = gAgent.controlFlagsDirty() || (last_control_flags != gAgent.getControlFlags());
+
+	    // Between keepalives send_agent_update() drops updates whose camera
+	    // and body changes are under its thresholds.
+	    BOOL force_update = flags_changed
+			|| (agent_force_update_timer.getElapsedTimeF32() > (1.0f / (F32) AGENT_FORCE_UPDATES_PER_SECOND));
+
+	    // Slow links get half the rate for camera movement; control flag
+	    // changes still go out right away.
+	    F32 agent_update_interval = 1.0f / (F32) AGENT_UPDATES_PER_SECOND;
+	    LLViewerRegion* agent_region = gAgent.getRegion();
+	    LLCircuitData* cdp = agent_region ? gMessageSystem->mCircuitInfo.findCircuit(agent_region->getHost()) : NULL;
+	    if (cdp && cdp->getPingDelay() > SLOW_LINK_PING_MS)
+	    {
+		    agent_update_interval *= 2.f;
+	    }
 		    
-	    if (flags_changed || (agent_update_time > (1.0f / (F32) AGENT_UPDATES_PER_SECOND)))
+	    if (flags_changed || (agent_update_time > agent_update_interval))
 	    {
 		    LLFastTimer t(FTM_AGENT_UPDATE);
 		    // Send avatar and camera info
 		    last_control_flags = gAgent.getControlFlags();
-		    send_agent_update(TRUE);
+		    send_agent_update(force_update);
 		    agent_update_timer.reset();
+		    if (force_update)
+		    {
+			    agent_force_update_timer.reset();
+		    }
 	    }
 	}
 
@@ -4662,6 +4759,7 @@ void LLAppViewer::idleNameCache()
 
 #ifdef TIME_THROTTLE_MESSAGES
 #define CHECK_MESSAGES_DEFAULT_MAX_TIME .020f // 50 ms = 50 fps (just for messages!)
+#define CHECK_MESSAGES_MAX_TIME_CAP .080f // never let a packet burst take more than this per frame
 static F32 CheckMessagesMaxTime = CHECK_MESSAGES_DEFAULT_MAX_TIME;
 #endif
 
@@ -4678,6 +4776,9 @@ void LLAppViewer::idleNetwork()
 	pingMainloopTimeout("idleNetwork");
 	
 	gObjectList.mNumNewObjects = 0;
+	gObjectList.mNumCacheHits = 0;
+	gObjectList.mNumCacheMisses = 0;
+	gObjectList.mNumCacheDupes = 0;
 	S32 total_decoded = 0;
 
 	if (!gSavedSettings.getBOOL("SpeedTest"))
@@ -4725,7 +4826,9 @@ void LLAppViewer::idleNetwork()
 		if (total_time >= CheckMessagesMaxTime)
 		{
 			// Increase CheckMessagesMaxTime so that we will eventually catch up
-			CheckMessagesMaxTime *= 1.035f; // 3.5% ~= x2 in 20 frames, ~8x in 60 frames
+			// but stop growing once a single frame would visibly hitch, a region
+			// full of object updates is better spread over more frames
+			CheckMessagesMaxTime = llmin(CheckMessagesMaxTime * 1.035f, CHECK_MESSAGES_MAX_TIME_CAP); // 3.5% ~= x2 in 20 frames
 		}
 		else
 		{
@@ -4754,6 +4857,9 @@ void LLAppViewer::idleNetwork()
 		}
 	}
 	LLViewerStats::getInstance()->mNumNewObjectsStat.addValue(gObjectList.mNumNewObjects);
+	LLViewerStats::getInstance()->mObjectCacheHitStat.addValue(gObjectList.mNumCacheHits);
+	LLViewerStats::getInstance()->mObjectCacheMissStat.addValue(gObjectList.mNumCacheMisses);
+	LLViewerStats::getInstance()->mObjectCacheDupeStat.addValue(gObjectList.mNumCacheDupes);
 
 	// Retransmit unacknowledged packets.
 	gXferManager->retransmitUnackedPackets();
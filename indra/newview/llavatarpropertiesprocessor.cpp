@@ -31,6 +31,7 @@
 // Viewer includes
 #include "llagent.h"
 #include "llagentpicksinfo.h"
+#include "llcallbacklist.h"
 #include "lldateutil.h"
 #include "llviewergenericmessage.h"
 
@@ -41,6 +42,11 @@
 #include "llui.h"				// LLUI::getLanguage()
 #include "message.h"
 
+#include <boost/bind.hpp>
+
+// How long a profile's properties are answered from the cache
+const U32 PROPERTIES_CACHE_EXPIRE_SECS = 300;
+
 LLAvatarPropertiesProcessor::LLAvatarPropertiesProcessor()
 {
 }
@@ -121,6 +127,17 @@ void LLAvatarPropertiesProcessor::sendAvatarPropertiesRequest(const LLUUID& avat
 	// indicate we're going to make a request
 	addPendingRequest(avatar_id, APT_PROPERTIES);
 
+	properties_cache_t::const_iterator cached = mPropertiesCache.find(avatar_id);
+	if (cached != mPropertiesCache.end()
+		&& cached->second.mHasProperties && cached->second.mHasInterests
+		&& (U32)time(NULL) < cached->second.mTimestamp + PROPERTIES_CACHE_EXPIRE_SECS)
+	{
+		// answer like the network would, after the caller has finished
+		// registering its observers
+		doOnIdleOneTime(boost::bind(&LLAvatarPropertiesProcessor::replayCachedProperties, this, avatar_id));
+		return;
+	}
+
 	LLMessageSystem *msg = gMessageSystem;
 
 	msg->newMessageFast(_PREHASH_AvatarPropertiesRequest);
@@ -131,6 +148,25 @@ void LLAvatarPropertiesProcessor::sendAvatarPropertiesRequest(const LLUUID& avat
 	gAgent.sendReliableMessage();
 }
 
+void LLAvatarPropertiesProcessor::replayCachedProperties(const LLUUID& avatar_id)
+{
+	removePendingRequest(avatar_id, APT_PROPERTIES);
+
+	properties_cache_t::iterator cached = mPropertiesCache.find(avatar_id);
+	if (cached == mPropertiesCache.end())
+	{
+		// dropped by an update since it was scheduled, ask the server
+		sendAvatarPropertiesRequest(avatar_id);
+		return;
+	}
+
+	// copies, observers may change the cache while being notified
+	LLAvatarData avatar_data = cached->second.mProperties;
+	FSInterestsData interests_data = cached->second.mInterests;
+	notifyObservers(avatar_id, &avatar_data, APT_PROPERTIES);
+	notifyObservers(avatar_id, &interests_data, APT_INTERESTS_INFO);
+}
+
 void LLAvatarPropertiesProcessor::sendAvatarPicksRequest(const LLUUID& avatar_id)
 {
 	sendGenericRequest(avatar_id, APT_PICKS, "avatarpicksrequest");
@@ -168,6 +204,8 @@ void LLAvatarPropertiesProcessor::sendAvatarPropertiesUpdate(const LLAvatarData*
 
 	llinfos << "Sending avatarinfo update" << llendl;
 
+	mPropertiesCache.erase(gAgent.getID());
+
 	// This value is required by sendAvatarPropertiesUpdate method.
 	//A profile should never be mature. (From the original code)
 	BOOL mature = FALSE;
@@ -278,6 +316,12 @@ void LLAvatarPropertiesProcessor::processAvatarPropertiesReply(LLMessageSystem*
 	LLAvatarPropertiesProcessor* self = getInstance();
 	// Request processed, no longer pending
 	self->removePendingRequest(avatar_data.avatar_id, APT_PROPERTIES);
+
+	CachedProperties& cached = self->mPropertiesCache[avatar_data.avatar_id];
+	cached.mProperties = avatar_data;
+	cached.mHasProperties = true;
+	cached.mTimestamp = time(NULL);
+
 	self->notifyObservers(avatar_data.avatar_id,&avatar_data,APT_PROPERTIES);
 }
 
@@ -304,6 +348,12 @@ void LLAvatarPropertiesProcessor::processAvatarInterestsReply(LLMessageSystem* m
 	LLAvatarPropertiesProcessor* self = getInstance();
 	// Request processed, no longer pending
 	self->removePendingRequest(interests_data.avatar_id, APT_INTERESTS_INFO);
+
+	CachedProperties& cached = self->mPropertiesCache[interests_data.avatar_id];
+	cached.mInterests = interests_data;
+	cached.mHasInterests = true;
+	cached.mTimestamp = time(NULL);
+
 	self->notifyObservers(interests_data.avatar_id, &interests_data, APT_INTERESTS_INFO);  
 //</FS:KC legacy profiles>
 }
@@ -677,6 +727,8 @@ void LLAvatarPropertiesProcessor::sendInterestsInfoUpdate(const FSInterestsData*
 		return;
 	}
 
+	mPropertiesCache.erase(gAgent.getID());
+
 	LLMessageSystem* msg = gMessageSystem;
 
 	msg->newMessage(_PREHASH_AvatarInterestsUpdate);
@@ -206,6 +206,8 @@ public:
 
 	// Request various types of avatar data.  Duplicate requests will be
 	// suppressed while waiting for a response from the network.
+	// Properties seen in the last few minutes are answered from a cache
+	// on the next idle instead of going back to the server.
 	void sendAvatarPropertiesRequest(const LLUUID& avatar_id);
 	void sendAvatarPicksRequest(const LLUUID& avatar_id);
 	void sendAvatarNotesRequest(const LLUUID& avatar_id);
@@ -278,6 +280,10 @@ protected:
 	// Call this when the reply to the request is received
 	void removePendingRequest(const LLUUID& avatar_id, EAvatarProcessorType type);
 
+	// Notifies observers with the cached properties and interests for
+	// this avatar, if they are still there.
+	void replayCachedProperties(const LLUUID& avatar_id);
+
 	typedef void* (*processor_method_t)(LLMessageSystem*);
 	static processor_method_t getProcessor(EAvatarProcessorType type);
 
@@ -293,6 +299,21 @@ protected:
 	// Map avatar_id+request_type -> U32 timestamp in seconds
 	typedef std::map< std::pair<LLUUID, EAvatarProcessorType>, U32> timestamp_map_t;
 	timestamp_map_t mRequestTimestamps;
+
+	// The server answers AvatarPropertiesRequest with both a properties and
+	// an interests reply, so the two are cached together.
+	struct CachedProperties
+	{
+		CachedProperties() : mHasProperties(false), mHasInterests(false), mTimestamp(0) {}
+
+		LLAvatarData	mProperties;
+		FSInterestsData	mInterests;
+		bool			mHasProperties;
+		bool			mHasInterests;
+		U32				mTimestamp;		// seconds, of the newest reply
+	};
+	typedef std::map<LLUUID, CachedProperties> properties_cache_t;
+	properties_cache_t mPropertiesCache;
 };
 
 #endif  // LL_LLAVATARPROPERTIESPROCESSOR_H
@@ -0,0 +1,178 @@
+/** 
+ * @file llbenchmarktester.cpp
+ * @brief Frame time and rez metrics for replayed benchmark sessions
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llbenchmarktester.h"
+
+#include "llagentpilot.h"
+#include "llappviewer.h"
+#include "llfasttimer.h"
+#include "llmeshrepository.h"
+#include "lltexturefetch.h"
+#include "llviewercontrol.h"
+
+const std::string LLBenchmarkTester::sTesterName("benchmark");
+LLBenchmarkTester* LLBenchmarkTester::sInstance = NULL;
+
+//static
+void LLBenchmarkTester::initClass()
+{
+	if (!sInstance && LLMetricPerformanceTesterBasic::isMetricLogRequested(sTesterName))
+	{
+		sInstance = new LLBenchmarkTester();
+		if (!sInstance->isValid())
+		{
+			delete sInstance;
+			sInstance = NULL;
+		}
+	}
+}
+
+//static
+void LLBenchmarkTester::updateClass()
+{
+	if (sInstance)
+	{
+		sInstance->update();
+	}
+}
+
+LLBenchmarkTester::LLBenchmarkTester()
+:	LLMetricPerformanceTesterBasic(sTesterName),
+	mPlaying(FALSE),
+	mRezCompleteTime(-1.f)
+{
+	addMetric("Time");
+	addMetric("Frames");
+	addMetric("FrameTimeMean");
+	addMetric("FrameTimeMax");
+	addMetric("IdleTimeMean");
+	addMetric("RenderTimeMean");
+	addMetric("SwapTimeMean");
+	addMetric("TexturesPending");
+	addMetric("MeshesPending");
+	addMetric("RezCompleteTime");
+
+	resetSample();
+}
+
+LLBenchmarkTester::~LLBenchmarkTester()
+{
+	sInstance = NULL;
+}
+
+void LLBenchmarkTester::resetSample()
+{
+	mSampleTimer.reset();
+	mFrames = 0;
+	mFrameTimeTotal = 0.0;
+	mFrameTimeMax = 0.0;
+	mIdleTimeTotal = 0.0;
+	mRenderTimeTotal = 0.0;
+	mSwapTimeTotal = 0.0;
+	mTexturesPending = 0;
+	mMeshesPending = 0;
+}
+
+// adds the named timer's time for the last frame, inclusive of its children
+void LLBenchmarkTester::addFrameTimer(const char* name, F64& total_ms)
+{
+	const LLFastTimer::NamedTimer* timer = LLFastTimer::getTimerByName(name);
+	if (timer)
+	{
+		total_ms += timer->getHistoricalCount(0) * 1000.0 / (F64)LLFastTimer::countsPerSecond();
+	}
+}
+
+void LLBenchmarkTester::update()
+{
+	if (!gAgentPilot.isPlaying())
+	{
+		if (mPlaying)
+		{
+			// playback is over, flush the partial sample
+			mPlaying = FALSE;
+			if (mFrames)
+			{
+				outputTestResults();
+			}
+			resetSample();
+		}
+		return;
+	}
+
+	if (!mPlaying)
+	{
+		// samples line up with the recorded path, so only count from its start
+		mPlaying = TRUE;
+		mRunTimer.reset();
+		mRezCompleteTime = -1.f;
+		resetSample();
+		return;
+	}
+
+	F64 frame_ms = gFrameIntervalSeconds * 1000.0;
+	mFrames++;
+	mFrameTimeTotal += frame_ms;
+	mFrameTimeMax = llmax(mFrameTimeMax, frame_ms);
+	addFrameTimer("Idle", mIdleTimeTotal);
+	addFrameTimer("Render", mRenderTimeTotal);
+	addFrameTimer("Swap", mSwapTimeTotal);
+
+	// backlog at the end of the sample
+	mTexturesPending = LLAppViewer::getTextureFetch()->getNumRequests();
+	mMeshesPending = LLMeshRepository::sLODPending + LLMeshRepository::sLODProcessing;
+	if (mRezCompleteTime < 0.f && !mTexturesPending && !mMeshesPending)
+	{
+		mRezCompleteTime = mRunTimer.getElapsedTimeF32();
+	}
+
+	static LLCachedControl<F32> sample_interval(gSavedSettings, "BenchmarkSampleInterval");
+	if (mSampleTimer.getElapsedTimeF32() >= sample_interval)
+	{
+		outputTestResults();
+		resetSample();
+	}
+}
+
+//virtual
+void LLBenchmarkTester::outputTestRecord(LLSD* sd)
+{
+	std::string label = getCurrentLabelName();
+	F64 frames = llmax(mFrames, 1);
+
+	(*sd)[label]["Time"]			= (LLSD::Real)mRunTimer.getElapsedTimeF32();
+	(*sd)[label]["Frames"]			= (LLSD::Integer)mFrames;
+	(*sd)[label]["FrameTimeMean"]	= (LLSD::Real)(mFrameTimeTotal / frames);
+	(*sd)[label]["FrameTimeMax"]	= (LLSD::Real)mFrameTimeMax;
+	(*sd)[label]["IdleTimeMean"]	= (LLSD::Real)(mIdleTimeTotal / frames);
+	(*sd)[label]["RenderTimeMean"]	= (LLSD::Real)(mRenderTimeTotal / frames);
+	(*sd)[label]["SwapTimeMean"]	= (LLSD::Real)(mSwapTimeTotal / frames);
+	(*sd)[label]["TexturesPending"]	= (LLSD::Integer)mTexturesPending;
+	(*sd)[label]["MeshesPending"]	= (LLSD::Integer)mMeshesPending;
+	(*sd)[label]["RezCompleteTime"]	= (LLSD::Real)mRezCompleteTime;
+}
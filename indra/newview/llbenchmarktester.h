@@ -0,0 +1,77 @@
+/** 
+ * @file llbenchmarktester.h
+ * @brief Frame time and rez metrics for replayed benchmark sessions
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLBENCHMARKTESTER_H
+#define LL_LLBENCHMARKTESTER_H
+
+#include "llmetricperformancetester.h"
+#include "lltimer.h"
+
+// Samples frame times, a few fast timers and texture/mesh backlog while
+// LLAgentPilot plays back a session, one record per sample interval.
+// Playback is deterministic, so record N of two runs covers the same stretch
+// of the path and --analyzeperformance can diff them.
+//
+// Run with: --benchmark <cold|warm> [--graphicslevel <0-3>] [--analyzeperformance]
+class LLBenchmarkTester : public LLMetricPerformanceTesterBasic
+{
+public:
+	LLBenchmarkTester();
+	~LLBenchmarkTester();
+
+	// creates the tester if "--logmetrics benchmark" (or the catch all) was given
+	static void initClass();
+	// call once a frame
+	static void updateClass();
+
+	static const std::string sTesterName;
+
+private:
+	void update();
+	void resetSample();
+	void addFrameTimer(const char* name, F64& total_ms);
+
+	/*virtual*/ void outputTestRecord(LLSD* sd);
+
+	static LLBenchmarkTester* sInstance;
+
+	BOOL	mPlaying;
+	LLTimer	mRunTimer;		// since playback started
+	LLTimer	mSampleTimer;	// since the current sample started
+	F32		mRezCompleteTime;	// first time nothing was left to fetch, -1 until then
+
+	// current sample
+	S32		mFrames;
+	F64		mFrameTimeTotal;	// ms
+	F64		mFrameTimeMax;
+	F64		mIdleTimeTotal;
+	F64		mRenderTimeTotal;
+	F64		mSwapTimeTotal;	// mostly waiting on the GPU
+	S32		mTexturesPending;
+	S32		mMeshesPending;
+};
+
+#endif // LL_LLBENCHMARKTESTER_H
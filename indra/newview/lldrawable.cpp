@@ -398,6 +398,13 @@ void LLDrawable::makeActive()
 	if (!isState(ACTIVE)) // && mGeneration > 0)
 	{
 		setState(ACTIVE);
+		gPipeline.markLightMoved(this);
+
+		//an active drawable makes its object active, so it needs idle updates again
+		if (mVObjp.notNull() && !mVObjp->onActiveList())
+		{
+			gObjectList.updateActive(mVObjp);
+		}
 		
 		//parent must be made active first
 		if (!isRoot() && !mParent->isActive())
@@ -451,6 +458,7 @@ void LLDrawable::makeStatic(BOOL warning_enabled)
 	if (isState(ACTIVE))
 	{
 		clearState(ACTIVE);
+		gPipeline.markLightMoved(this);
 
 		if (mParent.notNull() && mParent->isActive() && warning_enabled)
 		{
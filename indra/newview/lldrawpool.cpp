@@ -50,6 +50,11 @@
 
 S32 LLDrawPool::sNumDrawPools = 0;
 
+U16 LLRenderPass::sMergedStart = 0;
+U16 LLRenderPass::sMergedEnd = 0;
+std::vector<U32> LLRenderPass::sMergedCounts;
+std::vector<U32> LLRenderPass::sMergedOffsets;
+
 //=============================
 // Draw Pool Implementation
 //=============================
@@ -440,14 +445,94 @@ void LLRenderPass::renderTexture(U32 type, U32 mask)
 	pushBatches(type, mask, TRUE);
 }
 
+//static
+bool LLRenderPass::canMergeBatch(const LLDrawInfo& params, const LLDrawInfo& next)
+{
+	return next.mVertexBuffer == params.mVertexBuffer &&
+		next.mTexture == params.mTexture &&
+		next.mTextureList == params.mTextureList &&
+		next.mTextureMatrix == params.mTextureMatrix &&
+		next.mModelMatrix == params.mModelMatrix &&
+		next.mDrawMode == params.mDrawMode &&
+		next.mGroup == params.mGroup &&
+		next.mBump == params.mBump &&
+		next.mFullbright == params.mFullbright;
+}
+
 void LLRenderPass::pushBatches(U32 type, U32 mask, BOOL texture, BOOL batch_textures)
 {
-	for (LLCullResult::drawinfo_list_t::iterator i = gPipeline.beginRenderMap(type); i != gPipeline.endRenderMap(type); ++i)	
+	static LLCachedControl<bool> multi_draw(gSavedSettings, "RenderMultiDraw");
+	bool use_multi_draw = multi_draw && gGLManager.mHasMultiDrawArrays;
+
+	LLCullResult::drawinfo_list_t::iterator end = gPipeline.endRenderMap(type);
+
+	for (LLCullResult::drawinfo_list_t::iterator i = gPipeline.beginRenderMap(type); i != end; )	
 	{
 		LLDrawInfo* pparams = *i;
-		if (pparams) 
+		++i;
+
+		if (!pparams) 
+		{
+			continue;
+		}
+
+		//batches are sorted by render state in postSort, gather the ones that follow with the same state
+		//contiguous index ranges are joined, the rest go out in the same glMultiDrawElements if available
+		sMergedStart = pparams->mStart;
+		sMergedEnd = pparams->mEnd;
+		sMergedCounts.push_back(pparams->mCount);
+		sMergedOffsets.push_back(pparams->mOffset);
+
+		while (i != end && *i && canMergeBatch(*pparams, **i))
+		{
+			LLDrawInfo* next = *i;
+
+			if (next->mOffset == sMergedOffsets.back() + sMergedCounts.back())
+			{
+				sMergedCounts.back() += next->mCount;
+			}
+			else if (use_multi_draw)
+			{
+				sMergedCounts.push_back(next->mCount);
+				sMergedOffsets.push_back(next->mOffset);
+			}
+			else
+			{
+				break;
+			}
+
+			if (texture && next->mTexture.notNull())
+			{
+				next->mTexture->addTextureStats(next->mVSize);
+			}
+			sMergedStart = llmin(sMergedStart, next->mStart);
+			sMergedEnd = llmax(sMergedEnd, next->mEnd);
+			++i;
+		}
+
+		pushBatch(*pparams, mask, texture, batch_textures);
+
+		sMergedCounts.clear();
+		sMergedOffsets.clear();
+	}
+}
+
+//static
+void LLRenderPass::drawBatch(LLDrawInfo& params)
+{
+	if (sMergedCounts.empty())
+	{
+		params.mVertexBuffer->drawRange(params.mDrawMode, params.mStart, params.mEnd, params.mCount, params.mOffset);
+		gPipeline.addTrianglesDrawn(params.mCount, params.mDrawMode);
+	}
+	else
+	{
+		params.mVertexBuffer->multiDrawRange(params.mDrawMode, sMergedStart, sMergedEnd, 
+			&sMergedCounts[0], &sMergedOffsets[0], sMergedCounts.size());
+
+		for (U32 i = 0; i < sMergedCounts.size(); ++i)
 		{
-			pushBatch(*pparams, mask, texture, batch_textures);
+			gPipeline.addTrianglesDrawn(sMergedCounts[i], params.mDrawMode);
 		}
 	}
 }
@@ -513,8 +598,7 @@ void LLRenderPass::pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL ba
 			params.mGroup->rebuildMesh();
 		}
 		params.mVertexBuffer->setBuffer(mask);
-		params.mVertexBuffer->drawRange(params.mDrawMode, params.mStart, params.mEnd, params.mCount, params.mOffset);
-		gPipeline.addTrianglesDrawn(params.mCount, params.mDrawMode);
+		drawBatch(params);
 	}
 
 	if (tex_setup)
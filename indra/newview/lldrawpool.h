@@ -146,12 +146,22 @@ public:
 	void resetDrawOrders() { }
 
 	static void applyModelMatrix(LLDrawInfo& params);
+	//true if next needs no state change after params
+	static bool canMergeBatch(const LLDrawInfo& params, const LLDrawInfo& next);
+	//draw params' range, or every range pushBatches merged into params (call after setBuffer)
+	static void drawBatch(LLDrawInfo& params);
 	virtual void pushBatches(U32 type, U32 mask, BOOL texture = TRUE, BOOL batch_textures = FALSE);
 	virtual void pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL batch_textures = FALSE);
 	virtual void renderGroup(LLSpatialGroup* group, U32 type, U32 mask, BOOL texture = TRUE);
 	virtual void renderGroups(U32 type, U32 mask, BOOL texture = TRUE);
 	virtual void renderTexture(U32 type, U32 mask);
 
+protected:
+	//index ranges gathered by pushBatches for the batch being pushed, empty otherwise
+	static U16 sMergedStart;
+	static U16 sMergedEnd;
+	static std::vector<U32> sMergedCounts;
+	static std::vector<U32> sMergedOffsets;
 };
 
 class LLFacePool : public LLDrawPool
@@ -32,6 +32,7 @@
 #include "llvoavatar.h"
 #include "m3math.h"
 #include "llmatrix4a.h"
+#include "llsimdkernels.h"
 
 #include "llagent.h" //for gAgent.needsRenderAvatar()
 #include "lldrawable.h"
@@ -63,6 +64,11 @@ S32 LLDrawPoolAvatar::sDiffuseChannel = 0;
 
 static bool is_deferred_render = false;
 
+// Matrix palette last uploaded, so consecutive rigged faces sharing a skin upload it once
+static const LLMatrix4* sLastPalette = NULL;
+static U32 sLastPaletteFrame = 0;
+static LLGLSLShader* sLastPaletteProgram = NULL;
+
 extern BOOL gUseGLPick;
 
 F32 CLOTHING_GRAVITY_EFFECT = 0.7f;
@@ -585,6 +591,9 @@ void LLDrawPoolAvatar::beginImpostor()
 
 void LLDrawPoolAvatar::endImpostor()
 {
+	//atlas impostors are left unflushed by renderImpostor
+	gGL.flush();
+
 	if (LLGLSLShader::sNoFixedFunction)
 	{
 		gImpostorProgram.unbind();
@@ -646,6 +655,9 @@ void LLDrawPoolAvatar::beginDeferredImpostor()
 
 void LLDrawPoolAvatar::endDeferredImpostor()
 {
+	//atlas impostors are left unflushed by renderImpostor
+	gGL.flush();
+
 	sShaderLevel = mVertexShaderLevel;
 	sVertexProgram->disableTexture(LLViewerShaderMgr::DEFERRED_NORMAL);
 	sVertexProgram->disableTexture(LLViewerShaderMgr::SPECULAR_MAP);
@@ -1122,7 +1134,19 @@ void LLDrawPoolAvatar::renderAvatars(LLVOAvatar* single_avatar, S32 pass)
 
 		if (impostor)
 		{
-			if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && avatarp->mImpostor.isComplete()) 
+			if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && avatarp->mImpostorSlot >= 0 &&
+				gPipeline.mImpostorAtlas.isComplete())
+			{ //consecutive atlas impostors keep the same bindings and go out in one batch
+				if (normal_channel > -1)
+				{
+					gPipeline.mImpostorAtlas.mTarget.bindTexture(2, normal_channel);
+				}
+				if (specular_channel > -1)
+				{
+					gPipeline.mImpostorAtlas.mTarget.bindTexture(1, specular_channel);
+				}
+			}
+			else if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && avatarp->mImpostor.isComplete()) 
 			{
 				if (normal_channel > -1)
 				{
@@ -1277,9 +1301,15 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(LLVOAvatar* avatar, LLFace*
 	LLDrawable* drawable = face->getDrawable();
 
 	U32 data_mask = face->getRiggedVertexBufferDataMask();
+
+	//with vertex shaders, weights and bind pose positions never change after the
+	//buffer is built and all deformation happens on the GPU, so keep them static.
+	//software skinning rewrites positions and normals, so it needs a stream buffer
+	U32 usage = sShaderLevel > 0 ? GL_STATIC_DRAW_ARB : GL_STREAM_DRAW_ARB;
 	
 	if (buffer.isNull() || 
 		buffer->getTypeMask() != data_mask ||
+		buffer->getUsage() != usage ||
 		buffer->getNumVerts() != vol_face.mNumVertices ||
 		buffer->getNumIndices() != vol_face.mNumIndices ||
 		(drawable && drawable->isState(LLDrawable::REBUILD_ALL)))
@@ -1287,16 +1317,9 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(LLVOAvatar* avatar, LLFace*
 		face->setGeomIndex(0);
 		face->setIndicesIndex(0);
 		
-		if (buffer.isNull() || buffer->getTypeMask() != data_mask || !buffer->isWriteable())
+		if (buffer.isNull() || buffer->getTypeMask() != data_mask || buffer->getUsage() != usage || !buffer->isWriteable())
 		{ //make a new buffer
-			if (sShaderLevel > 0)
-			{
-				buffer = new LLVertexBuffer(data_mask, GL_DYNAMIC_DRAW_ARB);
-			}
-			else
-			{
-				buffer = new LLVertexBuffer(data_mask, GL_STREAM_DRAW_ARB);
-			}
+			buffer = new LLVertexBuffer(data_mask, usage);
 			buffer->allocateBuffer(vol_face.mNumVertices, vol_face.mNumIndices, true);
 		}
 		else
@@ -1335,6 +1358,9 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(LLVOAvatar* avatar, LLFace*
 		face->getGeometryVolume(*volume, face->getTEOffset(), mat_vert, mat_normal, offset, true);
 
 		buffer->flush();
+
+		//buffer holds the bind pose again, software skinning must redo it
+		face->mLastSkinTime = -1.f;
 	}
 
 	if (sShaderLevel <= 0 && face->mLastSkinTime < avatar->getLastSkinTime())
@@ -1354,70 +1380,23 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(LLVOAvatar* avatar, LLFace*
 
 		LLVector4a* norm = has_normal ? (LLVector4a*) normal.get() : NULL;
 		
-		//build matrix palette
+		//fetch matrix palette
 		LLMatrix4a mp[64];
-		LLMatrix4* mat = (LLMatrix4*) mp;
+		U32 palette_count = 0;
+		const LLMatrix4* palette = avatar->getSkinningMatrixPalette(skin, palette_count);
 
-		for (U32 j = 0; j < skin->mJointNames.size(); ++j)
+		for (U32 j = 0; j < llmin(palette_count, (U32) 64); ++j)
 		{
-			LLJoint* joint = avatar->getJoint(skin->mJointNames[j]);
-			if (joint)
-			{
-				mat[j] = skin->mInvBindMatrix[j];
-				mat[j] *= joint->getWorldMatrix();
-			}
+			mp[j].loadu(palette[j]);
 		}
 
 		LLMatrix4a bind_shape_matrix;
 		bind_shape_matrix.loadu(skin->mBindShapeMatrix);
 
-		for (U32 j = 0; j < buffer->getNumVerts(); ++j)
-		{
-			LLMatrix4a final_mat;
-			final_mat.clear();
+		ll_skin_vertices(mp, 64, bind_shape_matrix, weight, vol_face.mPositions, norm ? vol_face.mNormals : NULL,
+						 pos, norm, buffer->getNumVerts());
 
-			S32 idx[4];
-
-			LLVector4 wght;
-
-			F32 scale = 0.f;
-			for (U32 k = 0; k < 4; k++)
-			{
-				F32 w = weight[j][k];
-
-				idx[k] = llclamp((S32) floorf(w), 0, 63);
-				wght[k] = w - floorf(w);
-				scale += wght[k];
-			}
-
-			wght *= 1.f/scale;
-
-			for (U32 k = 0; k < 4; k++)
-			{
-				F32 w = wght[k];
-
-				LLMatrix4a src;
-				src.setMul(mp[idx[k]], w);
-
-				final_mat.add(src);
-			}
-
-			
-			LLVector4a& v = vol_face.mPositions[j];
-			LLVector4a t;
-			LLVector4a dst;
-			bind_shape_matrix.affineTransform(v, t);
-			final_mat.affineTransform(t, dst);
-			pos[j] = dst;
-
-			if (norm)
-			{
-				LLVector4a& n = vol_face.mNormals[j];
-				bind_shape_matrix.rotate(n, t);
-				final_mat.rotate(t, dst);
-				norm[j] = dst;
-			}
-		}
+		face->mLastSkinTime = avatar->getLastSkinTime();
 	}
 
 	if (drawable && (face->getTEOffset() == drawable->getNumFaces()-1))
@@ -1485,27 +1464,27 @@ void LLDrawPoolAvatar::renderRigged(LLVOAvatar* avatar, U32 type, bool glow)
 		if (buff)
 		{
 			if (sShaderLevel > 0)
-			{ //upload matrix palette to shader
-				LLMatrix4 mat[64];
+			{ //upload matrix palette to shader, unless this program already has it
+				U32 palette_count = 0;
+				const LLMatrix4* palette = avatar->getSkinningMatrixPalette(skin, palette_count);
+				const U32 frame = LLFrameTimer::getFrameCount();
 
-				for (U32 i = 0; i < skin->mJointNames.size(); ++i)
+				if (palette && (palette != sLastPalette || frame != sLastPaletteFrame ||
+								LLDrawPoolAvatar::sVertexProgram != sLastPaletteProgram))
 				{
-					LLJoint* joint = avatar->getJoint(skin->mJointNames[i]);
-					if (joint)
-					{
-						mat[i] = skin->mInvBindMatrix[i];
-						mat[i] *= joint->getWorldMatrix();
-					}
-				}
-				
-				stop_glerror();
+					sLastPalette = palette;
+					sLastPaletteFrame = frame;
+					sLastPaletteProgram = LLDrawPoolAvatar::sVertexProgram;
 
-				LLDrawPoolAvatar::sVertexProgram->uniformMatrix4fv("matrixPalette", 
-					skin->mJointNames.size(),
-					FALSE,
-					(GLfloat*) mat[0].mMatrix);
+					stop_glerror();
+
+					LLDrawPoolAvatar::sVertexProgram->uniformMatrix4fv("matrixPalette", 
+						llmin(palette_count, (U32) 64),
+						FALSE,
+						(GLfloat*) palette[0].mMatrix);
 				
-				stop_glerror();
+					stop_glerror();
+				}
 			}
 			else
 			{
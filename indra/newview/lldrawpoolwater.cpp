@@ -63,8 +63,20 @@ F32 LLDrawPoolWater::sWaterFogEnd = 0.f;
 
 LLVector3 LLDrawPoolWater::sLightDir;
 
+// horizontal distance from the camera to the nearest point of a water patch
+static F32 water_patch_distance(const LLVOWater* water, const LLVector3& origin)
+{
+	const LLVector3 center = water->getPositionAgent();
+	const LLVector3 half_scale = water->getScale() * 0.5f;
+
+	F32 dx = llmax(fabsf(origin.mV[VX] - center.mV[VX]) - half_scale.mV[VX], 0.f);
+	F32 dy = llmax(fabsf(origin.mV[VY] - center.mV[VY]) - half_scale.mV[VY], 0.f);
+	return sqrtf(dx * dx + dy * dy);
+}
+
 LLDrawPoolWater::LLDrawPoolWater() :
-	LLFacePool(POOL_WATER)
+	LLFacePool(POOL_WATER),
+	mBatchGridSize(0)
 {
 	mHBTex[0] = LLViewerTextureManager::getFetchedTexture(gSunTextureID, TRUE, LLViewerTexture::BOOST_UI);
 	gGL.getTexUnit(0)->bind(mHBTex[0]) ;
@@ -614,6 +626,7 @@ void LLDrawPoolWater::shade()
 	light_diffuse *= 6.f;
 
 	//shader->uniformMatrix4fv("inverse_ref", 1, GL_FALSE, (GLfloat*) gGLObliqueProjectionInverse.mMatrix);
+	shader->uniformMatrix4fv("reflection_reproject", 1, GL_FALSE, gPipeline.mWaterReflectionReproject.m);
 	shader->uniform1f(LLViewerShaderMgr::WATER_WATERHEIGHT, eyedepth);
 	shader->uniform1f(LLViewerShaderMgr::WATER_TIME, sTime);
 	shader->uniform3fv(LLViewerShaderMgr::WATER_EYEVEC, 1, LLViewerCamera::getInstance()->getOrigin().mV);
@@ -654,9 +667,20 @@ void LLDrawPoolWater::shade()
 		water_color.mV[3] = 0.9f;
 	}
 
+	static LLCachedControl<F32> refraction_distance(gSavedSettings, "RenderWaterRefractionDistance");
+	// past this distance the shaders use the fog color instead of sampling the distortion map
+	shader->uniform1f("refractionDistance", refraction_distance > 0.f ? (F32) refraction_distance : 1.0e9f);
+
 	{
 		LLGLEnable depth_clamp(gGLManager.mHasDepthClamp ? GL_DEPTH_CLAMP : 0);
 		LLGLDisable cullface(GL_CULL_FACE);
+
+		const LLVector3& origin = LLViewerCamera::getInstance()->getOrigin();
+		const BOOL needs_squash = !gGLManager.mHasDepthClamp && !deferred_render;
+
+		static std::vector<LLFace*> faces;
+		faces.clear();
+
 		for (std::vector<LLFace*>::iterator iter = mDrawFace.begin();
 			iter != mDrawFace.end(); iter++)
 		{
@@ -668,23 +692,39 @@ void LLDrawPoolWater::shade()
 			}
 
 			LLVOWater* water = (LLVOWater*) face->getViewerObject();
-			gGL.getTexUnit(diffTex)->bind(face->getTexture());
 
 			sNeedsReflectionUpdate = TRUE;
 			
-			if (water->getUseTexture() || !water->getIsEdgePatch())
-			{
+			if ((water->getUseTexture() || !water->getIsEdgePatch()) &&
+				(refraction_distance <= 0.f || water_patch_distance(water, origin) < refraction_distance))
+			{ //only water close enough to show refraction needs the distortion map
 				sNeedsDistortionUpdate = TRUE;
-				face->renderIndexed();
-			}
-			else if (gGLManager.mHasDepthClamp || deferred_render)
-			{
-				face->renderIndexed();
 			}
-			else
+
+			faces.push_back(face);
+		}
+
+		if (updateWaterBatch(faces))
+		{
+			renderWaterBatch(diffTex, needs_squash);
+		}
+		else
+		{ //too much water for one 16 bit index buffer, draw face by face
+			for (std::vector<LLFace*>::iterator iter = faces.begin(); iter != faces.end(); ++iter)
 			{
-				LLGLSquashToFarClip far_clip(glh_get_current_projection());
-				face->renderIndexed();
+				LLFace* face = *iter;
+				LLVOWater* water = (LLVOWater*) face->getViewerObject();
+				gGL.getTexUnit(diffTex)->bind(face->getTexture());
+
+				if (needs_squash && !water->getUseTexture() && water->getIsEdgePatch())
+				{
+					LLGLSquashToFarClip far_clip(glh_get_current_projection());
+					face->renderIndexed();
+				}
+				else
+				{
+					face->renderIndexed();
+				}
 			}
 		}
 	}
@@ -714,6 +754,144 @@ void LLDrawPoolWater::shade()
 
 }
 
+bool LLDrawPoolWater::updateWaterBatch(const std::vector<LLFace*>& faces)
+{
+	const S32 grid_size = LLVOWater::getGridSize();
+	const U32 verts_per_face = LLVOWater::getGridVertexCount();
+	const U32 indices_per_face = LLVOWater::getGridIndexCount();
+
+	if (faces.empty() || faces.size() * verts_per_face > 65536)
+	{
+		return false;
+	}
+
+	bool dirty = mBatchBuffer.isNull() || grid_size != mBatchGridSize || faces.size() != mBatchFaces.size();
+
+	for (U32 i = 0; i < faces.size() && !dirty; ++i)
+	{
+		LLFace* face = faces[i];
+		LLVOWater* water = (LLVOWater*) face->getViewerObject();
+		const BatchFace& batch_face = mBatchFaces[i];
+
+		// a new face vertex buffer means the face was rebuilt, possibly after a GL reset
+		dirty = batch_face.mFace != face ||
+				batch_face.mBuffer != face->getVertexBuffer() ||
+				batch_face.mTexture != face->getTexture() ||
+				batch_face.mPosition != water->getPositionAgent() ||
+				batch_face.mScale != water->getScale();
+	}
+
+	if (!dirty)
+	{
+		return true;
+	}
+
+	mBatchFaces.resize(faces.size());
+	for (U32 i = 0; i < faces.size(); ++i)
+	{
+		LLFace* face = faces[i];
+		LLVOWater* water = (LLVOWater*) face->getViewerObject();
+		BatchFace& batch_face = mBatchFaces[i];
+
+		batch_face.mFace = face;
+		batch_face.mBuffer = face->getVertexBuffer();
+		batch_face.mTexture = face->getTexture();
+		batch_face.mEdgePatch = !water->getUseTexture() && water->getIsEdgePatch();
+		batch_face.mPosition = water->getPositionAgent();
+		batch_face.mScale = water->getScale();
+	}
+	mBatchGridSize = grid_size;
+
+	std::vector<BatchFace> sorted(mBatchFaces);
+	std::sort(sorted.begin(), sorted.end(), CompareBatchFace());
+
+	mBatchBuffer = new LLVertexBuffer(VERTEX_DATA_MASK, GL_DYNAMIC_DRAW_ARB);
+	mBatchBuffer->allocateBuffer(sorted.size() * verts_per_face, sorted.size() * indices_per_face, TRUE);
+
+	LLStrider<LLVector3> verticesp, normalsp;
+	LLStrider<LLVector2> texCoordsp;
+	LLStrider<U16> indicesp;
+
+	if (!mBatchBuffer->getVertexStrider(verticesp) ||
+		!mBatchBuffer->getNormalStrider(normalsp) ||
+		!mBatchBuffer->getTexCoord0Strider(texCoordsp) ||
+		!mBatchBuffer->getIndexStrider(indicesp))
+	{
+		mBatchBuffer = NULL;
+		mBatchFaces.clear();
+		return false;
+	}
+
+	mBatches.clear();
+	for (U32 i = 0; i < sorted.size(); ++i)
+	{
+		const BatchFace& batch_face = sorted[i];
+		LLVOWater* water = (LLVOWater*) batch_face.mFace->getViewerObject();
+		water->getGeometry(verticesp, normalsp, texCoordsp, indicesp, i * verts_per_face);
+
+		if (mBatches.empty() ||
+			mBatches.back().mTexture != batch_face.mTexture ||
+			mBatches.back().mEdgePatch != batch_face.mEdgePatch)
+		{
+			WaterBatch batch;
+			batch.mTexture = batch_face.mTexture;
+			batch.mEdgePatch = batch_face.mEdgePatch;
+			batch.mStart = i * verts_per_face;
+			batch.mOffset = i * indices_per_face;
+			batch.mCount = 0;
+			mBatches.push_back(batch);
+		}
+
+		WaterBatch& batch = mBatches.back();
+		batch.mEnd = (i + 1) * verts_per_face - 1;
+		batch.mCount += indices_per_face;
+	}
+
+	mBatchBuffer->flush();
+
+	return true;
+}
+
+void LLDrawPoolWater::renderWaterBatch(S32 diffTex, BOOL needs_squash)
+{
+	mBatchBuffer->setBuffer(VERTEX_DATA_MASK);
+
+	U32 i = 0;
+	while (i < mBatches.size())
+	{
+		const WaterBatch& first = mBatches[i];
+		const BOOL squash = needs_squash && first.mEdgePatch;
+		U32 end = first.mEnd;
+		U32 count = first.mCount;
+
+		// runs are sorted by texture, so without squashing the edge patches
+		// join the region water that shares their texture
+		U32 j = i + 1;
+		while (j < mBatches.size() &&
+			mBatches[j].mTexture == first.mTexture &&
+			(needs_squash && mBatches[j].mEdgePatch) == squash)
+		{
+			end = mBatches[j].mEnd;
+			count += mBatches[j].mCount;
+			j++;
+		}
+
+		gGL.getTexUnit(diffTex)->bind(first.mTexture);
+
+		if (squash)
+		{
+			LLGLSquashToFarClip far_clip(glh_get_current_projection());
+			mBatchBuffer->drawRange(LLRender::TRIANGLES, first.mStart, end, count, first.mOffset);
+		}
+		else
+		{
+			mBatchBuffer->drawRange(LLRender::TRIANGLES, first.mStart, end, count, first.mOffset);
+		}
+
+		i = j;
+	}
+}
+
 LLViewerTexture *LLDrawPoolWater::getDebugTexture()
 {
 	return LLViewerFetchedTexture::sSmokeImagep;
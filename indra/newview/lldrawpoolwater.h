@@ -33,6 +33,7 @@
 class LLFace;
 class LLHeavenBody;
 class LLWaterSurface;
+class LLVOWater;
 
 class LLDrawPoolWater: public LLFacePool
 {
@@ -85,6 +86,49 @@ public:
 
 protected:
 	void renderOpaqueLegacyWater();
+
+	// Every water face shade() draws, copied into one buffer sorted by
+	// texture so runs sharing a texture and clip state go out as one draw.
+	// Rebuilt only when the set of faces or their geometry changes.
+	bool updateWaterBatch(const std::vector<LLFace*>& faces);
+	void renderWaterBatch(S32 diffTex, BOOL needs_squash);
+
+	struct BatchFace
+	{
+		LLFace* mFace;
+		LLVertexBuffer* mBuffer;
+		LLViewerTexture* mTexture;
+		BOOL mEdgePatch;
+		LLVector3 mPosition;
+		LLVector3 mScale;
+	};
+
+	struct CompareBatchFace
+	{
+		bool operator()(const BatchFace& lhs, const BatchFace& rhs) const
+		{
+			if (lhs.mTexture != rhs.mTexture)
+			{
+				return lhs.mTexture < rhs.mTexture;
+			}
+			return lhs.mEdgePatch < rhs.mEdgePatch;
+		}
+	};
+
+	struct WaterBatch
+	{
+		LLViewerTexture* mTexture;
+		BOOL mEdgePatch;	// untextured edge patch, may need squashing to the far clip
+		U32 mStart;
+		U32 mEnd;
+		U32 mOffset;
+		U32 mCount;
+	};
+
+	LLPointer<LLVertexBuffer> mBatchBuffer;
+	std::vector<WaterBatch> mBatches;
+	std::vector<BatchFace> mBatchFaces;	// what the buffer was built from, in draw pool order
+	S32 mBatchGridSize;
 };
 
 void cgErrorCallback();
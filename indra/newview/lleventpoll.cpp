@@ -69,6 +69,11 @@ namespace
 									const std::string& reason,
 									const LLChannelDescriptors& channels,
 									const LLIOPipe::buffer_ptr_t& buffer);
+
+		// Event batches can be large (object updates, inventory offers),
+		// parse them while the long poll is still receiving instead of in
+		// one go when it completes.
+		virtual bool parseWhileReceiving() const { return true; }
 	private:
 
 		bool	mDone;
@@ -149,6 +154,7 @@ namespace
 	}
 
 	// virtual 
+	// Only reached for responses that were not parsed while receiving.
 	void LLEventPollResponder::completedRaw(U32 status,
 									const std::string& reason,
 									const LLChannelDescriptors& channels,
@@ -53,6 +53,7 @@
 #define LL_MAX_INDICES_COUNT 1000000
 
 BOOL LLFace::sSafeRenderSelect = TRUE; // FALSE
+std::vector<LLFace::GeometryFill>* LLFace::sGeometryFills = NULL;
 
 #define DOTVEC(a,b) (a.mV[0]*b.mV[0] + a.mV[1]*b.mV[1] + a.mV[2]*b.mV[2])
 
@@ -1103,14 +1104,10 @@ static LLFastTimer::DeclareTimer FTM_FACE_GEOM_EMISSIVE("Emissive");
 static LLFastTimer::DeclareTimer FTM_FACE_GEOM_WEIGHTS("Weights");
 static LLFastTimer::DeclareTimer FTM_FACE_GEOM_BINORMAL("Binormal");
 static LLFastTimer::DeclareTimer FTM_FACE_GEOM_INDEX("Index");
-static LLFastTimer::DeclareTimer FTM_FACE_GEOM_INDEX_TAIL("Tail");
-static LLFastTimer::DeclareTimer FTM_FACE_POSITION_STORE("Pos");
+static LLFastTimer::DeclareTimer FTM_FACE_GEOM_FILL("Fill");
 static LLFastTimer::DeclareTimer FTM_FACE_TEXTURE_INDEX_STORE("TexIdx");
-static LLFastTimer::DeclareTimer FTM_FACE_POSITION_PAD("Pad");
 static LLFastTimer::DeclareTimer FTM_FACE_TEX_DEFAULT("Default");
 static LLFastTimer::DeclareTimer FTM_FACE_TEX_QUICK("Quick");
-static LLFastTimer::DeclareTimer FTM_FACE_TEX_QUICK_NO_XFORM("No Xform");
-static LLFastTimer::DeclareTimer FTM_FACE_TEX_QUICK_XFORM("Xform");
 
 static LLFastTimer::DeclareTimer FTM_FACE_TEX_QUICK_PLANAR("Quick Planar");
 
@@ -1133,6 +1130,7 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 
 
 	//don't use map range (generates many redundant unmap calls)
+	//bulk writes are deferred to GeometryFill after the strider calls, so a range could not be flushed per section anyway
 	bool map_range = false; //gGLManager.mHasMapBufferRange || gGLManager.mHasFlushBufferRange;
 
 	if (mVertexBuffer.notNull())
@@ -1167,6 +1165,8 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 	LLStrider<U16> indicesp;
 	LLStrider<LLVector4> wght;
 
+	GeometryFill fill;
+
 	BOOL full_rebuild = force_rebuild || mDrawablep->isState(LLDrawable::REBUILD_VOLUME);
 	
 	BOOL global_volume = mDrawablep->getVOVolume()->isVolumeGlobal();
@@ -1253,32 +1253,8 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		LLFastTimer t(FTM_FACE_GEOM_INDEX);
 		mVertexBuffer->getIndexStrider(indicesp, mIndicesIndex, mIndicesCount, map_range);
 
-		volatile __m128i* dst = (__m128i*) indicesp.get();
-		__m128i* src = (__m128i*) vf.mIndices;
-		__m128i offset = _mm_set1_epi16(index_offset);
-
-		S32 end = num_indices/8;
-		
-		for (S32 i = 0; i < end; i++)
-		{
-			__m128i res = _mm_add_epi16(src[i], offset);
-			_mm_storeu_si128((__m128i*) dst++, res);
-		}
-
-		{
-			LLFastTimer t(FTM_FACE_GEOM_INDEX_TAIL);
-			U16* idx = (U16*) dst;
-
-			for (S32 i = end*8; i < num_indices; ++i)
-			{
-				*idx++ = vf.mIndices[i]+index_offset;
-			}
-		}
-
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+		fill.mIndices = indicesp.get();
+		fill.mIndexOffset = index_offset;
 	}
 	
 	LLMatrix4a mat_normal;
@@ -1427,112 +1403,35 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		{ //not in atlas or not bump mapped, might be able to do a cheap update
 			mVertexBuffer->getTexCoord0Strider(tex_coords, mGeomIndex, mGeomCount);
 
-			if (texgen != LLTextureEntry::TEX_GEN_PLANAR)
+			//all the no bump, no atlas cases are written by GeometryFill
+			LLFastTimer t(texgen == LLTextureEntry::TEX_GEN_PLANAR ? FTM_FACE_TEX_QUICK_PLANAR : FTM_FACE_TEX_QUICK);
+			fill.mTexCoords = (F32*) tex_coords.get();
+			fill.mTexXform = do_xform;
+			fill.mTexCos = cos_ang;
+			fill.mTexSin = sin_ang;
+			fill.mTexOffsetS = os;
+			fill.mTexOffsetT = ot;
+			fill.mTexScaleS = ms;
+			fill.mTexScaleT = mt;
+
+			if (texgen == LLTextureEntry::TEX_GEN_PLANAR)
 			{
-				LLFastTimer t(FTM_FACE_TEX_QUICK);
-				if (!do_tex_mat)
-				{
-					if (!do_xform)
-					{
-						LLFastTimer t(FTM_FACE_TEX_QUICK_NO_XFORM);
-						LLVector4a::memcpyNonAliased16((F32*) tex_coords.get(), (F32*) vf.mTexCoords, num_vertices*2*sizeof(F32));
-					}
-					else
-					{
-						LLFastTimer t(FTM_FACE_TEX_QUICK_XFORM);
-						F32* dst = (F32*) tex_coords.get();
-						LLVector4a* src = (LLVector4a*) vf.mTexCoords;
-
-						LLVector4a trans;
-						trans.splat(-0.5f);
-
-						LLVector4a rot0;
-						rot0.set(cos_ang, -sin_ang, cos_ang, -sin_ang);
-
-						LLVector4a rot1;
-						rot1.set(sin_ang, cos_ang, sin_ang, cos_ang);
-
-						LLVector4a scale;
-						scale.set(ms, mt, ms, mt);
-
-						LLVector4a offset;
-						offset.set(os+0.5f, ot+0.5f, os+0.5f, ot+0.5f);
-
-						LLVector4Logical mask;
-						mask.clear();
-						mask.setElement<2>();
-						mask.setElement<3>();
-
-						U32 count = num_vertices/2 + num_vertices%2;
-
-						for (S32 i = 0; i < count; i++)
-						{	
-							LLVector4a res = *src++;
-							xform4a(res, trans, mask, rot0, rot1, offset, scale);
-							res.store4a(dst);
-							dst += 4;
-						}
-					}
-				}
-				else
-				{ //do tex mat, no texgen, no atlas, no bump
-					for (S32 i = 0; i < num_vertices; i++)
-					{	
-						LLVector2 tc(vf.mTexCoords[i]);
-						//LLVector4a& norm = vf.mNormals[i];
-						//LLVector4a& center = *(vf.mCenter);
-
-						LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
-						tmp = tmp * *mTextureMatrix;
-						tc.mV[0] = tmp.mV[0];
-						tc.mV[1] = tmp.mV[1];
-						*tex_coords++ = tc;	
-					}
-				}
-			}
-			else
-			{ //no bump, no atlas, tex gen planar
-				LLFastTimer t(FTM_FACE_TEX_QUICK_PLANAR);
-				if (do_tex_mat)
-				{
-					for (S32 i = 0; i < num_vertices; i++)
-					{	
-						LLVector2 tc(vf.mTexCoords[i]);
-						LLVector4a& norm = vf.mNormals[i];
-						LLVector4a& center = *(vf.mCenter);
-						LLVector4a vec = vf.mPositions[i];	
-						vec.mul(scalea);
-						planarProjection(tc, norm, center, vec);
-						
-						LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
-						tmp = tmp * *mTextureMatrix;
-						tc.mV[0] = tmp.mV[0];
-						tc.mV[1] = tmp.mV[1];
-				
-						*tex_coords++ = tc;	
-					}
-				}
-				else
-				{
-					for (S32 i = 0; i < num_vertices; i++)
-					{	
-						LLVector2 tc(vf.mTexCoords[i]);
-						LLVector4a& norm = vf.mNormals[i];
-						LLVector4a& center = *(vf.mCenter);
-						LLVector4a vec = vf.mPositions[i];	
-						vec.mul(scalea);
-						planarProjection(tc, norm, center, vec);
-						
-						xform(tc, cos_ang, sin_ang, os, ot, ms, mt);
-
-						*tex_coords++ = tc;	
-					}
-				}
+				fill.mTexPlanar = true;
+				fill.mTexGenScale[0] = scale.mV[0];
+				fill.mTexGenScale[1] = scale.mV[1];
+				fill.mTexGenScale[2] = scale.mV[2];
 			}
 
-			if (map_range)
+			if (do_tex_mat)
 			{
-				mVertexBuffer->flush();
+				const LLMatrix4& tex_mat = *mTextureMatrix;
+				fill.mTexMatXform = true;
+				fill.mTexMat[0] = tex_mat.mMatrix[VX][VX];
+				fill.mTexMat[1] = tex_mat.mMatrix[VX][VY];
+				fill.mTexMat[2] = tex_mat.mMatrix[VY][VX];
+				fill.mTexMat[3] = tex_mat.mMatrix[VY][VY];
+				fill.mTexMat[4] = tex_mat.mMatrix[VW][VX];
+				fill.mTexMat[5] = tex_mat.mMatrix[VW][VY];
 			}
 		}
 		else
@@ -1729,18 +1628,6 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		llassert(num_vertices > 0);
 		
 		mVertexBuffer->getVertexStrider(vert, mGeomIndex, mGeomCount, map_range);
-			
-
-		LLMatrix4a mat_vert;
-		mat_vert.loadu(mat_vert_in);
-
-		LLVector4a* src = vf.mPositions;
-		volatile F32* dst = (volatile F32*) vert.get();
-
-		volatile F32* end = dst+num_vertices*4;
-		LLVector4a res;
-
-		LLVector4a texIdx;
 
 		U8 index = mTextureIndex < 255 ? mTextureIndex : 0;
 
@@ -1753,128 +1640,40 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 
 		llassert(index <= LLGLSLShader::sIndexedTextureChannels-1);
 
-		LLVector4Logical mask;
-		mask.clear();
-		mask.setElement<3>();
-		
-		texIdx.set(0,0,0,val);
-
-		{
-			LLFastTimer t(FTM_FACE_POSITION_STORE);
-			LLVector4a tmp;
-
-			do
-			{	
-				mat_vert.affineTransform(*src++, res);
-				tmp.setSelectWithMask(mask, texIdx, res);
-				tmp.store4a((F32*) dst);
-				dst += 4;
-			}
-			while(dst < end);
-		}
-
-		{
-			LLFastTimer t(FTM_FACE_POSITION_PAD);
-			S32 aligned_pad_vertices = mGeomCount - num_vertices;
-			res.set(res[0], res[1], res[2], 0.f);
-
-			while (aligned_pad_vertices > 0)
-			{
-				--aligned_pad_vertices;
-				res.store4a((F32*) dst);
-				dst += 4;
-			}
-		}
-
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+		fill.mPositions = (F32*) vert.get();
+		fill.mMatVert = mat_vert_in;
+		fill.mTexIndex = val;
 	}
 		
 	if (rebuild_normal)
 	{
 		LLFastTimer t(FTM_FACE_GEOM_NORMAL);
 		mVertexBuffer->getNormalStrider(norm, mGeomIndex, mGeomCount, map_range);
-		F32* normals = (F32*) norm.get();
-	
-		for (S32 i = 0; i < num_vertices; i++)
-		{	
-			LLVector4a normal;
-			mat_normal.rotate(vf.mNormals[i], normal);
-			normal.normalize3fast();
-			normal.store4a(normals);
-			normals += 4;
-		}
-
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+		fill.mNormals = (F32*) norm.get();
+		fill.mMatNormal = mat_norm_in;
 	}
 		
 	if (rebuild_binormal)
 	{
 		LLFastTimer t(FTM_FACE_GEOM_BINORMAL);
 		mVertexBuffer->getBinormalStrider(binorm, mGeomIndex, mGeomCount, map_range);
-		F32* binormals = (F32*) binorm.get();
-		
-		for (S32 i = 0; i < num_vertices; i++)
-		{	
-			LLVector4a binormal;
-			mat_normal.rotate(vf.mBinormals[i], binormal);
-			binormal.normalize3fast();
-			binormal.store4a(binormals);
-			binormals += 4;
-		}
-
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+		fill.mBinormals = (F32*) binorm.get();
+		fill.mMatNormal = mat_norm_in;
 	}
 	
 	if (rebuild_weights && vf.mWeights)
 	{
 		LLFastTimer t(FTM_FACE_GEOM_WEIGHTS);
 		mVertexBuffer->getWeight4Strider(wght, mGeomIndex, mGeomCount, map_range);
-		F32* weights = (F32*) wght.get();
-		LLVector4a::memcpyNonAliased16(weights, (F32*) vf.mWeights, num_vertices*4*sizeof(F32));
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+		fill.mWeights = (F32*) wght.get();
 	}
 
 	if (rebuild_color && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_COLOR) )
 	{
 		LLFastTimer t(FTM_FACE_GEOM_COLOR);
 		mVertexBuffer->getColorStrider(colors, mGeomIndex, mGeomCount, map_range);
-
-		LLVector4a src;
-
-		U32 vec[4];
-		vec[0] = vec[1] = vec[2] = vec[3] = color.mAll;
-		
-		src.loadua((F32*) vec);
-
-		F32* dst = (F32*) colors.get();
-		S32 num_vecs = num_vertices/4;
-		if (num_vertices%4 > 0)
-		{
-			++num_vecs;
-		}
-
-		for (S32 i = 0; i < num_vecs; i++)
-		{	
-			src.store4a(dst);
-			dst += 4;
-		}
-
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+		fill.mColors = (F32*) colors.get();
+		fill.mColor = color.mAll;
 	}
 
 	if (rebuild_emissive)
@@ -1885,36 +1684,26 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 
 		U8 glow = (U8) llclamp((S32) (getTextureEntry()->getGlow()*255), 0, 255);
 
-		LLVector4a src;
-
-		
-		U32 glow32 = glow |
+		fill.mEmissive = (F32*) emissive.get();
+		fill.mGlow = glow |
 					 (glow << 8) |
 					 (glow << 16) |
 					 (glow << 24);
+	}
 
-		U32 vec[4];
-		vec[0] = vec[1] = vec[2] = vec[3] = glow32;
-		
-		src.loadua((F32*) vec);
-
-		F32* dst = (F32*) emissive.get();
-		S32 num_vecs = num_vertices/4;
-		if (num_vertices%4 > 0)
-		{
-			++num_vecs;
-		}
-
-		for (S32 i = 0; i < num_vecs; i++)
-		{	
-			src.store4a(dst);
-			dst += 4;
-		}
+	fill.mVolumeFace = &vf;
+	fill.mNumVertices = num_vertices;
+	fill.mNumIndices = num_indices;
+	fill.mGeomCount = mGeomCount;
 
-		if (map_range)
-		{
-			mVertexBuffer->flush();
-		}
+	if (sGeometryFills)
+	{
+		sGeometryFills->push_back(fill);
+	}
+	else
+	{
+		LLFastTimer t(FTM_FACE_GEOM_FILL);
+		fill.run();
 	}
 	if (rebuild_tcoord)
 	{
@@ -1941,6 +1730,316 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 	return TRUE;
 }
 
+LLFace::GeometryFill::GeometryFill()
+:	mVolumeFace(NULL),
+	mNumVertices(0),
+	mNumIndices(0),
+	mGeomCount(0),
+	mIndices(NULL),
+	mIndexOffset(0),
+	mTexCoords(NULL),
+	mTexXform(false),
+	mTexCos(1.f), mTexSin(0.f),
+	mTexOffsetS(0.f), mTexOffsetT(0.f),
+	mTexScaleS(1.f), mTexScaleT(1.f),
+	mTexPlanar(false),
+	mTexMatXform(false),
+	mPositions(NULL),
+	mTexIndex(0.f),
+	mNormals(NULL),
+	mBinormals(NULL),
+	mWeights(NULL),
+	mColors(NULL),
+	mColor(0),
+	mEmissive(NULL),
+	mGlow(0)
+{
+}
+
+//texture coordinate kernels for the cases the plain copy and xform4a don't
+//cover, one instance per (planar texgen, animation matrix) pair so the
+//per vertex loop has no mode checks
+template <bool PLANAR, bool TEX_MAT>
+static void fill_tex_coords(const LLFace::GeometryFill& fill)
+{
+	const LLVolumeFace& vf = *fill.mVolumeFace;
+	const F32* m = fill.mTexMat;
+
+	if (!PLANAR)
+	{ //two texture coordinates per vector, <s0, t0, s1, t1>
+		LLVector4a ms, mt, mtrans;
+		ms.set(m[0], m[1], m[0], m[1]);
+		mt.set(m[2], m[3], m[2], m[3]);
+		mtrans.set(m[4], m[5], m[4], m[5]);
+
+		LLVector4Logical mask;
+		mask.clear();
+		mask.setElement<2>();
+		mask.setElement<3>();
+
+		LLVector4a* src = (LLVector4a*) vf.mTexCoords;
+		F32* dst = fill.mTexCoords;
+		U32 count = fill.mNumVertices/2 + fill.mNumVertices%2;
+
+		for (U32 i = 0; i < count; i++)
+		{
+			LLVector4a st = *src++;
+
+			LLVector4a s0, s1, ss;
+			s0.splat(st, 0);
+			s1.splat(st, 2);
+			ss.setSelectWithMask(mask, s1, s0);
+
+			LLVector4a t0, t1, tt;
+			t0.splat(st, 1);
+			t1.splat(st, 3);
+			tt.setSelectWithMask(mask, t1, t0);
+
+			LLVector4a res;
+			res.setMul(ss, ms);
+			LLVector4a b;
+			b.setMul(tt, mt);
+			res.add(b);
+			res.add(mtrans);
+
+			res.store4a(dst);
+			dst += 4;
+		}
+		return;
+	}
+
+	LLVector4a scalea;
+	scalea.load3(fill.mTexGenScale);
+
+	LLVector2* dst = (LLVector2*) fill.mTexCoords;
+
+	for (S32 i = 0; i < fill.mNumVertices; i++)
+	{
+		LLVector2 tc;
+		LLVector4a vec;
+		vec.setMul(vf.mPositions[i], scalea);
+		planarProjection(tc, vf.mNormals[i], *vf.mCenter, vec);
+
+		if (TEX_MAT)
+		{
+			F32 s = tc.mV[0];
+			F32 t = tc.mV[1];
+			tc.mV[0] = s*m[0] + t*m[2] + m[4];
+			tc.mV[1] = s*m[1] + t*m[3] + m[5];
+		}
+		else
+		{
+			xform(tc, fill.mTexCos, fill.mTexSin, fill.mTexOffsetS, fill.mTexOffsetT, fill.mTexScaleS, fill.mTexScaleT);
+		}
+
+		*dst++ = tc;
+	}
+}
+
+void LLFace::GeometryFill::run() const
+{
+	const LLVolumeFace& vf = *mVolumeFace;
+	S32 num_vertices = mNumVertices;
+
+	if (mIndices)
+	{
+		volatile __m128i* dst = (__m128i*) mIndices;
+		__m128i* src = (__m128i*) vf.mIndices;
+		__m128i offset = _mm_set1_epi16(mIndexOffset);
+
+		S32 end = mNumIndices/8;
+		
+		for (S32 i = 0; i < end; i++)
+		{
+			__m128i res = _mm_add_epi16(src[i], offset);
+			_mm_storeu_si128((__m128i*) dst++, res);
+		}
+
+		U16* idx = (U16*) dst;
+
+		for (S32 i = end*8; i < mNumIndices; ++i)
+		{
+			*idx++ = vf.mIndices[i]+mIndexOffset;
+		}
+	}
+
+	if (mTexCoords)
+	{
+		if (mTexPlanar)
+		{
+			if (mTexMatXform)
+			{
+				fill_tex_coords<true, true>(*this);
+			}
+			else
+			{
+				fill_tex_coords<true, false>(*this);
+			}
+		}
+		else if (mTexMatXform)
+		{
+			fill_tex_coords<false, true>(*this);
+		}
+		else if (!mTexXform)
+		{
+			LLVector4a::memcpyNonAliased16(mTexCoords, (F32*) vf.mTexCoords, num_vertices*2*sizeof(F32));
+		}
+		else
+		{
+			F32* dst = mTexCoords;
+			LLVector4a* src = (LLVector4a*) vf.mTexCoords;
+
+			LLVector4a trans;
+			trans.splat(-0.5f);
+
+			LLVector4a rot0;
+			rot0.set(mTexCos, -mTexSin, mTexCos, -mTexSin);
+
+			LLVector4a rot1;
+			rot1.set(mTexSin, mTexCos, mTexSin, mTexCos);
+
+			LLVector4a scale;
+			scale.set(mTexScaleS, mTexScaleT, mTexScaleS, mTexScaleT);
+
+			LLVector4a offset;
+			offset.set(mTexOffsetS+0.5f, mTexOffsetT+0.5f, mTexOffsetS+0.5f, mTexOffsetT+0.5f);
+
+			LLVector4Logical mask;
+			mask.clear();
+			mask.setElement<2>();
+			mask.setElement<3>();
+
+			U32 count = num_vertices/2 + num_vertices%2;
+
+			for (S32 i = 0; i < count; i++)
+			{	
+				LLVector4a res = *src++;
+				xform4a(res, trans, mask, rot0, rot1, offset, scale);
+				res.store4a(dst);
+				dst += 4;
+			}
+		}
+	}
+
+	if (mPositions)
+	{
+		LLMatrix4a mat_vert;
+		mat_vert.loadu(mMatVert);
+
+		LLVector4a* src = vf.mPositions;
+		volatile F32* dst = (volatile F32*) mPositions;
+
+		volatile F32* end = dst+num_vertices*4;
+		LLVector4a res;
+
+		LLVector4a texIdx;
+		texIdx.set(0,0,0,mTexIndex);
+
+		LLVector4Logical mask;
+		mask.clear();
+		mask.setElement<3>();
+
+		LLVector4a tmp;
+
+		do
+		{	
+			mat_vert.affineTransform(*src++, res);
+			tmp.setSelectWithMask(mask, texIdx, res);
+			tmp.store4a((F32*) dst);
+			dst += 4;
+		}
+		while(dst < end);
+
+		S32 aligned_pad_vertices = mGeomCount - num_vertices;
+		res.set(res[0], res[1], res[2], 0.f);
+
+		while (aligned_pad_vertices > 0)
+		{
+			--aligned_pad_vertices;
+			res.store4a((F32*) dst);
+			dst += 4;
+		}
+	}
+
+	if (mNormals || mBinormals)
+	{
+		LLMatrix4a mat_normal;
+		mat_normal.loadu(mMatNormal);
+
+		if (mNormals)
+		{
+			F32* normals = mNormals;
+	
+			for (S32 i = 0; i < num_vertices; i++)
+			{	
+				LLVector4a normal;
+				mat_normal.rotate(vf.mNormals[i], normal);
+				normal.normalize3fast();
+				normal.store4a(normals);
+				normals += 4;
+			}
+		}
+
+		if (mBinormals)
+		{
+			F32* binormals = mBinormals;
+		
+			for (S32 i = 0; i < num_vertices; i++)
+			{	
+				LLVector4a binormal;
+				mat_normal.rotate(vf.mBinormals[i], binormal);
+				binormal.normalize3fast();
+				binormal.store4a(binormals);
+				binormals += 4;
+			}
+		}
+	}
+
+	if (mWeights)
+	{
+		LLVector4a::memcpyNonAliased16(mWeights, (F32*) vf.mWeights, num_vertices*4*sizeof(F32));
+	}
+
+	//colors and glow are one value per face, written four vertices at a time
+	S32 num_vecs = num_vertices/4;
+	if (num_vertices%4 > 0)
+	{
+		++num_vecs;
+	}
+
+	if (mColors)
+	{
+		U32 vec[4];
+		vec[0] = vec[1] = vec[2] = vec[3] = mColor;
+		
+		LLVector4a src;
+		src.loadua((F32*) vec);
+
+		F32* dst = mColors;
+		for (S32 i = 0; i < num_vecs; i++)
+		{	
+			src.store4a(dst);
+			dst += 4;
+		}
+	}
+
+	if (mEmissive)
+	{
+		U32 vec[4];
+		vec[0] = vec[1] = vec[2] = vec[3] = mGlow;
+		
+		LLVector4a src;
+		src.loadua((F32*) vec);
+
+		F32* dst = mEmissive;
+		for (S32 i = 0; i < num_vecs; i++)
+		{	
+			src.store4a(dst);
+			dst += 4;
+		}
+	}
+}
+
 //check if the face has a media
 BOOL LLFace::hasMedia() const 
 {
@@ -45,6 +45,7 @@
 
 class LLFacePool;
 class LLVolume;
+class LLVolumeFace;
 class LLViewerTexture;
 class LLTextureEntry;
 class LLVertexProgram;
@@ -159,6 +160,50 @@ public:
 						const U16 &index_offset,
 						bool force_rebuild = false);
 
+	//bulk vertex data writes of getGeometryVolume, into buffer regions already mapped on the render thread
+	//touches no GL or shared state, so LLVolumeGeometryManager can run them on worker threads before unmapping
+	struct GeometryFill
+	{
+		GeometryFill();
+		void run() const;
+
+		const LLVolumeFace* mVolumeFace;
+		S32			mNumVertices;
+		S32			mNumIndices;
+		S32			mGeomCount;
+
+		U16*		mIndices;
+		U16			mIndexOffset;
+
+		F32*		mTexCoords;		//untransformed or rotated/scaled/offset volume texture coordinates
+		bool		mTexXform;
+		F32			mTexCos, mTexSin;
+		F32			mTexOffsetS, mTexOffsetT;
+		F32			mTexScaleS, mTexScaleT;
+		bool		mTexPlanar;		//planar texgen from positions scaled by mTexGenScale
+		F32			mTexGenScale[3];
+		bool		mTexMatXform;	//texture animation matrix, replaces the transform above
+		F32			mTexMat[6];		//its 2D part: s row, t row, translation
+
+		F32*		mPositions;
+		LLMatrix4	mMatVert;
+		F32			mTexIndex;		//packed texture index stored in the w component
+
+		F32*		mNormals;
+		F32*		mBinormals;
+		LLMatrix3	mMatNormal;
+
+		F32*		mWeights;
+
+		F32*		mColors;
+		U32			mColor;
+		F32*		mEmissive;
+		U32			mGlow;
+	};
+
+	//when set, getGeometryVolume appends its fill here instead of running it
+	static std::vector<GeometryFill>* sGeometryFills;
+
 	// For avatar
 	U16			 getGeometryAvatar(
 									LLStrider<LLVector3> &vertices,
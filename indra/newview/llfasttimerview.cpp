@@ -32,6 +32,7 @@
 #include "llrect.h"
 #include "llerror.h"
 #include "llgl.h"
+#include "llgputimer.h"
 #include "llimagepng.h"
 #include "llrender.h"
 #include "llrendertarget.h"
@@ -114,11 +115,19 @@ void LLFastTimerView::onPause()
 	}
 }
 
+void LLFastTimerView::onTrace()
+{
+	// capture includes worker threads, which the bars above can't show
+	std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, "fasttimer_trace.json");
+	LLFastTimer::startTrace(gSavedSettings.getS32("FastTimerTraceFrames"), filename);
+}
+
 BOOL LLFastTimerView::postBuild()
 {
 	LLButton& pause_btn = getChildRef<LLButton>("pause_btn");
 	
 	pause_btn.setCommitCallback(boost::bind(&LLFastTimerView::onPause, this));
+	getChild<LLButton>("trace_btn")->setCommitCallback(boost::bind(&LLFastTimerView::onTrace, this));
 	return TRUE;
 }
 
@@ -378,6 +387,7 @@ void LLFastTimerView::draw()
 	
 	S32 xleft = margin;
 	S32 ytop = margin;
+	const S32 LEGEND_WIDTH = 220;
 	
 	mAverageCyclesPerTimer = LLFastTimer::sTimerCalls == 0 
 		? 0 
@@ -423,6 +433,49 @@ void LLFastTimerView::draw()
 		y -= (texth + 2);
 	}
 
+	// Draw the GPU lane, on the same scale as a CPU frame so they can be compared
+	if (LLGPUTimer::isEnabled())
+	{
+		const LLGPUTimer::timer_list_t& timers = LLGPUTimer::getTimers();
+		F32 gpu_ms = 0.f;
+		for (LLGPUTimer::timer_list_t::const_iterator it = timers.begin(); it != timers.end(); ++it)
+		{
+			gpu_ms += (*it)->getAverageMS();
+		}
+		F32 cpu_ms = (F32)(LLFastTimer::NamedTimer::getRootNamedTimer().getCountAverage() * iclock_freq);
+		F32 full_ms = llmax(cpu_ms, gpu_ms, 1.f);
+
+		x = xleft;
+		tdesc = llformat("GPU %.1f ms", gpu_ms);
+		LLFontGL::getFontMonospace()->renderUTF8(tdesc, 0, x, y, LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
+
+		left = xleft + LEGEND_WIDTH + 8;
+		barw = width - left - margin;
+		top = y;
+		bottom = y - texth;
+		S32 index = 0;
+		for (LLGPUTimer::timer_list_t::const_iterator it = timers.begin(); it != timers.end(); ++it, ++index)
+		{
+			F32 ms = (*it)->getAverageMS();
+			right = left + llround(ms / full_ms * barw);
+			if (right > left)
+			{
+				LLColor4 color = LLColor4::green;
+				color.setHSL((F32)(index % 12) / 12.f, 0.6f, 0.5f);
+				gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+				gl_rect_2d(left, top, right, bottom, color);
+
+				const std::string& name = (*it)->getName();
+				if (LLFontGL::getFontMonospace()->getWidth(name) < right - left - 4)
+				{
+					LLFontGL::getFontMonospace()->renderUTF8(name, 0, left + 2, top, LLColor4::black, LLFontGL::LEFT, LLFontGL::TOP);
+				}
+			}
+			left = right;
+		}
+		y -= (texth + 2);
+	}
+
 	S32 histmax = llmin(LLFastTimer::getLastFrameIndex()+1, MAX_VISIBLE_HISTORY);
 		
 	// Draw the legend
@@ -454,7 +507,6 @@ void LLFastTimerView::draw()
 		sTimerColors[idp] = child_color;
 	}
 
-	const S32 LEGEND_WIDTH = 220;
 	{
 		LLLocalClipRect clip(LLRect(margin, y, LEGEND_WIDTH, margin));
 		S32 cur_line = 0;
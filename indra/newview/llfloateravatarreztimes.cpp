@@ -0,0 +1,106 @@
+/**
+ * @file llfloateravatarreztimes.cpp
+ * @brief Debug floater listing how long nearby avatars took to reach each rez stage.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llfloateravatarreztimes.h"
+
+#include "llscrolllistctrl.h"
+#include "llvoavatar.h"
+
+// seconds between list refreshes while open
+const F32 REZ_TIMES_REFRESH_PERIOD = 1.f;
+
+LLFloaterAvatarRezTimes::LLFloaterAvatarRezTimes(const LLSD& key)
+:	LLFloater(key),
+	mList(NULL)
+{
+}
+
+LLFloaterAvatarRezTimes::~LLFloaterAvatarRezTimes()
+{
+}
+
+//virtual
+BOOL LLFloaterAvatarRezTimes::postBuild()
+{
+	mList = getChild<LLScrollListCtrl>("rez_list");
+	return TRUE;
+}
+
+//virtual
+void LLFloaterAvatarRezTimes::onOpen(const LLSD& key)
+{
+	refresh();
+}
+
+//virtual
+void LLFloaterAvatarRezTimes::draw()
+{
+	if (mRefreshTimer.getElapsedTimeF32() > REZ_TIMES_REFRESH_PERIOD)
+	{
+		refresh();
+	}
+
+	LLFloater::draw();
+}
+
+void LLFloaterAvatarRezTimes::refresh()
+{
+	mRefreshTimer.reset();
+
+	if (!mList)
+	{
+		return;
+	}
+
+	S32 scroll_pos = mList->getScrollPos();
+	mList->deleteAllItems();
+
+	for (std::vector<LLCharacter*>::iterator iter = LLCharacter::sInstances.begin();
+		 iter != LLCharacter::sInstances.end(); ++iter)
+	{
+		LLVOAvatar* avatarp = (LLVOAvatar*) *iter;
+		if (avatarp->isDead() || avatarp->mIsDummy)
+		{
+			continue;
+		}
+
+		LLSD row;
+		row["id"] = avatarp->getID();
+		row["columns"][0]["column"] = "name";
+		row["columns"][0]["value"] = avatarp->getFullname();
+		for (S32 i = 0; i < LLVOAvatar::REZ_STAGE_COUNT; i++)
+		{
+			F32 time = avatarp->getRezStageTime((LLVOAvatar::ERezStage) i);
+			row["columns"][i+1]["column"] = llformat("stage%d", i);
+			row["columns"][i+1]["value"] = time < 0.f ? std::string("-") : llformat("%.1f", time);
+		}
+		mList->addElement(row);
+	}
+
+	mList->setScrollPos(scroll_pos);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file llfloateravatarreztimes.h
+ * @brief Debug floater listing how long nearby avatars took to reach each rez stage.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFLOATERAVATARREZTIMES_H
+#define LL_LLFLOATERAVATARREZTIMES_H
+
+#include "llfloater.h"
+#include "llframetimer.h"
+
+class LLScrollListCtrl;
+
+class LLFloaterAvatarRezTimes
+: public LLFloater
+{
+	friend class LLFloaterReg;
+public:
+	/*virtual*/ BOOL postBuild();
+	/*virtual*/ void onOpen(const LLSD& key);
+	/*virtual*/ void draw();
+
+	void refresh();
+
+private:
+	LLFloaterAvatarRezTimes(const LLSD& key);
+	virtual ~LLFloaterAvatarRezTimes();
+
+	LLScrollListCtrl* mList;
+	LLFrameTimer mRefreshTimer;
+};
+
+#endif // LL_LLFLOATERAVATARREZTIMES_H
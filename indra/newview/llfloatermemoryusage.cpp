@@ -0,0 +1,115 @@
+/**
+ * @file llfloatermemoryusage.cpp
+ * @brief Debug floater breaking down the memory held by each subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llfloatermemoryusage.h"
+
+#include "llmemorycounter.h"
+#include "llmemoryusage.h"
+#include "llscrolllistctrl.h"
+#include "lltextbox.h"
+
+// seconds between list refreshes while open, matching the sample rate
+const F32 MEMORY_USAGE_REFRESH_PERIOD = 1.f;
+
+static std::string format_mb(S64 bytes, bool sign = false)
+{
+	return llformat(sign ? "%+.1f" : "%.1f", bytes / (1024.0 * 1024.0));
+}
+
+LLFloaterMemoryUsage::LLFloaterMemoryUsage(const LLSD& key)
+:	LLFloater(key),
+	mList(NULL),
+	mTotal(NULL)
+{
+}
+
+LLFloaterMemoryUsage::~LLFloaterMemoryUsage()
+{
+}
+
+//virtual
+BOOL LLFloaterMemoryUsage::postBuild()
+{
+	mList = getChild<LLScrollListCtrl>("memory_list");
+	mTotal = getChild<LLTextBox>("memory_total");
+	return TRUE;
+}
+
+//virtual
+void LLFloaterMemoryUsage::onOpen(const LLSD& key)
+{
+	refresh();
+}
+
+//virtual
+void LLFloaterMemoryUsage::draw()
+{
+	if (mRefreshTimer.getElapsedTimeF32() > MEMORY_USAGE_REFRESH_PERIOD)
+	{
+		refresh();
+	}
+
+	LLFloater::draw();
+}
+
+void LLFloaterMemoryUsage::refresh()
+{
+	mRefreshTimer.reset();
+
+	if (!mList)
+	{
+		return;
+	}
+
+	mTotal->setText(llformat("Process: %s MB", format_mb(LLMemoryUsage::getProcessBytes()).c_str()));
+
+	S32 scroll_pos = mList->getScrollPos();
+	mList->deleteAllItems();
+
+	const LLMemoryUsage::usage_list_t& usage_list = LLMemoryUsage::getUsage();
+	for (LLMemoryUsage::usage_list_t::const_iterator iter = usage_list.begin();
+		 iter != usage_list.end(); ++iter)
+	{
+		const LLMemoryUsage::Usage& usage = *iter;
+
+		LLSD row;
+		row["columns"][0]["column"] = "name";
+		row["columns"][0]["value"] = usage.mCounter->getName();
+		row["columns"][1]["column"] = "current";
+		row["columns"][1]["value"] = format_mb(usage.mBytes);
+		row["columns"][2]["column"] = "peak";
+		row["columns"][2]["value"] = format_mb(usage.mPeakBytes);
+		row["columns"][3]["column"] = "change1";
+		row["columns"][3]["value"] = format_mb(usage.getChange(60), true);
+		row["columns"][4]["column"] = "change5";
+		row["columns"][4]["value"] = format_mb(usage.getChange(LLMemoryUsage::HISTORY_SECONDS), true);
+		mList->addElement(row);
+	}
+
+	mList->setScrollPos(scroll_pos);
+}
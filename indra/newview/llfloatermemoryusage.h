@@ -0,0 +1,56 @@
+/**
+ * @file llfloatermemoryusage.h
+ * @brief Debug floater breaking down the memory held by each subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFLOATERMEMORYUSAGE_H
+#define LL_LLFLOATERMEMORYUSAGE_H
+
+#include "llfloater.h"
+#include "llframetimer.h"
+
+class LLScrollListCtrl;
+class LLTextBox;
+
+class LLFloaterMemoryUsage
+: public LLFloater
+{
+	friend class LLFloaterReg;
+public:
+	/*virtual*/ BOOL postBuild();
+	/*virtual*/ void onOpen(const LLSD& key);
+	/*virtual*/ void draw();
+
+	void refresh();
+
+private:
+	LLFloaterMemoryUsage(const LLSD& key);
+	virtual ~LLFloaterMemoryUsage();
+
+	LLScrollListCtrl* mList;
+	LLTextBox* mTotal;
+	LLFrameTimer mRefreshTimer;
+};
+
+#endif // LL_LLFLOATERMEMORYUSAGE_H
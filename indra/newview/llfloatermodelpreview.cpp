@@ -80,6 +80,7 @@
 #include "llmenubutton.h"
 #include "llmeshrepository.h"
 #include "llnotificationsutil.h"
+#include "llparallelfor.h"
 #include "llsdutil_math.h"
 #include "lltextbox.h"
 #include "lltoolmgr.h"
@@ -1289,6 +1290,8 @@ LLModelLoader::LLModelLoader( std::string filename, S32 lod, LLModelPreview* pre
 , mJointsFromNode( jointsFromNodes )
 , LLThread("Model Loader"), mFilename(filename), mLod(lod), mPreview(preview), mFirstTransform(TRUE), mNumOfFetchingTextures(0)
 {
+	mWorkerThreads = llmin(gSavedSettings.getU32("MeshImportWorkerThreads"), (U32) 16);
+
 	mJointMap["mPelvis"] = "mPelvis";
 	mJointMap["mTorso"] = "mTorso";
 	mJointMap["mChest"] = "mChest";
@@ -1456,6 +1459,22 @@ void LLModelLoader::run()
 	doOnIdleOneTime(boost::bind(&LLModelLoader::loadModelCallback,this));
 }
 
+// Normalizes and optimizes the faces of each loaded mesh, models don't share
+// any data so any of them can be finished on any thread.
+class LLModelFinishBody : public LLParallelFor::Body
+{
+public:
+	LLModelFinishBody(const std::vector<LLPointer<LLModel> >& models)
+		: mModels(models) { }
+
+	/*virtual*/ void run(U32 index)
+	{
+		mModels[index]->finishVolumeFaces();
+	}
+
+	const std::vector<LLPointer<LLModel> >& mModels;
+};
+
 bool LLModelLoader::doLoadModel()
 {
 	//first, look for a .slm file of the same name that was modified later
@@ -1588,6 +1607,10 @@ bool LLModelLoader::doLoadModel()
 	mTransform = rotation;
 	
 	
+	//the DOM isn't thread safe, so meshes are read here and only the
+	//normalize and optimize passes are spread over worker threads
+	std::vector<domMesh*> meshes;
+	std::vector<LLPointer<LLModel> > models;
 	for (daeInt idx = 0; idx < count; ++idx)
 	{ //build map of domEntities to LLModel
 		domMesh* mesh = NULL;
@@ -1595,7 +1618,7 @@ bool LLModelLoader::doLoadModel()
 		
 		if (mesh)
 		{
-			LLPointer<LLModel> model = LLModel::loadModelFromDomMesh(mesh);
+			LLPointer<LLModel> model = LLModel::loadModelFromDomMesh(mesh, false);
 			
 			if(model->getStatus() != LLModel::NO_ERRORS)
 			{
@@ -1603,11 +1626,31 @@ bool LLModelLoader::doLoadModel()
 				return false; //abort
 			}
 
-			if (model.notNull() && validate_model(model))
-			{
-				mModelList.push_back(model);
-				mModel[mesh] = model;
-			}
+			meshes.push_back(mesh);
+			models.push_back(model);
+		}
+	}
+
+	LLModelFinishBody body(models);
+	if (mWorkerThreads > 0 && models.size() > 1)
+	{
+		LLParallelFor workers("Model Loader Worker", llmin(mWorkerThreads, (U32) models.size() - 1));
+		workers.run(body, models.size());
+	}
+	else
+	{
+		for (U32 i = 0; i < models.size(); ++i)
+		{
+			body.run(i);
+		}
+	}
+
+	for (U32 i = 0; i < models.size(); ++i)
+	{
+		if (validate_model(models[i]))
+		{
+			mModelList.push_back(models[i]);
+			mModel[meshes[i]] = models[i];
 		}
 	}
 	
@@ -5843,7 +5886,19 @@ S32 LLFloaterModelPreview::DecompRequest::statusCallback(const char* status, S32
 		setStatusMessage(llformat("%s: %d/%d", status, p1, p2));
 		if (LLFloaterModelPreview::sInstance)
 		{
-			LLFloaterModelPreview::sInstance->setStatusMessage(mStatusMessage);
+			//pieces decompose in parallel, so show overall progress alongside this one's stage
+			S32 done = 0;
+			S32 total = 0;
+			gMeshRepo.mDecompThread->getProgress(done, total);
+
+			if (total > 1)
+			{
+				LLFloaterModelPreview::sInstance->setStatusMessage(llformat("%s (%d/%d)", mStatusMessage.c_str(), done, total));
+			}
+			else
+			{
+				LLFloaterModelPreview::sInstance->setStatusMessage(mStatusMessage);
+			}
 		}
 	}
 
@@ -82,6 +82,7 @@ public:
 	BOOL mFirstTransform;
 	LLVector3 mExtents[2];
 	bool mTrySLM;
+	U32 mWorkerThreads;	// threads used to finish meshes, 0 to do it on the loader thread
 	
 	std::map<daeElement*, LLPointer<LLModel> > mModel;
 	
@@ -155,6 +156,7 @@ public:
 		DecompRequest(const std::string& stage, LLModel* mdl);
 		virtual S32 statusCallback(const char* status, S32 p1, S32 p2);
 		virtual void completed();
+		virtual bool isCancelled() const { return !mContinue; }
 		
 	};
 	static LLFloaterModelPreview* sInstance;
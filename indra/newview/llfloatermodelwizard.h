@@ -49,6 +49,7 @@ public:
 		DecompRequest(const std::string& stage, LLModel* mdl);
 		virtual S32 statusCallback(const char* status, S32 p1, S32 p2);
 		virtual void completed();
+		virtual bool isCancelled() const { return !mContinue; }
 		
 	};
 	
@@ -33,6 +33,7 @@
 // Viewer includes
 #include "llagent.h"
 #include "llagentcamera.h"
+#include "llappviewer.h"
 #include "llcallbacklist.h"
 #include "llcriticaldamp.h"
 #include "llfloaterperms.h"
@@ -74,6 +75,7 @@
 #include "llimagepng.h"
 #include "llimagebmp.h"
 #include "llimagej2c.h"
+#include "llimageworker.h"
 #include "lllocalcliprect.h"
 #include "llnotificationsutil.h"
 #include "llpostcard.h"
@@ -102,6 +104,154 @@ const S32 MAX_TEXTURE_SIZE = 512 ; //max upload texture size 512 * 512
 
 static LLDefaultChildRegistry::Register<LLSnapshotFloaterView> r("snapshot_floater_view");
 
+///----------------------------------------------------------------------------
+/// Class LLSnapshotEncodeRequest
+///----------------------------------------------------------------------------
+
+// What the encode thread hands back to the preview.  The preview polls mDone
+// from onIdle() and drops its pointer if the snapshot is invalidated first.
+class LLSnapshotEncodeResult : public LLThreadSafeRefCount
+{
+public:
+	LLSnapshotEncodeResult()
+	:	mDone(0),
+		mEncoded(FALSE),
+		mDataSize(0),
+		mScaled(FALSE)
+	{
+	}
+
+	// does the work of the request, also called directly when there is no decode thread
+	void encode(LLImageRaw* raw, bool texture, LLFloaterSnapshot::ESnapshotFormat format, S32 quality);
+
+	LLAtomicU32					mDone;
+	BOOL						mEncoded;
+	LLPointer<LLImageFormatted>	mFormattedImage;	// NULL for textures
+	LLPointer<LLImageRaw>		mEncodedImage;		// the encoded image decoded back, for size and artifacts
+	LLPointer<LLImageRaw>		mDisplayImage;		// mEncodedImage resized for the preview texture
+	S32							mDataSize;
+	BOOL						mScaled;
+};
+
+// Encodes a snapshot, decodes it back and prepares the preview image on the
+// image decode thread, which used to stall the frame for large snapshots.
+// Only the GL texture creation is left for the main thread.
+class LLSnapshotEncodeRequest : public LLQueuedThread::QueuedRequest
+{
+public:
+	LLSnapshotEncodeRequest(LLQueuedThread::handle_t handle, LLImageRaw* raw, bool texture,
+							LLFloaterSnapshot::ESnapshotFormat format, S32 quality,
+							LLSnapshotEncodeResult* result)
+	:	LLQueuedThread::QueuedRequest(handle, LLQueuedThread::PRIORITY_HIGH, LLQueuedThread::FLAG_AUTO_COMPLETE),
+		mRawImage(raw),
+		mTexture(texture),
+		mFormat(format),
+		mQuality(quality),
+		mResult(result)
+	{
+	}
+
+	/*virtual*/ bool processRequest();
+	/*virtual*/ void finishRequest(bool completed);
+
+private:
+	LLPointer<LLImageRaw>		mRawImage;
+	bool						mTexture;
+	LLFloaterSnapshot::ESnapshotFormat mFormat;
+	S32							mQuality;
+	LLPointer<LLSnapshotEncodeResult> mResult;
+};
+
+void LLSnapshotEncodeResult::encode(LLImageRaw* raw, bool texture, LLFloaterSnapshot::ESnapshotFormat format, S32 quality)
+{
+	mEncodedImage = new LLImageRaw(raw->getWidth(), raw->getHeight(), raw->getComponents());
+
+	if (texture)
+	{
+		LLPointer<LLImageJ2C> formatted = new LLImageJ2C;
+		LLPointer<LLImageRaw> scaled = new LLImageRaw(
+			raw->getData(),
+			raw->getWidth(),
+			raw->getHeight(),
+			raw->getComponents());
+
+		scaled->biasedScaleToPowerOfTwo(MAX_TEXTURE_SIZE);
+		mScaled = TRUE;
+		if (formatted->encode(scaled, 0.f))
+		{
+			mEncoded = TRUE;
+			mDataSize = formatted->getDataSize();
+			formatted->decode(mEncodedImage, 0);
+		}
+	}
+	else
+	{
+		switch(format)
+		{
+		case LLFloaterSnapshot::SNAPSHOT_FORMAT_PNG:
+			mFormattedImage = new LLImagePNG();
+			break;
+		case LLFloaterSnapshot::SNAPSHOT_FORMAT_JPEG:
+			mFormattedImage = new LLImageJPEG(quality);
+			break;
+		case LLFloaterSnapshot::SNAPSHOT_FORMAT_BMP:
+			mFormattedImage = new LLImageBMP();
+			break;
+		}
+		if (mFormattedImage->encode(raw, 0))
+		{
+			mEncoded = TRUE;
+			mDataSize = mFormattedImage->getDataSize();
+			// special case BMP to copy instead of decode otherwise decode will crash.
+			if (format == LLFloaterSnapshot::SNAPSHOT_FORMAT_BMP)
+			{
+				mEncodedImage->copy(raw);
+			}
+			else
+			{
+				mFormattedImage->decode(mEncodedImage, 0);
+			}
+		}
+	}
+
+	LLPointer<LLImageRaw> scaled = new LLImageRaw(
+		mEncodedImage->getData(),
+		mEncodedImage->getWidth(),
+		mEncodedImage->getHeight(),
+		mEncodedImage->getComponents());
+
+	if (!scaled->isBufferInvalid())
+	{
+		// leave original image dimensions, just scale up texture buffer
+		if (mEncodedImage->getWidth() > 1024 || mEncodedImage->getHeight() > 1024)
+		{
+			// go ahead and shrink image to appropriate power of 2 for display
+			scaled->biasedScaleToPowerOfTwo(1024);
+			mScaled = TRUE;
+		}
+		else
+		{
+			// expand image but keep original image data intact
+			scaled->expandToPowerOfTwo(1024, FALSE);
+		}
+		mDisplayImage = scaled;
+	}
+}
+
+//virtual
+bool LLSnapshotEncodeRequest::processRequest()
+{
+	mResult->encode(mRawImage, mTexture, mFormat, mQuality);
+	return true;
+}
+
+//virtual
+void LLSnapshotEncodeRequest::finishRequest(bool completed)
+{
+	// an aborted request leaves mDisplayImage NULL, which the preview treats as a failed snapshot
+	mResult->mDone = 1;
+}
+
 ///----------------------------------------------------------------------------
 /// Class LLSnapshotLivePreview 
 ///----------------------------------------------------------------------------
@@ -148,6 +298,7 @@ public:
 	LLFloaterSnapshot::ESnapshotFormat getSnapshotFormat() const { return mSnapshotFormat; }
 	BOOL getSnapshotUpToDate() const { return mSnapshotUpToDate; }
 	BOOL isSnapshotActive() { return mSnapshotActive; }
+	BOOL isEncoding() const { return mEncodeResult.notNull(); }
 	LLViewerTexture* getThumbnailImage() const { return mThumbnailImage ; }
 	S32  getThumbnailWidth() const { return mThumbnailWidth ; }
 	S32  getThumbnailHeight() const { return mThumbnailHeight ; }
@@ -182,6 +333,12 @@ public:
 	// Returns TRUE when snapshot generated, FALSE otherwise.
 	static BOOL onIdle( void* snapshot_preview );
 
+private:
+	void startEncode();
+	void finishEncode();
+
+public:
+
 	// callback for region name resolve
 	void regionNameCallback(LLImageJPEG* snapshot, LLSD& metadata, const std::string& name, S32 x, S32 y, S32 z);
 
@@ -206,6 +363,7 @@ private:
 	LLPointer<LLImageRaw>		mPreviewImage;
 	LLPointer<LLImageRaw>		mPreviewImageEncoded;
 	LLPointer<LLImageFormatted>	mFormattedImage;
+	LLPointer<LLSnapshotEncodeResult> mEncodeResult;	// set while the encode thread has the snapshot
 	LLFrameTimer				mSnapshotDelayTimer;
 	S32							mShineCountdown;
 	LLFrameTimer				mShineAnimTimer;
@@ -278,6 +436,7 @@ LLSnapshotLivePreview::~LLSnapshotLivePreview()
 	mPreviewImage = NULL;
 	mPreviewImageEncoded = NULL;
 	mFormattedImage = NULL;
+	mEncodeResult = NULL;
 
 // 	gIdleCallbacks.deleteFunction( &LLSnapshotLivePreview::onIdle, (void*)this );
 	sList.erase(this);
@@ -337,6 +496,8 @@ void LLSnapshotLivePreview::updateSnapshot(BOOL new_snapshot, BOOL new_thumbnail
 		mFallAnimTimer.start();		
 	}
 	mSnapshotUpToDate = FALSE; 		
+	// any encode still running is for the old image
+	mEncodeResult = NULL;
 
 	// Update snapshot source rect depending on whether we keep the aspect ratio.
 	LLRect& rect = mImageRect[mCurImageIndex];
@@ -389,6 +550,7 @@ void LLSnapshotLivePreview::setSnapshotQuality(S32 quality)
 		mSnapshotQuality = quality;
 		gSavedSettings.setS32("SnapshotQuality", quality);
 		mSnapshotUpToDate = FALSE;
+		mEncodeResult = NULL;
 	}
 }
 
@@ -776,6 +938,14 @@ BOOL LLSnapshotLivePreview::onIdle( void* snapshot_preview )
 			autosnap ? AUTO_SNAPSHOT_TIME_DELAY : 0.f); // shutter delay if 1st arg is true.
 	}
 
+	// pick up the encode of the last snapshot
+	if (previewp->mEncodeResult.notNull() && previewp->mEncodeResult->mDone)
+	{
+		previewp->finishEncode();
+		LLFloaterSnapshot::postUpdate();
+		return TRUE;
+	}
+
 	// see if it's time yet to snap the shot and bomb out otherwise.
 	previewp->mSnapshotActive = 
 		(previewp->mSnapshotDelayTimer.getStarted() &&	previewp->mSnapshotDelayTimer.hasExpired())
@@ -789,10 +959,8 @@ BOOL LLSnapshotLivePreview::onIdle( void* snapshot_preview )
 	previewp->setThumbnailImageSize();
 
 	lldebugs << "producing snapshot" << llendl;
-	if (!previewp->mPreviewImage)
-	{
-		previewp->mPreviewImage = new LLImageRaw;
-	}
+	// always a new image, an earlier one may still be with the encode thread
+	previewp->mPreviewImage = new LLImageRaw;
 
 	if (!previewp->mPreviewImageEncoded)
 	{
@@ -805,8 +973,8 @@ BOOL LLSnapshotLivePreview::onIdle( void* snapshot_preview )
 	previewp->getWindow()->incBusyCount();
 	previewp->setImageScaled(FALSE);
 
-	// grab the raw image and encode it into desired format
-	if(gViewerWindow->rawSnapshot(
+	// grab the raw image and hand it off to be encoded into desired format
+	BOOL started = gViewerWindow->rawSnapshot(
 							previewp->mPreviewImage,
 							previewp->getWidth(),
 							previewp->getHeight(),
@@ -815,106 +983,11 @@ BOOL LLSnapshotLivePreview::onIdle( void* snapshot_preview )
 							gSavedSettings.getBOOL("RenderUIInSnapshot"),
 							FALSE,
 							previewp->mSnapshotBufferType,
-							previewp->getMaxImageSize()))
+							previewp->getMaxImageSize());
+	if (started)
 	{
-		previewp->mPreviewImageEncoded->resize(
-			previewp->mPreviewImage->getWidth(), 
-			previewp->mPreviewImage->getHeight(), 
-			previewp->mPreviewImage->getComponents());
-
-		if(previewp->getSnapshotType() == SNAPSHOT_TEXTURE)
-		{
-			lldebugs << "Encoding new image of format J2C" << llendl;
-			LLPointer<LLImageJ2C> formatted = new LLImageJ2C;
-			LLPointer<LLImageRaw> scaled = new LLImageRaw(
-				previewp->mPreviewImage->getData(),
-				previewp->mPreviewImage->getWidth(),
-				previewp->mPreviewImage->getHeight(),
-				previewp->mPreviewImage->getComponents());
-		
-			scaled->biasedScaleToPowerOfTwo(MAX_TEXTURE_SIZE);
-			previewp->setImageScaled(TRUE);
-			if (formatted->encode(scaled, 0.f))
-			{
-				previewp->mDataSize = formatted->getDataSize();
-				formatted->decode(previewp->mPreviewImageEncoded, 0);
-			}
-		}
-		else
-		{
-			// delete any existing image
-			previewp->mFormattedImage = NULL;
-			// now create the new one of the appropriate format.
-			LLFloaterSnapshot::ESnapshotFormat format = previewp->getSnapshotFormat();
-			lldebugs << "Encoding new image of format " << format << llendl;
-
-			switch(format)
-			{
-			case LLFloaterSnapshot::SNAPSHOT_FORMAT_PNG:
-				previewp->mFormattedImage = new LLImagePNG(); 
-				break;
-			case LLFloaterSnapshot::SNAPSHOT_FORMAT_JPEG:
-				previewp->mFormattedImage = new LLImageJPEG(previewp->mSnapshotQuality); 
-				break;
-			case LLFloaterSnapshot::SNAPSHOT_FORMAT_BMP:
-				previewp->mFormattedImage = new LLImageBMP(); 
-				break;
-			}
-			if (previewp->mFormattedImage->encode(previewp->mPreviewImage, 0))
-			{
-				previewp->mDataSize = previewp->mFormattedImage->getDataSize();
-				// special case BMP to copy instead of decode otherwise decode will crash.
-				if(format == LLFloaterSnapshot::SNAPSHOT_FORMAT_BMP)
-				{
-					previewp->mPreviewImageEncoded->copy(previewp->mPreviewImage);
-				}
-				else
-				{
-					previewp->mFormattedImage->decode(previewp->mPreviewImageEncoded, 0);
-				}
-			}
-		}
-
-		LLPointer<LLImageRaw> scaled = new LLImageRaw(
-			previewp->mPreviewImageEncoded->getData(),
-			previewp->mPreviewImageEncoded->getWidth(),
-			previewp->mPreviewImageEncoded->getHeight(),
-			previewp->mPreviewImageEncoded->getComponents());
-		
-		if(!scaled->isBufferInvalid())
-		{
-			// leave original image dimensions, just scale up texture buffer
-			if (previewp->mPreviewImageEncoded->getWidth() > 1024 || previewp->mPreviewImageEncoded->getHeight() > 1024)
-			{
-				// go ahead and shrink image to appropriate power of 2 for display
-				scaled->biasedScaleToPowerOfTwo(1024);
-				previewp->setImageScaled(TRUE);
-			}
-			else
-			{
-				// expand image but keep original image data intact
-				scaled->expandToPowerOfTwo(1024, FALSE);
-			}
-
-			previewp->mViewerImage[previewp->mCurImageIndex] = LLViewerTextureManager::getLocalTexture(scaled.get(), FALSE);
-			LLPointer<LLViewerTexture> curr_preview_image = previewp->mViewerImage[previewp->mCurImageIndex];
-			gGL.getTexUnit(0)->bind(curr_preview_image);
-			if (previewp->getSnapshotType() != SNAPSHOT_TEXTURE)
-			{
-				curr_preview_image->setFilteringOption(LLTexUnit::TFO_POINT);
-			}
-			else
-			{
-				curr_preview_image->setFilteringOption(LLTexUnit::TFO_ANISOTROPIC);
-			}
-			curr_preview_image->setAddressMode(LLTexUnit::TAM_CLAMP);
-
-			previewp->mSnapshotUpToDate = TRUE;
-			previewp->generateThumbnailImage(TRUE) ;
-
-			previewp->mPosTakenGlobal = gAgentCamera.getCameraPositionGlobal();
-			previewp->mShineCountdown = 4; // wait a few frames to avoid animation glitch due to readback this frame
-		}
+		previewp->mPosTakenGlobal = gAgentCamera.getCameraPositionGlobal();
+		previewp->startEncode();
 	}
 	previewp->getWindow()->decBusyCount();
 	// only show fullscreen preview when in freeze frame mode
@@ -926,12 +999,77 @@ BOOL LLSnapshotLivePreview::onIdle( void* snapshot_preview )
 	{
 		previewp->generateThumbnailImage() ;
 	}
+
+	// without a decode thread startEncode() finished the job already
+	if (previewp->mEncodeResult.notNull() && previewp->mEncodeResult->mDone)
+	{
+		previewp->finishEncode();
+	}
 	lldebugs << "done creating snapshot" << llendl;
 	LLFloaterSnapshot::postUpdate();
 
 	return TRUE;
 }
 
+void LLSnapshotLivePreview::startEncode()
+{
+	mEncodeResult = new LLSnapshotEncodeResult;
+	bool texture = getSnapshotType() == SNAPSHOT_TEXTURE;
+	lldebugs << "Encoding new image of format " << (texture ? "J2C" : llformat("%d", getSnapshotFormat())) << llendl;
+
+	LLImageDecodeThread* decode_thread = LLAppViewer::getImageDecodeThread();
+	if (decode_thread && !decode_thread->isQuitting())
+	{
+		LLQueuedThread::handle_t handle = decode_thread->generateHandle();
+		decode_thread->addRequest(new LLSnapshotEncodeRequest(handle, mPreviewImage, texture,
+															  getSnapshotFormat(), mSnapshotQuality, mEncodeResult));
+		return;
+	}
+
+	mEncodeResult->encode(mPreviewImage, texture, getSnapshotFormat(), mSnapshotQuality);
+	mEncodeResult->mDone = 1;
+}
+
+void LLSnapshotLivePreview::finishEncode()
+{
+	LLPointer<LLSnapshotEncodeResult> result = mEncodeResult;
+	mEncodeResult = NULL;
+
+	if (result->mEncoded)
+	{
+		mDataSize = result->mDataSize;
+	}
+	if (getSnapshotType() != SNAPSHOT_TEXTURE)
+	{
+		mFormattedImage = result->mFormattedImage;
+	}
+	mPreviewImageEncoded = result->mEncodedImage;
+	setImageScaled(result->mScaled);
+
+	if (result->mDisplayImage.isNull())
+	{
+		return;
+	}
+
+	mViewerImage[mCurImageIndex] = LLViewerTextureManager::getLocalTexture(result->mDisplayImage.get(), FALSE);
+	LLPointer<LLViewerTexture> curr_preview_image = mViewerImage[mCurImageIndex];
+	gGL.getTexUnit(0)->bind(curr_preview_image);
+	if (getSnapshotType() != SNAPSHOT_TEXTURE)
+	{
+		curr_preview_image->setFilteringOption(LLTexUnit::TFO_POINT);
+	}
+	else
+	{
+		curr_preview_image->setFilteringOption(LLTexUnit::TFO_ANISOTROPIC);
+	}
+	curr_preview_image->setAddressMode(LLTexUnit::TAM_CLAMP);
+
+	mSnapshotUpToDate = TRUE;
+	generateThumbnailImage(TRUE) ;
+
+	mShineCountdown = 4; // wait a few frames to avoid animation glitch due to readback this frame
+}
+
 void LLSnapshotLivePreview::setSize(S32 w, S32 h)
 {
 	lldebugs << "setSize(" << w << ", " << h << ")" << llendl;
@@ -2089,7 +2227,8 @@ void LLFloaterSnapshot::draw()
 	{		
 		if(previewp->getThumbnailImage())
 		{
-			bool working = impl.getStatus() == Impl::STATUS_WORKING;
+			// grey out the thumbnail while posting or while the new shot is still encoding
+			bool working = impl.getStatus() == Impl::STATUS_WORKING || previewp->isEncoding();
 			const LLRect& thumbnail_rect = getThumbnailPlaceholderRect();
 			const S32 thumbnail_w = previewp->getThumbnailWidth();
 			const S32 thumbnail_h = previewp->getThumbnailHeight();
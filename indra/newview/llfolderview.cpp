@@ -336,6 +336,7 @@ LLFolderView::~LLFolderView( void )
 	mFolders.clear();
 
 	mItemMap.clear();
+	mSearchIndex.clear();
 
 	delete mFilter;
 	mFilter = NULL;
@@ -2092,11 +2093,13 @@ void LLFolderView::setShowSingleSelection(BOOL show)
 void LLFolderView::addItemID(const LLUUID& id, LLFolderViewItem* itemp)
 {
 	mItemMap[id] = itemp;
+	mSearchIndex.update(id, itemp->getSearchableLabel());
 }
 
 void LLFolderView::removeItemID(const LLUUID& id)
 {
 	mItemMap.erase(id);
+	mSearchIndex.remove(id);
 }
 
 LLFastTimer::DeclareTimer FTM_GET_ITEM_BY_ID("Get FolderViewItem by ID");
@@ -2108,7 +2111,7 @@ LLFolderViewItem* LLFolderView::getItemByID(const LLUUID& id)
 		return this;
 	}
 
-	std::map<LLUUID, LLFolderViewItem*>::iterator map_it;
+	LLFlatHashMap<LLUUID, LLFolderViewItem*>::iterator map_it;
 	map_it = mItemMap.find(id);
 	if (map_it != mItemMap.end())
 	{
@@ -42,6 +42,8 @@
 #include "lldarray.h"
 #include "stdenums.h"
 #include "lldepthstack.h"
+#include "llflathashmap.h"
+#include "llinventorysearchindex.h"
 #include "lleditmenuhandler.h"
 #include "llfontgl.h"
 #include "llscrollcontainer.h"
@@ -239,6 +241,7 @@ public:
 	void scrollToShowSelection();
 	void scrollToShowItem(LLFolderViewItem* item, const LLRect& constraint_rect);
 	void setScrollContainer( LLScrollContainer* parent ) { mScrollContainer = parent; }
+	LLScrollContainer* getScrollContainer() const { return mScrollContainer; }
 	LLRect getVisibleRect();
 
 	BOOL search(LLFolderViewItem* first_item, const std::string &search_string, BOOL backward);
@@ -252,6 +255,8 @@ public:
 	void addItemID(const LLUUID& id, LLFolderViewItem* itemp);
 	void removeItemID(const LLUUID& id);
 	LLFolderViewItem* getItemByID(const LLUUID& id);
+	// searchable labels of every item, for the filter's substring test
+	LLInventorySearchIndex& getSearchIndex() { return mSearchIndex; }
 	LLFolderViewFolder* getFolderByID(const LLUUID& id);
 	
 	bool doToSelected(LLInventoryModel* model, const LLSD& userdata);
@@ -339,7 +344,8 @@ protected:
 	S32								mSignalSelectCallback;
 	S32								mMinWidth;
 	S32								mRunningHeight;
-	std::map<LLUUID, LLFolderViewItem*> mItemMap;
+	LLFlatHashMap<LLUUID, LLFolderViewItem*> mItemMap;
+	LLInventorySearchIndex			mSearchIndex;
 	BOOL							mDragAndDropThisFrame;
 	
 	LLUUID							mSelectThisID; // if non null, select this item
@@ -313,6 +313,10 @@ void LLFolderViewItem::refresh()
 	if (mSearchableLabel.compare(searchable_label))
 	{
 		mSearchableLabel.assign(searchable_label);
+		if (mRoot && mRoot != this && mListener)
+		{
+			mRoot->getSearchIndex().update(mListener->getUUID(), mSearchableLabel);
+		}
 		dirtyFilter();
 		// some part of label has changed, so overall width has potentially changed, and sort order too
 		if (mParentFolder)
@@ -633,6 +637,14 @@ const std::string& LLFolderViewItem::getSearchableLabel() const
 	return mSearchableLabel;
 }
 
+std::string::size_type LLFolderViewItem::findInSearchableLabel(const std::string& substring, bool& indexed) const
+{
+	std::string::size_type offset = std::string::npos;
+	indexed = mRoot && mListener
+		&& mRoot->getSearchIndex().findMatch(mListener->getUUID(), substring, offset);
+	return indexed ? offset : mSearchableLabel.find(substring);
+}
+
 LLViewerInventoryItem * LLFolderViewItem::getInventoryItem(void)
 {
 	if (!getListener()) return NULL;
@@ -2586,12 +2598,69 @@ void LLFolderViewFolder::draw()
 	// draw children if root folder, or any other folder that is open or animating to closed state
 	if( getRoot() == this || (mIsOpen || mCurHeight != mTargetHeight ))
 	{
-		LLView::draw();
+		if (getRoot() == this || !drawVisibleChildren())
+		{
+			LLView::draw();
+		}
 	}
 
 	mExpanderHighlighted = FALSE;
 }
 
+// LLView::draw() asks every child for its screen rect, which adds up to
+// real time in a folder of thousands of items. arrange() lays children out
+// top to bottom, folders then items, so the ones in view are a run of each
+// list: skip to it and stop at its end.
+bool LLFolderViewFolder::drawVisibleChildren()
+{
+	LLFolderView* root = getRoot();
+	if (!root->getScrollContainer()
+		|| getChildCount() != (S32)(mFolders.size() + mItems.size()))
+	{
+		// something other than rows to draw, or no scrolling to speak of
+		return false;
+	}
+
+	LLRect visible_rect;
+	root->localRectToOtherView(root->getVisibleRect(), &visible_rect, this);
+
+	for (folders_t::iterator fit = mFolders.begin(); fit != mFolders.end(); ++fit)
+	{
+		if (!drawChildInRect(*fit, visible_rect))
+		{
+			// the items are all below the folders
+			return true;
+		}
+	}
+	for (items_t::iterator iit = mItems.begin(); iit != mItems.end(); ++iit)
+	{
+		if (!drawChildInRect(*iit, visible_rect))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+bool LLFolderViewFolder::drawChildInRect(LLFolderViewItem* itemp, const LLRect& visible_rect)
+{
+	if (!itemp->getVisible() || !itemp->getRect().isValid())
+	{
+		// hidden rows keep whatever place they last had, don't judge by them
+		return true;
+	}
+	const LLRect& rect = itemp->getRect();
+	if (rect.mTop <= visible_rect.mBottom)
+	{
+		return false;
+	}
+	if (rect.mBottom < visible_rect.mTop)
+	{
+		drawChild(itemp);
+	}
+	return true;
+}
+
 time_t LLFolderViewFolder::getCreationDate() const
 {
 	return llmax<time_t>(mCreationDate, mSubtreeCreationDate);
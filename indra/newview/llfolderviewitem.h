@@ -267,6 +267,9 @@ public:
 	const std::string& getName( void ) const;
 
 	const std::string& getSearchableLabel( void ) const;
+	// Where substring starts in the searchable label. indexed is set when
+	// the root's search index answered instead of a search of the label.
+	std::string::size_type findInSearchableLabel(const std::string& substring, bool& indexed) const;
 
 	// This method returns the label displayed on the view. This
 	// method was primarily added to allow sorting on the folder
@@ -544,6 +547,13 @@ public:
 									   EAcceptance* accept,
 									   std::string& tooltip_msg);
 	virtual void draw();
+private:
+	// Draws only the children in the scrolled to part of the view, returns
+	// false when it can't tell which those are.
+	bool drawVisibleChildren();
+	// Returns false once itemp is below visible_rect
+	bool drawChildInRect(LLFolderViewItem* itemp, const LLRect& visible_rect);
+public:
 
 	time_t getCreationDate() const;
 	bool isTrash() const;
@@ -0,0 +1,154 @@
+/** 
+ * @file llframebudget.cpp
+ * @brief Scales draw distance and detail to hold a target frame rate.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llframebudget.h"
+
+#include "llagentcamera.h"
+#include "llviewercontrol.h"
+#include "llviewerpartsim.h"
+#include "llvoavatar.h"
+#include "llvovolume.h"
+#include "llworld.h"
+
+// Frame time is averaged over this long before deciding anything
+const F32 WINDOW_SECONDS = 0.5f;
+
+// Hysteresis: step down as soon as a window is over budget by 10%, but only
+// step up after two windows with 20% to spare
+const F32 SLOW_FACTOR = 1.1f;
+const F32 FAST_FACTOR = 0.8f;
+const S32 FAST_WINDOWS_TO_RAISE = 2;
+
+const F32 LEVEL_STEP_DOWN = 0.1f;
+const F32 LEVEL_STEP_UP = 0.05f;
+const F32 MIN_LEVEL = 0.25f;
+
+LLFrameBudget::LLFrameBudget()
+:	mLevel(1.f),
+	mActive(false),
+	mWindowTime(0.f),
+	mWindowFrames(0),
+	mAverageFrameTime(0.f),
+	mFastWindows(0)
+{
+}
+
+void LLFrameBudget::update(F32 frame_time)
+{
+	static LLCachedControl<bool> adaptive(gSavedSettings, "RenderAdaptiveQuality");
+	if (!adaptive)
+	{
+		if (mActive)
+		{
+			// hand everything back as the user set it
+			mActive = false;
+			mLevel = 1.f;
+			apply();
+		}
+		return;
+	}
+	mActive = true;
+
+	mWindowTime += frame_time;
+	mWindowFrames++;
+	if (mWindowTime < WINDOW_SECONDS)
+	{
+		return;
+	}
+
+	mAverageFrameTime = mWindowTime / mWindowFrames;
+	mWindowTime = 0.f;
+	mWindowFrames = 0;
+
+	static LLCachedControl<F32> target_fps(gSavedSettings, "RenderAdaptiveTargetFPS");
+	const F32 target_time = 1.f / llmax((F32)target_fps, 1.f);
+
+	F32 level = mLevel;
+	if (mAverageFrameTime > target_time * SLOW_FACTOR)
+	{
+		level -= LEVEL_STEP_DOWN;
+		mFastWindows = 0;
+	}
+	else if (mAverageFrameTime < target_time * FAST_FACTOR)
+	{
+		if (++mFastWindows >= FAST_WINDOWS_TO_RAISE)
+		{
+			level += LEVEL_STEP_UP;
+			mFastWindows = 0;
+		}
+	}
+	else
+	{
+		mFastWindows = 0;
+	}
+
+	level = llclamp(level, MIN_LEVEL, 1.f);
+	if (level != mLevel || mLevel < 1.f)
+	{
+		// reapplied while reducing, the user may have changed a setting
+		mLevel = level;
+		apply();
+	}
+}
+
+void LLFrameBudget::apply()
+{
+	static LLCachedControl<F32> min_far_clip(gSavedSettings, "RenderAdaptiveMinFarClip");
+
+	F32 far_clip = gSavedSettings.getF32("RenderFarClip");
+	if (far_clip > min_far_clip)
+	{
+		far_clip = llmax(far_clip * mLevel, (F32)min_far_clip);
+	}
+	if (far_clip != gAgentCamera.mDrawDistance)
+	{
+		gAgentCamera.mDrawDistance = far_clip;
+		LLWorld::getInstance()->setLandFarClip(far_clip);
+	}
+
+	// detail drops more gently than distance
+	F32 detail = lerp(0.5f, 1.f, (mLevel - MIN_LEVEL) / (1.f - MIN_LEVEL));
+
+	LLVOVolume::sLODFactor = gSavedSettings.getF32("RenderVolumeLODFactor") * detail;
+	LLVOVolume::sDistanceFactor = 1.f-LLVOVolume::sLODFactor * 0.1f;
+
+	S32 max_visible = gSavedSettings.getS32("RenderAvatarMaxVisible");
+	LLVOAvatar::sMaxVisible = (U32)llmax(llmin(max_visible, 3), (S32)(max_visible * mLevel));
+
+	LLViewerPartSim::setMaxPartCount((S32)(gSavedSettings.getS32("RenderMaxPartCount") * mLevel));
+}
+
+std::string LLFrameBudget::getDebugText() const
+{
+	static LLCachedControl<F32> target_fps(gSavedSettings, "RenderAdaptiveTargetFPS");
+	return llformat("Adaptive quality %d%% (%.1f ms, target %.1f ms): %.0fm, LOD %.2f, %d avatars, %d particles",
+					(S32)(mLevel * 100.f + 0.5f), mAverageFrameTime * 1000.f,
+					1000.f / llmax((F32)target_fps, 1.f),
+					gAgentCamera.mDrawDistance, LLVOVolume::sLODFactor,
+					(S32)LLVOAvatar::sMaxVisible, LLViewerPartSim::getMaxPartCount());
+}
@@ -0,0 +1,70 @@
+/** 
+ * @file llframebudget.h
+ * @brief Scales draw distance and detail to hold a target frame rate.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFRAMEBUDGET_H
+#define LL_LLFRAMEBUDGET_H
+
+#include "llsingleton.h"
+
+// With RenderAdaptiveQuality on, watches the frame time and scales the
+// user's draw distance, object LOD factor, visible avatar count and
+// particle count down when frames run over RenderAdaptiveTargetFPS, and
+// back up when there is room again.
+//
+// Only the effective values are changed; the settings keep what the user
+// picked.  The lowered draw distance also goes out in AgentUpdate, so the
+// simulator sends less as well.
+class LLFrameBudget : public LLSingleton<LLFrameBudget>
+{
+	friend class LLSingleton<LLFrameBudget>;
+public:
+	// Once a frame, with the time the last frame took
+	void update(F32 frame_time);
+
+	// True when running below the user's settings
+	bool isReducing() const				{ return mLevel < 1.f; }
+
+	// Line for the render info debug display
+	std::string getDebugText() const;
+
+private:
+	LLFrameBudget();
+
+	// Sets the effective values for mLevel from the user's settings.
+	void apply();
+
+	// 1 is the user's settings, down to MIN_LEVEL
+	F32		mLevel;
+	bool	mActive;
+
+	// frame time gathered over the current window
+	F32		mWindowTime;
+	S32		mWindowFrames;
+	F32		mAverageFrameTime;
+	S32		mFastWindows;
+};
+
+#endif // LL_LLFRAMEBUDGET_H
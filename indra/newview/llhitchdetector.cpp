@@ -0,0 +1,203 @@
+/** 
+ * @file llhitchdetector.cpp
+ * @brief Records what the viewer was doing during unusually long frames
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llhitchdetector.h"
+
+#include "llagent.h"
+#include "llappviewer.h"
+#include "llfasttimer.h"
+#include "llfocusmgr.h"
+#include "llframetimer.h"
+#include "llimageworker.h"
+#include "llmeshrepository.h"
+#include "llsdserialize.h"
+#include "llstartup.h"
+#include "lltexturecache.h"
+#include "lltexturefetch.h"
+#include "llviewercontrol.h"
+#include "llviewerobjectlist.h"
+#include "message.h"
+#include "pipeline.h"
+
+// don't rewrite the file more often than this during a run of hitches
+const F32 HITCH_WRITE_PERIOD = 5.f;
+
+// timers under this are left out of reports
+const F64 HITCH_TIMER_MIN_MS = 1.0;
+
+F64 LLHitchDetector::sHitchSeconds = 0.0;
+bool LLHitchDetector::sWrote = false;
+bool LLHitchDetector::sDirty = false;
+std::deque<LLSD> LLHitchDetector::sReports;
+
+static void add_timers(LLSD& timers, LLFastTimer::NamedTimer& timer, S32 depth, F64 iclock_freq)
+{
+	F64 ms = timer.getHistoricalCount(0) * iclock_freq;
+	if (ms < HITCH_TIMER_MIN_MS)
+	{
+		return;
+	}
+
+	LLSD entry;
+	entry["name"] = timer.getName();
+	entry["depth"] = depth;
+	entry["ms"] = ms;
+	entry["calls"] = (LLSD::Integer)timer.getHistoricalCalls(0);
+	timers.append(entry);
+
+	std::vector<LLFastTimer::NamedTimer*>& children = timer.getChildren();
+	for (std::vector<LLFastTimer::NamedTimer*>::iterator iter = children.begin(); iter != children.end(); ++iter)
+	{
+		add_timers(timers, **iter, depth + 1, iclock_freq);
+	}
+}
+
+//static
+void LLHitchDetector::frameEnded(F64 frame_seconds)
+{
+	static LLCachedControl<F32> threshold_ms(gSavedSettings, "HitchThresholdMS");
+
+	bool wrote = sWrote;
+	sWrote = false;
+
+	if (threshold_ms <= 0.f
+		|| frame_seconds * 1000.0 < threshold_ms
+		|| wrote
+		|| LLStartUp::getStartupState() < STATE_STARTED
+		|| !gFocusMgr.getAppHasFocus())	// background frames sleep on purpose
+	{
+		return;
+	}
+
+	sHitchSeconds = frame_seconds;
+}
+
+//static
+void LLHitchDetector::frameStarted()
+{
+	if (sHitchSeconds > 0.0)
+	{
+		static LLCachedControl<U32> report_count(gSavedSettings, "HitchReportCount");
+
+		LLSD report = captureReport(sHitchSeconds);
+		sHitchSeconds = 0.0;
+
+		LL_INFOS("Hitch") << "Frame took " << report["frame_ms"].asInteger() << " ms, details in hitch_reports.xml" << LL_ENDL;
+
+		sReports.push_back(report);
+		while (sReports.size() > llmax((U32)report_count, 1U))
+		{
+			sReports.pop_front();
+		}
+		sDirty = true;
+	}
+
+	static LLFrameTimer write_timer;
+	if (sDirty && write_timer.getElapsedTimeF32() > HITCH_WRITE_PERIOD)
+	{
+		writeReports();
+		write_timer.reset();
+		sWrote = true;
+	}
+}
+
+//static
+void LLHitchDetector::cleanupClass()
+{
+	if (sDirty)
+	{
+		writeReports();
+	}
+	sReports.clear();
+}
+
+//static
+LLSD LLHitchDetector::captureReport(F64 frame_seconds)
+{
+	LLSD report;
+	report["date"] = LLDate::now();
+	report["frame"] = (LLSD::Integer)gFrameCount;
+	report["frame_ms"] = frame_seconds * 1000.0;
+	report["teleporting"] = gAgent.getTeleportState() != LLAgent::TELEPORT_NONE;
+
+	F64 iclock_freq = 1000.0 / LLFastTimer::countsPerSecond();
+	LLSD timers = LLSD::emptyArray();
+	add_timers(timers, LLFastTimer::NamedTimer::getRootNamedTimer(), 0, iclock_freq);
+	report["timers"] = timers;
+
+	LLSD& queues = report["queues"];
+	queues["texture_fetch"] = LLAppViewer::getTextureFetch()->getNumRequests();
+	queues["texture_decode"] = LLAppViewer::getImageDecodeThread()->getPending();
+	queues["texture_cache"] = LLAppViewer::getTextureCache()->getPending();
+	queues["mesh_lod_pending"] = (LLSD::Integer)LLMeshRepository::sLODPending;
+	queues["mesh_lod_processing"] = (LLSD::Integer)LLMeshRepository::sLODProcessing;
+	queues["mesh_http_requests"] = (LLSD::Integer)LLMeshRepository::sHTTPRequestCount;
+	queues["drawable_rebuild"] = gPipeline.getBuildQueueSize();
+	queues["group_rebuild"] = gPipeline.getGroupQueueSize();
+	queues["new_objects"] = gObjectList.mNumNewObjects;
+	queues["objects"] = gObjectList.getNumObjects();
+
+	LLSD messages = LLSD::emptyArray();
+	if (gMessageSystem)
+	{
+		LLMessageSystem::recent_message_list_t recent;
+		gMessageSystem->getRecentMessages(recent);
+		for (LLMessageSystem::recent_message_list_t::iterator iter = recent.begin(); iter != recent.end(); ++iter)
+		{
+			LLSD message;
+			message["name"] = iter->mName ? iter->mName : "";
+			message["ms"] = iter->mHandlerMS;
+			messages.append(message);
+		}
+	}
+	report["messages"] = messages;
+
+	return report;
+}
+
+//static
+void LLHitchDetector::writeReports()
+{
+	LLSD reports = LLSD::emptyArray();
+	for (std::deque<LLSD>::iterator iter = sReports.begin(); iter != sReports.end(); ++iter)
+	{
+		reports.append(*iter);
+	}
+
+	std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, "hitch_reports.xml");
+	llofstream out(filename);
+	if (out.is_open())
+	{
+		LLSDSerialize::toPrettyXML(reports, out);
+	}
+	else
+	{
+		LL_WARNS("Hitch") << "Unable to write " << filename << LL_ENDL;
+	}
+	sDirty = false;
+}
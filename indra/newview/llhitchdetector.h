@@ -0,0 +1,61 @@
+/** 
+ * @file llhitchdetector.h
+ * @brief Records what the viewer was doing during unusually long frames
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLHITCHDETECTOR_H
+#define LL_LLHITCHDETECTOR_H
+
+#include <deque>
+
+#include "llsd.h"
+
+// Watches main loop frame times and, when one runs over HitchThresholdMS,
+// records what the viewer was doing: the fast timer tree of that frame, the
+// texture, mesh and object queue depths, and the messages most recently
+// handled.  The last HitchReportCount reports are kept in hitch_reports.xml
+// in the log directory, so users can send us hitches we can't reproduce.
+class LLHitchDetector
+{
+public:
+	// at the end of a frame's work, before frame pacing
+	static void frameEnded(F64 frame_seconds);
+
+	// after LLFastTimer::nextFrame(), which makes the ended frame's timers
+	// readable as history
+	static void frameStarted();
+
+	static void cleanupClass();	// writes out any unsaved reports
+
+private:
+	static LLSD captureReport(F64 frame_seconds);
+	static void writeReports();
+
+	static F64				sHitchSeconds;	// frame to report at the next frameStarted(), 0 if none
+	static bool				sWrote;			// reports went out this frame, so don't blame it
+	static bool				sDirty;
+	static std::deque<LLSD>	sReports;
+};
+
+#endif // LL_LLHITCHDETECTOR_H
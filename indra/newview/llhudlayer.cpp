@@ -0,0 +1,217 @@
+/** 
+ * @file llhudlayer.cpp
+ * @brief Decides when the cached HUD layer needs redrawing, and measures each HUD.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llhudlayer.h"
+
+#include <boost/functional/hash.hpp>
+
+#include "llagentcamera.h"
+#include "lldrawable.h"
+#include "llface.h"
+#include "llviewerjointattachment.h"
+#include "llviewertexture.h"
+#include "llviewerwindow.h"
+#include "llvoavatarself.h"
+#include "llvovolume.h"
+
+// Redraw now and then even when nothing seems to have changed, in case
+// something slipped past the checks
+const F32 MAX_CACHE_AGE = 1.f;
+
+LLHUDLayer::LLHUDLayer()
+:	mHash(0),
+	mPendingHash(0),
+	mValid(false),
+	mCacheable(false),
+	mRedraws(0),
+	mReuses(0)
+{
+}
+
+bool LLHUDLayer::update()
+{
+	mStats.clear();
+
+	size_t hash = 0;
+	bool cacheable = true;
+
+	boost::hash_combine(hash, gAgentCamera.mHUDCurZoom);
+	boost::hash_combine(hash, gViewerWindow->getWorldViewWidthRaw());
+	boost::hash_combine(hash, gViewerWindow->getWorldViewHeightRaw());
+
+	if (isAgentAvatarValid())
+	{
+		for (LLVOAvatar::attachment_map_t::const_iterator iter = gAgentAvatarp->mAttachmentPoints.begin();
+			 iter != gAgentAvatarp->mAttachmentPoints.end(); ++iter)
+		{
+			LLViewerJointAttachment* attachment = iter->second;
+			if (!attachment->getIsHUDAttachment() || !attachment->getNumObjects())
+			{
+				continue;
+			}
+
+			HUDStats stats;
+			stats.mName = attachment->getName();
+			stats.mPrims = stats.mFaces = stats.mTriangles = 0;
+
+			for (LLViewerJointAttachment::attachedobjs_vec_t::const_iterator obj_iter = attachment->mAttachedObjects.begin();
+				 obj_iter != attachment->mAttachedObjects.end(); ++obj_iter)
+			{
+				if (*obj_iter)
+				{
+					addObject(*obj_iter, hash, cacheable, stats.mPrims, stats.mFaces, stats.mTriangles);
+				}
+			}
+
+			mStats.push_back(stats);
+		}
+	}
+
+	mPendingHash = hash;
+	mCacheable = cacheable;
+
+	bool stale = !cacheable || !mValid || hash != mHash ||
+				 mRefreshTimer.getElapsedTimeF32() > MAX_CACHE_AGE;
+	if (!stale)
+	{
+		mReuses++;
+	}
+	return stale;
+}
+
+void LLHUDLayer::addObject(LLViewerObject* objectp, size_t& hash, bool& cacheable, S32& prims, S32& faces, S32& tris) const
+{
+	prims++;
+
+	if (objectp->mText.notNull() || objectp->isParticleSource() || objectp->isSelected() || objectp->isFlexible())
+	{ //changes without us seeing it here
+		cacheable = false;
+	}
+
+	if (objectp->getPCode() == LL_PCODE_VOLUME)
+	{
+		LLVOVolume* volp = (LLVOVolume*) objectp;
+		if (volp->mTextureAnimp || volp->hasMedia())
+		{
+			cacheable = false;
+		}
+		// a different volume means the shape or its LOD changed
+		boost::hash_combine(hash, (size_t) volp->getVolume());
+	}
+
+	boost::hash_combine(hash, (size_t) objectp);
+
+	const LLVector3& pos = objectp->getPosition();
+	const LLQuaternion& rot = objectp->getRotation();
+	const LLVector3& scale = objectp->getScale();
+	for (U32 i = 0; i < 3; i++)
+	{
+		boost::hash_combine(hash, pos.mV[i]);
+		boost::hash_combine(hash, scale.mV[i]);
+	}
+	for (U32 i = 0; i < 4; i++)
+	{
+		boost::hash_combine(hash, rot.mQ[i]);
+	}
+
+	for (U8 te = 0; te < objectp->getNumTEs(); te++)
+	{
+		const LLTextureEntry* tep = objectp->getTE(te);
+		if (tep)
+		{
+			boost::hash_combine(hash, hash_value(tep->getID()));
+			const LLColor4& color = tep->getColor();
+			for (U32 i = 0; i < 4; i++)
+			{
+				boost::hash_combine(hash, color.mV[i]);
+			}
+			boost::hash_combine(hash, tep->mScaleS);
+			boost::hash_combine(hash, tep->mScaleT);
+			boost::hash_combine(hash, tep->mOffsetS);
+			boost::hash_combine(hash, tep->mOffsetT);
+			boost::hash_combine(hash, tep->getRotation());
+			boost::hash_combine(hash, tep->getGlow());
+			boost::hash_combine(hash, tep->getBumpShinyFullbright());
+			boost::hash_combine(hash, tep->getMediaTexGen());
+		}
+
+		// textures come in over several discard levels
+		LLViewerTexture* imagep = objectp->getTEImage(te);
+		if (imagep)
+		{
+			boost::hash_combine(hash, (size_t) imagep->getTexName());
+			boost::hash_combine(hash, imagep->getDiscardLevel());
+		}
+	}
+
+	LLDrawable* drawablep = objectp->mDrawable;
+	if (drawablep)
+	{
+		for (S32 i = 0; i < drawablep->getNumFaces(); i++)
+		{
+			LLFace* facep = drawablep->getFace(i);
+			if (facep)
+			{
+				faces++;
+				tris += facep->getIndicesCount() / 3;
+			}
+		}
+	}
+
+	LLViewerObject::const_child_list_t& child_list = objectp->getChildren();
+	for (LLViewerObject::child_list_t::const_iterator iter = child_list.begin();
+		 iter != child_list.end(); ++iter)
+	{
+		if (*iter)
+		{
+			addObject(*iter, hash, cacheable, prims, faces, tris);
+		}
+	}
+}
+
+void LLHUDLayer::markDrawn()
+{
+	mHash = mPendingHash;
+	mValid = mCacheable;
+	mRedraws++;
+	mRefreshTimer.reset();
+}
+
+void LLHUDLayer::getDebugText(std::vector<std::string>& lines) const
+{
+	for (std::vector<HUDStats>::const_iterator iter = mStats.begin(); iter != mStats.end(); ++iter)
+	{
+		lines.push_back(llformat("HUD %s: %d prims, %d faces, %d tris",
+								 iter->mName.c_str(), iter->mPrims, iter->mFaces, iter->mTriangles));
+	}
+	if (!mStats.empty())
+	{
+		lines.push_back(llformat("HUD layer: %s, %d redraws, %d reuses",
+								 mCacheable ? "cached" : "drawn every frame", mRedraws, mReuses));
+	}
+}
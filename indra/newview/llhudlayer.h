@@ -0,0 +1,88 @@
+/** 
+ * @file llhudlayer.h
+ * @brief Decides when the cached HUD layer needs redrawing, and measures each HUD.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLHUDLAYER_H
+#define LL_LLHUDLAYER_H
+
+#include "llsingleton.h"
+#include "llframetimer.h"
+
+class LLViewerObject;
+
+// With RenderHUDBuffer on, HUD attachments are drawn into
+// LLPipeline::mHUDScreen and that image is composited every frame.  The
+// HUD is only drawn again when something about it changed: a prim moved,
+// a texture entry or volume changed, a texture finished loading, the HUD
+// zoom or world view size changed.  HUDs with hover text, particles,
+// media, flexi prims, texture animation or a selection are drawn every
+// frame, since those change on their own.
+//
+// The same walk over the HUD objects counts prims, faces and triangles
+// per attachment point for the render info debug display.
+class LLHUDLayer : public LLSingleton<LLHUDLayer>
+{
+	friend class LLSingleton<LLHUDLayer>;
+public:
+	// Once a frame before the HUD pass.  Returns true when the cached
+	// layer is stale (or can't be used) and the HUD has to be drawn.
+	bool update();
+
+	// The cached layer holds what update() just looked at
+	void markDrawn();
+
+	// False when some HUD changes on its own and has to be drawn directly
+	bool isCacheable() const			{ return mCacheable; }
+
+	// Forget the cached layer, e.g. after the target was reallocated
+	void invalidate()					{ mValid = false; }
+
+	// Lines for the render info debug display, one per HUD
+	void getDebugText(std::vector<std::string>& lines) const;
+
+private:
+	LLHUDLayer();
+
+	void addObject(LLViewerObject* objectp, size_t& hash, bool& cacheable, S32& prims, S32& faces, S32& tris) const;
+
+	struct HUDStats
+	{
+		std::string	mName;
+		S32			mPrims;
+		S32			mFaces;
+		S32			mTriangles;
+	};
+	std::vector<HUDStats>	mStats;
+
+	size_t		mHash;			// of the state the cached layer was drawn from
+	size_t		mPendingHash;	// of the state update() last saw
+	bool		mValid;
+	bool		mCacheable;
+	S32			mRedraws;		// counted for the debug display
+	S32			mReuses;
+	LLFrameTimer mRefreshTimer;
+};
+
+#endif // LL_LLHUDLAYER_H
@@ -105,7 +105,8 @@ LLHUDNameTag::LLHUDNameTag(const U8 type)
 	mTextAlignment(ALIGN_TEXT_CENTER),
 	mVertAlignment(ALIGN_VERT_CENTER),
 	mLOD(0),
-	mHidden(FALSE)
+	mHidden(FALSE),
+	mSizeDirty(TRUE)
 {
 	LLPointer<LLHUDNameTag> ptr(this);
 	sTextObjects.insert(ptr);
@@ -292,12 +293,13 @@ void LLHUDNameTag::renderText(BOOL for_select)
 
 	mOffsetY = lltrunc(mHeight * ((mVertAlignment == ALIGN_VERT_CENTER) ? 0.5f : 1.f));
 
-	// *TODO: cache this image
-	LLUIImagePtr imagep = LLUI::getUIImage("Rounded_Rect");
+	static LLUIImagePtr imagep = LLUI::getUIImage("Rounded_Rect");
 
 	// *TODO: make this a per-text setting
-	LLColor4 bg_color = LLUIColorTable::instance().getColor("NameTagBackground");
-	bg_color.setAlpha(gSavedSettings.getF32("ChatBubbleOpacity") * alpha_factor);
+	static LLUIColor name_tag_background = LLUIColorTable::instance().getColor("NameTagBackground");
+	static LLCachedControl<F32> chat_bubble_opacity(gSavedSettings, "ChatBubbleOpacity");
+	LLColor4 bg_color = name_tag_background.get();
+	bg_color.setAlpha(chat_bubble_opacity * alpha_factor);
 
 	// maybe a no-op?
 	//const S32 border_height = 16;
@@ -382,7 +384,7 @@ void LLHUDNameTag::renderText(BOOL for_select)
 				{
 					LLUI::pushMatrix();
 					{
-						gGL.color4f(text_color.mV[VX], text_color.mV[VY], text_color.mV[VZ], gSavedSettings.getF32("ChatBubbleOpacity") * alpha_factor);
+						gGL.color4f(text_color.mV[VX], text_color.mV[VY], text_color.mV[VZ], chat_bubble_opacity * alpha_factor);
 						LLVector3 label_height = (mFontp->getLineHeight() * mLabelSegments.size() + (VERTICAL_PADDING / 3.f)) * y_pixel_vec;
 						LLVector3 label_offset = height_vec - label_height;
 						LLUI::translate(label_offset.mV[VX], label_offset.mV[VY], label_offset.mV[VZ]);
@@ -474,7 +476,12 @@ void LLHUDNameTag::renderText(BOOL for_select)
 	}
 
 	F32 y_offset = (F32)mOffsetY;
-		
+
+	// label and text lines are gathered and drawn together
+	static std::vector<LLHUDTextLine> lines;
+	lines.clear();
+	LLHUDTextLine line;
+
 	// Render label
 	{
 		//gGL.getTexUnit(0)->setTextureBlendType(LLTexUnit::TB_MULT);
@@ -498,7 +505,15 @@ void LLHUDNameTag::renderText(BOOL for_select)
 
 			LLColor4 label_color(0.f, 0.f, 0.f, 1.f);
 			label_color.mV[VALPHA] = alpha_factor;
-			hud_render_text(segment_iter->getText(), render_position, *fontp, segment_iter->mStyle, LLFontGL::NO_SHADOW, x_offset, y_offset, label_color, FALSE);
+
+			line.mText = &segment_iter->getText();
+			line.mFont = fontp;
+			line.mStyle = segment_iter->mStyle;
+			line.mShadow = LLFontGL::NO_SHADOW;
+			line.mXOffset = x_offset;
+			line.mYOffset = y_offset;
+			line.mColor = label_color;
+			lines.push_back(line);
 		}
 	}
 
@@ -543,9 +558,19 @@ void LLHUDNameTag::renderText(BOOL for_select)
 			text_color = segment_iter->mColor;
 			text_color.mV[VALPHA] *= alpha_factor;
 
-			hud_render_text(segment_iter->getText(), render_position, *fontp, style, shadow, x_offset, y_offset, text_color, FALSE);
+			line.mText = &segment_iter->getText();
+			line.mFont = fontp;
+			line.mStyle = style;
+			line.mShadow = shadow;
+			line.mXOffset = x_offset;
+			line.mYOffset = y_offset;
+			line.mColor = text_color;
+			lines.push_back(line);
 		}
 	}
+
+	hud_render_text_lines(lines, render_position, FALSE);
+	lines.clear();
 	/// Reset the default color to white.  The renderer expects this to be the default. 
 	gGL.color4f(1.0f, 1.0f, 1.0f, 1.0f);
 	if (for_select)
@@ -557,12 +582,14 @@ void LLHUDNameTag::renderText(BOOL for_select)
 void LLHUDNameTag::setString(const std::string &text_utf8)
 {
 	mTextSegments.clear();
+	mSizeDirty = TRUE;
 	addLine(text_utf8, mColor);
 }
 
 void LLHUDNameTag::clearString()
 {
 	mTextSegments.clear();
+	mSizeDirty = TRUE;
 }
 
 
@@ -595,6 +622,7 @@ void LLHUDNameTag::addLine(const std::string &text_utf8,
 				S32 segment_length = font->maxDrawableChars(iter->substr(line_length).c_str(), max_pixels, wline.length(), LLFontGL::WORD_BOUNDARY_IF_POSSIBLE);
 				LLHUDTextSegment segment(iter->substr(line_length, segment_length), style, color, font);
 				mTextSegments.push_back(segment);
+				mSizeDirty = TRUE;
 				line_length += segment_length;
 			}
 			while (line_length != iter->size());
@@ -606,6 +634,7 @@ void LLHUDNameTag::addLine(const std::string &text_utf8,
 void LLHUDNameTag::setLabel(const std::string &label_utf8)
 {
 	mLabelSegments.clear();
+	mSizeDirty = TRUE;
 	addLabel(label_utf8);
 }
 
@@ -632,6 +661,7 @@ void LLHUDNameTag::addLabel(const std::string& label_utf8)
 					HUD_TEXT_MAX_WIDTH, wstr.length(), LLFontGL::WORD_BOUNDARY_IF_POSSIBLE);
 				LLHUDTextSegment segment(iter->substr(line_length, segment_length), LLFontGL::NORMAL, mColor, mFontp);
 				mLabelSegments.push_back(segment);
+				mSizeDirty = TRUE;
 				line_length += segment_length;
 			}
 			while (line_length != iter->size());
@@ -648,6 +678,7 @@ void LLHUDNameTag::setZCompare(const BOOL zcompare)
 void LLHUDNameTag::setFont(const LLFontGL* font)
 {
 	mFontp = font;
+	mSizeDirty = TRUE;
 }
 
 
@@ -799,6 +830,13 @@ LLVector2 LLHUDNameTag::updateScreenPos(LLVector2 &offset)
 
 void LLHUDNameTag::updateSize()
 {
+	// layout only changes with the text, fonts or LOD
+	if (!mSizeDirty)
+	{
+		return;
+	}
+	mSizeDirty = FALSE;
+
 	F32 height = 0.f;
 	F32 width = 0.f;
 
@@ -986,7 +1024,11 @@ void LLHUDNameTag::updateAll()
 
 void LLHUDNameTag::setLOD(S32 lod)
 {
-	mLOD = lod;
+	if (lod != mLOD)
+	{
+		mLOD = lod;
+		mSizeDirty = TRUE;
+	}
 	//RN: uncomment this to visualize LOD levels
 	//std::string label = llformat("%d", lod);
 	//setLabel(label);
@@ -1059,6 +1101,7 @@ void LLHUDNameTag::reshape()
 		{
 			segment_iter->clearFontWidthMap();
 		}
+		textp->mSizeDirty = TRUE;
 		for(segment_iter = textp->mLabelSegments.begin();
 			segment_iter != textp->mLabelSegments.end(); ++segment_iter )
 		{
@@ -107,7 +107,7 @@ public:
 	void setVisibleOffScreen(BOOL visible) { mVisibleOffScreen = visible; }
 	
 	// mMaxLines of -1 means unlimited lines.
-	void setMaxLines(S32 max_lines) { mMaxLines = max_lines; }
+	void setMaxLines(S32 max_lines) { mMaxLines = max_lines; mSizeDirty = TRUE; }
 	void setFadeDistance(F32 fade_distance, F32 fade_range) { mFadeDistance = fade_distance; mFadeRange = fade_range; }
 	void updateVisibility();
 	LLVector2 updateScreenPos(LLVector2 &offset_target);
@@ -173,6 +173,8 @@ private:
 	EVertAlignment	mVertAlignment;
 	S32				mLOD;
 	BOOL			mHidden;
+	// set when mWidth / mHeight need to be recomputed in updateSize()
+	BOOL			mSizeDirty;
 
 	static BOOL    sDisplayText ;
 	static std::set<LLPointer<LLHUDNameTag> > sTextObjects;
@@ -50,23 +50,14 @@ void hud_render_utf8text(const std::string &str, const LLVector3 &pos_agent,
 	hud_render_text(wstr, pos_agent, font, style, shadow, x_offset, y_offset, color, orthographic);
 }
 
-void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
-					const LLFontGL &font,
-					const U8 style,
-					const LLFontGL::ShadowType shadow,
-					const F32 x_offset, const F32 y_offset,
-					const LLColor4& color,
-					const BOOL orthographic)
+// Projects the text origin to window coordinates
+static void hud_project_text(const LLVector3 &pos_agent,
+							 const F32 x_offset, const F32 y_offset,
+							 const BOOL orthographic,
+							 const F64* mdlv, const F64* proj, const S32* viewport,
+							 F64& winX, F64& winY, F64& winZ)
 {
 	LLViewerCamera* camera = LLViewerCamera::getInstance();
-	// Do cheap plane culling
-	LLVector3 dir_vec = pos_agent - camera->getOrigin();
-	dir_vec /= dir_vec.magVec();
-
-	if (wstr.empty() || (!orthographic && dir_vec * camera->getAtAxis() <= 0.f))
-	{
-		return;
-	}
 
 	LLVector3 right_axis;
 	LLVector3 up_axis;
@@ -79,48 +70,42 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
 	{
 		camera->getPixelVectors(pos_agent, up_axis, right_axis);
 	}
-	LLCoordFrame render_frame = *camera;
-	LLQuaternion rot;
-	if (!orthographic)
-	{
-		rot = render_frame.getQuaternion();
-		rot = rot * LLQuaternion(-F_PI_BY_TWO, camera->getYAxis());
-		rot = rot * LLQuaternion(F_PI_BY_TWO, camera->getXAxis());
-	}
-	else
-	{
-		rot = LLQuaternion(-F_PI_BY_TWO, LLVector3(0.f, 0.f, 1.f));
-		rot = rot * LLQuaternion(-F_PI_BY_TWO, LLVector3(0.f, 1.f, 0.f));
-	}
-	F32 angle;
-	LLVector3 axis;
-	rot.getAngleAxis(&angle, axis);
 
 	LLVector3 render_pos = pos_agent + (floorf(x_offset) * right_axis) + (floorf(y_offset) * up_axis);
 
 	//get the render_pos in screen space
-	
-	F64 winX, winY, winZ;
-	LLRect world_view_rect = gViewerWindow->getWorldViewRectRaw();
-	S32	viewport[4];
+	gluProject(render_pos.mV[0], render_pos.mV[1], render_pos.mV[2],
+				mdlv, proj, (GLint*) viewport,
+				&winX, &winY, &winZ);
+}
+
+static BOOL hud_text_visible(const LLVector3 &pos_agent, const BOOL orthographic)
+{
+	LLViewerCamera* camera = LLViewerCamera::getInstance();
+	// Do cheap plane culling
+	LLVector3 dir_vec = pos_agent - camera->getOrigin();
+	dir_vec /= dir_vec.magVec();
+
+	return orthographic || dir_vec * camera->getAtAxis() > 0.f;
+}
+
+static void hud_get_view(LLRect& world_view_rect, S32* viewport, F64* mdlv, F64* proj)
+{
+	world_view_rect = gViewerWindow->getWorldViewRectRaw();
 	viewport[0] = world_view_rect.mLeft;
 	viewport[1] = world_view_rect.mBottom;
 	viewport[2] = world_view_rect.getWidth();
 	viewport[3] = world_view_rect.getHeight();
 
-	F64 mdlv[16];
-	F64 proj[16];
-
 	for (U32 i = 0; i < 16; i++)
 	{
 		mdlv[i] = (F64) gGLModelView[i];
 		proj[i] = (F64) gGLProjection[i];
 	}
+}
 
-	gluProject(render_pos.mV[0], render_pos.mV[1], render_pos.mV[2],
-				mdlv, proj, (GLint*) viewport,
-				&winX, &winY, &winZ);
-		
+static void hud_begin_text(const LLRect& world_view_rect)
+{
 	//fonts all render orthographically, set up projection``
 	gGL.matrixMode(LLRender::MM_PROJECTION);
 	gGL.pushMatrix();
@@ -130,7 +115,13 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
 		
 	gl_state_for_2d(world_view_rect.getWidth(), world_view_rect.getHeight());
 	gViewerWindow->setup3DViewport();
-	
+}
+
+static void hud_draw_text(const LLWString &wstr, const LLFontGL &font,
+						  const U8 style, const LLFontGL::ShadowType shadow,
+						  const LLColor4& color, const LLRect& world_view_rect,
+						  F64 winX, F64 winY, F64 winZ)
+{
 	winX -= world_view_rect.mLeft;
 	winY -= world_view_rect.mBottom;
 	LLUI::loadIdentity();
@@ -139,7 +130,10 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
 	F32 right_x;
 	
 	font.render(wstr, 0, 0, 1, color, LLFontGL::LEFT, LLFontGL::BASELINE, style, shadow, wstr.length(), 1000, &right_x);
+}
 
+static void hud_end_text()
+{
 	LLUI::popMatrix();
 	gGL.popMatrix();
 
@@ -147,3 +141,62 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
 	gGL.popMatrix();
 	gGL.matrixMode(LLRender::MM_MODELVIEW);
 }
+
+void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
+					const LLFontGL &font,
+					const U8 style,
+					const LLFontGL::ShadowType shadow,
+					const F32 x_offset, const F32 y_offset,
+					const LLColor4& color,
+					const BOOL orthographic)
+{
+	if (wstr.empty() || !hud_text_visible(pos_agent, orthographic))
+	{
+		return;
+	}
+
+	LLRect world_view_rect;
+	S32	viewport[4];
+	F64 mdlv[16];
+	F64 proj[16];
+	hud_get_view(world_view_rect, viewport, mdlv, proj);
+
+	F64 winX, winY, winZ;
+	hud_project_text(pos_agent, x_offset, y_offset, orthographic, mdlv, proj, viewport, winX, winY, winZ);
+
+	hud_begin_text(world_view_rect);
+	hud_draw_text(wstr, font, style, shadow, color, world_view_rect, winX, winY, winZ);
+	hud_end_text();
+}
+
+void hud_render_text_lines(const std::vector<LLHUDTextLine>& lines,
+						   const LLVector3 &pos_agent,
+						   const BOOL orthographic)
+{
+	if (lines.empty() || !hud_text_visible(pos_agent, orthographic))
+	{
+		return;
+	}
+
+	LLRect world_view_rect;
+	S32	viewport[4];
+	F64 mdlv[16];
+	F64 proj[16];
+	hud_get_view(world_view_rect, viewport, mdlv, proj);
+
+	// one 2D state change for all lines, the glyph quads stay in one batch
+	hud_begin_text(world_view_rect);
+	for (std::vector<LLHUDTextLine>::const_iterator iter = lines.begin();
+		 iter != lines.end(); ++iter)
+	{
+		if (iter->mText->empty())
+		{
+			continue;
+		}
+
+		F64 winX, winY, winZ;
+		hud_project_text(pos_agent, iter->mXOffset, iter->mYOffset, orthographic, mdlv, proj, viewport, winX, winY, winZ);
+		hud_draw_text(*iter->mText, *iter->mFont, iter->mStyle, iter->mShadow, iter->mColor, world_view_rect, winX, winY, winZ);
+	}
+	hud_end_text();
+}
@@ -27,7 +27,10 @@
 #ifndef LL_LLHUDRENDER_H
 #define LL_LLHUDRENDER_H
 
+#include <vector>
+
 #include "llfontgl.h"
+#include "v4color.h"
 
 class LLVector3;
 class LLFontGL;
@@ -43,6 +46,24 @@ void hud_render_text(const LLWString &wstr,
 					 const LLColor4& color,
 					 const BOOL orthographic);
 
+// One line of text for hud_render_text_lines(), offsets are in pixels
+struct LLHUDTextLine
+{
+	const LLWString*		mText;
+	const LLFontGL*			mFont;
+	U8						mStyle;
+	LLFontGL::ShadowType	mShadow;
+	F32						mXOffset;
+	F32						mYOffset;
+	LLColor4				mColor;
+};
+
+// Draws lines anchored at the same agent position inside a single 2D
+// state setup, cheaper than a hud_render_text() call per line
+void hud_render_text_lines(const std::vector<LLHUDTextLine>& lines,
+						   const LLVector3 &pos_agent,
+						   const BOOL orthographic);
+
 // Legacy, slower
 void hud_render_utf8text(const std::string &str,
 						 const LLVector3 &pos_agent,
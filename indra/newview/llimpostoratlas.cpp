@@ -0,0 +1,287 @@
+/**
+ * @file llimpostoratlas.cpp
+ * @brief Shared render target that avatar impostors are packed into.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llimpostoratlas.h"
+
+#include "llframetimer.h"
+#include "llvoavatar.h"
+
+LLImpostorAtlas::LLImpostorAtlas()
+{
+	mNodes.resize(levelOffset(NUM_LEVELS));
+	reset();
+}
+
+LLImpostorAtlas::~LLImpostorAtlas()
+{
+	//owners are gone by now, mTarget releases itself
+}
+
+bool LLImpostorAtlas::allocate()
+{
+	reset();
+
+	if (!mTarget.allocate(ATLAS_SIZE, ATLAS_SIZE, GL_RGBA, TRUE, FALSE))
+	{
+		return false;
+	}
+
+	gGL.getTexUnit(0)->bind(&mTarget);
+	gGL.getTexUnit(0)->setTextureFilteringOption(LLTexUnit::TFO_POINT);
+	gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+
+	return true;
+}
+
+void LLImpostorAtlas::release()
+{
+	reset();
+	mTarget.release();
+}
+
+void LLImpostorAtlas::reset()
+{
+	//every impostor in the atlas has to be regenerated somewhere else
+	for (U32 i = 0; i < mNodes.size(); ++i)
+	{
+		if (mNodes[i].mState == NODE_USED && mNodes[i].mOwner)
+		{
+			mNodes[i].mOwner->mImpostorSlot = -1;
+			mNodes[i].mOwner->mNeedsImpostorUpdate = TRUE;
+		}
+		mNodes[i] = Node();
+	}
+
+	mNodes[0].mState = NODE_FREE;
+}
+
+//static
+U32 LLImpostorAtlas::levelOffset(U32 level)
+{
+	//number of nodes in all levels above level, (4^level - 1) / 3
+	return ((1 << (level*2)) - 1) / 3;
+}
+
+//static
+U32 LLImpostorAtlas::levelForSize(U32 size)
+{
+	U32 level = 0;
+	U32 slot_size = ATLAS_SIZE;
+	while (level < NUM_LEVELS-1 && slot_size/2 >= size)
+	{
+		slot_size /= 2;
+		level++;
+	}
+	return level;
+}
+
+//static
+U32 LLImpostorAtlas::nodeLevel(U32 node)
+{
+	U32 level = 0;
+	while (level < NUM_LEVELS-1 && node >= levelOffset(level+1))
+	{
+		level++;
+	}
+	return level;
+}
+
+S32 LLImpostorAtlas::allocateSlot(LLVOAvatar* avatar, U32 width, U32 height)
+{
+	U32 level = levelForSize(llmax(width, height));
+
+	S32 current = avatar->mImpostorSlot;
+	if (current >= 0 && (U32) current < mNodes.size() &&
+		mNodes[current].mOwner == avatar && nodeLevel(current) == level)
+	{
+		touchSlot(current);
+		return current;
+	}
+
+	if (current >= 0)
+	{
+		freeSlot(current);
+	}
+
+	S32 node = findFreeNode(level);
+	while (node < 0)
+	{ //make room by dropping the impostor that has gone longest without being drawn
+		S32 victim = -1;
+		for (U32 i = 0; i < mNodes.size(); ++i)
+		{
+			if (mNodes[i].mState == NODE_USED &&
+				(victim < 0 || mNodes[i].mLastUsed < mNodes[victim].mLastUsed))
+			{
+				victim = i;
+			}
+		}
+
+		if (victim < 0)
+		{
+			return -1;
+		}
+
+		evict(victim);
+		node = findFreeNode(level);
+	}
+
+	mNodes[node].mState = NODE_USED;
+	mNodes[node].mOwner = avatar;
+	mNodes[node].mLastUsed = LLFrameTimer::getFrameCount();
+	avatar->mImpostorSlot = node;
+
+	return node;
+}
+
+void LLImpostorAtlas::freeSlot(S32 slot)
+{
+	if (slot < 0 || (U32) slot >= mNodes.size() || mNodes[slot].mState != NODE_USED)
+	{
+		return;
+	}
+
+	if (mNodes[slot].mOwner && mNodes[slot].mOwner->mImpostorSlot == slot)
+	{
+		mNodes[slot].mOwner->mImpostorSlot = -1;
+	}
+
+	freeNode(slot);
+}
+
+void LLImpostorAtlas::touchSlot(S32 slot)
+{
+	if (slot >= 0 && (U32) slot < mNodes.size())
+	{
+		mNodes[slot].mLastUsed = LLFrameTimer::getFrameCount();
+	}
+}
+
+void LLImpostorAtlas::getSlotRect(S32 slot, U32& x, U32& y, U32& size) const
+{
+	U32 level = nodeLevel(slot);
+	U32 dim = 1 << level;
+	U32 local = slot - levelOffset(level);
+
+	size = ATLAS_SIZE >> level;
+	x = (local % dim) * size;
+	y = (local / dim) * size;
+}
+
+S32 LLImpostorAtlas::findFreeNode(U32 level)
+{
+	U32 first = levelOffset(level);
+	U32 last = levelOffset(level+1);
+	for (U32 i = first; i < last; ++i)
+	{
+		if (mNodes[i].mState == NODE_FREE)
+		{
+			return i;
+		}
+	}
+
+	if (level == 0)
+	{
+		return -1;
+	}
+
+	//split a free slot one size up into four
+	S32 parent = findFreeNode(level-1);
+	if (parent < 0)
+	{
+		return -1;
+	}
+
+	U32 parent_dim = 1 << (level-1);
+	U32 parent_local = parent - levelOffset(level-1);
+	U32 px = parent_local % parent_dim;
+	U32 py = parent_local / parent_dim;
+	U32 dim = parent_dim * 2;
+
+	mNodes[parent].mState = NODE_SPLIT;
+	for (U32 j = 0; j < 2; ++j)
+	{
+		for (U32 i = 0; i < 2; ++i)
+		{
+			mNodes[first + (py*2+j)*dim + px*2+i].mState = NODE_FREE;
+		}
+	}
+
+	return first + (py*2)*dim + px*2;
+}
+
+void LLImpostorAtlas::freeNode(U32 node)
+{
+	mNodes[node].mState = NODE_FREE;
+	mNodes[node].mOwner = NULL;
+
+	U32 level = nodeLevel(node);
+	if (level == 0)
+	{
+		return;
+	}
+
+	//merge back into the parent once all four siblings are free
+	U32 dim = 1 << level;
+	U32 local = node - levelOffset(level);
+	U32 px = (local % dim) / 2;
+	U32 py = (local / dim) / 2;
+	U32 first = levelOffset(level);
+
+	for (U32 j = 0; j < 2; ++j)
+	{
+		for (U32 i = 0; i < 2; ++i)
+		{
+			if (mNodes[first + (py*2+j)*dim + px*2+i].mState != NODE_FREE)
+			{
+				return;
+			}
+		}
+	}
+
+	for (U32 j = 0; j < 2; ++j)
+	{
+		for (U32 i = 0; i < 2; ++i)
+		{
+			mNodes[first + (py*2+j)*dim + px*2+i].mState = NODE_NONE;
+		}
+	}
+
+	freeNode(levelOffset(level-1) + py*(dim/2) + px);
+}
+
+void LLImpostorAtlas::evict(U32 node)
+{
+	LLVOAvatar* owner = mNodes[node].mOwner;
+	if (owner && owner->mImpostorSlot == (S32) node)
+	{
+		owner->mImpostorSlot = -1;
+		owner->mNeedsImpostorUpdate = TRUE;
+	}
+
+	freeNode(node);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file llimpostoratlas.h
+ * @brief Shared render target that avatar impostors are packed into.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMPOSTORATLAS_H
+#define LL_LLIMPOSTORATLAS_H
+
+#include <vector>
+
+#include "llrendertarget.h"
+
+class LLVOAvatar;
+
+//============================================================================
+// The atlas is a quadtree of square slots, from the whole target down to
+// MIN_SLOT_SIZE. Each impostor takes the smallest slot its resolution fits
+// in; when nothing is free the least recently drawn impostor is evicted and
+// flagged to regenerate.
+
+class LLImpostorAtlas
+{
+public:
+	enum
+	{
+		ATLAS_SIZE = 2048,
+		MIN_SLOT_SIZE = 32,
+		NUM_LEVELS = 7 // 2048 down to 32
+	};
+
+	LLImpostorAtlas();
+	~LLImpostorAtlas();
+
+	// Deferred attachments are added by the caller
+	bool allocate();
+	void release();
+	bool isComplete() const		{ return mTarget.isComplete(); }
+
+	// Returns a slot of at least width x height for avatar, reusing its
+	// current slot when that is the right size, or -1 if none can be made.
+	S32 allocateSlot(LLVOAvatar* avatar, U32 width, U32 height);
+	void freeSlot(S32 slot);
+
+	// Marks slot as drawn this frame for LRU eviction
+	void touchSlot(S32 slot);
+
+	// Pixel origin and edge length of slot within the atlas
+	void getSlotRect(S32 slot, U32& x, U32& y, U32& size) const;
+
+	LLRenderTarget mTarget;
+
+private:
+	enum
+	{
+		NODE_NONE = 0,	// covered by an unsplit ancestor
+		NODE_FREE,
+		NODE_SPLIT,
+		NODE_USED
+	};
+
+	struct Node
+	{
+		Node() : mState(NODE_NONE), mOwner(NULL), mLastUsed(0) {}
+
+		U8 mState;
+		LLVOAvatar* mOwner;
+		U32 mLastUsed;
+	};
+
+	static U32 levelOffset(U32 level);
+	static U32 levelForSize(U32 size);
+	static U32 nodeLevel(U32 node);
+
+	S32 findFreeNode(U32 level);
+	void freeNode(U32 node);
+	void evict(U32 node);
+	void reset();
+
+	std::vector<Node> mNodes;
+};
+
+#endif // LL_LLIMPOSTORATLAS_H
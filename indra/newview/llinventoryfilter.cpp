@@ -44,6 +44,10 @@
 
 LLFastTimer::DeclareTimer FT_FILTER_CLIPBOARD("Filter Clipboard");
 
+// Items the search index turns away cost a fraction of a full check, this
+// many of them count as one against the per frame filter budget.
+const S32 INDEXED_REJECTS_PER_CHECK = 8;
+
 LLInventoryFilter::FilterOps::FilterOps() :
 	mFilterObjectTypes(0xffffffffffffffffULL),
 	mFilterCategoryTypes(0xffffffffffffffffULL),
@@ -76,6 +80,8 @@ LLInventoryFilter::LLInventoryFilter(const std::string& name)
 	mMustPassGeneration = S32_MAX;
 	mMinRequiredGeneration = 0;
 	mFilterCount = 0;
+	mIndexedReject = false;
+	mIndexedRejectCount = 0;
 	mNextFilterGeneration = mFilterGeneration + 1;
 
 	mLastLogoff = gSavedPerAccountSettings.getU32("LastLogoff");
@@ -91,6 +97,8 @@ LLInventoryFilter::~LLInventoryFilter()
 
 BOOL LLInventoryFilter::check(const LLFolderViewItem* item) 
 {
+	mIndexedReject = false;
+
 	// Clipboard cut items are *always* filtered so we need this value upfront
 	const LLFolderViewEventListener* listener = item->getListener();
 	const BOOL passed_clipboard = (listener ? checkAgainstClipboard(listener->getUUID()) : TRUE);
@@ -102,7 +110,18 @@ BOOL LLInventoryFilter::check(const LLFolderViewItem* item)
 		return passed_clipboard;
 	}
 
-	mSubStringMatchOffset = mFilterSubString.size() ? item->getSearchableLabel().find(mFilterSubString) : std::string::npos;
+	bool indexed = false;
+	mSubStringMatchOffset = mFilterSubString.size() ? item->findInSearchableLabel(mFilterSubString, indexed) : std::string::npos;
+
+	// Failing the name test fails the item, so don't pay for the type and
+	// permission checks.  The exception is the empty folders check, it
+	// fetches hidden system folders as a side effect.
+	if (mFilterSubString.size() && mSubStringMatchOffset == std::string::npos
+		&& !(mFilterOps.mFilterTypes & FILTERTYPE_EMPTYFOLDERS))
+	{
+		mIndexedReject = indexed;
+		return FALSE;
+	}
 
 	const BOOL passed_filtertype = checkAgainstFilterType(item);
 	const BOOL passed_permissions = checkAgainstPermissions(item);
@@ -1108,6 +1127,15 @@ S32 LLInventoryFilter::getFilterCount() const
 
 void LLInventoryFilter::decrementFilterCount() 
 { 
+	if (mIndexedReject)
+	{
+		mIndexedReject = false;
+		if (++mIndexedRejectCount < INDEXED_REJECTS_PER_CHECK)
+		{
+			return;
+		}
+		mIndexedRejectCount = 0;
+	}
 	mFilterCount--; 
 }
 
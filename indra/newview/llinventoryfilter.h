@@ -219,6 +219,8 @@ private:
 	S32						mNextFilterGeneration;
 
 	S32						mFilterCount;
+	bool					mIndexedReject;		// last check() was failed by the search index
+	S32						mIndexedRejectCount;
 	EFilterBehavior 		mFilterBehavior;
 
 	BOOL 					mModified;
@@ -46,6 +46,8 @@
 #include "llappviewer.h"
 #include "llviewerregion.h"
 #include "llcallbacklist.h"
+#include "llflathashmap.h"
+#include "llsdserialize.h"
 #include "llvoavatarself.h"
 #include "llgesturemgr.h"
 #include <typeinfo>
@@ -61,7 +63,8 @@
 
 // Increment this if the inventory contents change in a non-backwards-compatible way.
 // For viewer 2, the addition of link items makes a pre-viewer-2 cache incorrect.
-const S32 LLInventoryModel::sCurrentInvCacheVersion = 2;
+// Version 3 is the binary cache.
+const S32 LLInventoryModel::sCurrentInvCacheVersion = 3;
 BOOL LLInventoryModel::sFirstTimeInViewer2 = TRUE;
 
 ///----------------------------------------------------------------------------
@@ -69,7 +72,39 @@ BOOL LLInventoryModel::sFirstTimeInViewer2 = TRUE;
 ///----------------------------------------------------------------------------
 
 //BOOL decompress_file(const char* src_filename, const char* dst_filename);
-const char CACHE_FORMAT_STRING[] = "%s.inv"; 
+const char CACHE_FORMAT_STRING[] = "%s.inv.bin"; 
+// text cache written by older viewers, gzipped
+const char LEGACY_CACHE_FORMAT_STRING[] = "%s.inv.gz"; 
+
+// Layout of the inventory cache file, in native byte order since it never
+// leaves this machine:
+//   LLInvCacheHeader
+//   LLInvCacheEntry * mCategoryCount
+//   data: category names and binary LLSD item arrays, at the offsets
+//         (from the start of the data) given in each entry
+const U32 INV_CACHE_MAGIC = 0x43564e49; // "INVC"
+
+struct LLInvCacheHeader
+{
+	U32 mMagic;
+	S32 mCacheVersion;
+	U32 mCategoryCount;
+	U32 mDataSize;
+};
+
+struct LLInvCacheEntry
+{
+	U8 mID[UUID_BYTES];
+	U8 mParentID[UUID_BYTES];
+	U8 mOwnerID[UUID_BYTES];
+	S32 mVersion;
+	S8 mType;
+	S8 mPreferredType;
+	U16 mNameLength;
+	U32 mNameOffset;
+	U32 mItemsOffset;
+	U32 mItemsLength;
+};
 
 struct InventoryIDPtrLess
 {
@@ -151,6 +186,7 @@ LLInventoryModel::LLInventoryModel()
 	mLibraryRootFolderID(),
 	mLibraryOwnerID(),
 	mIsNotifyObservers(FALSE),
+	mChangeSetIncomplete(true),
 	mIsAgentInvUsable(false)
 {
 }
@@ -814,6 +850,7 @@ U32 LLInventoryModel::updateItem(const LLViewerInventoryItem* item)
 				item_array->put(old_item);
 			}
 			mask |= LLInventoryObserver::STRUCTURE;
+			addChangedParent(old_parent_id);
 		}
 		if(old_item->getName() != item->getName())
 		{
@@ -979,6 +1016,7 @@ void LLInventoryModel::updateCategory(const LLViewerInventoryCategory* cat)
 				cat_array->put(old_cat);
 			}
 			mask |= LLInventoryObserver::STRUCTURE;
+			addChangedParent(old_parent_id);
 		}
 		if(old_cat->getName() != cat->getName())
 		{
@@ -1022,7 +1060,7 @@ void LLInventoryModel::moveObject(const LLUUID& object_id, const LLUUID& cat_id)
 		return;
 	}
 
-	if((object_id == cat_id) || !is_in_map(mCategoryMap, cat_id))
+	if((object_id == cat_id) || !mCategoryMap.count(cat_id))
 	{
 		llwarns << "Could not move inventory object " << object_id << " to "
 				<< cat_id << llendl;
@@ -1032,6 +1070,7 @@ void LLInventoryModel::moveObject(const LLUUID& object_id, const LLUUID& cat_id)
 	if(cat && (cat->getParentUUID() != cat_id))
 	{
 		cat_array_t* cat_array;
+		addChangedParent(cat->getParentUUID());
 		cat_array = getUnlockedCatArray(cat->getParentUUID());
 		if(cat_array) cat_array->removeObj(cat);
 		cat_array = getUnlockedCatArray(cat_id);
@@ -1044,6 +1083,7 @@ void LLInventoryModel::moveObject(const LLUUID& object_id, const LLUUID& cat_id)
 	if(item && (item->getParentUUID() != cat_id))
 	{
 		item_array_t* item_array;
+		addChangedParent(item->getParentUUID());
 		item_array = getUnlockedItemArray(item->getParentUUID());
 		if(item_array) item_array->removeObj(item);
 		item_array = getUnlockedItemArray(cat_id);
@@ -1155,6 +1195,8 @@ void LLInventoryModel::deleteObject(const LLUUID& id)
 		delete cat_list;
 		mParentChildCategoryTree.erase(id);
 	}
+	// the object is gone, so addChangedMask() can't look up where it was
+	addChangedParent(parent_id);
 	addChangedMask(LLInventoryObserver::REMOVE, id);
 	obj = NULL; // delete obj
 	updateLinkedObjectsFromPurge(id);
@@ -1338,6 +1380,9 @@ void LLInventoryModel::notifyObservers()
 
 	mModifyMask = LLInventoryObserver::NONE;
 	mChangedItemIDs.clear();
+	mChangedMasks.clear();
+	mChangedParentIDs.clear();
+	mChangeSetIncomplete = false;
 	mIsNotifyObservers = FALSE;
 }
 
@@ -1357,6 +1402,24 @@ void LLInventoryModel::addChangedMask(U32 mask, const LLUUID& referent)
 	if (referent.notNull())
 	{
 		mChangedItemIDs.insert(referent);
+		mChangedMasks[referent] |= mask;
+
+		const LLInventoryObject* obj = getObject(referent);
+		if (obj)
+		{
+			addChangedParent(obj->getParentUUID());
+		}
+		else if (mask != LLInventoryObserver::REMOVE)
+		{
+			// deleteObject() records the parent itself, anything else
+			// unknown could be anywhere
+			mChangeSetIncomplete = true;
+		}
+	}
+	else if (mask & ~(LLInventoryObserver::CALLING_CARD | LLInventoryObserver::GESTURE | LLInventoryObserver::SORT))
+	{
+		// a change somewhere, but no saying where
+		mChangeSetIncomplete = true;
 	}
 	
 	// Update all linked items.  Starting with just LABEL because I'm
@@ -1367,6 +1430,44 @@ void LLInventoryModel::addChangedMask(U32 mask, const LLUUID& referent)
 	}
 }
 
+void LLInventoryModel::addChangedParent(const LLUUID& parent_id)
+{
+	if (parent_id.notNull())
+	{
+		mChangedParentIDs.insert(parent_id);
+	}
+}
+
+U32 LLInventoryModel::getChangedMask(const LLUUID& id) const
+{
+	LLFlatHashMap<LLUUID, U32>::const_iterator iter = mChangedMasks.find(id);
+	return iter != mChangedMasks.end() ? iter->second : LLInventoryObserver::NONE;
+}
+
+bool LLInventoryModel::isCategoryChanged(const LLUUID& cat_id) const
+{
+	return mChangeSetIncomplete
+		|| mChangedParentIDs.find(cat_id) != mChangedParentIDs.end()
+		|| mChangedMasks.count(cat_id);
+}
+
+bool LLInventoryModel::isCategoryTreeChanged(const LLUUID& cat_id) const
+{
+	if (isCategoryChanged(cat_id))
+	{
+		return true;
+	}
+	for (changed_items_t::const_iterator iter = mChangedParentIDs.begin();
+		 iter != mChangedParentIDs.end(); ++iter)
+	{
+		if (isObjectDescendentOf(*iter, cat_id))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 // If we get back a normal response, handle it here
 void  LLInventoryModel::fetchInventoryResponder::result(const LLSD& content)
 {	
@@ -1494,17 +1595,8 @@ void LLInventoryModel::cache(
 	std::string path(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, agent_id_str));
 	inventory_filename = llformat(CACHE_FORMAT_STRING, path.c_str());
 	saveToFile(inventory_filename, categories, items);
-	std::string gzip_filename(inventory_filename);
-	gzip_filename.append(".gz");
-	if(gzip_file(inventory_filename, gzip_filename))
-	{
-		lldebugs << "Successfully compressed " << inventory_filename << llendl;
-		LLFile::remove(inventory_filename);
-	}
-	else
-	{
-		llwarns << "Unable to compress " << inventory_filename << llendl;
-	}
+	// drop the text cache left by older viewers
+	LLFile::remove(llformat(LEGACY_CACHE_FORMAT_STRING, path.c_str()));
 }
 
 
@@ -1800,28 +1892,13 @@ bool LLInventoryModel::loadSkeleton(
 		std::string inventory_filename;
 		inventory_filename = llformat(CACHE_FORMAT_STRING, path.c_str());
 		const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
-		std::string gzip_filename(inventory_filename);
-		gzip_filename.append(".gz");
-		LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
-		bool remove_inventory_file = false;
-		if(fp)
-		{
-			fclose(fp);
-			fp = NULL;
-			if(gunzip_file(gzip_filename, inventory_filename))
-			{
-				// we only want to remove the inventory file if it was
-				// gzipped before we loaded, and we successfully
-				// gunziped it.
-				remove_inventory_file = true;
-			}
-			else
-			{
-				llinfos << "Unable to gunzip " << gzip_filename << llendl;
-			}
+		version_map_t skeleton_versions;
+		for(cat_set_t::iterator it = temp_cats.begin(); it != temp_cats.end(); ++it)
+		{
+			skeleton_versions[(*it)->getUUID()] = (*it)->getVersion();
 		}
 		bool is_cache_obsolete = false;
-		if(loadFromFile(inventory_filename, categories, items, is_cache_obsolete))
+		if(loadFromFile(inventory_filename, categories, items, is_cache_obsolete, &skeleton_versions))
 		{
 			// We were able to find a cache of files. So, use what we
 			// found to generate a set of categories we should add. We
@@ -1961,16 +2038,10 @@ bool LLInventoryModel::loadSkeleton(
 			}
 		}
 
-		if(remove_inventory_file)
-		{
-			// clean up the gunzipped file.
-			LLFile::remove(inventory_filename);
-		}
 		if(is_cache_obsolete)
 		{
-			// If out of date, remove the gzipped file too.
 			llwarns << "Inv cache out of date, removing" << llendl;
-			LLFile::remove(gzip_filename);
+			LLFile::remove(inventory_filename);
 		}
 		categories.clear(); // will unref and delete entries
 	}
@@ -2250,10 +2321,56 @@ bool LLUUIDAndName::operator>(const LLUUIDAndName& rhs) const
 }
 
 // static
+// Reads a whole cache file and checks that its sections fit. Returns false
+// for a missing or truncated file; a file from another cache version reads
+// fine and is left for the caller to reject.
+static bool read_inventory_cache(const std::string& filename, std::vector<U8>& buffer,
+								 S32 current_version)
+{
+	LLFILE* file = LLFile::fopen(filename, "rb");		/*Flawfinder: ignore*/
+	if(!file)
+	{
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if(size < (long)sizeof(LLInvCacheHeader))
+	{
+		fclose(file);
+		return false;
+	}
+	buffer.resize(size);
+	size_t nread = fread(&buffer[0], 1, size, file);
+	fclose(file);
+	if(nread != (size_t)size)
+	{
+		return false;
+	}
+
+	const LLInvCacheHeader* header = (const LLInvCacheHeader*)&buffer[0];
+	if(header->mMagic != INV_CACHE_MAGIC)
+	{
+		return false;
+	}
+	if(header->mCacheVersion == current_version)
+	{
+		U64 expected = sizeof(LLInvCacheHeader)
+			+ (U64)header->mCategoryCount * sizeof(LLInvCacheEntry)
+			+ header->mDataSize;
+		if(expected != (U64)size)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 bool LLInventoryModel::loadFromFile(const std::string& filename,
 									LLInventoryModel::cat_array_t& categories,
 									LLInventoryModel::item_array_t& items,
-									bool &is_cache_obsolete)
+									bool &is_cache_obsolete,
+									const version_map_t* current_versions)
 {
 	if(filename.empty())
 	{
@@ -2261,90 +2378,90 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
 		return false;
 	}
 	llinfos << "LLInventoryModel::loadFromFile(" << filename << ")" << llendl;
-	LLFILE* file = LLFile::fopen(filename, "rb");		/*Flawfinder: ignore*/
-	if(!file)
+	std::vector<U8> buffer;
+	if(!read_inventory_cache(filename, buffer, sCurrentInvCacheVersion))
 	{
 		llinfos << "unable to load inventory from: " << filename << llendl;
 		return false;
 	}
-	// *NOTE: This buffer size is hard coded into scanf() below.
-	char buffer[MAX_STRING];		/*Flawfinder: ignore*/
-	char keyword[MAX_STRING];		/*Flawfinder: ignore*/
-	char value[MAX_STRING];			/*Flawfinder: ignore*/
 	is_cache_obsolete = true;  		// Obsolete until proven current
-	while(!feof(file) && fgets(buffer, MAX_STRING, file)) 
+	const LLInvCacheHeader* header = (const LLInvCacheHeader*)&buffer[0];
+	if(header->mCacheVersion != sCurrentInvCacheVersion)
+	{
+		return false;
+	}
+	is_cache_obsolete = false;
+
+	const LLInvCacheEntry* entries = (const LLInvCacheEntry*)(&buffer[0] + sizeof(LLInvCacheHeader));
+	const U8* data = (const U8*)(entries + header->mCategoryCount);
+	const U32 data_size = header->mDataSize;
+	S32 skipped = 0;
+	for(U32 i = 0; i < header->mCategoryCount; ++i)
 	{
-		sscanf(buffer, " %126s %126s", keyword, value);	/* Flawfinder: ignore */
-		if(0 == strcmp("inv_cache_version", keyword))
+		const LLInvCacheEntry& entry = entries[i];
+		if((U64)entry.mNameOffset + entry.mNameLength > data_size
+		   || (U64)entry.mItemsOffset + entry.mItemsLength > data_size)
 		{
-			S32 version;
-			int succ = sscanf(value,"%d",&version);
-			if ((1 == succ) && (version == sCurrentInvCacheVersion))
+			llwarns << "loadInventoryFromFile().  Ignoring category with bad offsets, index " << i << llendl;
+			continue;
+		}
+
+		LLUUID cat_id, parent_id, owner_id;
+		memcpy(cat_id.mData, entry.mID, UUID_BYTES);		/* Flawfinder: ignore */
+		memcpy(parent_id.mData, entry.mParentID, UUID_BYTES);	/* Flawfinder: ignore */
+		memcpy(owner_id.mData, entry.mOwnerID, UUID_BYTES);	/* Flawfinder: ignore */
+		std::string name((const char*)data + entry.mNameOffset, entry.mNameLength);
+		LLPointer<LLViewerInventoryCategory> inv_cat =
+			new LLViewerInventoryCategory(cat_id, parent_id,
+										  (LLFolderType::EType)entry.mPreferredType,
+										  name, owner_id);
+		inv_cat->setType((LLAssetType::EType)entry.mType);
+		inv_cat->setVersion(entry.mVersion);
+		categories.put(inv_cat);
+
+		if(current_versions)
+		{
+			// the items of a stale category would only be thrown away
+			version_map_t::const_iterator it = current_versions->find(cat_id);
+			if(it == current_versions->end() || it->second != entry.mVersion)
 			{
-				// Cache is up to date
-				is_cache_obsolete = false;
+				++skipped;
 				continue;
 			}
-			else
-			{
-				// Cache is out of date
-				break;
-			}
 		}
-		else if(0 == strcmp("inv_category", keyword))
+
+		LLSD item_array;
+		if(entry.mItemsLength == 0
+		   || LLSDSerialize::fromBinaryBuffer(item_array, data + entry.mItemsOffset, entry.mItemsLength) <= 0
+		   || !item_array.isArray())
 		{
-			if (is_cache_obsolete)
-				break;
-			
-			LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(LLUUID::null);
-			if(inv_cat->importFileLocal(file))
-			{
-				categories.put(inv_cat);
-			}
-			else
-			{
-				llwarns << "loadInventoryFromFile().  Ignoring invalid inventory category: " << inv_cat->getName() << llendl;
-				//delete inv_cat; // automatic when inv_cat is reassigned or destroyed
-			}
+			continue;
 		}
-		else if(0 == strcmp("inv_item", keyword))
+		for(LLSD::array_const_iterator it = item_array.beginArray(); it != item_array.endArray(); ++it)
 		{
-			if (is_cache_obsolete)
-				break;
-
 			LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
-			if( inv_item->importFileLocal(file) )
+			if(!inv_item->fromLLSD(*it))
 			{
-				// *FIX: Need a better solution, this prevents the
-				// application from freezing, but breaks inventory
-				// caching.
-				if(inv_item->getUUID().isNull())
-				{
-					//delete inv_item; // automatic when inv_cat is reassigned or destroyed
-					llwarns << "Ignoring inventory with null item id: "
-							<< inv_item->getName() << llendl;
-						
-				}
-				else
-				{
-					items.put(inv_item);
-				}
+				llwarns << "loadInventoryFromFile().  Ignoring invalid inventory item: " << inv_item->getName() << llendl;
+				continue;
 			}
-			else
+			// *FIX: Need a better solution, this prevents the
+			// application from freezing, but breaks inventory
+			// caching.
+			if(inv_item->getUUID().isNull())
 			{
-				llwarns << "loadInventoryFromFile().  Ignoring invalid inventory item: " << inv_item->getName() << llendl;
-				//delete inv_item; // automatic when inv_cat is reassigned or destroyed
+				llwarns << "Ignoring inventory with null item id: "
+						<< inv_item->getName() << llendl;
+				continue;
 			}
-		}
-		else
-		{
-			llwarns << "Unknown token in inventory file '" << keyword << "'"
-					<< llendl;
+			inv_item->setComplete(FALSE);
+			items.put(inv_item);
 		}
 	}
-	fclose(file);
-	if (is_cache_obsolete)
-		return false;
+	if(skipped)
+	{
+		llinfos << "Skipped the items of " << skipped << " out of date cached categories" << llendl;
+	}
 	return true;
 }
 
@@ -2359,32 +2476,133 @@ bool LLInventoryModel::saveToFile(const std::string& filename,
 		return false;
 	}
 	llinfos << "LLInventoryModel::saveToFile(" << filename << ")" << llendl;
-	LLFILE* file = LLFile::fopen(filename, "wb");		/*Flawfinder: ignore*/
-	if(!file)
-	{
-		llwarns << "unable to save inventory to: " << filename << llendl;
-		return false;
+
+	// Index what the last save wrote so unchanged categories can be copied
+	std::vector<U8> old_buffer;
+	LLFlatHashMap<LLUUID, const LLInvCacheEntry*> old_entries;
+	const U8* old_data = NULL;
+	U32 old_data_size = 0;
+	if(read_inventory_cache(filename, old_buffer, sCurrentInvCacheVersion))
+	{
+		const LLInvCacheHeader* old_header = (const LLInvCacheHeader*)&old_buffer[0];
+		if(old_header->mCacheVersion == sCurrentInvCacheVersion)
+		{
+			const LLInvCacheEntry* entries = (const LLInvCacheEntry*)(&old_buffer[0] + sizeof(LLInvCacheHeader));
+			old_data = (const U8*)(entries + old_header->mCategoryCount);
+			old_data_size = old_header->mDataSize;
+			old_entries.reserve(old_header->mCategoryCount);
+			for(U32 i = 0; i < old_header->mCategoryCount; ++i)
+			{
+				LLUUID id;
+				memcpy(id.mData, entries[i].mID, UUID_BYTES);	/* Flawfinder: ignore */
+				old_entries[id] = &entries[i];
+			}
+		}
 	}
 
-	fprintf(file, "\tinv_cache_version\t%d\n",sCurrentInvCacheVersion);
 	S32 count = categories.count();
-	S32 i;
-	for(i = 0; i < count; ++i)
+	LLFlatHashMap<LLUUID, std::vector<const LLViewerInventoryItem*> > items_by_parent;
+	items_by_parent.reserve(count);
+	for(S32 i = 0; i < items.count(); ++i)
 	{
-		LLViewerInventoryCategory* cat = categories[i];
-		if(cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
+		items_by_parent[items[i]->getParentUUID()].push_back(items[i]);
+	}
+
+	std::vector<LLInvCacheEntry> entries;
+	entries.reserve(count);
+	std::vector<U8> data;
+	S32 reused = 0;
+	for(S32 i = 0; i < count; ++i)
+	{
+		const LLViewerInventoryCategory* cat = categories[i];
+		if(cat->getVersion() == LLViewerInventoryCategory::VERSION_UNKNOWN)
 		{
-			cat->exportFileLocal(file);
+			continue;
+		}
+
+		LLInvCacheEntry entry;
+		memcpy(entry.mID, cat->getUUID().mData, UUID_BYTES);			/* Flawfinder: ignore */
+		memcpy(entry.mParentID, cat->getParentUUID().mData, UUID_BYTES);	/* Flawfinder: ignore */
+		memcpy(entry.mOwnerID, cat->getOwnerID().mData, UUID_BYTES);		/* Flawfinder: ignore */
+		entry.mVersion = cat->getVersion();
+		entry.mType = (S8)cat->getType();
+		entry.mPreferredType = (S8)cat->getPreferredType();
+
+		// name and parent live in the entry, so a renamed or moved
+		// category whose own version is unchanged still saves correctly
+		const std::string& name = cat->getName();
+		entry.mNameLength = (U16)llmin(name.size(), (size_t)U16_MAX);
+		entry.mNameOffset = data.size();
+		data.insert(data.end(), name.begin(), name.begin() + entry.mNameLength);
+
+		entry.mItemsOffset = data.size();
+		LLFlatHashMap<LLUUID, const LLInvCacheEntry*>::const_iterator old_it = old_entries.find(cat->getUUID());
+		if(old_it != old_entries.end()
+		   && old_it->second->mVersion == entry.mVersion
+		   && (U64)old_it->second->mItemsOffset + old_it->second->mItemsLength <= old_data_size)
+		{
+			// same version, same contents as last time
+			const U8* blob = old_data + old_it->second->mItemsOffset;
+			data.insert(data.end(), blob, blob + old_it->second->mItemsLength);
+			++reused;
+		}
+		else
+		{
+			LLFlatHashMap<LLUUID, std::vector<const LLViewerInventoryItem*> >::const_iterator children = items_by_parent.find(cat->getUUID());
+			if(children != items_by_parent.end())
+			{
+				LLSD item_array = LLSD::emptyArray();
+				for(std::vector<const LLViewerInventoryItem*>::const_iterator it = children->second.begin();
+					it != children->second.end(); ++it)
+				{
+					item_array.append((*it)->asLLSD());
+				}
+				LLSDSerialize::toBinaryBuffer(item_array, data);
+			}
 		}
+		entry.mItemsLength = data.size() - entry.mItemsOffset;
+		entries.push_back(entry);
 	}
 
-	count = items.count();
-	for(i = 0; i < count; ++i)
+	LLInvCacheHeader header;
+	header.mMagic = INV_CACHE_MAGIC;
+	header.mCacheVersion = sCurrentInvCacheVersion;
+	header.mCategoryCount = entries.size();
+	header.mDataSize = data.size();
+
+	// write beside the old file and swap, so a crash mid-save can't
+	// leave a truncated cache behind
+	std::string temp_filename(filename + ".tmp");
+	LLFILE* file = LLFile::fopen(temp_filename, "wb");		/*Flawfinder: ignore*/
+	if(!file)
 	{
-		items[i]->exportFile(file);
+		llwarns << "unable to save inventory to: " << temp_filename << llendl;
+		return false;
+	}
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	if(success && !entries.empty())
+	{
+		success = fwrite(&entries[0], sizeof(LLInvCacheEntry), entries.size(), file) == entries.size();
+	}
+	if(success && !data.empty())
+	{
+		success = fwrite(&data[0], 1, data.size(), file) == data.size();
 	}
-
 	fclose(file);
+	if(!success)
+	{
+		llwarns << "unable to save inventory to: " << temp_filename << llendl;
+		LLFile::remove(temp_filename);
+		return false;
+	}
+	LLFile::remove(filename);
+	if(LLFile::rename(temp_filename, filename) != 0)
+	{
+		llwarns << "unable to save inventory to: " << filename << llendl;
+		return false;
+	}
+	llinfos << "Saved " << entries.size() << " categories, "
+			<< reused << " unchanged since the last save" << llendl;
 	return true;
 }
 
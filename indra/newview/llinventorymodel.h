@@ -33,6 +33,7 @@
 #include "llframetimer.h"
 #include "llhttpclient.h"
 #include "lluuid.h"
+#include "llflathashmap.h"
 #include "llpermissionsflags.h"
 #include "llstring.h"
 #include "llmd5.h"
@@ -86,6 +87,7 @@ public:
 		fetchInventoryResponder(const LLSD& request_sd) : mRequestSD(request_sd) {};
 		void result(const LLSD& content);			
 		void error(U32 status, const std::string& reason);
+		/*virtual*/ bool parseWhileReceiving() const { return true; }
 	protected:
 		LLSD mRequestSD;
 	};
@@ -147,8 +149,8 @@ private:
 	// the inventory using several different identifiers.
 	// mInventory member data is the 'master' list of inventory, and
 	// mCategoryMap and mItemMap store uuid->object mappings. 
-	typedef std::map<LLUUID, LLPointer<LLViewerInventoryCategory> > cat_map_t;
-	typedef std::map<LLUUID, LLPointer<LLViewerInventoryItem> > item_map_t;
+	typedef LLFlatHashMap<LLUUID, LLPointer<LLViewerInventoryCategory> > cat_map_t;
+	typedef LLFlatHashMap<LLUUID, LLPointer<LLViewerInventoryItem> > item_map_t;
 	cat_map_t mCategoryMap;
 	item_map_t mItemMap;
 	// This last set of indices is used to map parents to children.
@@ -460,9 +462,22 @@ public:
 	// inventory. The next notify will include that notification.
 	void addChangedMask(U32 mask, const LLUUID& referent);
 	const changed_items_t& getChangedIDs() const { return mChangedItemIDs; }
+
+	// The pending change set, for observers to skip work on categories
+	// that weren't touched.  Only meaningful inside changed().
+	U32 getChangedMask(const LLUUID& id) const;
+	// Categories whose contents gained, lost or changed an object,
+	// including the old parent of anything moved out.
+	const changed_items_t& getChangedParentIDs() const { return mChangedParentIDs; }
+	// True if cat_id or its direct contents may have changed.  Errs on
+	// the side of true whenever a change couldn't be placed.
+	bool isCategoryChanged(const LLUUID& cat_id) const;
+	// As above, but anywhere below cat_id.
+	bool isCategoryTreeChanged(const LLUUID& cat_id) const;
 protected:
 	// Updates all linked items pointing to this id.
 	void addChangedMaskForLinks(const LLUUID& object_id, U32 mask);
+	void addChangedParent(const LLUUID& parent_id);
 private:
 	// Flag set when notifyObservers is being called, to look for bugs
 	// where it's called recursively.
@@ -470,6 +485,11 @@ private:
 	// Variables used to track what has changed since the last notify.
 	U32 mModifyMask;
 	changed_items_t mChangedItemIDs;
+	LLFlatHashMap<LLUUID, U32> mChangedMasks;
+	changed_items_t mChangedParentIDs;
+	// Set when a change couldn't be tied to a category, so every
+	// category has to be treated as changed.
+	bool mChangeSetIncomplete;
 	
 	//--------------------------------------------------------------------
 	// Observers
@@ -506,10 +526,18 @@ public:
 	// File I/O
 	//--------------------------------------------------------------------
 protected:
+	typedef std::map<LLUUID, S32> version_map_t;
+	// The cache is binary: a fixed size record per category, then each
+	// category's items as one binary LLSD blob.  When current_versions is
+	// given, only the items of categories whose cached version matches are
+	// parsed; the others come back as bare categories.
 	static bool loadFromFile(const std::string& filename,
 							 cat_array_t& categories,
 							 item_array_t& items,
-							 bool& is_cache_obsolete); 
+							 bool& is_cache_obsolete,
+							 const version_map_t* current_versions = NULL); 
+	// Item blobs of categories whose version hasn't changed since the
+	// last save are copied over from the old file rather than rebuilt.
 	static bool saveToFile(const std::string& filename,
 						   const cat_array_t& categories,
 						   const item_array_t& items); 
@@ -41,6 +41,17 @@
 const F32 MAX_TIME_FOR_SINGLE_FETCH = 10.f;
 const S32 MAX_FETCH_RETRIES = 10;
 
+// Bulk fetch batch sizing: replies quicker than FAST grow the batch,
+// slower than SLOW (or timed out) halve it.
+const U32 MIN_FETCH_BATCH_SIZE = 2;
+const U32 INITIAL_FETCH_BATCH_SIZE = 10;
+const F64 FAST_FETCH_LATENCY = 2.0;
+const F64 SLOW_FETCH_LATENCY = 10.0;
+// Folders asked for directly may go over the concurrent fetch limit by this much
+const S16 PRIORITY_FETCH_HEADROOM = 2;
+// Time per frame spent applying fetched folders to the model
+const F32 FETCH_PROCESSING_TIME_SLICE = 0.005f;
+
 LLInventoryModelBackgroundFetch::LLInventoryModelBackgroundFetch() :
 	mBackgroundFetchActive(FALSE),
 	mFolderFetchActive(false),
@@ -50,6 +61,7 @@ LLInventoryModelBackgroundFetch::LLInventoryModelBackgroundFetch() :
 	mNumFetchRetries(0),
 	mMinTimeBetweenFetches(0.3f),
 	mMaxTimeBetweenFetches(10.f),
+	mBatchSize(INITIAL_FETCH_BATCH_SIZE),
 	mTimelyFetchPending(FALSE),
 	mFetchCount(0)
 {
@@ -61,7 +73,7 @@ LLInventoryModelBackgroundFetch::~LLInventoryModelBackgroundFetch()
 
 bool LLInventoryModelBackgroundFetch::isBulkFetchProcessingComplete() const
 {
-	return mFetchQueue.empty() && mFetchCount<=0;
+	return mFetchQueue.empty() && mFetchedFolders.empty() && mFetchCount<=0;
 }
 
 bool LLInventoryModelBackgroundFetch::libraryFetchStarted() const
@@ -133,7 +145,7 @@ void LLInventoryModelBackgroundFetch::start(const LLUUID& id, BOOL recursive)
 			// Specific folder requests go to front of queue.
 			if (mFetchQueue.empty() || mFetchQueue.front().mUUID != id)
 			{
-				mFetchQueue.push_front(FetchQueueInfo(id, recursive));
+				mFetchQueue.push_front(FetchQueueInfo(id, recursive, true, true));
 				gIdleCallbacks.addFunction(&LLInventoryModelBackgroundFetch::backgroundFetchCB, NULL);
 			}
 			if (id == gInventory.getLibraryRootFolderID())
@@ -152,7 +164,7 @@ void LLInventoryModelBackgroundFetch::start(const LLUUID& id, BOOL recursive)
 		{
 			mBackgroundFetchActive = TRUE;
 
-			mFetchQueue.push_front(FetchQueueInfo(id, false, false));
+			mFetchQueue.push_front(FetchQueueInfo(id, false, false, true));
 			gIdleCallbacks.addFunction(&LLInventoryModelBackgroundFetch::backgroundFetchCB, NULL);
 		}
 	}
@@ -387,120 +399,36 @@ class LLInventoryModelFetchDescendentsResponder: public LLHTTPClient::Responder
 public:
 	LLInventoryModelFetchDescendentsResponder(const LLSD& request_sd, uuid_vec_t recursive_cats) : 
 		mRequestSD(request_sd),
-		mRecursiveCatUUIDs(recursive_cats)
+		mRecursiveCatUUIDs(recursive_cats),
+		mStartTime(LLTimer::getTotalSeconds())
 	{};
 	//LLInventoryModelFetchDescendentsResponder() {};
 	void result(const LLSD& content);
 	void error(U32 status, const std::string& reason);
-protected:
-	BOOL getIsRecursive(const LLUUID& cat_id) const;
+	// FetchInventoryDescendents2 replies run to megabytes
+	/*virtual*/ bool parseWhileReceiving() const { return true; }
 private:
 	LLSD mRequestSD;
 	uuid_vec_t mRecursiveCatUUIDs; // hack for storing away which cat fetches are recursive
+	F64 mStartTime;
 };
 
+static BOOL is_recursive_fetch(const uuid_vec_t& recursive_cats, const LLUUID& cat_id)
+{
+	return (std::find(recursive_cats.begin(), recursive_cats.end(), cat_id) != recursive_cats.end());
+}
+
 // If we get back a normal response, handle it here.
 void LLInventoryModelFetchDescendentsResponder::result(const LLSD& content)
 {
 	LLInventoryModelBackgroundFetch *fetcher = LLInventoryModelBackgroundFetch::getInstance();
+	fetcher->bulkFetchCompleted(LLTimer::getTotalSeconds() - mStartTime, false);
+
+	// The folders are applied over the next frames by the idle callback,
+	// a big reply would stall the frame otherwise.
 	if (content.has("folders"))	
 	{
-
-		for(LLSD::array_const_iterator folder_it = content["folders"].beginArray();
-			folder_it != content["folders"].endArray();
-			++folder_it)
-		{	
-			LLSD folder_sd = *folder_it;
-			
-
-			//LLUUID agent_id = folder_sd["agent_id"];
-
-			//if(agent_id != gAgent.getID())	//This should never happen.
-			//{
-			//	llwarns << "Got a UpdateInventoryItem for the wrong agent."
-			//			<< llendl;
-			//	break;
-			//}
-
-			LLUUID parent_id = folder_sd["folder_id"];
-			LLUUID owner_id = folder_sd["owner_id"];
-			S32    version  = (S32)folder_sd["version"].asInteger();
-			S32    descendents = (S32)folder_sd["descendents"].asInteger();
-			LLPointer<LLViewerInventoryCategory> tcategory = new LLViewerInventoryCategory(owner_id);
-
-            if (parent_id.isNull())
-            {
-			    LLPointer<LLViewerInventoryItem> titem = new LLViewerInventoryItem;
-			    for(LLSD::array_const_iterator item_it = folder_sd["items"].beginArray();
-				    item_it != folder_sd["items"].endArray();
-				    ++item_it)
-			    {	
-                    const LLUUID lost_uuid = gInventory.findCategoryUUIDForType(LLFolderType::FT_LOST_AND_FOUND);
-                    if (lost_uuid.notNull())
-                    {
-				        LLSD item = *item_it;
-				        titem->unpackMessage(item);
-				
-                        LLInventoryModel::update_list_t update;
-                        LLInventoryModel::LLCategoryUpdate new_folder(lost_uuid, 1);
-                        update.push_back(new_folder);
-                        gInventory.accountForUpdate(update);
-
-                        titem->setParent(lost_uuid);
-                        titem->updateParentOnServer(FALSE);
-                        gInventory.updateItem(titem);
-                        gInventory.notifyObservers();
-                        
-                    }
-                }
-            }
-
-	        LLViewerInventoryCategory* pcat = gInventory.getCategory(parent_id);
-			if (!pcat)
-			{
-				continue;
-			}
-
-			for(LLSD::array_const_iterator category_it = folder_sd["categories"].beginArray();
-				category_it != folder_sd["categories"].endArray();
-				++category_it)
-			{	
-				LLSD category = *category_it;
-				tcategory->fromLLSD(category); 
-				
-				const BOOL recursive = getIsRecursive(tcategory->getUUID());
-				
-				if (recursive)
-				{
-					fetcher->mFetchQueue.push_back(LLInventoryModelBackgroundFetch::FetchQueueInfo(tcategory->getUUID(), recursive));
-				}
-				else if ( !gInventory.isCategoryComplete(tcategory->getUUID()) )
-				{
-					gInventory.updateCategory(tcategory);
-				}
-
-			}
-			LLPointer<LLViewerInventoryItem> titem = new LLViewerInventoryItem;
-			for(LLSD::array_const_iterator item_it = folder_sd["items"].beginArray();
-				item_it != folder_sd["items"].endArray();
-				++item_it)
-			{	
-				LLSD item = *item_it;
-				titem->unpackMessage(item);
-				
-				gInventory.updateItem(titem);
-			}
-
-			// Set version and descendentcount according to message.
-			LLViewerInventoryCategory* cat = gInventory.getCategory(parent_id);
-			if(cat)
-			{
-				cat->setVersion(version);
-				cat->setDescendentCount(descendents);
-				cat->determineFolderType();
-			}
-
-		}
+		fetcher->queueFetchedFolders(content["folders"], mRecursiveCatUUIDs);
 	}
 		
 	if (content.has("bad_folders"))
@@ -524,8 +452,6 @@ void LLInventoryModelFetchDescendentsResponder::result(const LLSD& content)
 		llinfos << "Inventory fetch completed" << llendl;
 		fetcher->setAllFoldersFetched();
 	}
-	
-	gInventory.notifyObservers();
 }
 
 // If we get back an error (not found, etc...), handle it here.
@@ -540,13 +466,14 @@ void LLInventoryModelFetchDescendentsResponder::error(U32 status, const std::str
 
 	if (status==499) // timed out
 	{
+		fetcher->bulkFetchCompleted(LLTimer::getTotalSeconds() - mStartTime, true);
 		for(LLSD::array_const_iterator folder_it = mRequestSD["folders"].beginArray();
 			folder_it != mRequestSD["folders"].endArray();
 			++folder_it)
 		{	
 			LLSD folder_sd = *folder_it;
 			LLUUID folder_id = folder_sd["folder_id"];
-			const BOOL recursive = getIsRecursive(folder_id);
+			const BOOL recursive = is_recursive_fetch(mRecursiveCatUUIDs, folder_id);
 			fetcher->mFetchQueue.push_front(LLInventoryModelBackgroundFetch::FetchQueueInfo(folder_id, recursive));
 		}
 	}
@@ -560,9 +487,147 @@ void LLInventoryModelFetchDescendentsResponder::error(U32 status, const std::str
 	gInventory.notifyObservers();
 }
 
-BOOL LLInventoryModelFetchDescendentsResponder::getIsRecursive(const LLUUID& cat_id) const
+void LLInventoryModelBackgroundFetch::bulkFetchCompleted(F64 latency, bool timed_out)
+{
+	U32 max_batch_size = llmax(gSavedSettings.getU32("InventoryFetchMaxBatch"), MIN_FETCH_BATCH_SIZE);
+	if (timed_out || latency > SLOW_FETCH_LATENCY)
+	{
+		mBatchSize = llmax(mBatchSize / 2, MIN_FETCH_BATCH_SIZE);
+	}
+	else if (latency < FAST_FETCH_LATENCY)
+	{
+		mBatchSize = llmin(mBatchSize + mBatchSize / 2, max_batch_size);
+	}
+	LL_DEBUGS("InventoryFetch") << "Bulk fetch took " << latency << "s, batch size now " << mBatchSize << LL_ENDL;
+}
+
+void LLInventoryModelBackgroundFetch::queueFetchedFolders(const LLSD& folders, const uuid_vec_t& recursive_cats)
+{
+	if (folders.size() == 0)
+	{
+		return;
+	}
+	mFetchedFolders.push_back(FetchedFolders());
+	FetchedFolders& fetched = mFetchedFolders.back();
+	fetched.mFolders = folders;
+	fetched.mRecursiveCatUUIDs = recursive_cats;
+	fetched.mNext = 0;
+}
+
+void LLInventoryModelBackgroundFetch::processFetchedFolders(F32 max_time)
+{
+	if (mFetchedFolders.empty())
+	{
+		return;
+	}
+
+	LLTimer timer;
+	while (!mFetchedFolders.empty() && timer.getElapsedTimeF32() < max_time)
+	{
+		FetchedFolders& fetched = mFetchedFolders.front();
+		processFetchedFolder(fetched.mFolders[fetched.mNext], fetched.mRecursiveCatUUIDs);
+		if (++fetched.mNext >= fetched.mFolders.size())
+		{
+			mFetchedFolders.pop_front();
+		}
+	}
+
+	if (isBulkFetchProcessingComplete())
+	{
+		llinfos << "Inventory fetch completed" << llendl;
+		setAllFoldersFetched();
+	}
+	gInventory.notifyObservers();
+}
+
+void LLInventoryModelBackgroundFetch::processFetchedFolder(const LLSD& folder_sd, const uuid_vec_t& recursive_cats)
 {
-	return (std::find(mRecursiveCatUUIDs.begin(),mRecursiveCatUUIDs.end(), cat_id) != mRecursiveCatUUIDs.end());
+	//LLUUID agent_id = folder_sd["agent_id"];
+
+	//if(agent_id != gAgent.getID())	//This should never happen.
+	//{
+	//	llwarns << "Got a UpdateInventoryItem for the wrong agent."
+	//			<< llendl;
+	//	break;
+	//}
+
+	LLUUID parent_id = folder_sd["folder_id"];
+	LLUUID owner_id = folder_sd["owner_id"];
+	S32    version  = (S32)folder_sd["version"].asInteger();
+	S32    descendents = (S32)folder_sd["descendents"].asInteger();
+	LLPointer<LLViewerInventoryCategory> tcategory = new LLViewerInventoryCategory(owner_id);
+
+	if (parent_id.isNull())
+	{
+		LLPointer<LLViewerInventoryItem> titem = new LLViewerInventoryItem;
+		for(LLSD::array_const_iterator item_it = folder_sd["items"].beginArray();
+			item_it != folder_sd["items"].endArray();
+			++item_it)
+		{	
+			const LLUUID lost_uuid = gInventory.findCategoryUUIDForType(LLFolderType::FT_LOST_AND_FOUND);
+			if (lost_uuid.notNull())
+			{
+				LLSD item = *item_it;
+				titem->unpackMessage(item);
+		
+				LLInventoryModel::update_list_t update;
+				LLInventoryModel::LLCategoryUpdate new_folder(lost_uuid, 1);
+				update.push_back(new_folder);
+				gInventory.accountForUpdate(update);
+
+				titem->setParent(lost_uuid);
+				titem->updateParentOnServer(FALSE);
+				gInventory.updateItem(titem);
+				gInventory.notifyObservers();
+				
+			}
+		}
+	}
+
+	LLViewerInventoryCategory* pcat = gInventory.getCategory(parent_id);
+	if (!pcat)
+	{
+		return;
+	}
+
+	for(LLSD::array_const_iterator category_it = folder_sd["categories"].beginArray();
+		category_it != folder_sd["categories"].endArray();
+		++category_it)
+	{	
+		LLSD category = *category_it;
+		tcategory->fromLLSD(category); 
+		
+		const BOOL recursive = is_recursive_fetch(recursive_cats, tcategory->getUUID());
+		
+		if (recursive)
+		{
+			mFetchQueue.push_back(FetchQueueInfo(tcategory->getUUID(), recursive));
+		}
+		else if ( !gInventory.isCategoryComplete(tcategory->getUUID()) )
+		{
+			gInventory.updateCategory(tcategory);
+		}
+
+	}
+	LLPointer<LLViewerInventoryItem> titem = new LLViewerInventoryItem;
+	for(LLSD::array_const_iterator item_it = folder_sd["items"].beginArray();
+		item_it != folder_sd["items"].endArray();
+		++item_it)
+	{	
+		LLSD item = *item_it;
+		titem->unpackMessage(item);
+		
+		gInventory.updateItem(titem);
+	}
+
+	// Set version and descendentcount according to message.
+	LLViewerInventoryCategory* cat = gInventory.getCategory(parent_id);
+	if(cat)
+	{
+		cat->setVersion(version);
+		cat->setDescendentCount(descendents);
+		cat->determineFolderType();
+	}
 }
 
 // Bundle up a bunch of requests to send all at once.
@@ -570,28 +635,52 @@ BOOL LLInventoryModelFetchDescendentsResponder::getIsRecursive(const LLUUID& cat
 void LLInventoryModelBackgroundFetch::bulkFetch()
 {
 	//Background fetch is called from gIdleCallbacks in a loop until background fetch is stopped.
-	//If there are items in mFetchQueue, we want to check the time since the last bulkFetch was 
-	//sent.  If it exceeds our retry time, go ahead and fire off another batch.  
+	//Each call applies some of the replies received so far, then sends batches off mFetchQueue
+	//until the concurrent fetch limit is reached.
 	LLViewerRegion* region = gAgent.getRegion();
 	if (!region) return;
 
-	S16 max_concurrent_fetches=8;
-	F32 new_min_time = 0.5f;			//HACK!  Clean this up when old code goes away entirely.
-	if (mMinTimeBetweenFetches < new_min_time) 
-	{
-		mMinTimeBetweenFetches=new_min_time;  //HACK!  See above.
-	}
-	
-	if (gDisconnected ||
-		(mFetchCount > max_concurrent_fetches) ||
-		(mFetchTimer.getElapsedTimeF32() < mMinTimeBetweenFetches))
+	processFetchedFolders(FETCH_PROCESSING_TIME_SLICE);
+
+	if (gDisconnected)
 	{
 		return; // just bail if we are disconnected
 	}	
 
+	// Rather than wait between batches, keep the pipe full; the batch
+	// size follows how quickly the replies come back.
+	S16 max_concurrent_fetches = (S16)llclamp(gSavedSettings.getU32("InventoryFetchMaxConcurrent"), (U32)1, (U32)64);
+	while (!mFetchQueue.empty())
+	{
+		S16 limit = max_concurrent_fetches;
+		if (mFetchQueue.front().mIsPriority)
+		{
+			limit += PRIORITY_FETCH_HEADROOM;
+		}
+		if (mFetchCount >= limit || !bulkFetchBatch(region))
+		{
+			break;
+		}
+	}
+
+	if (isBulkFetchProcessingComplete())
+	{
+		setAllFoldersFetched();
+	}
+}
+
+// Sends one batch off the front of the queue. Folders already fetched
+// only contribute their children, so a batch may send nothing.
+bool LLInventoryModelBackgroundFetch::bulkFetchBatch(LLViewerRegion* region)
+{
+	if (mFetchQueue.empty())
+	{
+		return false;
+	}
+
 	U32 item_count=0;
 	U32 folder_count=0;
-	U32 max_batch_size=5;
+	U32 max_batch_size=mBatchSize;
 
 	U32 sort_order = gSavedSettings.getU32(LLInventoryPanel::DEFAULT_SORT_ORDER) & 0x1;
 
@@ -605,7 +694,9 @@ void LLInventoryModelBackgroundFetch::bulkFetch()
 	while (!mFetchQueue.empty() 
 			&& (item_count + folder_count) < max_batch_size)
 	{
-		const FetchQueueInfo& fetch_info = mFetchQueue.front();
+		// copied, pushing the children below may reallocate the queue
+		const FetchQueueInfo fetch_info = mFetchQueue.front();
+		mFetchQueue.pop_front();
 		if (fetch_info.mIsCategory)
 		{
 			const LLUUID &cat_id = fetch_info.mUUID;
@@ -679,8 +770,6 @@ void LLInventoryModelBackgroundFetch::bulkFetch()
 				item_count++;
 			}
 		}
-
-		mFetchQueue.pop_front();
 	}
 		
 	if (item_count + folder_count > 0)
@@ -688,9 +777,9 @@ void LLInventoryModelBackgroundFetch::bulkFetch()
 		if (folder_count)
 		{
 			std::string url = region->getCapability("FetchInventoryDescendents2");   
-			mFetchCount++;
 			if (folder_request_body["folders"].size())
 			{
+				mFetchCount++;
 				LLInventoryModelFetchDescendentsResponder *fetcher = new LLInventoryModelFetchDescendentsResponder(folder_request_body, recursive_cats);
 				LLHTTPClient::post(url, folder_request_body, fetcher, 300.0);
 			}
@@ -698,6 +787,7 @@ void LLInventoryModelBackgroundFetch::bulkFetch()
 			{
 				std::string url_lib = gAgent.getRegion()->getCapability("FetchLibDescendents2");
 
+				mFetchCount++;
 				LLInventoryModelFetchDescendentsResponder *fetcher = new LLInventoryModelFetchDescendentsResponder(folder_request_body_lib, recursive_cats);
 				LLHTTPClient::post(url_lib, folder_request_body_lib, fetcher, 300.0);
 			}
@@ -749,11 +839,7 @@ void LLInventoryModelBackgroundFetch::bulkFetch()
 		}
 		mFetchTimer.reset();
 	}
-
-	else if (isBulkFetchProcessingComplete())
-	{
-		setAllFoldersFetched();
-	}
+	return true;
 }
 
 bool LLInventoryModelBackgroundFetch::fetchQueueContainsNoDescendentsOf(const LLUUID& cat_id) const
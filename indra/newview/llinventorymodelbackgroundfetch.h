@@ -27,9 +27,12 @@
 #ifndef LL_LLINVENTORYMODELBACKGROUNDFETCH_H
 #define LL_LLINVENTORYMODELBACKGROUNDFETCH_H
 
+#include "llsd.h"
 #include "llsingleton.h"
 #include "lluuid.h"
 
+class LLViewerRegion;
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // Class LLInventoryModelBackgroundFetch
 //
@@ -64,6 +67,14 @@ public:
 protected:
 	bool isBulkFetchProcessingComplete() const;
 	void bulkFetch();
+	bool bulkFetchBatch(LLViewerRegion* region);
+
+	// Replies are applied to the model a slice at a time from the idle loop
+	void queueFetchedFolders(const LLSD& folders, const uuid_vec_t& recursive_cats);
+	void processFetchedFolders(F32 max_time);
+	void processFetchedFolder(const LLSD& folder_sd, const uuid_vec_t& recursive_cats);
+	// Grows the batch size while replies come back quickly, shrinks it when they don't
+	void bulkFetchCompleted(F64 latency, bool timed_out);
 
 	void backgroundFetch();
 	static void backgroundFetchCB(void*); // background fetch idle function
@@ -84,18 +95,29 @@ private:
 	LLFrameTimer mFetchTimer;
 	F32 mMinTimeBetweenFetches;
 	F32 mMaxTimeBetweenFetches;
+	U32 mBatchSize;
 
 	struct FetchQueueInfo
 	{
-		FetchQueueInfo(const LLUUID& id, BOOL recursive, bool is_category = true) :
-			mUUID(id), mRecursive(recursive), mIsCategory(is_category)
+		FetchQueueInfo(const LLUUID& id, BOOL recursive, bool is_category = true, bool is_priority = false) :
+			mUUID(id), mRecursive(recursive), mIsCategory(is_category), mIsPriority(is_priority)
 		{}
 		LLUUID mUUID;
 		bool mIsCategory;
 		BOOL mRecursive;
+		bool mIsPriority; // asked for directly, e.g. a folder being opened
 	};
 	typedef std::deque<FetchQueueInfo> fetch_queue_t;
 	fetch_queue_t mFetchQueue;
+
+	struct FetchedFolders
+	{
+		LLSD mFolders;
+		uuid_vec_t mRecursiveCatUUIDs;
+		S32 mNext;
+	};
+	typedef std::deque<FetchedFolders> fetched_folders_t;
+	fetched_folders_t mFetchedFolders;
 };
 
 #endif // LL_LLINVENTORYMODELBACKGROUNDFETCH_H
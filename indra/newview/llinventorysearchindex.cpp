@@ -0,0 +1,188 @@
+/** 
+ * @file llinventorysearchindex.cpp
+ * @brief Implementation of the inventory label search index
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llinventorysearchindex.h"
+
+const std::string::size_type TRIGRAM_LENGTH = 3;
+// don't bother compacting small indexes
+const S32 MIN_STALE_ENTRIES_TO_REBUILD = 16384;
+
+static inline U32 trigram_at(const std::string& str, std::string::size_type pos)
+{
+	return ((U32)(U8)str[pos] << 16) | ((U32)(U8)str[pos + 1] << 8) | (U32)(U8)str[pos + 2];
+}
+
+static inline S32 trigram_count(const std::string& str)
+{
+	return str.size() < TRIGRAM_LENGTH ? 0 : (S32)(str.size() - TRIGRAM_LENGTH + 1);
+}
+
+LLInventorySearchIndex::LLInventorySearchIndex()
+:	mLiveEntries(0),
+	mStaleEntries(0)
+{
+}
+
+void LLInventorySearchIndex::update(const LLUUID& id, const std::string& label)
+{
+	label_map_t::iterator it = mLabels.find(id);
+	if (it != mLabels.end())
+	{
+		if (it->second == label)
+		{
+			return;
+		}
+		S32 count = trigram_count(it->second);
+		mLiveEntries -= count;
+		mStaleEntries += count;
+		it->second = label;
+	}
+	else
+	{
+		mLabels[id] = label;
+	}
+	addTrigrams(id, label);
+
+	if (!mQuery.empty())
+	{
+		std::string::size_type offset = label.find(mQuery);
+		if (offset != std::string::npos)
+		{
+			mMatches[id] = offset;
+		}
+		else
+		{
+			mMatches.erase(id);
+		}
+	}
+
+	if (mStaleEntries > MIN_STALE_ENTRIES_TO_REBUILD && mStaleEntries > mLiveEntries)
+	{
+		rebuild();
+	}
+}
+
+void LLInventorySearchIndex::remove(const LLUUID& id)
+{
+	label_map_t::iterator it = mLabels.find(id);
+	if (it == mLabels.end())
+	{
+		return;
+	}
+	S32 count = trigram_count(it->second);
+	mLiveEntries -= count;
+	mStaleEntries += count;
+	mLabels.erase(it);
+	mMatches.erase(id);
+}
+
+void LLInventorySearchIndex::clear()
+{
+	mPostings.clear();
+	mLabels.clear();
+	mMatches.clear();
+	mQuery.clear();
+	mLiveEntries = 0;
+	mStaleEntries = 0;
+}
+
+bool LLInventorySearchIndex::findMatch(const LLUUID& id, const std::string& substring, std::string::size_type& offset)
+{
+	if (substring.size() < TRIGRAM_LENGTH || mLabels.find(id) == mLabels.end())
+	{
+		return false;
+	}
+	if (substring != mQuery)
+	{
+		setQuery(substring);
+	}
+	match_map_t::const_iterator it = mMatches.find(id);
+	offset = (it != mMatches.end()) ? it->second : std::string::npos;
+	return true;
+}
+
+void LLInventorySearchIndex::addTrigrams(const LLUUID& id, const std::string& label)
+{
+	S32 count = trigram_count(label);
+	for (S32 i = 0; i < count; i++)
+	{
+		mPostings[trigram_at(label, i)].push_back(id);
+	}
+	mLiveEntries += count;
+}
+
+void LLInventorySearchIndex::setQuery(const std::string& substring)
+{
+	mQuery = substring;
+	mMatches.clear();
+
+	// every match has all of the substring's trigrams, so the labels behind
+	// the shortest list are the only ones worth searching
+	const std::vector<LLUUID>* candidates = NULL;
+	S32 count = trigram_count(substring);
+	for (S32 i = 0; i < count; i++)
+	{
+		postings_t::const_iterator it = mPostings.find(trigram_at(substring, i));
+		if (it == mPostings.end())
+		{
+			return;
+		}
+		if (!candidates || it->second.size() < candidates->size())
+		{
+			candidates = &it->second;
+		}
+	}
+	if (!candidates)
+	{
+		return;
+	}
+
+	for (std::vector<LLUUID>::const_iterator it = candidates->begin(); it != candidates->end(); ++it)
+	{
+		label_map_t::const_iterator label = mLabels.find(*it);
+		if (label != mLabels.end())
+		{
+			std::string::size_type offset = label->second.find(substring);
+			if (offset != std::string::npos)
+			{
+				mMatches[*it] = offset;
+			}
+		}
+	}
+}
+
+void LLInventorySearchIndex::rebuild()
+{
+	mPostings.clear();
+	mLiveEntries = 0;
+	mStaleEntries = 0;
+	for (label_map_t::const_iterator it = mLabels.begin(); it != mLabels.end(); ++it)
+	{
+		addTrigrams(it->first, it->second);
+	}
+}
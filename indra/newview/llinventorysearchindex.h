@@ -0,0 +1,82 @@
+/** 
+ * @file llinventorysearchindex.h
+ * @brief Trigram index over inventory labels for substring search
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYSEARCHINDEX_H
+#define LL_LLINVENTORYSEARCHINDEX_H
+
+#include <string>
+#include <vector>
+
+#include "llflathashmap.h"
+#include "lluuid.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLInventorySearchIndex
+//
+// Maps every three character run of a label to the ids whose labels contain
+// it, so a substring search only looks at the labels sharing its rarest
+// trigram instead of all of them.  The matches for the last substring asked
+// for are kept, and kept current as labels change, so a filter pass over a
+// whole folder view costs one lookup per item.
+//
+// Labels are expected upper cased already, the same as the filter string.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLInventorySearchIndex
+{
+public:
+	LLInventorySearchIndex();
+
+	void update(const LLUUID& id, const std::string& label);
+	void remove(const LLUUID& id);
+	void clear();
+
+	// Returns false when the index can't answer (substrings shorter than a
+	// trigram, or an id it has never seen) and the caller has to search the
+	// label itself.  Otherwise offset is where substring starts, or npos.
+	bool findMatch(const LLUUID& id, const std::string& substring, std::string::size_type& offset);
+
+private:
+	void addTrigrams(const LLUUID& id, const std::string& label);
+	void setQuery(const std::string& substring);
+	void rebuild();
+
+	typedef LLFlatHashMap<U32, std::vector<LLUUID> > postings_t;
+	typedef LLFlatHashMap<LLUUID, std::string> label_map_t;
+	typedef LLFlatHashMap<LLUUID, std::string::size_type> match_map_t;
+
+	// Postings aren't pruned when a label changes or goes away, a stale id
+	// is caught by the label check in setQuery().  Once they outnumber the
+	// live ones the postings are rebuilt.
+	postings_t	mPostings;
+	label_map_t	mLabels;
+	S32			mLiveEntries;
+	S32			mStaleEntries;
+
+	std::string	mQuery;
+	match_map_t	mMatches;
+};
+
+#endif // LL_LLINVENTORYSEARCHINDEX_H
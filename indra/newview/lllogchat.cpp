@@ -600,6 +600,19 @@ std::string LLLogChat::oldLogFileName(std::string filename)
 	directory += gDirUtilp->getDirDelimiter();/* add final OS dependent delimiter */
 	filename=cleanFileName(filename);/* lest make shure the file name has no invalad charecters befor making the pattern */
 	std::string pattern = (filename+(( filename == "chat" ) ? "-???\?-?\?-??.txt" : "-???\?-??.txt"));/* create search pattern*/
+
+	// Scanning a log directory with years of dated files is slow, and the
+	// answer only changes when saveHistory() writes a new file, which
+	// makeLogFileName() finds before we're asked again.
+	typedef std::map<std::string, std::string> old_log_map_t;
+	static old_log_map_t sOldLogFileNames;
+	std::string cache_key = directory + pattern;
+	old_log_map_t::const_iterator found = sOldLogFileNames.find(cache_key);
+	if (found != sOldLogFileNames.end())
+	{
+		return found->second;
+	}
+
 	//LL_INFOS("") << "Checking:" << directory << " for " << pattern << LL_ENDL;/* uncomment if you want to verify step, delete on commit */
 	std::vector<std::string> allfiles;
 
@@ -621,5 +634,6 @@ std::string LLLogChat::oldLogFileName(std::string filename)
         // thisfile is now the most recent version of the file.
     }
 	//LL_INFOS("") << "Reading:" << scanResult << LL_ENDL;/* uncomment if you want to verify step, delete on commit */
+	sOldLogFileNames[cache_key] = scanResult;
     return scanResult;
 }
@@ -0,0 +1,182 @@
+/** 
+ * @file llmemoryusage.cpp
+ * @brief Periodic samples of LLMemoryCounter totals
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmemoryusage.h"
+
+#include "llaudioengine.h"
+#include "llframetimer.h"
+#include "llimage.h"
+#include "llimagegl.h"
+#include "llinventorymodel.h"
+#include "llmemory.h"
+#include "llmemorycounter.h"
+#include "llprimitive.h"
+#include "llrendertarget.h"
+#include "llvertexbuffer.h"
+#include "llviewerinventory.h"
+#include "llvolumemgr.h"
+
+// Subsystems that already keep a total of their own
+
+static S64 sample_texture_raw()
+{
+	return LLImageRaw::sGlobalRawMemory;
+}
+
+static S64 sample_texture_formatted()
+{
+	return LLImageFormatted::sGlobalFormattedMemory;
+}
+
+static S64 sample_gl_textures()
+{
+	return LLImageGL::sGlobalTextureMemoryInBytes;
+}
+
+static S64 sample_render_targets()
+{
+	return LLRenderTarget::sBytesAllocated;
+}
+
+static S64 sample_vertex_buffers()
+{
+	return LLVertexBuffer::sAllocatedBytes;
+}
+
+// prims and meshes come from the same walk of the volume manager
+static U32 sPrimBytes = 0;
+static U32 sMeshBytes = 0;
+
+static S64 sample_prim_volumes()
+{
+	LLVolumeMgr* volume_mgr = LLPrimitive::getVolumeManager();
+	if (volume_mgr)
+	{
+		volume_mgr->getMemoryStats(sPrimBytes, sMeshBytes);
+	}
+	return sPrimBytes;
+}
+
+static S64 sample_mesh()
+{
+	return sMeshBytes;
+}
+
+static S64 sample_inventory()
+{
+	// the objects themselves; their names and descriptions are not counted
+	return (S64)gInventory.getItemCount() * sizeof(LLViewerInventoryItem)
+		+ (S64)gInventory.getCategoryCount() * sizeof(LLViewerInventoryCategory);
+}
+
+static S64 sample_audio()
+{
+	return gAudiop ? gAudiop->getBufferBytes() : 0;
+}
+
+static LLMemoryCounter MEM_TEXTURE_RAW("Texture Raw", &sample_texture_raw);
+static LLMemoryCounter MEM_TEXTURE_FORMATTED("Texture Formatted", &sample_texture_formatted);
+static LLMemoryCounter MEM_GL_TEXTURES("GL Textures", &sample_gl_textures);
+static LLMemoryCounter MEM_RENDER_TARGETS("Render Targets", &sample_render_targets);
+static LLMemoryCounter MEM_VERTEX_BUFFERS("Vertex Buffers", &sample_vertex_buffers);
+static LLMemoryCounter MEM_PRIM_VOLUMES("Prim Volumes", &sample_prim_volumes);
+static LLMemoryCounter MEM_MESH("Mesh", &sample_mesh);	// after MEM_PRIM_VOLUMES, which fills it
+static LLMemoryCounter MEM_INVENTORY("Inventory", &sample_inventory);
+static LLMemoryCounter MEM_AUDIO("Audio", &sample_audio);
+
+LLMemoryUsage::usage_list_t LLMemoryUsage::sUsage;
+U64 LLMemoryUsage::sProcessBytes = 0;
+S32 LLMemoryUsage::sSamples = 0;
+
+S64 LLMemoryUsage::Usage::getChange(S32 seconds) const
+{
+	seconds = llmin(seconds, sSamples - 1, (S32)HISTORY_SECONDS - 1);
+	if (seconds <= 0)
+	{
+		return 0;
+	}
+	S32 then = (sSamples - 1 - seconds) % HISTORY_SECONDS;
+	return mBytes - mHistory[then];
+}
+
+//static
+void LLMemoryUsage::idle()
+{
+	static LLFrameTimer sample_timer;
+
+	if (sSamples && sample_timer.getElapsedTimeF32() < 1.f)
+	{
+		return;
+	}
+	sample_timer.reset();
+	sample();
+}
+
+//static
+void LLMemoryUsage::sample()
+{
+	const LLMemoryCounter::counter_list_t& counters = LLMemoryCounter::getCounters();
+	if (sUsage.empty())
+	{
+		// counters are all statics, so the list is complete by now
+		sUsage.resize(counters.size());
+		for (U32 i = 0; i < counters.size(); i++)
+		{
+			sUsage[i].mCounter = counters[i];
+		}
+	}
+
+	S32 slot = sSamples % HISTORY_SECONDS;
+	for (usage_list_t::iterator iter = sUsage.begin(); iter != sUsage.end(); ++iter)
+	{
+		Usage& usage = *iter;
+		usage.mBytes = usage.mCounter->getBytes();
+		usage.mPeakBytes = llmax(usage.mPeakBytes, usage.mBytes);
+		usage.mHistory[slot] = usage.mBytes;
+	}
+	sProcessBytes = LLMemory::getCurrentRSS();
+	sSamples++;
+}
+
+//static
+void LLMemoryUsage::logUsage()
+{
+	const F64 MB = 1024.0 * 1024.0;
+
+	std::ostringstream out;
+	out << llformat("Memory usage: process %.1f MB", sProcessBytes / MB);
+	for (usage_list_t::const_iterator iter = sUsage.begin(); iter != sUsage.end(); ++iter)
+	{
+		out << llformat("\n  %-18s %8.1f MB  peak %8.1f MB  5 min %+8.1f MB",
+						iter->mCounter->getName(),
+						iter->mBytes / MB,
+						iter->mPeakBytes / MB,
+						iter->getChange(HISTORY_SECONDS) / MB);
+	}
+	LL_INFOS("Memory") << out.str() << LL_ENDL;
+}
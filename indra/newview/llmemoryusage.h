@@ -0,0 +1,69 @@
+/** 
+ * @file llmemoryusage.h
+ * @brief Periodic samples of LLMemoryCounter totals
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2010, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMEMORYUSAGE_H
+#define LL_LLMEMORYUSAGE_H
+
+#include <vector>
+
+class LLMemoryCounter;
+
+// Samples every LLMemoryCounter once a second, keeping a few minutes of
+// history for the memory usage floater.  logUsage() goes out with the
+// MEMORY line every MemoryLogFrequency seconds.
+class LLMemoryUsage
+{
+public:
+	enum { HISTORY_SECONDS = 300 };
+
+	struct Usage
+	{
+		const LLMemoryCounter*	mCounter;
+		S64						mBytes;
+		S64						mPeakBytes;
+		S64						mHistory[HISTORY_SECONDS];	// ring, one sample a second
+
+		// bytes gained over the last seconds, or since the first sample
+		S64 getChange(S32 seconds) const;
+	};
+	typedef std::vector<Usage> usage_list_t;
+
+	static void idle();	// call once a frame
+
+	static const usage_list_t& getUsage() { return sUsage; }
+	static U64 getProcessBytes() { return sProcessBytes; }
+
+	static void logUsage();
+
+private:
+	static void sample();
+
+	static usage_list_t	sUsage;
+	static U64			sProcessBytes;
+	static S32			sSamples;
+};
+
+#endif // LL_LLMEMORYUSAGE_H
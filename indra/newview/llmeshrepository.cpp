@@ -37,6 +37,8 @@
 #include "llcallbacklist.h"
 #include "llcurl.h"
 #include "lldatapacker.h"
+#include "lldiriterator.h"
+#include "llfile.h"
 #include "llfloatermodelpreview.h"
 #include "llfloaterperms.h"
 #include "lleconomy.h"
@@ -56,6 +58,7 @@
 #include "llviewertexturelist.h"
 #include "llvolume.h"
 #include "llvolumemgr.h"
+#include "llvoavatar.h"
 #include "llvovolume.h"
 #include "llworld.h"
 #include "material_codes.h"
@@ -76,6 +79,13 @@
 LLMeshRepository gMeshRepo;
 
 const U32 MAX_MESH_REQUESTS_PER_SECOND = 100;
+const F32 MESH_REQUEST_RESCORE_INTERVAL = 0.5f;		// seconds between re-ranking queued requests
+const F32 MESH_OFFSCREEN_SCORE_SCALE = 0.25f;		// objects out of view load after visible ones
+const std::string MESH_DECODED_CACHE_DIR = "meshfaces";
+const std::string MESH_DECODED_CACHE_EXT = ".lmf";
+
+static LLFastTimer::DeclareTimer FTM_MESH_THREAD_REQUESTS("Mesh Thread Requests");
+static LLFastTimer::DeclareTimer FTM_MESH_THREAD_CURL("Mesh Thread Curl");
 
 // Maximum mesh version to support.  Three least significant digits are reserved for the minor version, 
 // with major version changes indicating a format change that is not backwards compatible and should not
@@ -199,6 +209,7 @@ void get_vertex_buffer_from_mesh(LLCDMeshData& mesh, LLModel::PhysicsMesh& res,
 S32 LLMeshRepoThread::sActiveHeaderRequests = 0;
 S32 LLMeshRepoThread::sActiveLODRequests = 0;
 U32	LLMeshRepoThread::sMaxConcurrentRequests = 1;
+S64 LLMeshRepoThread::sDecodedCacheMaxBytes = 0;
 
 class LLMeshHeaderResponder : public LLCurl::Responder
 {
@@ -462,6 +473,7 @@ LLMeshRepoThread::LLMeshRepoThread()
 : LLThread("mesh repo") 
 { 
 	mWaiting = false;
+	mDecodedCacheBytes = 0;
 	mMutex = new LLMutex(NULL);
 	mHeaderMutex = new LLMutex(NULL);
 	mSignal = new LLCondition(NULL);
@@ -480,6 +492,9 @@ LLMeshRepoThread::~LLMeshRepoThread()
 void LLMeshRepoThread::run()
 {
 	mCurlRequest = new LLCurlRequest();
+	//keep one connection open per concurrent request
+	mCurlRequest->setConnectionPolicy(sMaxConcurrentRequests, false);
+	initDecodedCache();
 	LLCDResult res = LLConvexDecomposition::initThread();
 	if (res != LLCD_OK)
 	{
@@ -494,6 +509,7 @@ void LLMeshRepoThread::run()
 
 		if (!LLApp::isQuitting())
 		{
+			LLFastTimer::ThreadTimer t(FTM_MESH_THREAD_REQUESTS);
 			static U32 count = 0;
 
 			static F32 last_hundred = gFrameTimeSeconds;
@@ -512,13 +528,14 @@ void LLMeshRepoThread::run()
 				{
 					mMutex->lock();
 					LODRequest req = mLODReqQ.front();
-					mLODReqQ.pop();
+					mLODReqQ.pop_front();
 					LLMeshRepository::sLODProcessing--;
 					mMutex->unlock();
 					if (!fetchMeshLOD(req.mMeshParams, req.mLOD, count))//failed, resubmit
 					{
 						mMutex->lock();
-						mLODReqQ.push(req) ; 
+						pushLODRequest(req);
+						LLMeshRepository::sLODProcessing++;
 						mMutex->unlock();
 					}
 				}
@@ -530,12 +547,12 @@ void LLMeshRepoThread::run()
 				{
 					mMutex->lock();
 					HeaderRequest req = mHeaderReqQ.front();
-					mHeaderReqQ.pop();
+					mHeaderReqQ.pop_front();
 					mMutex->unlock();
 					if (!fetchMeshHeader(req.mMeshParams, count))//failed, resubmit
 					{
 						mMutex->lock();
-						mHeaderReqQ.push(req) ;
+						pushHeaderRequest(req);
 						mMutex->unlock();
 					}
 				}
@@ -580,6 +597,7 @@ void LLMeshRepoThread::run()
 				mPhysicsShapeRequests = incomplete;
 			}
 
+			LLFastTimer::ThreadTimer t_curl(FTM_MESH_THREAD_CURL);
 			mCurlRequest->process();
 		}
 	}
@@ -624,7 +642,7 @@ void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
 		LODRequest req(mesh_params, lod);
 		{
 			LLMutexLock lock(mMutex);
-			mLODReqQ.push(req);
+			pushLODRequest(req);
 			LLMeshRepository::sLODProcessing++;
 		}
 	}
@@ -642,12 +660,230 @@ void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
 		else
 		{ //if no header request is pending, fetch header
 			LLMutexLock lock(mMutex);
-			mHeaderReqQ.push(req);
+			pushHeaderRequest(req);
 			mPendingLOD[mesh_params].push_back(lod);
 		}
 	}
 }
 
+//static
+std::string LLMeshRepoThread::getDecodedCacheDir()
+{
+	return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, MESH_DECODED_CACHE_DIR);
+}
+
+std::string LLMeshRepoThread::getDecodedFileName(const decoded_key_t& key) const
+{
+	return getDecodedCacheDir() + gDirUtilp->getDirDelimiter() +
+		key.first.asString() + llformat("_%d", key.second) + MESH_DECODED_CACHE_EXT;
+}
+
+void LLMeshRepoThread::initDecodedCache()
+{
+	mDecodedMap.clear();
+	mDecodedLRU.clear();
+	mDecodedCacheBytes = 0;
+	if (sDecodedCacheMaxBytes <= 0)
+	{
+		return;
+	}
+
+	std::string dir = getDecodedCacheDir();
+	LLFile::mkdir(dir);
+
+	//rebuild the index from the files on disk, oldest first
+	typedef std::multimap<time_t, std::pair<decoded_key_t, S32> > time_map_t;
+	time_map_t files;
+	std::string filename;
+	LLDirIterator dir_iter(dir, "*" + MESH_DECODED_CACHE_EXT);
+	while (dir_iter.next(filename))
+	{
+		LLUUID mesh_id;
+		if (filename.size() < UUID_STR_LENGTH + 1 || filename[UUID_STR_LENGTH - 1] != '_' ||
+			!mesh_id.set(filename.substr(0, UUID_STR_LENGTH - 1), FALSE))
+		{
+			continue;
+		}
+		decoded_key_t key(mesh_id, atoi(filename.c_str() + UUID_STR_LENGTH));
+		std::string path = getDecodedFileName(key);
+		llstat stat_data;
+		S32 size = LLAPRFile::size(path);
+		if (size <= 0 || key.second < 0 || key.second >= LLModel::NUM_LODS || LLFile::stat(path, &stat_data) != 0)
+		{
+			continue;
+		}
+		files.insert(std::make_pair(stat_data.st_mtime, std::make_pair(key, size)));
+	}
+	for (time_map_t::iterator iter = files.begin(); iter != files.end(); ++iter)
+	{
+		addDecodedEntry(iter->second.first, iter->second.second);
+	}
+
+	LL_INFOS("MeshStreaming") << "Decoded mesh LODs: " << mDecodedMap.size() << " files, "
+							  << mDecodedCacheBytes / (1024 * 1024) << " MB of " << sDecodedCacheMaxBytes / (1024 * 1024) << " MB" << LL_ENDL;
+}
+
+bool LLMeshRepoThread::loadDecodedLOD(const LLVolumeParams& mesh_params, S32 lod)
+{
+	decoded_key_t key(mesh_params.getSculptID(), lod);
+	decoded_map_t::iterator iter = mDecodedMap.find(key);
+	if (iter == mDecodedMap.end())
+	{
+		return false;
+	}
+
+	S32 size = iter->second.first;
+	U8* buffer = (U8*) ll_aligned_malloc_16(size);
+	LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
+	bool success = LLAPRFile::readEx(getDecodedFileName(key), buffer, 0, size) == size &&
+				   volume->unpackRawVolumeFaces(buffer, size);
+	ll_aligned_free_16(buffer);
+
+	if (!success)
+	{
+		LL_DEBUGS("MeshStreaming") << "Discarding bad decoded LOD " << lod << " of mesh " << key.first << LL_ENDL;
+		removeDecodedEntry(key);
+		return false;
+	}
+
+	mDecodedLRU.splice(mDecodedLRU.end(), mDecodedLRU, iter->second.second);
+	LLMeshRepository::sCacheBytesRead += size;
+
+	volume->prepareVolumeFaces();
+
+	LoadedMesh mesh(volume, mesh_params, lod);
+	{
+		LLMutexLock lock(mMutex);
+		mLoadedQ.push(mesh);
+	}
+	return true;
+}
+
+void LLMeshRepoThread::saveDecodedLOD(const LLUUID& mesh_id, S32 lod, const LLVolume* volume)
+{
+	decoded_key_t key(mesh_id, lod);
+	if (sDecodedCacheMaxBytes <= 0 || mDecodedMap.find(key) != mDecodedMap.end())
+	{
+		return;
+	}
+
+	S32 size = volume->getRawVolumeFacesSize();
+	if (size > sDecodedCacheMaxBytes)
+	{
+		return;
+	}
+	U8* buffer = (U8*) ll_aligned_malloc_16(size);
+	volume->packRawVolumeFaces(buffer);
+	S32 written = LLAPRFile::writeEx(getDecodedFileName(key), buffer, 0, size);
+	ll_aligned_free_16(buffer);
+
+	if (written == size)
+	{
+		LLMeshRepository::sCacheBytesWritten += size;
+		addDecodedEntry(key, size);
+	}
+	else
+	{
+		LLAPRFile::remove(getDecodedFileName(key));
+	}
+}
+
+void LLMeshRepoThread::addDecodedEntry(const decoded_key_t& key, S32 size)
+{
+	decoded_lru_t::iterator lru = mDecodedLRU.insert(mDecodedLRU.end(), key);
+	mDecodedMap[key] = std::make_pair(size, lru);
+	mDecodedCacheBytes += size;
+
+	while (mDecodedCacheBytes > sDecodedCacheMaxBytes && mDecodedLRU.size() > 1)
+	{
+		removeDecodedEntry(mDecodedLRU.front());
+	}
+}
+
+void LLMeshRepoThread::removeDecodedEntry(const decoded_key_t& key)
+{
+	decoded_map_t::iterator iter = mDecodedMap.find(key);
+	if (iter != mDecodedMap.end())
+	{
+		LLAPRFile::remove(getDecodedFileName(key));
+		mDecodedCacheBytes -= iter->second.first;
+		mDecodedLRU.erase(iter->second.second);
+		mDecodedMap.erase(iter);
+	}
+}
+
+void LLMeshRepoThread::pushHeaderRequest(HeaderRequest req)
+{
+	score_map_t::const_iterator score = mRequestScores.find(req.mMeshParams.getSculptID());
+	req.mScore = score != mRequestScores.end() ? score->second : 0.f;
+	//after requests of equal score so equal requests stay in arrival order
+	mHeaderReqQ.insert(std::upper_bound(mHeaderReqQ.begin(), mHeaderReqQ.end(), req, CompareScoreGreater()), req);
+}
+
+void LLMeshRepoThread::pushLODRequest(LODRequest req)
+{
+	score_map_t::const_iterator score = mRequestScores.find(req.mMeshParams.getSculptID());
+	req.mScore = score != mRequestScores.end() ? score->second : 0.f;
+	mLODReqQ.insert(std::upper_bound(mLODReqQ.begin(), mLODReqQ.end(), req, CompareScoreGreater()), req);
+}
+
+void LLMeshRepoThread::updateRequestScores(const score_map_t& scores)
+{
+	mRequestScores = scores;
+
+	for (lod_req_queue_t::iterator iter = mLODReqQ.begin(); iter != mLODReqQ.end(); ++iter)
+	{
+		score_map_t::const_iterator score = scores.find(iter->mMeshParams.getSculptID());
+		iter->mScore = score != scores.end() ? score->second : 0.f;
+	}
+	std::stable_sort(mLODReqQ.begin(), mLODReqQ.end(), CompareScoreGreater());
+
+	for (header_req_queue_t::iterator iter = mHeaderReqQ.begin(); iter != mHeaderReqQ.end(); ++iter)
+	{
+		score_map_t::const_iterator score = scores.find(iter->mMeshParams.getSculptID());
+		iter->mScore = score != scores.end() ? score->second : 0.f;
+	}
+	std::stable_sort(mHeaderReqQ.begin(), mHeaderReqQ.end(), CompareScoreGreater());
+}
+
+void LLMeshRepoThread::cancelQueuedRequests(const std::set<LLUUID>& mesh_ids, std::vector<LODRequest>& cancelled)
+{ //requests already handed to curl are left to complete
+	for (lod_req_queue_t::iterator iter = mLODReqQ.begin(); iter != mLODReqQ.end(); )
+	{
+		if (mesh_ids.find(iter->mMeshParams.getSculptID()) != mesh_ids.end())
+		{
+			cancelled.push_back(*iter);
+			iter = mLODReqQ.erase(iter);
+			LLMeshRepository::sLODProcessing--;
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	for (header_req_queue_t::iterator iter = mHeaderReqQ.begin(); iter != mHeaderReqQ.end(); )
+	{
+		if (mesh_ids.find(iter->mMeshParams.getSculptID()) != mesh_ids.end())
+		{ //LODs waiting on this header go with it
+			pending_lod_map::iterator pending = mPendingLOD.find(iter->mMeshParams);
+			if (pending != mPendingLOD.end())
+			{
+				for (U32 i = 0; i < pending->second.size(); ++i)
+				{
+					cancelled.push_back(LODRequest(iter->mMeshParams, pending->second[i]));
+				}
+				mPendingLOD.erase(pending);
+			}
+			iter = mHeaderReqQ.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
 //static 
 std::string LLMeshRepoThread::constructUrl(LLUUID mesh_id)
 {
@@ -706,12 +942,11 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id)
 			{				
 				LLMeshRepository::sCacheBytesRead += size;
 				file.seek(offset);
-				U8* buffer = new U8[size];
-				file.read(buffer, size);
+				const U8* buffer = file.map(size);
 
 				//make sure buffer isn't all 0's by checking the first 1KB (reserved block but not written)
 				bool zero = true;
-				for (S32 i = 0; i < llmin(size, 1024) && zero; ++i)
+				for (S32 i = 0; buffer && i < llmin(size, 1024) && zero; ++i)
 				{
 					zero = buffer[i] > 0 ? false : true;
 				}
@@ -720,12 +955,9 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id)
 				{ //attempt to parse
 					if (skinInfoReceived(mesh_id, buffer, size))
 					{						
-						delete[] buffer;
 						return true;
 					}
 				}
-
-				delete[] buffer;
 			}
 
 			//reading from VFS failed for whatever reason, fetch from sim
@@ -788,12 +1020,11 @@ bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
 				LLMeshRepository::sCacheBytesRead += size;
 
 				file.seek(offset);
-				U8* buffer = new U8[size];
-				file.read(buffer, size);
+				const U8* buffer = file.map(size);
 
 				//make sure buffer isn't all 0's by checking the first 1KB (reserved block but not written)
 				bool zero = true;
-				for (S32 i = 0; i < llmin(size, 1024) && zero; ++i)
+				for (S32 i = 0; buffer && i < llmin(size, 1024) && zero; ++i)
 				{
 					zero = buffer[i] > 0 ? false : true;
 				}
@@ -802,12 +1033,9 @@ bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
 				{ //attempt to parse
 					if (decompositionReceived(mesh_id, buffer, size))
 					{
-						delete[] buffer;
 						return true;
 					}
 				}
-
-				delete[] buffer;
 			}
 
 			//reading from VFS failed for whatever reason, fetch from sim
@@ -869,12 +1097,11 @@ bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id)
 			{
 				LLMeshRepository::sCacheBytesRead += size;
 				file.seek(offset);
-				U8* buffer = new U8[size];
-				file.read(buffer, size);
+				const U8* buffer = file.map(size);
 
 				//make sure buffer isn't all 0's by checking the first 1KB (reserved block but not written)
 				bool zero = true;
-				for (S32 i = 0; i < llmin(size, 1024) && zero; ++i)
+				for (S32 i = 0; buffer && i < llmin(size, 1024) && zero; ++i)
 				{
 					zero = buffer[i] > 0 ? false : true;
 				}
@@ -883,12 +1110,9 @@ bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id)
 				{ //attempt to parse
 					if (physicsShapeReceived(mesh_id, buffer, size))
 					{
-						delete[] buffer;
 						return true;
 					}
 				}
-
-				delete[] buffer;
 			}
 
 			//reading from VFS failed for whatever reason, fetch from sim
@@ -991,18 +1215,23 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 		if (version <= MAX_MESH_VERSION && offset >= 0 && size > 0)
 		{
 
+			//already decoded faces skip both the VFS and the inflate and parse
+			if (loadDecodedLOD(mesh_params, lod))
+			{
+				return true;
+			}
+
 			//check VFS for mesh asset
 			LLVFile file(gVFS, mesh_id, LLAssetType::AT_MESH);
 			if (file.getSize() >= offset+size)
 			{
 				LLMeshRepository::sCacheBytesRead += size;
 				file.seek(offset);
-				U8* buffer = new U8[size];
-				file.read(buffer, size);
+				const U8* buffer = file.map(size);
 
 				//make sure buffer isn't all 0's by checking the first 1KB (reserved block but not written)
 				bool zero = true;
-				for (S32 i = 0; i < llmin(size, 1024) && zero; ++i)
+				for (S32 i = 0; buffer && i < llmin(size, 1024) && zero; ++i)
 				{
 					zero = buffer[i] > 0 ? false : true;
 				}
@@ -1011,12 +1240,9 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 				{ //attempt to parse
 					if (lodReceived(mesh_params, lod, buffer, size))
 					{
-						delete[] buffer;
 						return true;
 					}
 				}
-
-				delete[] buffer;
 			}
 
 			//reading from VFS failed for whatever reason, fetch from sim
@@ -1053,33 +1279,31 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 	return retval;
 }
 
-bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size)
+bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, const U8* data, S32 data_size)
 {
 	LLSD header;
 	
 	U32 header_size = 0;
 	if (data_size > 0)
 	{
-		std::string res_str((char*) data, data_size);
-
-		std::string deprecated_header("<? LLSD/Binary ?>");
+		static const std::string deprecated_header("<? LLSD/Binary ?>");
 
-		if (res_str.substr(0, deprecated_header.size()) == deprecated_header)
+		if (data_size > (S32) deprecated_header.size() &&
+			deprecated_header.compare(0, deprecated_header.size(), (const char*) data, deprecated_header.size()) == 0)
 		{
-			res_str = res_str.substr(deprecated_header.size()+1, data_size);
 			header_size = deprecated_header.size()+1;
+			data += header_size;
+			data_size -= header_size;
 		}
-		data_size = res_str.size();
 
-		std::istringstream stream(res_str);
-
-		if (!LLSDSerialize::fromBinary(header, stream, data_size))
+		S32 bytes_read = 0;
+		if (LLSDSerialize::fromBinaryBuffer(header, data, data_size, &bytes_read) <= 0)
 		{
 			llwarns << "Mesh header parse error.  Not a valid mesh asset!" << llendl;
 			return false;
 		}
 
-		header_size += stream.tellg();
+		header_size += bytes_read;
 	}
 	else
 	{
@@ -1105,7 +1329,7 @@ bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* dat
 			for (U32 i = 0; i < iter->second.size(); ++i)
 			{
 				LODRequest req(mesh_params, iter->second[i]);
-				mLODReqQ.push(req);
+				pushLODRequest(req);
 				LLMeshRepository::sLODProcessing++;
 			}
 		}
@@ -1115,7 +1339,7 @@ bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* dat
 	return true;
 }
 
-bool LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
+bool LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, const U8* data, S32 data_size)
 {
 	LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
 	std::string mesh_string((char*) data, data_size);
@@ -1125,6 +1349,11 @@ bool LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U
 	{
 		if (volume->getNumFaces() > 0)
 		{
+			saveDecodedLOD(mesh_params.getSculptID(), lod, volume);
+
+			//do the per-face work here rather than on the main thread, which just swaps the faces in
+			volume->prepareVolumeFaces();
+
 			LoadedMesh mesh(volume, mesh_params, lod);
 			{
 				LLMutexLock lock(mMutex);
@@ -1137,7 +1366,7 @@ bool LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U
 	return false;
 }
 
-bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size)
+bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, const U8* data, S32 data_size)
 {
 	LLSD skin;
 
@@ -1165,7 +1394,7 @@ bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 dat
 	return true;
 }
 
-bool LLMeshRepoThread::decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size)
+bool LLMeshRepoThread::decompositionReceived(const LLUUID& mesh_id, const U8* data, S32 data_size)
 {
 	LLSD decomp;
 
@@ -1191,7 +1420,7 @@ bool LLMeshRepoThread::decompositionReceived(const LLUUID& mesh_id, U8* data, S3
 	return true;
 }
 
-bool LLMeshRepoThread::physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size)
+bool LLMeshRepoThread::physicsShapeReceived(const LLUUID& mesh_id, const U8* data, S32 data_size)
 {
 	LLSD physics_shape;
 
@@ -1265,6 +1494,7 @@ LLMeshUploadThread::LLMeshUploadThread(LLMeshUploadThread::instance_list& data,
 	mMutex = new LLMutex(NULL);
 	mCurlRequest = NULL;
 	mPendingUploads = 0;
+	mPendingDecomps = 0;
 	mFinished = false;
 	mOrigin = gAgent.getPositionAgent();
 	mHost = gAgent.getRegionHost();
@@ -1278,7 +1508,7 @@ LLMeshUploadThread::LLMeshUploadThread(LLMeshUploadThread::instance_list& data,
 
 LLMeshUploadThread::~LLMeshUploadThread()
 {
-
+	finishTextureEncodes();
 }
 
 LLMeshUploadThread::DecompRequest::DecompRequest(LLModel* mdl, LLModel* base_model, LLMeshUploadThread* thread)
@@ -1291,21 +1521,92 @@ LLMeshUploadThread::DecompRequest::DecompRequest(LLModel* mdl, LLModel* base_mod
 	
 	//copy out positions and indices
 	assignData(mdl) ;	
+}
 
-	mThread->mFinalDecomp = this;
-	mThread->mPhysicsComplete = false;
+LLMeshUploadThread::TextureEncoder::TextureEncoder(LLMeshUploadThread* thread)
+: LLThread("mesh upload texture encode"),
+  mThread(thread)
+{
 }
 
-void LLMeshUploadThread::DecompRequest::completed()
+void LLMeshUploadThread::TextureEncoder::run()
 {
-	if (mThread->mFinalDecomp == this)
+	while (!mThread->isDiscarded())
 	{
-		mThread->mPhysicsComplete = true;
+		LLPointer<LLViewerFetchedTexture> texture;
+		{
+			LLMutexLock lock(mThread->mMutex);
+			if (mThread->mTextureEncodeQueue.empty())
+			{
+				break;
+			}
+			texture = mThread->mTextureEncodeQueue.back();
+			mThread->mTextureEncodeQueue.pop_back();
+		}
+
+		LLPointer<LLImageJ2C> upload_file = LLViewerTextureList::convertToUploadFile(texture->getSavedRawImage());
+
+		{
+			LLMutexLock lock(mThread->mMutex);
+			mThread->mEncodedTextures[texture] = upload_file;
+		}
+	}
+}
+
+void LLMeshUploadThread::startTextureEncodes()
+{
+	if (!mUploadTextures)
+	{
+		return;
+	}
+
+	std::set<LLViewerFetchedTexture*> textures;
+	for (instance_map::iterator iter = mInstance.begin(); iter != mInstance.end(); ++iter)
+	{
+		LLModel* base_model = iter->first;
+		for (instance_list::iterator instance_iter = iter->second.begin(); instance_iter != iter->second.end(); ++instance_iter)
+		{
+			S32 end = llmin((S32)base_model->mMaterialList.size(), base_model->getNumVolumeFaces());
+			for (S32 face_num = 0; face_num < end; face_num++)
+			{
+				LLViewerFetchedTexture* texture = instance_iter->mMaterial[base_model->mMaterialList[face_num]].mDiffuseMap.get();
+				if (texture && texture->hasSavedRawImage() && textures.insert(texture).second)
+				{
+					mTextureEncodeQueue.push_back(texture);
+				}
+			}
+		}
+	}
+
+	U32 num_encoders = llmin((U32) mTextureEncodeQueue.size(), llclamp(gSavedSettings.getU32("MeshUploadEncodeThreads"), (U32) 1, (U32) 8));
+	for (U32 i = 0; i < num_encoders; ++i)
+	{
+		TextureEncoder* encoder = new TextureEncoder(this);
+		mTextureEncoders.push_back(encoder);
+		encoder->start();
 	}
+}
 
+void LLMeshUploadThread::finishTextureEncodes()
+{
+	for (U32 i = 0; i < mTextureEncoders.size(); ++i)
+	{
+		while (!mTextureEncoders[i]->isStopped())
+		{
+			apr_sleep(10000);
+		}
+		delete mTextureEncoders[i];
+	}
+	mTextureEncoders.clear();
+}
+
+void LLMeshUploadThread::DecompRequest::completed()
+{
 	llassert(mHull.size() == 1);
 	
 	mThread->mHullMap[mBaseModel] = mHull[0];
+
+	mThread->mPendingDecomps--;
 }
 
 //called in the main thread.
@@ -1431,7 +1732,6 @@ void LLMeshUploadThread::wholeModelToLLSD(LLSD& dest, bool include_textures)
 				mUploadSkin,
 				mUploadJoints);
 
-			data.mAssetData = ostr.str();
 			std::string str = ostr.str();
 
 			res["mesh_list"][mesh_num] = LLSD::Binary(str.begin(),str.end()); 
@@ -1481,24 +1781,24 @@ void LLMeshUploadThread::wholeModelToLLSD(LLSD& dest, bool include_textures)
 					textures.insert(texture);
 				}
 
-				std::stringstream texture_str;
-				if (texture != NULL && include_textures && mUploadTextures)
-				{
-					if(texture->hasSavedRawImage())
-					{											
-						LLPointer<LLImageJ2C> upload_file =
-							LLViewerTextureList::convertToUploadFile(texture->getSavedRawImage());
-						texture_str.write((const char*) upload_file->getData(), upload_file->getDataSize());
-					}
-				}
-
 				if (texture != NULL &&
 					mUploadTextures &&
 					texture_index.find(texture) == texture_index.end())
 				{
+					LLSD::Binary texture_data;
+					if (include_textures)
+					{ //encoded by startTextureEncodes, drop our copy once it's in the body
+						encoded_texture_map::iterator encoded = mEncodedTextures.find(texture);
+						if (encoded != mEncodedTextures.end() && encoded->second.notNull())
+						{
+							const U8* data = encoded->second->getData();
+							texture_data.assign(data, data + encoded->second->getDataSize());
+							encoded->second = NULL;
+						}
+					}
+
 					texture_index[texture] = texture_num;
-					std::string str = texture_str.str();
-					res["texture_list"][texture_num] = LLSD::Binary(str.begin(),str.end());
+					res["texture_list"][texture_num] = texture_data;
 					texture_num++;
 				}
 
@@ -1573,6 +1873,7 @@ void LLMeshUploadThread::generateHulls()
 		DecompRequest* request = new DecompRequest(physics, data.mBaseModel, this);
 		if(request->isValid())
 		{
+			mPendingDecomps++;
 			gMeshRepo.mDecompThread->submitRequest(request);
 			has_valid_requests = true ;
 		}
@@ -1580,7 +1881,7 @@ void LLMeshUploadThread::generateHulls()
 		
 	if(has_valid_requests)
 	{
-		while (!mPhysicsComplete)
+		while (mPendingDecomps > 0)
 		{
 			apr_sleep(100);
 		}
@@ -1597,10 +1898,14 @@ void LLMeshUploadThread::doWholeModelUpload()
 	}
 	else
 	{
+		//textures encode while the hulls are generated
+		startTextureEncodes();
 		generateHulls();
+		finishTextureEncodes();
 
 		LLSD full_model_data;
 		wholeModelToLLSD(full_model_data, true);
+		mEncodedTextures.clear();
 		LLSD body = full_model_data["asset_resources"];
 		dump_llsd_to_file(body,make_dump_name("whole_model_body_",dump_num));
 		LLCurlRequest::headers_t headers;
@@ -2030,7 +2335,7 @@ void LLMeshHeaderResponder::completedRaw(U32 status, const std::string& reason,
 			LLMeshRepository::sHTTPRetryCount++;
 			LLMeshRepoThread::HeaderRequest req(mMeshParams);
 			LLMutexLock lock(gMeshRepo.mThread->mMutex);
-			gMeshRepo.mThread->mHeaderReqQ.push(req);
+			gMeshRepo.mThread->pushHeaderRequest(req);
 
 			return;
 		}
@@ -2130,6 +2435,7 @@ void LLMeshRepository::init()
 	
 	LLConvexDecomposition::getInstance()->initSystem();
 
+	LLPhysicsDecomp::sNumThreads = llclamp(gSavedSettings.getU32("MeshDecompositionThreads"), (U32) 1, (U32) 8);
 	mDecompThread = new LLPhysicsDecomp();
 	mDecompThread->start();
 
@@ -2140,6 +2446,8 @@ void LLMeshRepository::init()
 
 	
 	
+	LLMeshRepoThread::sMaxConcurrentRequests = gSavedSettings.getU32("MeshMaxConcurrentRequests");
+	LLMeshRepoThread::sDecodedCacheMaxBytes = (S64)gSavedSettings.getU32("MeshDecodedCacheSize") * 1024 * 1024;
 	mThread = new LLMeshRepoThread();
 	mThread->start();
 }
@@ -2224,6 +2532,8 @@ S32 LLMeshRepository::loadMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_para
 		if (iter != mLoadingMeshes[detail].end())
 		{ //request pending for this mesh, append volume id to list
 			iter->second.insert(vobj->getID());
+			//someone is waiting on it now
+			mPrefetchMeshes[detail].erase(mesh_params);
 		}
 		else
 		{
@@ -2288,6 +2598,35 @@ S32 LLMeshRepository::loadMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_para
 	return detail;
 }
 
+void LLMeshRepository::prefetchMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_params, S32 detail)
+{
+	detail = getActualMeshLOD(mesh_params, detail);
+	if (detail < 0 || detail > 3)
+	{
+		return;
+	}
+
+	LLVolumeLODGroup* group = LLPrimitive::getVolumeManager()->getGroup(mesh_params);
+	if (group)
+	{
+		LLVolume* lod = group->getLOD(detail);
+		if (lod && lod->isMeshAssetLoaded())
+		{ //already have it
+			return;
+		}
+	}
+
+	LLMutexLock lock(mMeshMutex);
+	if (mLoadingMeshes[detail].find(mesh_params) == mLoadingMeshes[detail].end())
+	{
+		//the volume id keeps the request alive and ranked while the object is around
+		mLoadingMeshes[detail][mesh_params].insert(vobj->getID());
+		mPrefetchMeshes[detail].insert(mesh_params);
+		mPendingRequests.push_back(LLMeshRepoThread::LODRequest(mesh_params, detail));
+		LLMeshRepository::sLODPending++;
+	}
+}
+
 void LLMeshRepository::notifyLoadedMeshes()
 { //called from main thread
 
@@ -2399,45 +2738,11 @@ void LLMeshRepository::notifyLoadedMeshes()
 
 		S32 push_count = LLMeshRepoThread::sMaxConcurrentRequests-(LLMeshRepoThread::sActiveHeaderRequests+LLMeshRepoThread::sActiveLODRequests);
 
-		if (push_count > 0)
+		static LLFrameTimer rescore_timer;
+		if (push_count > 0 || rescore_timer.getElapsedTimeF32() > MESH_REQUEST_RESCORE_INTERVAL)
 		{
-			//calculate "score" for pending requests
-
-			//create score map
-			std::map<LLUUID, F32> score_map;
-
-			for (U32 i = 0; i < 4; ++i)
-			{
-				for (mesh_load_map::iterator iter = mLoadingMeshes[i].begin();  iter != mLoadingMeshes[i].end(); ++iter)
-				{
-					F32 max_score = 0.f;
-					for (std::set<LLUUID>::iterator obj_iter = iter->second.begin(); obj_iter != iter->second.end(); ++obj_iter)
-					{
-						LLViewerObject* object = gObjectList.findObject(*obj_iter);
-
-						if (object)
-						{
-							LLDrawable* drawable = object->mDrawable;
-							if (drawable)
-							{
-								F32 cur_score = drawable->getRadius()/llmax(drawable->mDistanceWRTCamera, 1.f);
-								max_score = llmax(max_score, cur_score);
-							}
-						}
-					}
-				
-					score_map[iter->first.getSculptID()] = max_score;
-				}
-			}
-
-			//set "score" for pending requests
-			for (std::vector<LLMeshRepoThread::LODRequest>::iterator iter = mPendingRequests.begin(); iter != mPendingRequests.end(); ++iter)
-			{
-				iter->mScore = score_map[iter->mMeshParams.getSculptID()];
-			}
-
-			//sort by "score"
-			std::sort(mPendingRequests.begin(), mPendingRequests.end(), LLMeshRepoThread::CompareScoreGreater());
+			rescore_timer.reset();
+			updatePendingRequests();
 
 			while (!mPendingRequests.empty() && push_count > 0)
 			{
@@ -2476,6 +2781,93 @@ void LLMeshRepository::notifyLoadedMeshes()
 	mThread->mSignal->signal();
 }
 
+void LLMeshRepository::updatePendingRequests()
+{
+	//calculate "score" for loading meshes: the largest on-screen size of
+	//the objects waiting on them, and whether any of them is still around
+	LLMeshRepoThread::score_map_t score_map;
+	std::set<LLUUID> live;
+
+	for (U32 i = 0; i < 4; ++i)
+	{
+		for (mesh_load_map::iterator iter = mLoadingMeshes[i].begin();  iter != mLoadingMeshes[i].end(); ++iter)
+		{
+			const LLUUID& mesh_id = iter->first.getSculptID();
+			F32 max_score = 0.f;
+			for (std::set<LLUUID>::iterator obj_iter = iter->second.begin(); obj_iter != iter->second.end(); ++obj_iter)
+			{
+				LLViewerObject* object = gObjectList.findObject(*obj_iter);
+
+				if (object && !object->isDead())
+				{
+					live.insert(mesh_id);
+					LLDrawable* drawable = object->mDrawable;
+					if (drawable)
+					{
+						F32 cur_score = drawable->getRadius()/llmax(drawable->mDistanceWRTCamera, 1.f);
+						if (!drawable->isVisible())
+						{
+							cur_score *= MESH_OFFSCREEN_SCORE_SCALE;
+						}
+						max_score = llmax(max_score, cur_score);
+					}
+				}
+			}
+
+			F32& score = score_map[mesh_id];
+			score = llmax(score, max_score);
+		}
+	}
+
+	//drop the requests not yet sent for meshes no object is waiting on any more
+	std::set<LLUUID> orphans;
+	for (LLMeshRepoThread::score_map_t::iterator iter = score_map.begin(); iter != score_map.end(); ++iter)
+	{
+		if (live.find(iter->first) == live.end())
+		{
+			orphans.insert(iter->first);
+		}
+	}
+
+	if (!orphans.empty())
+	{
+		std::vector<LLMeshRepoThread::LODRequest> cancelled;
+		for (std::vector<LLMeshRepoThread::LODRequest>::iterator iter = mPendingRequests.begin(); iter != mPendingRequests.end(); )
+		{
+			if (orphans.find(iter->mMeshParams.getSculptID()) != orphans.end())
+			{
+				cancelled.push_back(*iter);
+				iter = mPendingRequests.erase(iter);
+				LLMeshRepository::sLODPending--;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+		mThread->cancelQueuedRequests(orphans, cancelled);
+
+		//a later loadMesh() for the same mesh starts over
+		for (std::vector<LLMeshRepoThread::LODRequest>::iterator iter = cancelled.begin(); iter != cancelled.end(); ++iter)
+		{
+			mLoadingMeshes[iter->mLOD].erase(iter->mMeshParams);
+			mPrefetchMeshes[iter->mLOD].erase(iter->mMeshParams);
+		}
+	}
+
+	//set "score" for pending requests
+	for (std::vector<LLMeshRepoThread::LODRequest>::iterator iter = mPendingRequests.begin(); iter != mPendingRequests.end(); ++iter)
+	{
+		iter->mScore = score_map[iter->mMeshParams.getSculptID()];
+	}
+
+	//sort by "score"
+	std::sort(mPendingRequests.begin(), mPendingRequests.end(), LLMeshRepoThread::CompareScoreGreater());
+
+	//and re-rank what the repo thread has queued
+	mThread->updateRequestScores(score_map);
+}
+
 void LLMeshRepository::notifySkinInfoReceived(LLMeshSkinInfo& info)
 {
 	mSkinMap[info.mMeshID] = info;
@@ -2488,6 +2880,11 @@ void LLMeshRepository::notifySkinInfoReceived(LLMeshSkinInfo& info)
 			LLVOVolume* vobj = (LLVOVolume*) gObjectList.findObject(*obj_id);
 			if (vobj)
 			{
+				LLVOAvatar* avatar = vobj->getAvatar();
+				if (avatar)
+				{
+					avatar->recordRezStage(LLVOAvatar::REZ_SKIN_INFO_LOADED);
+				}
 				vobj->notifyMeshLoaded();
 			}
 		}
@@ -2531,7 +2928,8 @@ void LLMeshRepository::notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVol
 			LLVolume* sys_volume = LLPrimitive::getVolumeManager()->refVolume(mesh_params, detail);
 			if (sys_volume)
 			{
-				sys_volume->copyVolumeFaces(volume);
+				//volume is discarded after this, so take its faces instead of copying them
+				sys_volume->swapVolumeFaces(volume);
 				sys_volume->setMeshAssetLoaded(TRUE);
 				LLPrimitive::getVolumeManager()->unrefVolume(sys_volume);
 			}
@@ -2541,13 +2939,22 @@ void LLMeshRepository::notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVol
 			}
 		}
 
-		//notify waiting LLVOVolume instances that their requested mesh is available
-		for (std::set<LLUUID>::iterator vobj_iter = obj_iter->second.begin(); vobj_iter != obj_iter->second.end(); ++vobj_iter)
+		//notify waiting LLVOVolume instances that their requested mesh is available,
+		//prefetched LODs are picked up when the objects switch to them
+		if (mPrefetchMeshes[detail].erase(mesh_params) == 0)
 		{
-			LLVOVolume* vobj = (LLVOVolume*) gObjectList.findObject(*vobj_iter);
-			if (vobj)
+			for (std::set<LLUUID>::iterator vobj_iter = obj_iter->second.begin(); vobj_iter != obj_iter->second.end(); ++vobj_iter)
 			{
-				vobj->notifyMeshLoaded();
+				LLVOVolume* vobj = (LLVOVolume*) gObjectList.findObject(*vobj_iter);
+				if (vobj)
+				{
+					LLVOAvatar* avatar = vobj->getAvatar();
+					if (avatar && vobj->isMesh())
+					{
+						avatar->recordRezStage(LLVOAvatar::REZ_RIGGED_MESH_LOADED);
+					}
+					vobj->notifyMeshLoaded();
+				}
 			}
 		}
 		
@@ -2581,6 +2988,7 @@ void LLMeshRepository::notifyMeshUnavailable(const LLVolumeParams& mesh_params,
 		}
 		
 		mLoadingMeshes[lod].erase(mesh_params);
+		mPrefetchMeshes[lod].erase(mesh_params);
 	}
 }
 
@@ -2943,12 +3351,20 @@ F32 LLMeshRepository::getStreamingCost(LLSD& header, F32 radius, S32* bytes, S32
 }
 
 
+//static
+U32 LLPhysicsDecomp::sNumThreads = 1;
+
+//request being decomposed on the current thread, for llcdCallback
+static ll_thread_local LLPhysicsDecomp::Request* sCurDecompRequest = NULL;
+
 LLPhysicsDecomp::LLPhysicsDecomp()
 : LLThread("Physics Decomp")
 {
 	mInited = false;
 	mQuitting = false;
 	mDone = false;
+	mRequestsDone = 0;
+	mRequestsTotal = 0;
 
 	mSignal = new LLCondition(NULL);
 	mMutex = new LLMutex(NULL);
@@ -2969,7 +3385,9 @@ void LLPhysicsDecomp::shutdown()
 	if (mSignal)
 	{
 		mQuitting = true;
-		mSignal->signal();
+		mSignal->lock();
+		mSignal->broadcast();
+		mSignal->unlock();
 
 		while (!isStopped())
 		{
@@ -2980,35 +3398,59 @@ void LLPhysicsDecomp::shutdown()
 
 void LLPhysicsDecomp::submitRequest(LLPhysicsDecomp::Request* request)
 {
-	LLMutexLock lock(mMutex);
-	mRequestQ.push(request);
+	{
+		LLMutexLock lock(mMutex);
+		mRequestQ.push_back(request);
+		mRequestsTotal++;
+	}
+
+	mSignal->lock();
 	mSignal->signal();
+	mSignal->unlock();
+}
+
+void LLPhysicsDecomp::cancel()
+{
+	LLMutexLock lock(mMutex);
+	while (!mRequestQ.empty())
+	{
+		mCompletedQ.push(mRequestQ.front());
+		mRequestQ.pop_front();
+		mRequestsDone++;
+	}
+}
+
+void LLPhysicsDecomp::getProgress(S32& done, S32& total)
+{
+	LLMutexLock lock(mMutex);
+	done = mRequestsDone;
+	total = mRequestsTotal;
 }
 
 //static
 S32 LLPhysicsDecomp::llcdCallback(const char* status, S32 p1, S32 p2)
 {	
-	if (gMeshRepo.mDecompThread && gMeshRepo.mDecompThread->mCurRequest.notNull())
+	if (sCurDecompRequest)
 	{
-		return gMeshRepo.mDecompThread->mCurRequest->statusCallback(status, p1, p2);
+		return sCurDecompRequest->statusCallback(status, p1, p2);
 	}
 
 	return 1;
 }
 
-void LLPhysicsDecomp::setMeshData(LLCDMeshData& mesh, bool vertex_based)
+void LLPhysicsDecomp::setMeshData(Request* request, LLCDMeshData& mesh, bool vertex_based)
 {
-	mesh.mVertexBase = mCurRequest->mPositions[0].mV;
+	mesh.mVertexBase = request->mPositions[0].mV;
 	mesh.mVertexStrideBytes = 12;
-	mesh.mNumVertices = mCurRequest->mPositions.size();
+	mesh.mNumVertices = request->mPositions.size();
 
 	if(!vertex_based)
 	{
 		mesh.mIndexType = LLCDMeshData::INT_16;
-		mesh.mIndexBase = &(mCurRequest->mIndices[0]);
+		mesh.mIndexBase = &(request->mIndices[0]);
 		mesh.mIndexStrideBytes = 6;
 	
-		mesh.mNumTriangles = mCurRequest->mIndices.size()/3;
+		mesh.mNumTriangles = request->mIndices.size()/3;
 	}
 
 	if ((vertex_based || mesh.mNumTriangles > 0) && mesh.mNumVertices > 2)
@@ -3026,10 +3468,11 @@ void LLPhysicsDecomp::setMeshData(LLCDMeshData& mesh, bool vertex_based)
 	}
 }
 
-void LLPhysicsDecomp::doDecomposition()
+void LLPhysicsDecomp::doDecomposition(Request* request)
 {
 	LLCDMeshData mesh;
-	S32 stage = mStageID[mCurRequest->mStage];
+	std::map<std::string, S32>::const_iterator stage_iter = mStageID.find(request->mStage);
+	S32 stage = stage_iter != mStageID.end() ? stage_iter->second : 0;
 
 	if (LLConvexDecomposition::getInstance() == NULL)
 	{
@@ -3040,37 +3483,24 @@ void LLPhysicsDecomp::doDecomposition()
 	//load data intoLLCD
 	if (stage == 0)
 	{
-		setMeshData(mesh, false);
+		setMeshData(request, mesh, false);
 	}
 		
-	//build parameter map
-	std::map<std::string, const LLCDParam*> param_map;
-
-	static const LLCDParam* params = NULL;
-	static S32 param_count = 0;
-	if (!params)
-	{
-		param_count = LLConvexDecomposition::getInstance()->getParameters(&params);
-	}
-	
-	for (S32 i = 0; i < param_count; ++i)
-	{
-		param_map[params[i].mName] = params+i;
-	}
-
 	//set parameter values
-	for (decomp_params::iterator iter = mCurRequest->mParams.begin(); iter != mCurRequest->mParams.end(); ++iter)
+	for (decomp_params::iterator iter = request->mParams.begin(); iter != request->mParams.end(); ++iter)
 	{
 		const std::string& name = iter->first;
 		const LLSD& value = iter->second;
 
-		const LLCDParam* param = param_map[name];
+		std::map<std::string, const LLCDParam*>::const_iterator param_iter = mParamMap.find(name);
 
-		if (param == NULL)
+		if (param_iter == mParamMap.end())
 		{ //couldn't find valid parameter
 			continue;
 		}
 
+		const LLCDParam* param = param_iter->second;
+
 		U32 ret = LLCD_OK;
 
 		if (param->mType == LLCDParam::LLCD_FLOAT)
@@ -3088,7 +3518,7 @@ void LLPhysicsDecomp::doDecomposition()
 		}
 	}
 
-	mCurRequest->setStatusMessage("Executing.");
+	request->setStatusMessage("Executing.");
 
 	LLCDResult ret = LLCD_OK;
 	
@@ -3102,16 +3532,16 @@ void LLPhysicsDecomp::doDecomposition()
 		llwarns << "Convex Decomposition thread valid but could not execute stage " << stage << llendl;
 		LLMutexLock lock(mMutex);
 
-		mCurRequest->mHull.clear();
-		mCurRequest->mHullMesh.clear();
+		request->mHull.clear();
+		request->mHullMesh.clear();
 
-		mCurRequest->setStatusMessage("FAIL");
+		request->setStatusMessage("FAIL");
 		
-		completeCurrent();
+		completeRequest(request);
 	}
 	else
 	{
-		mCurRequest->setStatusMessage("Reading results");
+		request->setStatusMessage("Reading results");
 
 		S32 num_hulls =0;
 		if (LLConvexDecomposition::getInstance() != NULL)
@@ -3121,11 +3551,11 @@ void LLPhysicsDecomp::doDecomposition()
 		
 		{
 			LLMutexLock lock(mMutex);
-			mCurRequest->mHull.clear();
-			mCurRequest->mHull.resize(num_hulls);
+			request->mHull.clear();
+			request->mHull.resize(num_hulls);
 
-			mCurRequest->mHullMesh.clear();
-			mCurRequest->mHullMesh.resize(num_hulls);
+			request->mHullMesh.clear();
+			request->mHullMesh.resize(num_hulls);
 		}
 
 		for (S32 i = 0; i < num_hulls; ++i)
@@ -3148,27 +3578,27 @@ void LLPhysicsDecomp::doDecomposition()
 			// if LLConvexDecomposition is a stub, num_hulls should have been set to 0 above, and we should not reach this code
 			LLConvexDecomposition::getInstance()->getMeshFromStage(stage, i, &mesh);
 
-			get_vertex_buffer_from_mesh(mesh, mCurRequest->mHullMesh[i]);
+			get_vertex_buffer_from_mesh(mesh, request->mHullMesh[i]);
 			
 			{
 				LLMutexLock lock(mMutex);
-				mCurRequest->mHull[i] = p;
+				request->mHull[i] = p;
 			}
 		}
 	
 		{
 			LLMutexLock lock(mMutex);
-			mCurRequest->setStatusMessage("FAIL");
-			completeCurrent();						
+			request->setStatusMessage("FAIL");
+			completeRequest(request);						
 		}
 	}
 }
 
-void LLPhysicsDecomp::completeCurrent()
+void LLPhysicsDecomp::completeRequest(Request* request)
 {
 	LLMutexLock lock(mMutex);
-	mCompletedQ.push(mCurRequest);
-	mCurRequest = NULL;
+	mCompletedQ.push(request);
+	mRequestsDone++;
 }
 
 void LLPhysicsDecomp::notifyCompleted()
@@ -3182,6 +3612,12 @@ void LLPhysicsDecomp::notifyCompleted()
 			req->completed();
 			mCompletedQ.pop();
 		}
+
+		if (mRequestQ.empty() && mActiveDecomps.empty())
+		{ //start counting progress over with the next batch
+			mRequestsDone = 0;
+			mRequestsTotal = 0;
+		}
 	}
 }
 
@@ -3213,7 +3649,7 @@ void make_box(LLPhysicsDecomp::Request * request)
 }
 
 
-void LLPhysicsDecomp::doDecompositionSingleHull()
+void LLPhysicsDecomp::doDecompositionSingleHull(Request* request)
 {
 	LLConvexDecomposition* decomp = LLConvexDecomposition::getInstance();
 
@@ -3225,21 +3661,21 @@ void LLPhysicsDecomp::doDecompositionSingleHull()
 	
 	LLCDMeshData mesh;	
 
-	setMeshData(mesh, true);
+	setMeshData(request, mesh, true);
 
 	LLCDResult ret = decomp->buildSingleHull() ;
 	if(ret)
 	{
 		llwarns << "Could not execute decomposition stage when attempting to create single hull." << llendl;
-		make_box(mCurRequest);
+		make_box(request);
 	}
 	else
 	{
 		{
 			LLMutexLock lock(mMutex);
-			mCurRequest->mHull.clear();
-			mCurRequest->mHull.resize(1);
-			mCurRequest->mHullMesh.clear();
+			request->mHull.clear();
+			request->mHull.resize(1);
+			request->mHullMesh.clear();
 		}
 
 		std::vector<LLVector3> p;
@@ -3259,12 +3695,12 @@ void LLPhysicsDecomp::doDecompositionSingleHull()
 					
 		{
 			LLMutexLock lock(mMutex);
-			mCurRequest->mHull[0] = p;
+			request->mHull[0] = p;
 		}
 	}		
 
 	{
-		completeCurrent();
+		completeRequest(request);
 		
 	}
 }
@@ -3282,7 +3718,6 @@ void LLPhysicsDecomp::run()
 	}
 
 	decomp->initThread();
-	mInited = true;
 
 	static const LLCDStageData* stages = NULL;
 	static S32 num_stages = 0;
@@ -3297,43 +3732,126 @@ void LLPhysicsDecomp::run()
 		mStageID[stages[i].mName] = i;
 	}
 
+	const LLCDParam* params = NULL;
+	S32 param_count = decomp->getParameters(&params);
+	for (S32 i = 0; i < param_count; ++i)
+	{
+		mParamMap[params[i].mName] = params+i;
+	}
+
+	//stage and parameter maps are read only from here on, so the workers can share them
+	for (U32 i = 1; i < sNumThreads; ++i)
+	{
+		Worker* worker = new Worker(this);
+		mWorkers.push_back(worker);
+		worker->start();
+	}
+
+	mInited = true;
+
+	processRequests();
+
+	for (U32 i = 0; i < mWorkers.size(); ++i)
+	{
+		while (!mWorkers[i]->isStopped())
+		{
+			apr_sleep(10);
+		}
+		delete mWorkers[i];
+	}
+	mWorkers.clear();
+
+	decomp->quitThread();
+
+	mDone = true;
+}
+
+void LLPhysicsDecomp::processRequests()
+{
+	LLConvexDecomposition* decomp = LLConvexDecomposition::getInstance();
+
 	while (!mQuitting)
 	{
-		mSignal->wait();
-		while (!mQuitting && !mRequestQ.empty())
+		LLPointer<Request> request;
+
+		mSignal->lock();
+		while (!mQuitting && (request = popRequest()).isNull())
 		{
-			{
-				LLMutexLock lock(mMutex);
-				mCurRequest = mRequestQ.front();
-				mRequestQ.pop();
-			}
+			mSignal->wait();
+		}
+		mSignal->unlock();
+
+		if (request.isNull())
+		{ //quitting
+			break;
+		}
 
-			S32& id = *(mCurRequest->mDecompID);
+		if (request->isCancelled())
+		{
+			completeRequest(request);
+		}
+		else
+		{
+			S32& id = *(request->mDecompID);
 			if (id == -1)
 			{
 				decomp->genDecomposition(id);
 			}
 			decomp->bindDecomposition(id);
 
-			if (mCurRequest->mStage == "single_hull")
+			sCurDecompRequest = request;
+			if (request->mStage == "single_hull")
 			{
-				doDecompositionSingleHull();
+				doDecompositionSingleHull(request);
 			}
 			else
 			{
-				doDecomposition();
-			}		
+				doDecomposition(request);
+			}
+			sCurDecompRequest = NULL;
 		}
-	}
 
-	decomp->quitThread();
-	
-	if (mSignal->isLocked())
-	{ //let go of mSignal's associated mutex
+		{
+			LLMutexLock lock(mMutex);
+			mActiveDecomps.erase(request->mDecompID);
+		}
+
+		//another thread may be waiting on this model's next stage
+		mSignal->lock();
+		mSignal->broadcast();
 		mSignal->unlock();
 	}
+}
 
-	mDone = true;
+LLPointer<LLPhysicsDecomp::Request> LLPhysicsDecomp::popRequest()
+{
+	LLMutexLock lock(mMutex);
+	for (request_queue::iterator iter = mRequestQ.begin(); iter != mRequestQ.end(); ++iter)
+	{
+		LLPointer<Request> request = *iter;
+		if (mActiveDecomps.find(request->mDecompID) == mActiveDecomps.end())
+		{
+			mActiveDecomps.insert(request->mDecompID);
+			mRequestQ.erase(iter);
+			return request;
+		}
+	}
+	return NULL;
+}
+
+LLPhysicsDecomp::Worker::Worker(LLPhysicsDecomp* pool)
+: LLThread("Physics Decomp Worker"),
+  mPool(pool)
+{
+}
+
+void LLPhysicsDecomp::Worker::run()
+{
+	LLConvexDecomposition* decomp = LLConvexDecomposition::getInstance();
+
+	decomp->initThread();
+	mPool->processRequests();
+	decomp->quitThread();
 }
 
 void LLPhysicsDecomp::Request::assignData(LLModel* mdl) 
@@ -30,6 +30,7 @@
 #include "llassettype.h"
 #include "llmodel.h"
 #include "lluuid.h"
+#include "llflathashmap.h"
 #include "llviewertexture.h"
 #include "llvolume.h"
 
@@ -45,6 +46,7 @@ class LLMutex;
 class LLCondition;
 class LLVFS;
 class LLMeshRepository;
+class LLImageJ2C;
 
 class LLMeshUploadData
 {
@@ -161,6 +163,9 @@ public:
 		//completed callback, called from the main thread
 		virtual void completed() = 0;
 
+		//requests cancelled before a decomposition thread picks them up are completed without running
+		virtual bool isCancelled() const { return false; }
+
 		virtual void setStatusMessage(const std::string& msg);
 
 		bool isValid() const {return mPositions.size() > 2 && mIndices.size() > 2 ;}
@@ -175,6 +180,9 @@ public:
 		bool isValidTriangle(U16 idx1, U16 idx2, U16 idx3) ;
 	};
 
+	//number of threads decomposing requests concurrently, set before start()
+	static U32 sNumThreads;
+
 	LLCondition* mSignal;
 	LLMutex* mMutex;
 	
@@ -189,26 +197,54 @@ public:
 		
 	void submitRequest(Request* request);
 	static S32 llcdCallback(const char*, S32, S32);
+	//complete every request not yet started without running it
 	void cancel();
 
-	void setMeshData(LLCDMeshData& mesh, bool vertex_based);
-	void doDecomposition();
-	void doDecompositionSingleHull();
+	//requests finished and submitted since the queue was last empty, for progress display
+	void getProgress(S32& done, S32& total);
+
+	void setMeshData(Request* request, LLCDMeshData& mesh, bool vertex_based);
+	void doDecomposition(Request* request);
+	void doDecompositionSingleHull(Request* request);
 
 	virtual void run();
 	
-	void completeCurrent();
+	void completeRequest(Request* request);
 	void notifyCompleted();
 
 	std::map<std::string, S32> mStageID;
 
-	typedef std::queue<LLPointer<Request> > request_queue;
+	typedef std::deque<LLPointer<Request> > request_queue;
 	request_queue mRequestQ;
 
-	LLPointer<Request> mCurRequest;
-
 	std::queue<LLPointer<Request> > mCompletedQ;
 
+private:
+	//extra decomposition threads, all of them share the request queue with this one
+	class Worker : public LLThread
+	{
+	public:
+		Worker(LLPhysicsDecomp* pool);
+		virtual void run();
+
+	private:
+		LLPhysicsDecomp* mPool;
+	};
+
+	//take requests off the queue until quitting, on the calling thread
+	void processRequests();
+	//next request whose model no other thread is decomposing, NULL if none
+	LLPointer<Request> popRequest();
+
+	std::vector<Worker*> mWorkers;
+
+	//decompositions being worked on, so the stages of one model run in order on one thread at a time
+	std::set<S32*> mActiveDecomps;
+
+	std::map<std::string, const LLCDParam*> mParamMap;
+
+	S32 mRequestsDone;
+	S32 mRequestsTotal;
 };
 
 class LLMeshRepoThread : public LLThread
@@ -218,6 +254,7 @@ public:
 	static S32 sActiveHeaderRequests;
 	static S32 sActiveLODRequests;
 	static U32 sMaxConcurrentRequests;
+	static S64 sDecodedCacheMaxBytes; //0 disables the decoded LOD cache
 
 	LLCurlRequest* mCurlRequest;
 	LLMutex*	mMutex;
@@ -230,15 +267,16 @@ public:
 	typedef std::map<LLUUID, LLSD> mesh_header_map;
 	mesh_header_map mMeshHeader;
 	
-	std::map<LLUUID, U32> mMeshHeaderSize;
+	LLFlatHashMap<LLUUID, U32> mMeshHeaderSize;
 	
 	class HeaderRequest
 	{ 
 	public:
-		const LLVolumeParams mMeshParams;
+		LLVolumeParams mMeshParams;
+		F32 mScore;
 
 		HeaderRequest(const LLVolumeParams&  mesh_params)
-			: mMeshParams(mesh_params)
+			: mMeshParams(mesh_params), mScore(0.f)
 		{
 		}
 
@@ -267,6 +305,10 @@ public:
 		{
 			return lhs.mScore > rhs.mScore; // greatest = first
 		}
+		bool operator()(const HeaderRequest& lhs, const HeaderRequest& rhs)
+		{
+			return lhs.mScore > rhs.mScore; // greatest = first
+		}
 	};
 	
 
@@ -299,11 +341,17 @@ public:
 	//queue of completed Decomposition info requests
 	std::queue<LLModel::Decomposition*> mDecompositionQ;
 
-	//queue of requested headers
-	std::queue<HeaderRequest> mHeaderReqQ;
+	//queue of requested headers, highest score first (protected by mMutex)
+	typedef std::deque<HeaderRequest> header_req_queue_t;
+	header_req_queue_t mHeaderReqQ;
+
+	//queue of requested LODs, highest score first (protected by mMutex)
+	typedef std::deque<LODRequest> lod_req_queue_t;
+	lod_req_queue_t mLODReqQ;
 
-	//queue of requested LODs
-	std::queue<LODRequest> mLODReqQ;
+	//latest score of each mesh being loaded, set by the main thread (protected by mMutex)
+	typedef std::map<LLUUID, F32> score_map_t;
+	score_map_t mRequestScores;
 
 	//queue of unavailable LODs (either asset doesn't exist or asset doesn't have desired LOD)
 	std::queue<LODRequest> mUnavailableQ;
@@ -316,6 +364,7 @@ public:
 	pending_lod_map mPendingLOD;
 
 	static std::string constructUrl(LLUUID mesh_id);
+	static std::string getDecodedCacheDir();
 
 	LLMeshRepoThread();
 	~LLMeshRepoThread();
@@ -323,13 +372,23 @@ public:
 	virtual void run();
 
 	void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
+
+	//insert a request in score order, caller holds mMutex
+	void pushHeaderRequest(HeaderRequest req);
+	void pushLODRequest(LODRequest req);
+
+	//called from the main thread with mMutex held: re-ranks the queued
+	//requests and drops queued requests for the given meshes, returning
+	//the LODs that will no longer be loaded
+	void updateRequestScores(const score_map_t& scores);
+	void cancelQueuedRequests(const std::set<LLUUID>& mesh_ids, std::vector<LODRequest>& cancelled);
 	bool fetchMeshHeader(const LLVolumeParams& mesh_params, U32& count);
 	bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, U32& count);
-	bool headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size);
-	bool lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
-	bool skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
-	bool decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
-	bool physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
+	bool headerReceived(const LLVolumeParams& mesh_params, const U8* data, S32 data_size);
+	bool lodReceived(const LLVolumeParams& mesh_params, S32 lod, const U8* data, S32 data_size);
+	bool skinInfoReceived(const LLUUID& mesh_id, const U8* data, S32 data_size);
+	bool decompositionReceived(const LLUUID& mesh_id, const U8* data, S32 data_size);
+	bool physicsShapeReceived(const LLUUID& mesh_id, const U8* data, S32 data_size);
 	LLSD& getMeshHeader(const LLUUID& mesh_id);
 
 	void notifyLoadedMeshes();
@@ -351,6 +410,24 @@ public:
 	//  (should hold onto mesh_id and try again later if header info does not exist)
 	bool fetchMeshPhysicsShape(const LLUUID& mesh_id);
 
+	//decoded LOD cache: one file of raw LLVolumeFace data per mesh LOD,
+	//least recently used first out.  Repo thread only.
+	void initDecodedCache();
+	bool loadDecodedLOD(const LLVolumeParams& mesh_params, S32 lod);
+	void saveDecodedLOD(const LLUUID& mesh_id, S32 lod, const LLVolume* volume);
+
+private:
+	typedef std::pair<LLUUID, S32> decoded_key_t;
+	typedef std::list<decoded_key_t> decoded_lru_t;
+	typedef std::map<decoded_key_t, std::pair<S32, decoded_lru_t::iterator> > decoded_map_t;
+
+	std::string getDecodedFileName(const decoded_key_t& key) const;
+	void addDecodedEntry(const decoded_key_t& key, S32 size);
+	void removeDecodedEntry(const decoded_key_t& key);
+
+	decoded_map_t mDecodedMap;
+	decoded_lru_t mDecodedLRU;
+	S64 mDecodedCacheBytes;
 
 };
 
@@ -374,8 +451,25 @@ public:
 		void completed();
 	};
 
-	LLPointer<DecompRequest> mFinalDecomp;
-	bool mPhysicsComplete;
+	//hull requests submitted and not yet completed, they finish in any order
+	LLAtomicS32 mPendingDecomps;
+
+	//encodes textures to J2C while the hulls are being generated
+	class TextureEncoder : public LLThread
+	{
+	public:
+		TextureEncoder(LLMeshUploadThread* thread);
+		virtual void run();
+
+	private:
+		LLMeshUploadThread* mThread;
+	};
+
+	typedef std::map<LLViewerFetchedTexture*, LLPointer<LLImageJ2C> > encoded_texture_map;
+	//textures waiting for an encoder, and their encoded data once done; guarded by mMutex
+	std::vector<LLPointer<LLViewerFetchedTexture> > mTextureEncodeQueue;
+	encoded_texture_map mEncodedTextures;
+	std::vector<TextureEncoder*> mTextureEncoders;
 
 	typedef std::map<LLPointer<LLModel>, std::vector<LLVector3> > hull_map;
 	hull_map mHullMap;
@@ -413,6 +507,10 @@ public:
 
 	void generateHulls();
 
+	//queue every texture to upload on a pool of TextureEncoders, then wait for them
+	void startTextureEncodes();
+	void finishTextureEncodes();
+
 	void doWholeModelUpload();
 	void requestWholeModelFee();
 
@@ -457,6 +555,8 @@ public:
 
 	//mesh management functions
 	S32 loadMesh(LLVOVolume* volume, const LLVolumeParams& mesh_params, S32 detail = 0, S32 last_lod = -1);
+	//fetch a LOD an object is expected to need soon, without rebuilding it when it arrives
+	void prefetchMesh(LLVOVolume* volume, const LLVolumeParams& mesh_params, S32 detail);
 	
 	void notifyLoadedMeshes();
 	void notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVolume* volume);
@@ -486,13 +586,19 @@ public:
 
 	S32 getMeshSize(const LLUUID& mesh_id, S32 lod);
 
+	//rank pending mesh requests by on-screen size and drop those no object is waiting on, called with mMeshMutex and mThread->mMutex held
+	void updatePendingRequests();
+
 	typedef std::map<LLVolumeParams, std::set<LLUUID> > mesh_load_map;
 	mesh_load_map mLoadingMeshes[4];
+	//entries of mLoadingMeshes only requested by prefetchMesh
+	std::set<LLVolumeParams> mPrefetchMeshes[4];
 	
 	typedef std::map<LLUUID, LLMeshSkinInfo> skin_map;
 	skin_map mSkinMap;
 
-	typedef std::map<LLUUID, LLModel::Decomposition*> decomposition_map;
+	// only holds pointers, unlike mSkinMap which hands out references to its values
+	typedef LLFlatHashMap<LLUUID, LLModel::Decomposition*> decomposition_map;
 	decomposition_map mDecompositionMap;
 
 	LLMutex*					mMeshMutex;
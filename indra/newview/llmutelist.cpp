@@ -253,6 +253,7 @@ BOOL LLMuteList::add(const LLMute& mute, U32 flags)
 			localmute.mFlags = it->mFlags;
 			
 			mMutes.erase(it);
+			mMuteFlags.erase(localmute.mID);
 			// Don't need to call notifyObservers() here, since it will happen after the entry has been re-added below.
 		}
 		else
@@ -277,6 +278,7 @@ BOOL LLMuteList::add(const LLMute& mute, U32 flags)
 			std::pair<mute_set_t::iterator, bool> result = mMutes.insert(localmute);
 			if (result.second)
 			{
+				mMuteFlags[localmute.mID] = localmute.mFlags;
 				llinfos << "Muting " << localmute.mName << " id " << localmute.mID << " flags " << localmute.mFlags << llendl;
 				updateAdd(localmute);
 				notifyObservers();
@@ -355,6 +357,7 @@ BOOL LLMuteList::remove(const LLMute& mute, U32 flags)
 		
 		// Always remove the entry from the set -- it will be re-added with new flags if necessary.
 		mMutes.erase(it);
+		mMuteFlags.erase(localmute.mID);
 
 		if(remove)
 		{
@@ -366,6 +369,7 @@ BOOL LLMuteList::remove(const LLMute& mute, U32 flags)
 		{
 			// Flags were updated, the mute entry needs to be retransmitted to the server and re-added to the list.
 			mMutes.insert(localmute);
+			mMuteFlags[localmute.mID] = localmute.mFlags;
 			updateAdd(localmute);
 			llinfos << "Updating mute entry " << localmute.mName << " id " << localmute.mID << " flags " << localmute.mFlags << llendl;
 		}
@@ -535,9 +539,9 @@ BOOL LLMuteList::loadFromFile(const std::string& filename)
 		{
 			mLegacyMutes.insert(mute.mName);
 		}
-		else
+		else if (mMutes.insert(mute).second)
 		{
-			mMutes.insert(mute);
+			mMuteFlags[mute.mID] = mute.mFlags;
 		}
 	}
 	fclose(fp);
@@ -591,17 +595,22 @@ BOOL LLMuteList::saveToFile(const std::string& filename)
 
 BOOL LLMuteList::isMuted(const LLUUID& id, const std::string& name, U32 flags) const
 {
+	// Called for every chat line, sound and particle source, most people
+	// have nothing muted.
+	if (mMuteFlags.empty() && (mLegacyMutes.empty() || name.empty()))
+	{
+		return FALSE;
+	}
+
 	// for objects, check for muting on their parent prim
 	LLViewerObject* mute_object = get_object_to_mute_from_id(id);
-	LLUUID id_to_check  = (mute_object) ? mute_object->getID() : id;
+	const LLUUID& id_to_check  = (mute_object) ? mute_object->getID() : id;
 
-	// don't need name or type for lookup
-	LLMute mute(id_to_check);
-	mute_set_t::const_iterator mute_it = mMutes.find(mute);
-	if (mute_it != mMutes.end())
+	mute_flags_map_t::const_iterator mute_it = mMuteFlags.find(id_to_check);
+	if (mute_it != mMuteFlags.end())
 	{
 		// If any of the flags the caller passed are set, this item isn't considered muted for this caller.
-		if(flags & mute_it->mFlags)
+		if(flags & mute_it->second)
 		{
 			return FALSE;
 		}
@@ -30,6 +30,8 @@
 #include "llstring.h"
 #include "lluuid.h"
 #include "llextendedstatus.h"
+#include "llflathashmap.h"
+#include <boost/unordered_set.hpp>
 
 class LLViewerObject;
 class LLMessageSystem;
@@ -156,8 +158,12 @@ private:
 	};
 	typedef std::set<LLMute, compare_by_id> mute_set_t;
 	mute_set_t mMutes;
+
+	// Flags of every entry in mMutes by id, for isMuted()
+	typedef LLFlatHashMap<LLUUID, U32> mute_flags_map_t;
+	mute_flags_map_t mMuteFlags;
 	
-	typedef std::set<std::string> string_set_t;
+	typedef boost::unordered_set<std::string> string_set_t;
 	string_set_t mLegacyMutes;
 	
 	typedef std::set<LLMuteListObserver*> observer_set_t;
@@ -343,28 +343,54 @@ void LLNetMap::draw()
 
 		LLWorld::getInstance()->getAvatars(&avatar_ids, &positions, gAgentCamera.getCameraPositionGlobal());
 
-		// Draw avatars
+		// Work out each dot first, then draw them one image at a time so the
+		// quads for each image go out in a single batch instead of switching
+		// textures from one avatar to the next.
+		std::vector<LLVector3> avatar_pos_map(avatar_ids.size());
+		std::vector<LLColor4> avatar_colors(avatar_ids.size());
+		std::vector<LLUIImage*> avatar_images(avatar_ids.size());
 		for (U32 i = 0; i < avatar_ids.size(); i++)
 		{
-			pos_map = globalPosToView(positions[i]);
-			LLUUID uuid = avatar_ids[i];
+			avatar_pos_map[i] = globalPosToView(positions[i]);
 
 // [RLVa:KB] - Checked: 2010-04-19 (RLVa-1.2.0f) | Modified: RLVa-1.2.0f
-			bool show_as_friend = (LLAvatarTracker::instance().getBuddyInfo(uuid) != NULL) &&
+			bool show_as_friend = (LLAvatarTracker::instance().getBuddyInfo(avatar_ids[i]) != NULL) &&
 				(!gRlvHandler.hasBehaviour(RLV_BHVR_SHOWNAMES));
 // [/RLVa:KB]
-//			bool show_as_friend = (LLAvatarTracker::instance().getBuddyInfo(uuid) != NULL);
+//			bool show_as_friend = (LLAvatarTracker::instance().getBuddyInfo(avatar_ids[i]) != NULL);
 
-			LLColor4 color = show_as_friend ? map_avatar_friend_color : map_avatar_color;
+			avatar_colors[i] = show_as_friend ? map_avatar_friend_color : map_avatar_color;
 
 			unknown_relative_z = positions[i].mdV[VZ] == COARSEUPDATE_MAX_Z &&
 					camera_position.mV[VZ] >= COARSEUPDATE_MAX_Z;
 
-			LLWorldMapView::drawAvatar(
-				pos_map.mV[VX], pos_map.mV[VY], 
-				color, 
-				pos_map.mV[VZ], mDotRadius,
-				unknown_relative_z);
+			avatar_images[i] = LLWorldMapView::getAvatarImage(avatar_pos_map[i].mV[VZ], unknown_relative_z);
+		}
+
+		S32 dot_size = llround(mDotRadius * 2.f);
+		LLUIImage* dot_images[] = { LLWorldMapView::sAvatarLevelImage, LLWorldMapView::sAvatarAboveImage,
+									LLWorldMapView::sAvatarBelowImage, LLWorldMapView::sAvatarUnknownImage };
+		for (U32 image = 0; image < LL_ARRAY_SIZE(dot_images); image++)
+		{
+			for (U32 i = 0; i < avatar_ids.size(); i++)
+			{
+				if (avatar_images[i] == dot_images[image])
+				{
+					dot_images[image]->draw(llround(avatar_pos_map[i].mV[VX] - mDotRadius),
+											llround(avatar_pos_map[i].mV[VY] - mDotRadius),
+											dot_size,
+											dot_size,
+											avatar_colors[i]);
+				}
+			}
+		}
+
+		// Selection markers and picking
+		for (U32 i = 0; i < avatar_ids.size(); i++)
+		{
+			pos_map = avatar_pos_map[i];
+			LLUUID uuid = avatar_ids[i];
+			const LLColor4& color = avatar_colors[i];
 
 			if(uuid.notNull())
 			{
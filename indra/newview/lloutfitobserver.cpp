@@ -83,11 +83,16 @@ bool LLOutfitObserver::checkCOF()
 		return false;
 
 	bool cof_changed = false;
-	LLMD5 item_name_hash = gInventory.hashDirectDescendentNames(cof);
-	if (item_name_hash != mItemNameHash)
+	// hashing every COF name is only worth it when the COF was touched
+	if (cof != mItemNameHashCOF || gInventory.isCategoryChanged(cof))
 	{
-		cof_changed = true;
-		mItemNameHash = item_name_hash;
+		LLMD5 item_name_hash = gInventory.hashDirectDescendentNames(cof);
+		if (item_name_hash != mItemNameHash)
+		{
+			cof_changed = true;
+			mItemNameHash = item_name_hash;
+		}
+		mItemNameHashCOF = cof;
 	}
 
 	S32 cof_version = getCategoryVersion(cof);
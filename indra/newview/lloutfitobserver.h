@@ -80,6 +80,8 @@ protected:
 	bool mLastOutfitDirtiness;
 
 	LLMD5 mItemNameHash;
+	// COF that mItemNameHash was computed for
+	LLUUID mItemNameHashCOF;
 
 private:
 	signal_t mBOFReplaced;
@@ -742,7 +742,10 @@ LLPanelGroupMembersSubTab::LLPanelGroupMembersSubTab()
 	mChanged(FALSE),
 	mPendingMemberUpdate(FALSE),
 	mHasMatch(FALSE),
-	mNumOwnerAdditions(0)
+	mNumOwnerAdditions(0),
+	mMemberProgress(0),
+	mFilterMatchesValid(false),
+	mNarrowFilter(false)
 {
 	mUdpateSessionID = LLUUID::null;
 }
@@ -815,9 +818,26 @@ void LLPanelGroupMembersSubTab::setGroupID(const LLUUID& id)
 	if(mAssignedRolesList) mAssignedRolesList->deleteAllItems();
 	if(mAllowedActionsList) mAllowedActionsList->deleteAllItems();
 
+	mFilterMatchesValid = false;
+	mFilterMatches.clear();
+
 	LLPanelGroupSubTab::setGroupID(id);
 }
 
+void LLPanelGroupMembersSubTab::setSearchFilter(const std::string& filter)
+{
+	std::string filter_lc(filter);
+	LLStringUtil::toLower(filter_lc);
+
+	// Typing more of a name can only remove matches, so only the members
+	// that passed the last pass need a look.
+	mNarrowFilter = mFilterMatchesValid
+		&& !mMatchedFilter.empty()
+		&& filter_lc.find(mMatchedFilter) != std::string::npos;
+
+	LLPanelGroupSubTab::setSearchFilter(filter);
+}
+
 void LLPanelGroupRolesSubTab::setGroupID(const LLUUID& id)
 {
 	if(mRolesList) mRolesList->deleteAllItems();
@@ -1544,7 +1564,26 @@ void LLPanelGroupMembersSubTab::update(LLGroupChange gc)
 		&& gdatap->isRoleDataComplete()
 		&& gdatap->isRoleMemberDataComplete())
 	{
-		mMemberProgress = gdatap->mMembers.begin();
+		if (mNarrowFilter)
+		{
+			mMemberCandidates.swap(mFilterMatches);
+		}
+		else
+		{
+			mMemberCandidates.clear();
+			mMemberCandidates.reserve(gdatap->mMembers.size());
+			for (LLGroupMgrGroupData::member_list_t::iterator mit = gdatap->mMembers.begin();
+				 mit != gdatap->mMembers.end(); ++mit)
+			{
+				mMemberCandidates.push_back(mit->first);
+			}
+		}
+		mNarrowFilter = false;
+		mFilterMatchesValid = false;
+		mFilterMatches.clear();
+		mMatchedFilter = mSearchFilter;
+
+		mMemberProgress = 0;
 		mPendingMemberUpdate = TRUE;
 		mHasMatch = FALSE;
 		// Generate unique ID for current updateMembers()- see onNameCache for details.
@@ -1658,39 +1697,46 @@ void LLPanelGroupMembersSubTab::updateMembers()
 	}
 
 	//cleanup list only for first iretation
-	if(mMemberProgress == gdatap->mMembers.begin())
+	if(mMemberProgress == 0)
 	{
 		mMembersList->deleteAllItems();
 	}
 
-
-	LLGroupMgrGroupData::member_list_t::iterator end = gdatap->mMembers.end();
+	const U32 end = mMemberCandidates.size();
 	
 	S32 i = 0;
 	for( ; mMemberProgress != end && i<UPDATE_MEMBERS_PER_FRAME; 
 			++mMemberProgress, ++i)
 	{
-		if (!mMemberProgress->second)
+		const LLUUID& member_id = mMemberCandidates[mMemberProgress];
+		LLGroupMgrGroupData::member_list_t::iterator mit = gdatap->mMembers.find(member_id);
+		if (mit == gdatap->mMembers.end() || !mit->second)
 			continue;
 		// Do filtering on name if it is already in the cache.
 		std::string fullname;
-		if (gCacheName->getFullName(mMemberProgress->first, fullname))
+		if (gCacheName->getFullName(member_id, fullname))
 		{
 			if (matchesSearchFilter(fullname))
 			{
-				addMemberToList(mMemberProgress->first, mMemberProgress->second);
+				addMemberToList(member_id, mit->second);
+				mFilterMatches.push_back(member_id);
 			}
 		}
 		else
 		{
 			// If name is not cached, onNameCache() should be called when it is cached and add this member to list.
-			gCacheName->get(mMemberProgress->first, FALSE, boost::bind(&LLPanelGroupMembersSubTab::onNameCache,
+			gCacheName->get(member_id, FALSE, boost::bind(&LLPanelGroupMembersSubTab::onNameCache,
 																	   this, mUdpateSessionID, _1));
+			// it may still match, keep it for a narrower search
+			mFilterMatches.push_back(member_id);
 		}
 	}
 
 	if (mMemberProgress == end)
 	{
+		mFilterMatchesValid = true;
+		mMemberCandidates.clear();
+
 		if (mHasMatch)
 		{
 			mMembersList->setEnabled(TRUE);
@@ -1703,6 +1749,11 @@ void LLPanelGroupMembersSubTab::updateMembers()
 	}
 	else
 	{
+		// let the user work with the rows that are already in
+		if (mHasMatch)
+		{
+			mMembersList->setEnabled(TRUE);
+		}
 		mPendingMemberUpdate = TRUE;
 	}
 
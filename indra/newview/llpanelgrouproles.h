@@ -186,6 +186,7 @@ public:
 	virtual void draw();
 
 	virtual void setGroupID(const LLUUID& id);
+	virtual void setSearchFilter( const std::string& filter );
 
 	void addMemberToList(LLUUID id, LLGroupMemberData* data);
 	void onNameCache(const LLUUID& update_id, const LLUUID& id);
@@ -216,7 +217,18 @@ protected:
 	member_role_changes_map_t mMemberRoleChangeData;
 	U32 mNumOwnerAdditions;
 
-	LLGroupMgrGroupData::member_list_t::iterator mMemberProgress;
+	// Members still to be filtered by updateMembers().  Normally the whole
+	// roster, but when the search filter only gets longer it is the members
+	// that passed the previous filter.
+	uuid_vec_t mMemberCandidates;
+	U32 mMemberProgress;
+
+	// Members that passed (or may pass, if their name was not cached yet)
+	// mMatchedFilter in the last full pass.
+	uuid_vec_t mFilterMatches;
+	std::string mMatchedFilter;
+	bool mFilterMatchesValid;
+	bool mNarrowFilter;
 };
 
 class LLPanelGroupRolesSubTab : public LLPanelGroupSubTab
@@ -28,6 +28,7 @@
 
 // libs
 #include "llavatarname.h"
+#include "llflathashmap.h"
 #include "llfloaterreg.h"
 #include "llfloatersidepanelcontainer.h"
 #include "llmenubutton.h"
@@ -132,9 +133,11 @@ protected:
 class LLAvatarItemDistanceComparator : public LLAvatarItemComparator
 {
 public:
-	typedef std::map < LLUUID, LLVector3d > id_to_pos_map_t;
+	typedef LLFlatHashMap < LLUUID, F64 > id_to_dist_map_t;
 	LLAvatarItemDistanceComparator() {};
 
+	// Distances are updated in place; the map is only rebuilt when someone
+	// has left, which is the only way it can hold more entries than uuids.
 	void updateAvatarsPositions(std::vector<LLVector3d>& positions, uuid_vec_t& uuids)
 	{
 		std::vector<LLVector3d>::const_iterator
@@ -145,27 +148,38 @@ public:
 			id_it = uuids.begin(),
 			id_end = uuids.end();
 
-		LLAvatarItemDistanceComparator::id_to_pos_map_t pos_map;
-
-		mAvatarsPositions.clear();
+		const LLVector3d& me_pos = gAgent.getPositionGlobal();
 
 		for (;pos_it != pos_end && id_it != id_end; ++pos_it, ++id_it )
 		{
-			mAvatarsPositions[*id_it] = *pos_it;
+			mAvatarsDistances[*id_it] = dist_vec_squared(*pos_it, me_pos);
+		}
+
+		if (mAvatarsDistances.size() > uuids.size())
+		{
+			id_to_dist_map_t distances;
+			distances.reserve(uuids.size());
+			for (id_it = uuids.begin(); id_it != id_end; ++id_it)
+			{
+				distances[*id_it] = mAvatarsDistances[*id_it];
+			}
+			mAvatarsDistances.swap(distances);
 		}
 	};
 
 protected:
 	virtual bool doCompare(const LLAvatarListItem* item1, const LLAvatarListItem* item2) const
 	{
-		const LLVector3d& me_pos = gAgent.getPositionGlobal();
-		const LLVector3d& item1_pos = mAvatarsPositions.find(item1->getAvatarId())->second;
-		const LLVector3d& item2_pos = mAvatarsPositions.find(item2->getAvatarId())->second;
-		
-		return dist_vec_squared(item1_pos, me_pos) < dist_vec_squared(item2_pos, me_pos);
+		return getDistance(item1->getAvatarId()) < getDistance(item2->getAvatarId());
 	}
 private:
-	id_to_pos_map_t mAvatarsPositions;
+	F64 getDistance(const LLUUID& id) const
+	{
+		id_to_dist_map_t::const_iterator found_it = mAvatarsDistances.find(id);
+		return found_it != mAvatarsDistances.end() ? found_it->second : F64_MAX;
+	}
+
+	id_to_dist_map_t mAvatarsDistances;
 };
 
 /** Comparator for comparing nearby avatar items by last spoken time */
@@ -809,12 +823,37 @@ void LLPanelPeople::updateNearbyList()
 	if (!mNearbyList)
 		return;
 
+	// The updater only runs while the Nearby tab is selected, but the tab
+	// stays "visible" when the whole people panel is closed.
+	if (!mNearbyList->isInVisibleChain())
+		return;
+
+	static LLCachedControl<F32> near_me_range(gSavedSettings, "NearMeRange");
+
+	uuid_vec_t avatar_ids;
 	std::vector<LLVector3d> positions;
 
-	LLWorld::getInstance()->getAvatars(&mNearbyList->getIDs(), &positions, gAgent.getPositionGlobal(), gSavedSettings.getF32("NearMeRange"));
-	mNearbyList->setDirty();
+	LLWorld::getInstance()->getAvatars(&avatar_ids, &positions, gAgent.getPositionGlobal(), near_me_range);
+
+	DISTANCE_COMPARATOR.updateAvatarsPositions(positions, avatar_ids);
+
+	// Only arrivals and departures need a refresh(), which creates and
+	// destroys rows; otherwise the rows stay and just get re-sorted, which
+	// costs nothing when the order has not changed.
+	uuid_vec_t& cur_ids = mNearbyList->getIDs();
+	uuid_vec_t new_sorted(avatar_ids), cur_sorted(cur_ids);
+	std::sort(new_sorted.begin(), new_sorted.end());
+	std::sort(cur_sorted.begin(), cur_sorted.end());
+	if (new_sorted != cur_sorted)
+	{
+		cur_ids.swap(avatar_ids);
+		mNearbyList->setDirty();
+	}
+	else
+	{
+		mNearbyList->sort();
+	}
 
-	DISTANCE_COMPARATOR.updateAvatarsPositions(positions, mNearbyList->getIDs());
 	LLActiveSpeakerMgr::instance().update(TRUE);
 }
 
@@ -39,12 +39,17 @@
 #include "llviewercontrol.h"
 #include "llviewervisualparam.h"
 #include "llvoavatarself.h"
+#include "llparallelfor.h"
+#include "pipeline.h"
+
+#include <algorithm>
 
 typedef std::map<std::string, std::string> controller_map_t;
 typedef std::map<std::string, F32> default_controller_map_t;
 
 #define MIN_REQUIRED_PIXEL_AREA_AVATAR_PHYSICS_MOTION 0.f
-#define TIME_ITERATION_STEP 0.1f
+#define PHYSICS_FIXED_STEP (1.f/60.f)
+#define PHYSICS_BATCH_CHUNK 64 // motions per render worker job
 
 inline F64 llsgn(const F64 a)
 {
@@ -64,6 +69,64 @@ inline F64 llsgn(const F64 a)
    to.
 */
 
+// Controller settings of each motion, see sControllerNames
+enum
+{
+        CONTROLLER_MASS = 0,
+        CONTROLLER_GRAVITY,
+        CONTROLLER_DAMPING,
+        CONTROLLER_DRAG,
+        CONTROLLER_MAXEFFECT,
+        CONTROLLER_SPRING,
+        CONTROLLER_GAIN,
+        CONTROLLER_COUNT
+};
+
+static const char* sControllerNames[CONTROLLER_COUNT] =
+{
+        "Mass",
+        "Gravity",
+        "Damping",
+        "Drag",
+        "MaxEffect",
+        "Spring",
+        "Gain"
+};
+
+//-----------------------------------------------------------------------------
+// LLPhysicsMotionBatch
+// Every physics motion that updates this frame, across all avatars, laid out
+// as one array per quantity so the simulation can be stepped in one pass.
+// gather() appends inputs on the main thread, step() only touches the arrays
+// and so can run on the render workers, apply() reads the results back.
+//-----------------------------------------------------------------------------
+class LLPhysicsMotionBatch
+{
+public:
+        void clear();
+        U32 size() const { return mPosition.size(); }
+
+        // Simulates entries [first, last)
+        void step(U32 first, U32 last);
+
+        // inputs
+        std::vector<F32> mTimeDelta;
+        std::vector<F32> mPositionUser;
+        std::vector<F32> mVelocityJoint;
+        std::vector<F32> mAccelerationJoint;
+        std::vector<F32> mGravity; // gravity force in param space, before mass
+        std::vector<F32> mMass;
+        std::vector<F32> mSpring;
+        std::vector<F32> mGain;
+        std::vector<F32> mDamping;
+        std::vector<F32> mDrag;
+        std::vector<F32> mMaxEffect;
+
+        // state, stepped in place
+        std::vector<F32> mPosition;
+        std::vector<F32> mVelocity;
+};
+
 class LLPhysicsMotion
 {
 public:
@@ -92,10 +155,13 @@ public:
                 mParamDriver(NULL),
                 mParamControllers(controllers),
                 mCharacter(character),
+                mIsSelf(FALSE),
                 mLastTime(0),
                 mPosition_local(0),
                 mVelocityJoint_local(0),
-                mPositionLastUpdate_local(0)
+                mPositionLastUpdate_local(0),
+                mStepRemainder(0),
+                mBatchIndex(-1)
         {
                 mJointState = new LLJointState;
         }
@@ -104,29 +170,30 @@ public:
 
         ~LLPhysicsMotion() {}
 
-        BOOL onUpdate(F32 time);
+        // Adds this motion's inputs for this frame to batch, returns FALSE if
+        // there is nothing to simulate.
+        BOOL gather(F32 time, LLPhysicsMotionBatch &batch);
+
+        // Takes the stepped state back from batch and sets the driven params,
+        // returns TRUE if character has to update visual params.
+        BOOL apply(const LLPhysicsMotionBatch &batch);
 
         LLPointer<LLJointState> getJointState() 
         {
                 return mJointState;
         }
 protected:
-        F32 getParamValue(const std::string& controller_key)
+        F32 getParamValue(U32 controller)
         {
-                const controller_map_t::const_iterator& entry = mParamControllers.find(controller_key);
-                if (entry == mParamControllers.end())
-                {
-                        return sDefaultController[controller_key];
-                }
-                const std::string& param_name = (*entry).second.c_str();
-                return mCharacter->getVisualParamWeight(param_name.c_str());
+                const LLVisualParam* param = mControllerParams[controller];
+                return param ? param->getWeight() : mControllerDefaults[controller];
         }
         void setParamValue(LLViewerVisualParam *param,
                            const F32 new_value_local,
                                                    F32 behavior_maxeffect);
 
-        F32 toLocal(const LLVector3 &world);
-        F32 calculateVelocity_local();
+        F32 toLocal(const LLVector3 &world, const LLQuaternion &rotation_world);
+        F32 calculateVelocity_local(const LLVector3 &position_world, const LLQuaternion &rotation_world);
         F32 calculateAcceleration_local(F32 velocity_local);
 private:
         const std::string mParamDriverName;
@@ -144,11 +211,25 @@ private:
 
         LLViewerVisualParam *mParamDriver;
         const controller_map_t mParamControllers;
+
+        // mParamControllers resolved in initialize(), NULL where the default is used
+        LLVisualParam* mControllerParams[CONTROLLER_COUNT];
+        F32 mControllerDefaults[CONTROLLER_COUNT];
         
         LLPointer<LLJointState> mJointState;
         LLCharacter *mCharacter;
+        BOOL mIsSelf;
 
         F32 mLastTime;
+        F32 mStepRemainder; // Time not yet simulated, less than PHYSICS_FIXED_STEP
+
+        // Values from gather() that apply() needs
+        S32 mBatchIndex;
+        F32 mVelocityJointNew_local;
+        F32 mAccelerationJointNew_local;
+        F32 mBehaviorMaxEffect;
+        F32 mLODFactor;
+        LLVector3 mPositionNew_world;
         
         static default_controller_map_t sDefaultController;
 };
@@ -181,18 +262,44 @@ BOOL LLPhysicsMotion::initialize()
                 return FALSE;
         }
 
+        mIsSelf = (dynamic_cast<LLVOAvatarSelf *>(mCharacter) != NULL);
+
+        // Look the controller params up once, by name they are too slow to read every frame
+        for (U32 i = 0; i < CONTROLLER_COUNT; ++i)
+        {
+                mControllerParams[i] = NULL;
+                mControllerDefaults[i] = sDefaultController[sControllerNames[i]];
+
+                const controller_map_t::const_iterator& entry = mParamControllers.find(sControllerNames[i]);
+                if (entry != mParamControllers.end())
+                {
+                        mControllerParams[i] = mCharacter->getVisualParam((*entry).second.c_str());
+                        if (!mControllerParams[i])
+                        {
+                                llwarns << "Invalid physics controller param: " << (*entry).second << llendl;
+                                mControllerDefaults[i] = 0.f;
+                        }
+                }
+        }
+
         return TRUE;
 }
 
 LLPhysicsMotionController::LLPhysicsMotionController(const LLUUID &id) : 
         LLMotion(id),
-        mCharacter(NULL)
+        mCharacter(NULL),
+        mBatchPending(FALSE)
 {
         mName = "breast_motion";
 }
 
 LLPhysicsMotionController::~LLPhysicsMotionController()
 {
+        if (sPending)
+        {
+                sPending->erase(std::remove(sPending->begin(), sPending->end(), this), sPending->end());
+        }
+
         for (motion_vec_t::iterator iter = mMotions.begin();
              iter != mMotions.end();
              ++iter)
@@ -368,26 +475,20 @@ F32 LLPhysicsMotionController::getMinPixelArea()
 }
 
 // Local space means "parameter space".
-F32 LLPhysicsMotion::toLocal(const LLVector3 &world)
+F32 LLPhysicsMotion::toLocal(const LLVector3 &world, const LLQuaternion &rotation_world)
 {
-        LLJoint *joint = mJointState->getJoint();
-        const LLQuaternion rotation_world = joint->getWorldRotation();
-        
         LLVector3 dir_world = mMotionDirectionVec * rotation_world;
         dir_world.normalize();
         return world * dir_world;
 }
 
-F32 LLPhysicsMotion::calculateVelocity_local()
+F32 LLPhysicsMotion::calculateVelocity_local(const LLVector3 &position_world, const LLQuaternion &rotation_world)
 {
 	const F32 world_to_model_scale = 100.0f;
-        LLJoint *joint = mJointState->getJoint();
-        const LLVector3 position_world = joint->getWorldPosition();
-        const LLQuaternion rotation_world = joint->getWorldRotation();
         const LLVector3 last_position_world = mPosition_world;
 	const LLVector3 positionchange_world = (position_world-last_position_world) * world_to_model_scale;
         const LLVector3 velocity_world = positionchange_world;
-        const F32 velocity_local = toLocal(velocity_world);
+        const F32 velocity_local = toLocal(velocity_world, rotation_world);
         return velocity_local;
 }
 
@@ -404,35 +505,267 @@ F32 LLPhysicsMotion::calculateAcceleration_local(const F32 velocity_local)
         return smoothed_acceleration_local;
 }
 
+//-----------------------------------------------------------------------------
+// LLPhysicsMotionBatch
+//-----------------------------------------------------------------------------
+void LLPhysicsMotionBatch::clear()
+{
+        mTimeDelta.clear();
+        mPositionUser.clear();
+        mVelocityJoint.clear();
+        mAccelerationJoint.clear();
+        mGravity.clear();
+        mMass.clear();
+        mSpring.clear();
+        mGain.clear();
+        mDamping.clear();
+        mDrag.clear();
+        mMaxEffect.clear();
+        mPosition.clear();
+        mVelocity.clear();
+}
+
+void LLPhysicsMotionBatch::step(U32 first, U32 last)
+{
+        static const F32 max_velocity = 100.0f; // magic number, used to be customizable.
+
+        for (U32 i = first; i < last; ++i)
+        {
+                F32 position = mPosition[i];
+                F32 velocity = mVelocity[i];
+                const F32 position_user_local = mPositionUser[i];
+                const F32 behavior_mass = mMass[i];
+                const F32 behavior_spring = mSpring[i];
+                const F32 behavior_damping = mDamping[i];
+                const F32 behavior_maxeffect = mMaxEffect[i];
+                const F32 velocity_joint_local = mVelocityJoint[i];
+
+                // Forces from the joint motion are the same for every step this frame.
+		// Acceleration is the force that comes from the change in velocity of the torso.
+		// F = ma
+                const F32 force_accel = mGain[i] * (mAccelerationJoint[i] * behavior_mass);
+		// Gravity always points downward in world space.
+		// F = mg
+                const F32 force_gravity = mGravity[i] * behavior_mass;
+		// Drag is a force imparted by velocity (intuitively it is similar to wind resistance)
+		// F = .5kv^2
+                const F32 force_drag = .5f*mDrag[i]*velocity_joint_local*velocity_joint_local*llsgn(velocity_joint_local);
+
+                // Fixed steps so that differing framerates show the same behavior,
+                // time left over is carried into the next frame.
+                F32 time_remaining = mTimeDelta[i];
+                while (time_remaining >= PHYSICS_FIXED_STEP)
+                {
+                        time_remaining -= PHYSICS_FIXED_STEP;
+
+                        // position should be in normalized 0,1 range already.  Just making sure...
+                        const F32 position_current_local = llclamp(position, 0.0f, 1.0f);
+
+                        // If the effect is turned off then stop once we reach
+                        // the default (i.e. user) position.
+                        if ((behavior_maxeffect == 0) && (position_current_local == position_user_local))
+                        {
+                                time_remaining = 0.f;
+                                break;
+                        }
+
+		        // Spring force is a restoring force towards the original user-set breast position.
+		        // F = kx
+                        const F32 spring_length = position_current_local - position_user_local;
+                        const F32 force_spring = -spring_length * behavior_spring;
+
+		        // Damping is a restoring force that opposes the current velocity.
+		        // F = -kv
+                        const F32 force_damping = -behavior_damping * velocity;
+
+                        const F32 force_net = (force_accel + 
+                                               force_gravity +
+                                               force_spring + 
+                                               force_damping + 
+                                               force_drag);
+
+		        // Calculate the new acceleration based on the net force.
+		        // a = F/m
+                        const F32 acceleration_new_local = force_net / behavior_mass;
+                        F32 velocity_new_local = velocity + acceleration_new_local*PHYSICS_FIXED_STEP;
+                        velocity_new_local = llclamp(velocity_new_local, 
+                                                     -max_velocity, max_velocity);
+
+		        // Calculate the new parameters, or remain unchanged if max speed is 0.
+                        F32 position_new_local = position_current_local + velocity_new_local*PHYSICS_FIXED_STEP;
+                        if (behavior_maxeffect == 0)
+                                position_new_local = position_user_local;
+
+		        // Zero out the velocity if the param is being pushed beyond its limits.
+                        if ((position_new_local < 0 && velocity_new_local < 0) || 
+                            (position_new_local > 1 && velocity_new_local > 0))
+                        {
+                                velocity_new_local = 0;
+                        }
+
+		        // Check for NaN values.  A NaN value is detected if the variables doesn't equal itself.  
+		        // If NaN, then reset everything.
+                        if ((position != position) ||
+                            (velocity_new_local != velocity_new_local) ||
+                            (position_new_local != position_new_local))
+                        {
+                                position_new_local = 0;
+                                velocity_new_local = 0;
+                        }
+
+                        position = position_new_local;
+                        velocity = velocity_new_local;
+                }
+
+                mPosition[i] = position;
+                mVelocity[i] = velocity;
+                mTimeDelta[i] = time_remaining;
+        }
+}
+
+class LLPhysicsStepBody : public LLParallelFor::Body
+{
+public:
+        LLPhysicsStepBody(LLPhysicsMotionBatch& batch) : mBatch(batch) { }
+
+        /*virtual*/ void run(U32 index)
+        {
+                U32 first = index * PHYSICS_BATCH_CHUNK;
+                mBatch.step(first, llmin(first + PHYSICS_BATCH_CHUNK, mBatch.size()));
+        }
+
+        LLPhysicsMotionBatch& mBatch;
+};
+
+//-----------------------------------------------------------------------------
+// LLPhysicsMotionController
+//-----------------------------------------------------------------------------
+
+static LLPhysicsMotionBatch sBatch;
+
+// static
+std::vector<LLPhysicsMotionController*>* LLPhysicsMotionController::sPending = NULL;
+
 BOOL LLPhysicsMotionController::onUpdate(F32 time, U8* joint_mask)
 {
         // Skip if disabled globally.
-        if (!gSavedSettings.getBOOL("AvatarPhysics"))
+        static LLCachedControl<bool> avatar_physics(gSavedSettings, "AvatarPhysics");
+        if (!avatar_physics)
+        {
+                return TRUE;
+        }
+
+        // Already waiting on this frame's batch
+        if (mBatchPending)
+        {
+                return TRUE;
+        }
+
+        BOOL gathered = FALSE;
+        for (motion_vec_t::iterator iter = mMotions.begin();
+             iter != mMotions.end();
+             ++iter)
+        {
+                LLPhysicsMotion *motion = (*iter);
+                gathered |= motion->gather(time, sBatch);
+        }
+
+        if (!gathered)
         {
                 return TRUE;
         }
+
+        if (sPending)
+        {
+                mBatchPending = TRUE;
+                sPending->push_back(this);
+        }
+        else
+        {
+                // Not inside the idle update, simulate just this avatar now
+                sBatch.step(0, sBatch.size());
+                applyBatch();
+                sBatch.clear();
+        }
         
+        return TRUE;
+}
+
+void LLPhysicsMotionController::applyBatch()
+{
+        mBatchPending = FALSE;
+
         BOOL update_visuals = FALSE;
         for (motion_vec_t::iterator iter = mMotions.begin();
              iter != mMotions.end();
              ++iter)
         {
                 LLPhysicsMotion *motion = (*iter);
-                update_visuals |= motion->onUpdate(time);
+                update_visuals |= motion->apply(sBatch);
         }
                 
         if (update_visuals)
                 mCharacter->updateVisualParams();
-        
-        return TRUE;
 }
 
+// static
+void LLPhysicsMotionController::beginBatch()
+{
+        static std::vector<LLPhysicsMotionController*> pending;
+
+        if (!sPending)
+        {
+                pending.clear();
+                sBatch.clear();
+                sPending = &pending;
+        }
+}
+
+static LLFastTimer::DeclareTimer FTM_PHYSICS_BATCH("Avatar Physics");
 
-// Return TRUE if character has to update visual params.
-BOOL LLPhysicsMotion::onUpdate(F32 time)
+// static
+void LLPhysicsMotionController::finishBatch()
 {
-        // static FILE *mFileWrite = fopen("c:\\temp\\avatar_data.txt","w");
-        
+        if (!sPending)
+        {
+                return;
+        }
+
+        std::vector<LLPhysicsMotionController*>& pending = *sPending;
+        sPending = NULL;
+
+        if (pending.empty())
+        {
+                return;
+        }
+
+        LLFastTimer t(FTM_PHYSICS_BATCH);
+
+        LLParallelFor* workers = gPipeline.getRenderWorkers();
+        if (workers && sBatch.size() > PHYSICS_BATCH_CHUNK)
+        {
+                LLPhysicsStepBody body(sBatch);
+                workers->run(body, (sBatch.size() + PHYSICS_BATCH_CHUNK - 1) / PHYSICS_BATCH_CHUNK);
+        }
+        else
+        {
+                sBatch.step(0, sBatch.size());
+        }
+
+        // Setting params and applying morphs stays on the main thread
+        for (U32 i = 0; i < pending.size(); ++i)
+        {
+                pending[i]->applyBatch();
+        }
+
+        pending.clear();
+        sBatch.clear();
+}
+
+BOOL LLPhysicsMotion::gather(F32 time, LLPhysicsMotionBatch &batch)
+{
+        mBatchIndex = -1;
+
         if (!mParamDriver)
                 return FALSE;
 
@@ -448,16 +781,16 @@ BOOL LLPhysicsMotion::onUpdate(F32 time)
 
         const F32 time_delta = time - mLastTime;
 
-	// Don't update too frequently, to avoid precision errors from small time slices.
-	if (time_delta <= .01)
-	{
-		return FALSE;
-	}
-	
 	// If less than 1FPS, we don't want to be spending time updating physics at all.
         if (time_delta > 1.0)
         {
                 mLastTime = time;
+                mStepRemainder = 0.f;
+                return FALSE;
+        }
+
+        if (time_delta <= 0.f)
+        {
                 return FALSE;
         }
 
@@ -466,20 +799,12 @@ BOOL LLPhysicsMotion::onUpdate(F32 time)
         const F32 lod_factor = LLVOAvatar::sPhysicsLODFactor;
         if (lod_factor == 0)
         {
-                return TRUE;
+                return FALSE;
         }
 
-        LLJoint *joint = mJointState->getJoint();
-
-        const F32 behavior_mass = getParamValue("Mass");
-        const F32 behavior_gravity = getParamValue("Gravity");
-        const F32 behavior_spring = getParamValue("Spring");
-        const F32 behavior_gain = getParamValue("Gain");
-        const F32 behavior_damping = getParamValue("Damping");
-        const F32 behavior_drag = getParamValue("Drag");
         const BOOL physics_test = FALSE; // Enable this to simulate bouncing on all parts.
         
-        F32 behavior_maxeffect = getParamValue("MaxEffect");
+        F32 behavior_maxeffect = getParamValue(CONTROLLER_MAXEFFECT);
         if (physics_test)
                 behavior_maxeffect = 1.0f;
 
@@ -488,226 +813,126 @@ BOOL LLPhysicsMotion::onUpdate(F32 time)
 	// and each of these driven params may have its own range.
 	// This means we'll do all our calculations in normalized [0,1] local coordinates.
 	const F32 position_user_local = (mParamDriver->getWeight() - mParamDriver->getMinWeight()) / (mParamDriver->getMaxWeight() - mParamDriver->getMinWeight());
-       	
-	//
-	// End parameters and settings
-	////////////////////////////////////////////////////////////////////////////////
-	
-	
+
+        // Nothing to simulate for parts at rest with the effect turned off, which is most avatars
+        if ((behavior_maxeffect == 0) && (llclamp(mPosition_local, 0.0f, 1.0f) == position_user_local))
+        {
+                mLastTime = time;
+                mStepRemainder = 0.f;
+                return FALSE;
+        }
+
 	////////////////////////////////////////////////////////////////////////////////
 	// Calculate velocity and acceleration in parameter space.
 	//
+        LLJoint *joint = mJointState->getJoint();
+        const LLVector3 position_world = joint->getWorldPosition();
+        const LLQuaternion rotation_world = joint->getWorldRotation();
         
-	//const F32 velocity_joint_local = calculateVelocity_local(time_iteration_step);
-	const F32 velocity_joint_local = calculateVelocity_local();
+	const F32 velocity_joint_local = calculateVelocity_local(position_world, rotation_world);
 	const F32 acceleration_joint_local = calculateAcceleration_local(velocity_joint_local);
-	
-	//
-	// End velocity and acceleration
-	////////////////////////////////////////////////////////////////////////////////
-	
-	BOOL update_visuals = FALSE;
-	
-	// Break up the physics into a bunch of iterations so that differing framerates will show
-	// roughly the same behavior.
-	for (F32 time_iteration = 0; time_iteration <= time_delta; time_iteration += TIME_ITERATION_STEP)
-	{
-		F32 time_iteration_step = TIME_ITERATION_STEP;
-		if (time_iteration + TIME_ITERATION_STEP > time_delta)
-		{
-			time_iteration_step = time_delta-time_iteration;
-		}
-		
-		// mPositon_local should be in normalized 0,1 range already.  Just making sure...
-		const F32 position_current_local = llclamp(mPosition_local,
-							   0.0f,
-							   1.0f);
-		// If the effect is turned off then don't process unless we need one more update
-		// to set the position to the default (i.e. user) position.
-		if ((behavior_maxeffect == 0) && (position_current_local == position_user_local))
-		{
-			return update_visuals;
-		}
+	const LLVector3 gravity_world(0,0,1);
+
+        mBatchIndex = batch.size();
+        batch.mTimeDelta.push_back(time_delta + mStepRemainder);
+        batch.mPositionUser.push_back(position_user_local);
+        batch.mVelocityJoint.push_back(velocity_joint_local);
+        batch.mAccelerationJoint.push_back(acceleration_joint_local);
+        batch.mGravity.push_back(toLocal(gravity_world, rotation_world) * getParamValue(CONTROLLER_GRAVITY));
+        batch.mMass.push_back(getParamValue(CONTROLLER_MASS));
+        batch.mSpring.push_back(getParamValue(CONTROLLER_SPRING));
+        batch.mGain.push_back(getParamValue(CONTROLLER_GAIN));
+        batch.mDamping.push_back(getParamValue(CONTROLLER_DAMPING));
+        batch.mDrag.push_back(getParamValue(CONTROLLER_DRAG));
+        batch.mMaxEffect.push_back(behavior_maxeffect);
+        batch.mPosition.push_back(mPosition_local);
+        batch.mVelocity.push_back(mVelocity_local);
+
+        mVelocityJointNew_local = velocity_joint_local;
+        mAccelerationJointNew_local = acceleration_joint_local;
+        mBehaviorMaxEffect = behavior_maxeffect;
+        mLODFactor = lod_factor;
+        mPositionNew_world = position_world;
+        mLastTime = time;
 
-		////////////////////////////////////////////////////////////////////////////////
-		// Calculate the total force 
-		//
-
-		// Spring force is a restoring force towards the original user-set breast position.
-		// F = kx
-		const F32 spring_length = position_current_local - position_user_local;
-		const F32 force_spring = -spring_length * behavior_spring;
+        return TRUE;
+}
 
-		// Acceleration is the force that comes from the change in velocity of the torso.
-		// F = ma
-		const F32 force_accel = behavior_gain * (acceleration_joint_local * behavior_mass);
+// Return TRUE if character has to update visual params.
+BOOL LLPhysicsMotion::apply(const LLPhysicsMotionBatch &batch)
+{
+        if (mBatchIndex < 0)
+        {
+                return FALSE;
+        }
 
-		// Gravity always points downward in world space.
-		// F = mg
-		const LLVector3 gravity_world(0,0,1);
-		const F32 force_gravity = (toLocal(gravity_world) * behavior_gravity * behavior_mass);
-                
-		// Damping is a restoring force that opposes the current velocity.
-		// F = -kv
-		const F32 force_damping = -behavior_damping * mVelocity_local;
-                
-		// Drag is a force imparted by velocity (intuitively it is similar to wind resistance)
-		// F = .5kv^2
-		const F32 force_drag = .5*behavior_drag*velocity_joint_local*velocity_joint_local*llsgn(velocity_joint_local);
+        const U32 index = mBatchIndex;
+        mBatchIndex = -1;
 
-		const F32 force_net = (force_accel + 
-				       force_gravity +
-				       force_spring + 
-				       force_damping + 
-				       force_drag);
+        mPosition_local = batch.mPosition[index];
+        mVelocity_local = batch.mVelocity[index];
+        mStepRemainder = batch.mTimeDelta[index];
+        mAccelerationJoint_local = mAccelerationJointNew_local;
+        mVelocityJoint_local = mVelocityJointNew_local;
+        mPosition_world = mPositionNew_world;
 
-		//
-		// End total force
-		////////////////////////////////////////////////////////////////////////////////
+        const F32 position_new_local_clamped = llclamp(mPosition_local,
+                                                       0.0f,
+                                                       1.0f);
 
+	////////////////////////////////////////////////////////////////////////////////
+	// Conditionally update the visual params
+	//
         
-		////////////////////////////////////////////////////////////////////////////////
-		// Calculate new params
-		//
-
-		// Calculate the new acceleration based on the net force.
-		// a = F/m
-		const F32 acceleration_new_local = force_net / behavior_mass;
-		static const F32 max_velocity = 100.0f; // magic number, used to be customizable.
-		F32 velocity_new_local = mVelocity_local + acceleration_new_local*time_iteration_step;
-		velocity_new_local = llclamp(velocity_new_local, 
-					     -max_velocity, max_velocity);
+	// Updating the visual params (i.e. what the user sees) is fairly expensive.
+	// So only update if the params have changed enough, and also take into account
+	// the graphics LOD settings.  Changes below that tolerance are not written at all.
         
-		// Temporary debugging setting to cause all avatars to move, for profiling purposes.
-		if (physics_test)
-		{
-			velocity_new_local = sin(time*4.0);
-		}
-		// Calculate the new parameters, or remain unchanged if max speed is 0.
-		F32 position_new_local = position_current_local + velocity_new_local*time_iteration_step;
-		if (behavior_maxeffect == 0)
-			position_new_local = position_user_local;
-
-		// Zero out the velocity if the param is being pushed beyond its limits.
-		if ((position_new_local < 0 && velocity_new_local < 0) || 
-		    (position_new_local > 1 && velocity_new_local > 0))
-		{
-			velocity_new_local = 0;
-		}
-	
-		// Check for NaN values.  A NaN value is detected if the variables doesn't equal itself.  
-		// If NaN, then reset everything.
-		if ((mPosition_local != mPosition_local) ||
-		    (mVelocity_local != mVelocity_local) ||
-		    (position_new_local != position_new_local))
-		{
-			position_new_local = 0;
-			mVelocity_local = 0;
-			mVelocityJoint_local = 0;
-			mAccelerationJoint_local = 0;
-			mPosition_local = 0;
-			mPosition_world = LLVector3(0,0,0);
-		}
+	// For non-self, if the avatar is small enough visually, then don't update.
+        const F32 lod_factor = mLODFactor;
+	const F32 area_for_max_settings = 0.0;
+	const F32 area_for_min_settings = 1400.0;
+	const F32 area_for_this_setting = area_for_max_settings + (area_for_min_settings-area_for_max_settings)*(1.0-lod_factor);
+        const F32 pixel_area = sqrtf(mCharacter->getPixelArea());
+        
+        if ((pixel_area <= area_for_this_setting) && !mIsSelf)
+        {
+                return FALSE;
+        }
+
+        const F32 position_diff_local = llabs(mPositionLastUpdate_local-position_new_local_clamped);
+        const F32 min_delta = (1.0001f-lod_factor)*0.4f;
+        if (position_diff_local <= min_delta)
+        {
+                return FALSE;
+        }
 
-		const F32 position_new_local_clamped = llclamp(position_new_local,
-							       0.0f,
-							       1.0f);
+        mPositionLastUpdate_local = mPosition_local;
 
-		LLDriverParam *driver_param = dynamic_cast<LLDriverParam *>(mParamDriver);
-		llassert_always(driver_param);
-		if (driver_param)
+	LLDriverParam *driver_param = dynamic_cast<LLDriverParam *>(mParamDriver);
+	llassert_always(driver_param);
+	if (driver_param)
+	{
+		// If this is one of our "hidden" driver params, then make sure it's
+		// the default value.
+		if ((driver_param->getGroup() != VISUAL_PARAM_GROUP_TWEAKABLE) &&
+		    (driver_param->getGroup() != VISUAL_PARAM_GROUP_TWEAKABLE_NO_TRANSMIT))
 		{
-			// If this is one of our "hidden" driver params, then make sure it's
-			// the default value.
-			if ((driver_param->getGroup() != VISUAL_PARAM_GROUP_TWEAKABLE) &&
-			    (driver_param->getGroup() != VISUAL_PARAM_GROUP_TWEAKABLE_NO_TRANSMIT))
-			{
-				mCharacter->setVisualParamWeight(driver_param,
-								 0,
-								 FALSE);
-			}
-			for (LLDriverParam::entry_list_t::iterator iter = driver_param->mDriven.begin();
-			     iter != driver_param->mDriven.end();
-			     ++iter)
-			{
-				LLDrivenEntry &entry = (*iter);
-				LLViewerVisualParam *driven_param = entry.mParam;
-				setParamValue(driven_param,position_new_local_clamped, behavior_maxeffect);
-			}
+			mCharacter->setVisualParamWeight(driver_param,
+							 0,
+							 FALSE);
 		}
-        
-		//
-		// End calculate new params
-		////////////////////////////////////////////////////////////////////////////////
-
-		////////////////////////////////////////////////////////////////////////////////
-		// Conditionally update the visual params
-		//
-        
-		// Updating the visual params (i.e. what the user sees) is fairly expensive.
-		// So only update if the params have changed enough, and also take into account
-		// the graphics LOD settings.
-        
-		// For non-self, if the avatar is small enough visually, then don't update.
-		const F32 area_for_max_settings = 0.0;
-		const F32 area_for_min_settings = 1400.0;
-		const F32 area_for_this_setting = area_for_max_settings + (area_for_min_settings-area_for_max_settings)*(1.0-lod_factor);
-	        const F32 pixel_area = sqrtf(mCharacter->getPixelArea());
-        
-		const BOOL is_self = (dynamic_cast<LLVOAvatarSelf *>(mCharacter) != NULL);
-		if ((pixel_area > area_for_this_setting) || is_self)
+		for (LLDriverParam::entry_list_t::iterator iter = driver_param->mDriven.begin();
+		     iter != driver_param->mDriven.end();
+		     ++iter)
 		{
-			const F32 position_diff_local = llabs(mPositionLastUpdate_local-position_new_local_clamped);
-			const F32 min_delta = (1.0001f-lod_factor)*0.4f;
-			if (llabs(position_diff_local) > min_delta)
-			{
-				update_visuals = TRUE;
-				mPositionLastUpdate_local = position_new_local;
-			}
+			LLDrivenEntry &entry = (*iter);
+			LLViewerVisualParam *driven_param = entry.mParam;
+			setParamValue(driven_param,position_new_local_clamped, mBehaviorMaxEffect);
 		}
-
-		//
-		// End update visual params
-		////////////////////////////////////////////////////////////////////////////////
-
-		mVelocity_local = velocity_new_local;
-		mAccelerationJoint_local = acceleration_joint_local;
-		mPosition_local = position_new_local;
 	}
-	mLastTime = time;
-	mPosition_world = joint->getWorldPosition();
-	mVelocityJoint_local = velocity_joint_local;
-
-
-        /*
-          // Write out debugging info into a spreadsheet.
-          if (mFileWrite != NULL && is_self)
-          {
-          fprintf(mFileWrite,"%f\t%f\t%f \t\t%f \t\t%f\t%f\t%f\t \t\t%f\t%f\t%f\t%f\t%f \t\t%f\t%f\t%f\n",
-          position_new_local,
-          velocity_new_local,
-          acceleration_new_local,
-
-          time_delta,
-
-          mPosition_world[0],
-          mPosition_world[1],
-          mPosition_world[2],
-
-          force_net,
-          force_spring,
-          force_accel,
-          force_damping,
-          force_drag,
-
-          spring_length,
-          velocity_joint_local,
-          acceleration_joint_local
-          );
-          }
-        */
 
-        return update_visuals;
+        return TRUE;
 }
 
 // Range of new_value_local is assumed to be [0 , 1] normalized.
@@ -37,6 +37,7 @@
 #define PHYSICS_MOTION_FADEOUT_TIME 1.0f
 
 class LLPhysicsMotion;
+class LLPhysicsMotionBatch;
 
 //-----------------------------------------------------------------------------
 // class LLPhysicsMotion
@@ -105,10 +106,19 @@ public:
 
 	LLCharacter* getCharacter() { return mCharacter; }
 
+	// Between these, onUpdate() only gathers each avatar's motions and the
+	// whole set is simulated together in finishBatch()
+	static void beginBatch();
+	static void finishBatch();
+
 protected:
 	void addMotion(LLPhysicsMotion *motion);
+	void applyBatch();
 private:
 	LLCharacter*		mCharacter;
+	BOOL				mBatchPending;
+
+	static std::vector<LLPhysicsMotionController*>* sPending;
 
 	typedef std::vector<LLPhysicsMotion *> motion_vec_t;
 	motion_vec_t mMotions;
@@ -86,6 +86,7 @@ LLPolyMeshSharedData::LLPolyMeshSharedData()
         mNumTriangleIndices = 0;
 
         mReferenceData = NULL;
+        mDefaultVertexData = NULL;
 
         mLastIndexOffset = -1;
 }
@@ -159,6 +160,9 @@ void LLPolyMeshSharedData::freeMeshData()
         delete [] mTriangleIndices;
         mTriangleIndices = NULL;
 
+        ll_aligned_free_16(mDefaultVertexData);
+        mDefaultVertexData = NULL;
+
 //      mVertFaceMap.deleteAllData();
 }
 
@@ -217,6 +221,11 @@ U32 LLPolyMeshSharedData::getNumKB()
                 num_kb += mNumVertices * sizeof(float);         // weights
         }
 
+        if (mDefaultVertexData)
+        {
+                num_kb += mNumVertices * (2*4 + 3*3 + 2 + 4) * sizeof(F32);     // default morph output
+        }
+
         num_kb += mNumFaces * sizeof(LLPolyFace);       // faces
 
         num_kb /= 1024;
@@ -746,6 +755,7 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 	mReferenceMesh = reference_mesh;
 	mAvatarp = NULL;
 	mVertexData = NULL;
+	mVertexOwner = this;
 
 	mCurVertexCount = 0;
 	mFaceIndexCount = 0;
@@ -755,34 +765,16 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 
 	if (shared_data->isLOD() && reference_mesh)
 	{
-		mCoords = reference_mesh->mCoords;
-		mNormals = reference_mesh->mNormals;
-		mScaledNormals = reference_mesh->mScaledNormals;
-		mBinormals = reference_mesh->mBinormals;
-		mScaledBinormals = reference_mesh->mScaledBinormals;
-		mTexCoords = reference_mesh->mTexCoords;
-		mClothingWeights = reference_mesh->mClothingWeights;
+		// LODs always follow the reference mesh's output, even after it
+		// gets its own copy
+		mVertexOwner = reference_mesh->mVertexOwner;
+		setVertexPointers(NULL);
 	}
 	else
 	{
-		// Allocate memory without initializing every vector
-		// NOTE: This makes asusmptions about the size of LLVector[234]
-		int nverts = mSharedData->mNumVertices;
-		int nfloats = nverts * (2*4 + 3*3 + 2 + 4);
-		//use 16 byte aligned vertex data to make LLPolyMesh SSE friendly
-		mVertexData = (F32*) ll_aligned_malloc_16(nfloats*4);
-		int offset = 0;
-		mCoords				= 	(LLVector4*)(mVertexData + offset); offset += 4*nverts;
-		mNormals			=	(LLVector4*)(mVertexData + offset); offset += 4*nverts;
-		mClothingWeights	= 	(LLVector4*)(mVertexData + offset); offset += 4*nverts;
-		mTexCoords			= 	(LLVector2*)(mVertexData + offset); offset += 2*nverts;
-
-		// these members don't need to be 16-byte aligned, but the first one might be
-		// read during an aligned memcpy of mTexCoords
-		mScaledNormals =                (LLVector3*)(mVertexData + offset); offset += 3*nverts;
-		mBinormals =                    (LLVector3*)(mVertexData + offset); offset += 3*nverts;
-		mScaledBinormals =              (LLVector3*)(mVertexData + offset); offset += 3*nverts; 
-		initializeForMorph();
+		// Start out on the shared default arrays, most meshes on most
+		// avatars are never morphed away from them
+		setVertexPointers(mSharedData->getDefaultVertexData());
 	}
 }
 
@@ -908,7 +900,8 @@ void LLPolyMesh::dumpDiagInfo()
 //-----------------------------------------------------------------------------
 LLVector4 *LLPolyMesh::getWritableCoords()
 {
-        return mCoords;
+        makeVertexDataWritable();
+        return mVertexOwner->mCoords;
 }
 
 //-----------------------------------------------------------------------------
@@ -916,7 +909,8 @@ LLVector4 *LLPolyMesh::getWritableCoords()
 //-----------------------------------------------------------------------------
 LLVector4 *LLPolyMesh::getWritableNormals()
 {
-        return mNormals;
+        makeVertexDataWritable();
+        return mVertexOwner->mNormals;
 }
 
 //-----------------------------------------------------------------------------
@@ -924,7 +918,8 @@ LLVector4 *LLPolyMesh::getWritableNormals()
 //-----------------------------------------------------------------------------
 LLVector3 *LLPolyMesh::getWritableBinormals()
 {
-        return mBinormals;
+        makeVertexDataWritable();
+        return mVertexOwner->mBinormals;
 }
 
 
@@ -933,7 +928,8 @@ LLVector3 *LLPolyMesh::getWritableBinormals()
 //-----------------------------------------------------------------------------
 LLVector4       *LLPolyMesh::getWritableClothingWeights()
 {
-        return mClothingWeights;
+        makeVertexDataWritable();
+        return mVertexOwner->mClothingWeights;
 }
 
 //-----------------------------------------------------------------------------
@@ -941,7 +937,8 @@ LLVector4       *LLPolyMesh::getWritableClothingWeights()
 //-----------------------------------------------------------------------------
 LLVector2       *LLPolyMesh::getWritableTexCoords()
 {
-        return mTexCoords;
+        makeVertexDataWritable();
+        return mVertexOwner->mTexCoords;
 }
 
 //-----------------------------------------------------------------------------
@@ -949,7 +946,8 @@ LLVector2       *LLPolyMesh::getWritableTexCoords()
 //-----------------------------------------------------------------------------
 LLVector3 *LLPolyMesh::getScaledNormals()
 {
-        return mScaledNormals;
+        makeVertexDataWritable();
+        return mVertexOwner->mScaledNormals;
 }
 
 //-----------------------------------------------------------------------------
@@ -957,26 +955,106 @@ LLVector3 *LLPolyMesh::getScaledNormals()
 //-----------------------------------------------------------------------------
 LLVector3 *LLPolyMesh::getScaledBinormals()
 {
-        return mScaledBinormals;
+        makeVertexDataWritable();
+        return mVertexOwner->mScaledBinormals;
 }
 
 
 //-----------------------------------------------------------------------------
-// initializeForMorph()
+// setVertexPointers()
 //-----------------------------------------------------------------------------
-void LLPolyMesh::initializeForMorph()
+void LLPolyMesh::setVertexPointers(F32* data)
 {
-    for (U32 i = 0; i < mSharedData->mNumVertices; ++i)
+	if (!data)
+	{
+		mCoords = NULL;
+		mNormals = NULL;
+		mClothingWeights = NULL;
+		mTexCoords = NULL;
+		mScaledNormals = NULL;
+		mBinormals = NULL;
+		mScaledBinormals = NULL;
+		return;
+	}
+
+	// NOTE: This makes asusmptions about the size of LLVector[234]
+	int nverts = mSharedData->mNumVertices;
+	int offset = 0;
+	mCoords				= 	(LLVector4*)(data + offset); offset += 4*nverts;
+	mNormals			=	(LLVector4*)(data + offset); offset += 4*nverts;
+	mClothingWeights	= 	(LLVector4*)(data + offset); offset += 4*nverts;
+	mTexCoords			= 	(LLVector2*)(data + offset); offset += 2*nverts;
+
+	// these members don't need to be 16-byte aligned, but the first one might be
+	// read during an aligned memcpy of mTexCoords
+	mScaledNormals =                (LLVector3*)(data + offset); offset += 3*nverts;
+	mBinormals =                    (LLVector3*)(data + offset); offset += 3*nverts;
+	mScaledBinormals =              (LLVector3*)(data + offset); offset += 3*nverts; 
+}
+
+//-----------------------------------------------------------------------------
+// makeVertexDataWritable()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::makeVertexDataWritable()
+{
+	if (mVertexOwner != this)
+	{
+		mVertexOwner->makeVertexDataWritable();
+		return;
+	}
+
+	if (mVertexData)
 	{
-		mCoords[i] = LLVector4(mSharedData->mBaseCoords[i]);
-		mNormals[i] = LLVector4(mSharedData->mBaseNormals[i]);
+		return;
 	}
 
-	memcpy(mScaledNormals, mSharedData->mBaseNormals, sizeof(LLVector3) * mSharedData->mNumVertices);	/*Flawfinder: ignore*/
-	memcpy(mBinormals, mSharedData->mBaseBinormals, sizeof(LLVector3) * mSharedData->mNumVertices);	/*Flawfinder: ignore*/
-	memcpy(mScaledBinormals, mSharedData->mBaseBinormals, sizeof(LLVector3) * mSharedData->mNumVertices);		/*Flawfinder: ignore*/
-	memcpy(mTexCoords, mSharedData->mTexCoords, sizeof(LLVector2) * mSharedData->mNumVertices);		/*Flawfinder: ignore*/
-	memset(mClothingWeights, 0, sizeof(LLVector4) * mSharedData->mNumVertices);
+	LLMemType mt(LLMemType::MTYPE_AVATAR_MESH);
+
+	int nfloats = mSharedData->mNumVertices * (2*4 + 3*3 + 2 + 4);
+	//use 16 byte aligned vertex data to make LLPolyMesh SSE friendly
+	mVertexData = (F32*) ll_aligned_malloc_16(nfloats*4);
+	memcpy(mVertexData, mSharedData->getDefaultVertexData(), nfloats*4);	/*Flawfinder: ignore*/
+	setVertexPointers(mVertexData);
+}
+
+//-----------------------------------------------------------------------------
+// LLPolyMeshSharedData::getDefaultVertexData()
+//-----------------------------------------------------------------------------
+F32* LLPolyMeshSharedData::getDefaultVertexData()
+{
+	if (mDefaultVertexData || isLOD())
+	{
+		return mDefaultVertexData;
+	}
+
+	// Allocate memory without initializing every vector
+	// NOTE: This makes asusmptions about the size of LLVector[234]
+	int nverts = mNumVertices;
+	int nfloats = nverts * (2*4 + 3*3 + 2 + 4);
+	mDefaultVertexData = (F32*) ll_aligned_malloc_16(nfloats*4);
+
+	int offset = 0;
+	LLVector4* coords			= (LLVector4*)(mDefaultVertexData + offset); offset += 4*nverts;
+	LLVector4* normals			= (LLVector4*)(mDefaultVertexData + offset); offset += 4*nverts;
+	LLVector4* clothing_weights	= (LLVector4*)(mDefaultVertexData + offset); offset += 4*nverts;
+	LLVector2* tex_coords		= (LLVector2*)(mDefaultVertexData + offset); offset += 2*nverts;
+	LLVector3* scaled_normals	= (LLVector3*)(mDefaultVertexData + offset); offset += 3*nverts;
+	LLVector3* binormals		= (LLVector3*)(mDefaultVertexData + offset); offset += 3*nverts;
+	LLVector3* scaled_binormals	= (LLVector3*)(mDefaultVertexData + offset); offset += 3*nverts;
+
+	for (S32 i = 0; i < nverts; ++i)
+	{
+		coords[i] = LLVector4(mBaseCoords[i]);
+		normals[i] = LLVector4(mBaseNormals[i]);
+	}
+
+	memcpy(scaled_normals, mBaseNormals, sizeof(LLVector3) * nverts);	/*Flawfinder: ignore*/
+	memcpy(binormals, mBaseBinormals, sizeof(LLVector3) * nverts);	/*Flawfinder: ignore*/
+	memcpy(scaled_binormals, mBaseBinormals, sizeof(LLVector3) * nverts);		/*Flawfinder: ignore*/
+	memcpy(tex_coords, mTexCoords, sizeof(LLVector2) * nverts);		/*Flawfinder: ignore*/
+	memset(clothing_weights, 0, sizeof(LLVector4) * nverts);
+
+	return mDefaultVertexData;
 }
 
 //-----------------------------------------------------------------------------
@@ -1219,6 +1297,7 @@ LLPolyMorphData *clone_morph_param_duplicate(const LLPolyMorphData *src_data,
                 cloned_morph_data->mNormals[v] = src_data->mNormals[v];
                 cloned_morph_data->mBinormals[v] = src_data->mBinormals[v];
         }
+        cloned_morph_data->packDeltas();
         return cloned_morph_data;
 }
 
@@ -1234,6 +1313,7 @@ LLPolyMorphData *clone_morph_param_direction(const LLPolyMorphData *src_data,
                 cloned_morph_data->mNormals[v] = LLVector3(0,0,0);
                 cloned_morph_data->mBinormals[v] = LLVector3(0,0,0);
         }
+        cloned_morph_data->packDeltas();
         return cloned_morph_data;
 }
 
@@ -1255,6 +1335,7 @@ LLPolyMorphData *clone_morph_param_cleavage(const LLPolyMorphData *src_data,
                         cloned_morph_data->mBinormals[v][1] *= -1;
                 }
         }
+        cloned_morph_data->packDeltas();
         return cloned_morph_data;
 }
 
@@ -100,6 +100,10 @@ private:
 	LLPolyMeshSharedData*		mReferenceData;
 	S32							mLastIndexOffset;
 
+	// morph output arrays at their default values, laid out like
+	// LLPolyMesh::mVertexData and shared by every unmorphed instance
+	F32*						mDefaultVertexData;
+
 public:
 	// Temporarily...
 	// Triangle indices
@@ -129,6 +133,9 @@ private:
 	// Retrieve the number of KB of memory used by this instance
 	U32 getNumKB();
 
+	// Builds mDefaultVertexData on first use
+	F32* getDefaultVertexData();
+
 	// Load mesh data from file
 	BOOL loadMesh( const std::string& fileName );
 
@@ -218,7 +225,7 @@ public:
 
 	// Get coords
 	const LLVector4	*getCoords() const{
-		return mCoords;
+		return mVertexOwner->mCoords;
 	}
 
 	// non const version
@@ -226,12 +233,12 @@ public:
 
 	// Get normals
 	const LLVector4	*getNormals() const{ 
-		return mNormals; 
+		return mVertexOwner->mNormals; 
 	}
 
 	// Get normals
 	const LLVector3	*getBinormals() const{ 
-		return mBinormals; 
+		return mVertexOwner->mBinormals; 
 	}
 
 	// Get base mesh normals
@@ -255,7 +262,7 @@ public:
 
 	// Get texCoords
 	const LLVector2	*getTexCoords() const { 
-		return mTexCoords; 
+		return mVertexOwner->mTexCoords; 
 	}
 
 	// non const version
@@ -279,9 +286,12 @@ public:
 
 	const LLVector4		*getClothingWeights()
 	{
-		return mClothingWeights;	
+		return mVertexOwner->mClothingWeights;	
 	}
 
+	// TRUE once this mesh has its own copy of the morph output arrays
+	BOOL hasWritableVertexData() const { return mVertexOwner->mVertexData != NULL; }
+
 	//--------------------------------------------------------------------
 	// Face Data Access
 	//--------------------------------------------------------------------
@@ -330,7 +340,12 @@ public:
 	U32				mFaceIndexCount;
 	U32				mCurVertexCount;
 private:
-	void initializeForMorph();
+	// Points the morph output arrays into data
+	void setVertexPointers(F32* data);
+
+	// Replaces the shared default arrays with a private copy the first
+	// time a morph writes to this mesh
+	void makeVertexDataWritable();
 
 	// Dumps diagnostic information about the global mesh table
 	static void dumpDiagInfo();
@@ -338,8 +353,11 @@ private:
 protected:
 	// mesh data shared across all instances of a given mesh
 	LLPolyMeshSharedData	*mSharedData;
-	// Single array of floats for allocation / deletion
+	// Single array of floats for allocation / deletion, NULL while the
+	// output arrays still point at mSharedData->mDefaultVertexData
 	F32						*mVertexData;
+	// mesh whose output arrays are used, the reference mesh for LODs
+	LLPolyMesh				*mVertexOwner;
 	// deformed vertices (resulting from application of morph targets)
 	LLVector4				*mCoords;
 	// deformed normals (resulting from application of morph targets)
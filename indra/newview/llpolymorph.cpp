@@ -34,11 +34,27 @@
 #include "llwearable.h"
 #include "llxmltree.h"
 #include "llendianswizzle.h"
+#include "llvector4a.h"
 
 //#include "../tools/imdebug/imdebug.h"
 
 const F32 NORMAL_SOFTEN_FACTOR = 0.65f;
 
+// normalize3() that leaves degenerate vectors zero like LLVector3::normVec()
+static inline void normalize3_or_zero(LLVector4a& v)
+{
+	LLVector4a len_sqrd;
+	len_sqrd.setAllDot3(v, v);
+	LLVector4Logical valid = len_sqrd.greaterThan(LLVector4a(FP_MAG_THRESHOLD*FP_MAG_THRESHOLD));
+
+	LLVector4a normalized = v;
+	normalized.normalize3();
+
+	LLVector4a zero;
+	zero.clear();
+	v.setSelectWithMask(valid, normalized, zero);
+}
+
 //-----------------------------------------------------------------------------
 // LLPolyMorphData()
 //-----------------------------------------------------------------------------
@@ -55,6 +71,7 @@ LLPolyMorphData::LLPolyMorphData(const std::string& morph_name)
 	mNormals = NULL;
 	mBinormals = NULL;
 	mTexCoords = NULL;
+	mPackedDeltas = NULL;
 
 	mMesh = NULL;
 }
@@ -69,7 +86,8 @@ LLPolyMorphData::LLPolyMorphData(const LLPolyMorphData &rhs) :
 	mCoords(NULL),
 	mNormals(NULL),
 	mBinormals(NULL),
-	mTexCoords(NULL)
+	mTexCoords(NULL),
+	mPackedDeltas(NULL)
 {
 	const S32 numVertices = mNumIndices;
 
@@ -87,6 +105,8 @@ LLPolyMorphData::LLPolyMorphData(const LLPolyMorphData &rhs) :
 		mTexCoords[v] = rhs.mTexCoords[v];
 		mVertexIndices[v] = rhs.mVertexIndices[v];
 	}
+
+	packDeltas();
 }
 
 
@@ -100,6 +120,7 @@ LLPolyMorphData::~LLPolyMorphData()
 	delete [] mNormals;
 	delete [] mBinormals;
 	delete [] mTexCoords;
+	ll_aligned_free_16(mPackedDeltas);
 }
 
 //-----------------------------------------------------------------------------
@@ -203,9 +224,38 @@ BOOL LLPolyMorphData::loadBinary(LLFILE *fp, LLPolyMeshSharedData *mesh)
 	mAvgDistortion = mAvgDistortion * (1.f/(F32)mNumIndices);
 	mAvgDistortion.normVec();
 
+	packDeltas();
+
 	return TRUE;
 }
 
+//-----------------------------------------------------------------------------
+// packDeltas()
+//-----------------------------------------------------------------------------
+void LLPolyMorphData::packDeltas()
+{
+	ll_aligned_free_16(mPackedDeltas);
+	mPackedDeltas = NULL;
+
+	if (!mNumIndices)
+	{
+		return;
+	}
+
+	mPackedDeltas = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a) * 3 * mNumIndices);
+
+	LLVector4a* dst = mPackedDeltas;
+	for (U32 v = 0; v < mNumIndices; v++)
+	{
+		dst[0].load3(mCoords[v].mV);
+		dst[1].load3(mNormals[v].mV);
+		dst[1].mul(NORMAL_SOFTEN_FACTOR);
+		dst[2].load3(mBinormals[v].mV);
+		dst[2].mul(NORMAL_SOFTEN_FACTOR);
+		dst += 3;
+	}
+}
+
 //-----------------------------------------------------------------------------
 // LLPolyMorphTargetInfo()
 //-----------------------------------------------------------------------------
@@ -521,9 +571,23 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 
 		F32 *maskWeightArray = (mVertMask) ? mVertMask->getMorphMaskWeights() : NULL;
 
-		for(U32 vert_index_morph = 0; vert_index_morph < mMorphData->mNumIndices; vert_index_morph++)
+		if (!mMorphData->mPackedDeltas)
+		{
+			mMorphData->packDeltas();
+		}
+
+		// coords, normals and clothing weights are 16 byte aligned in the mesh
+		// (see LLPolyMesh::LLPolyMesh), the packed LLVector3 arrays are not
+		const LLVector4a* deltas = mMorphData->mPackedDeltas;
+		const U32* indices = mMorphData->mVertexIndices;
+		const LLVector2* morph_tex_coords = mMorphData->mTexCoords;
+		LLVector4* morph_clothing_weights = getInfo()->mIsClothingMorph ? clothing_weights : NULL;
+
+		LL_ALIGN_16(F32 out[4]);
+
+		for(U32 vert_index_morph = 0; vert_index_morph < mMorphData->mNumIndices; vert_index_morph++, deltas += 3)
 		{
-			S32 vert_index_mesh = mMorphData->mVertexIndices[vert_index_morph];
+			S32 vert_index_mesh = indices[vert_index_morph];
 
 			F32 maskWeight = 1.f;
 			if (maskWeightArray)
@@ -531,32 +595,56 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 				maskWeight = maskWeightArray[vert_index_morph];
 			}
 
-			coords[vert_index_mesh] += LLVector4(mMorphData->mCoords[vert_index_morph] * delta_weight * maskWeight);
+			F32 weight = delta_weight * maskWeight;
 
-			if (getInfo()->mIsClothingMorph && clothing_weights)
+			LLVector4a offset;
+			offset.setMul(deltas[0], LLVector4a(weight));
+
+			LLVector4a coord;
+			coord.load4a(coords[vert_index_mesh].mV);
+			coord.add(offset);
+			coord.store4a(coords[vert_index_mesh].mV);
+
+			if (morph_clothing_weights)
 			{
-				LLVector3 clothing_offset = mMorphData->mCoords[vert_index_morph] * delta_weight * maskWeight;
-				LLVector4* clothing_weight = &clothing_weights[vert_index_mesh];
-				clothing_weight->mV[VX] += clothing_offset.mV[VX];
-				clothing_weight->mV[VY] += clothing_offset.mV[VY];
-				clothing_weight->mV[VZ] += clothing_offset.mV[VZ];
+				LLVector4* clothing_weight = &morph_clothing_weights[vert_index_mesh];
+				LLVector4a clothing;
+				clothing.load4a(clothing_weight->mV);
+				clothing.add(offset);
+				clothing.store4a(clothing_weight->mV);
 				clothing_weight->mV[VW] = maskWeight;
 			}
 
 			// calculate new normals based on half angles
-			scaled_normals[vert_index_mesh] += mMorphData->mNormals[vert_index_morph] * delta_weight * maskWeight * NORMAL_SOFTEN_FACTOR;
-			LLVector3 normalized_normal = scaled_normals[vert_index_mesh];
-			normalized_normal.normVec();
-			normals[vert_index_mesh] = LLVector4(normalized_normal);
+			LLVector4a scaled_normal;
+			scaled_normal.load3(scaled_normals[vert_index_mesh].mV);
+			offset.setMul(deltas[1], LLVector4a(weight));
+			scaled_normal.add(offset);
+			scaled_normal.store4a(out);
+			scaled_normals[vert_index_mesh].set(out);
+
+			LLVector4a normal = scaled_normal;
+			normalize3_or_zero(normal);
+			normal.store4a(normals[vert_index_mesh].mV);
+			normals[vert_index_mesh].mV[VW] = 1.f;
 
 			// calculate new binormals
-			scaled_binormals[vert_index_mesh] += mMorphData->mBinormals[vert_index_morph] * delta_weight * maskWeight * NORMAL_SOFTEN_FACTOR;
-			LLVector3 tangent = scaled_binormals[vert_index_mesh] % normalized_normal;
-			LLVector3 normalized_binormal = normalized_normal % tangent; 
-			normalized_binormal.normVec();
-			binormals[vert_index_mesh] = normalized_binormal;
-
-			tex_coords[vert_index_mesh] += mMorphData->mTexCoords[vert_index_morph] * delta_weight * maskWeight;
+			LLVector4a scaled_binormal;
+			scaled_binormal.load3(scaled_binormals[vert_index_mesh].mV);
+			offset.setMul(deltas[2], LLVector4a(weight));
+			scaled_binormal.add(offset);
+			scaled_binormal.store4a(out);
+			scaled_binormals[vert_index_mesh].set(out);
+
+			LLVector4a tangent;
+			tangent.setCross3(scaled_binormal, normal);
+			LLVector4a binormal;
+			binormal.setCross3(normal, tangent);
+			normalize3_or_zero(binormal);
+			binormal.store4a(out);
+			binormals[vert_index_mesh].set(out);
+
+			tex_coords[vert_index_mesh] += morph_tex_coords[vert_index_morph] * weight;
 		}
 
 		// now apply volume changes
@@ -35,6 +35,7 @@
 class LLPolyMeshSharedData;
 class LLVOAvatar;
 class LLVector2;
+class LLVector4a;
 class LLViewerJointCollisionVolume;
 class LLWearable;
 
@@ -51,6 +52,9 @@ public:
 	BOOL			loadBinary(LLFILE* fp, LLPolyMeshSharedData *mesh);
 	const std::string& getName() { return mName; }
 
+	// Rebuild mPackedDeltas, call after changing mCoords, mNormals or mBinormals
+	void			packDeltas();
+
 public:
 	std::string			mName;
 
@@ -63,6 +67,10 @@ public:
 	LLVector3*			mBinormals;
 	LLVector2*			mTexCoords;
 
+	// 16 byte aligned coord, normal and binormal delta per index for the SSE
+	// morph kernel, normals and binormals are pre-scaled by the soften factor
+	LLVector4a*			mPackedDeltas;
+
 	F32					mTotalDistortion;	// vertex distortion summed over entire morph
 	F32					mMaxDistortion;		// maximum single vertex distortion in a given morph
 	LLVector3			mAvgDistortion;		// average vertex distortion, to infer directionality of the morph
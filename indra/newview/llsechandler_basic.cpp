@@ -36,6 +36,7 @@
 #include "lldir.h"
 #include "llviewercontrol.h"
 #include <vector>
+#include <algorithm>
 #include <ios>
 #include <openssl/ossl_typ.h>
 #include <openssl/x509.h>
@@ -90,7 +91,10 @@ LLBasicCertificate::LLBasicCertificate(X509* pCert)
 	{
 		throw LLInvalidCertificate(this);
 	}	
-	mCert = X509_dup(pCert);
+	// nothing here modifies the cert, so share it rather than paying for an
+	// encode/decode round trip with X509_dup on every verify callback
+	CRYPTO_add(&pCert->references, 1, CRYPTO_LOCK_X509);
+	mCert = pCert;
 }
 
 LLBasicCertificate::~LLBasicCertificate() 
@@ -581,6 +585,7 @@ LLPointer<LLCertificate> LLBasicCertificateVector::erase(iterator _iter)
 // uses a pem file such as the legacy CA.pem stored in the existing 
 // SL implementation.
 LLBasicCertificateStore::LLBasicCertificateStore(const std::string& filename)
+:	mCacheMutex(NULL)
 {
 	mFilename = filename;
 	load_from_file(filename);
@@ -685,28 +690,32 @@ LLBasicCertificateChain::LLBasicCertificateChain(const X509_STORE_CTX* store)
 		// if there are other certs in the chain, we build up a vector
 		// of untrusted certs so we can search for the parents of each
 		// consecutive cert.
-		LLBasicCertificateVector untrusted_certs;
+		// Only the names are needed to order the chain, so compare those
+		// directly instead of building the full LLSD of every cert.
+		std::vector<X509*> untrusted_certs;
+		std::vector<std::string> untrusted_subjects;
 		for(int i = 0; i < sk_X509_num(store->untrusted); i++)
 		{
-			LLPointer<LLCertificate> cert = new LLBasicCertificate(sk_X509_value(store->untrusted, i));
-			untrusted_certs.add(cert);
-
-		}		
+			X509* cert = sk_X509_value(store->untrusted, i);
+			untrusted_certs.push_back(cert);
+			untrusted_subjects.push_back(cert_string_name_from_X509_NAME(X509_get_subject_name(cert)));
+		}
+		X509* current_x509 = store->cert;
 		while(untrusted_certs.size() > 0)
 		{
-			LLSD find_data = LLSD::emptyMap();
-			LLSD cert_data;
-			current->getLLSD(cert_data);
 			// we simply build the chain via subject/issuer name as the
 			// client should not have passed in multiple CA's with the same 
 			// subject name.  If they did, it'll come out in the wash during
 			// validation.
-			find_data[CERT_SUBJECT_NAME_STRING] = cert_data[CERT_ISSUER_NAME_STRING]; 
-			LLBasicCertificateVector::iterator issuer = untrusted_certs.find(find_data);
-			if (issuer != untrusted_certs.end())
+			std::string issuer_name = cert_string_name_from_X509_NAME(X509_get_issuer_name(current_x509));
+			std::vector<std::string>::iterator issuer = std::find(untrusted_subjects.begin(), untrusted_subjects.end(), issuer_name);
+			if (issuer != untrusted_subjects.end())
 			{
-				current = untrusted_certs.erase(issuer);
-				add(current);
+				size_t index = issuer - untrusted_subjects.begin();
+				current_x509 = untrusted_certs[index];
+				add(new LLBasicCertificate(current_x509));
+				untrusted_certs.erase(untrusted_certs.begin() + index);
+				untrusted_subjects.erase(issuer);
 			}
 			else
 			{
@@ -1049,8 +1058,9 @@ void LLBasicCertificateStore::validate(int validation_policy,
 		throw LLInvalidCertificate((*current_cert));			
 	}
 	std::string sha1_hash((const char *)cert_x509->sha1_hash, SHA_DIGEST_LENGTH);
-	t_cert_cache::iterator cache_entry = mTrustedCertCache.find(sha1_hash);
-	if(cache_entry != mTrustedCertCache.end())
+	X509_free(cert_x509);
+	std::pair<LLDate, LLDate> cached_dates;
+	if(findTrustedCert(sha1_hash, cached_dates))
 	{
 		LL_DEBUGS("SECAPI") << "Found cert in cache" << LL_ENDL;	
 		// this cert is in the cache, so validate the time.
@@ -1062,8 +1072,8 @@ void LLBasicCertificateStore::validate(int validation_policy,
 				validation_date = validation_params[CERT_VALIDATION_DATE];
 			}
 			
-			if((validation_date < cache_entry->second.first) ||
-			   (validation_date > cache_entry->second.second))
+			if((validation_date < cached_dates.first) ||
+			   (validation_date > cached_dates.second))
 			{
 				throw LLCertValidationExpirationException((*current_cert), validation_date);
 			}
@@ -1112,7 +1122,7 @@ void LLBasicCertificateStore::validate(int validation_policy,
 		LLCertificateStore::iterator found_store_cert = find(cert_search_params);
 		if(found_store_cert != end())
 		{
-			mTrustedCertCache[sha1_hash] = std::pair<LLDate, LLDate>(from_time, to_time);
+			cacheTrustedCert(sha1_hash, from_time, to_time);
 			return;
 		}
 		
@@ -1149,7 +1159,7 @@ void LLBasicCertificateStore::validate(int validation_policy,
 				throw LLCertValidationInvalidSignatureException(*current_cert);
 			}			
 			// successfully validated.
-			mTrustedCertCache[sha1_hash] = std::pair<LLDate, LLDate>(from_time, to_time);		
+			cacheTrustedCert(sha1_hash, from_time, to_time);
 			return;
 		}
 		previous_cert = (*current_cert);
@@ -1166,7 +1176,26 @@ void LLBasicCertificateStore::validate(int validation_policy,
 		throw LLCertValidationTrustException((*cert_chain)[cert_chain->size()-1]);
 
 	}
-	mTrustedCertCache[sha1_hash] = std::pair<LLDate, LLDate>(from_time, to_time);	
+	cacheTrustedCert(sha1_hash, from_time, to_time);
+}
+
+// verify callbacks can come from the curl thread and the main thread at once
+bool LLBasicCertificateStore::findTrustedCert(const std::string& sha1_hash, std::pair<LLDate, LLDate>& dates)
+{
+	LLMutexLock lock(&mCacheMutex);
+	t_cert_cache::iterator cache_entry = mTrustedCertCache.find(sha1_hash);
+	if(cache_entry == mTrustedCertCache.end())
+	{
+		return false;
+	}
+	dates = cache_entry->second;
+	return true;
+}
+
+void LLBasicCertificateStore::cacheTrustedCert(const std::string& sha1_hash, const LLDate& from_time, const LLDate& to_time)
+{
+	LLMutexLock lock(&mCacheMutex);
+	mTrustedCertCache[sha1_hash] = std::pair<LLDate, LLDate>(from_time, to_time);
 }
 
 
@@ -29,6 +29,7 @@
 #define LLSECHANDLER_BASIC
 
 #include "llsecapi.h"
+#include "llthread.h"
 #include <vector>
 #include <openssl/x509.h>
 
@@ -185,6 +186,10 @@ protected:
 	// but the certs that have been validated against this store.
 	typedef std::map<std::string, std::pair<LLDate, LLDate> > t_cert_cache;
 	t_cert_cache mTrustedCertCache;
+	LLMutex mCacheMutex;
+
+	bool findTrustedCert(const std::string& sha1_hash, std::pair<LLDate, LLDate>& dates);
+	void cacheTrustedCert(const std::string& sha1_hash, const LLDate& from_time, const LLDate& to_time);
 	
 	std::string mFilename;
 };
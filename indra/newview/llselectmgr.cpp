@@ -6436,8 +6436,17 @@ void LLObjectSelection::addNodeAtEnd(LLSelectNode *nodep)
 
 void LLObjectSelection::moveNodeToFront(LLSelectNode *nodep)
 {
-	mList.remove(nodep);
-	mList.push_front(nodep);
+	// a node is only in the list once, so stop at it rather than letting
+	// list::remove() walk the whole selection
+	list_t::iterator iter = std::find(mList.begin(), mList.end(), nodep);
+	if (iter != mList.end())
+	{
+		mList.splice(mList.begin(), mList, iter);
+	}
+	else
+	{
+		mList.push_front(nodep);
+	}
 }
 
 void LLObjectSelection::removeNode(LLSelectNode *nodep)
@@ -6448,7 +6457,11 @@ void LLObjectSelection::removeNode(LLSelectNode *nodep)
 		mPrimaryObject = NULL;
 	}
 	nodep->setObject(NULL); // Will get erased in cleanupNodes()
-	mList.remove(nodep);
+	list_t::iterator iter = std::find(mList.begin(), mList.end(), nodep);
+	if (iter != mList.end())
+	{
+		mList.erase(iter);
+	}
 }
 
 void LLObjectSelection::deleteAllNodes()
@@ -6474,7 +6487,7 @@ LLSelectNode* LLObjectSelection::findNode(LLViewerObject* objectp)
 //-----------------------------------------------------------------------------
 BOOL LLObjectSelection::isEmpty() const
 {
-	return (mList.size() == 0);
+	return mList.empty();
 }
 
 
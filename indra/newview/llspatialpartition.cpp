@@ -1196,6 +1196,8 @@ LLSpatialGroup::LLSpatialGroup(OctreeNode* node, LLSpatialPartition* part) :
 	mBufferUsage(part->mBufferUsage),
 	mDistance(0.f),
 	mDepth(0.f),
+	mAlphaSortIndex(0),
+	mAlphaSortEpoch(0),
 	mLastUpdateDistance(-1.f), 
 	mLastUpdateTime(gFrameTimeSeconds),
 	mAtlasList(4),
@@ -1577,13 +1579,18 @@ void LLSpatialGroup::checkOcclusion()
 		}
 		else if (isOcclusionState(QUERY_PENDING))
 		{	//otherwise, if a query is pending, read it back
+			static LLCachedControl<bool> wait_for_results(gSavedSettings, "RenderOcclusionWaitForResults");
+
+			//a query issued before last frame was made while this group was out of view (or its result arrived late),
+			//the depth it was tested against no longer matches what is on screen
+			bool stale = mOcclusionIssued[LLViewerCamera::sCurCameraID] + 1 < gFrameCount;
 
 			GLuint available = 0;
 			if (mOcclusionQuery[LLViewerCamera::sCurCameraID])
 			{
 				glGetQueryObjectuivARB(mOcclusionQuery[LLViewerCamera::sCurCameraID], GL_QUERY_RESULT_AVAILABLE_ARB, &available);
 
-				if (mOcclusionIssued[LLViewerCamera::sCurCameraID] < gFrameCount)
+				if (wait_for_results && mOcclusionIssued[LLViewerCamera::sCurCameraID] < gFrameCount)
 				{ //query was issued last frame, wait until it's available
 					S32 max_loop = 1024;
 					LLFastTimer t(FTM_OCCLUSION_WAIT);
@@ -1620,8 +1627,8 @@ void LLSpatialGroup::checkOcclusion()
 					mOcclusionQuery[LLViewerCamera::sCurCameraID] = 0;
 				}
 				
-				if (isOcclusionState(DISCARD_QUERY))
-				{
+				if (isOcclusionState(DISCARD_QUERY) || stale)
+				{ //assume visible, the group is queried again if it gets occluded
 					res = 2;
 				}
 
@@ -1640,6 +1647,13 @@ void LLSpatialGroup::checkOcclusion()
 
 				clearOcclusionState(QUERY_PENDING | DISCARD_QUERY);
 			}
+			else if (stale && isOcclusionState(LLSpatialGroup::OCCLUDED))
+			{ //result is overdue, draw the group while it is outstanding rather than leave a hole
+				assert_states_valid(this);
+				clearOcclusionState(LLSpatialGroup::OCCLUDED, LLSpatialGroup::STATE_MODE_DIFF);
+				assert_states_valid(this);
+			}
+			//otherwise keep last frame's state and read the result next frame
 		}
 		else if (mSpatialPartition->isOcclusionEnabled() && isOcclusionState(LLSpatialGroup::OCCLUDED))
 		{	//check occlusion has been issued for occluded node that has not had a query issued
@@ -1920,8 +1934,8 @@ void LLSpatialPartition::shift(const LLVector4a &offset)
 class LLOctreeCull : public LLSpatialGroup::OctreeTraveler
 {
 public:
-	LLOctreeCull(LLCamera* camera)
-		: mCamera(camera), mRes(0) { }
+	LLOctreeCull(LLCamera* camera, LLCullResult* result = NULL)
+		: mCamera(camera), mResult(result), mRes(0) { }
 
 	virtual bool earlyFail(LLSpatialGroup* group)
 	{
@@ -2015,7 +2029,7 @@ public:
 		{
 			group->doOcclusion(mCamera);
 		}
-		gPipeline.markNotCulled(group, *mCamera);
+		gPipeline.markNotCulled(group, *mCamera, mResult);
 	}
 	
 	virtual void visit(const LLSpatialGroup::OctreeNode* branch) 
@@ -2031,14 +2045,15 @@ public:
 	}
 
 	LLCamera *mCamera;
+	LLCullResult* mResult;
 	S32 mRes;
 };
 
 class LLOctreeCullNoFarClip : public LLOctreeCull
 {
 public: 
-	LLOctreeCullNoFarClip(LLCamera* camera) 
-		: LLOctreeCull(camera) { }
+	LLOctreeCullNoFarClip(LLCamera* camera, LLCullResult* result = NULL) 
+		: LLOctreeCull(camera, result) { }
 
 	virtual S32 frustumCheck(const LLSpatialGroup* group)
 	{
@@ -2055,8 +2070,8 @@ public:
 class LLOctreeCullShadow : public LLOctreeCull
 {
 public:
-	LLOctreeCullShadow(LLCamera* camera)
-		: LLOctreeCull(camera) { }
+	LLOctreeCullShadow(LLCamera* camera, LLCullResult* result = NULL)
+		: LLOctreeCull(camera, result) { }
 
 	virtual S32 frustumCheck(const LLSpatialGroup* group)
 	{
@@ -2370,6 +2385,24 @@ BOOL LLSpatialPartition::visibleObjectsInFrustum(LLCamera& camera)
 S32 LLSpatialPartition::cull(LLCamera &camera, std::vector<LLDrawable *>* results, BOOL for_select)
 {
 	LLMemType mt(LLMemType::MTYPE_SPACE_PARTITION);
+	rebound();
+	
+	if (for_select)
+	{
+		LLOctreeSelect selecter(&camera, results);
+		selecter.traverse(mOctree);
+	}
+	else
+	{
+		LLFastTimer ftm(FTM_FRUSTUM_CULL);
+		frustumCull(camera);
+	}
+	
+	return 0;
+}
+
+void LLSpatialPartition::rebound()
+{
 #if LL_OCTREE_PARANOIA_CHECK
 	((LLSpatialGroup*)mOctree->getListener(0))->checkStates();
 #endif
@@ -2382,33 +2415,25 @@ S32 LLSpatialPartition::cull(LLCamera &camera, std::vector<LLDrawable *>* result
 #if LL_OCTREE_PARANOIA_CHECK
 	((LLSpatialGroup*)mOctree->getListener(0))->validate();
 #endif
+}
 
-	
-	if (for_select)
-	{
-		LLOctreeSelect selecter(&camera, results);
-		selecter.traverse(mOctree);
-	}
-	else if (LLPipeline::sShadowRender)
+void LLSpatialPartition::frustumCull(LLCamera& camera, LLCullResult* result)
+{
+	if (LLPipeline::sShadowRender)
 	{
-		LLFastTimer ftm(FTM_FRUSTUM_CULL);
-		LLOctreeCullShadow culler(&camera);
+		LLOctreeCullShadow culler(&camera, result);
 		culler.traverse(mOctree);
 	}
 	else if (mInfiniteFarClip || !LLPipeline::sUseFarClip)
 	{
-		LLFastTimer ftm(FTM_FRUSTUM_CULL);		
-		LLOctreeCullNoFarClip culler(&camera);
+		LLOctreeCullNoFarClip culler(&camera, result);
 		culler.traverse(mOctree);
 	}
 	else
 	{
-		LLFastTimer ftm(FTM_FRUSTUM_CULL);		
-		LLOctreeCull culler(&camera);
+		LLOctreeCull culler(&camera, result);
 		culler.traverse(mOctree);
 	}
-	
-	return 0;
 }
 
 BOOL earlyFail(LLCamera* camera, LLSpatialGroup* group)
@@ -4576,6 +4601,11 @@ LLVertexBuffer* LLGeometryManager::createVertexBuffer(U32 type_mask, U32 usage)
 
 LLCullResult::LLCullResult() 
 {
+	//clear() zeroes the render maps up to their previous size
+	for (U32 i = 0; i < LLRenderPass::NUM_RENDER_TYPES; i++)
+	{
+		mRenderMapSize[i] = 0;
+	}
 	clear();
 }
 
@@ -4780,6 +4810,35 @@ void LLCullResult::pushDrawInfo(U32 type, LLDrawInfo* draw_info)
 }
 
 
+void LLCullResult::append(LLCullResult& fragment)
+{
+	for (sg_list_t::iterator iter = fragment.beginVisibleGroups(); iter != fragment.endVisibleGroups(); ++iter)
+	{
+		pushVisibleGroup(*iter);
+	}
+	for (sg_list_t::iterator iter = fragment.beginAlphaGroups(); iter != fragment.endAlphaGroups(); ++iter)
+	{
+		pushAlphaGroup(*iter);
+	}
+	for (sg_list_t::iterator iter = fragment.beginOcclusionGroups(); iter != fragment.endOcclusionGroups(); ++iter)
+	{
+		pushOcclusionGroup(*iter);
+	}
+	for (sg_list_t::iterator iter = fragment.beginDrawableGroups(); iter != fragment.endDrawableGroups(); ++iter)
+	{
+		pushDrawableGroup(*iter);
+	}
+	for (drawable_list_t::iterator iter = fragment.beginVisibleList(); iter != fragment.endVisibleList(); ++iter)
+	{
+		pushDrawable(*iter);
+	}
+	for (bridge_list_t::iterator iter = fragment.beginVisibleBridge(); iter != fragment.endVisibleBridge(); ++iter)
+	{
+		pushBridge(*iter);
+	}
+	//draw infos are only pushed by stateSort, after fragments are merged
+}
+
 void LLCullResult::assertDrawMapsEmpty()
 {
 	for (U32 i = 0; i < LLRenderPass::NUM_RENDER_TYPES; i++)
@@ -4793,3 +4852,51 @@ void LLCullResult::assertDrawMapsEmpty()
 
 
 
+
+LLParallelCull::LLParallelCull(LLParallelFor& pool)
+: mPool(pool),
+  mPartitions(NULL),
+  mCameras(NULL)
+{
+}
+
+LLParallelCull::~LLParallelCull()
+{
+	for (U32 i = 0; i < mResults.size(); ++i)
+	{
+		delete mResults[i];
+	}
+	mResults.clear();
+}
+
+void LLParallelCull::cull(const std::vector<LLSpatialPartition*>& partitions, const std::vector<LLCamera>& cameras)
+{
+	llassert(partitions.size() == cameras.size());
+
+	//rebound records fast timers, which only the main thread may do
+	for (U32 i = 0; i < partitions.size(); ++i)
+	{
+		partitions[i]->rebound();
+	}
+
+	while (mResults.size() < partitions.size())
+	{
+		mResults.push_back(new LLCullResult());
+	}
+
+	mPartitions = &partitions;
+	mCameras = &cameras;
+	mPool.run(*this, partitions.size());
+	mPartitions = NULL;
+	mCameras = NULL;
+}
+
+//virtual
+void LLParallelCull::run(U32 index)
+{
+	LLCamera camera = (*mCameras)[index];
+	LLCullResult* result = mResults[index];
+
+	result->clear();
+	(*mPartitions)[index]->frustumCull(camera, result);
+}
@@ -40,6 +40,7 @@
 #include "llface.h"
 #include "llviewercamera.h"
 #include "llvector4a.h"
+#include "llparallelfor.h"
 #include <queue>
 
 #define SG_STATE_INHERIT_MASK (OCCLUDED)
@@ -48,6 +49,7 @@
 class LLSpatialPartition;
 class LLSpatialBridge;
 class LLSpatialGroup;
+class LLCullResult;
 class LLTextureAtlas;
 class LLTextureAtlasSlot;
 
@@ -160,6 +162,30 @@ public:
 
 	};
 
+	struct CompareRenderState
+	{ //sort by texture, then matrix, then vertex buffer and index offset so adjacent draws can share binds and merge
+		bool operator()(const LLDrawInfo* lhs, const LLDrawInfo* rhs) const
+		{
+			if (lhs == NULL || rhs == NULL)
+			{ //sort NULL down to the end
+				return lhs != NULL && rhs == NULL;
+			}
+			if (lhs->mTexture.get() != rhs->mTexture.get())
+			{
+				return lhs->mTexture.get() > rhs->mTexture.get();
+			}
+			if (lhs->mModelMatrix != rhs->mModelMatrix)
+			{
+				return lhs->mModelMatrix > rhs->mModelMatrix;
+			}
+			if (lhs->mVertexBuffer.get() != rhs->mVertexBuffer.get())
+			{
+				return lhs->mVertexBuffer.get() > rhs->mVertexBuffer.get();
+			}
+			return lhs->mOffset < rhs->mOffset;
+		}
+	};
+
 	struct CompareBump
 	{
 		bool operator()(const LLPointer<LLDrawInfo>& lhs, const LLPointer<LLDrawInfo>& rhs) 
@@ -422,6 +448,8 @@ public:
 	S32 mVisible[LLViewerCamera::NUM_CAMERAS];
 	F32 mDistance;
 	F32 mDepth;
+	U32 mAlphaSortIndex;	// position in the last world camera alpha sort
+	U32 mAlphaSortEpoch;	// which sort mAlphaSortIndex came from
 	F32 mLastUpdateDistance;
 	F32 mLastUpdateTime;
 	
@@ -473,6 +501,9 @@ public:
 
 	BOOL visibleObjectsInFrustum(LLCamera& camera);
 	S32 cull(LLCamera &camera, std::vector<LLDrawable *>* results = NULL, BOOL for_select = FALSE); // Cull on arbitrary frustum
+	void rebound();
+	//frustum cull an already rebound octree into result (sCull if NULL), safe off the main thread when no occlusion queries are used
+	void frustumCull(LLCamera& camera, LLCullResult* result = NULL);
 	
 	BOOL isVisible(const LLVector3& v);
 	bool isHUDPartition() ;
@@ -589,6 +620,9 @@ public:
 
 	void assertDrawMapsEmpty();
 
+	//append the groups, drawables and bridges of a fragment culled on another thread
+	void append(LLCullResult& fragment);
+
 private:
 	U32					mVisibleGroupsSize;
 	U32					mAlphaGroupsSize;
@@ -614,6 +648,30 @@ private:
 	drawinfo_list_t::iterator mRenderMapEnd[LLRenderPass::NUM_RENDER_TYPES];
 };
 
+//culls a list of spatial partitions on worker threads, one result fragment per partition
+//only valid for passes that do not issue occlusion queries (see LLPipeline::updateCull)
+class LLParallelCull : public LLParallelFor::Body
+{
+public:
+	LLParallelCull(LLParallelFor& pool);
+	~LLParallelCull();
+
+	//rebound and cull each partition with the matching camera, blocks until all are done
+	//the calling thread culls partitions as well
+	void cull(const std::vector<LLSpatialPartition*>& partitions, const std::vector<LLCamera>& cameras);
+
+	//fragment for partition index of the last cull
+	LLCullResult& getResult(U32 index)	{ return *mResults[index]; }
+
+	/*virtual*/ void run(U32 index);
+
+private:
+	LLParallelFor& mPool;
+
+	const std::vector<LLSpatialPartition*>* mPartitions;
+	const std::vector<LLCamera>* mCameras;
+	std::vector<LLCullResult*> mResults;
+};
 
 //spatial partition for water (implemented in LLVOWater.cpp)
 class LLWaterPartition : public LLSpatialPartition
@@ -692,6 +750,14 @@ class LLVolumeGeometryManager: public LLGeometryManager
 	virtual void getGeometry(LLSpatialGroup* group);
 	void genDrawInfo(LLSpatialGroup* group, U32 mask, std::vector<LLFace*>& faces, BOOL distance_sort = FALSE, BOOL batch_textures = FALSE);
 	void registerFace(LLSpatialGroup* group, LLFace* facep, U32 type);
+
+protected:
+	//defer face geometry fills while buffers are mapped, then run them on the render workers and unmap
+	void beginGeometryFill();
+	void finishGeometryFill();
+
+	static std::vector<LLFace::GeometryFill> sGeometryFills;
+	static std::vector<LLPointer<LLVertexBuffer> > sFillBuffers; //buffers to unmap once their fills are done
 };
 
 //spatial partition that uses volume geometry manager (implemented in LLVOVolume.cpp)
@@ -923,21 +923,27 @@ void LLLocalSpeakerMgr::updateSpeakerList()
 	LLWorld::getInstance()->getAvatars(&avatar_ids, &positions, gAgent.getPositionGlobal(), CHAT_NORMAL_RADIUS);
 	for(U32 i=0; i<avatar_ids.size(); i++)
 	{
-		setSpeaker(avatar_ids[i]);
+		// only arrivals and speakers whose status setSpeaker() would change,
+		// everyone else already in range is left alone
+		speaker_map_t::const_iterator found_it = mSpeakers.find(avatar_ids[i]);
+		if (found_it == mSpeakers.end()
+			|| found_it->second->mStatus > LLSpeaker::STATUS_TEXT_ONLY
+			|| found_it->second->mType != LLSpeaker::SPEAKER_AGENT)
+		{
+			setSpeaker(avatar_ids[i]);
+		}
 	}
 
-	// check if text only speakers have moved out of chat range
+	// check if text only speakers have moved out of chat range, using the
+	// list we just got instead of looking every speaker up again
+	std::sort(avatar_ids.begin(), avatar_ids.end());
 	for (speaker_map_t::iterator speaker_it = mSpeakers.begin(); speaker_it != mSpeakers.end(); ++speaker_it)
 	{
-		LLUUID speaker_id = speaker_it->first;
 		LLSpeaker* speakerp = speaker_it->second;
-		if (speakerp->mStatus == LLSpeaker::STATUS_TEXT_ONLY)
+		if (speakerp->mStatus == LLSpeaker::STATUS_TEXT_ONLY
+			&& !std::binary_search(avatar_ids.begin(), avatar_ids.end(), speaker_it->first))
 		{
-			LLVOAvatar* avatarp = (LLVOAvatar*)gObjectList.findObject(speaker_id);
-			if (!avatarp || dist_vec_squared(avatarp->getPositionAgent(), gAgent.getPositionAgent()) > CHAT_NORMAL_RADIUS_SQUARED)
-			{
-				setSpeakerNotInChannel(speakerp);
-			}
+			setSpeakerNotInChannel(speakerp);
 		}
 	}
 }
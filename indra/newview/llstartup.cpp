@@ -270,6 +270,7 @@ void trust_cert_done(const LLSD& notification, const LLSD& response);
 void apply_udp_blacklist(const std::string& csv);
 bool process_login_success_response();
 void transition_back_to_login_panel(const std::string& emsg);
+void prewarm_floaters();
 
 void callback_cache_name(const LLUUID& id, const std::string& full_name, bool is_group)
 {
@@ -647,6 +648,11 @@ bool idle_startup()
 				msg->mPacketRing.setUseOutThrottle(TRUE);
 				msg->mPacketRing.setOutBandwidth(outBandwidth);
 			}
+
+			if (gSavedSettings.getBOOL("MessageReceiveThread"))
+			{
+				msg->mPacketRing.startReceiveThread(msg->mSocket);
+			}
 		}
 
 		LL_INFOS("AppInit") << "Message System Initialized." << LL_ENDL;
@@ -2304,6 +2310,8 @@ bool idle_startup()
 		LLIMFloater::initIMFloater();
 		display_startup();
 
+		prewarm_floaters();
+
 		return TRUE;
 	}
 
@@ -2315,6 +2323,39 @@ bool idle_startup()
 // local function definition
 //
 
+// Builds one floater per idle callback, so the hitch of parsing its XUI is
+// spread out and paid before the user first asks for it.  Floaters that
+// destroy themselves on close (no reuse_instance) only gain on their first
+// open.
+static bool prewarm_next_floater(boost::shared_ptr<std::vector<std::string> > names)
+{
+	while (!names->empty())
+	{
+		std::string name = names->back();
+		names->pop_back();
+		LLStringUtil::trim(name);
+		if (!name.empty() && !LLFloaterReg::findInstance(name))
+		{
+			LL_DEBUGS("AppInit") << "Prewarming floater " << name << LL_ENDL;
+			LLFloaterReg::getInstance(name);
+			return names->empty();
+		}
+	}
+	return true;
+}
+
+void prewarm_floaters()
+{
+	boost::shared_ptr<std::vector<std::string> > names(new std::vector<std::string>);
+	LLStringUtil::getTokens(gSavedSettings.getString("PrewarmFloaters"), *names, std::string(","));
+	if (!names->empty())
+	{
+		// build them in the order listed
+		std::reverse(names->begin(), names->end());
+		doOnIdleRepeating(boost::bind(&prewarm_next_floater, names));
+	}
+}
+
 void login_show()
 {
 	LL_INFOS("AppInit") << "Initializing Login Screen" << LL_ENDL;
@@ -42,6 +42,7 @@
 #include "llvlcomposition.h"
 #include "lldrawpool.h"
 #include "noise.h"
+#include "llvector4a.h"
 
 extern U64 gFrameTime;
 extern LLPipeline gPipeline;
@@ -354,6 +355,73 @@ void LLSurfacePatch::calcNormal(const U32 x, const U32 y, const U32 stride)
 	*(mDataNorm + surface_stride * y + x) = normal;
 }
 
+// Normals more than two grids from every edge only sample this patch, so the
+// neighbor lookups in calcNormal() are skipped and four are done at a time.
+void LLSurfacePatch::calcMiddleNormals()
+{
+	const U32 stride = 2;
+	const U32 grids_per_patch_edge = mSurfacep->getGridsPerPatchEdge();
+	const U32 surface_stride = mSurfacep->getGridsPerEdge();
+	const F32 mpg = mSurfacep->getMetersPerGrid() * stride;
+
+	// With c1 = p11 - p00 and c2 = p01 - p10 as in calcNormal(), c1 % c2 is
+	// (2mpg (dz2 - dz1), -2mpg (dz1 + dz2), 8mpg^2)
+	LLVector4a two_mpg, neg_two_mpg, normal_z, normal_z_sq;
+	two_mpg.splat(2.f * mpg);
+	neg_two_mpg.splat(-2.f * mpg);
+	normal_z.splat(8.f * mpg * mpg);
+	normal_z_sq.setMul(normal_z, normal_z);
+
+	llassert(mDataNorm);
+	for (U32 j = stride; j < grids_per_patch_edge - stride; j++)
+	{
+		const F32* south = mDataZ + (j - stride)*surface_stride;
+		const F32* north = mDataZ + (j + stride)*surface_stride;
+		LLVector3* normals = mDataNorm + j*surface_stride;
+
+		U32 i = stride;
+		for (; i + 4 <= grids_per_patch_edge - stride; i += 4)
+		{
+			LLVector4a z00, z01, z10, z11;
+			z00.loadua(south + i - stride);
+			z10.loadua(south + i + stride);
+			z01.loadua(north + i - stride);
+			z11.loadua(north + i + stride);
+
+			LLVector4a dz1, dz2;
+			dz1.setSub(z11, z00);
+			dz2.setSub(z01, z10);
+
+			LLVector4a nx, ny, nz;
+			nx.setSub(dz2, dz1);
+			nx.mul(two_mpg);
+			ny.setAdd(dz1, dz2);
+			ny.mul(neg_two_mpg);
+
+			LLVector4a len, tmp;
+			len.setMul(nx, nx);
+			tmp.setMul(ny, ny);
+			len.add(tmp);
+			len.add(normal_z_sq);
+			len = _mm_sqrt_ps(len);
+
+			nx.div(len);
+			ny.div(len);
+			nz.setDiv(normal_z, len);
+
+			for (U32 k = 0; k < 4; k++)
+			{
+				normals[i + k].set(nx[k], ny[k], nz[k]);
+			}
+		}
+
+		for (; i < grids_per_patch_edge - stride; i++)
+		{
+			calcNormal(i, j, stride);
+		}
+	}
+}
+
 const LLVector3 &LLSurfacePatch::getNormal(const U32 x, const U32 y) const
 {
 	U32 surface_stride = mSurfacep->getGridsPerEdge();
@@ -589,13 +657,7 @@ void LLSurfacePatch::updateNormals()
 	// update the middle normals
 	if (mNormalsInvalid[MIDDLE])
 	{
-		for (j=2; j < grids_per_patch_edge - 2; j++)
-		{
-			for (i=2; i < grids_per_patch_edge - 2; i++)
-			{
-				calcNormal(i, j, 2);
-			}
-		}
+		calcMiddleNormals();
 		dirty_patch = TRUE;
 	}
 
@@ -849,6 +911,9 @@ void LLSurfacePatch::updateVisibility()
 	}
 
 	const F32 DEFAULT_DELTA_ANGLE 	= (0.15f);
+	// fraction of the distance the camera has to move past a stride boundary
+	// before the patch switches, so hovering near one doesn't keep rebuilding
+	const F32 LOD_HYSTERESIS		= (0.25f);
 	U32 old_render_stride, max_render_stride;
 	U32 new_render_level;
 	F32 stride_per_distance = DEFAULT_DELTA_ANGLE / mSurfacep->getMetersPerGrid();
@@ -884,7 +949,24 @@ void LLSurfacePatch::updateVisibility()
 
 		// We only use render_strides that are powers of two, so we use look-up tables to figure out
 		// the render_level and corresponding render_stride
-		new_render_level = mVisInfo.mRenderLevel = mSurfacep->getRenderLevel(max_render_stride);
+		new_render_level = mSurfacep->getRenderLevel(max_render_stride);
+
+		if (old_render_stride)
+		{
+			// Keep the current stride while it would still be chosen with the
+			// distance nudged by the hysteresis in either direction. Levels
+			// count down as the stride grows.
+			U32 near_stride = llmin((U32)lltrunc(mVisInfo.mDistance * (1.f - LOD_HYSTERESIS) * stride_per_distance), 2*grids_per_patch_edge);
+			U32 far_stride = llmin((U32)lltrunc(mVisInfo.mDistance * (1.f + LOD_HYSTERESIS) * stride_per_distance), 2*grids_per_patch_edge);
+			U32 old_render_level = (U32)mVisInfo.mRenderLevel;
+			if (old_render_level <= mSurfacep->getRenderLevel(near_stride) &&
+				old_render_level >= mSurfacep->getRenderLevel(far_stride))
+			{
+				new_render_level = old_render_level;
+			}
+		}
+
+		mVisInfo.mRenderLevel = new_render_level;
 		mVisInfo.mRenderStride = mSurfacep->getRenderStride(new_render_level);
 
 		if ((mVisInfo.mRenderStride != old_render_stride)) 
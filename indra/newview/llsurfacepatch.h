@@ -103,6 +103,7 @@ public:
 	LLVector2 getTexCoords(const U32 x, const U32 y) const;
 
 	void calcNormal(const U32 x, const U32 y, const U32 stride);
+	void calcMiddleNormals();
 	const LLVector3 &getNormal(const U32 x, const U32 y) const;
 
 	void eval(const U32 x, const U32 y, const U32 stride,
@@ -30,6 +30,8 @@
 
 #include "llagent.h"
 #include "llimagej2c.h"
+#include "llimageworker.h"
+#include "llappviewer.h"
 #include "llimagetga.h"
 #include "llnotificationsutil.h"
 #include "llvfile.h"
@@ -54,6 +56,7 @@ using namespace LLVOAvatarDefines;
 
 static const S32 BAKE_UPLOAD_ATTEMPTS = 7;
 static const F32 BAKE_UPLOAD_RETRY_DELAY = 2.f; // actual delay grows by power of 2 each attempt
+static const S32 BAKE_UPLOADED_CACHE_SIZE = 4; // final bakes remembered per layer set for reuse
 
 class LLTexLayerInfo
 {
@@ -98,15 +101,52 @@ private:
 LLBakedUploadData::LLBakedUploadData(const LLVOAvatarSelf* avatar,
 									 LLTexLayerSet* layerset,
 									 const LLUUID& id,
-									 bool highest_res) :
+									 bool highest_res,
+									 U32 bake_crc) :
 	mAvatar(avatar),
 	mTexLayerSet(layerset),
 	mID(id),
 	mStartTime(LLFrameTimer::getTotalTime()),		// Record starting time
-	mIsHighestRes(highest_res)
+	mIsHighestRes(highest_res),
+	mBakeCRC(bake_crc)
 { 
 }
 
+//-----------------------------------------------------------------------------
+// LLBakedEncodeResponder
+// Holds the result of a bake encode running on the image decode thread until
+// the owning LLTexLayerSetBuffer picks it up on the main thread.
+//-----------------------------------------------------------------------------
+class LLBakedEncodeResponder : public LLImageDecodeThread::EncodeResponder
+{
+public:
+	LLBakedEncodeResponder(LLImageJ2C* image, bool highest_lod, U32 bake_crc) :
+		mImage(image),
+		mHighestLOD(highest_lod),
+		mBakeCRC(bake_crc),
+		mSuccess(false)
+	{
+		mDone = 0;
+	}
+
+	// DECODE THREAD
+	/*virtual*/ void completed(bool success, LLImageJ2C* image)
+	{
+		mSuccess = success;
+		mDone = 1;
+	}
+
+	bool isDone() const			{ return mDone != 0; }
+
+	LLPointer<LLImageJ2C> mImage;
+	const bool mHighestLOD;
+	const U32 mBakeCRC;
+	bool mSuccess;
+
+private:
+	LLAtomicU32 mDone;
+};
+
 //-----------------------------------------------------------------------------
 // LLTexLayerSetBuffer
 // The composite image that a LLTexLayerSet writes to.  Each LLTexLayerSet has one.
@@ -174,6 +214,7 @@ void LLTexLayerSetBuffer::requestUpdate()
 	// If we're in the middle of uploading a baked texture, we don't care about it any more.
 	// When it's downloaded, ignore it.
 	mUploadID.setNull();
+	mPendingEncode = NULL;
 }
 
 void LLTexLayerSetBuffer::requestUpload()
@@ -212,6 +253,8 @@ void LLTexLayerSetBuffer::cancelUpload()
 	mUploadPending = FALSE;
 	mNeedsUploadTimer.pause();
 	mUploadRetryTimer.reset();
+	// Let any encode in flight finish on its own, the result is dropped
+	mPendingEncode = NULL;
 }
 
 void LLTexLayerSetBuffer::pushProjection() const
@@ -240,6 +283,8 @@ BOOL LLTexLayerSetBuffer::needsRender()
 	llassert(mTexLayerSet->getAvatar() == gAgentAvatarp);
 	if (!isAgentAvatarValid()) return FALSE;
 
+	checkPendingEncode();
+
 	const BOOL upload_now = mNeedsUpload && isReadyToUpload();
 	const BOOL update_now = mNeedsUpdate && isReadyToUpdate();
 
@@ -378,6 +423,7 @@ BOOL LLTexLayerSetBuffer::uploadInProgress() const
 
 BOOL LLTexLayerSetBuffer::isReadyToUpload() const
 {
+	if (mPendingEncode.notNull()) return FALSE; // Still encoding the previous read back.
 	if (!gAgentQueryManager.hasNoPendingQueries()) return FALSE; // Can't upload if there are pending queries.
 	if (isAgentAvatarValid() && !gAgentAvatarp->isUsingBakedTextures()) return FALSE; // Don't upload if avatar is using composites.
 
@@ -492,103 +538,173 @@ void LLTexLayerSetBuffer::doUpload()
 			i++;
 		}
 	}
-	
+
+	delete [] baked_color_data;
+
+	const bool highest_lod = mTexLayerSet->isLocalTextureDataFinal();
+
+	// An identical final bake is already on the server (e.g. switching back to a
+	// previous outfit), so point at it instead of encoding and sending it again.
+	LLCRC bake_crc;
+	bake_crc.update(baked_image_data, mFullWidth * mFullHeight * baked_image_components);
+	const U32 bake_crc_value = bake_crc.getCRC();
+	if (highest_lod)
+	{
+		baked_id_map_t::iterator found = mUploadedBakes.find(bake_crc_value);
+		if (found != mUploadedBakes.end())
+		{
+			llinfos << "Reusing baked " << mTexLayerSet->getBodyRegionName() << " " << found->second << llendl;
+			mUploadPending = FALSE;
+			mNeedsUpload = FALSE;
+			mNeedsUploadTimer.pause();
+			gAgentAvatarp->setNewBakedTexture(gAgentAvatarp->getBakedTE(mTexLayerSet), found->second);
+			return;
+		}
+	}
+
 	LLPointer<LLImageJ2C> compressedImage = new LLImageJ2C;
 	compressedImage->setRate(0.f);
-	const char* comment_text = LINDEN_J2C_COMMENT_PREFIX "RGBHM"; // writes into baked_color_data. 5 channels (rgb, heightfield/alpha, mask)
+	const char* comment_text = LINDEN_J2C_COMMENT_PREFIX "RGBHM"; // 5 channels (rgb, heightfield/alpha, mask)
+
+	static LLCachedControl<bool> async_encode(gSavedSettings, "AvatarBakedTextureAsyncEncode");
+	LLImageDecodeThread* decode_thread = LLAppViewer::getImageDecodeThread();
+	if (async_encode && decode_thread)
+	{
+		// The encode takes long enough to hitch the frame, run it on the decode
+		// thread and pick the result up in checkPendingEncode().
+		LLPointer<LLBakedEncodeResponder> responder = new LLBakedEncodeResponder(compressedImage, highest_lod, bake_crc_value);
+		if (decode_thread->encodeImage(baked_image, compressedImage, comment_text,
+									   LLQueuedThread::PRIORITY_HIGH, responder) != LLQueuedThread::nullHandle())
+		{
+			mPendingEncode = responder;
+			return;
+		}
+	}
+
 	if (compressedImage->encode(baked_image, comment_text))
 	{
-		LLTransactionID tid;
-		tid.generate();
-		const LLAssetID asset_id = tid.makeAssetID(gAgent.getSecureSessionID());
-		if (LLVFile::writeFile(compressedImage->getData(), compressedImage->getDataSize(),
-							   gVFS, asset_id, LLAssetType::AT_TEXTURE))
-		{
-			// Read back the file and validate.
-			BOOL valid = FALSE;
-			LLPointer<LLImageJ2C> integrity_test = new LLImageJ2C;
-			S32 file_size = 0;
-			U8* data = LLVFile::readFile(gVFS, asset_id, LLAssetType::AT_TEXTURE, &file_size);
-			if (data)
+		finishUpload(compressedImage, highest_lod, bake_crc_value);
+	}
+	else
+	{
+		mUploadPending = FALSE;
+		llinfos << "Unable to create baked upload file (reason: failed to encode)" << llendl;
+	}
+}
+
+void LLTexLayerSetBuffer::checkPendingEncode()
+{
+	if (mPendingEncode.isNull() || !mPendingEncode->isDone())
+	{
+		return;
+	}
+
+	LLPointer<LLBakedEncodeResponder> encode = mPendingEncode;
+	mPendingEncode = NULL;
+
+	if (encode->mSuccess)
+	{
+		finishUpload(encode->mImage, encode->mHighestLOD, encode->mBakeCRC);
+	}
+	else
+	{
+		mUploadPending = FALSE;
+		llinfos << "Unable to create baked upload file (reason: failed to encode)" << llendl;
+	}
+}
+
+void LLTexLayerSetBuffer::finishUpload(LLImageJ2C* compressedImage, bool highest_lod, U32 bake_crc)
+{
+	LLTransactionID tid;
+	tid.generate();
+	const LLAssetID asset_id = tid.makeAssetID(gAgent.getSecureSessionID());
+	if (LLVFile::writeFile(compressedImage->getData(), compressedImage->getDataSize(),
+						   gVFS, asset_id, LLAssetType::AT_TEXTURE))
+	{
+		// Read back the file and validate.
+		BOOL valid = FALSE;
+		LLPointer<LLImageJ2C> integrity_test = new LLImageJ2C;
+		S32 file_size = 0;
+		U8* data = LLVFile::readFile(gVFS, asset_id, LLAssetType::AT_TEXTURE, &file_size);
+		if (data)
+		{
+			valid = integrity_test->validate(data, file_size); // integrity_test will delete 'data'
+		}
+		else
+		{
+			integrity_test->setLastError("Unable to read entire file");
+		}
+		
+		if (valid)
+		{
+			// Baked_upload_data is owned by the responder and deleted after the request completes.
+			LLBakedUploadData* baked_upload_data = new LLBakedUploadData(gAgentAvatarp, 
+																		 this->mTexLayerSet, 
+																		 asset_id,
+																		 highest_lod,
+																		 bake_crc);
+			// upload ID is used to avoid overlaps, e.g. when the user rapidly makes two changes outside of Face Edit.
+			mUploadID = asset_id;
+
+			// Upload the image
+			const std::string url = gAgent.getRegion()->getCapability("UploadBakedTexture");
+			if(!url.empty()
+				&& !LLPipeline::sForceOldBakedUpload // toggle debug setting UploadBakedTexOld to change between the new caps method and old method
+				&& (mUploadFailCount < (BAKE_UPLOAD_ATTEMPTS - 1))) // Try last ditch attempt via asset store if cap upload is failing.
 			{
-				valid = integrity_test->validate(data, file_size); // integrity_test will delete 'data'
-			}
+				LLSD body = LLSD::emptyMap();
+				// The responder will call LLTexLayerSetBuffer::onTextureUploadComplete()
+				LLHTTPClient::post(url, body, new LLSendTexLayerResponder(body, mUploadID, LLAssetType::AT_TEXTURE, baked_upload_data));
+				llinfos << "Baked texture upload via capability of " << mUploadID << " to " << url << llendl;
+			} 
 			else
 			{
-				integrity_test->setLastError("Unable to read entire file");
+				gAssetStorage->storeAssetData(tid,
+											  LLAssetType::AT_TEXTURE,
+											  LLTexLayerSetBuffer::onTextureUploadComplete,
+											  baked_upload_data,
+											  TRUE,		// temp_file
+											  TRUE,		// is_priority
+											  TRUE);	// store_local
+				llinfos << "Baked texture upload via Asset Store." <<  llendl;
 			}
-			
-			if (valid)
-			{
-				const bool highest_lod = mTexLayerSet->isLocalTextureDataFinal();
-				// Baked_upload_data is owned by the responder and deleted after the request completes.
-				LLBakedUploadData* baked_upload_data = new LLBakedUploadData(gAgentAvatarp, 
-																			 this->mTexLayerSet, 
-																			 asset_id,
-																			 highest_lod);
-				// upload ID is used to avoid overlaps, e.g. when the user rapidly makes two changes outside of Face Edit.
-				mUploadID = asset_id;
-
-				// Upload the image
-				const std::string url = gAgent.getRegion()->getCapability("UploadBakedTexture");
-				if(!url.empty()
-					&& !LLPipeline::sForceOldBakedUpload // toggle debug setting UploadBakedTexOld to change between the new caps method and old method
-					&& (mUploadFailCount < (BAKE_UPLOAD_ATTEMPTS - 1))) // Try last ditch attempt via asset store if cap upload is failing.
-				{
-					LLSD body = LLSD::emptyMap();
-					// The responder will call LLTexLayerSetBuffer::onTextureUploadComplete()
-					LLHTTPClient::post(url, body, new LLSendTexLayerResponder(body, mUploadID, LLAssetType::AT_TEXTURE, baked_upload_data));
-					llinfos << "Baked texture upload via capability of " << mUploadID << " to " << url << llendl;
-				} 
-				else
-				{
-					gAssetStorage->storeAssetData(tid,
-												  LLAssetType::AT_TEXTURE,
-												  LLTexLayerSetBuffer::onTextureUploadComplete,
-												  baked_upload_data,
-												  TRUE,		// temp_file
-												  TRUE,		// is_priority
-												  TRUE);	// store_local
-					llinfos << "Baked texture upload via Asset Store." <<  llendl;
-				}
 
-				if (highest_lod)
-				{
-					// Sending the final LOD for the baked texture.  All done, pause 
-					// the upload timer so we know how long it took.
-					mNeedsUpload = FALSE;
-					mNeedsUploadTimer.pause();
-				}
-				else
-				{
-					// Sending a lower level LOD for the baked texture.  Restart the upload timer.
-					mNumLowresUploads++;
-					mNeedsUploadTimer.unpause();
-					mNeedsUploadTimer.reset();
-				}
-
-				// Print out notification that we uploaded this texture.
-				if (gSavedSettings.getBOOL("DebugAvatarRezTime"))
-				{
-					const std::string lod_str = highest_lod ? "HighRes" : "LowRes";
-					LLSD args;
-					args["EXISTENCE"] = llformat("%d",(U32)mTexLayerSet->getAvatar()->debugGetExistenceTimeElapsedF32());
-					args["TIME"] = llformat("%d",(U32)mNeedsUploadTimer.getElapsedTimeF32());
-					args["BODYREGION"] = mTexLayerSet->getBodyRegionName();
-					args["RESOLUTION"] = lod_str;
-					LLNotificationsUtil::add("AvatarRezSelfBakedTextureUploadNotification",args);
-					llinfos << "Uploading [ name: " << mTexLayerSet->getBodyRegionName() << " res:" << lod_str << " time:" << (U32)mNeedsUploadTimer.getElapsedTimeF32() << " ]" << llendl;
-				}
+			if (highest_lod)
+			{
+				// Sending the final LOD for the baked texture.  All done, pause 
+				// the upload timer so we know how long it took.
+				mNeedsUpload = FALSE;
+				mNeedsUploadTimer.pause();
 			}
 			else
 			{
-				// The read back and validate operation failed.  Remove the uploaded file.
-				mUploadPending = FALSE;
-				LLVFile file(gVFS, asset_id, LLAssetType::AT_TEXTURE, LLVFile::WRITE);
-				file.remove();
-				llinfos << "Unable to create baked upload file (reason: corrupted)." << llendl;
+				// Sending a lower level LOD for the baked texture.  Restart the upload timer.
+				mNumLowresUploads++;
+				mNeedsUploadTimer.unpause();
+				mNeedsUploadTimer.reset();
+			}
+
+			// Print out notification that we uploaded this texture.
+			if (gSavedSettings.getBOOL("DebugAvatarRezTime"))
+			{
+				const std::string lod_str = highest_lod ? "HighRes" : "LowRes";
+				LLSD args;
+				args["EXISTENCE"] = llformat("%d",(U32)mTexLayerSet->getAvatar()->debugGetExistenceTimeElapsedF32());
+				args["TIME"] = llformat("%d",(U32)mNeedsUploadTimer.getElapsedTimeF32());
+				args["BODYREGION"] = mTexLayerSet->getBodyRegionName();
+				args["RESOLUTION"] = lod_str;
+				LLNotificationsUtil::add("AvatarRezSelfBakedTextureUploadNotification",args);
+				llinfos << "Uploading [ name: " << mTexLayerSet->getBodyRegionName() << " res:" << lod_str << " time:" << (U32)mNeedsUploadTimer.getElapsedTimeF32() << " ]" << llendl;
 			}
 		}
+		else
+		{
+			// The read back and validate operation failed.  Remove the uploaded file.
+			mUploadPending = FALSE;
+			LLVFile file(gVFS, asset_id, LLAssetType::AT_TEXTURE, LLVFile::WRITE);
+			file.remove();
+			llinfos << "Unable to create baked upload file (reason: corrupted)." << llendl;
+		}
 	}
 	else
 	{
@@ -596,8 +712,6 @@ void LLTexLayerSetBuffer::doUpload()
 		mUploadPending = FALSE;
 		llinfos << "Unable to create baked upload file (reason: failed to write file)" << llendl;
 	}
-
-	delete [] baked_color_data;
 }
 
 // Mostly bookkeeping; don't need to actually "do" anything since
@@ -677,6 +791,16 @@ void LLTexLayerSetBuffer::onTextureUploadComplete(const LLUUID& uuid,
 				U64 now = LLFrameTimer::getTotalTime();		// Record starting time
 				llinfos << "Baked" << resolution << "texture upload for " << name << " took " << (S32)((now - baked_upload_data->mStartTime) / 1000) << " ms" << llendl;
 				gAgentAvatarp->setNewBakedTexture(baked_te, uuid);
+
+				if (baked_upload_data->mIsHighestRes && baked_upload_data->mBakeCRC)
+				{
+					baked_id_map_t& uploaded = layerset_buffer->mUploadedBakes;
+					while ((S32)uploaded.size() >= BAKE_UPLOADED_CACHE_SIZE)
+					{
+						uploaded.erase(uploaded.begin()); // arbitrarily drop the first entry
+					}
+					uploaded[baked_upload_data->mBakeCRC] = uuid;
+				}
 			}
 			else
 			{	
@@ -890,6 +1014,8 @@ BOOL LLTexLayerSet::parseData(LLXmlTreeNode* node)
 
 void LLTexLayerSet::deleteCaches()
 {
+	// cached masks may be regenerated from higher resolution textures under the same crc
+	mAvatar->invalidateMorphMaskCRC(mBakedTexIndex);
 	for( layer_list_t::iterator iter = mLayerList.begin(); iter != mLayerList.end(); iter++ )
 	{
 		LLTexLayerInterface* layer = *iter;
@@ -1172,9 +1298,9 @@ void LLTexLayerSet::renderAlphaMaskTextures(S32 x, S32 y, S32 width, S32 height,
 	gGL.setSceneBlendType(LLRender::BT_ALPHA);
 }
 
-void LLTexLayerSet::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components)
+void LLTexLayerSet::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components, U32 mask_crc)
 {
-	mAvatar->applyMorphMask(tex_data, width, height, num_components, mBakedTexIndex);
+	mAvatar->applyMorphMask(tex_data, width, height, num_components, mBakedTexIndex, mask_crc);
 }
 
 BOOL LLTexLayerSet::isMorphValid() const
@@ -1192,6 +1318,7 @@ BOOL LLTexLayerSet::isMorphValid() const
 
 void LLTexLayerSet::invalidateMorphMasks()
 {
+	mAvatar->invalidateMorphMaskCRC(mBakedTexIndex);
 	for( layer_list_t::iterator iter = mLayerList.begin(); iter != mLayerList.end(); iter++ )
 	{
 		LLTexLayerInterface* layer = *iter;
@@ -2052,7 +2179,7 @@ BOOL LLTexLayer::renderMorphMasks(S32 x, S32 y, S32 width, S32 height, const LLC
 		getTexLayerSet()->getAvatar()->dirtyMesh();
 
 		mMorphMasksValid = TRUE;
-		getTexLayerSet()->applyMorphMask(alpha_data, width, height, 1);
+		getTexLayerSet()->applyMorphMask(alpha_data, width, height, 1, cache_index);
 	}
 
 	return success;
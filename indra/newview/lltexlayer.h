@@ -36,6 +36,8 @@ class LLVOAvatar;
 class LLVOAvatarSelf;
 class LLImageTGA;
 class LLImageRaw;
+class LLImageJ2C;
+class LLBakedEncodeResponder;
 class LLXmlTreeNode;
 class LLTexLayerSet;
 class LLTexLayerSetInfo;
@@ -203,7 +205,7 @@ public:
 	BOOL						getUpdatesEnabled()	const 	{ return mUpdatesEnabled; }
 	void						deleteCaches();
 	void						gatherMorphMaskAlpha(U8 *data, S32 width, S32 height);
-	void						applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components);
+	void						applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components, U32 mask_crc = 0);
 	BOOL						isMorphValid() const;
 	void						invalidateMorphMasks();
 	LLTexLayerInterface*		findLayerByName(const std::string& name);
@@ -306,9 +308,14 @@ public:
 													S32 result, LLExtStat ext_status);
 protected:
 	BOOL					isReadyToUpload() const;
-	void					doUpload(); 					// Does a read back and upload.
+	void					doUpload(); 					// Does a read back and starts the encode for upload.
+	void					finishUpload(LLImageJ2C* compressed_image, bool highest_lod, U32 bake_crc); // Writes out and sends an encoded bake.
+	void					checkPendingEncode();			// Finishes the upload once an off thread encode is done.
 	void					conditionalRestartUploadTimer();
 private:
+	LLPointer<LLBakedEncodeResponder> mPendingEncode;		// Encode of the last read back, running on the image decode thread
+	typedef std::map<U32, LLUUID> baked_id_map_t;
+	baked_id_map_t			mUploadedBakes;					// Final bakes already on the server, keyed by a crc of their pixels
 	BOOL					mNeedsUpload; 					// Whether we need to send our baked textures to the server
 	U32						mNumLowresUploads; 				// Number of times we've sent a lowres version of our baked textures to the server
 	BOOL					mUploadPending; 				// Whether we have received back the new baked textures
@@ -368,13 +375,15 @@ struct LLBakedUploadData
 	LLBakedUploadData(const LLVOAvatarSelf* avatar, 
 					  LLTexLayerSet* layerset, 
 					  const LLUUID& id,
-					  bool highest_res);
+					  bool highest_res,
+					  U32 bake_crc = 0);
 	~LLBakedUploadData() {}
 	const LLUUID				mID;
 	const LLVOAvatarSelf*		mAvatar; // note: backlink only; don't LLPointer 
 	LLTexLayerSet*				mTexLayerSet;
    	const U64					mStartTime;	// for measuring baked texture upload time
    	const bool					mIsHighestRes; // whether this is a "final" bake, or intermediate low res
+	const U32					mBakeCRC; // crc of the uploaded pixels, see LLTexLayerSetBuffer::mUploadedBakes
 };
 
 #endif  // LL_LLTEXLAYER_H
@@ -30,6 +30,8 @@
 
 #include "llapr.h"
 #include "lldir.h"
+#include "lldiriterator.h"
+#include "llfile.h"
 #include "llimage.h"
 #include "lllfsthread.h"
 #include "llviewercontrol.h"
@@ -51,6 +53,26 @@ const S32 TEXTURE_CACHE_ENTRY_SIZE = FIRST_PACKET_SIZE;//1024;
 const F32 TEXTURE_CACHE_PURGE_AMOUNT = .20f; // % amount to reduce the cache by when it exceeds its limit
 const F32 TEXTURE_CACHE_LRU_SIZE = .10f; // % amount for LRU list (low overhead to regenerate)
 
+// Queued by LLTextureCache::initCache() ahead of any reads or writes
+class LLTextureCacheInitRequest : public LLQueuedThread::QueuedRequest
+{
+public:
+	LLTextureCacheInitRequest(LLQueuedThread::handle_t handle, LLTextureCache* cache)
+		: LLQueuedThread::QueuedRequest(handle, LLQueuedThread::PRIORITY_IMMEDIATE, FLAG_AUTO_COMPLETE),
+		  mCache(cache)
+	{
+	}
+
+	/*virtual*/ bool processRequest()
+	{
+		mCache->loadHeaders();
+		return true;
+	}
+
+private:
+	LLTextureCache* mCache;
+};
+
 class LLTextureCacheWorker : public LLWorkerClass
 {
 	friend class LLTextureCache;
@@ -285,7 +307,8 @@ public:
 						 S32 imagesize, // for writes
 						 LLTextureCache::Responder* responder) 
 			: LLTextureCacheWorker(cache, priority, id, data, datasize, offset, imagesize, responder),
-			mState(INIT)
+			mState(INIT),
+			mBodySize(0)
 	{
 	}
 
@@ -303,6 +326,7 @@ private:
 	};
 
 	e_state mState;
+	S32 mBodySize; // body size recorded in the entry
 };
 
 
@@ -414,6 +438,7 @@ bool LLTextureCacheRemoteWorker::doRead()
 		else
 		{
 			mImageSize = entry.mImageSize ;
+			mBodySize = entry.mBodySize;
 			// If the read offset is bigger than the header cache, we read directly from the body
 			// Note that currently, we *never* read with offset from the cache, so the result is *always* HEADER
 			mState = mOffset < TEXTURE_CACHE_ENTRY_SIZE ? HEADER : BODY;
@@ -460,7 +485,18 @@ bool LLTextureCacheRemoteWorker::doRead()
 		std::string filename = mCache->getTextureFileName(mID);
 		S32 filesize = LLAPRFile::size(filename, mCache->getLocalAPRFilePool());
 
-		if (filesize && (filesize + TEXTURE_CACHE_ENTRY_SIZE) > mOffset)
+		if (mBodySize > 0 && filesize != mBodySize)
+		{
+			// Bodies are no longer validated at startup, a bad one only costs this texture
+			LL_WARNS("TextureCache") << "TEXTURE CACHE BODY HAS BAD SIZE: " << filesize << " != " << mBodySize
+					<< " " << filename << LL_ENDL;
+			FREE_MEM(LLImageBase::getPrivatePool(), mReadData);
+			mReadData = NULL;
+			mDataSize = -1; // failed, the fetcher goes to the network
+			mCache->removeFromCache(mID);
+			done = true;
+		}
+		else if (filesize && (filesize + TEXTURE_CACHE_ENTRY_SIZE) > mOffset)
 		{
 			S32 max_datasize = TEXTURE_CACHE_ENTRY_SIZE + filesize - mOffset;
 			mDataSize = llmin(max_datasize, mDataSize);
@@ -640,6 +676,8 @@ bool LLTextureCacheRemoteWorker::doWrite()
 		{
 			// build the cache file name from the UUID
 			std::string filename = mCache->getTextureFileName(mID);			
+			// an earlier purge of this texture mustn't delete the new body
+			mCache->cancelBodyRemoval(mID);
 // 			llinfos << "Writing Body: " << filename << " Bytes: " << file_offset+file_size << llendl;
 			S32 bytes_written = LLAPRFile::writeEx(	filename, 
 													mWriteData + TEXTURE_CACHE_ENTRY_SIZE,
@@ -744,16 +782,21 @@ LLTextureCache::LLTextureCache(bool threaded)
 	  mWorkersMutex(NULL),
 	  mHeaderMutex(NULL),
 	  mListMutex(NULL),
+	  mBodyRemovalMutex(NULL),
 	  mHeaderAPRFile(NULL),
 	  mReadOnly(TRUE), //do not allow to change the texture cache until setReadOnly() is called.
 	  mTexturesSizeTotal(0),
-	  mDoPurge(FALSE)
+	  mDoPurge(FALSE),
+	  mDecodedMutex(NULL),
+	  mDecodedSizeTotal(0),
+	  mDecodedMaxSize(0)
 {
 }
 
 LLTextureCache::~LLTextureCache()
 {
 	clearDeleteList() ;
+	removeQueuedBodies(0.f);
 	writeUpdatedEntries() ;
 }
 
@@ -806,9 +849,55 @@ S32 LLTextureCache::update(F32 max_time_ms)
 		writeUpdatedEntries() ;
 	}
 
+	// a purge can leave thousands of files behind, spread them out
+	const F32 BODY_REMOVAL_TIME_MS = 2.f;
+	removeQueuedBodies(BODY_REMOVAL_TIME_MS);
+
 	return res;
 }
 
+void LLTextureCache::queueBodyRemoval(const LLUUID& id)
+{
+	LLMutexLock lock(&mBodyRemovalMutex);
+	mBodyRemovals.insert(id);
+}
+
+// Called from the worker thread
+void LLTextureCache::cancelBodyRemoval(const LLUUID& id)
+{
+	LLMutexLock lock(&mBodyRemovalMutex);
+	mBodyRemovals.erase(id);
+}
+
+void LLTextureCache::removeQueuedBodies(F32 max_time_ms)
+{
+	LLTimer timer;
+	S32 removed = 0;
+	while (true)
+	{
+		LLMutexLock lock(&mBodyRemovalMutex);
+		if (mBodyRemovals.empty())
+		{
+			break;
+		}
+		LLUUID id = *mBodyRemovals.begin();
+		mBodyRemovals.erase(mBodyRemovals.begin());
+		// still holding the lock, so a writer can't create this body meanwhile.
+		// No file pool, the local one belongs to the cache thread.
+		LLAPRFile::remove(getTextureFileName(id));
+		removed++;
+
+		if (max_time_ms > 0.f && timer.getElapsedTimeF32() * 1000.f > max_time_ms)
+		{
+			break;
+		}
+	}
+	if (removed)
+	{
+		LL_DEBUGS("TextureCache") << "TEXTURE CACHE: removed " << removed << " purged bodies" << LL_ENDL;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // search for local copy of UUID-based image file
 std::string LLTextureCache::getLocalFileName(const LLUUID& id)
@@ -888,6 +977,8 @@ const char* cache_filename = "texture.cache";
 const char* old_textures_dirname = "textures";
 //change the location of the texture cache to prevent from being deleted by old version viewers.
 const char* textures_dirname = "texturecache";
+const char* decoded_dirname = "decoded";
+const U32 DECODED_CACHE_VERSION = 1;
 
 void LLTextureCache::setDirNames(ELLPath location)
 {
@@ -896,6 +987,7 @@ void LLTextureCache::setDirNames(ELLPath location)
 	mHeaderEntriesFileName = gDirUtilp->getExpandedFilename(location, textures_dirname, entries_filename);
 	mHeaderDataFileName = gDirUtilp->getExpandedFilename(location, textures_dirname, cache_filename);
 	mTexturesDirName = gDirUtilp->getExpandedFilename(location, textures_dirname);
+	mDecodedDirName = gDirUtilp->getExpandedFilename(location, textures_dirname, decoded_dirname);
 }
 
 void LLTextureCache::purgeCache(ELLPath location)
@@ -977,14 +1069,26 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, BOOL texture_cache
 			LLFile::mkdir(dirname);
 		}
 	}
-	readHeaderCache();
-	purgeTextures(true); // calc mTexturesSize and make some room in the texture cache if we need it
-
-	llassert_always(getPending() == 0) ; //should not start accessing the texture cache before initialized.
+	if (mThreaded)
+	{
+		// Reading the entries is all disk, nothing at startup waits for it.
+		// It runs first on the cache thread, so reads and writes queue behind it.
+		addRequest(new LLTextureCacheInitRequest(generateHandle(), this));
+	}
+	else
+	{
+		loadHeaders();
+	}
 
 	return max_size; // unused cache space
 }
 
+void LLTextureCache::loadHeaders()
+{
+	readHeaderCache();
+	purgeTextures(); // calc mTexturesSize and make some room in the texture cache if we need it
+}
+
 //----------------------------------------------------------------------------
 // mHeaderMutex must be locked for the following functions!
 
@@ -1156,11 +1260,20 @@ void LLTextureCache::writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool
 
 	closeHeaderEntriesFile();
 	mUpdatedEntryMap.erase(idx) ;
+	setResidentEntry(idx, entry);
 }
 
 //mHeaderMutex is locked before calling this.
 void LLTextureCache::readEntryFromHeaderImmediately(S32& idx, Entry& entry)
 {
+	// Entries are kept resident once the entries file has been read,
+	// so a lookup does not have to touch the disk.
+	if (idx >= 0 && idx < (S32)mResidentEntries.size())
+	{
+		entry = mResidentEntries[idx];
+		return;
+	}
+
 	S32 offset = sizeof(EntriesInfo) + idx * sizeof(Entry);
 	LLAPRFile* aprfile = openHeaderEntriesFile(true, offset);
 	S32 bytes_read = aprfile->read((void*)&entry, (S32)sizeof(Entry));
@@ -1190,6 +1303,7 @@ void LLTextureCache::updateEntryTimeStamp(S32 idx, Entry& entry)
 		{
 			entry.mTime = time(NULL);			
 			mUpdatedEntryMap[idx] = entry ;
+			setResidentEntry(idx, entry);
 		}
 	}
 }
@@ -1272,18 +1386,21 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 		}
 		aprfile->seek(APR_SET, (S32)sizeof(EntriesInfo));
 	}
+	// Read the whole table in one call rather than one Entry at a time.
+	entries.resize(num_entries);
+	S32 bytes_expected = (S32)(num_entries * sizeof(Entry));
+	S32 bytes_read = num_entries ? aprfile->read((void*)(&entries[0]), bytes_expected) : 0;
+	closeHeaderEntriesFile();
+	if (bytes_read < bytes_expected)
+	{
+		llwarns << "Corrupted header entries, failed at " << bytes_read / (S32)sizeof(Entry) << " / " << num_entries << llendl;
+		entries.clear();
+		purgeAllTextures(false);
+		return 0;
+	}
 	for (U32 idx=0; idx<num_entries; idx++)
 	{
-		Entry entry;
-		S32 bytes_read = aprfile->read((void*)(&entry), (S32)sizeof(Entry));
-		if (bytes_read < sizeof(Entry))
-		{
-			llwarns << "Corrupted header entries, failed at " << idx << " / " << num_entries << llendl;
-			closeHeaderEntriesFile();
-			purgeAllTextures(false);
-			return 0;
-		}
-		entries.push_back(entry);
+		const Entry& entry = entries[idx];
 // 		llinfos << "ENTRY: " << entry.mTime << " TEX: " << entry.mID << " IDX: " << idx << " Size: " << entry.mImageSize << llendl;
 		if(entry.mImageSize > entry.mBodySize)
 		{
@@ -1296,7 +1413,7 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 			mFreeList.insert(idx);
 		}
 	}
-	closeHeaderEntriesFile();
+	mResidentEntries = entries;
 	return num_entries;
 }
 
@@ -1308,17 +1425,30 @@ void LLTextureCache::writeEntriesAndClose(const std::vector<Entry>& entries)
 	if (!mReadOnly)
 	{
 		LLAPRFile* aprfile = openHeaderEntriesFile(false, (S32)sizeof(EntriesInfo));
-		for (S32 idx=0; idx<num_entries; idx++)
+		S32 bytes_expected = num_entries * (S32)sizeof(Entry);
+		S32 bytes_written = num_entries ? aprfile->write((void*)(&entries[0]), bytes_expected) : 0;
+		if(bytes_written != bytes_expected)
 		{
-			S32 bytes_written = aprfile->write((void*)(&entries[idx]), (S32)sizeof(Entry));
-			if(bytes_written != sizeof(Entry))
-			{
-				clearCorruptedCache() ; //clear the cache.
-				return ;
-			}
+			clearCorruptedCache() ; //clear the cache.
+			return ;
 		}
 		closeHeaderEntriesFile();
+		mResidentEntries = entries;
+	}
+}
+
+//mHeaderMutex is locked before calling this.
+void LLTextureCache::setResidentEntry(S32 idx, const Entry& entry)
+{
+	if (idx < 0)
+	{
+		return;
+	}
+	if (idx >= (S32)mResidentEntries.size())
+	{
+		mResidentEntries.resize(idx + 1);
 	}
+	mResidentEntries[idx] = entry;
 }
 
 void LLTextureCache::writeUpdatedEntries()
@@ -1510,8 +1640,14 @@ void LLTextureCache::clearCorruptedCache()
 
 void LLTextureCache::purgeAllTextures(bool purge_directories)
 {
+	purgeDecoded();
 	if (!mReadOnly)
 	{
+		if (purge_directories)
+		{
+			LLFile::rmdir(mDecodedDirName);
+		}
+
 		const char* subdirs = "0123456789abcdef";
 		std::string delem = gDirUtilp->getDirDelimiter();
 		std::string mask = "*";
@@ -1537,6 +1673,7 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
 	mFreeList.clear();
 	mTexturesSizeTotal = 0;
 	mUpdatedEntryMap.clear();
+	mResidentEntries.clear();
 
 	// Info with 0 entries
 	mHeaderEntriesInfo.mVersion = sHeaderCacheVersion;
@@ -1546,7 +1683,7 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
 	llinfos << "The entire texture cache is cleared." << llendl ;
 }
 
-void LLTextureCache::purgeTextures(bool validate)
+void LLTextureCache::purgeTextures()
 {
 	if (mReadOnly)
 	{
@@ -1593,65 +1730,34 @@ void LLTextureCache::purgeTextures(bool validate)
 		}
 	}
 	
-	// Validate 1/256th of the files on startup
-	U32 validate_idx = 0;
-	if (validate)
-	{
-		validate_idx = gSavedSettings.getU32("CacheValidateCounter");
-		U32 next_idx = (validate_idx + 1) % 256;
-		gSavedSettings.setU32("CacheValidateCounter", next_idx);
-		LL_DEBUGS("TextureCache") << "TEXTURE CACHE: Validating: " << validate_idx << LL_ENDL;
-	}
-
 	S64 cache_size = mTexturesSizeTotal;
 	S64 purged_cache_size = (sCacheMaxTexturesSize * (S64)((1.f-TEXTURE_CACHE_PURGE_AMOUNT)*100)) / 100;
 	S32 purge_count = 0;
 	for (time_idx_set_t::iterator iter = time_idx_set.begin();
 		 iter != time_idx_set.end(); ++iter)
 	{
-		S32 idx = iter->second;
-		bool purge_entry = false;
-		std::string filename = getTextureFileName(entries[idx].mID);
-		if (cache_size >= purged_cache_size)
-		{
-			purge_entry = true;
-		}
-		else if (validate)
-		{
-			// make sure file exists and is the correct size
-			U32 uuididx = entries[idx].mID.mData[0];
-			if (uuididx == validate_idx)
-			{
- 				LL_DEBUGS("TextureCache") << "Validating: " << filename << "Size: " << entries[idx].mBodySize << LL_ENDL;
-				S32 bodysize = LLAPRFile::size(filename, getLocalAPRFilePool());
-				if (bodysize != entries[idx].mBodySize)
-				{
-					LL_WARNS("TextureCache") << "TEXTURE CACHE BODY HAS BAD SIZE: " << bodysize << " != " << entries[idx].mBodySize
-							<< filename << LL_ENDL;
-					purge_entry = true;
-				}
-			}
-		}
-		else
+		if (cache_size < purged_cache_size)
 		{
 			break;
 		}
-		
-		if (purge_entry)
-		{
-			purge_count++;
-	 		LL_DEBUGS("TextureCache") << "PURGING: " << filename << LL_ENDL;
-			cache_size -= entries[idx].mBodySize;
-			removeEntry(idx, entries[idx], filename) ;			
-		}
+
+		S32 idx = iter->second;
+		std::string filename = getTextureFileName(entries[idx].mID);
+		purge_count++;
+ 		LL_DEBUGS("TextureCache") << "PURGING: " << filename << LL_ENDL;
+		cache_size -= entries[idx].mBodySize;
+		removeEntry(idx, entries[idx], filename) ;
 	}
 
 	LL_DEBUGS("TextureCache") << "TEXTURE CACHE: Writing Entries: " << num_entries << LL_ENDL;
 
 	writeEntriesAndClose(entries);
 	
-	// *FIX:Mani - watchdog back on.
-	LLAppViewer::instance()->resumeMainloopTimeout();
+	if (!mThreaded)
+	{
+		// *FIX:Mani - watchdog back on.
+		LLAppViewer::instance()->resumeMainloopTimeout();
+	}
 	
 	LL_INFOS("TextureCache") << "TEXTURE CACHE:"
 			<< " PURGED: " << purge_count
@@ -1801,7 +1907,7 @@ LLTextureCache::handle_t LLTextureCache::writeToCache(const LLUUID& id, U32 prio
 		// NOTE: This may cause an occasional hiccup,
 		//  but it really needs to be done on the control thread
 		//  (i.e. here)		
-		purgeTextures(false);
+		purgeTextures();
 		mDoPurge = FALSE;
 	}
 	LLMutexLock lock(&mWorkersMutex);
@@ -1858,7 +1964,7 @@ void LLTextureCache::removeCachedTexture(const LLUUID& id)
 		mTexturesSizeMap.erase(id);
 	}
 	mHeaderIDMap.erase(id);
-	LLAPRFile::remove(getTextureFileName(id), getLocalAPRFilePool());		
+	queueBodyRemoval(id);
 }
 
 //called after mHeaderMutex is locked.
@@ -1890,7 +1996,14 @@ void LLTextureCache::removeEntry(S32 idx, Entry& entry, std::string& filename)
 
 	if (file_maybe_exists)
 	{
-		LLAPRFile::remove(filename, getLocalAPRFilePool());		
+		if (idx >= 0)
+		{
+			queueBodyRemoval(entry.mID);
+		}
+		else
+		{
+			LLAPRFile::remove(filename, getLocalAPRFilePool());		
+		}
 	}
 }
 
@@ -1913,10 +2026,210 @@ bool LLTextureCache::removeFromCache(const LLUUID& id)
 		}
 
 		unlockHeaders() ;
+
+		removeDecoded(id);
 	}
 	return ret ;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Decoded mip tier
+
+//called in the main thread, after initCache(...)
+void LLTextureCache::initDecodedCache(S64 max_size)
+{
+	LLMutexLock lock(&mDecodedMutex);
+
+	mDecodedMaxSize = max_size;
+	mDecodedMap.clear();
+	mDecodedLRU.clear();
+	mDecodedSizeTotal = 0;
+	if (mDecodedMaxSize <= 0)
+	{
+		return;
+	}
+
+	if (!mReadOnly)
+	{
+		LLFile::mkdir(mDecodedDirName);
+	}
+
+	// Rebuild the index from the files on disk, oldest first
+	typedef std::multimap<time_t, std::pair<decoded_key_t, S32> > time_map_t;
+	time_map_t files;
+	std::string filename;
+	LLDirIterator dir_iter(mDecodedDirName, "*.raw");
+	while (dir_iter.next(filename))
+	{
+		if (filename.size() < UUID_STR_LENGTH + 1 || filename[UUID_STR_LENGTH - 1] != '_')
+		{
+			continue;
+		}
+		LLUUID id;
+		if (!id.set(filename.substr(0, UUID_STR_LENGTH - 1), FALSE))
+		{
+			continue;
+		}
+		decoded_key_t key(id, atoi(filename.c_str() + UUID_STR_LENGTH));
+		std::string path = getDecodedFileName(key);
+		llstat stat_data;
+		S32 size = LLAPRFile::size(path);
+		if (size <= (S32)sizeof(DecodedHeader) || LLFile::stat(path, &stat_data) != 0)
+		{
+			continue;
+		}
+		files.insert(std::make_pair(stat_data.st_mtime, std::make_pair(key, size)));
+	}
+	for (time_map_t::iterator iter = files.begin(); iter != files.end(); ++iter)
+	{
+		addDecodedEntry(iter->second.first, iter->second.second);
+	}
+
+	LL_INFOS("TextureCache") << "Decoded mips: " << mDecodedMap.size() << " files, "
+							 << mDecodedSizeTotal / (1024 * 1024) << " MB of " << mDecodedMaxSize / (1024 * 1024) << " MB" << LL_ENDL;
+}
+
+bool LLTextureCache::readDecoded(const LLUUID& id, S32 discard, LLPointer<LLImageRaw>& raw)
+{
+	if (!hasDecodedCache())
+	{
+		return false;
+	}
+
+	LLMutexLock lock(&mDecodedMutex);
+
+	decoded_key_t key(id, discard);
+	decoded_map_t::iterator iter = mDecodedMap.find(key);
+	if (iter == mDecodedMap.end())
+	{
+		return false;
+	}
+	std::string filename = getDecodedFileName(key);
+
+	DecodedHeader header;
+	S32 bytes = LLAPRFile::readEx(filename, &header, 0, sizeof(DecodedHeader));
+	S32 data_size = header.mWidth * header.mHeight * header.mComponents;
+	if (bytes != sizeof(DecodedHeader) || header.mVersion != DECODED_CACHE_VERSION ||
+		header.mComponents < 1 || header.mComponents > 4 ||
+		header.mWidth <= 0 || header.mHeight <= 0 || header.mWidth > 2048 || header.mHeight > 2048 ||
+		iter->second.first != (S32)sizeof(DecodedHeader) + data_size)
+	{
+		LL_WARNS("TextureCache") << "Removing invalid decoded mip: " << filename << LL_ENDL;
+		removeDecodedEntry(key);
+		return false;
+	}
+
+	LLPointer<LLImageRaw> image = new LLImageRaw;
+	if (!image->allocateDataSize(header.mWidth, header.mHeight, header.mComponents, data_size) ||
+		LLAPRFile::readEx(filename, image->getData(), sizeof(DecodedHeader), data_size) != data_size)
+	{
+		return false;
+	}
+
+	// Most recently used goes to the back
+	mDecodedLRU.splice(mDecodedLRU.end(), mDecodedLRU, iter->second.second);
+	raw = image;
+	return true;
+}
+
+void LLTextureCache::writeDecoded(const LLUUID& id, S32 discard, const LLImageRaw* raw)
+{
+	if (!hasDecodedCache() || mReadOnly || !raw || !raw->getData())
+	{
+		return;
+	}
+
+	LLMutexLock lock(&mDecodedMutex);
+
+	decoded_key_t key(id, discard);
+	if (mDecodedMap.find(key) != mDecodedMap.end())
+	{
+		return; // textures never change, the stored copy is still good
+	}
+
+	DecodedHeader header;
+	header.mVersion = DECODED_CACHE_VERSION;
+	header.mWidth = raw->getWidth();
+	header.mHeight = raw->getHeight();
+	header.mComponents = raw->getComponents();
+	S32 data_size = raw->getDataSize();
+	S32 size = (S32)sizeof(DecodedHeader) + data_size;
+	if (size > mDecodedMaxSize)
+	{
+		return;
+	}
+
+	// Make room, least recently used first
+	while (!mDecodedLRU.empty() && mDecodedSizeTotal + size > mDecodedMaxSize)
+	{
+		removeDecodedEntry(mDecodedLRU.front());
+	}
+
+	std::string filename = getDecodedFileName(key);
+	if (LLAPRFile::writeEx(filename, &header, 0, sizeof(DecodedHeader)) != sizeof(DecodedHeader) ||
+		LLAPRFile::writeEx(filename, (void*)raw->getData(), -1, data_size) != data_size)
+	{
+		LLAPRFile::remove(filename);
+		return;
+	}
+	addDecodedEntry(key, size);
+}
+
+std::string LLTextureCache::getDecodedFileName(const decoded_key_t& key)
+{
+	return mDecodedDirName + gDirUtilp->getDirDelimiter() + key.first.asString() + llformat("_%d.raw", key.second);
+}
+
+//called after mDecodedMutex is locked.
+void LLTextureCache::addDecodedEntry(const decoded_key_t& key, S32 size)
+{
+	decoded_lru_t::iterator lru_iter = mDecodedLRU.insert(mDecodedLRU.end(), key);
+	mDecodedMap[key] = std::make_pair(size, lru_iter);
+	mDecodedSizeTotal += size;
+}
+
+//called after mDecodedMutex is locked.
+void LLTextureCache::removeDecodedEntry(const decoded_key_t& key)
+{
+	decoded_map_t::iterator iter = mDecodedMap.find(key);
+	if (iter != mDecodedMap.end())
+	{
+		mDecodedSizeTotal -= iter->second.first;
+		mDecodedLRU.erase(iter->second.second);
+		mDecodedMap.erase(iter);
+		if (!mReadOnly)
+		{
+			LLAPRFile::remove(getDecodedFileName(key));
+		}
+	}
+}
+
+void LLTextureCache::removeDecoded(const LLUUID& id)
+{
+	if (!hasDecodedCache())
+	{
+		return;
+	}
+
+	LLMutexLock lock(&mDecodedMutex);
+	for (S32 discard = 0; discard <= MAX_DISCARD_LEVEL; discard++)
+	{
+		removeDecodedEntry(decoded_key_t(id, discard));
+	}
+}
+
+void LLTextureCache::purgeDecoded()
+{
+	LLMutexLock lock(&mDecodedMutex);
+	if (!mReadOnly)
+	{
+		gDirUtilp->deleteFilesInDir(mDecodedDirName, "*");
+	}
+	mDecodedMap.clear();
+	mDecodedLRU.clear();
+	mDecodedSizeTotal = 0;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 LLTextureCache::ReadResponder::ReadResponder()
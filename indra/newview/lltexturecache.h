@@ -34,11 +34,15 @@
 
 #include "llworkerthread.h"
 
+#include <list>
+
 class LLImageFormatted;
+class LLImageRaw;
 class LLTextureCacheWorker;
 
 class LLTextureCache : public LLWorkerThread
 {
+	friend class LLTextureCacheInitRequest;
 	friend class LLTextureCacheWorker;
 	friend class LLTextureCacheRemoteWorker;
 	friend class LLTextureCacheLocalFileWorker;
@@ -120,6 +124,13 @@ public:
 
 	bool removeFromCache(const LLUUID& id);
 
+	// Decoded mip tier, keyed by UUID and discard level, with its own size limit.
+	// Reads and writes are synchronous and may be called from any thread.
+	void initDecodedCache(S64 max_size);
+	bool hasDecodedCache() const { return mDecodedMaxSize > 0; }
+	bool readDecoded(const LLUUID& id, S32 discard, LLPointer<LLImageRaw>& raw);
+	void writeDecoded(const LLUUID& id, S32 discard, const LLImageRaw* raw);
+
 	// For LLTextureCacheWorker::Responder
 	LLTextureCacheWorker* getReader(handle_t handle);
 	LLTextureCacheWorker* getWriter(handle_t handle);
@@ -148,9 +159,10 @@ protected:
 private:
 	void setDirNames(ELLPath location);
 	void readHeaderCache();
+	void loadHeaders();
 	void clearCorruptedCache();
 	void purgeAllTextures(bool purge_directories);
-	void purgeTextures(bool validate);
+	void purgeTextures();
 	LLAPRFile* openHeaderEntriesFile(bool readonly, S32 offset);
 	void closeHeaderEntriesFile();
 	void readEntriesHeader();
@@ -162,20 +174,36 @@ private:
 	void writeEntriesAndClose(const std::vector<Entry>& entries);
 	void readEntryFromHeaderImmediately(S32& idx, Entry& entry) ;
 	void writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool write_header = false) ;
+	void setResidentEntry(S32 idx, const Entry& entry);
 	void removeEntry(S32 idx, Entry& entry, std::string& filename);
 	void removeCachedTexture(const LLUUID& id) ;
+
+	// Body files of purged entries are deleted a few at a time from
+	// update() instead of while holding mHeaderMutex.
+	void queueBodyRemoval(const LLUUID& id);
+	void cancelBodyRemoval(const LLUUID& id);	// before writing a new body
+	void removeQueuedBodies(F32 max_time_ms);	// 0 = all of them
 	S32 getHeaderCacheEntry(const LLUUID& id, Entry& entry);
 	S32 setHeaderCacheEntry(const LLUUID& id, Entry& entry, S32 imagesize, S32 datasize);
 	void writeUpdatedEntries() ;
 	void updatedHeaderEntriesFile() ;
 	void lockHeaders() { mHeaderMutex.lock(); }
 	void unlockHeaders() { mHeaderMutex.unlock(); }
+
+	typedef std::pair<LLUUID, S32> decoded_key_t; // id, discard level
+	std::string getDecodedFileName(const decoded_key_t& key);
+	void addDecodedEntry(const decoded_key_t& key, S32 size);
+	void removeDecodedEntry(const decoded_key_t& key);
+	void removeDecoded(const LLUUID& id);
+	void purgeDecoded();
 	
 private:
 	// Internal
 	LLMutex mWorkersMutex;
 	LLMutex mHeaderMutex;
 	LLMutex mListMutex;
+	LLMutex mBodyRemovalMutex;	// also held while a body file is deleted
+	uuid_list_t mBodyRemovals;
 	LLAPRFile* mHeaderAPRFile;
 	
 	typedef std::map<handle_t, LLTextureCacheWorker*> handle_map_t;
@@ -208,6 +236,24 @@ private:
 
 	typedef std::map<S32, Entry> idx_entry_map_t;
 	idx_entry_map_t mUpdatedEntryMap;
+	std::vector<Entry> mResidentEntries; // in-memory copy of the entries file, indexed like it
+
+	// DECODED MIPS (mDecodedMutex protects all of these)
+	struct DecodedHeader
+	{
+		U32 mVersion;
+		S32 mWidth;
+		S32 mHeight;
+		S32 mComponents;
+	};
+	LLMutex mDecodedMutex;
+	std::string mDecodedDirName;
+	typedef std::list<decoded_key_t> decoded_lru_t;
+	decoded_lru_t mDecodedLRU; // least recently used first
+	typedef std::map<decoded_key_t, std::pair<S32, decoded_lru_t::iterator> > decoded_map_t;
+	decoded_map_t mDecodedMap; // file size and LRU position
+	S64 mDecodedSizeTotal;
+	S64 mDecodedMaxSize;
 
 	// Statics
 	static F32 sHeaderCacheVersion;
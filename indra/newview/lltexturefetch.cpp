@@ -51,6 +51,7 @@
 #include "llviewerregion.h"
 #include "llviewerstats.h"
 #include "llviewerassetstats.h"
+#include "llviewerthrottle.h"
 #include "llworld.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -265,6 +266,8 @@ private:
 	S32 mActiveCount;
 	U32 mGetStatus;
 	std::string mGetReason;
+	S32 mFetchBudget;		// LLViewerAssetStats::EFetchBudget
+	bool mBudgetDeferred;	// already counted as deferred for this request
 	
 	// Work Data
 	LLMutex mWorkMutex;
@@ -629,6 +632,9 @@ const char* LLTextureFetchWorker::sStateDescs[] = {
 // static
 volatile bool LLTextureFetch::svMetricsDataBreak(true);	// Start with a data break
 
+// Smallest decoded mip worth writing to the decoded tier of the texture cache
+const S32 MIN_DECODED_CACHE_PIXELS = 128 * 128;
+
 // called from MAIN THREAD
 
 LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
@@ -674,6 +680,8 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
 	  mRetryAttempt(0),
 	  mActiveCount(0),
 	  mGetStatus(0),
+	  mFetchBudget(LLViewerAssetStats::EFBAgentRegion),
+	  mBudgetDeferred(false),
 	  mWorkMutex(NULL),
 	  mFirstPacket(0),
 	  mLastPacket(-1),
@@ -902,6 +910,31 @@ bool LLTextureFetchWorker::doWork(S32 param)
 		// fall through
 	}
 
+	if (mState == LOAD_FROM_TEXTURE_CACHE)
+	{
+		if (mCacheReadHandle == LLTextureCache::nullHandle() && mUrl.empty() && !mNeedsAux &&
+			mDesiredDiscard >= 0 && mFetcher->mTextureCache->hasDecodedCache())
+		{
+			// A decoded copy skips both the J2C read and the decode thread
+			for (S32 discard = mDesiredDiscard; discard >= 0; discard--)
+			{
+				if (mFetcher->mTextureCache->readDecoded(mID, discard, mRawImage))
+				{
+					LL_DEBUGS("Texture") << mID << ": Decoded copy cached. Discard: " << discard
+										 << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
+					mAuxImage = NULL;
+					mLoadedDiscard = discard;
+					mDecodedDiscard = discard;
+					mDecoded = TRUE;
+					mWriteToCacheState = NOT_WRITE;
+					setPriority(LLWorkerThread::PRIORITY_HIGH | mWorkPriority);
+					mState = DONE;
+					break;
+				}
+			}
+		}
+	}
+
 	if (mState == LOAD_FROM_TEXTURE_CACHE)
 	{
 		if (mCacheReadHandle == LLTextureCache::nullHandle())
@@ -1040,6 +1073,18 @@ bool LLTextureFetchWorker::doWork(S32 param)
 		}
 		if (mCanUseHTTP && !mUrl.empty())
 		{
+			if (LLImageBase::TYPE_AVATAR_BAKE == mType)
+			{
+				mFetchBudget = LLViewerAssetStats::EFBAvatarBakes;
+			}
+			else if (mHost == LLHost::invalid || mHost == gAgent.getRegionHost())
+			{
+				mFetchBudget = LLViewerAssetStats::EFBAgentRegion;
+			}
+			else
+			{
+				mFetchBudget = LLViewerAssetStats::EFBNeighborRegions;
+			}
 			mState = LLTextureFetchWorker::SEND_HTTP_REQ;
 			setPriority(LLWorkerThread::PRIORITY_HIGH | mWorkPriority);
 			if(mWriteToCacheState != NOT_WRITE)
@@ -1140,12 +1185,19 @@ bool LLTextureFetchWorker::doWork(S32 param)
 			//control the number of the http requests issued for:
 			//1, not openning too many file descriptors at the same time;
 			//2, control the traffic of http so udp gets bandwidth.
+			//The same limit sizes the keep-alive connection pool (see startThread()).
+			//Within it each fetch budget gets its share (see canStartHTTPRequest()).
 			//
-			static const S32 MAX_NUM_OF_HTTP_REQUESTS_IN_QUEUE = 8 ;
-			if(mFetcher->getNumHTTPRequests() > MAX_NUM_OF_HTTP_REQUESTS_IN_QUEUE)
+			if(!mFetcher->canStartHTTPRequest(mFetchBudget))
 			{
+				if (!mBudgetDeferred)
+				{
+					mBudgetDeferred = true;
+					LLViewerAssetStatsFF::record_budget_defer_thread1((LLViewerAssetStats::EFetchBudget)mFetchBudget);
+				}
 				return false ; //wait.
 			}
+			mBudgetDeferred = false;
 
 			mFetcher->removeFromNetworkQueue(this, false);
 			
@@ -1187,7 +1239,8 @@ bool LLTextureFetchWorker::doWork(S32 param)
 				setPriority(LLWorkerThread::PRIORITY_LOW | mWorkPriority);
 				mState = WAIT_HTTP_REQ;	
 
-				mFetcher->addToHTTPQueue(mID);
+				mFetcher->addToHTTPQueue(mID, mFetchBudget);
+				LLViewerAssetStatsFF::record_budget_start_thread1((LLViewerAssetStats::EFetchBudget)mFetchBudget);
 				if (! mMetricsStartTime)
 				{
 					mMetricsStartTime = LLViewerAssetStatsFF::get_timestamp();
@@ -1421,6 +1474,12 @@ bool LLTextureFetchWorker::doWork(S32 param)
 				llassert_always(mRawImage.notNull());
 				LL_DEBUGS("Texture") << mID << ": Decoded. Discard: " << mDecodedDiscard
 						<< " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
+				if (mUrl.empty() && !mNeedsAux &&
+					mRawImage->getWidth() * mRawImage->getHeight() >= MIN_DECODED_CACHE_PIXELS)
+				{
+					// Small mips decode quickly, only keep the expensive ones
+					mFetcher->mTextureCache->writeDecoded(mID, mDecodedDiscard, mRawImage);
+				}
 				setPriority(LLWorkerThread::PRIORITY_HIGH | mWorkPriority);
 				mState = WRITE_TO_CACHE;
 			}
@@ -1822,12 +1881,32 @@ LLTextureFetch::LLTextureFetch(LLTextureCache* cache, LLImageDecodeThread* image
 	  mImageDecodeThread(imagedecodethread),
 	  mTextureBandwidth(0),
 	  mHTTPTextureBits(0),
+	  mHTTPBudgetFloorBits(0),
 	  mTotalHTTPRequests(0),
 	  mCurlGetRequest(NULL),
 	  mQAMode(qa_mode)
 {
 	mCurlPOSTRequestCount = 0;
 	mMaxBandwidth = gSavedSettings.getF32("ThrottleBandwidthKBPS");
+	mMaxHTTPRequests = llclamp((S32)gSavedSettings.getU32("TextureFetchMaxHTTPRequests"), 1, 32);
+	mHTTPPipelining = gSavedSettings.getBOOL("TextureFetchHTTPPipelining");
+
+	mHTTPBudgetShare[LLViewerAssetStats::EFBAgentRegion] = llmax(gSavedSettings.getF32("TextureFetchAgentRegionShare"), 0.f);
+	mHTTPBudgetShare[LLViewerAssetStats::EFBNeighborRegions] = llmax(gSavedSettings.getF32("TextureFetchNeighborRegionShare"), 0.f);
+	mHTTPBudgetShare[LLViewerAssetStats::EFBAvatarBakes] = llmax(gSavedSettings.getF32("TextureFetchAvatarBakeShare"), 0.f);
+	F32 share_total = 0.f;
+	for (S32 i = 0; i < LLViewerAssetStats::EFBCount; ++i)
+	{
+		share_total += mHTTPBudgetShare[i];
+	}
+	for (S32 i = 0; i < LLViewerAssetStats::EFBCount; ++i)
+	{
+		mHTTPBudgetShare[i] = share_total > 0.f ? mHTTPBudgetShare[i] / share_total : 1.f / LLViewerAssetStats::EFBCount;
+		mHTTPBudgetMaxRequests[i] = llmax(llround(mHTTPBudgetShare[i] * mMaxHTTPRequests), 1);
+		mHTTPBudgetActive[i] = 0;
+		mHTTPBudgetBits[i] = 0;
+		mHTTPBudgetDemandTime[i] = 0.0;
+	}
 	mTextureInfo.setUpLogging(gSavedSettings.getBOOL("LogTextureDownloadsToViewerLog"), gSavedSettings.getBOOL("LogTextureDownloadsToSimulator"), gSavedSettings.getU32("TextureLoggingThreshold"));
 }
 
@@ -1970,18 +2049,108 @@ void LLTextureFetch::removeFromNetworkQueue(LLTextureFetchWorker* worker, bool c
 }
 
 // protected
-void LLTextureFetch::addToHTTPQueue(const LLUUID& id)
+void LLTextureFetch::addToHTTPQueue(const LLUUID& id, S32 budget)
 {
 	LLMutexLock lock(&mNetworkQueueMutex);
-	mHTTPTextureQueue.insert(id);
+	if (mHTTPTextureQueue.insert(std::make_pair(id, budget)).second)
+	{
+		++mHTTPBudgetActive[budget];
+	}
 	mTotalHTTPRequests++;
 }
 
 void LLTextureFetch::removeFromHTTPQueue(const LLUUID& id, S32 received_size)
 {
+	S32 budget = -1;
+	{
+		LLMutexLock lock(&mNetworkQueueMutex);
+		http_queue_t::iterator iter = mHTTPTextureQueue.find(id);
+		if (iter != mHTTPTextureQueue.end())
+		{
+			budget = iter->second;
+			--mHTTPBudgetActive[budget];
+			mHTTPBudgetBits[budget] += received_size * 8;
+			mHTTPTextureQueue.erase(iter);
+		}
+		mHTTPTextureBits += received_size * 8; // Approximate - does not include header bits	
+	}
+	if (budget >= 0 && received_size > 0)
+	{
+		LLViewerAssetStatsFF::record_budget_bytes_thread1((LLViewerAssetStats::EFetchBudget)budget, received_size);
+	}
+}
+
+// Seconds since its last deferred request during which a budget still
+// counts as wanting its share.
+const F64 HTTP_BUDGET_DEMAND_WINDOW = 1.0;
+
+// protected
+// A budget under both its request and bandwidth shares may always start a
+// request while the global limit allows.  Once over either share it only
+// borrows what other budgets with pending demand are not entitled to.
+bool LLTextureFetch::canStartHTTPRequest(S32 budget)
+{
+	LLMutexLock lock(&mNetworkQueueMutex);
+	const F64 now = LLTimer::getElapsedSeconds();
+	mHTTPBudgetDemandTime[budget] = now;
+
+	const S32 total = (S32)mHTTPTextureQueue.size();
+	if (total >= mMaxHTTPRequests)
+	{
+		return false;
+	}
+
+	U32 window_bits = 0;
+	for (S32 i = 0; i < LLViewerAssetStats::EFBCount; ++i)
+	{
+		window_bits += mHTTPBudgetBits[i];
+	}
+	const F32 window_cap = (F32)llmax(window_bits, mHTTPBudgetFloorBits);
+
+	const bool over_requests = mHTTPBudgetActive[budget] >= mHTTPBudgetMaxRequests[budget];
+	const bool over_bandwidth = (F32)mHTTPBudgetBits[budget] > mHTTPBudgetShare[budget] * window_cap;
+	if (!over_requests && !over_bandwidth)
+	{
+		return true;
+	}
+
+	S32 reserved = 0;
+	for (S32 i = 0; i < LLViewerAssetStats::EFBCount; ++i)
+	{
+		if (i == budget || now - mHTTPBudgetDemandTime[i] > HTTP_BUDGET_DEMAND_WINDOW)
+		{
+			continue;
+		}
+		if (over_bandwidth && (F32)mHTTPBudgetBits[i] < mHTTPBudgetShare[i] * window_cap)
+		{
+			return false; // yield to a budget that is short of its bandwidth
+		}
+		reserved += llmax(mHTTPBudgetMaxRequests[i] - mHTTPBudgetActive[i], 0);
+	}
+	return mMaxHTTPRequests - total > reserved;
+}
+
+// MAIN THREAD
+// Ages the per-budget bandwidth window once a second and refreshes the floor
+// from the texture throttle so that a quiet pipe does not hand the first
+// budget to wake up the whole window.
+void LLTextureFetch::updateHTTPBudgets()
+{
+	if (mHTTPBudgetTimer.getElapsedTimeF32() < 1.f)
+	{
+		return;
+	}
+	mHTTPBudgetTimer.reset();
+
+	// A window halved every second settles at twice the per-second rate
+	const U32 floor_bits = (U32)(gViewerThrottle.getCurrentThrottle(TC_TEXTURE) * 1024.f * 2.f);
+
 	LLMutexLock lock(&mNetworkQueueMutex);
-	mHTTPTextureQueue.erase(id);
-	mHTTPTextureBits += received_size * 8; // Approximate - does not include header bits	
+	mHTTPBudgetFloorBits = floor_bits;
+	for (S32 i = 0; i < LLViewerAssetStats::EFBCount; ++i)
+	{
+		mHTTPBudgetBits[i] /= 2;
+	}
 }
 
 void LLTextureFetch::deleteRequest(const LLUUID& id, bool cancel)
@@ -2118,18 +2287,47 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 	return res;
 }
 
-bool LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority)
+// MAIN THREAD
+void LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority)
 {
-	bool res = false;
-	LLTextureFetchWorker* worker = getWorker(id);
-	if (worker)
+	// Later updates for the same request replace earlier ones
+	mPendingPriorities[id] = priority;
+}
+
+// MAIN THREAD
+void LLTextureFetch::flushRequestPriorities()
+{
+	if (mPendingPriorities.empty())
+	{
+		return;
+	}
+
+	// Look all the workers up under a single queue lock
+	typedef std::vector<std::pair<LLTextureFetchWorker*, F32> > worker_priority_list_t;
+	worker_priority_list_t workers;
+	workers.reserve(mPendingPriorities.size());
+	lockQueue() ;
+	for (priority_map_t::iterator iter = mPendingPriorities.begin();
+		 iter != mPendingPriorities.end(); ++iter)
+	{
+		LLTextureFetchWorker* worker = getWorkerAfterLock(iter->first);
+		if (worker)
+		{
+			workers.push_back(std::make_pair(worker, iter->second));
+		}
+	}
+	unlockQueue() ;
+	mPendingPriorities.clear();
+
+	// Workers are only deleted on the main thread, so the pointers stay valid here
+	for (worker_priority_list_t::iterator iter = workers.begin();
+		 iter != workers.end(); ++iter)
 	{
+		LLTextureFetchWorker* worker = iter->first;
 		worker->lockWorkMutex();
-		worker->setImagePriority(priority);
+		worker->setImagePriority(iter->second);
 		worker->unlockWorkMutex();
-		res = true;
 	}
-	return res;
 }
 
 // Replicates and expands upon the base class's
@@ -2218,6 +2416,9 @@ S32 LLTextureFetch::update(F32 max_time_ms)
 		mNetworkQueueMutex.unlock() ;
 	}
 
+	flushRequestPriorities();
+	updateHTTPBudgets();
+
 	S32 res = LLWorkerThread::update(max_time_ms);
 	
 	if (!mDebugPause)
@@ -2258,6 +2459,9 @@ void LLTextureFetch::startThread()
 {
 	// Construct mCurlGetRequest from Worker Thread
 	mCurlGetRequest = new LLCurlRequest();
+	// Keep one persistent connection per concurrent GET so texture
+	// requests to the same host don't pay for a new TCP/SSL handshake.
+	mCurlGetRequest->setConnectionPolicy(mMaxHTTPRequests, mHTTPPipelining);
 }
 
 // WORKER THREAD
@@ -32,8 +32,10 @@
 #include "lluuid.h"
 #include "llworkerthread.h"
 #include "llcurl.h"
+#include "llframetimer.h"
 #include "lltextureinfo.h"
 #include "llapr.h"
+#include "llviewerassetstats.h"
 
 class LLViewerTexture;
 class LLTextureFetchWorker;
@@ -64,7 +66,8 @@ public:
 	void deleteRequest(const LLUUID& id, bool cancel);
 	bool getRequestFinished(const LLUUID& id, S32& discard_level,
 							LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux);
-	bool updateRequestPriority(const LLUUID& id, F32 priority);
+	// Queued and applied to the workers in one batch by update()
+	void updateRequestPriority(const LLUUID& id, F32 priority);
 
 	bool receiveImageHeader(const LLHost& host, const LLUUID& id, U8 codec, U16 packets, U32 totalbytes, U16 data_size, U8* data);
 	bool receiveImagePacket(const LLHost& host, const LLUUID& id, U16 packet_num, U16 data_size, U8* data);
@@ -109,7 +112,8 @@ public:
 protected:
 	void addToNetworkQueue(LLTextureFetchWorker* worker);
 	void removeFromNetworkQueue(LLTextureFetchWorker* worker, bool cancel);
-	void addToHTTPQueue(const LLUUID& id);
+	void addToHTTPQueue(const LLUUID& id, S32 budget);
+	bool canStartHTTPRequest(S32 budget);
 	void removeFromHTTPQueue(const LLUUID& id, S32 received_size = 0);
 	void removeRequest(LLTextureFetchWorker* worker, bool cancel);
 
@@ -122,6 +126,8 @@ private:
 	/*virtual*/ void endThread(void);
 	/*virtual*/ void threadedUpdate(void);
 	void commonUpdate();
+	void flushRequestPriorities();
+	void updateHTTPBudgets();
 
 	// Metrics command helpers
 	/**
@@ -175,18 +181,36 @@ private:
 	// Set of requests that require network data
 	typedef std::set<LLUUID> queue_t;
 	queue_t mNetworkQueue;
-	queue_t mHTTPTextureQueue;
+	typedef std::map<LLUUID, S32> http_queue_t; // id -> LLViewerAssetStats::EFetchBudget
+	http_queue_t mHTTPTextureQueue;
 	typedef std::map<LLHost,std::set<LLUUID> > cancel_queue_t;
 	cancel_queue_t mCancelQueue;
 	F32 mTextureBandwidth;
 	F32 mMaxBandwidth;
+	S32 mMaxHTTPRequests;	// concurrent HTTP GETs, also the keep-alive pool size
+	bool mHTTPPipelining;
 	LLTextureInfo mTextureInfo;
 
 	U32 mHTTPTextureBits;
 
+	// HTTP fetch budgets, protected by mNetworkQueueMutex.  Each budget is
+	// guaranteed its share of mMaxHTTPRequests and of the bits received in
+	// the current window, and may borrow whatever the others leave idle.
+	F32 mHTTPBudgetShare[LLViewerAssetStats::EFBCount];
+	S32 mHTTPBudgetMaxRequests[LLViewerAssetStats::EFBCount];
+	S32 mHTTPBudgetActive[LLViewerAssetStats::EFBCount];
+	U32 mHTTPBudgetBits[LLViewerAssetStats::EFBCount];
+	F64 mHTTPBudgetDemandTime[LLViewerAssetStats::EFBCount]; // last time a request was waiting
+	U32 mHTTPBudgetFloorBits;	// texture throttle over one window
+	LLFrameTimer mHTTPBudgetTimer; // main thread only
+
 	//debug use
 	U32 mTotalHTTPRequests ;
 
+	// Priority changes waiting for the next update(), main thread only
+	typedef std::map<LLUUID, F32> priority_map_t;
+	priority_map_t mPendingPriorities;
+
 	// Out-of-band cross-thread command queue.  This command queue
 	// is logically tied to LLQueuedThread's list of
 	// QueuedRequest instances and so must be covered by the
@@ -108,6 +108,12 @@ LLViewerAssetStats::PerRegionStats::reset()
 		mRequests[i].mDequeued.reset();
 		mRequests[i].mResponse.reset();
 	}
+	for (int i(0); i < LL_ARRAY_SIZE(mFetchBudgets); ++i)
+	{
+		mFetchBudgets[i].mStarted.reset();
+		mFetchBudgets[i].mDeferred.reset();
+		mFetchBudgets[i].mBytes.reset();
+	}
 	mFPS.reset();
 	
 	mTotalTime = 0;
@@ -133,6 +139,14 @@ LLViewerAssetStats::PerRegionStats::merge(const LLViewerAssetStats::PerRegionSta
 		mRequests[i].mDequeued.merge(src.mRequests[i].mDequeued);
 		mRequests[i].mResponse.merge(src.mRequests[i].mResponse);
 	}
+
+	// Fetch budgets
+	for (int i = 0; i < LL_ARRAY_SIZE(mFetchBudgets); ++i)
+	{
+		mFetchBudgets[i].mStarted.merge(src.mFetchBudgets[i].mStarted);
+		mFetchBudgets[i].mDeferred.merge(src.mFetchBudgets[i].mDeferred);
+		mFetchBudgets[i].mBytes.merge(src.mFetchBudgets[i].mBytes);
+	}
 }
 
 
@@ -252,6 +266,24 @@ LLViewerAssetStats::recordFPS(F32 fps)
 	mCurRegionStats->mFPS.record(fps);
 }
 
+void
+LLViewerAssetStats::recordFetchBudgetStarted(EFetchBudget budget)
+{
+	++(mCurRegionStats->mFetchBudgets[int(budget)].mStarted);
+}
+
+void
+LLViewerAssetStats::recordFetchBudgetDeferred(EFetchBudget budget)
+{
+	++(mCurRegionStats->mFetchBudgets[int(budget)].mDeferred);
+}
+
+void
+LLViewerAssetStats::recordFetchBudgetBytes(EFetchBudget budget, U32 bytes)
+{
+	mCurRegionStats->mFetchBudgets[int(budget)].mBytes.record(bytes);
+}
+
 LLSD
 LLViewerAssetStats::asLLSD(bool compact_output)
 {
@@ -268,6 +300,13 @@ LLViewerAssetStats::asLLSD(bool compact_output)
 			LLSD::String("get_other")
 		};
 
+	static const LLSD::String budget_tags[EFBCount] = 
+		{
+			LLSD::String("fetch_budget_agent_region"),
+			LLSD::String("fetch_budget_neighbor_regions"),
+			LLSD::String("fetch_budget_avatar_bakes")
+		};
+
 	// Stats Group Sub-tags.
 	static const LLSD::String enq_tag("enqueued");
 	static const LLSD::String deq_tag("dequeued");
@@ -282,6 +321,11 @@ LLViewerAssetStats::asLLSD(bool compact_output)
 	static const LLSD::String max_tag("max");
 	static const LLSD::String mean_tag("mean");
 
+	// Budget Group Sub-tags.
+	static const LLSD::String start_tag("started");
+	static const LLSD::String defer_tag("deferred");
+	static const LLSD::String bytes_tag("bytes");
+
 	const duration_t now = LLViewerAssetStatsFF::get_timestamp();
 	mCurRegionStats->accumulateTime(now);
 
@@ -320,6 +364,23 @@ LLViewerAssetStats::asLLSD(bool compact_output)
 			}
 		}
 
+		for (int i = 0; i < LL_ARRAY_SIZE(budget_tags); ++i)
+		{
+			PerRegionStats::fb_group & group(stats.mFetchBudgets[i]);
+			
+			if ((! compact_output) ||
+				group.mStarted.getCount() ||
+				group.mDeferred.getCount())
+			{
+				LLSD & slot = reg_stat[budget_tags[i]];
+				slot = LLSD::emptyMap();
+				slot[start_tag] = LLSD(S32(group.mStarted.getCount()));
+				slot[defer_tag] = LLSD(S32(group.mDeferred.getCount()));
+				slot[rcnt_tag] = LLSD(S32(group.mBytes.getCount()));
+				slot[bytes_tag] = LLSD(group.mBytes.getMean() * group.mBytes.getCount());
+			}
+		}
+
 		if ((! compact_output) || stats.mFPS.getCount())
 		{
 			LLSD & slot = reg_stat["fps"];
@@ -478,6 +539,33 @@ record_response_thread1(LLViewerAssetType::EType at, bool with_http, bool is_tem
 	gViewerAssetStatsThread1->recordGetServiced(at, with_http, is_temp, duration);
 }
 
+void
+record_budget_start_thread1(LLViewerAssetStats::EFetchBudget budget)
+{
+	if (! gViewerAssetStatsThread1)
+		return;
+
+	gViewerAssetStatsThread1->recordFetchBudgetStarted(budget);
+}
+
+void
+record_budget_defer_thread1(LLViewerAssetStats::EFetchBudget budget)
+{
+	if (! gViewerAssetStatsThread1)
+		return;
+
+	gViewerAssetStatsThread1->recordFetchBudgetDeferred(budget);
+}
+
+void
+record_budget_bytes_thread1(LLViewerAssetStats::EFetchBudget budget, U32 bytes)
+{
+	if (! gViewerAssetStatsThread1)
+		return;
+
+	gViewerAssetStatsThread1->recordFetchBudgetBytes(budget, bytes);
+}
+
 
 void
 init()
@@ -89,6 +89,19 @@ public:
 		EVACCount						// Must be last
 	};
 
+	/**
+	 * Texture fetch budgets, each with its own share of concurrent
+	 * HTTP requests and of texture bandwidth (see LLTextureFetch).
+	 */
+	enum EFetchBudget
+	{
+		EFBAgentRegion,					//< Textures from the agent's region
+		EFBNeighborRegions,				//< Textures from other connected regions
+		EFBAvatarBakes,					//< Baked avatar textures
+
+		EFBCount						// Must be last
+	};
+
 	/**
 	 * Type for duration and other time values in the metrics.  Selected
 	 * for compatibility with the pre-existing timestamp on the texture
@@ -131,6 +144,10 @@ public:
 				{
 					mRequests[i] = src.mRequests[i];
 				}
+				for (int i = 0; i < LL_ARRAY_SIZE(mFetchBudgets); ++i)
+				{
+					mFetchBudgets[i] = src.mFetchBudgets[i];
+				}
 			}
 
 		// Default assignment and destructor are correct.
@@ -156,6 +173,14 @@ public:
 			LLSimpleStatMMM<duration_t>	mResponse;
 		}
 		mRequests [EVACCount];
+
+		struct fb_group
+		{
+			LLSimpleStatCounter			mStarted;
+			LLSimpleStatCounter			mDeferred;
+			LLSimpleStatMMM<F64>		mBytes;
+		}
+		mFetchBudgets [EFBCount];
 	};
 
 public:
@@ -181,6 +206,11 @@ public:
 	// Frames-Per-Second Samples
 	void recordFPS(F32 fps);
 
+	// Texture fetch budgets
+	void recordFetchBudgetStarted(EFetchBudget budget);
+	void recordFetchBudgetDeferred(EFetchBudget budget);
+	void recordFetchBudgetBytes(EFetchBudget budget, U32 bytes);
+
 	// Merge a source instance into a destination instance.  This is
 	// conceptually an 'operator+=()' method:
 	// - counts are added
@@ -209,6 +239,13 @@ public:
 	//   mean  : float
 	// }
 	//
+	// &budget_group = {
+	//   started    : int,
+	//   deferred   : int,
+	//   resp_count : int,
+	//   bytes      : float
+	// }
+	//
 	// {
 	//   duration: int
 	//   regions: {
@@ -222,7 +259,10 @@ public:
 	//       get_wearable_udp          : &stats_group,
 	//       get_sound_udp             : &stats_group,
 	//       get_gesture_udp           : &stats_group,
-	//       get_other                 : &stats_group
+	//       get_other                 : &stats_group,
+	//       fetch_budget_agent_region     : &budget_group,
+	//       fetch_budget_neighbor_regions : &budget_group,
+	//       fetch_budget_avatar_bakes     : &budget_group
 	//     }
 	//   }
 	// }
@@ -323,6 +363,12 @@ void record_dequeue_thread1(LLViewerAssetType::EType at, bool with_http, bool is
 void record_response_thread1(LLViewerAssetType::EType at, bool with_http, bool is_temp,
 						  LLViewerAssetStats::duration_t duration);
 
+void record_budget_start_thread1(LLViewerAssetStats::EFetchBudget budget);
+
+void record_budget_defer_thread1(LLViewerAssetStats::EFetchBudget budget);
+
+void record_budget_bytes_thread1(LLViewerAssetStats::EFetchBudget budget, U32 bytes);
+
 } // namespace LLViewerAssetStatsFF
 
 #endif // LL_LLVIEWERASSETSTATUS_H
@@ -322,6 +322,7 @@ void LLViewerAssetStorage::storeAssetData(
  * with the following changes:
  *  -  Use a locally-derived request class
  *  -  Start timing for metrics when request is queued
+ *  -  Transfer priority depends on asset type (see asset_type_priority)
  *
  * This is an unfortunate implementation choice but it's forced by
  * current conditions.  A refactoring that might clean up the layers
@@ -332,6 +333,27 @@ void LLViewerAssetStorage::storeAssetData(
  * as well.
  */
 
+// Extra transfer priority by asset type. The simulator sends higher priority
+// transfers first, so at login what the outfit needs goes ahead of the
+// gestures, sounds and notecards that queue up alongside it.
+static F32 asset_type_priority(LLAssetType::EType atype)
+{
+	switch (atype)
+	{
+	case LLAssetType::AT_BODYPART:
+	case LLAssetType::AT_CLOTHING:
+		return 8.f;
+	case LLAssetType::AT_ANIMATION:
+		return 6.f;
+	case LLAssetType::AT_GESTURE:
+		return 4.f;
+	case LLAssetType::AT_SOUND:
+		return 0.f;
+	default:
+		return 2.f;
+	}
+}
+
 // virtual
 void LLViewerAssetStorage::_queueDataRequest(
 	const LLUUID& uuid,
@@ -371,7 +393,7 @@ void LLViewerAssetStorage::_queueDataRequest(
 
 			LL_DEBUGS("AssetStorage") << "Starting transfer for " << uuid << llendl;
 			LLTransferTargetChannel *ttcp = gTransferManager.getTargetChannel(mUpstreamHost, LLTCT_ASSET);
-			ttcp->requestTransfer(spa, tpvf, 100.f + (is_priority ? 1.f : 0.f));
+			ttcp->requestTransfer(spa, tpvf, 100.f + asset_type_priority(atype) + (is_priority ? 1.f : 0.f));
 
 			LLViewerAssetStatsFF::record_enqueue_main(atype, false, false);
 		}
@@ -29,6 +29,7 @@
 #include "llviewerdisplay.h"
 
 #include "llgl.h"
+#include "llgputimer.h"
 #include "llrender.h"
 #include "llglheaders.h"
 #include "llagent.h"
@@ -40,7 +41,10 @@
 #include "lldynamictexture.h"
 #include "lldrawpoolalpha.h"
 #include "llfeaturemanager.h"
+#include "llfloaterreg.h"
+#include "llmemoryusage.h"
 //#include "llfirstuse.h"
+#include "llhudlayer.h"
 #include "llhudmanager.h"
 #include "llimagebmp.h"
 #include "llmemory.h"
@@ -208,6 +212,7 @@ void display_stats()
 		U32 memory = (U32)(gMemoryAllocated / (1024*1024));
 		llinfos << llformat("MEMORY: %d MB", memory) << llendl;
 		LLMemory::logMemoryInfo(TRUE) ;
+		LLMemoryUsage::logUsage();
 		gRecentMemoryTime.reset();
 	}
 }
@@ -1010,7 +1015,29 @@ void render_hud_attachments()
 	// smoothly interpolate current zoom level
 	gAgentCamera.mHUDCurZoom = lerp(gAgentCamera.mHUDCurZoom, gAgentCamera.mHUDTargetZoom, LLCriticalDamp::getInterpolant(0.03f));
 
-	if (LLPipeline::sShowHUDAttachments && !gDisconnected && setup_hud_matrices())
+	bool hud_visible = LLPipeline::sShowHUDAttachments && !gDisconnected && setup_hud_matrices();
+
+	// also gathers the per HUD complexity for the debug display
+	bool hud_stale = hud_visible && LLHUDLayer::getInstance()->update();
+
+	LLRenderTarget& hud_layer = gPipeline.mHUDScreen;
+	bool use_hud_layer = hud_visible && LLPipeline::RenderHUDBuffer && hud_layer.isComplete() &&
+						 LLHUDLayer::getInstance()->isCacheable();
+
+	LLRenderTarget* prev_target = LLRenderTarget::getCurrentBoundTarget();
+
+	if (use_hud_layer && hud_stale)
+	{
+		hud_layer.bindTarget();
+		// the HUD matrices are set up for the world view, not the whole target
+		glViewport(0, 0, gGLViewport[2], gGLViewport[3]);
+		gGL.setColorMask(true, true);
+		glClearColor(0.f, 0.f, 0.f, 0.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		gGL.setCoverageAlphaBlend(true);
+	}
+
+	if (hud_visible && (hud_stale || !use_hud_layer))
 	{
 		LLCamera hud_cam = *LLViewerCamera::getInstance();
 		LLVector3 origin = hud_cam.getOrigin();
@@ -1086,6 +1113,59 @@ void render_hud_attachments()
 		}
 		LLPipeline::sUseOcclusion = use_occlusion;
 	}
+
+	if (use_hud_layer && hud_stale)
+	{
+		gGL.setCoverageAlphaBlend(false);
+		gGL.setColorMask(true, false);
+		hud_layer.flush();
+		if (prev_target)
+		{
+			prev_target->bindTarget();
+		}
+		glViewport(gGLViewport[0], gGLViewport[1], gGLViewport[2], gGLViewport[3]);
+		LLHUDLayer::getInstance()->markDrawn();
+	}
+
+	if (use_hud_layer)
+	{ //composite the layer over the world view, its color is premultiplied
+		gGL.matrixMode(LLRender::MM_PROJECTION);
+		gGL.loadIdentity();
+		gGL.matrixMode(LLRender::MM_MODELVIEW);
+		gGL.loadIdentity();
+
+		if (LLGLSLShader::sNoFixedFunction)
+		{
+			gUIProgram.bind();
+		}
+
+		LLGLDisable depth(GL_DEPTH_TEST);
+		LLGLDisable cull(GL_CULL_FACE);
+		LLGLEnable blend(GL_BLEND);
+		gGL.blendFunc(LLRender::BF_ONE, LLRender::BF_ONE_MINUS_SOURCE_ALPHA);
+
+		F32 tc_x = (F32) gGLViewport[2] / hud_layer.getWidth();
+		F32 tc_y = (F32) gGLViewport[3] / hud_layer.getHeight();
+
+		gGL.getTexUnit(0)->bind(&hud_layer);
+		gGL.color4f(1,1,1,1);
+		gGL.begin(LLRender::TRIANGLE_STRIP);
+		gGL.texCoord2f(0.f, 0.f);		gGL.vertex2f(-1.f, -1.f);
+		gGL.texCoord2f(tc_x, 0.f);		gGL.vertex2f(1.f, -1.f);
+		gGL.texCoord2f(0.f, tc_y);		gGL.vertex2f(-1.f, 1.f);
+		gGL.texCoord2f(tc_x, tc_y);		gGL.vertex2f(1.f, 1.f);
+		gGL.end();
+		gGL.flush();
+		gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+
+		gGL.setSceneBlendType(LLRender::BT_ALPHA);
+
+		if (LLGLSLShader::sNoFixedFunction)
+		{
+			gUIProgram.unbind();
+		}
+	}
+
 	gGL.matrixMode(LLRender::MM_PROJECTION);
 	gGL.popMatrix();
 	gGL.matrixMode(LLRender::MM_MODELVIEW);
@@ -1259,6 +1339,11 @@ void render_ui(F32 zoom_factor, int subfield)
 		gViewerWindow->getWindow()->swapBuffers();
 	}
 	gDisplaySwapBuffers = TRUE;
+
+	// GPU timers cost a query per pass, only run them while someone is looking
+	static LLCachedControl<bool> render_gpu_timers(gSavedSettings, "RenderGPUTimers");
+	LLGPUTimer::setEnabled(render_gpu_timers || LLFastTimer::sLog || LLFloaterReg::instanceVisible("fast_timers"));
+	LLGPUTimer::nextFrame();
 }
 
 void renderCoordinateAxes()
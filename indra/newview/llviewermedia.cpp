@@ -845,6 +845,10 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
 	F32 max_cpu = gSavedSettings.getF32("PluginInstancesCPULimit");
 	// Setting max_cpu to 0.0 disables CPU usage checking.
 	bool check_cpu_usage = (max_cpu != 0.0f);
+	// Likewise for the pixel budget of normal priority inworld media
+	F64 max_normal_pixels = gSavedSettings.getU32("PluginInstancesNormalPixels");
+	bool check_normal_pixels = (max_normal_pixels != 0.0);
+	F64 total_normal_pixels = 0.0;
 	
 	LLViewerMediaImpl* lowest_interest_loadable = NULL;
 	
@@ -913,11 +917,14 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
 					// Higher priority plugins have already used up the CPU budget.  Set remaining ones to slideshow priority.
 					new_priority = LLPluginClassMedia::PRIORITY_SLIDESHOW;
 				}
-				else if((impl_count_interest_normal < (int)max_normal) && !media_is_small)
+				else if((impl_count_interest_normal < (int)max_normal) && !media_is_small
+						&& (!check_normal_pixels || total_normal_pixels + approximate_interest <= max_normal_pixels))
 				{
-					// Up to max_normal inworld get normal priority
+					// Up to max_normal inworld get normal priority, as long as
+					// together they don't decode more than max_normal_pixels
 					new_priority = LLPluginClassMedia::PRIORITY_NORMAL;
 					impl_count_interest_normal++;
+					total_normal_pixels += approximate_interest;
 				}
 				else if (impl_count_interest_low + impl_count_interest_normal < (int)max_low + (int)max_normal)
 				{
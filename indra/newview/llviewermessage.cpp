@@ -98,6 +98,7 @@
 #include "llviewerwindow.h"
 #include "llvlmanager.h"
 #include "llvoavatarself.h"
+#include "llvocache.h"
 #include "llworld.h"
 #include "pipeline.h"
 #include "llfloaterworldmap.h"
@@ -4087,6 +4088,13 @@ void process_teleport_finish(LLMessageSystem* msg, void**)
 
 	LLHost sim_host(sim_ip, sim_port);
 
+	// Start pulling the destination's objects off disk now, the region
+	// won't ask for them until its handshake comes back.
+	if (LLVOCache::hasInstance())
+	{
+		LLVOCache::getInstance()->prefetchRegion(region_handle);
+	}
+
 	// Viewer trusts the simulator.
 	gMessageSystem->enableCircuit(sim_host, TRUE);
 	LLViewerRegion* regionp =  LLWorld::getInstance()->addRegion(region_handle, sim_host);
@@ -233,7 +233,7 @@ LLViewerObject::LLViewerObject(const LLUUID &id, const LLPCode pcode, LLViewerRe
 	mDead(FALSE),
 	mOrphaned(FALSE),
 	mUserSelected(FALSE),
-	mOnActiveList(FALSE),
+	mListIndex(-1),
 	mOnMap(FALSE),
 	mStatic(FALSE),
 	mNumFaces(0),
@@ -182,8 +182,9 @@ public:
 
 
 	virtual BOOL    isActive() const; // Whether this object needs to do an idleUpdate.
-	BOOL			onActiveList() const				{return mOnActiveList;}
-	void			setOnActiveList(BOOL on_active)		{ mOnActiveList = on_active; }
+	BOOL			onActiveList() const				{ return mListIndex != -1; }
+	S32				getListIndex() const				{ return mListIndex; }
+	void			setListIndex(S32 index)				{ mListIndex = index; }
 
 	virtual BOOL	isAttachment() const { return FALSE; }
 	virtual LLVOAvatar* getAvatar() const;  //get the avatar this object is attached to, or NULL if object is not an attachment
@@ -712,7 +713,7 @@ protected:
 	BOOL			mDead;
 	BOOL			mOrphaned;					// This is an orphaned child
 	BOOL			mUserSelected;				// Cached user select information
-	BOOL			mOnActiveList;
+	S32				mListIndex;					// Index in LLViewerObjectList::mActiveObjects, -1 if not active
 	BOOL			mOnMap;						// On the map.
 	BOOL			mStatic;					// Object doesn't move.
 	S32				mNumFaces;
@@ -96,8 +96,8 @@ extern LLPipeline	gPipeline;
 
 // Statics for object lookup tables.
 U32						LLViewerObjectList::sSimulatorMachineIndex = 1; // Not zero deliberately, to speed up index check.
-std::map<U64, U32>			LLViewerObjectList::sIPAndPortToIndex;
-std::map<U64, LLUUID>	LLViewerObjectList::sIndexAndLocalIDToUUID;
+boost::unordered_map<U64, U32>		LLViewerObjectList::sIPAndPortToIndex;
+boost::unordered_map<U64, LLUUID>	LLViewerObjectList::sIndexAndLocalIDToUUID;
 
 LLViewerObjectList::LLViewerObjectList()
 {
@@ -108,6 +108,9 @@ LLViewerObjectList::LLViewerObjectList()
 	mNumDeadObjects = 0;
 	mNumOrphans = 0;
 	mNumNewObjects = 0;
+	mNumCacheHits = 0;
+	mNumCacheMisses = 0;
+	mNumCacheDupes = 0;
 	mWasPaused = FALSE;
 	mNumDeadObjectUpdates = 0;
 	mNumUnknownKills = 0;
@@ -148,7 +151,15 @@ void LLViewerObjectList::getUUIDFromLocal(LLUUID &id,
 
 	U64	indexid = (((U64)index) << 32) | (U64)local_id;
 
-	id = get_if_there(sIndexAndLocalIDToUUID, indexid, LLUUID::null);
+	boost::unordered_map<U64, LLUUID>::const_iterator iter = sIndexAndLocalIDToUUID.find(indexid);
+	if (iter != sIndexAndLocalIDToUUID.end())
+	{
+		id = iter->second;
+	}
+	else
+	{
+		id.setNull();
+	}
 }
 
 U64 LLViewerObjectList::getIndex(const U32 local_id,
@@ -181,7 +192,7 @@ BOOL LLViewerObjectList::removeFromLocalIDTable(const LLViewerObject* objectp)
 		
 		U64	indexid = (((U64)index) << 32) | (U64)local_id;
 		
-		std::map<U64, LLUUID>::iterator iter = sIndexAndLocalIDToUUID.find(indexid);
+		boost::unordered_map<U64, LLUUID>::iterator iter = sIndexAndLocalIDToUUID.find(indexid);
 		if (iter == sIndexAndLocalIDToUUID.end())
 		{
 			return FALSE;
@@ -312,7 +323,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 	LLMemType mt(LLMemType::MTYPE_OBJECT_PROCESS_UPDATE);
 	LLFastTimer t(FTM_PROCESS_OBJECTS);	
 	
-	LLVector3d camera_global = gAgentCamera.getCameraPositionGlobal();
 	LLViewerObject *objectp;
 	S32			num_objects;
 	U32			local_id;
@@ -378,8 +388,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 
 	for (i = 0; i < num_objects; i++)
 	{
-		// timer is unused?
-		LLTimer update_timer;
 		BOOL justCreated = FALSE;
 
 		if (cached)
@@ -395,6 +403,7 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			if (cached_dpp)
 			{
 				// Cache Hit.
+				mNumCacheHits++;
 				cached_dpp->reset();
 				cached_dpp->unpackUUID(fullid, "ID");
 				cached_dpp->unpackU32(local_id, "LocalID");
@@ -403,6 +412,7 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			else
 			{
 				// Cache Miss.
+				mNumCacheMisses++;
 				#if LL_RECORD_VIEWER_STATS
 				LLViewerStatsRecorder::instance()->recordCacheMissEvent(id, update_type, cache_miss_type);
 				#endif
@@ -588,11 +598,13 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
 			{
 				bCached = true;
-				#if LL_RECORD_VIEWER_STATS
 				LLViewerRegion::eCacheUpdateResult result = objectp->mRegionp->cacheFullUpdate(objectp, compressed_dp);
+				if (result == LLViewerRegion::CACHE_UPDATE_DUPE)
+				{
+					mNumCacheDupes++;
+				}
+				#if LL_RECORD_VIEWER_STATS
 				LLViewerStatsRecorder::instance()->recordCacheFullUpdate(local_id, update_type, result, objectp);
-				#else
-				objectp->mRegionp->cacheFullUpdate(objectp, compressed_dp);
 				#endif
 			}
 		}
@@ -620,7 +632,8 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 	LLViewerStatsRecorder::instance()->endObjectUpdateEvents();
 #endif
 
-	LLVOAvatar::cullAvatarsByPixelArea();
+	// Avatar ranking is redone once per frame in update(), there is no need
+	// to sort every avatar again for each update packet that arrives.
 }
 
 void LLViewerObjectList::processCompressedObjectUpdate(LLMessageSystem *mesgsys,
@@ -963,7 +976,7 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 		LLFastTimer t(idle_copy);
 		idle_list.reserve( mActiveObjects.size() );
 
- 		for (std::set<LLPointer<LLViewerObject> >::iterator active_iter = mActiveObjects.begin();
+ 		for (vobj_list_t::iterator active_iter = mActiveObjects.begin();
 			active_iter != mActiveObjects.end(); active_iter++)
 		{
 			objectp = *active_iter;
@@ -979,6 +992,9 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 		}
 	}
 
+	//avatar pose blending and physics are batched up and finished on the render workers below
+	LLVOAvatar::beginDeferredUpdates();
+
 	if (gSavedSettings.getBOOL("FreezeTime"))
 	{
 		for (std::vector<LLViewerObject*>::iterator iter = idle_list.begin();
@@ -990,6 +1006,8 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 				objectp->idleUpdate(agent, world, frame_time);
 			}
 		}
+
+		LLVOAvatar::finishDeferredUpdates();
 	}
 	else
 	{
@@ -1005,8 +1023,16 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 			else
 			{
 				num_active_objects++;
+
+				if (!objectp->isActive())
+				{ //stopped moving or went static this frame, drop it until something wakes it up
+					updateActive(objectp);
+				}
 			}
 		}
+
+		LLVOAvatar::finishDeferredUpdates();
+
 		for (std::vector<LLViewerObject*>::iterator kill_iter = kill_list.begin();
 			kill_iter != kill_list.end(); kill_iter++)
 		{
@@ -1241,8 +1267,7 @@ void LLViewerObjectList::cleanupReferences(LLViewerObject *objectp)
 	if (objectp->onActiveList())
 	{
 		//llinfos << "Removing " << objectp->mID << " " << objectp->getPCodeString() << " from active list in cleanupReferences." << llendl;
-		objectp->setOnActiveList(FALSE);
-		mActiveObjects.erase(objectp);
+		removeFromActiveList(objectp);
 	}
 
 	if (objectp->isOnMap())
@@ -1356,6 +1381,10 @@ void LLViewerObjectList::killAllObjects()
 	if (!mActiveObjects.empty())
 	{
 		llwarns << "Some objects still on active object list!" << llendl;
+		for (vobj_list_t::iterator iter = mActiveObjects.begin(); iter != mActiveObjects.end(); ++iter)
+		{
+			(*iter)->setListIndex(-1);
+		}
 		mActiveObjects.clear();
 	}
 
@@ -1433,16 +1462,35 @@ void LLViewerObjectList::updateActive(LLViewerObject *objectp)
 		if (active)
 		{
 			//llinfos << "Adding " << objectp->mID << " " << objectp->getPCodeString() << " to active list." << llendl;
-			mActiveObjects.insert(objectp);
-			objectp->setOnActiveList(TRUE);
+			objectp->setListIndex(mActiveObjects.size());
+			mActiveObjects.push_back(objectp);
 		}
 		else
 		{
 			//llinfos << "Removing " << objectp->mID << " " << objectp->getPCodeString() << " from active list." << llendl;
-			mActiveObjects.erase(objectp);
-			objectp->setOnActiveList(FALSE);
+			removeFromActiveList(objectp);
+		}
+	}
+}
+
+void LLViewerObjectList::removeFromActiveList(LLViewerObject* objectp)
+{
+	S32 idx = objectp->getListIndex();
+	if (idx >= 0 && idx < (S32) mActiveObjects.size() && mActiveObjects[idx] == objectp)
+	{
+		//swap the last object into the hole so the list stays packed
+		if (idx != (S32) mActiveObjects.size() - 1)
+		{
+			mActiveObjects[idx] = mActiveObjects.back();
+			mActiveObjects[idx]->setListIndex(idx);
 		}
+		mActiveObjects.pop_back();
 	}
+	else
+	{
+		llwarns << "Active object " << objectp->mID << " has bad list index " << idx << llendl;
+	}
+	objectp->setListIndex(-1);
 }
 
 void LLViewerObjectList::updateObjectCost(LLViewerObject* object)
@@ -1989,13 +2037,11 @@ void LLViewerObjectList::orphanize(LLViewerObject *childp, U32 parent_id, U32 ip
 	// Unknown parent, add to orpaned child list
 	U64 parent_info = getIndex(parent_id, ip, port);
 
-	if (std::find(mOrphanParents.begin(), mOrphanParents.end(), parent_info) == mOrphanParents.end())
-	{
-		mOrphanParents.push_back(parent_info);
-	}
+	//a parent we haven't seen before can't have this child listed yet
+	bool new_parent = mOrphanParents.insert(parent_info).second;
 
 	LLViewerObjectList::OrphanInfo oi(parent_info, childp->mID);
-	if (std::find(mOrphanChildren.begin(), mOrphanChildren.end(), oi) == mOrphanChildren.end())
+	if (new_parent || std::find(mOrphanChildren.begin(), mOrphanChildren.end(), oi) == mOrphanChildren.end())
 	{
 		mOrphanChildren.push_back(oi);
 		mNumOrphans++;
@@ -2013,20 +2059,19 @@ void LLViewerObjectList::findOrphans(LLViewerObject* objectp, U32 ip, U32 port)
 	}
 
 	// See if we are a parent of an orphan.
-	// Note:  This code is fairly inefficient but it should happen very rarely.
-	// It can be sped up if this is somehow a performance issue...
 	if (mOrphanParents.empty())
 	{
 		// no known orphan parents
 		return;
 	}
-	if (std::find(mOrphanParents.begin(), mOrphanParents.end(), getIndex(objectp->mLocalID, ip, port)) == mOrphanParents.end())
+
+	U64 parent_info = getIndex(objectp->mLocalID, ip, port);
+	if (mOrphanParents.find(parent_info) == mOrphanParents.end())
 	{
 		// did not find objectp in OrphanParent list
 		return;
 	}
 
-	U64 parent_info = getIndex(objectp->mLocalID, ip, port);
 	BOOL orphans_found = FALSE;
 	// Iterate through the orphan list, and set parents of matching children.
 
@@ -2044,6 +2089,7 @@ void LLViewerObjectList::findOrphans(LLViewerObject* objectp, U32 ip, U32 port)
 			{
 				llwarns << objectp->mID << " has self as parent, skipping!" 
 					<< llendl;
+				++iter;
 				continue;
 			}
 
@@ -2082,26 +2128,22 @@ void LLViewerObjectList::findOrphans(LLViewerObject* objectp, U32 ip, U32 port)
 	}
 
 	// Remove orphan parent and children from lists now that they've been found
-	{
-		std::vector<U64>::iterator iter = std::find(mOrphanParents.begin(), mOrphanParents.end(), parent_info);
-		if (iter != mOrphanParents.end())
-		{
-			mOrphanParents.erase(iter);
-		}
-	}
-	
-	for (std::vector<OrphanInfo>::iterator iter = mOrphanChildren.begin(); iter != mOrphanChildren.end(); )
+	mOrphanParents.erase(parent_info);
+
+	//compact in one pass rather than erasing from the middle for each child
+	std::vector<OrphanInfo>::iterator dest = mOrphanChildren.begin();
+	for (std::vector<OrphanInfo>::iterator iter = mOrphanChildren.begin(); iter != mOrphanChildren.end(); ++iter)
 	{
 		if (iter->mParentInfo == parent_info)
 		{
-			iter = mOrphanChildren.erase(iter);
 			mNumOrphans--;
 		}
 		else
 		{
-			++iter;
+			*dest++ = *iter;
 		}
 	}
+	mOrphanChildren.erase(dest, mOrphanChildren.end());
 
 	if (orphans_found && objectp->isSelected())
 	{
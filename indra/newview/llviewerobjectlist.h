@@ -29,6 +29,8 @@
 
 #include <map>
 #include <set>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 // common includes
 #include "llstat.h"
@@ -163,6 +165,9 @@ public:
 
 	// Statistics data (see also LLViewerStats)
 	S32 mNumNewObjects;
+	S32 mNumCacheHits;		// ObjectUpdateCached probes found with a matching CRC
+	S32 mNumCacheMisses;
+	S32 mNumCacheDupes;		// full updates for objects already cached unchanged
 	S32 mNumSizeCulled;
 	S32 mNumVisCulled;
 
@@ -188,20 +193,23 @@ public:
 	S32 mNumUnknownKills;
 	S32 mNumDeadObjects;
 protected:
-	std::vector<U64>	mOrphanParents;	// LocalID/ip,port of orphaned objects
+	void removeFromActiveList(LLViewerObject* objectp);
+
+	boost::unordered_set<U64>	mOrphanParents;	// LocalID/ip,port of orphaned objects
 	std::vector<OrphanInfo> mOrphanChildren;	// UUID's of orphaned objects
 	S32 mNumOrphans;
 
 	typedef std::vector<LLPointer<LLViewerObject> > vobj_list_t;
 
 	vobj_list_t mObjects;
-	std::set<LLPointer<LLViewerObject> > mActiveObjects;
+	vobj_list_t mActiveObjects;	// unordered, each object knows its own index
 
 	vobj_list_t mMapObjects;
 
-	std::set<LLUUID> mDeadObjects;	
+	boost::unordered_set<LLUUID> mDeadObjects;	
 
-	std::map<LLUUID, LLPointer<LLViewerObject> > mUUIDObjectMap;
+	typedef boost::unordered_map<LLUUID, LLPointer<LLViewerObject> > uuid_object_map_t;
+	uuid_object_map_t mUUIDObjectMap;
 
 	//set of objects that need to update their cost
 	std::set<LLUUID> mStaleObjectCost;
@@ -216,9 +224,9 @@ protected:
 	S32 mCurLazyUpdateIndex;
 
 	static U32 sSimulatorMachineIndex;
-	static std::map<U64, U32> sIPAndPortToIndex;
+	static boost::unordered_map<U64, U32> sIPAndPortToIndex;
 
-	static std::map<U64, LLUUID> sIndexAndLocalIDToUUID;
+	static boost::unordered_map<U64, LLUUID> sIndexAndLocalIDToUUID;
 
 	std::set<LLViewerObject *> mSelectPickList;
 
@@ -257,7 +265,7 @@ extern LLViewerObjectList gObjectList;
  */
 inline LLViewerObject *LLViewerObjectList::findObject(const LLUUID &id)
 {
-	std::map<LLUUID, LLPointer<LLViewerObject> >::iterator iter = mUUIDObjectMap.find(id);
+	uuid_object_map_t::iterator iter = mUUIDObjectMap.find(id);
 	if(iter != mUUIDObjectMap.end())
 	{
 		return iter->second;
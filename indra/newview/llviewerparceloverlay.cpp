@@ -47,11 +47,14 @@
 #include "llselectmgr.h"
 #include "llfloatertools.h"
 #include "llglheaders.h"
+#include "llvertexbuffer.h"
 #include "pipeline.h"
 
 
 const U8  OVERLAY_IMG_COMPONENTS = 4;
 
+static const U32 PROPERTY_LINE_MASK = LLVertexBuffer::MAP_VERTEX | LLVertexBuffer::MAP_COLOR | LLVertexBuffer::MAP_TEXCOORD0;
+
 LLViewerParcelOverlay::LLViewerParcelOverlay(LLViewerRegion* region, F32 region_width_meters)
 :	mRegion( region ),
 	mParcelGridsPerEdge( S32( region_width_meters / PARCEL_GRID_STEP_METERS ) ),
@@ -59,9 +62,8 @@ LLViewerParcelOverlay::LLViewerParcelOverlay(LLViewerRegion* region, F32 region_
 	mTimeSinceLastUpdate(),
 	mOverlayTextureIdx(-1),
 	mVertexCount(0),
-	mVertexArray(NULL),
-	mColorArray(NULL)
-//	mTexCoordArray(NULL),
+	mLineDirtyMin(mParcelGridsPerEdge),
+	mLineDirtyMax(-1)
 {
 	// Create a texture to hold color information.
 	// 4 components
@@ -91,6 +93,12 @@ LLViewerParcelOverlay::LLViewerParcelOverlay(LLViewerRegion* region, F32 region_
 		mOwnership[i] = PARCEL_PUBLIC;
 	}
 
+	mLineRows.resize(mParcelGridsPerEdge);
+	for (S32 chunk = 0; chunk < PARCEL_OVERLAY_CHUNKS; chunk++)
+	{
+		mLineBufferDirty[chunk] = FALSE;
+	}
+
 	gPipeline.markGLRebuild(this);
 }
 
@@ -100,15 +108,10 @@ LLViewerParcelOverlay::~LLViewerParcelOverlay()
 	delete[] mOwnership;
 	mOwnership = NULL;
 
-	delete[] mVertexArray;
-	mVertexArray = NULL;
-
-	delete[] mColorArray;
-	mColorArray = NULL;
-
-// JC No textures.
-//	delete mTexCoordArray;
-//	mTexCoordArray = NULL;
+	for (S32 chunk = 0; chunk < PARCEL_OVERLAY_CHUNKS; chunk++)
+	{
+		mLineBuffers[chunk] = NULL;
+	}
 
 	mImageRaw = NULL;
 }
@@ -411,10 +414,25 @@ void LLViewerParcelOverlay::uncompressLandOverlay(S32 chunk, U8 *packed_overlay)
 	S32	size	= mParcelGridsPerEdge * mParcelGridsPerEdge;
 	S32 chunk_size = size / PARCEL_OVERLAY_CHUNKS;
 
+	// Only rows whose bits changed need new property lines.  A row also
+	// draws the north edges from the south lines of the row above it.
+	const S32 first_row = chunk_size * chunk / mParcelGridsPerEdge;
+	const S32 row_count = chunk_size / mParcelGridsPerEdge;
+	for (S32 r = 0; r < row_count; r++)
+	{
+		S32 row = first_row + r;
+		U8* dest = mOwnership + row * mParcelGridsPerEdge;
+		U8* src = packed_overlay + r * mParcelGridsPerEdge;
+		if (memcmp(dest, src, mParcelGridsPerEdge))
+		{
+			markLineRowsDirty(llmax(row - 1, 0), row);
+		}
+	}
+
 	memcpy(mOwnership + chunk*chunk_size, packed_overlay, chunk_size);		/*Flawfinder: ignore*/
 
-	// Force property lines and overlay texture to update
-	setDirty();
+	// Force overlay texture to update
+	mDirty = TRUE;
 }
 
 
@@ -423,242 +441,231 @@ void LLViewerParcelOverlay::updatePropertyLines()
 	if (!gSavedSettings.getBOOL("ShowPropertyLines"))
 		return;
 	
-	S32 row, col;
+	if (mLineDirtyMin > mLineDirtyMax)
+	{
+		// nothing changed since the last update
+		return;
+	}
+
+	// line color for each PARCEL_COLOR_MASK value, none for public land
+	LLColor4U colors[PARCEL_COLOR_MASK + 1];
+	colors[PARCEL_OWNED] = LLUIColorTable::instance().getColor("PropertyColorOther").get();
+	colors[PARCEL_GROUP] = LLUIColorTable::instance().getColor("PropertyColorGroup").get();
+	colors[PARCEL_SELF] = LLUIColorTable::instance().getColor("PropertyColorSelf").get();
+	colors[PARCEL_FOR_SALE] = LLUIColorTable::instance().getColor("PropertyColorForSale").get();
+	colors[PARCEL_AUCTION] = LLUIColorTable::instance().getColor("PropertyColorAuction").get();
+
+	const S32 GRIDS_PER_EDGE = mParcelGridsPerEdge;
+	const S32 ROWS_PER_CHUNK = GRIDS_PER_EDGE / PARCEL_OVERLAY_CHUNKS;
 
-	const LLColor4U self_coloru  = LLUIColorTable::instance().getColor("PropertyColorSelf").get();
-	const LLColor4U other_coloru = LLUIColorTable::instance().getColor("PropertyColorOther").get();
-	const LLColor4U group_coloru = LLUIColorTable::instance().getColor("PropertyColorGroup").get();
-	const LLColor4U for_sale_coloru = LLUIColorTable::instance().getColor("PropertyColorForSale").get();
-	const LLColor4U auction_coloru = LLUIColorTable::instance().getColor("PropertyColorAuction").get();
+	for (S32 row = mLineDirtyMin; row <= mLineDirtyMax; row++)
+	{
+		updatePropertyLineRow(row, colors);
+	}
+
+	for (S32 chunk = mLineDirtyMin / ROWS_PER_CHUNK; chunk <= mLineDirtyMax / ROWS_PER_CHUNK; chunk++)
+	{
+		mLineBufferDirty[chunk] = TRUE;
+	}
+
+	mLineDirtyMin = GRIDS_PER_EDGE;
+	mLineDirtyMax = -1;
+
+	mVertexCount = 0;
+	for (S32 row = 0; row < GRIDS_PER_EDGE; row++)
+	{
+		mVertexCount += mLineRows[row].mVertices.size();
+	}
+	
+	// Everything's clean now
+	mDirty = FALSE;
+}
 
-	// Build into dynamic arrays, then copy into static arrays.
-	LLDynamicArray<LLVector3, 256> new_vertex_array;
-	LLDynamicArray<LLColor4U, 256> new_color_array;
-	LLDynamicArray<LLVector2, 256> new_coord_array;
+void LLViewerParcelOverlay::updatePropertyLineRow(S32 row, const LLColor4U* colors)
+{
+	LineRow& line_row = mLineRows[row];
+	line_row.mVertices.clear();
+	line_row.mColors.clear();
+	line_row.mTexCoords.clear();
 
 	U8 overlay = 0;
 	BOOL add_edge = FALSE;
 	const F32 GRID_STEP = PARCEL_GRID_STEP_METERS;
 	const S32 GRIDS_PER_EDGE = mParcelGridsPerEdge;
 
-	for (row = 0; row < GRIDS_PER_EDGE; row++)
+	for (S32 col = 0; col < GRIDS_PER_EDGE; col++)
 	{
-		for (col = 0; col < GRIDS_PER_EDGE; col++)
+		overlay = mOwnership[row*GRIDS_PER_EDGE+col];
+
+		U8 owner = overlay & PARCEL_COLOR_MASK;
+		if (owner < PARCEL_OWNED || owner > PARCEL_AUCTION)
 		{
-			overlay = mOwnership[row*GRIDS_PER_EDGE+col];
+			// no lines around public land
+			continue;
+		}
+		const LLColor4U& color = colors[owner];
 
-			F32 left = col*GRID_STEP;
-			F32 right = left+GRID_STEP;
+		F32 left = col*GRID_STEP;
+		F32 right = left+GRID_STEP;
 
-			F32 bottom = row*GRID_STEP;
-			F32 top = bottom+GRID_STEP;
+		F32 bottom = row*GRID_STEP;
+		F32 top = bottom+GRID_STEP;
 
-			// West edge
-			if (overlay & PARCEL_WEST_LINE)
-			{
-				switch(overlay & PARCEL_COLOR_MASK)
-				{
-				case PARCEL_SELF:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, WEST, self_coloru);
-					break;
-				case PARCEL_GROUP:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, WEST, group_coloru);
-					break;
-				case PARCEL_OWNED:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, WEST, other_coloru);
-					break;
-				case PARCEL_FOR_SALE:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, WEST, for_sale_coloru);
-					break;
-				case PARCEL_AUCTION:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, WEST, auction_coloru);
-					break;
-				default:
-					break;
-				}
-			}
-
-			// East edge
-			if (col < GRIDS_PER_EDGE-1)
-			{
-				U8 east_overlay = mOwnership[row*GRIDS_PER_EDGE+col+1];
-				add_edge = east_overlay & PARCEL_WEST_LINE;
-			}
-			else
-			{
-				add_edge = TRUE;
-			}
+		// West edge
+		if (overlay & PARCEL_WEST_LINE)
+		{
+			addPropertyLine(line_row, left, bottom, WEST, color);
+		}
 
-			if (add_edge)
-			{
-				switch(overlay & PARCEL_COLOR_MASK)
-				{
-				case PARCEL_SELF:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						right, bottom, EAST, self_coloru);
-					break;
-				case PARCEL_GROUP:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						right, bottom, EAST, group_coloru);
-					break;
-				case PARCEL_OWNED:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						right, bottom, EAST, other_coloru);
-					break;
-				case PARCEL_FOR_SALE:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						right, bottom, EAST, for_sale_coloru);
-					break;
-				case PARCEL_AUCTION:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						right, bottom, EAST, auction_coloru);
-					break;
-				default:
-					break;
-				}
-			}
+		// East edge
+		if (col < GRIDS_PER_EDGE-1)
+		{
+			U8 east_overlay = mOwnership[row*GRIDS_PER_EDGE+col+1];
+			add_edge = east_overlay & PARCEL_WEST_LINE;
+		}
+		else
+		{
+			add_edge = TRUE;
+		}
 
-			// South edge
-			if (overlay & PARCEL_SOUTH_LINE)
-			{
-				switch(overlay & PARCEL_COLOR_MASK)
-				{
-				case PARCEL_SELF:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, SOUTH, self_coloru);
-					break;
-				case PARCEL_GROUP:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, SOUTH, group_coloru);
-					break;
-				case PARCEL_OWNED:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, SOUTH, other_coloru);
-					break;
-				case PARCEL_FOR_SALE:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, SOUTH, for_sale_coloru);
-					break;
-				case PARCEL_AUCTION:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, bottom, SOUTH, auction_coloru);
-					break;
-				default:
-					break;
-				}
-			}
+		if (add_edge)
+		{
+			addPropertyLine(line_row, right, bottom, EAST, color);
+		}
 
+		// South edge
+		if (overlay & PARCEL_SOUTH_LINE)
+		{
+			addPropertyLine(line_row, left, bottom, SOUTH, color);
+		}
 
-			// North edge
-			if (row < GRIDS_PER_EDGE-1)
-			{
-				U8 north_overlay = mOwnership[(row+1)*GRIDS_PER_EDGE+col];
-				add_edge = north_overlay & PARCEL_SOUTH_LINE;
-			}
-			else
-			{
-				add_edge = TRUE;
-			}
+		// North edge
+		if (row < GRIDS_PER_EDGE-1)
+		{
+			U8 north_overlay = mOwnership[(row+1)*GRIDS_PER_EDGE+col];
+			add_edge = north_overlay & PARCEL_SOUTH_LINE;
+		}
+		else
+		{
+			add_edge = TRUE;
+		}
 
-			if (add_edge)
-			{
-				switch(overlay & PARCEL_COLOR_MASK)
-				{
-				case PARCEL_SELF:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, top, NORTH, self_coloru);
-					break;
-				case PARCEL_GROUP:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, top, NORTH, group_coloru);
-					break;
-				case PARCEL_OWNED:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, top, NORTH, other_coloru);
-					break;
-				case PARCEL_FOR_SALE:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, top, NORTH, for_sale_coloru);
-					break;
-				case PARCEL_AUCTION:
-					addPropertyLine(new_vertex_array, new_color_array, new_coord_array,
-						left, top, NORTH, auction_coloru);
-					break;
-				default:
-					break;
-				}
-			}
+		if (add_edge)
+		{
+			addPropertyLine(line_row, left, top, NORTH, color);
 		}
 	}
 
-	// Now copy into static arrays for faster rendering.
-	// Attempt to recycle old arrays if possible to avoid memory
-	// shuffling.
-	S32 new_vertex_count = new_vertex_array.count();
-	
-	if (!(mVertexArray && mColorArray && new_vertex_count == mVertexCount))
+	line_row.mMinZ = F32_MAX;
+	line_row.mMaxZ = -F32_MAX;
+	for (U32 i = 0; i < line_row.mVertices.size(); i++)
+	{
+		line_row.mMinZ = llmin(line_row.mMinZ, line_row.mVertices[i].mV[VZ]);
+		line_row.mMaxZ = llmax(line_row.mMaxZ, line_row.mVertices[i].mV[VZ]);
+	}
+}
+
+// Copies the lines of one chunk of rows into its vertex buffer, with each
+// edge's strip turned into triangles so neighbouring rows draw in one call.
+void LLViewerParcelOverlay::updatePropertyLineBuffer(S32 chunk)
+{
+	const S32 ROWS_PER_CHUNK = mParcelGridsPerEdge / PARCEL_OVERLAY_CHUNKS;
+	const S32 first_row = chunk * ROWS_PER_CHUNK;
+	const S32 vertex_per_edge = getVertexPerEdge();
+
+	mLineBufferDirty[chunk] = FALSE;
+	mLineBuffers[chunk] = NULL;
+
+	S32 vertex_count = 0;
+	for (S32 row = first_row; row < first_row + ROWS_PER_CHUNK; row++)
+	{
+		vertex_count += mLineRows[row].mVertices.size();
+	}
+
+	if (vertex_count == 0)
+	{
+		return;
+	}
+
+	S32 index_count = (vertex_count / vertex_per_edge) * (vertex_per_edge - 2) * 3;
+
+	LLPointer<LLVertexBuffer> buff = new LLVertexBuffer(PROPERTY_LINE_MASK, GL_STATIC_DRAW_ARB);
+	buff->allocateBuffer(vertex_count, index_count, true);
+
+	LLStrider<LLVector3> verts;
+	LLStrider<LLColor4U> colors;
+	LLStrider<LLVector2> tex_coords;
+	LLStrider<U16> indices;
+	if (!buff->getVertexStrider(verts) || !buff->getColorStrider(colors) ||
+		!buff->getTexCoord0Strider(tex_coords) || !buff->getIndexStrider(indices))
 	{
-		// ...need new arrays
-		delete[] mVertexArray;
-		mVertexArray = NULL;
-		delete[] mColorArray;
-		mColorArray = NULL;
+		return;
+	}
 
-		mVertexCount = new_vertex_count;
+	S32 vertex_offset = 0;
+	S32 index_offset = 0;
+	for (S32 row = first_row; row < first_row + ROWS_PER_CHUNK; row++)
+	{
+		LineRow& line_row = mLineRows[row];
+		line_row.mBufferVertexStart = vertex_offset;
+		line_row.mBufferIndexStart = index_offset;
+
+		for (U32 i = 0; i < line_row.mVertices.size(); i++)
+		{
+			*verts++ = line_row.mVertices[i];
+			*colors++ = line_row.mColors[i];
+			*tex_coords++ = line_row.mTexCoords[i];
+		}
 
-		if (new_vertex_count > 0)
+		for (U32 strip = 0; strip < line_row.mVertices.size(); strip += vertex_per_edge)
 		{
-			mVertexArray   = new F32[3 * mVertexCount];
-			mColorArray    = new U8 [4 * mVertexCount];
+			U16 base = (U16) (vertex_offset + strip);
+			for (S32 k = 0; k < vertex_per_edge - 2; k++)
+			{
+				// keep the strip's winding
+				*indices++ = base + k + (k & 1);
+				*indices++ = base + k + 1 - (k & 1);
+				*indices++ = base + k + 2;
+			}
+			index_offset += (vertex_per_edge - 2) * 3;
 		}
+
+		vertex_offset += line_row.mVertices.size();
 	}
 
-	// Copy the new data into the arrays
-	S32 i;
-	F32* vertex = mVertexArray;
-	for (i = 0; i < mVertexCount; i++)
-	{
-		const LLVector3& point = new_vertex_array.get(i);
-		*vertex = point.mV[VX];
-		vertex++;
-		*vertex = point.mV[VY];
-		vertex++;
-		*vertex = point.mV[VZ];
-		vertex++;
-	}
-
-	U8* colorp = mColorArray;
-	for (i = 0; i < mVertexCount; i++)
-	{
-		const LLColor4U& color = new_color_array.get(i);
-		*colorp = color.mV[VRED];
-		colorp++;
-		*colorp = color.mV[VGREEN];
-		colorp++;
-		*colorp = color.mV[VBLUE];
-		colorp++;
-		*colorp = color.mV[VALPHA];
-		colorp++;
+	buff->flush();
+	mLineBuffers[chunk] = buff;
+}
+
+void LLViewerParcelOverlay::resetVertexBuffers()
+{
+	for (S32 chunk = 0; chunk < PARCEL_OVERLAY_CHUNKS; chunk++)
+	{
+		mLineBuffers[chunk] = NULL;
+		mLineBufferDirty[chunk] = TRUE;
 	}
-	
-	// Everything's clean now
-	mDirty = FALSE;
+}
+
+//static
+S32 LLViewerParcelOverlay::getVertexPerEdge()
+{
+	// Include +1 because vertices are fenceposts.
+	// *2 because it's a quad strip
+	const S32 GRID_STEP = S32( PARCEL_GRID_STEP_METERS );
+	return 3 + 2 * (GRID_STEP-1) + 3;
 }
 
 
 void LLViewerParcelOverlay::addPropertyLine(
-				LLDynamicArray<LLVector3, 256>& vertex_array,
-				LLDynamicArray<LLColor4U, 256>& color_array,
-				LLDynamicArray<LLVector2, 256>& coord_array,
+				LineRow& line_row,
 				const F32 start_x, const F32 start_y, 
 				const U32 edge,
 				const LLColor4U& color)
 {
+	std::vector<LLVector3>& vertex_array = line_row.mVertices;
+	std::vector<LLColor4U>& color_array = line_row.mColors;
+	std::vector<LLVector2>& coord_array = line_row.mTexCoords;
+
 	LLColor4U underwater( color );
 	underwater.mV[VALPHA] /= 2;
 
@@ -716,11 +723,11 @@ void LLViewerParcelOverlay::addPropertyLine(
 	// First part, only one vertex
 	outside_z = land.resolveHeightRegion( outside_x, outside_y );
 
-	if (outside_z > 20.f) color_array.put( color );
-	else color_array.put( underwater );
+	if (outside_z > 20.f) color_array.push_back( color );
+	else color_array.push_back( underwater );
 
-	vertex_array.put( LLVector3(outside_x, outside_y, outside_z) );
-	coord_array.put(  LLVector2(outside_x - start_x, 0.f) );
+	vertex_array.push_back( LLVector3(outside_x, outside_y, outside_z) );
+	coord_array.push_back(  LLVector2(outside_x - start_x, 0.f) );
 
 	inside_x += dx * LINE_WIDTH;
 	inside_y += dy * LINE_WIDTH;
@@ -732,17 +739,17 @@ void LLViewerParcelOverlay::addPropertyLine(
 	inside_z = land.resolveHeightRegion( inside_x, inside_y );
 	outside_z = land.resolveHeightRegion( outside_x, outside_y );
 
-	if (inside_z > 20.f) color_array.put( color );
-	else color_array.put( underwater );
+	if (inside_z > 20.f) color_array.push_back( color );
+	else color_array.push_back( underwater );
 
-	if (outside_z > 20.f) color_array.put( color );
-	else color_array.put( underwater );
+	if (outside_z > 20.f) color_array.push_back( color );
+	else color_array.push_back( underwater );
 
-	vertex_array.put( LLVector3(inside_x, inside_y, inside_z) );
-	vertex_array.put( LLVector3(outside_x, outside_y, outside_z) );
+	vertex_array.push_back( LLVector3(inside_x, inside_y, inside_z) );
+	vertex_array.push_back( LLVector3(outside_x, outside_y, outside_z) );
 
-	coord_array.put(  LLVector2(outside_x - start_x, 1.f) );
-	coord_array.put(  LLVector2(outside_x - start_x, 0.f) );
+	coord_array.push_back(  LLVector2(outside_x - start_x, 1.f) );
+	coord_array.push_back(  LLVector2(outside_x - start_x, 0.f) );
 
 	inside_x += dx * (dx - LINE_WIDTH);
 	inside_y += dy * (dy - LINE_WIDTH);
@@ -758,17 +765,17 @@ void LLViewerParcelOverlay::addPropertyLine(
 		inside_z = land.resolveHeightRegion( inside_x, inside_y );
 		outside_z = land.resolveHeightRegion( outside_x, outside_y );
 
-		if (inside_z > 20.f) color_array.put( color );
-		else color_array.put( underwater );
+		if (inside_z > 20.f) color_array.push_back( color );
+		else color_array.push_back( underwater );
 
-		if (outside_z > 20.f) color_array.put( color );
-		else color_array.put( underwater );
+		if (outside_z > 20.f) color_array.push_back( color );
+		else color_array.push_back( underwater );
 
-		vertex_array.put( LLVector3(inside_x, inside_y, inside_z) );
-		vertex_array.put( LLVector3(outside_x, outside_y, outside_z) );
+		vertex_array.push_back( LLVector3(inside_x, inside_y, inside_z) );
+		vertex_array.push_back( LLVector3(outside_x, outside_y, outside_z) );
 
-		coord_array.put(  LLVector2(outside_x - start_x, 1.f) );
-		coord_array.put(  LLVector2(outside_x - start_x, 0.f) );
+		coord_array.push_back(  LLVector2(outside_x - start_x, 1.f) );
+		coord_array.push_back(  LLVector2(outside_x - start_x, 0.f) );
 
 		inside_x += dx;
 		inside_y += dy;
@@ -787,17 +794,17 @@ void LLViewerParcelOverlay::addPropertyLine(
 	inside_z = land.resolveHeightRegion( inside_x, inside_y );
 	outside_z = land.resolveHeightRegion( outside_x, outside_y );
 
-	if (inside_z > 20.f) color_array.put( color );
-	else color_array.put( underwater );
+	if (inside_z > 20.f) color_array.push_back( color );
+	else color_array.push_back( underwater );
 
-	if (outside_z > 20.f) color_array.put( color );
-	else color_array.put( underwater );
+	if (outside_z > 20.f) color_array.push_back( color );
+	else color_array.push_back( underwater );
 
-	vertex_array.put( LLVector3(inside_x, inside_y, inside_z) );
-	vertex_array.put( LLVector3(outside_x, outside_y, outside_z) );
+	vertex_array.push_back( LLVector3(inside_x, inside_y, inside_z) );
+	vertex_array.push_back( LLVector3(outside_x, outside_y, outside_z) );
 
-	coord_array.put(  LLVector2(outside_x - start_x, 1.f) );
-	coord_array.put(  LLVector2(outside_x - start_x, 0.f) );
+	coord_array.push_back(  LLVector2(outside_x - start_x, 1.f) );
+	coord_array.push_back(  LLVector2(outside_x - start_x, 0.f) );
 
 	inside_x += dx * LINE_WIDTH;
 	inside_y += dy * LINE_WIDTH;
@@ -808,17 +815,24 @@ void LLViewerParcelOverlay::addPropertyLine(
 	// Last edge is not drawn to the edge
 	outside_z = land.resolveHeightRegion( outside_x, outside_y );
 
-	if (outside_z > 20.f) color_array.put( color );
-	else color_array.put( underwater );
+	if (outside_z > 20.f) color_array.push_back( color );
+	else color_array.push_back( underwater );
 
-	vertex_array.put( LLVector3(outside_x, outside_y, outside_z) );
-	coord_array.put(  LLVector2(outside_x - start_x, 0.f) );
+	vertex_array.push_back( LLVector3(outside_x, outside_y, outside_z) );
+	coord_array.push_back(  LLVector2(outside_x - start_x, 0.f) );
 }
 
 
 void LLViewerParcelOverlay::setDirty()
 {
 	mDirty = TRUE;
+	markLineRowsDirty(0, mParcelGridsPerEdge - 1);
+}
+
+void LLViewerParcelOverlay::markLineRowsDirty(S32 first_row, S32 last_row)
+{
+	mLineDirtyMin = llmin(mLineDirtyMin, first_row);
+	mLineDirtyMax = llmax(mLineDirtyMax, last_row);
 }
 
 void LLViewerParcelOverlay::updateGL()
@@ -857,11 +871,20 @@ S32 LLViewerParcelOverlay::renderPropertyLines	()
 	{
 		return 0;
 	}
-	if (!mVertexArray || !mColorArray)
+	if (!mVertexCount)
 	{
 		return 0;
 	}
 
+	const S32 ROWS_PER_CHUNK = mParcelGridsPerEdge / PARCEL_OVERLAY_CHUNKS;
+	for (S32 chunk = 0; chunk < PARCEL_OVERLAY_CHUNKS; chunk++)
+	{
+		if (mLineBufferDirty[chunk])
+		{
+			updatePropertyLineBuffer(chunk);
+		}
+	}
+
 	LLSurface& land = mRegion->getLand();
 
 	LLGLSUIDefault gls_ui; // called from pipeline
@@ -894,10 +917,7 @@ S32 LLViewerParcelOverlay::renderPropertyLines	()
 	gGL.translatef(pull_toward_camera.mV[VX], pull_toward_camera.mV[VY],
 		pull_toward_camera.mV[VZ]);
 
-	// Include +1 because vertices are fenceposts.
-	// *2 because it's a quad strip
-	const S32 GRID_STEP = S32( PARCEL_GRID_STEP_METERS );
-	const S32 vertex_per_edge = 3 + 2 * (GRID_STEP-1) + 3;
+	const S32 vertex_per_edge = getVertexPerEdge();
 
 	// Stomp the camera into two dimensions
 	LLVector3 camera_region = mRegion->getPosRegionFromGlobal( gAgentCamera.getCameraPositionGlobal() );
@@ -908,86 +928,124 @@ S32 LLViewerParcelOverlay::renderPropertyLines	()
 	cull_plane_point *= -2.f * PARCEL_GRID_STEP_METERS;
 	cull_plane_point += camera_region;
 
-	LLVector3 vertex;
-
-	const S32 BYTES_PER_COLOR = 4;
-	const S32 FLOATS_PER_VERTEX = 3;
-	//const S32 FLOATS_PER_TEX_COORD = 2;
-	S32 i, j;
 	S32 drawn = 0;
-	F32* vertexp;
-	U8* colorp;
 	bool render_hidden = LLSelectMgr::sRenderHiddenSelections && LLFloaterReg::instanceVisible("build");
 
 	const F32 PROPERTY_LINE_CLIP_DIST_SQUARED = 256.f * 256.f;
+	const F32 region_width = mParcelGridsPerEdge * PARCEL_GRID_STEP_METERS;
 
-	for (i = 0; i < mVertexCount; i += vertex_per_edge)
+	// Rows are culled as a whole, then runs of neighbouring visible rows
+	// go to the card in one draw per chunk.
+	std::vector<bool> row_visible(mParcelGridsPerEdge, false);
+	for (S32 row = 0; row < mParcelGridsPerEdge; row++)
 	{
-		colorp  = mColorArray  + BYTES_PER_COLOR   * i;
-		vertexp = mVertexArray + FLOATS_PER_VERTEX * i;
+		const LineRow& line_row = mLineRows[row];
+		if (line_row.mVertices.empty())
+		{
+			continue;
+		}
 
-		vertex.mV[VX] = *(vertexp);
-		vertex.mV[VY] = *(vertexp+1);
-		vertex.mV[VZ] = *(vertexp+2);
+		F32 bottom = row * PARCEL_GRID_STEP_METERS;
+		F32 top = bottom + PARCEL_GRID_STEP_METERS;
 
-		if (dist_vec_squared2D(vertex, camera_region) > PROPERTY_LINE_CLIP_DIST_SQUARED)
+		// 2D distance from the camera to the nearest point of the row
+		LLVector3 nearest(llclamp(camera_region.mV[VX], 0.f, region_width),
+						  llclamp(camera_region.mV[VY], bottom, top),
+						  0.f);
+		if (dist_vec_squared2D(nearest, camera_region) > PROPERTY_LINE_CLIP_DIST_SQUARED)
 		{
 			continue;
 		}
 
-		// Destroy vertex, transform to plane-local.
-		vertex -= cull_plane_point;
+		// corner of the row's box furthest along the cull plane normal
+		LLVector3 corner(CAMERA_AT.mV[VX] > 0.f ? region_width : 0.f,
+						 CAMERA_AT.mV[VY] > 0.f ? top : bottom,
+						 CAMERA_AT.mV[VZ] > 0.f ? line_row.mMaxZ : line_row.mMinZ);
+		corner -= cull_plane_point;
 
-		// negative dot product means it is in back of the plane
-		if ( vertex * CAMERA_AT < 0.f )
+		// negative dot product means the whole row is in back of the plane
+		if ( corner * CAMERA_AT < 0.f )
 		{
 			continue;
 		}
 
-		gGL.begin(LLRender::TRIANGLE_STRIP);
+		row_visible[row] = true;
+	}
 
-		for (j = 0; j < vertex_per_edge; j++)
+	for (S32 chunk = 0; chunk < PARCEL_OVERLAY_CHUNKS; chunk++)
+	{
+		LLVertexBuffer* buff = mLineBuffers[chunk];
+		if (!buff)
 		{
-			gGL.color4ubv(colorp);
-			gGL.vertex3fv(vertexp);
-
-			colorp  += BYTES_PER_COLOR;
-			vertexp += FLOATS_PER_VERTEX;			
+			continue;
 		}
 
-		drawn += vertex_per_edge;
-
-		gGL.end();
-		
-		if (render_hidden)
+		bool bound = false;
+		const S32 first_row = chunk * ROWS_PER_CHUNK;
+		const S32 end_row = first_row + ROWS_PER_CHUNK;
+		S32 row = first_row;
+		while (row < end_row)
 		{
-			LLGLDepthTest depth(GL_TRUE, GL_FALSE, GL_GREATER);
-			
-			colorp  = mColorArray  + BYTES_PER_COLOR   * i;
-			vertexp = mVertexArray + FLOATS_PER_VERTEX * i;
+			if (!row_visible[row])
+			{
+				row++;
+				continue;
+			}
 
-			gGL.begin(LLRender::TRIANGLE_STRIP);
+			S32 run_end = row;
+			S32 vertex_count = 0;
+			while (run_end < end_row && row_visible[run_end])
+			{
+				vertex_count += mLineRows[run_end].mVertices.size();
+				run_end++;
+			}
 
-			for (j = 0; j < vertex_per_edge; j++)
+			if (!bound)
 			{
-				U8 color[4];
-				color[0] = colorp[0];
-				color[1] = colorp[1];
-				color[2] = colorp[2];
-				color[3] = colorp[3]/4;
+				buff->setBuffer(PROPERTY_LINE_MASK);
+				bound = true;
+			}
 
-				gGL.color4ubv(color);
-				gGL.vertex3fv(vertexp);
+			const LineRow& first = mLineRows[row];
+			S32 index_count = (vertex_count / vertex_per_edge) * (vertex_per_edge - 2) * 3;
+			buff->drawRange(LLRender::TRIANGLES, first.mBufferVertexStart,
+							first.mBufferVertexStart + vertex_count - 1,
+							index_count, first.mBufferIndexStart);
+			drawn += vertex_count;
+
+			row = run_end;
+		}
+	}
+
+	if (render_hidden)
+	{
+		// faint copy of the lines where they are behind something
+		LLGLDepthTest depth(GL_TRUE, GL_FALSE, GL_GREATER);
 
-				colorp  += BYTES_PER_COLOR;
-				vertexp += FLOATS_PER_VERTEX;			
+		for (S32 row = 0; row < mParcelGridsPerEdge; row++)
+		{
+			if (!row_visible[row])
+			{
+				continue;
 			}
 
-			drawn += vertex_per_edge;
+			const LineRow& line_row = mLineRows[row];
+			for (U32 i = 0; i < line_row.mVertices.size(); i += vertex_per_edge)
+			{
+				gGL.begin(LLRender::TRIANGLE_STRIP);
 
-			gGL.end();
+				for (S32 j = 0; j < vertex_per_edge; j++)
+				{
+					const LLColor4U& color = line_row.mColors[i + j];
+					gGL.color4ub(color.mV[VRED], color.mV[VGREEN], color.mV[VBLUE], color.mV[VALPHA]/4);
+					gGL.vertex3fv(line_row.mVertices[i + j].mV);
+				}
+
+				drawn += vertex_per_edge;
+
+				gGL.end();
+			}
 		}
-		
 	}
 
 	gGL.popMatrix();
@@ -31,16 +31,18 @@
 // One of these structures per region.
 
 #include "llbbox.h"
-#include "lldarray.h"
 #include "llframetimer.h"
 #include "lluuid.h"
 #include "llviewertexture.h"
 #include "llgl.h"
+#include "v3math.h"
+#include "v2math.h"
+#include "v4coloru.h"
+#include "llparcel.h"
+#include <vector>
 
 class LLViewerRegion;
-class LLVector3;
-class LLColor4U;
-class LLVector2;
+class LLVertexBuffer;
 
 class LLViewerParcelOverlay : public LLGLUpdate
 {
@@ -79,6 +81,9 @@ public:
 	// Indicate property lines and overlay texture need to be rebuilt.
 	void	setDirty();
 
+	// Drop the property line vertex buffers, they are rebuilt on the next render.
+	void	resetVertexBuffers();
+
 	void	idleUpdate(bool update_now = false);
 	void	updateGL();
 
@@ -88,15 +93,33 @@ private:
 	U8		ownership(S32 row, S32 col) const	
 				{ return 0x7 & mOwnership[row * mParcelGridsPerEdge + col]; }
 
-	void	addPropertyLine(LLDynamicArray<LLVector3, 256>& vertex_array,
-				LLDynamicArray<LLColor4U, 256>& color_array,
-				LLDynamicArray<LLVector2, 256>& coord_array,
+	// Property line strips for one row of parcel grid squares
+	struct LineRow
+	{
+		LineRow() : mMinZ(0.f), mMaxZ(0.f), mBufferVertexStart(0), mBufferIndexStart(0) {}
+
+		std::vector<LLVector3>	mVertices;
+		std::vector<LLColor4U>	mColors;
+		std::vector<LLVector2>	mTexCoords;
+		F32		mMinZ;
+		F32		mMaxZ;
+		// where this row lives in its chunk's vertex buffer
+		S32		mBufferVertexStart;
+		S32		mBufferIndexStart;
+	};
+
+	void	addPropertyLine(LineRow& line_row,
 				const F32 start_x, const F32 start_y, 
 				const U32 edge, 
 				const LLColor4U& color);
 
 	void 	updateOverlayTexture();
 	void	updatePropertyLines();
+	void	updatePropertyLineRow(S32 row, const LLColor4U* colors);
+	void	updatePropertyLineBuffer(S32 chunk);
+	void	markLineRowsDirty(S32 first_row, S32 last_row);
+
+	static S32	getVertexPerEdge();
 	
 private:
 	// Back pointer to the region that owns this structure.
@@ -118,8 +141,16 @@ private:
 	S32				mOverlayTextureIdx;
 	
 	S32				mVertexCount;
-	F32*			mVertexArray;
-	U8*				mColorArray;
+
+	// Property lines are rebuilt only for the rows between these two
+	std::vector<LineRow>	mLineRows;
+	S32				mLineDirtyMin;
+	S32				mLineDirtyMax;
+
+	// One buffer per overlay chunk, so an update touches at most the
+	// chunks whose rows changed.
+	LLPointer<LLVertexBuffer>	mLineBuffers[PARCEL_OVERLAY_CHUNKS];
+	BOOL			mLineBufferDirty[PARCEL_OVERLAY_CHUNKS];
 };
 
 #endif
@@ -64,6 +64,7 @@ const F32 LLViewerPartSim::PART_ADAPT_RATE_MULT_RECIP = 1.0f/PART_ADAPT_RATE_MUL
 
 
 U32 LLViewerPart::sNextPartID = 1;
+void* LLViewerPart::sFreeList = NULL;
 
 F32 calc_desired_size(LLViewerCamera* camera, LLVector3 pos, LLVector2 scale)
 {
@@ -93,6 +94,45 @@ LLViewerPart::~LLViewerPart()
 	--LLViewerPartSim::sParticleCount2 ;
 }
 
+//static
+void* LLViewerPart::operator new(size_t size)
+{
+	if (size != sizeof(LLViewerPart))
+	{
+		return ::operator new(size);
+	}
+
+	if (!sFreeList)
+	{
+		//blocks are never handed back, the pool only grows to the peak particle count
+		char* block = (char*) ::operator new(sizeof(LLViewerPart) * POOL_BLOCK_COUNT);
+		for (S32 i = POOL_BLOCK_COUNT - 1; i >= 0; --i)
+		{
+			void* slot = block + i * sizeof(LLViewerPart);
+			*(void**) slot = sFreeList;
+			sFreeList = slot;
+		}
+	}
+
+	void* ptr = sFreeList;
+	sFreeList = *(void**) ptr;
+	return ptr;
+}
+
+//static
+void LLViewerPart::operator delete(void* ptr, size_t size)
+{
+	if (size != sizeof(LLViewerPart))
+	{
+		::operator delete(ptr);
+	}
+	else if (ptr)
+	{
+		*(void**) ptr = sFreeList;
+		sFreeList = ptr;
+	}
+}
+
 void LLViewerPart::init(LLPointer<LLViewerPartSource> sourcep, LLViewerTexture *imagep, LLVPCallback cb)
 {
 	LLMemType mt(LLMemType::MTYPE_PARTICLES);
@@ -332,9 +372,9 @@ void LLViewerPartGroup::updateParticles(const F32 lastdt)
 		else
 		{
 			// Do velocity interpolation
-			part->mPosAgent += dt*part->mVelocity;
-			part->mPosAgent += 0.5f*dt*dt*part->mAccel;
-			part->mVelocity += part->mAccel*dt;
+			LLVector3 dv = part->mAccel*dt;
+			part->mPosAgent += dt*(part->mVelocity + 0.5f*dv);
+			part->mVelocity += dv;
 		}
 
 		// Do a bounce test
@@ -56,6 +56,11 @@ public:
 
 	void init(LLPointer<LLViewerPartSource> sourcep, LLViewerTexture *imagep, LLVPCallback cb);
 
+	// Particles are created and killed by the thousand every second, so they
+	// come out of a free list that is refilled a block at a time.
+	void* operator new(size_t size);
+	void operator delete(void* ptr, size_t size);
+
 
 	U32					mPartID;					// Particle ID used primarily for moving between groups
 	F32					mLastUpdateTime;			// Last time the particle was updated
@@ -74,6 +79,10 @@ public:
 	LLVector2		mScale;
 
 	static U32		sNextPartID;
+
+private:
+	enum { POOL_BLOCK_COUNT = 256 };
+	static void*	sFreeList;
 };
 
 
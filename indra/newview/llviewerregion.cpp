@@ -34,6 +34,7 @@
 #include "llfloaterreg.h"
 #include "llmath.h"
 #include "llhttpclient.h"
+#include "llhttpstatuscodes.h"
 #include "llregionflags.h"
 #include "llregionhandle.h"
 #include "llsurface.h"
@@ -48,6 +49,8 @@
 #include "llcaphttpsender.h"
 #include "llcapabilitylistener.h"
 #include "llcommandhandler.h"
+#include "llcorohttp.h"
+#include "llcoros.h"
 #include "lldir.h"
 #include "lleventpoll.h"
 #include "llfloatergodtools.h"
@@ -111,7 +114,10 @@ public:
 	{
 	}
 
-	void buildCapabilityNames(LLSD& capabilityNames);
+	static void buildCapabilityNames(LLSD& capabilityNames);
+
+	// Every region asks its seed for the same list, build it once.
+	static const LLSD& getCapabilityNames();
 
 	// The surfaces and other layers
 	LLSurface*	mLandp;
@@ -199,40 +205,41 @@ public:
 };
 LLRegionHandler gRegionHandler;
 
-class BaseCapabilitiesComplete : public LLHTTPClient::Responder
+// Asks the seed capability for the region's capabilities, retrying until
+// it answers or we run out of attempts.  Runs as a coroutine: arguments by
+// value only.
+static void request_base_capabilities_coro(LLCoros::self& self, U64 region_handle, S32 id,
+										   std::string url, LLSD capability_names)
 {
-	LOG_CLASS(BaseCapabilitiesComplete);
-public:
-    BaseCapabilitiesComplete(U64 region_handle, S32 id)
-		: mRegionHandle(region_handle), mID(id)
-    { }
-	virtual ~BaseCapabilitiesComplete()
-	{ }
-
-    void error(U32 statusNum, const std::string& reason)
-    {
-		LL_WARNS2("AppInit", "Capabilities") << statusNum << ": " << reason << LL_ENDL;
-		LLViewerRegion *regionp = LLWorld::getInstance()->getRegionFromHandle(mRegionHandle);
-		if (regionp)
-		{
-			regionp->failedSeedCapability();
-		}
-    }
+	while (true)
+	{
+		U32 status = 0;
+		std::string reason;
+		LLSD content = httpPostAndWait(self, url, capability_names, CAP_REQUEST_TIMEOUT, &status, &reason);
 
-    void result(const LLSD& content)
-    {
-		LLViewerRegion *regionp = LLWorld::getInstance()->getRegionFromHandle(mRegionHandle);
+		LLViewerRegion *regionp = LLWorld::getInstance()->getRegionFromHandle(region_handle);
 		if(!regionp) //region was removed
 		{
 			LL_WARNS2("AppInit", "Capabilities") << "Received results for region that no longer exists!" << LL_ENDL;
 			return ;
 		}
-		if( mID != regionp->getHttpResponderID() ) // region is no longer referring to this responder
+		if( id != regionp->getHttpResponderID() ) // region is no longer waiting on this request
 		{
-			LL_WARNS2("AppInit", "Capabilities") << "Received results for a stale http responder!" << LL_ENDL;
+			LL_WARNS2("AppInit", "Capabilities") << "Received results for a stale seed request!" << LL_ENDL;
 			return ;
 		}
 
+		if (status != (U32)HTTP_OK)
+		{
+			LL_WARNS2("AppInit", "Capabilities") << status << ": " << reason << LL_ENDL;
+			if (!regionp->failedSeedCapability())
+			{
+				return;
+			}
+			url = regionp->getCapability("Seed");
+			continue;
+		}
+
 		LLSD::map_const_iterator iter;
 		for(iter = content.beginMap(); iter != content.endMap(); ++iter)
 		{
@@ -253,18 +260,9 @@ public:
 		{
 			LLStartUp::setStartupState( STATE_SEED_CAP_GRANTED );
 		}
+		return;
 	}
-
-    static boost::intrusive_ptr<BaseCapabilitiesComplete> build( U64 region_handle, S32 id )
-    {
-		return boost::intrusive_ptr<BaseCapabilitiesComplete>( 
-				new BaseCapabilitiesComplete(region_handle, id) );
-    }
-
-private:
-	U64 mRegionHandle;
-	S32 mID;
-};
+}
 
 
 LLViewerRegion::LLViewerRegion(const U64 &handle,
@@ -1246,9 +1244,34 @@ void LLViewerRegion::addCacheMissFull(const U32 local_id)
 
 void LLViewerRegion::requestCacheMisses()
 {
+	const S32 MAX_BLOCKS = 255;
+	const F32 CACHE_MISS_BATCH_TIME = 0.1f;
+
 	S32 full_count = mCacheMissFull.count();
 	S32 crc_count = mCacheMissCRC.count();
-	if (full_count == 0 && crc_count == 0) return;
+	if (full_count == 0 && crc_count == 0)
+	{
+		mCacheMissTimer.reset();
+		return;
+	}
+
+	// Let the misses from several ObjectUpdateCached packets pile up into
+	// full RequestMultipleObjects messages instead of sending a small one
+	// every frame.
+	if (full_count + crc_count < MAX_BLOCKS &&
+		mCacheMissTimer.getElapsedTimeF32() < CACHE_MISS_BATCH_TIME)
+	{
+		return;
+	}
+
+	// The same id can be missed more than once before we get here, from
+	// repeated cached updates or from orphan parent lookups.
+	std::sort(mCacheMissFull.begin(), mCacheMissFull.end());
+	mCacheMissFull.erase(std::unique(mCacheMissFull.begin(), mCacheMissFull.end()), mCacheMissFull.end());
+	std::sort(mCacheMissCRC.begin(), mCacheMissCRC.end());
+	mCacheMissCRC.erase(std::unique(mCacheMissCRC.begin(), mCacheMissCRC.end()), mCacheMissCRC.end());
+	full_count = mCacheMissFull.count();
+	crc_count = mCacheMissCRC.count();
 
 	LLMessageSystem* msg = gMessageSystem;
 	BOOL start_new_message = TRUE;
@@ -1273,7 +1296,7 @@ void LLViewerRegion::requestCacheMisses()
 		msg->addU32Fast(_PREHASH_ID, mCacheMissFull[i]);
 		blocks++;
 
-		if (blocks >= 255)
+		if (blocks >= MAX_BLOCKS)
 		{
 			sendReliableMessage();
 			start_new_message = TRUE;
@@ -1299,7 +1322,7 @@ void LLViewerRegion::requestCacheMisses()
 		msg->addU32Fast(_PREHASH_ID, mCacheMissCRC[i]);
 		blocks++;
 
-		if (blocks >= 255)
+		if (blocks >= MAX_BLOCKS)
 		{
 			sendReliableMessage();
 			start_new_message = TRUE;
@@ -1487,6 +1510,7 @@ void LLViewerRegion::unpackRegionHandshake()
 	msg->sendReliable(host);
 }
 
+//static
 void LLViewerRegionImpl::buildCapabilityNames(LLSD& capabilityNames)
 {
 	capabilityNames.append("AttachmentResources");
@@ -1560,6 +1584,18 @@ void LLViewerRegionImpl::buildCapabilityNames(LLSD& capabilityNames)
 	// merge conflicts.
 }
 
+//static
+const LLSD& LLViewerRegionImpl::getCapabilityNames()
+{
+	static LLSD sCapabilityNames;
+	if (sCapabilityNames.isUndefined())
+	{
+		sCapabilityNames = LLSD::emptyArray();
+		buildCapabilityNames(sCapabilityNames);
+	}
+	return sCapabilityNames;
+}
+
 void LLViewerRegion::setSeedCapability(const std::string& url)
 {
 	if (getCapability("Seed") == url)
@@ -1574,15 +1610,12 @@ void LLViewerRegion::setSeedCapability(const std::string& url)
 	mImpl->mCapabilities.clear();
 	setCapability("Seed", url);
 
-	LLSD capabilityNames = LLSD::emptyArray();
-	mImpl->buildCapabilityNames(capabilityNames);
-
 	llinfos << "posting to seed " << url << llendl;
 
 	S32 id = ++mImpl->mHttpResponderID;
-	LLHTTPClient::post(url, capabilityNames, 
-						BaseCapabilitiesComplete::build(getHandle(), id),
-						LLSD(), CAP_REQUEST_TIMEOUT);
+	LLCoros::instance().launch("LLViewerRegion::requestBaseCapabilities",
+							   boost::bind(request_base_capabilities_coro, _1, getHandle(), id,
+										   url, LLViewerRegionImpl::getCapabilityNames()));
 }
 
 S32 LLViewerRegion::getNumSeedCapRetries()
@@ -1590,7 +1623,7 @@ S32 LLViewerRegion::getNumSeedCapRetries()
 	return mImpl->mSeedCapAttempts;
 }
 
-void LLViewerRegion::failedSeedCapability()
+bool LLViewerRegion::failedSeedCapability()
 {
 	// Should we retry asking for caps?
 	mImpl->mSeedCapAttempts++;
@@ -1598,7 +1631,7 @@ void LLViewerRegion::failedSeedCapability()
 	if ( url.empty() )
 	{
 		LL_WARNS2("AppInit", "Capabilities") << "Failed to get seed capabilities, and can not determine url for retries!" << LL_ENDL;
-		return;
+		return false;
 	}
 	// After a few attempts, continue login.  We will keep trying once in-world:
 	if ( mImpl->mSeedCapAttempts >= mImpl->mSeedCapMaxAttemptsBeforeLogin &&
@@ -1609,22 +1642,14 @@ void LLViewerRegion::failedSeedCapability()
 
 	if ( mImpl->mSeedCapAttempts < mImpl->mSeedCapMaxAttempts)
 	{
-		LLSD capabilityNames = LLSD::emptyArray();
-		mImpl->buildCapabilityNames(capabilityNames);
-
 		llinfos << "posting to seed " << url << " (retry " 
 				<< mImpl->mSeedCapAttempts << ")" << llendl;
-
-		S32 id = ++mImpl->mHttpResponderID;
-		LLHTTPClient::post(url, capabilityNames, 
-						BaseCapabilitiesComplete::build(getHandle(), id),
-						LLSD(), CAP_REQUEST_TIMEOUT);
-	}
-	else
-	{
-		// *TODO: Give a user pop-up about this error?
-		LL_WARNS2("AppInit", "Capabilities") << "Failed to get seed capabilities from '" << url << "' after " << mImpl->mSeedCapAttempts << " attempts.  Giving up!" << LL_ENDL;
+		return true;
 	}
+
+	// *TODO: Give a user pop-up about this error?
+	LL_WARNS2("AppInit", "Capabilities") << "Failed to get seed capabilities from '" << url << "' after " << mImpl->mSeedCapAttempts << " attempts.  Giving up!" << LL_ENDL;
+	return false;
 }
 
 class SimulatorFeaturesReceived : public LLHTTPClient::Responder
@@ -1675,6 +1700,10 @@ private:
 
 void LLViewerRegion::setCapability(const std::string& name, const std::string& url)
 {
+	// caps and seeds for neighbours show up well before we need them, so
+	// have the host resolved by the time the first request goes out
+	LLCurl::prefetchHost(url);
+
 	if(name == "EventQueueGet")
 	{
 		delete mImpl->mEventPoll;
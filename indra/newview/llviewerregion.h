@@ -33,6 +33,7 @@
 #include <boost/signals2.hpp>
 
 #include "lldarray.h"
+#include "llframetimer.h"
 #include "llwind.h"
 #include "llstat.h"
 #include "v3dmath.h"
@@ -230,7 +231,8 @@ public:
 
 	// Get/set named capability URLs for this region.
 	void setSeedCapability(const std::string& url);
-	void failedSeedCapability();
+	// Counts a failed seed request, returns true if it should be retried.
+	bool failedSeedCapability();
 	S32 getNumSeedCapRetries();
 	void setCapability(const std::string& name, const std::string& url);
 	// implements LLCapabilityProvider
@@ -408,6 +410,7 @@ private:
 
 	LLDynamicArray<U32>						mCacheMissFull;
 	LLDynamicArray<U32>						mCacheMissCRC;
+	LLFrameTimer							mCacheMissTimer;	// time since the miss lists were last empty
 
 	bool	mAlive;					// can become false if circuit disconnects
 	bool	mCapabilitiesReceived;
@@ -384,6 +384,15 @@ void LLViewerShaderMgr::setShaders()
 	
 	// Make sure the compiled shader map is cleared before we recompile shaders.
 	mShaderObjects.clear();
+	mShaderSourceHashes.clear();
+	mFeatureHash.clear();
+
+	mProgramCacheDir.clear();
+	if (gSavedSettings.getBOOL("RenderShaderCache"))
+	{
+		mProgramCacheDir = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "shader_cache");
+		LLFile::mkdir(mProgramCacheDir);
+	}
 	
 	initAttribsAndUniforms();
 	gPipeline.releaseGLBuffers();
@@ -489,6 +498,9 @@ void LLViewerShaderMgr::setShaders()
 
 		if (loaded)
 		{
+			//every program links against the basic shaders, fold them into each program's cache key
+			updateFeatureHash();
+
 			gPipeline.mVertexShadersEnabled = TRUE;
 			gPipeline.mVertexShadersLoaded = 1;
 
@@ -263,6 +263,9 @@ LLViewerStats::LLViewerStats() :
 	mNumObjectsStat("numobjectsstat"),
 	mNumActiveObjectsStat("numactiveobjectsstat"),
 	mNumNewObjectsStat("numnewobjectsstat"),
+	mObjectCacheHitStat("objectcachehitstat"),
+	mObjectCacheMissStat("objectcachemissstat"),
+	mObjectCacheDupeStat("objectcachedupestat"),
 	mNumSizeCulledStat("numsizeculledstat"),
 	mNumVisCulledStat("numvisculledstat"),
 	mLastTimeDiff(0.0)
@@ -107,6 +107,9 @@ public:
 	LLStat mNumObjectsStat;
 	LLStat mNumActiveObjectsStat;
 	LLStat mNumNewObjectsStat;
+	LLStat mObjectCacheHitStat;
+	LLStat mObjectCacheMissStat;
+	LLStat mObjectCacheDupeStat;
 	LLStat mNumSizeCulledStat;
 	LLStat mNumVisCulledStat;
 
@@ -32,18 +32,22 @@
 #include "llfile.h"
 #include "llviewerregion.h"
 #include "llviewerobject.h"
+#include "llvoavatar.h"
 
 
 // To do - something using region name or global position
 #if LL_WINDOWS
 	static const std::string STATS_FILE_NAME("C:\\ViewerObjectCacheStats.csv");
+	static const std::string AVATAR_REZ_FILE_NAME("C:\\ViewerAvatarRezStats.csv");
 #else
 	static const std::string STATS_FILE_NAME("/tmp/viewerstats.csv");
+	static const std::string AVATAR_REZ_FILE_NAME("/tmp/viewerrezstats.csv");
 #endif
 
 LLViewerStatsRecorder* LLViewerStatsRecorder::sInstance = NULL;
 LLViewerStatsRecorder::LLViewerStatsRecorder() :
 	mObjectCacheFile(NULL),
+	mAvatarRezFile(NULL),
 	mTimer(),
 	mRegionp(NULL),
 	mStartTime(0.f),
@@ -64,6 +68,11 @@ LLViewerStatsRecorder::~LLViewerStatsRecorder()
 		LLFile::close(mObjectCacheFile);
 		mObjectCacheFile = NULL;
 	}
+	if (mAvatarRezFile != NULL)
+	{
+		LLFile::close(mAvatarRezFile);
+		mAvatarRezFile = NULL;
+	}
 }
 
 // static
@@ -247,6 +256,41 @@ void LLViewerStatsRecorder::endObjectUpdateEvents()
 	clearStats();
 }
 
+void LLViewerStatsRecorder::recordAvatarRezTimes(LLVOAvatar* avatarp)
+{
+	if (mAvatarRezFile == NULL)
+	{
+		mAvatarRezFile = LLFile::fopen(AVATAR_REZ_FILE_NAME, "wb");
+		if (mAvatarRezFile)
+		{	// Write column headers
+			std::ostringstream data_msg;
+			data_msg << "AvatarID, Self";
+			for (S32 i = 0; i < LLVOAvatar::REZ_STAGE_COUNT; i++)
+			{
+				data_msg << ", " << LLVOAvatar::getRezStageName((LLVOAvatar::ERezStage) i);
+			}
+			data_msg << "\n";
+
+			fwrite(data_msg.str().c_str(), 1, data_msg.str().size(), mAvatarRezFile );
+		}
+	}
+
+	if (mAvatarRezFile != NULL)
+	{
+		// one row per avatar, -1 for stages it never reached
+		std::ostringstream data_msg;
+		data_msg << avatarp->getID()
+			<< ", " << (avatarp->isSelf() ? 1 : 0);
+		for (S32 i = 0; i < LLVOAvatar::REZ_STAGE_COUNT; i++)
+		{
+			data_msg << ", " << avatarp->getRezStageTime((LLVOAvatar::ERezStage) i);
+		}
+		data_msg << "\n";
+
+		fwrite(data_msg.str().c_str(), 1, data_msg.str().size(), mAvatarRezFile );
+	}
+}
+
 F32 LLViewerStatsRecorder::getTimeSinceStart()
 {
 	return (F32) ((LLTimer::getTotalTime() - mStartTime) / 1000.0);
@@ -43,6 +43,7 @@
 class LLMutex;
 class LLViewerRegion;
 class LLViewerObject;
+class LLVOAvatar;
 
 class LLViewerStatsRecorder
 {
@@ -64,12 +65,16 @@ class LLViewerStatsRecorder
 	void recordRequestCacheMissesEvent(S32 count);
 	void endObjectUpdateEvents();
 
+	// Appends the avatar's rez stage times, once it finishes loading or leaves
+	void recordAvatarRezTimes(LLVOAvatar* avatarp);
+
 	F32 getTimeSinceStart();
 
 private:
 	static LLViewerStatsRecorder* sInstance;
 
 	LLFILE *	mObjectCacheFile;		// File to write data into
+	LLFILE *	mAvatarRezFile;			// Per avatar rez stage times
 	LLFrameTimer	mTimer;
 	LLViewerRegion*	mRegionp;
 	F64			mStartTime;
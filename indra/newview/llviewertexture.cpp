@@ -610,6 +610,7 @@ void LLViewerTexture::init(bool firstinit)
 	mMaxVirtualSizeResetInterval = 1;
 	mMaxVirtualSizeResetCounter = mMaxVirtualSizeResetInterval ;
 	mAdditionalDecodePriority = 0.f ;	
+	mPixelAreaBucket = -1 ;
 	mParcelMedia = NULL ;
 	mNumFaces = 0 ;
 	mNumVolumes = 0;
@@ -724,6 +725,25 @@ void LLViewerTexture::addTextureStats(F32 virtual_size, BOOL needs_gltexture) co
 	{
 		mMaxVirtualSize = virtual_size;
 	}	
+
+	S8 bucket = getPixelAreaBucket(mMaxVirtualSize);
+	if (bucket > mPixelAreaBucket)
+	{
+		mPixelAreaBucket = bucket;
+		onPixelAreaBucketRaised();
+	}
+}
+
+//static
+S8 LLViewerTexture::getPixelAreaBucket(F32 virtual_size)
+{
+	if (virtual_size < 1.f)
+	{
+		return 0;
+	}
+	S32 exponent;
+	frexpf(virtual_size, &exponent);
+	return (S8)((exponent + 1) >> 1);
 }
 
 void LLViewerTexture::resetTextureStats()
@@ -1548,6 +1568,8 @@ BOOL LLViewerFetchedTexture::createTexture(S32 usename/*= 0*/)
 	
 	if(!(res = insertToAtlas()))
 	{
+		// Only in-world textures may be stored lossy compressed, UI and previews keep full quality
+		mGLTexturep->setAllowCompression(mBoostLevel < LLViewerTexture::BOOST_HIGH);
 		res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, TRUE, mBoostLevel);
 		resetFaceAtlas() ;
 	}
@@ -1825,6 +1847,16 @@ void LLViewerFetchedTexture::setDecodePriority(F32 priority)
 	}
 }
 
+//virtual
+void LLViewerFetchedTexture::onPixelAreaBucketRaised() const
+{
+	// Textures shrinking on screen are picked up by the regular sweep
+	if (mInImageList)
+	{
+		gTextureList.dirtyImagePriority(const_cast<LLViewerFetchedTexture*>(this));
+	}
+}
+
 void LLViewerFetchedTexture::setAdditionalDecodePriority(F32 priority)
 {
 	priority = llclamp(priority, 0.f, 1.f);
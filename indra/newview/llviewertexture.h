@@ -179,6 +179,10 @@ public:
 
 	virtual F32  getMaxVirtualSize() ;
 
+	// Coarse pixel area class (one per factor of 4), used to spot visibility changes cheaply
+	static S8 getPixelAreaBucket(F32 virtual_size);
+	void updatePixelAreaBucket() { mPixelAreaBucket = getPixelAreaBucket(mMaxVirtualSize); }
+
 	LLFrameTimer* getLastReferencedTimer() {return &mLastReferencedTimer ;}
 	
 	S32 getFullWidth() const { return mFullWidth; }
@@ -262,6 +266,7 @@ protected:
 	void reorganizeFaceList() ;
 	void reorganizeVolumeList() ;
 	void setTexelsPerImage();
+	virtual void onPixelAreaBucketRaised() const {} // this texture became noticeably larger on screen
 private:
 	//note: do not make this function public.
 	/*virtual*/ LLImageGL* getGLTexture() const ;
@@ -281,6 +286,7 @@ protected:
 	mutable S32  mMaxVirtualSizeResetCounter ;
 	mutable S32  mMaxVirtualSizeResetInterval;
 	mutable F32 mAdditionalDecodePriority;  // priority add to mDecodePriority.
+	mutable S8  mPixelAreaBucket;	// pixel area class at the last priority update
 	LLFrameTimer mLastReferencedTimer;	
 
 	//GL texture
@@ -397,6 +403,7 @@ public:
 	void destroyTexture() ;	
 	
 	virtual void processTextureStats() ;
+	/*virtual*/ void onPixelAreaBucketRaised() const;
 	F32  calcDecodePriority() ;
 
 	BOOL needsAux() const { return mNeedsAux; }
@@ -39,6 +39,8 @@ public:
 	/*virtual*/ void reset();
 
 	S32 animateTextures(F32 &off_s, F32 &off_t, F32 &scale_s, F32 &scale_t, F32 &rotate);
+	// next animateTextures() reports the current frame even if it hasn't changed
+	void invalidateFrame() { mLastFrame = -1.f; }
 	enum
 	{
 		TRANSLATE = 0x01 // Result code JUST for animateTextures
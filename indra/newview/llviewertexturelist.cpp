@@ -279,6 +279,7 @@ void LLViewerTextureList::shutdown()
 	mUUIDMap.clear();
 	
 	mImageList.clear();
+	mDirtyPriorityList.clear();
 
 	mInitialized = FALSE ; //prevent loading textures again.
 }
@@ -570,6 +571,7 @@ void LLViewerTextureList::deleteImage(LLViewerFetchedTexture *image)
 		{
 			mCallbackList.erase(image);
 		}
+		mDirtyPriorityList.erase(image);
 
 		llverify(mUUIDMap.erase(image->getID()) == 1);
 		sNumImages--;
@@ -587,6 +589,11 @@ void LLViewerTextureList::dirtyImage(LLViewerFetchedTexture *image)
 	mDirtyTextureList.insert(image);
 }
 
+void LLViewerTextureList::dirtyImagePriority(LLViewerFetchedTexture *image)
+{
+	mDirtyPriorityList.insert(image);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 static LLFastTimer::DeclareTimer FTM_IMAGE_MARK_DIRTY("Dirty Images");
 static LLFastTimer::DeclareTimer FTM_IMAGE_UPDATE_PRIORITIES("Prioritize");
@@ -661,6 +668,23 @@ void LLViewerTextureList::updateImages(F32 max_time)
 
 void LLViewerTextureList::updateImagesDecodePriorities()
 {
+	// Images that grew on screen go first, so the frame cost follows visibility changes
+	// rather than the size of the image list
+	{
+		const size_t max_dirty_count = llmin((S32) (4096*gFrameIntervalSeconds) + 1, 128); //target 4096 textures per second
+		size_t dirty_counter = llmin(max_dirty_count, mDirtyPriorityList.size());
+		while(dirty_counter > 0)
+		{
+			LLViewerFetchedTexture* imagep = *mDirtyPriorityList.begin();
+			mDirtyPriorityList.erase(mDirtyPriorityList.begin());
+			if (!imagep->isDeleted())
+			{
+				updateImageDecodePriority(imagep);
+			}
+			dirty_counter--;
+		}
+	}
+
 	// Update the decode priority for N images each frame
 	{
 		const size_t max_update_count = llmin((S32) (1024*gFrameIntervalSeconds) + 1, 32); //target 1024 textures per second
@@ -730,24 +754,32 @@ void LLViewerTextureList::updateImagesDecodePriorities()
 				}
 			}
 			
-			imagep->processTextureStats();
-			F32 old_priority = imagep->getDecodePriority();
-			F32 old_priority_test = llmax(old_priority, 0.0f);
-			F32 decode_priority = imagep->calcDecodePriority();
-			F32 decode_priority_test = llmax(decode_priority, 0.0f);
-			// Ignore < 20% difference
-			if ((decode_priority_test < old_priority_test * .8f) ||
-				(decode_priority_test > old_priority_test * 1.25f))
-			{
-				removeImageFromList(imagep);
-				imagep->setDecodePriority(decode_priority);
-				addImageToList(imagep);
-			}
+			updateImageDecodePriority(imagep);
 			update_counter--;
 		}
 	}
 }
 
+void LLViewerTextureList::updateImageDecodePriority(LLViewerFetchedTexture* imagep)
+{
+	imagep->processTextureStats();
+	// Restarting the virtual size window may have queued this image again
+	imagep->updatePixelAreaBucket();
+	mDirtyPriorityList.erase(imagep);
+	F32 old_priority = imagep->getDecodePriority();
+	F32 old_priority_test = llmax(old_priority, 0.0f);
+	F32 decode_priority = imagep->calcDecodePriority();
+	F32 decode_priority_test = llmax(decode_priority, 0.0f);
+	// Ignore < 20% difference
+	if ((decode_priority_test < old_priority_test * .8f) ||
+		(decode_priority_test > old_priority_test * 1.25f))
+	{
+		removeImageFromList(imagep);
+		imagep->setDecodePriority(decode_priority);
+		addImageToList(imagep);
+	}
+}
+
 /*
  static U8 get_image_type(LLViewerFetchedTexture* imagep, LLHost target_host)
  {
@@ -1369,6 +1401,7 @@ void LLUIImageList::cleanUp()
 {
 	mUIImages.clear();
 	mUITextureList.clear() ;
+	mAtlasPages.clear();
 }
 
 LLUIImagePtr LLUIImageList::getUIImageByID(const LLUUID& image_id, S32 priority)
@@ -1532,6 +1565,7 @@ struct UIImageDeclaration : public LLInitParam::Block<UIImageDeclaration>
 	Optional<LLRect>		scale;
 	Optional<LLRect>		clip;
 	Optional<bool>			use_mips;
+	Optional<bool>			atlas;
 
 	UIImageDeclaration()
 	:	name("name"),
@@ -1539,7 +1573,8 @@ struct UIImageDeclaration : public LLInitParam::Block<UIImageDeclaration>
 		preload("preload", false),
 		scale("scale"),
 		clip("clip"),
-		use_mips("use_mips", false)
+		use_mips("use_mips", false),
+		atlas("atlas", true)
 	{}
 };
 
@@ -1554,6 +1589,315 @@ struct UIImageDeclarations : public LLInitParam::Block<UIImageDeclarations>
 	{}
 };
 
+// Preloaded skin images are packed into a few shared textures so that
+// drawing the UI chrome doesn't bind a different small texture for every
+// widget.  The packed pages are cached and reused until a source changes.
+static const S32 UI_ATLAS_VERSION = 1;
+static const S32 UI_ATLAS_PAGE_SIZE = 1024;
+static const S32 UI_ATLAS_MAX_IMAGE_SIZE = 256;
+// edge pixels are repeated into the gutter so bilinear filtering never
+// picks up a neighbouring image
+static const S32 UI_ATLAS_GUTTER = 1;
+
+struct UIAtlasSource
+{
+	const UIImageDeclaration* mDeclaration;
+	std::string		mPath;
+	S32				mFileSize;
+	S32				mFileTime;
+	LLPointer<LLImageRaw> mRaw;
+	S32				mPage;	// -1 when not packed
+	LLRect			mRect;	// pixels on the page, without the gutter
+};
+
+static std::string ui_atlas_page_filename(S32 page)
+{
+	return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, llformat("ui_atlas_%d.png", page));
+}
+
+static bool ui_atlas_load_cached(const std::string& index_filename, std::vector<UIAtlasSource>& sources, std::vector< LLPointer<LLImageRaw> >& pages)
+{
+	LLSD index;
+	llifstream file;
+	file.open(index_filename);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	LLSDSerialize::fromXML(index, file);
+	file.close();
+
+	const LLSD& cached_sources = index["sources"];
+	if (index["version"].asInteger() != UI_ATLAS_VERSION
+		|| index["page_size"].asInteger() != UI_ATLAS_PAGE_SIZE
+		|| cached_sources.size() != (S32)sources.size())
+	{
+		return false;
+	}
+	for (S32 i = 0; i < (S32)sources.size(); i++)
+	{
+		const LLSD& cached = cached_sources[i];
+		UIAtlasSource& source = sources[i];
+		if (cached["name"].asString() != source.mDeclaration->name()
+			|| cached["path"].asString() != source.mPath
+			|| cached["size"].asInteger() != source.mFileSize
+			|| cached["time"].asInteger() != source.mFileTime)
+		{
+			return false;
+		}
+		source.mPage = cached["page"].asInteger();
+		source.mRect.setValue(cached["rect"]);
+	}
+
+	S32 num_pages = index["pages"].asInteger();
+	for (S32 page = 0; page < num_pages; page++)
+	{
+		LLPointer<LLImagePNG> png = new LLImagePNG;
+		LLPointer<LLImageRaw> raw = new LLImageRaw;
+		if (!png->load(ui_atlas_page_filename(page))
+			|| !png->decode(raw, 0.f)
+			|| raw->getWidth() != UI_ATLAS_PAGE_SIZE
+			|| raw->getHeight() != UI_ATLAS_PAGE_SIZE
+			|| raw->getComponents() != 4)
+		{
+			pages.clear();
+			return false;
+		}
+		pages.push_back(raw);
+	}
+	return true;
+}
+
+// copies src onto the page with its lower left corner at x, y and fills the
+// gutter around it from the nearest edge pixel
+static void ui_atlas_blit(LLImageRaw* page, const LLImageRaw* src, S32 x, S32 y)
+{
+	const S32 width = src->getWidth();
+	const S32 height = src->getHeight();
+	const S32 components = src->getComponents();
+	const U8* src_data = src->getData();
+	U8* page_data = page->getData();
+
+	for (S32 row = -UI_ATLAS_GUTTER; row < height + UI_ATLAS_GUTTER; row++)
+	{
+		const U8* src_row = src_data + llclamp(row, 0, height - 1) * width * components;
+		U8* dst = page_data + ((y + row) * UI_ATLAS_PAGE_SIZE + x - UI_ATLAS_GUTTER) * 4;
+		for (S32 col = -UI_ATLAS_GUTTER; col < width + UI_ATLAS_GUTTER; col++)
+		{
+			const U8* pixel = src_row + llclamp(col, 0, width - 1) * components;
+			dst[0] = pixel[0];
+			dst[1] = pixel[1];
+			dst[2] = pixel[2];
+			dst[3] = components == 4 ? pixel[3] : 255;
+			dst += 4;
+		}
+	}
+}
+
+struct CompareAtlasHeight
+{
+	CompareAtlasHeight(const std::vector<UIAtlasSource>& sources) : mSources(sources) {}
+	bool operator()(S32 a, S32 b) const
+	{
+		return mSources[a].mRaw->getHeight() > mSources[b].mRaw->getHeight();
+	}
+	const std::vector<UIAtlasSource>& mSources;
+};
+
+static void ui_atlas_build(const std::string& index_filename, std::vector<UIAtlasSource>& sources, std::vector< LLPointer<LLImageRaw> >& pages)
+{
+	std::vector<S32> packed;
+	for (S32 i = 0; i < (S32)sources.size(); i++)
+	{
+		UIAtlasSource& source = sources[i];
+		source.mPage = -1;
+
+		LLPointer<LLImageFormatted> image = LLImageFormatted::createFromExtension(source.mPath);
+		if (image.isNull() || !image->load(source.mPath))
+		{
+			continue;
+		}
+		LLPointer<LLImageRaw> raw = new LLImageRaw;
+		if (!image->decode(raw, 0.f)
+			|| raw->getWidth() > UI_ATLAS_MAX_IMAGE_SIZE
+			|| raw->getHeight() > UI_ATLAS_MAX_IMAGE_SIZE
+			|| raw->getComponents() < 3)
+		{
+			// loaded on its own as before
+			continue;
+		}
+		source.mRaw = raw;
+		packed.push_back(i);
+	}
+
+	// shelf packing, tallest first
+	std::stable_sort(packed.begin(), packed.end(), CompareAtlasHeight(sources));
+	S32 page = 0;
+	S32 x = 0;
+	S32 y = 0;
+	S32 shelf_height = 0;
+	for (std::vector<S32>::iterator iter = packed.begin(); iter != packed.end(); ++iter)
+	{
+		UIAtlasSource& source = sources[*iter];
+		S32 width = source.mRaw->getWidth() + UI_ATLAS_GUTTER * 2;
+		S32 height = source.mRaw->getHeight() + UI_ATLAS_GUTTER * 2;
+		if (x + width > UI_ATLAS_PAGE_SIZE)
+		{
+			x = 0;
+			y += shelf_height;
+			shelf_height = 0;
+		}
+		if (y + height > UI_ATLAS_PAGE_SIZE)
+		{
+			page++;
+			x = 0;
+			y = 0;
+			shelf_height = 0;
+		}
+		if (page >= (S32)pages.size())
+		{
+			LLPointer<LLImageRaw> page_raw = new LLImageRaw(UI_ATLAS_PAGE_SIZE, UI_ATLAS_PAGE_SIZE, 4);
+			page_raw->clear(0, 0, 0, 0);
+			pages.push_back(page_raw);
+		}
+
+		source.mPage = page;
+		source.mRect.setOriginAndSize(x + UI_ATLAS_GUTTER, y + UI_ATLAS_GUTTER, source.mRaw->getWidth(), source.mRaw->getHeight());
+		ui_atlas_blit(pages[page], source.mRaw, source.mRect.mLeft, source.mRect.mBottom);
+		source.mRaw = NULL;
+
+		x += width;
+		shelf_height = llmax(shelf_height, height);
+	}
+
+	// cache the packing for the next run
+	for (S32 i = 0; i < (S32)pages.size(); i++)
+	{
+		LLPointer<LLImagePNG> png = new LLImagePNG;
+		if (!png->encode(pages[i], 0.f) || !png->save(ui_atlas_page_filename(i)))
+		{
+			llwarns << "Unable to cache UI image atlas page " << i << llendl;
+			return;
+		}
+	}
+
+	LLSD index;
+	index["version"] = UI_ATLAS_VERSION;
+	index["page_size"] = UI_ATLAS_PAGE_SIZE;
+	index["pages"] = (S32)pages.size();
+	for (S32 i = 0; i < (S32)sources.size(); i++)
+	{
+		const UIAtlasSource& source = sources[i];
+		LLSD cached;
+		cached["name"] = source.mDeclaration->name();
+		cached["path"] = source.mPath;
+		cached["size"] = source.mFileSize;
+		cached["time"] = source.mFileTime;
+		cached["page"] = source.mPage;
+		cached["rect"] = source.mRect.getValue();
+		index["sources"].append(cached);
+	}
+	llofstream file;
+	file.open(index_filename);
+	LLSDSerialize::toPrettyXML(index, file);
+}
+
+void LLUIImageList::loadAtlasImages(const std::map<std::string, UIImageDeclaration>& declarations)
+{
+	// only the preloaded chrome is packed; images drawn straight from their
+	// texture (rotated arrows, the name tag background) opt out with atlas="false"
+	std::vector<UIAtlasSource> sources;
+	for (std::map<std::string, UIImageDeclaration>::const_iterator image_it = declarations.begin();
+		image_it != declarations.end();
+		++image_it)
+	{
+		const UIImageDeclaration& image = image_it->second;
+		if (!image.preload || image.use_mips || !image.atlas)
+		{
+			continue;
+		}
+		std::string file_name = image.file_name.isProvided() ? image.file_name() : image.name();
+		std::string extension = gDirUtilp->getExtension(file_name);
+		if (extension != "png" && extension != "tga")
+		{
+			continue;
+		}
+		std::string full_path = gDirUtilp->findSkinnedFilename("textures", file_name);
+		llstat stat_data;
+		if (full_path.empty() || LLFile::stat(full_path, &stat_data) != 0)
+		{
+			continue;
+		}
+
+		UIAtlasSource source;
+		source.mDeclaration = &image;
+		source.mPath = full_path;
+		source.mFileSize = (S32)stat_data.st_size;
+		source.mFileTime = (S32)stat_data.st_mtime;
+		source.mPage = -1;
+		sources.push_back(source);
+	}
+	if (sources.empty())
+	{
+		return;
+	}
+
+	std::string index_filename = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "ui_atlas.xml");
+	std::vector< LLPointer<LLImageRaw> > pages;
+	if (!ui_atlas_load_cached(index_filename, sources, pages))
+	{
+		ui_atlas_build(index_filename, sources, pages);
+	}
+
+	for (S32 i = 0; i < (S32)pages.size(); i++)
+	{
+		LLPointer<LLViewerTexture> texture = LLViewerTextureManager::getLocalTexture(pages[i], FALSE);
+		texture->setAddressMode(LLTexUnit::TAM_CLAMP);
+		mAtlasPages.push_back(texture);
+	}
+
+	const F32 page_size = (F32)UI_ATLAS_PAGE_SIZE;
+	S32 packed_count = 0;
+	for (std::vector<UIAtlasSource>::iterator iter = sources.begin(); iter != sources.end(); ++iter)
+	{
+		const UIAtlasSource& source = *iter;
+		if (source.mPage < 0 || source.mPage >= (S32)mAtlasPages.size())
+		{
+			continue;
+		}
+		const UIImageDeclaration& image = *source.mDeclaration;
+		LLUIImagePtr imagep = new LLUIImage(image.name, mAtlasPages[source.mPage]);
+
+		LLRect clip_rect = source.mRect;
+		if (image.clip.isProvided() && image.clip() != LLRect::null)
+		{
+			const LLRect& clip = image.clip();
+			clip_rect.set(source.mRect.mLeft + clip.mLeft, source.mRect.mBottom + clip.mTop,
+						  source.mRect.mLeft + clip.mRight, source.mRect.mBottom + clip.mBottom);
+			clip_rect.intersectWith(source.mRect);
+		}
+		imagep->setClipRegion(LLRectf((F32)clip_rect.mLeft / page_size,
+									(F32)clip_rect.mTop / page_size,
+									(F32)clip_rect.mRight / page_size,
+									(F32)clip_rect.mBottom / page_size));
+
+		if (image.scale.isProvided() && image.scale() != LLRect::null)
+		{
+			const LLRect& scale_rect = image.scale();
+			imagep->setScaleRegion(
+				LLRectf(llclamp((F32)scale_rect.mLeft / (F32)imagep->getWidth(), 0.f, 1.f),
+					llclamp((F32)scale_rect.mTop / (F32)imagep->getHeight(), 0.f, 1.f),
+					llclamp((F32)scale_rect.mRight / (F32)imagep->getWidth(), 0.f, 1.f),
+					llclamp((F32)scale_rect.mBottom / (F32)imagep->getHeight(), 0.f, 1.f)));
+		}
+
+		mUIImages.insert(std::make_pair(image.name(), imagep));
+		packed_count++;
+	}
+
+	llinfos << "Packed " << packed_count << " UI images into " << mAtlasPages.size() << " atlas pages" << llendl;
+}
+
 bool LLUIImageList::initFromFile()
 {
 	// construct path to canonical textures.xml in default skin dir
@@ -1611,6 +1955,11 @@ bool LLUIImageList::initFromFile()
 		merged_declarations[image_it->name].overwriteFrom(*image_it);
 	}
 
+	if (gSavedSettings.getBOOL("UIImageAtlas"))
+	{
+		loadAtlasImages(merged_declarations);
+	}
+
 	enum e_decode_pass
 	{
 		PASS_DECODE_NOW,
@@ -1633,6 +1982,11 @@ bool LLUIImageList::initFromFile()
 			{
 				continue;
 			}
+			if (mUIImages.find(image.name) != mUIImages.end())
+			{
+				// already drawn from an atlas page
+				continue;
+			}
 			preloadUIImage(image.name, file_name, image.use_mips, image.scale, image.clip);
 		}
 
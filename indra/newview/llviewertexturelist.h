@@ -89,6 +89,8 @@ public:
 	LLViewerFetchedTexture *findImage(const LLUUID &image_id);
 
 	void dirtyImage(LLViewerFetchedTexture *image);
+	// Recompute this image's decode priority ahead of the regular sweep
+	void dirtyImagePriority(LLViewerFetchedTexture *image);
 	
 	// Using image stats, determine what images are necessary, and perform image updates.
 	void updateImages(F32 max_time);
@@ -115,6 +117,7 @@ public:
 	
 private:
 	void updateImagesDecodePriorities();
+	void updateImageDecodePriority(LLViewerFetchedTexture* imagep);
 	F32  updateImagesCreateTextures(F32 max_time);
 	F32  updateImagesFetchTextures(F32 max_time);
 	void updateImagesUpdateStats();
@@ -174,6 +177,8 @@ public:
 
 	// Note: just raw pointers because they are never referenced, just compared against
 	std::set<LLViewerFetchedTexture*> mDirtyTextureList;
+	// Images whose pixel area class grew since their last priority update, same lifetime rules
+	std::set<LLViewerFetchedTexture*> mDirtyPriorityList;
 	
 	BOOL mForceResetTextureStats;
     
@@ -211,6 +216,8 @@ private:
 	static void (*sUUIDCallback)(void**, const LLUUID &);
 };
 
+struct UIImageDeclaration;
+
 class LLUIImageList : public LLImageProviderInterface, public LLSingleton<LLUIImageList>
 {
 public:
@@ -236,6 +243,9 @@ private:
 
 	LLPointer<LLUIImage> loadUIImage(LLViewerFetchedTexture* imagep, const std::string& name, BOOL use_mips = FALSE, const LLRect& scale_rect = LLRect::null, const LLRect& clip_rect = LLRect::null);
 
+	// packs the preloaded skin images into shared textures, reusing the
+	// packing cached from a previous run when none of the sources changed
+	void loadAtlasImages(const std::map<std::string, UIImageDeclaration>& declarations);
 
 	struct LLUIImageLoadData
 	{
@@ -251,6 +261,8 @@ private:
 	//keep a copy of UI textures to prevent them to be deleted.
 	//mGLTexturep of each UI texture equals to some LLUIImage.mImage.
 	std::list< LLPointer<LLViewerFetchedTexture> > mUITextureList ;
+
+	std::vector< LLPointer<LLViewerTexture> > mAtlasPages;
 };
 
 const BOOL GLTEXTURE_TRUE = TRUE;
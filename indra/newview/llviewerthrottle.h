@@ -66,6 +66,7 @@ public:
 
 	F32 getMaxBandwidth()const			{ return mMaxBandwidth; }
 	F32 getCurrentBandwidth() const		{ return mCurrentBandwidth; }
+	F32 getCurrentThrottle(EThrottleCats cat) const	{ return mCurrent.mThrottles[cat]; }	// kbps
 
 	void updateDynamicThrottle();
 	void resetDynamicThrottle();
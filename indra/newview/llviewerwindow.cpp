@@ -38,6 +38,8 @@
 #include "llagent.h"
 #include "llagentcamera.h"
 #include "llfloaterreg.h"
+#include "llframebudget.h"
+#include "llhudlayer.h"
 #include "llmeshrepository.h"
 #include "llpanellogin.h"
 #include "llviewerkeyboard.h"
@@ -112,6 +114,7 @@
 #include "llfontfreetype.h"
 #include "llgesturemgr.h"
 #include "llglheaders.h"
+#include "llgputimer.h"
 #include "lltooltip.h"
 #include "llhudmanager.h"
 #include "llhudobject.h"
@@ -463,6 +466,20 @@ public:
 				ypos += y_inc;
 			}
 
+			if (gSavedSettings.getBOOL("RenderAdaptiveQuality"))
+			{
+				addText(xpos, ypos, LLFrameBudget::getInstance()->getDebugText());
+				ypos += y_inc;
+			}
+
+			std::vector<std::string> hud_lines;
+			LLHUDLayer::getInstance()->getDebugText(hud_lines);
+			for (std::vector<std::string>::const_iterator iter = hud_lines.begin(); iter != hud_lines.end(); ++iter)
+			{
+				addText(xpos, ypos, *iter);
+				ypos += y_inc;
+			}
+
 			if (gGLManager.mHasATIMemInfo)
 			{
 				S32 meminfo[4];
@@ -559,6 +576,9 @@ public:
 			addText(xpos, ypos, llformat("%d Unique Textures", LLImageGL::sUniqueCount));
 			ypos += y_inc;
 
+			addText(xpos, ypos, llformat("%d GL State Changes", LLGLState::sStateChanges));
+			ypos += y_inc;
+
 			addText(xpos, ypos, llformat("%d Render Calls", gPipeline.mBatchCount));
             ypos += y_inc;
 
@@ -625,6 +645,7 @@ public:
 
 			LLVertexBuffer::sBindCount = LLImageGL::sBindCount = 
 				LLVertexBuffer::sSetCount = LLImageGL::sUniqueCount = 
+				LLGLState::sStateChanges =
 				gPipeline.mNumVisibleNodes = LLPipeline::sVisibleLightCount = 0;
 		}
 		if (gSavedSettings.getBOOL("DebugShowRenderMatrices"))
@@ -1646,6 +1667,7 @@ LLViewerWindow::LLViewerWindow(const Params& p)
 	}
 	LLVertexBuffer::initClass(gSavedSettings.getBOOL("RenderVBOEnable"), gSavedSettings.getBOOL("RenderVBOMappingDisable"));
 	LL_INFOS("RenderInit") << "LLVertexBuffer initialization done." << LL_ENDL ;
+	LLGPUTimer::initClass();
 	gGL.init() ;
 
 	if (LLFeatureManager::getInstance()->isSafe()
@@ -4352,51 +4374,54 @@ BOOL LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
 					render_ui(scale_factor, subfield);
 				}
 				
-				for (U32 out_y = 0; out_y < read_height ; out_y++)
+				LLAppViewer::instance()->pingMainloopTimeout("LLViewerWindow::rawSnapshot");
+
+				S32 output_buffer_offset = ( 
+											(window_width * subimage_x) // ...plus subimage start in x...
+											+ (raw->getWidth() * window_height * subimage_y) // ...plus subimage start in y...
+											- output_buffer_offset_x // ...minus buffer padding x...
+											- (output_buffer_offset_y * (raw->getWidth()))  // ...minus buffer padding y...
+											) * raw->getComponents();
+
+				if (type == SNAPSHOT_TYPE_COLOR)
 				{
-					S32 output_buffer_offset = ( 
-												(out_y * (raw->getWidth())) // ...plus iterated y...
-												+ (window_width * subimage_x) // ...plus subimage start in x...
-												+ (raw->getWidth() * window_height * subimage_y) // ...plus subimage start in y...
-												- output_buffer_offset_x // ...minus buffer padding x...
-												- (output_buffer_offset_y * (raw->getWidth()))  // ...minus buffer padding y...
-												) * raw->getComponents();
-				
-					// Ping the watchdog thread every 100 lines to keep us alive (arbitrary number, feel free to change)
-					if (out_y % 100 == 0)
-					{
-						LLAppViewer::instance()->pingMainloopTimeout("LLViewerWindow::rawSnapshot");
-					}
-				
-					if (type == SNAPSHOT_TYPE_COLOR)
-					{
-						glReadPixels(
-									 subimage_x_offset, out_y + subimage_y_offset,
-									 read_width, 1,
-									 GL_RGB, GL_UNSIGNED_BYTE,
-									 raw->getData() + output_buffer_offset
-									 );
-					}
-					else // SNAPSHOT_TYPE_DEPTH
+					// Read the whole tile at once, letting GL stride it into the output image.
+					// One read stalls the pipeline once instead of once per scanline.
+					glPixelStorei(GL_PACK_ROW_LENGTH, raw->getWidth());
+					glReadPixels(
+								 subimage_x_offset, subimage_y_offset,
+								 read_width, read_height,
+								 GL_RGB, GL_UNSIGNED_BYTE,
+								 raw->getData() + output_buffer_offset
+								 );
+					glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+				}
+				else // SNAPSHOT_TYPE_DEPTH
+				{
+					LLPointer<LLImageRaw> depth_buffer = new LLImageRaw(read_width, read_height, sizeof(GL_FLOAT)); // need to store floating point values
+					glReadPixels(
+								 subimage_x_offset, subimage_y_offset,
+								 read_width, read_height,
+								 GL_DEPTH_COMPONENT, GL_FLOAT,
+								 depth_buffer->getData()
+								 );
+
+					const F32* depth_data = (const F32*)depth_buffer->getData();
+					const F32 near_clip = LLViewerCamera::getInstance()->getNear();
+					const F32 far_clip = LLViewerCamera::getInstance()->getFar();
+					for (U32 out_y = 0; out_y < read_height; out_y++)
 					{
-						LLPointer<LLImageRaw> depth_line_buffer = new LLImageRaw(read_width, 1, sizeof(GL_FLOAT)); // need to store floating point values
-						glReadPixels(
-									 subimage_x_offset, out_y + subimage_y_offset,
-									 read_width, 1,
-									 GL_DEPTH_COMPONENT, GL_FLOAT,
-									 depth_line_buffer->getData()// current output pixel is beginning of buffer...
-									 );
-
+						U8* out_line = raw->getData() + output_buffer_offset + (out_y * raw->getWidth() * raw->getComponents());
 						for (S32 i = 0; i < (S32)read_width; i++)
 						{
-							F32 depth_float = *(F32*)(depth_line_buffer->getData() + (i * sizeof(F32)));
+							F32 depth_float = depth_data[out_y * read_width + i];
 					
 							F32 linear_depth_float = 1.f / (depth_conversion_factor_1 - (depth_float * depth_conversion_factor_2));
-							U8 depth_byte = F32_to_U8(linear_depth_float, LLViewerCamera::getInstance()->getNear(), LLViewerCamera::getInstance()->getFar());
+							U8 depth_byte = F32_to_U8(linear_depth_float, near_clip, far_clip);
 							// write converted scanline out to result image
 							for (S32 j = 0; j < raw->getComponents(); j++)
 							{
-								*(raw->getData() + output_buffer_offset + (i * raw->getComponents()) + j) = depth_byte;
+								out_line[(i * raw->getComponents()) + j] = depth_byte;
 							}
 						}
 					}
@@ -4705,6 +4730,7 @@ void LLViewerWindow::stopGL(BOOL save_state)
 		}
 		
 		gBox.cleanupGL();
+		LLGPUTimer::destroyGL();
 		
 		if(gPostProcess)
 		{
@@ -70,6 +70,7 @@
 #include "llmutelist.h"
 #include "llmoveview.h"
 #include "llnotificationsutil.h"
+#include "llparallelfor.h"
 #include "llquantize.h"
 #include "llrand.h"
 #include "llregionhandle.h"
@@ -86,6 +87,7 @@
 #include "llviewerparcelmgr.h"
 #include "llviewershadermgr.h"
 #include "llviewerstats.h"
+#include "llviewerstatsrecorder.h"
 #include "llvoavatarself.h"
 #include "llvovolume.h"
 #include "llworld.h"
@@ -244,6 +246,8 @@ private:
 	BOOL mIsJoint;
 	LLVector3 mPos;
 	LLVector3 mRot;
+	// mRot converted once at load, every avatar's skeleton is set up from it
+	LLQuaternion mRotQuat;
 	LLVector3 mScale;
 	LLVector3 mPivot;
 	typedef std::vector<LLVOAvatarBoneInfo*> child_list_t;
@@ -602,6 +606,7 @@ LLVOAvatarSkeletonInfo* LLVOAvatar::sAvatarSkeletonInfo = NULL;
 LLVOAvatar::LLVOAvatarXmlInfo* LLVOAvatar::sAvatarXmlInfo = NULL;
 LLVOAvatarDictionary *LLVOAvatar::sAvatarDictionary = NULL;
 S32 LLVOAvatar::sFreezeCounter = 0;
+std::vector<LLPointer<LLVOAvatar> >* LLVOAvatar::sDeferredUpdates = NULL;
 U32 LLVOAvatar::sMaxVisible = 12;
 F32 LLVOAvatar::sRenderDistance = 256.f;
 S32	LLVOAvatar::sNumVisibleAvatars = 0;
@@ -714,6 +719,7 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 		mBakedTextureDatas[i].mIsLoaded = false;
 		mBakedTextureDatas[i].mIsUsed = false;
 		mBakedTextureDatas[i].mMaskTexName = 0;
+		mBakedTextureDatas[i].mMorphMaskCRC = 0;
 		mBakedTextureDatas[i].mTextureIndex = LLVOAvatarDictionary::bakedToLocalTextureIndex((EBakedTextureIndex)i);
 	}
 
@@ -735,6 +741,7 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 
 	mNeedsImpostorUpdate = TRUE;
 	mNeedsAnimUpdate = TRUE;
+	mImpostorSlot = -1;
 
 	mImpostorDistance = 0;
 	mImpostorPixelArea = 0;
@@ -768,6 +775,11 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 	mRuthTimer.reset();
 	mRuthDebugTimer.reset();
 	mDebugExistenceTimer.reset();
+	mRezStageTimer.reset();
+	for (S32 i = 0; i < REZ_STAGE_COUNT; i++)
+	{
+		mRezStageTimes[i] = -1.f;
+	}
 	mPelvisOffset = LLVector3(0.0f,0.0f,0.0f);
 	mLastPelvisToFoot = 0.0f;
 	mPelvisFixup = 0.0f;
@@ -779,6 +791,14 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 //------------------------------------------------------------------------
 LLVOAvatar::~LLVOAvatar()
 {
+#if LL_RECORD_VIEWER_STATS
+	// avatars that never finished loading are recorded as they leave
+	if (getRezStageTime(REZ_FULLY_LOADED) < 0.f && LLViewerStatsRecorder::instance())
+	{
+		LLViewerStatsRecorder::instance()->recordAvatarRezTimes(this);
+	}
+#endif
+
 	if (gSavedSettings.getBOOL("DebugAvatarRezTime"))
 	{
 		if (!mFullyLoaded)
@@ -861,6 +881,7 @@ void LLVOAvatar::markDead()
 	}
 	mVoiceVisualizer->markDead();
 	LLLoadedCallbackEntry::cleanUpCallbackList(&mCallbackTextureList) ;
+	gPipeline.mImpostorAtlas.freeSlot(mImpostorSlot);
 	LLViewerObject::markDead();
 }
 
@@ -1036,6 +1057,8 @@ void LLVOAvatar::resetImpostors()
 		LLVOAvatar* avatar = (LLVOAvatar*) *iter;
 		avatar->mImpostor.release();
 	}
+
+	gPipeline.mImpostorAtlas.release();
 }
 
 // static
@@ -1725,8 +1748,7 @@ BOOL LLVOAvatar::setupBone(const LLVOAvatarBoneInfo* info, LLViewerJoint* parent
 	}
 
 	joint->setPosition(info->mPos);
-	joint->setRotation(mayaQ(info->mRot.mV[VX], info->mRot.mV[VY],
-							 info->mRot.mV[VZ], LLQuaternion::XYZ));
+	joint->setRotation(info->mRotQuat);
 	joint->setScale(info->mScale);
 
 	joint->setDefaultFromCurrentXform();
@@ -2407,6 +2429,19 @@ BOOL LLVOAvatar::idleUpdate(LLAgent &agent, LLWorld &world, const F64 &time)
 	LLVector3 root_pos_last = mRoot.getWorldPosition();
 	BOOL detailed_update = updateCharacter(agent);
 
+	if (mMotionController.hasPendingBlend())
+	{ //finishDeferredUpdates completes the update once the pose has been applied
+		mDeferredRootPosLast = root_pos_last;
+		return TRUE;
+	}
+
+	finishIdleUpdate(detailed_update, root_pos_last);
+
+	return TRUE;
+}
+
+void LLVOAvatar::finishIdleUpdate(BOOL detailed_update, const LLVector3& root_pos_last)
+{
 	static LLUICachedControl<bool> visualizers_in_calls("ShowVoiceVisualizersInCalls", false);
 	bool voice_enabled = (visualizers_in_calls || LLVoiceClient::getInstance()->inProximalChannel()) &&
 						 LLVoiceClient::getInstance()->getVoiceEnabled(mID);
@@ -2424,8 +2459,6 @@ BOOL LLVOAvatar::idleUpdate(LLAgent &agent, LLWorld &world, const F64 &time)
 	
 	idleUpdateNameTag( root_pos_last );
 	idleUpdateRenderCost();
-
-	return TRUE;
 }
 
 void LLVOAvatar::idleUpdateVoiceVisualizer(bool voice_enabled)
@@ -2892,13 +2925,16 @@ void LLVOAvatar::idleUpdateNameTag(const LLVector3& root_pos_last)
 	}
 	
 	const F32 time_visible = mTimeVisible.getElapsedTimeF32();
-	const F32 NAME_SHOW_TIME = gSavedSettings.getF32("RenderNameShowTime");	// seconds
-	const F32 FADE_DURATION = gSavedSettings.getF32("RenderNameFadeDuration"); // seconds
+	static LLCachedControl<F32> render_name_show_time(gSavedSettings, "RenderNameShowTime");
+	static LLCachedControl<F32> render_name_fade_duration(gSavedSettings, "RenderNameFadeDuration");
+	static LLCachedControl<bool> use_chat_bubbles(gSavedSettings, "UseChatBubbles");
+	const F32 NAME_SHOW_TIME = render_name_show_time;	// seconds
+	const F32 FADE_DURATION = render_name_fade_duration; // seconds
 // [RLVa:KB] - Checked: 2010-04-04 (RLVa-1.2.2a) | Added: RLVa-0.2.0b
 	bool fRlvShowNames = gRlvHandler.hasBehaviour(RLV_BHVR_SHOWNAMES);
 // [/RLVa:KB]
 	BOOL visible_avatar = isVisible() || mNeedsAnimUpdate;
-	BOOL visible_chat = gSavedSettings.getBOOL("UseChatBubbles") && (mChats.size() || mTyping);
+	BOOL visible_chat = use_chat_bubbles && (mChats.size() || mTyping);
 	BOOL render_name =	visible_chat ||
 		                (visible_avatar &&
 // [RLVa:KB] - Checked: 2010-04-04 (RLVa-1.2.2a) | Added: RLVa-1.0.0h
@@ -2910,10 +2946,12 @@ void LLVOAvatar::idleUpdateNameTag(const LLVector3& root_pos_last)
 	// draw if we're specifically hiding our own name.
 	if (isSelf())
 	{
+		static LLCachedControl<bool> render_name_show_self(gSavedSettings, "RenderNameShowSelf");
+		static LLCachedControl<S32> avatar_name_tag_mode(gSavedSettings, "AvatarNameTagMode");
 		render_name = render_name
 			&& !gAgentCamera.cameraMouselook()
-			&& (visible_chat || (gSavedSettings.getBOOL("RenderNameShowSelf") 
-								 && gSavedSettings.getS32("AvatarNameTagMode") ));
+			&& (visible_chat || (render_name_show_self 
+								 && avatar_name_tag_mode ));
 	}
 
 	if ( !render_name )
@@ -3035,7 +3073,8 @@ void LLVOAvatar::idleUpdateNameTagText(BOOL new_name)
 // [/RLVa:KB]
 	bool is_cloud = getIsCloud();
 
-			if (gSavedSettings.getBOOL("DebugAvatarRezTime"))
+			static LLCachedControl<bool> debug_avatar_rez_time(gSavedSettings, "DebugAvatarRezTime");
+			if (debug_avatar_rez_time)
 			{
 				if (is_appearance != mNameAppearance)
 				{
@@ -3544,6 +3583,25 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 		F32 time_quantum = clamp_rescale((F32)sInstances.size(), 10.f, 35.f, 0.f, 0.25f);
 		F32 pixel_area_scale = clamp_rescale(mPixelArea, 100, 5000, 1.f, 0.f);
 		F32 time_step = time_quantum * pixel_area_scale;
+
+		// each animation LOD quarters the pixel area threshold and halves the update rate,
+		// the motion controller interpolates the pose on the frames in between
+		static LLCachedControl<F32> anim_lod_area(gSavedSettings, "AvatarAnimationLODPixelArea");
+		S32 anim_lod = LLCharacter::ANIM_LOD_FULL;
+		F32 area = anim_lod_area;
+		while (area > 0.f && anim_lod < LLCharacter::ANIM_LOD_LOWEST && mPixelArea < area)
+		{
+			anim_lod++;
+			area *= 0.25f;
+		}
+		setAnimationLOD(anim_lod);
+
+		if (anim_lod > LLCharacter::ANIM_LOD_FULL)
+		{ // snap to whole 60hz frames so the step doesn't follow every frame rate wobble
+			F32 frame_time = 1.f / llclamp(gFPSClamped, 10.f, 60.f);
+			F32 lod_step = llround((F32) (1 << anim_lod) * frame_time, 1.f / 60.f);
+			time_step = llmax(time_step, lod_step);
+		}
 		if (time_step != 0.f)
 		{
 			// disable walk motion servo controller as it doesn't work with motion timesteps
@@ -3811,7 +3869,26 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 	if (mSpecialRenderMode == 1) // Animation Preview
 		updateMotions(LLCharacter::FORCE_UPDATE);
 	else
-		updateMotions(LLCharacter::NORMAL_UPDATE);
+		updateMotions(LLCharacter::NORMAL_UPDATE, sDeferredUpdates && !isSelf() && !mIsDummy);
+
+	if (mMotionController.hasPendingBlend())
+	{ //pose blend and joint update are batched with other avatars
+		sDeferredUpdates->push_back(this);
+		return TRUE;
+	}
+
+	finishCharacterUpdate();
+
+	return TRUE;
+}
+
+//------------------------------------------------------------------------
+// finishCharacterUpdate()
+// everything in updateCharacter that needs the blended pose
+//------------------------------------------------------------------------
+void LLVOAvatar::finishCharacterUpdate()
+{
+	LLVector3 normal;
 
 	// update head position
 	updateHeadOffset();
@@ -3912,8 +3989,6 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 
 	//mesh vertices need to be reskinned
 	mNeedsSkin = TRUE;
-
-	return TRUE;
 }
 //-----------------------------------------------------------------------------
 // updateHeadOffset()
@@ -4123,6 +4198,57 @@ bool LLVOAvatar::shouldAlphaMask()
 
 }
 
+// Palettes not used for this many frames go when a new one is added
+const U32 SKINNING_PALETTE_MAX_IDLE_FRAMES = 256;
+
+const LLMatrix4* LLVOAvatar::getSkinningMatrixPalette(const LLMeshSkinInfo* skin, U32& count)
+{
+	const U32 frame = LLFrameTimer::getFrameCount();
+
+	skinning_palette_map_t::iterator iter = mSkinningPalettes.find(skin->mMeshID);
+	if (iter == mSkinningPalettes.end())
+	{
+		for (skinning_palette_map_t::iterator stale = mSkinningPalettes.begin(); stale != mSkinningPalettes.end(); )
+		{
+			if (frame - stale->second.mFrame > SKINNING_PALETTE_MAX_IDLE_FRAMES)
+			{
+				mSkinningPalettes.erase(stale++);
+			}
+			else
+			{
+				++stale;
+			}
+		}
+
+		iter = mSkinningPalettes.insert(std::make_pair(skin->mMeshID, SkinningPalette())).first;
+		SkinningPalette& palette = iter->second;
+		palette.mFrame = frame - 1;
+		palette.mJoints.resize(skin->mJointNames.size());
+		palette.mMatrices.resize(skin->mJointNames.size());
+		for (U32 i = 0; i < skin->mJointNames.size(); ++i)
+		{
+			palette.mJoints[i] = getJoint(skin->mJointNames[i]);
+		}
+	}
+
+	SkinningPalette& palette = iter->second;
+	count = palette.mMatrices.size();
+	if (palette.mFrame != frame)
+	{
+		palette.mFrame = frame;
+		for (U32 i = 0; i < count; ++i)
+		{
+			if (palette.mJoints[i])
+			{
+				palette.mMatrices[i] = skin->mInvBindMatrix[i];
+				palette.mMatrices[i] *= palette.mJoints[i]->getWorldMatrix();
+			}
+		}
+	}
+
+	return count ? &palette.mMatrices[0] : NULL;
+}
+
 U32 LLVOAvatar::renderSkinnedAttachments()
 {
 	/*U32 num_indices = 0;
@@ -4444,7 +4570,9 @@ U32 LLVOAvatar::renderRigid()
 
 U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
 {
-	if (!mImpostor.isComplete())
+	bool use_atlas = mImpostorSlot >= 0 && gPipeline.mImpostorAtlas.isComplete();
+
+	if (!use_atlas && !mImpostor.isComplete())
 	{
 		return 0;
 	}
@@ -4458,22 +4586,41 @@ U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
 	left *= mImpostorDim.mV[0];
 	up *= mImpostorDim.mV[1];
 
-	LLGLEnable test(GL_ALPHA_TEST);
+	LLVector2 tc_min(0,0);
+	LLVector2 tc_max(1,1);
+
+	if (use_atlas)
+	{ //atlas impostors are only drawn with shaders, which do their own alpha rejection,
+	  //and share one texture so consecutive impostors batch into a single draw
+		gPipeline.mImpostorAtlas.touchSlot(mImpostorSlot);
+		gPipeline.mImpostorAtlas.mTarget.bindTexture(0, diffuse_channel);
+		tc_min = mImpostorTexCoords[0];
+		tc_max = mImpostorTexCoords[1];
+	}
+	else
+	{
+		gGL.getTexUnit(diffuse_channel)->bind(&mImpostor);
+	}
+
+	LLGLEnable test(use_atlas ? 0 : GL_ALPHA_TEST);
 	gGL.setAlphaRejectSettings(LLRender::CF_GREATER, 0.f);
 
 	gGL.color4ubv(color.mV);
-	gGL.getTexUnit(diffuse_channel)->bind(&mImpostor);
 	gGL.begin(LLRender::QUADS);
-	gGL.texCoord2f(0,0);
+	gGL.texCoord2f(tc_min.mV[0],tc_min.mV[1]);
 	gGL.vertex3fv((pos+left-up).mV);
-	gGL.texCoord2f(1,0);
+	gGL.texCoord2f(tc_max.mV[0],tc_min.mV[1]);
 	gGL.vertex3fv((pos-left-up).mV);
-	gGL.texCoord2f(1,1);
+	gGL.texCoord2f(tc_max.mV[0],tc_max.mV[1]);
 	gGL.vertex3fv((pos-left+up).mV);
-	gGL.texCoord2f(0,1);
+	gGL.texCoord2f(tc_min.mV[0],tc_max.mV[1]);
 	gGL.vertex3fv((pos+left+up).mV);
 	gGL.end();
-	gGL.flush();
+
+	if (!use_atlas)
+	{
+		gGL.flush();
+	}
 
 	return 6;
 }
@@ -6551,6 +6698,11 @@ BOOL LLVOAvatar::processFullyLoadedChange(bool loading)
 	
 	mFullyLoaded = (mFullyLoadedTimer.getElapsedTimeF32() > PAUSE);
 
+	if (mFullyLoaded)
+	{
+		recordRezStage(REZ_FULLY_LOADED);
+	}
+
 	if (gSavedSettings.getBOOL("DebugAvatarRezTime"))
 	{
 		if (!mPreviousFullyLoaded && !loading && mFullyLoaded)
@@ -6613,6 +6765,9 @@ LLMotion* LLVOAvatar::findMotion(const LLUUID& id) const
 void LLVOAvatar::updateMeshTextures()
 {
     // llinfos << "updateMeshTextures" << llendl;
+	// appearance changed, impostor needs to be regenerated
+	mNeedsImpostorUpdate = TRUE;
+
 	// if user has never specified a texture, assign the default
 	for (U32 i=0; i < getNumTEs(); i++)
 	{
@@ -6710,6 +6865,7 @@ void LLVOAvatar::updateMeshTextures()
 				}
 				baked_img->setLoadedCallback(onBakedTextureLoaded, SWITCH_TO_BAKED_DISCARD, FALSE, FALSE, new LLUUID( mID ), 
 					src_callback_list, paused );
+				recordRezStage(REZ_BAKES_REQUESTED);
 			}
 		}
 		else if (mBakedTextureDatas[i].mTexLayerSet 
@@ -6845,7 +7001,7 @@ BOOL LLVOAvatar::morphMaskNeedsUpdate(LLVOAvatarDefines::EBakedTextureIndex inde
 	return FALSE;
 }
 
-void LLVOAvatar::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components, LLVOAvatarDefines::EBakedTextureIndex index)
+void LLVOAvatar::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components, LLVOAvatarDefines::EBakedTextureIndex index, U32 mask_crc)
 {
 	if (index >= BAKED_NUM_INDICES)
 	{
@@ -6853,6 +7009,13 @@ void LLVOAvatar::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_com
 		return;
 	}
 
+	if (mask_crc && mask_crc == mBakedTextureDatas[index].mMorphMaskCRC)
+	{
+		// the morphs already have this mask
+		return;
+	}
+	mBakedTextureDatas[index].mMorphMaskCRC = mask_crc;
+
 	for (morph_list_t::const_iterator iter = mBakedTextureDatas[index].mMaskedMorphs.begin();
 		 iter != mBakedTextureDatas[index].mMaskedMorphs.end(); ++iter)
 	{
@@ -6862,6 +7025,14 @@ void LLVOAvatar::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_com
 }
 
 
+void LLVOAvatar::invalidateMorphMaskCRC(LLVOAvatarDefines::EBakedTextureIndex index)
+{
+	if (index < BAKED_NUM_INDICES)
+	{
+		mBakedTextureDatas[index].mMorphMaskCRC = 0;
+	}
+}
+
 //-----------------------------------------------------------------------------
 // releaseComponentTextures()
 // release any component texture UUIDs for which we have a baked texture
@@ -7168,6 +7339,7 @@ void LLVOAvatar::onFirstTEMessageReceived()
 	if( !mFirstTEMessageReceived )
 	{
 		mFirstTEMessageReceived = TRUE;
+		recordRezStage(REZ_FIRST_TE);
 
 		LLLoadedCallbackEntry::source_callback_list_t* src_callback_list = NULL ;
 		BOOL paused = FALSE ;
@@ -7614,9 +7786,66 @@ void LLVOAvatar::useBakedTexture( const LLUUID& id )
 		}
 	}
 
+	if (getRezStageTime(REZ_BAKES_DECODED) < 0.f)
+	{
+		bool all_loaded = true;
+		for (U32 i = 0; i < mBakedTextureDatas.size(); i++)
+		{
+			if (isTextureDefined(mBakedTextureDatas[i].mTextureIndex)
+				&& ( (i != BAKED_SKIRT) || isWearingWearableType(LLWearableType::WT_SKIRT) )
+				&& !mBakedTextureDatas[i].mIsLoaded)
+			{
+				all_loaded = false;
+				break;
+			}
+		}
+		if (all_loaded)
+		{
+			recordRezStage(REZ_BAKES_DECODED);
+		}
+	}
+
 	dirtyMesh();
 }
 
+void LLVOAvatar::recordRezStage(ERezStage stage)
+{
+	if (mRezStageTimes[stage] >= 0.f)
+	{
+		return;
+	}
+
+	mRezStageTimes[stage] = mRezStageTimer.getElapsedTimeF32();
+
+	static LLCachedControl<bool> debug_avatar_rez_time(gSavedSettings, "DebugAvatarRezTime");
+	if (debug_avatar_rez_time)
+	{
+		llinfos << "REZTIME: [ " << mRezStageTimes[stage] << "sec ] Avatar '" << getFullname() << "' reached " << getRezStageName(stage) << llendl;
+	}
+
+#if LL_RECORD_VIEWER_STATS
+	if (stage == REZ_FULLY_LOADED && LLViewerStatsRecorder::instance())
+	{
+		LLViewerStatsRecorder::instance()->recordAvatarRezTimes(this);
+	}
+#endif
+}
+
+// static
+const char* LLVOAvatar::getRezStageName(ERezStage stage)
+{
+	static const char* stage_names[REZ_STAGE_COUNT] =
+	{
+		"first TE",
+		"bakes requested",
+		"bakes decoded",
+		"rigged mesh loaded",
+		"skin info loaded",
+		"fully loaded"
+	};
+	return stage_names[stage];
+}
+
 // static
 void LLVOAvatar::dumpArchetypeXML( void* )
 {
@@ -7859,6 +8088,7 @@ BOOL LLVOAvatarBoneInfo::parseXml(LLXmlTreeNode* node)
 		llwarns << "Bone without rotation" << llendl;
 		return FALSE;
 	}
+	mRotQuat = mayaQ(mRot.mV[VX], mRot.mV[VY], mRot.mV[VZ], LLQuaternion::XYZ);
 	
 	static LLStdStringHandle scale_string = LLXmlTree::addAttributeString("scale");
 	if (!node->getFastAttributeVector3(scale_string, mScale))
@@ -8336,6 +8566,77 @@ void LLVOAvatar::updateFreezeCounter(S32 counter)
 	}
 }
 
+static LLFastTimer::DeclareTimer FTM_AVATAR_DEFERRED_POSE("Avatar Pose Blend");
+
+class LLAvatarPoseBody : public LLParallelFor::Body
+{
+public:
+	LLAvatarPoseBody(const std::vector<LLPointer<LLVOAvatar> >& avatars)
+		: mAvatars(avatars) { }
+
+	/*virtual*/ void run(U32 index)
+	{
+		LLVOAvatar* avatar = mAvatars[index];
+		avatar->getMotionController().applyPendingBlend();
+		avatar->getRootJoint()->updateWorldMatrixChildren();
+	}
+
+	const std::vector<LLPointer<LLVOAvatar> >& mAvatars;
+};
+
+//static
+void LLVOAvatar::beginDeferredUpdates()
+{
+	static LLCachedControl<bool> parallel_update(gSavedSettings, "AvatarParallelUpdate");
+	static std::vector<LLPointer<LLVOAvatar> > deferred;
+
+	if (parallel_update && gPipeline.getRenderWorkers() && !sDeferredUpdates)
+	{
+		deferred.clear();
+		sDeferredUpdates = &deferred;
+	}
+
+	LLPhysicsMotionController::beginBatch();
+}
+
+//static
+void LLVOAvatar::finishDeferredUpdates()
+{
+	LLPhysicsMotionController::finishBatch();
+
+	if (!sDeferredUpdates)
+	{
+		return;
+	}
+
+	std::vector<LLPointer<LLVOAvatar> >& avatars = *sDeferredUpdates;
+	sDeferredUpdates = NULL;
+
+	if (avatars.empty())
+	{
+		return;
+	}
+
+	{ //each skeleton is independent, blend and transform them all at once
+		LLFastTimer t(FTM_AVATAR_DEFERRED_POSE);
+		LLAvatarPoseBody body(avatars);
+		gPipeline.getRenderWorkers()->run(body, avatars.size());
+	}
+
+	for (U32 i = 0; i < avatars.size(); ++i)
+	{
+		LLVOAvatar* avatar = avatars[i];
+		if (!avatar->isDead())
+		{
+			LLFastTimer t(FTM_AVATAR_UPDATE);
+			avatar->finishCharacterUpdate();
+			avatar->finishIdleUpdate(TRUE, avatar->mDeferredRootPosLast);
+		}
+	}
+
+	avatars.clear();
+}
+
 BOOL LLVOAvatar::updateLOD()
 {
 	if (isImpostor())
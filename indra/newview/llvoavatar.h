@@ -68,6 +68,7 @@ class LLHUDEffectSpiral;
 class LLTexGlobalColor;
 class LLVOAvatarBoneInfo;
 class LLVOAvatarSkeletonInfo;
+class LLMeshSkinInfo;
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // LLVOAvatar
@@ -224,6 +225,8 @@ private:
 	//--------------------------------------------------------------------
 public:
 	virtual BOOL 	updateCharacter(LLAgent &agent);
+	void			finishCharacterUpdate();
+	void			finishIdleUpdate(BOOL detailed_update, const LLVector3& root_pos_last);
 	void 			idleUpdateVoiceVisualizer(bool voice_enabled);
 	void 			idleUpdateMisc(bool detailed_update);
 	virtual void	idleUpdateAppearanceAnimation();
@@ -387,6 +390,9 @@ public:
 	U32 		renderRigid();
 	U32 		renderSkinned(EAvatarRenderPass pass);
 	F32			getLastSkinTime() { return mLastSkinTime; }
+	// Joint matrix palette of skin on this skeleton, built at most once a
+	// frame and shared by every rigged face using that skin.
+	const LLMatrix4* getSkinningMatrixPalette(const LLMeshSkinInfo* skin, U32& count);
 	U32			renderSkinnedAttachments();
 	U32 		renderTransparent(BOOL first_pass);
 	void 		renderCollisionVolumes();
@@ -404,6 +410,15 @@ private:
 	BOOL 		mNeedsSkin; // avatar has been animated and verts have not been updated
 	F32			mLastSkinTime; //value of gFrameTimeSeconds at last skin update
 
+	struct SkinningPalette
+	{
+		U32 mFrame; // LLFrameTimer frame count when mMatrices was built
+		std::vector<LLJoint*> mJoints; // resolved once, joints live as long as the avatar
+		std::vector<LLMatrix4> mMatrices;
+	};
+	typedef std::map<LLUUID, SkinningPalette> skinning_palette_map_t;
+	skinning_palette_map_t mSkinningPalettes; // by mesh id
+
 	S32	 		mUpdatePeriod;
 	S32  		mNumInitFaces; //number of faces generated when creating the avatar drawable, does not inculde splitted faces due to long vertex buffer.
 
@@ -413,7 +428,9 @@ private:
 public:
 	BOOL 		morphMaskNeedsUpdate(LLVOAvatarDefines::EBakedTextureIndex index = LLVOAvatarDefines::BAKED_NUM_INDICES);
 	void 		addMaskedMorph(LLVOAvatarDefines::EBakedTextureIndex index, LLPolyMorphTarget* morph_target, BOOL invert, std::string layer);
-	void 		applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components, LLVOAvatarDefines::EBakedTextureIndex index = LLVOAvatarDefines::BAKED_NUM_INDICES);
+	// mask_crc identifies the mask contents, a mask with the same non-zero crc as the last one applied is skipped
+	void 		applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components, LLVOAvatarDefines::EBakedTextureIndex index = LLVOAvatarDefines::BAKED_NUM_INDICES, U32 mask_crc = 0);
+	void		invalidateMorphMaskCRC(LLVOAvatarDefines::EBakedTextureIndex index);
 
 	//--------------------------------------------------------------------
 	// Visibility
@@ -450,6 +467,8 @@ public:
 	static void updateImpostors();
 	LLRenderTarget mImpostor;
 	BOOL		mNeedsImpostorUpdate;
+	S32			mImpostorSlot; // slot in gPipeline.mImpostorAtlas, or -1 if using mImpostor
+	LLVector2	mImpostorTexCoords[2]; // min and max corners of mImpostorSlot
 private:
 	LLVector3	mImpostorOffset;
 	LLVector2	mImpostorDim;
@@ -492,6 +511,19 @@ public:
 private:
 	static S32  sFreezeCounter;
 
+	//--------------------------------------------------------------------
+	// Deferred animation
+	//--------------------------------------------------------------------
+public:
+	// Between these calls avatars other than self leave their pose blend and joint
+	// update for finishDeferredUpdates, which runs them on the render workers and
+	// then completes each avatar's idle update on the main thread
+	static void beginDeferredUpdates();
+	static void finishDeferredUpdates();
+private:
+	static std::vector<LLPointer<LLVOAvatar> >* sDeferredUpdates;
+	LLVector3	mDeferredRootPosLast;
+
 	//--------------------------------------------------------------------
 	// Constants
 	//--------------------------------------------------------------------
@@ -543,6 +575,7 @@ protected:
 		bool								mIsUsed;
 		LLVOAvatarDefines::ETextureIndex 	mTextureIndex;
 		U32									mMaskTexName;
+		U32									mMorphMaskCRC; // crc of the mask last applied to mMaskedMorphs, 0 if unknown
 		// Stores pointers to the joint meshes that this baked texture deals with
 		std::vector< LLViewerJointMesh * > 	mMeshes;  // std::vector<LLViewerJointMesh> mJoints[i]->mMeshParts
 		morph_list_t						mMaskedMorphs;
@@ -984,9 +1017,27 @@ private:
 	//--------------------------------------------------------------------
 public:
 	F32				debugGetExistenceTimeElapsedF32() const { return mDebugExistenceTimer.getElapsedTimeF32(); }
+
+	enum ERezStage
+	{
+		REZ_FIRST_TE = 0,
+		REZ_BAKES_REQUESTED,
+		REZ_BAKES_DECODED,		// every worn bake is loaded
+		REZ_RIGGED_MESH_LOADED,	// first rigged mesh attachment
+		REZ_SKIN_INFO_LOADED,	// first skin info for a rigged mesh attachment
+		REZ_FULLY_LOADED,
+		REZ_STAGE_COUNT
+	};
+	// Remembers the first time the avatar reaches stage
+	void			recordRezStage(ERezStage stage);
+	// Seconds from creation to stage, negative until it is reached
+	F32				getRezStageTime(ERezStage stage) const { return mRezStageTimes[stage]; }
+	static const char* getRezStageName(ERezStage stage);
 protected:
 	LLFrameTimer	mRuthDebugTimer; // For tracking how long it takes for av to rez
 	LLFrameTimer	mDebugExistenceTimer; // Debugging for how long the avatar has been in memory.
+	LLFrameTimer	mRezStageTimer; // Never reset, unlike mDebugExistenceTimer
+	F32				mRezStageTimes[REZ_STAGE_COUNT];
 
 /**                    Diagnostics
  **                                                                            **
@@ -27,7 +27,8 @@
 #include "llviewerprecompiledheaders.h"
 #include "llvocache.h"
 #include "llerror.h"
-#include "llregionhandle.h"
+#include "llthread.h"
+#include "lltimer.h"	// ms_sleep()
 #include "llviewercontrol.h"
 
 BOOL check_read(LLAPRFile* apr_file, void* src, S32 n_bytes) 
@@ -51,7 +52,8 @@ LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &
 	mCRC(crc),
 	mHitCount(0),
 	mDupeCount(0),
-	mCRCChangeCount(0)
+	mCRCChangeCount(0),
+	mDirty(TRUE)
 {
 	mBuffer = new U8[dp.getBufferSize()];
 	mDP.assignBuffer(mBuffer, dp.getBufferSize());
@@ -65,13 +67,15 @@ LLVOCacheEntry::LLVOCacheEntry()
 	mHitCount(0),
 	mDupeCount(0),
 	mCRCChangeCount(0),
-	mBuffer(NULL)
+	mBuffer(NULL),
+	mDirty(FALSE)
 {
 	mDP.assignBuffer(mBuffer, 0);
 }
 
 LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
-	: mBuffer(NULL)
+	: mBuffer(NULL),
+	  mDirty(FALSE)
 {
 	S32 size = -1;
 	BOOL success;
@@ -150,6 +154,7 @@ void LLVOCacheEntry::assignCRC(U32 crc, LLDataPackerBinaryBuffer &dp)
 		mCRC = crc;
 		mHitCount = 0;
 		mCRCChangeCount++;
+		mDirty = TRUE;
 
 		mDP.freeBuffer();
 		mBuffer = new U8[dp.getBufferSize()];
@@ -224,17 +229,60 @@ BOOL LLVOCacheEntry::writeToFile(LLAPRFile* apr_file) const
 //-------------------------------------------------------------------
 //LLVOCache
 //-------------------------------------------------------------------
-// Format string used to construct filename for the object cache
-static const char OBJECT_CACHE_FILENAME[] = "objects_%d_%d.slc";
-
 const U32 MAX_NUM_OBJECT_ENTRIES = 128 ;
 const U32 MIN_ENTRIES_TO_PURGE = 16 ;
 const U32 INVALID_TIME = 0 ;
+const S32 MIN_LOG_SIZE_TO_COMPACT = 4 * 1024 * 1024 ;
 const char* object_cache_dirname = "objectcache";
 const char* header_filename = "object.cache";
+const char* log_filename = "objects.slc";
+const char* index_filename = "objects.idx";
 
 LLVOCache* LLVOCache::sInstance = NULL;
 
+//-------------------------------------------------------------------
+// Reads one region's records out of the log. The log is only appended to
+// outside of startup compaction, so the offsets it was handed stay valid
+// while the main thread keeps writing other regions.
+class LLVOCache::RegionPrefetch : public LLThread
+{
+public:
+	RegionPrefetch(const std::string& filename, const record_offset_list_t& offsets)
+	:	LLThread("VOCache Prefetch"),
+		mFileName(filename),
+		mOffsets(offsets),
+		mSuccess(false)
+	{
+	}
+
+	~RegionPrefetch()
+	{
+		waitUntilDone();
+		for(LLVOCacheEntry::vocache_entry_map_t::iterator iter = mEntries.begin(); iter != mEntries.end(); ++iter)
+		{
+			delete iter->second;
+		}
+	}
+
+	void waitUntilDone()
+	{
+		while(!isStopped())
+		{
+			ms_sleep(1);
+		}
+	}
+
+	/*virtual*/ void run()
+	{
+		mSuccess = LLVOCache::readRecords(mFileName, getLocalAPRFilePool(), mOffsets, mEntries);
+	}
+
+	std::string mFileName;
+	record_offset_list_t mOffsets;
+	LLVOCacheEntry::vocache_entry_map_t mEntries;
+	bool mSuccess;
+};
+
 //static 
 LLVOCache* LLVOCache::getInstance() 
 {	
@@ -265,7 +313,8 @@ LLVOCache::LLVOCache():
 	mInitialized(FALSE),
 	mReadOnly(TRUE),
 	mNumEntries(0),
-	mCacheSize(1)
+	mCacheSize(1),
+	mLogGeneration(0)
 {
 	mEnabled = gSavedSettings.getBOOL("ObjectCacheEnabled");
 	mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
@@ -275,7 +324,9 @@ LLVOCache::~LLVOCache()
 {
 	if(mEnabled)
 	{
+		clearPrefetches();
 		writeCacheHeader();
+		writeCacheIndex();
 		clearCacheInMemory();
 	}
 	delete mLocalAPRFilePoolp;
@@ -284,6 +335,8 @@ LLVOCache::~LLVOCache()
 void LLVOCache::setDirNames(ELLPath location)
 {
 	mHeaderFileName = gDirUtilp->getExpandedFilename(location, object_cache_dirname, header_filename);
+	mLogFileName = gDirUtilp->getExpandedFilename(location, object_cache_dirname, log_filename);
+	mIndexFileName = gDirUtilp->getExpandedFilename(location, object_cache_dirname, index_filename);
 	mObjectCacheDirName = gDirUtilp->getExpandedFilename(location, object_cache_dirname);
 }
 
@@ -322,7 +375,11 @@ void LLVOCache::initCache(ELLPath location, U32 size, U32 cache_version)
 		{			
 			removeCache();
 		}
-	}	
+	}
+	else
+	{
+		readCacheIndex();
+	}
 }
 	
 void LLVOCache::removeCache(ELLPath location) 
@@ -411,18 +468,8 @@ void LLVOCache::clearCacheInMemory()
 		mHandleEntryMap.clear();
 		mNumEntries = 0 ;
 	}
-
-}
-
-void LLVOCache::getObjectCacheFilename(U64 handle, std::string& filename) 
-{
-	U32 region_x, region_y;
-
-	grid_from_region_handle(handle, &region_x, &region_y);
-	filename = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, object_cache_dirname,
-			   llformat(OBJECT_CACHE_FILENAME, region_x, region_y));
-
-	return ;
+	mRegionIndices.clear();
+	clearPrefetches();
 }
 
 void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
@@ -433,9 +480,8 @@ void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
 		return ;
 	}
 
-	std::string filename;
-	getObjectCacheFilename(entry->mHandle, filename);
-	LLAPRFile::remove(filename, mLocalAPRFilePoolp);
+	//its records stay in the log until the next compaction
+	mRegionIndices.erase(entry->mHandle);
 	entry->mTime = INVALID_TIME ;
 	updateEntry(entry) ; //update the head file.
 }
@@ -583,6 +629,204 @@ BOOL LLVOCache::updateEntry(const HeaderEntryInfo* entry)
 	return check_write(&apr_file, (void*)entry, sizeof(HeaderEntryInfo)) ;
 }
 
+void LLVOCache::readCacheIndex()
+{
+	mRegionIndices.clear();
+
+	bool success = false ;
+	if (LLAPRFile::isExist(mIndexFileName, mLocalAPRFilePoolp) && LLAPRFile::isExist(mLogFileName, mLocalAPRFilePoolp))
+	{
+		U32 log_generation = 0 ;
+		{
+			LLAPRFile log_file(mLogFileName, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
+			success = check_read(&log_file, &log_generation, sizeof(U32)) ;
+		}
+
+		LLAPRFile apr_file(mIndexFileName, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
+
+		U32 generation = 0 ;
+		S32 num_regions = 0 ;
+		success = success && check_read(&apr_file, &generation, sizeof(U32)) ;
+		if(success && generation != log_generation)
+		{
+			llwarns << "Object cache index does not match the log, discarding" << llendl;
+			success = false ;
+		}
+		success = success && check_read(&apr_file, &num_regions, sizeof(S32)) ;
+
+		for(S32 i = 0 ; success && i < num_regions ; i++)
+		{
+			U64 handle = 0 ;
+			RegionIndex region ;
+			S32 num_records = 0 ;
+			success = check_read(&apr_file, &handle, sizeof(U64)) &&
+					  check_read(&apr_file, region.mID.mData, UUID_BYTES) &&
+					  check_read(&apr_file, &num_records, sizeof(S32)) &&
+					  num_records >= 0 ;
+
+			for(S32 j = 0 ; success && j < num_records ; j++)
+			{
+				U32 local_id ;
+				RecordInfo info ;
+				success = check_read(&apr_file, &local_id, sizeof(U32)) &&
+						  check_read(&apr_file, &info, sizeof(RecordInfo)) ;
+				region.mRecords[local_id] = info ;
+			}
+
+			//regions purged from the header since the index was saved are dropped
+			if(success && mHandleEntryMap.find(handle) != mHandleEntryMap.end())
+			{
+				mRegionIndices[handle].mID = region.mID ;
+				mRegionIndices[handle].mRecords.swap(region.mRecords) ;
+			}
+		}
+
+		if(success)
+		{
+			mLogGeneration = log_generation ;
+		}
+		else
+		{
+			llwarns << "Error reading object cache index." << llendl;
+		}
+	}
+
+	if(!success)
+	{
+		//without an index nothing in the log can be found, start it over
+		mRegionIndices.clear();
+		if(!mReadOnly)
+		{
+			if(LLAPRFile::isExist(mLogFileName, mLocalAPRFilePoolp))
+			{
+				LLAPRFile::remove(mLogFileName, mLocalAPRFilePoolp);
+			}
+			if(LLAPRFile::isExist(mIndexFileName, mLocalAPRFilePoolp))
+			{
+				LLAPRFile::remove(mIndexFileName, mLocalAPRFilePoolp);
+			}
+		}
+		return ;
+	}
+
+	if(!mReadOnly)
+	{
+		compactLog() ;
+	}
+}
+
+void LLVOCache::writeCacheIndex()
+{
+	if(!mEnabled || !mInitialized || mReadOnly)
+	{
+		return ;
+	}
+
+	bool success = true ;
+	{
+		LLAPRFile apr_file(mIndexFileName, APR_CREATE|APR_WRITE|APR_TRUNCATE|APR_BINARY, mLocalAPRFilePoolp);
+
+		S32 num_regions = mRegionIndices.size() ;
+		success = check_write(&apr_file, &mLogGeneration, sizeof(U32)) &&
+				  check_write(&apr_file, &num_regions, sizeof(S32)) ;
+
+		for(region_index_map_t::iterator iter = mRegionIndices.begin() ; success && iter != mRegionIndices.end() ; ++iter)
+		{
+			U64 handle = iter->first ;
+			RegionIndex& region = iter->second ;
+			S32 num_records = region.mRecords.size() ;
+			success = check_write(&apr_file, &handle, sizeof(U64)) &&
+					  check_write(&apr_file, region.mID.mData, UUID_BYTES) &&
+					  check_write(&apr_file, &num_records, sizeof(S32)) ;
+
+			for(record_map_t::iterator rec = region.mRecords.begin() ; success && rec != region.mRecords.end() ; ++rec)
+			{
+				U32 local_id = rec->first ;
+				success = check_write(&apr_file, &local_id, sizeof(U32)) &&
+						  check_write(&apr_file, &rec->second, sizeof(RecordInfo)) ;
+			}
+		}
+	}
+
+	if(!success)
+	{
+		llwarns << "Failed to write object cache index, discarding the log." << llendl;
+		LLAPRFile::remove(mIndexFileName, mLocalAPRFilePoolp);
+		LLAPRFile::remove(mLogFileName, mLocalAPRFilePoolp);
+	}
+}
+
+//copy the records that are still indexed into a fresh log once more than
+//half of the current one is dead space.
+void LLVOCache::compactLog()
+{
+	S32 log_size = LLAPRFile::size(mLogFileName, mLocalAPRFilePoolp) ;
+	if(log_size < MIN_LOG_SIZE_TO_COMPACT)
+	{
+		return ;
+	}
+
+	S32 live_size = 0 ;
+	for(region_index_map_t::iterator iter = mRegionIndices.begin() ; iter != mRegionIndices.end() ; ++iter)
+	{
+		for(record_map_t::iterator rec = iter->second.mRecords.begin() ; rec != iter->second.mRecords.end() ; ++rec)
+		{
+			live_size += rec->second.mSize ;
+		}
+	}
+	if(live_size * 2 > log_size)
+	{
+		return ;
+	}
+
+	llinfos << "Compacting object cache log, " << live_size << " of " << log_size << " bytes in use." << llendl;
+
+	std::string tmp_filename = mLogFileName + ".tmp" ;
+	U32 generation = mLogGeneration + 1 ;
+	region_index_map_t new_indices = mRegionIndices ;
+
+	bool success = true ;
+	{
+		LLAPRFile old_file(mLogFileName, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
+		LLAPRFile new_file(tmp_filename, APR_CREATE|APR_WRITE|APR_TRUNCATE|APR_BINARY, mLocalAPRFilePoolp);
+
+		success = check_write(&new_file, &generation, sizeof(U32)) ;
+		U32 offset = sizeof(U32) ;
+
+		std::vector<U8> buffer ;
+		for(region_index_map_t::iterator iter = new_indices.begin() ; success && iter != new_indices.end() ; ++iter)
+		{
+			for(record_map_t::iterator rec = iter->second.mRecords.begin() ; success && rec != iter->second.mRecords.end() ; ++rec)
+			{
+				RecordInfo& info = rec->second ;
+				buffer.resize(info.mSize) ;
+				success = old_file.seek(APR_SET, info.mOffset) == (S32)info.mOffset &&
+						  check_read(&old_file, &buffer[0], info.mSize) &&
+						  check_write(&new_file, &buffer[0], info.mSize) ;
+
+				info.mOffset = offset ;
+				offset += info.mSize ;
+			}
+		}
+	}
+
+	if(success)
+	{
+		success = LLAPRFile::rename(tmp_filename, mLogFileName, mLocalAPRFilePoolp) ;
+	}
+
+	if(!success)
+	{
+		llwarns << "Object cache log compaction failed, keeping the old log." << llendl;
+		LLAPRFile::remove(tmp_filename, mLocalAPRFilePoolp);
+		return ;
+	}
+
+	mLogGeneration = generation ;
+	mRegionIndices.swap(new_indices) ;
+	writeCacheIndex() ;
+}
+
 void LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map) 
 {
 	if(!mEnabled)
@@ -592,56 +836,55 @@ void LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
 	}
 	llassert_always(mInitialized);
 
+	RegionPrefetch* prefetch = NULL ;
+	prefetch_map_t::iterator prefetch_iter = mPrefetches.find(handle) ;
+	if(prefetch_iter != mPrefetches.end())
+	{
+		prefetch = prefetch_iter->second ;
+		mPrefetches.erase(prefetch_iter) ;
+	}
+
 	handle_entry_map_t::iterator iter = mHandleEntryMap.find(handle) ;
 	if(iter == mHandleEntryMap.end()) //no cache
 	{
 		llwarns << "No handle map entry for " << handle << llendl;
+		delete prefetch ;
 		return ;
 	}
 
-	bool success = true ;
+	region_index_map_t::iterator region_iter = mRegionIndices.find(handle) ;
+	if(region_iter == mRegionIndices.end()) //nothing in the log
 	{
-		std::string filename;
-		getObjectCacheFilename(handle, filename);
-		LLAPRFile apr_file(filename, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
-	
-		LLUUID cache_id ;
-		success = check_read(&apr_file, cache_id.mData, UUID_BYTES) ;
-	
-		if(success)
-		{		
-			if(cache_id != id)
-			{
-				llinfos << "Cache ID doesn't match for this region, discarding"<< llendl;
-				success = false ;
-			}
+		delete prefetch ;
+		return ;
+	}
+	const RegionIndex& region = region_iter->second ;
 
-			if(success)
-			{
-				S32 num_entries;
-				success = check_read(&apr_file, &num_entries, sizeof(S32)) ;
-	
-				if(success)
-				{
-					for (S32 i = 0; i < num_entries; i++)
-					{
-						LLVOCacheEntry* entry = new LLVOCacheEntry(&apr_file);
-						if (!entry->getLocalID())
-						{
-							llwarns << "Aborting cache file load for " << filename << ", cache file corruption!" << llendl;
-							delete entry ;
-							success = false ;
-							break ;
-						}
-						cache_entry_map[entry->getLocalID()] = entry;
-					}
-				}
-			}
-		}		
+	bool success = true ;
+	if(region.mID != id)
+	{
+		llinfos << "Cache ID doesn't match for this region, discarding"<< llendl;
+		success = false ;
 	}
+	else if(prefetch)
+	{
+		//usually long done by the time the handshake arrives
+		prefetch->waitUntilDone() ;
+		success = prefetch->mSuccess ;
+		cache_entry_map.insert(prefetch->mEntries.begin(), prefetch->mEntries.end()) ;
+		prefetch->mEntries.clear() ;
+	}
+	else
+	{
+		record_offset_list_t offsets ;
+		getRecordOffsets(region, offsets) ;
+		success = readRecords(mLogFileName, mLocalAPRFilePoolp, offsets, cache_entry_map) ;
+	}
+	delete prefetch ;
 	
 	if(!success)
 	{
+		llwarns << "Aborting cache load for handle " << handle << ", cache file corruption!" << llendl;
 		if(cache_entry_map.empty())
 		{
 			removeEntry(iter->second) ;
@@ -650,6 +893,83 @@ void LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
 
 	return ;
 }
+
+void LLVOCache::prefetchRegion(U64 handle)
+{
+	if(!mEnabled || !mInitialized)
+	{
+		return ;
+	}
+
+	if(mPrefetches.find(handle) != mPrefetches.end() ||
+	   mHandleEntryMap.find(handle) == mHandleEntryMap.end())
+	{
+		return ;
+	}
+
+	region_index_map_t::iterator region_iter = mRegionIndices.find(handle) ;
+	if(region_iter == mRegionIndices.end() || region_iter->second.mRecords.empty())
+	{
+		return ;
+	}
+
+	record_offset_list_t offsets ;
+	getRecordOffsets(region_iter->second, offsets) ;
+
+	RegionPrefetch* prefetch = new RegionPrefetch(mLogFileName, offsets) ;
+	mPrefetches[handle] = prefetch ;
+	prefetch->start() ;
+}
+
+void LLVOCache::clearPrefetches()
+{
+	for(prefetch_map_t::iterator iter = mPrefetches.begin() ; iter != mPrefetches.end() ; ++iter)
+	{
+		delete iter->second ;
+	}
+	mPrefetches.clear() ;
+}
+
+//static
+//sorted by offset so that the log is read front to back
+void LLVOCache::getRecordOffsets(const RegionIndex& region, record_offset_list_t& offsets)
+{
+	offsets.clear() ;
+	offsets.reserve(region.mRecords.size()) ;
+	for(record_map_t::const_iterator rec = region.mRecords.begin() ; rec != region.mRecords.end() ; ++rec)
+	{
+		offsets.push_back(std::make_pair(rec->second.mOffset, rec->first)) ;
+	}
+	std::sort(offsets.begin(), offsets.end()) ;
+}
+
+//static
+//called from prefetch threads as well, so only touches its arguments
+bool LLVOCache::readRecords(const std::string& filename, LLVolatileAPRPool* pool, const record_offset_list_t& offsets, 
+							LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
+{
+	LLAPRFile apr_file(filename, APR_READ|APR_BINARY, pool);
+	if(!apr_file.getFileHandle())
+	{
+		return false ;
+	}
+
+	for(U32 i = 0 ; i < offsets.size() ; i++)
+	{
+		LLVOCacheEntry* entry = NULL ;
+		if(apr_file.seek(APR_SET, offsets[i].first) == (S32)offsets[i].first)
+		{
+			entry = new LLVOCacheEntry(&apr_file);
+		}
+		if(!entry || entry->getLocalID() != offsets[i].second)
+		{
+			delete entry ;
+			return false ;
+		}
+		cache_entry_map[entry->getLocalID()] = entry;
+	}
+	return true ;
+}
 	
 void LLVOCache::purgeEntries(U32 size)
 {
@@ -721,26 +1041,51 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
 		return ; //nothing changed, no need to update.
 	}
 
-	//write to cache file
+	//append the changed entries to the log, the rest keep their old records
+	RegionIndex& region = mRegionIndices[handle] ;
+	if(region.mID != id)
+	{
+		region.mID = id ;
+		region.mRecords.clear() ;
+	}
+
 	bool success = true ;
 	{
-		std::string filename;
-		getObjectCacheFilename(handle, filename);
-		LLAPRFile apr_file(filename, APR_CREATE|APR_WRITE|APR_BINARY, mLocalAPRFilePoolp);
-	
-		success = check_write(&apr_file, (void*)id.mData, UUID_BYTES) ;
+		LLAPRFile apr_file(mLogFileName, APR_CREATE|APR_WRITE|APR_BINARY, mLocalAPRFilePoolp);
 
-	
-		if(success)
+		S32 offset = apr_file.seek(APR_END, 0) ;
+		success = offset >= 0 ;
+		if(success && offset == 0) //new log
 		{
-			S32 num_entries = cache_entry_map.size() ;
-			success = check_write(&apr_file, &num_entries, sizeof(S32));
-	
-			for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
+			success = check_write(&apr_file, &mLogGeneration, sizeof(U32)) ;
+			offset = sizeof(U32) ;
+		}
+
+		record_map_t records ;
+		for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
+		{
+			LLVOCacheEntry* cache_entry = iter->second ;
+			record_map_t::iterator rec = region.mRecords.find(iter->first) ;
+			if(!cache_entry->isDirty() && rec != region.mRecords.end())
+			{
+				records[iter->first] = rec->second ;
+				continue ;
+			}
+
+			success = cache_entry->writeToFile(&apr_file) ;
+			if(success)
 			{
-				success = iter->second->writeToFile(&apr_file) ;
+				S32 end = apr_file.seek(APR_CUR, 0) ;
+				RecordInfo& info = records[iter->first] ;
+				info.mOffset = offset ;
+				info.mSize = end - offset ;
+				offset = end ;
+				cache_entry->clearDirty() ;
 			}
 		}
+
+		//entries the region dropped since the last write fall out of the index here
+		region.mRecords.swap(records) ;
 	}
 
 	if(!success)
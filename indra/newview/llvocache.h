@@ -27,6 +27,8 @@
 #ifndef LL_LLVOCACHE_H
 #define LL_LLVOCACHE_H
 
+#include <boost/unordered_map.hpp>
+
 #include "lluuid.h"
 #include "lldatapacker.h"
 #include "lldlinked.h"
@@ -57,8 +59,13 @@ public:
 	void recordHit();
 	void recordDupe() { mDupeCount++; }
 
+	// Dirty entries have not been written to the object cache log yet
+	BOOL isDirty() const			{ return mDirty; }
+	void clearDirty()				{ mDirty = FALSE; }
+
 public:
-	typedef std::map<U32, LLVOCacheEntry*>	vocache_entry_map_t;
+	// hashed, a region's whole ObjectUpdateCached packet is probed against it
+	typedef boost::unordered_map<U32, LLVOCacheEntry*>	vocache_entry_map_t;
 
 protected:
 	U32							mLocalID;
@@ -68,11 +75,17 @@ protected:
 	S32							mCRCChangeCount;
 	LLDataPackerBinaryBuffer	mDP;
 	U8							*mBuffer;
+	BOOL						mDirty;
 };
 
 //
 //Note: LLVOCache is not thread-safe
 //
+//Object records for every region are appended to a single log file, and a
+//per-region index of record offsets is kept in memory and saved on exit.
+//Leaving a region only appends the entries that changed; records that are
+//no longer indexed are dropped when the log is compacted at startup.
+//
 class LLVOCache
 {
 private:
@@ -105,6 +118,25 @@ private:
 	};
 	typedef std::set<HeaderEntryInfo*, header_entry_less> header_entry_queue_t;
 	typedef std::map<U64, HeaderEntryInfo*> handle_entry_map_t;
+
+	struct RecordInfo
+	{
+		RecordInfo() : mOffset(0), mSize(0) {}
+		U32 mOffset;
+		U32 mSize;
+	};
+	typedef std::map<U32, RecordInfo> record_map_t;	// by local id
+
+	struct RegionIndex
+	{
+		LLUUID       mID;
+		record_map_t mRecords;
+	};
+	typedef std::map<U64, RegionIndex> region_index_map_t;
+	typedef std::vector<std::pair<U32, U32> > record_offset_list_t;	// (offset, local id)
+
+	class RegionPrefetch;
+	typedef std::map<U64, RegionPrefetch*> prefetch_map_t;
 private:
 	LLVOCache() ;
 
@@ -115,6 +147,9 @@ public:
 	void removeCache(ELLPath location) ;
 
 	void readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map) ;
+	// Start reading a region's entries on a worker thread so that they are
+	// ready by the time the region handshakes and calls readFromCache().
+	void prefetchRegion(U64 handle) ;
 	void writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, BOOL dirty_cache) ;
 	void removeEntry(U64 handle) ;
 
@@ -122,11 +157,17 @@ public:
 
 private:
 	void setDirNames(ELLPath location);	
-	// determine the cache filename for the region from the region handle	
-	void getObjectCacheFilename(U64 handle, std::string& filename);
 	void removeFromCache(HeaderEntryInfo* entry);
 	void readCacheHeader();
 	void writeCacheHeader();
+	void readCacheIndex();
+	void writeCacheIndex();
+	void compactLog();
+	void clearPrefetches();
+
+	static void getRecordOffsets(const RegionIndex& region, record_offset_list_t& offsets);
+	static bool readRecords(const std::string& filename, LLVolatileAPRPool* pool, const record_offset_list_t& offsets, 
+							LLVOCacheEntry::vocache_entry_map_t& cache_entry_map);
 	void clearCacheInMemory();
 	void removeCache() ;
 	void removeEntry(HeaderEntryInfo* entry) ;
@@ -141,10 +182,15 @@ private:
 	U32                  mCacheSize;
 	U32                  mNumEntries;
 	std::string          mHeaderFileName ;
+	std::string          mLogFileName ;
+	std::string          mIndexFileName ;
 	std::string          mObjectCacheDirName;
+	U32                  mLogGeneration;	// bumped by compaction, ties the index to the log
 	LLVolatileAPRPool*   mLocalAPRFilePoolp ; 	
 	header_entry_queue_t mHeaderEntryQueue;
 	handle_entry_map_t   mHandleEntryMap;	
+	region_index_map_t   mRegionIndices;
+	prefetch_map_t       mPrefetches;
 
 	static LLVOCache* sInstance ;
 public:
@@ -354,7 +354,10 @@ LLVivoxVoiceClient::LLVivoxVoiceClient() :
 	mCaptureBufferRecording(false),
 	mCaptureBufferRecorded(false),
 	mCaptureBufferPlaying(false),
-	mPlayRequestCount(0)
+	mPlayRequestCount(0),
+
+	mSpeakerManagerDirty(false),
+	mAgentParticipantUpdated(false)
 {	
 	mSpeakerVolume = scale_speaker_volume(0);
 
@@ -651,6 +654,7 @@ void LLVivoxVoiceClient::idle(void* user_data)
 {
 	LLVivoxVoiceClient* self = (LLVivoxVoiceClient*)user_data;
 	self->stateMachine();
+	self->updateSpeakerManager();
 }
 
 std::string LLVivoxVoiceClient::state2string(LLVivoxVoiceClient::state inState)
@@ -3823,23 +3827,11 @@ void LLVivoxVoiceClient::participantUpdatedEvent(
 			 So, we have to call LLSpeakerMgr::update() here. In any case it is better than call it                                                
 			 in LLCallFloater::draw()                                                                                                              
 			 */
-			LLVoiceChannel* voice_cnl = LLVoiceChannel::getCurrentVoiceChannel();
-			
-			// ignore session ID of local chat                                                                                                    
-			if (voice_cnl && voice_cnl->getSessionID().notNull())
+			// The update itself is deferred to updateSpeakerManager() on the next idle.
+			mSpeakerManagerDirty = true;
+			if (gAgent.getID() == participant->mAvatarID)
 			{
-				LLSpeakerMgr* speaker_manager = LLIMModel::getInstance()->getSpeakerManager(voice_cnl->getSessionID());
-				if (speaker_manager)
-				{
-					speaker_manager->update(true);
-
-					// also initialize voice moderate_mode depend on Agent's participant. See EXT-6937.
-					// *TODO: remove once a way to request the current voice channel moderation mode is implemented.
-					if (gAgent.getID() == participant->mAvatarID)
-					{
-						speaker_manager->initVoiceModerateMode();
-					}
-				}
+				mAgentParticipantUpdated = true;
 			}
 		}
 		else
@@ -3853,6 +3845,36 @@ void LLVivoxVoiceClient::participantUpdatedEvent(
 	}
 }
 
+void LLVivoxVoiceClient::updateSpeakerManager()
+{
+	if (!mSpeakerManagerDirty)
+	{
+		return;
+	}
+	mSpeakerManagerDirty = false;
+	bool agent_updated = mAgentParticipantUpdated;
+	mAgentParticipantUpdated = false;
+
+	LLVoiceChannel* voice_cnl = LLVoiceChannel::getCurrentVoiceChannel();
+	
+	// ignore session ID of local chat
+	if (voice_cnl && voice_cnl->getSessionID().notNull())
+	{
+		LLSpeakerMgr* speaker_manager = LLIMModel::getInstance()->getSpeakerManager(voice_cnl->getSessionID());
+		if (speaker_manager)
+		{
+			speaker_manager->update(true);
+
+			// also initialize voice moderate_mode depend on Agent's participant. See EXT-6937.
+			// *TODO: remove once a way to request the current voice channel moderation mode is implemented.
+			if (agent_updated)
+			{
+				speaker_manager->initVoiceModerateMode();
+			}
+		}
+	}
+}
+
 void LLVivoxVoiceClient::buddyPresenceEvent(
 		std::string &uriString, 
 		std::string &alias, 
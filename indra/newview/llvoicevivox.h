@@ -828,6 +828,13 @@ private:
 
 	void notifyParticipantObservers();
 
+	// Participant updates arrive at speech detection rate, one per
+	// participant, so the session's speaker manager is updated once per
+	// idle instead of once per event.
+	void updateSpeakerManager();
+	bool mSpeakerManagerDirty;
+	bool mAgentParticipantUpdated;	// also refresh the moderation mode
+
 	typedef std::set<LLVoiceClientStatusObserver*> status_observer_set_t;
 	status_observer_set_t mStatusObservers;
 	
@@ -340,54 +340,45 @@ void LLVOPartGroup::getGeometry(S32 idx,
 	up.mul(0.5f*part.mScale.mV[1]);
 
 
-	LLVector3 normal = -LLViewerCamera::getInstance()->getXAxis();
-
-	//HACK -- the verticesp->mV[3] = 0.f here are to set the texture index to 0 (particles don't use texture batching, maybe they should)
-	// this works because there is actually a 4th float stored after the vertex position which is used as a texture index
-	// also, somebody please VECTORIZE THIS
+	const LLVector3 normal = -LLViewerCamera::getInstance()->getXAxis();
 
+	// The 4th float stored after the vertex position is the texture index.
+	// load3() and setCross3() leave w at 0, so every corner below lands on
+	// texture index 0 (particles don't use texture batching) without
+	// touching it again.
 	LLVector4a ppapu;
 	LLVector4a ppamu;
 
 	ppapu.setAdd(part_pos_agent, up);
 	ppamu.setSub(part_pos_agent, up);
 
-	verticesp->setSub(ppapu, right);
-	(*verticesp++).getF32ptr()[3] = 0.f;
-	verticesp->setSub(ppamu, right);
-	(*verticesp++).getF32ptr()[3] = 0.f;
-	verticesp->setAdd(ppapu, right);
-	(*verticesp++).getF32ptr()[3] = 0.f;
-	verticesp->setAdd(ppamu, right);
-	(*verticesp++).getF32ptr()[3] = 0.f;
-
-	//*verticesp++ = part_pos_agent + up - right;
-	//*verticesp++ = part_pos_agent - up - right;
-	//*verticesp++ = part_pos_agent + up + right;
-	//*verticesp++ = part_pos_agent - up + right;
-
-	*colorsp++ = part.mColor;
-	*colorsp++ = part.mColor;
-	*colorsp++ = part.mColor;
-	*colorsp++ = part.mColor;
-
-	*texcoordsp++ = LLVector2(0.f, 1.f);
-	*texcoordsp++ = LLVector2(0.f, 0.f);
-	*texcoordsp++ = LLVector2(1.f, 1.f);
-	*texcoordsp++ = LLVector2(1.f, 0.f);
-
-	*normalsp++   = normal;
-	*normalsp++   = normal;
-	*normalsp++   = normal;
-	*normalsp++   = normal;
-
-	*indicesp++ = vert_offset + 0;
-	*indicesp++ = vert_offset + 1;
-	*indicesp++ = vert_offset + 2;
-
-	*indicesp++ = vert_offset + 1;
-	*indicesp++ = vert_offset + 3;
-	*indicesp++ = vert_offset + 2;
+	(*verticesp++).setSub(ppapu, right);
+	(*verticesp++).setSub(ppamu, right);
+	(*verticesp++).setAdd(ppapu, right);
+	(*verticesp++).setAdd(ppamu, right);
+
+	static const LLVector2 corner_tc[] =
+	{
+		LLVector2(0.f, 1.f),
+		LLVector2(0.f, 0.f),
+		LLVector2(1.f, 1.f),
+		LLVector2(1.f, 0.f)
+	};
+
+	static const U16 quad_indices[] = { 0, 1, 2, 1, 3, 2 };
+
+	const LLColor4U color = part.mColor;
+	for (U32 i = 0; i < 4; ++i)
+	{
+		*colorsp++ = color;
+		*texcoordsp++ = corner_tc[i];
+		*normalsp++ = normal;
+	}
+
+	for (U32 i = 0; i < 6; ++i)
+	{
+		*indicesp++ = vert_offset + quad_indices[i];
+	}
 }
 
 U32 LLVOPartGroup::getPartitionType() const
@@ -327,6 +327,7 @@ LLVOSky::LLVOSky(const LLUUID &id, const LLPCode pcode, LLViewerRegion *regionp)
 	mCloudDensity(0.2f),
 	mWind(0.f),
 	mForceUpdate(FALSE),
+	mCycleParamsGeneration(0),
 	mWorldScale(1.f),
 	mBumpSunDir(0.f, 0.f, 1.f)
 {
@@ -1081,6 +1082,22 @@ BOOL LLVOSky::updateSky()
 	if (mUpdateTimer.getElapsedTimeF32() > 0.001f)
 	{
 		mUpdateTimer.reset();
+
+		if (next_frame == 0 && mInitialized && !mForceUpdate)
+		{
+			// Don't rebuild the sky and environment map tile by tile, and
+			// reupload them, when they'd come out the same as last time.
+			const U32 generation = LLWLParamManager::getInstance()->mCurParams.getGeneration();
+			const LLVector3& sun_direction = gSky.getSunDirection();
+			if (generation == mCycleParamsGeneration && sun_direction == mCycleSunDirection)
+			{
+				calcAtmospherics();
+				return TRUE;
+			}
+			mCycleParamsGeneration = generation;
+			mCycleSunDirection = sun_direction;
+		}
+
 		const S32 frame = next_frame;
 
 		++next_frame;
@@ -585,6 +585,8 @@ protected:
 	BOOL				mForceUpdate;				//flag to force instantaneous update of cubemap
 	LLVector3			mLastLightingDirection;
 	LLColor3			mLastTotalAmbient;
+	U32					mCycleParamsGeneration;		// windlight params the current texture cycle was built from
+	LLVector3			mCycleSunDirection;
 	F32					mAmbientScale;
 	LLColor3			mNightColorShift;
 	F32					mInterpVal;
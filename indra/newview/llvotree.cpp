@@ -74,6 +74,7 @@ F32 LLVOTree::sLODAngles[sMAX_NUM_TREE_LOD_LEVELS] = {30.f, 20.f, 15.f, F_ALMOST
 F32 LLVOTree::sTreeFactor = 1.f;
 
 LLVOTree::SpeciesMap LLVOTree::sSpeciesTable;
+LLVOTree::species_buffer_map_t LLVOTree::sReferenceBuffers;
 S32 LLVOTree::sMaxTreeSpecies = 0;
 
 // Tree variables and functions
@@ -268,6 +269,7 @@ void LLVOTree::initClass()
 //static
 void LLVOTree::cleanupClass()
 {
+	sReferenceBuffers.clear();
 	std::for_each(sSpeciesTable.begin(), sSpeciesTable.end(), DeletePairedPointer());
 }
 
@@ -298,6 +300,7 @@ U32 LLVOTree::processUpdateMessage(LLMessageSystem *mesgsys,
 	// 
 	//  Load Instance-Specific data 
 	//
+	U8 old_species = mSpecies;
 	if (mData)
 	{
 		mSpecies = ((U8 *)mData)[0];
@@ -312,6 +315,12 @@ U32 LLVOTree::processUpdateMessage(LLMessageSystem *mesgsys,
 		}
 	}
 
+	if (mSpecies != old_species)
+	{
+		// pick up the new species' reference geometry on the next rebuild
+		mReferenceBuffer = NULL;
+	}
+
 	//
 	//  Load Species-Specific data 
 	//
@@ -511,319 +520,331 @@ BOOL LLVOTree::updateGeometry(LLDrawable *drawable)
 		face->mCenterAgent = getPositionAgent();
 		face->mCenterLocal = face->mCenterAgent;
 
-		for (lod = 0; lod < sMAX_NUM_TREE_LOD_LEVELS; lod++)
+		// the reference geometry only depends on the species, so trees of
+		// the same kind share one copy
+		species_buffer_map_t::iterator found = sReferenceBuffers.find(mSpecies);
+		if (found != sReferenceBuffers.end())
 		{
-			slices = sLODSlices[lod];
-			sLODVertexOffset[lod] = max_vertices;
-			sLODVertexCount[lod] = slices*slices;
-			sLODIndexOffset[lod] = max_indices;
-			sLODIndexCount[lod] = (slices-1)*(slices-1)*6;
-			max_indices += sLODIndexCount[lod];
-			max_vertices += sLODVertexCount[lod];
+			mReferenceBuffer = found->second;
 		}
+		else
+		{
+			for (lod = 0; lod < sMAX_NUM_TREE_LOD_LEVELS; lod++)
+			{
+				slices = sLODSlices[lod];
+				sLODVertexOffset[lod] = max_vertices;
+				sLODVertexCount[lod] = slices*slices;
+				sLODIndexOffset[lod] = max_indices;
+				sLODIndexCount[lod] = (slices-1)*(slices-1)*6;
+				max_indices += sLODIndexCount[lod];
+				max_vertices += sLODVertexCount[lod];
+			}
 
-		mReferenceBuffer = new LLVertexBuffer(LLDrawPoolTree::VERTEX_DATA_MASK, 0);
-		mReferenceBuffer->allocateBuffer(max_vertices, max_indices, TRUE);
+			mReferenceBuffer = new LLVertexBuffer(LLDrawPoolTree::VERTEX_DATA_MASK, 0);
+			mReferenceBuffer->allocateBuffer(max_vertices, max_indices, TRUE);
 
-		LLStrider<LLVector3> vertices;
-		LLStrider<LLVector3> normals;
-		LLStrider<LLVector2> tex_coords;
-		LLStrider<U16> indicesp;
+			LLStrider<LLVector3> vertices;
+			LLStrider<LLVector3> normals;
+			LLStrider<LLVector2> tex_coords;
+			LLStrider<U16> indicesp;
 
-		mReferenceBuffer->getVertexStrider(vertices);
-		mReferenceBuffer->getNormalStrider(normals);
-		mReferenceBuffer->getTexCoord0Strider(tex_coords);
-		mReferenceBuffer->getIndexStrider(indicesp);
+			mReferenceBuffer->getVertexStrider(vertices);
+			mReferenceBuffer->getNormalStrider(normals);
+			mReferenceBuffer->getTexCoord0Strider(tex_coords);
+			mReferenceBuffer->getIndexStrider(indicesp);
 				
-		S32 vertex_count = 0;
-		S32 index_count = 0;
+			S32 vertex_count = 0;
+			S32 index_count = 0;
 		
-		// First leaf
-		*(normals++) =		LLVector3(-SRR2, -SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 0.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR3, -SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
-		*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(-SRR3, -SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
-		*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR2, -SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 0.f);
-		vertex_count++;
-
-
-		*(indicesp++) = 0;
-		index_count++;
-		*(indicesp++) = 1;
-		index_count++;
-		*(indicesp++) = 2;
-		index_count++;
-
-		*(indicesp++) = 0;
-		index_count++;
-		*(indicesp++) = 3;
-		index_count++;
-		*(indicesp++) = 1;
-		index_count++;
-
-		// Same leaf, inverse winding/normals
-		*(normals++) =		LLVector3(-SRR2, SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 0.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR3, SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
-		*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(-SRR3, SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
-		*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR2, SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 0.f);
-		vertex_count++;
-
-		*(indicesp++) = 4;
-		index_count++;
-		*(indicesp++) = 6;
-		index_count++;
-		*(indicesp++) = 5;
-		index_count++;
-
-		*(indicesp++) = 4;
-		index_count++;
-		*(indicesp++) = 5;
-		index_count++;
-		*(indicesp++) = 7;
-		index_count++;
-
-
-		// next leaf
-		*(normals++) =		LLVector3(SRR2, -SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 0.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR3, SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
-		*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR3, -SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
-		*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(SRR2, SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 0.f);
-		vertex_count++;
-
-		*(indicesp++) = 8;
-		index_count++;
-		*(indicesp++) = 9;
-		index_count++;
-		*(indicesp++) = 10;
-		index_count++;
-
-		*(indicesp++) = 8;
-		index_count++;
-		*(indicesp++) = 11;
-		index_count++;
-		*(indicesp++) = 9;
-		index_count++;
-
-
-		// other side of same leaf
-		*(normals++) =		LLVector3(-SRR2, -SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 0.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(-SRR3, SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
-		*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(-SRR3, -SRR3, SRR3);
-		*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
-		*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 1.f);
-		vertex_count++;
-
-		*(normals++) =		LLVector3(-SRR2, SRR2, 0.f);
-		*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
-		*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 0.f);
-		vertex_count++;
-
-		*(indicesp++) = 12;
-		index_count++;
-		*(indicesp++) = 14;
-		index_count++;
-		*(indicesp++) = 13;
-		index_count++;
-
-		*(indicesp++) = 12;
-		index_count++;
-		*(indicesp++) = 13;
-		index_count++;
-		*(indicesp++) = 15;
-		index_count++;
-
-		// Generate geometry for the cylinders
-
-		// Different LOD's
-
-		// Generate the vertices
-		// Generate the indices
-
-		for (lod = 0; lod < sMAX_NUM_TREE_LOD_LEVELS; lod++)
-		{
-			slices = sLODSlices[lod];
-			F32 base_radius = 0.65f;
-			F32 top_radius = base_radius * sSpeciesTable[mSpecies]->mTaper;
-			//llinfos << "Species " << ((U32) mSpecies) << ", taper = " << sSpeciesTable[mSpecies].mTaper << llendl;
-			//llinfos << "Droop " << mDroop << ", branchlength: " << mBranchLength << llendl;
-			F32 angle = 0;
-			F32 angle_inc = 360.f/(slices-1);
-			F32 z = 0.f;
-			F32 z_inc = 1.f;
-			if (slices > 3)
+			// First leaf
+			*(normals++) =		LLVector3(-SRR2, -SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 0.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR3, -SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
+			*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(-SRR3, -SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
+			*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR2, -SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 0.f);
+			vertex_count++;
+
+
+			*(indicesp++) = 0;
+			index_count++;
+			*(indicesp++) = 1;
+			index_count++;
+			*(indicesp++) = 2;
+			index_count++;
+
+			*(indicesp++) = 0;
+			index_count++;
+			*(indicesp++) = 3;
+			index_count++;
+			*(indicesp++) = 1;
+			index_count++;
+
+			// Same leaf, inverse winding/normals
+			*(normals++) =		LLVector3(-SRR2, SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 0.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR3, SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
+			*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(-SRR3, SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
+			*(vertices++) =		LLVector3(-0.5f*LEAF_WIDTH, 0.f, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR2, SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(0.5f*LEAF_WIDTH, 0.f, 0.f);
+			vertex_count++;
+
+			*(indicesp++) = 4;
+			index_count++;
+			*(indicesp++) = 6;
+			index_count++;
+			*(indicesp++) = 5;
+			index_count++;
+
+			*(indicesp++) = 4;
+			index_count++;
+			*(indicesp++) = 5;
+			index_count++;
+			*(indicesp++) = 7;
+			index_count++;
+
+
+			// next leaf
+			*(normals++) =		LLVector3(SRR2, -SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 0.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR3, SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
+			*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR3, -SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
+			*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(SRR2, SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 0.f);
+			vertex_count++;
+
+			*(indicesp++) = 8;
+			index_count++;
+			*(indicesp++) = 9;
+			index_count++;
+			*(indicesp++) = 10;
+			index_count++;
+
+			*(indicesp++) = 8;
+			index_count++;
+			*(indicesp++) = 11;
+			index_count++;
+			*(indicesp++) = 9;
+			index_count++;
+
+
+			// other side of same leaf
+			*(normals++) =		LLVector3(-SRR2, -SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 0.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(-SRR3, SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_TOP);
+			*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(-SRR3, -SRR3, SRR3);
+			*(tex_coords++) =	LLVector2(LEAF_LEFT, LEAF_TOP);
+			*(vertices++) =		LLVector3(0.f, -0.5f*LEAF_WIDTH, 1.f);
+			vertex_count++;
+
+			*(normals++) =		LLVector3(-SRR2, SRR2, 0.f);
+			*(tex_coords++) =	LLVector2(LEAF_RIGHT, LEAF_BOTTOM);
+			*(vertices++) =		LLVector3(0.f, 0.5f*LEAF_WIDTH, 0.f);
+			vertex_count++;
+
+			*(indicesp++) = 12;
+			index_count++;
+			*(indicesp++) = 14;
+			index_count++;
+			*(indicesp++) = 13;
+			index_count++;
+
+			*(indicesp++) = 12;
+			index_count++;
+			*(indicesp++) = 13;
+			index_count++;
+			*(indicesp++) = 15;
+			index_count++;
+
+			// Generate geometry for the cylinders
+
+			// Different LOD's
+
+			// Generate the vertices
+			// Generate the indices
+
+			for (lod = 0; lod < sMAX_NUM_TREE_LOD_LEVELS; lod++)
 			{
-				z_inc = 1.f/(slices - 3);
-			}
-			F32 radius = base_radius;
-
-			F32 x1,y1;
-			F32 noise_scale = sSpeciesTable[mSpecies]->mNoiseMag;
-			LLVector3 nvec;
+				slices = sLODSlices[lod];
+				F32 base_radius = 0.65f;
+				F32 top_radius = base_radius * sSpeciesTable[mSpecies]->mTaper;
+				//llinfos << "Species " << ((U32) mSpecies) << ", taper = " << sSpeciesTable[mSpecies].mTaper << llendl;
+				//llinfos << "Droop " << mDroop << ", branchlength: " << mBranchLength << llendl;
+				F32 angle = 0;
+				F32 angle_inc = 360.f/(slices-1);
+				F32 z = 0.f;
+				F32 z_inc = 1.f;
+				if (slices > 3)
+				{
+					z_inc = 1.f/(slices - 3);
+				}
+				F32 radius = base_radius;
 
-			const F32 cap_nudge = 0.1f;			// Height to 'peak' the caps on top/bottom of branch
+				F32 x1,y1;
+				F32 noise_scale = sSpeciesTable[mSpecies]->mNoiseMag;
+				LLVector3 nvec;
 
-			const S32 fractal_depth = 5;
-			F32 nvec_scale = 1.f * sSpeciesTable[mSpecies]->mNoiseScale;
-			F32 nvec_scalez = 4.f * sSpeciesTable[mSpecies]->mNoiseScale;
+				const F32 cap_nudge = 0.1f;			// Height to 'peak' the caps on top/bottom of branch
 
-			F32 tex_z_repeat = sSpeciesTable[mSpecies]->mRepeatTrunkZ;
+				const S32 fractal_depth = 5;
+				F32 nvec_scale = 1.f * sSpeciesTable[mSpecies]->mNoiseScale;
+				F32 nvec_scalez = 4.f * sSpeciesTable[mSpecies]->mNoiseScale;
 
-			F32 start_radius;
-			F32 nangle = 0;
-			F32 height = 1.f;
-			F32 r0;
+				F32 tex_z_repeat = sSpeciesTable[mSpecies]->mRepeatTrunkZ;
 
-			for (i = 0; i < slices; i++)
-			{
-				if (i == 0) 
-				{
-					z = - cap_nudge;
-					r0 = 0.0;
-				}
-				else if (i == (slices - 1))
-				{
-					z = 1.f + cap_nudge;//((i - 2) * z_inc) + cap_nudge;
-					r0 = 0.0;
-				}
-				else  
-				{
-					z = (i - 1) * z_inc;
-					r0 = base_radius + (top_radius - base_radius)*z;
-				}
+				F32 start_radius;
+				F32 nangle = 0;
+				F32 height = 1.f;
+				F32 r0;
 
-				for (j = 0; j < slices; j++)
+				for (i = 0; i < slices; i++)
 				{
-					if (slices - 1 == j)
+					if (i == 0) 
 					{
-						angle = 0.f;
+						z = - cap_nudge;
+						r0 = 0.0;
 					}
-					else
+					else if (i == (slices - 1))
 					{
-						angle =  j*angle_inc;
+						z = 1.f + cap_nudge;//((i - 2) * z_inc) + cap_nudge;
+						r0 = 0.0;
 					}
-				
-					nangle = angle;
-					
-					x1 = cos(angle * DEG_TO_RAD);
-					y1 = sin(angle * DEG_TO_RAD);
-					LLVector2 tc;
-					// This isn't totally accurate.  Should compute based on slope as well.
-					start_radius = r0 * (1.f + 1.2f*fabs(z - 0.66f*height)/height);
-					nvec.set(	cos(nangle * DEG_TO_RAD)*start_radius*nvec_scale, 
-								sin(nangle * DEG_TO_RAD)*start_radius*nvec_scale, 
-								z*nvec_scalez); 
-					// First and last slice at 0 radius (to bring in top/bottom of structure)
-					radius = start_radius + turbulence3((F32*)&nvec.mV, (F32)fractal_depth)*noise_scale;
-
-					if (slices - 1 == j)
+					else  
 					{
-						// Not 0.5 for slight slop factor to avoid edges on leaves
-						tc = LLVector2(0.490f, (1.f - z/2.f)*tex_z_repeat);
+						z = (i - 1) * z_inc;
+						r0 = base_radius + (top_radius - base_radius)*z;
 					}
-					else
+
+					for (j = 0; j < slices; j++)
 					{
-						tc = LLVector2((angle/360.f)*0.5f, (1.f - z/2.f)*tex_z_repeat);
+						if (slices - 1 == j)
+						{
+							angle = 0.f;
+						}
+						else
+						{
+							angle =  j*angle_inc;
+						}
+				
+						nangle = angle;
+					
+						x1 = cos(angle * DEG_TO_RAD);
+						y1 = sin(angle * DEG_TO_RAD);
+						LLVector2 tc;
+						// This isn't totally accurate.  Should compute based on slope as well.
+						start_radius = r0 * (1.f + 1.2f*fabs(z - 0.66f*height)/height);
+						nvec.set(	cos(nangle * DEG_TO_RAD)*start_radius*nvec_scale, 
+									sin(nangle * DEG_TO_RAD)*start_radius*nvec_scale, 
+									z*nvec_scalez); 
+						// First and last slice at 0 radius (to bring in top/bottom of structure)
+						radius = start_radius + turbulence3((F32*)&nvec.mV, (F32)fractal_depth)*noise_scale;
+
+						if (slices - 1 == j)
+						{
+							// Not 0.5 for slight slop factor to avoid edges on leaves
+							tc = LLVector2(0.490f, (1.f - z/2.f)*tex_z_repeat);
+						}
+						else
+						{
+							tc = LLVector2((angle/360.f)*0.5f, (1.f - z/2.f)*tex_z_repeat);
+						}
+
+						*(vertices++) =		LLVector3(x1*radius, y1*radius, z);
+						*(normals++) =		LLVector3(x1, y1, 0.f);
+						*(tex_coords++) = tc;
+						vertex_count++;
 					}
-
-					*(vertices++) =		LLVector3(x1*radius, y1*radius, z);
-					*(normals++) =		LLVector3(x1, y1, 0.f);
-					*(tex_coords++) = tc;
-					vertex_count++;
 				}
-			}
 
-			for (i = 0; i < (slices - 1); i++)
-			{
-				for (j = 0; j < (slices - 1); j++)
+				for (i = 0; i < (slices - 1); i++)
 				{
-					S32 x1_offset = j+1;
-					if ((j+1) == slices)
+					for (j = 0; j < (slices - 1); j++)
 					{
-						x1_offset = 0;
+						S32 x1_offset = j+1;
+						if ((j+1) == slices)
+						{
+							x1_offset = 0;
+						}
+						// Generate the matching quads
+						*(indicesp) = j + (i*slices) + sLODVertexOffset[lod];
+						llassert(*(indicesp) < (U32)max_vertices);
+						indicesp++;
+						index_count++;
+						*(indicesp) = x1_offset + ((i+1)*slices) + sLODVertexOffset[lod];
+						llassert(*(indicesp) < (U32)max_vertices);
+						indicesp++;
+						index_count++;
+						*(indicesp) = j + ((i+1)*slices) + sLODVertexOffset[lod];
+						llassert(*(indicesp) < (U32)max_vertices);
+						indicesp++;
+						index_count++;
+
+						*(indicesp) = j + (i*slices) + sLODVertexOffset[lod];
+						llassert(*(indicesp) < (U32)max_vertices);
+						indicesp++;
+						index_count++;
+						*(indicesp) = x1_offset + (i*slices) + sLODVertexOffset[lod];
+						llassert(*(indicesp) < (U32)max_vertices);
+						indicesp++;
+						index_count++;
+						*(indicesp) = x1_offset + ((i+1)*slices) + sLODVertexOffset[lod];
+						llassert(*(indicesp) < (U32)max_vertices);
+						indicesp++;
+						index_count++;
 					}
-					// Generate the matching quads
-					*(indicesp) = j + (i*slices) + sLODVertexOffset[lod];
-					llassert(*(indicesp) < (U32)max_vertices);
-					indicesp++;
-					index_count++;
-					*(indicesp) = x1_offset + ((i+1)*slices) + sLODVertexOffset[lod];
-					llassert(*(indicesp) < (U32)max_vertices);
-					indicesp++;
-					index_count++;
-					*(indicesp) = j + ((i+1)*slices) + sLODVertexOffset[lod];
-					llassert(*(indicesp) < (U32)max_vertices);
-					indicesp++;
-					index_count++;
-
-					*(indicesp) = j + (i*slices) + sLODVertexOffset[lod];
-					llassert(*(indicesp) < (U32)max_vertices);
-					indicesp++;
-					index_count++;
-					*(indicesp) = x1_offset + (i*slices) + sLODVertexOffset[lod];
-					llassert(*(indicesp) < (U32)max_vertices);
-					indicesp++;
-					index_count++;
-					*(indicesp) = x1_offset + ((i+1)*slices) + sLODVertexOffset[lod];
-					llassert(*(indicesp) < (U32)max_vertices);
-					indicesp++;
-					index_count++;
 				}
+				slices /= 2; 
 			}
-			slices /= 2; 
-		}
 
-		mReferenceBuffer->flush();
-		llassert(vertex_count == max_vertices);
-		llassert(index_count == max_indices);
+			mReferenceBuffer->flush();
+			llassert(vertex_count == max_vertices);
+			llassert(index_count == max_indices);
+
+			sReferenceBuffers[mSpecies] = mReferenceBuffer;
+		}
 	}
 
 	//generate tree mesh
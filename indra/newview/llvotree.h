@@ -185,6 +185,10 @@ protected:
 	typedef std::map<U32, TreeSpeciesData*> SpeciesMap;
 	static SpeciesMap sSpeciesTable;
 
+	// reference geometry shared by all trees of a species
+	typedef std::map<U32, LLPointer<LLVertexBuffer> > species_buffer_map_t;
+	static species_buffer_map_t sReferenceBuffers;
+
 	static S32 sLODIndexOffset[4];
 	static S32 sLODIndexCount[4];
 	static S32 sLODVertexOffset[4];
@@ -214,6 +214,7 @@ LLVOVolume::LLVOVolume(const LLUUID &id, const LLPCode pcode, LLViewerRegion *re
 
 	mFaceMappingChanged = FALSE;
 	mLOD = MIN_LOD;
+	mPrefetchLOD = -1;
 	mTextureAnimp = NULL;
 	mVolumeChanged = FALSE;
 	mVObjRadius = LLVector3(1,1,0.5f).length();
@@ -513,6 +514,14 @@ void LLVOVolume::animateTextures()
 			mFaceMappingChanged = TRUE;
 			gPipeline.markTextured(mDrawable);
 		}
+		else if (!mDrawable->isVisible())
+		{
+			// The matrices are only read when the faces draw, and the
+			// animation is driven by its timer, so an unseen sign can skip
+			// the update and catch up whenever it comes back into view.
+			mTextureAnimp->invalidateFrame();
+			return;
+		}
 		mTexAnimMode = result | mTextureAnimp->mMode;
 				
 		S32 start=0, end=mDrawable->getNumFaces()-1;
@@ -520,6 +529,11 @@ void LLVOVolume::animateTextures()
 		{
 			start = end = mTextureAnimp->mFace;
 		}
+
+		// faces of one prim usually share their texture entry settings,
+		// the last matrix built is copied when the inputs match
+		const LLMatrix4* last_mat = NULL;
+		F32 last_off_s = 0.f, last_off_t = 0.f, last_scale_s = 1.f, last_scale_t = 1.f, last_rot = 0.f;
 		
 		for (S32 i = start; i <= end; i++)
 		{
@@ -552,6 +566,15 @@ void LLVOVolume::animateTextures()
 			}
 
 			LLMatrix4& tex_mat = *facep->mTextureMatrix;
+
+			if (last_mat && !facep->isAtlasInUse() &&
+				off_s == last_off_s && off_t == last_off_t &&
+				scale_s == last_scale_s && scale_t == last_scale_t && rot == last_rot)
+			{
+				tex_mat = *last_mat;
+				continue;
+			}
+
 			tex_mat.setIdentity();
 			LLVector3 trans ;
 
@@ -597,6 +620,16 @@ void LLVOVolume::animateTextures()
 			tex_mat *= mat;
 		
 			tex_mat.translate(trans);
+
+			if (!facep->isAtlasInUse())
+			{
+				last_mat = &tex_mat;
+				last_off_s = off_s;
+				last_off_t = off_t;
+				last_scale_s = scale_s;
+				last_scale_t = scale_t;
+				last_rot = rot;
+			}
 		}
 	}
 	else
@@ -1204,6 +1237,62 @@ S32	LLVOVolume::computeLODDetail(F32 distance, F32 radius)
 	return cur_detail;
 }
 
+S32 LLVOVolume::computeLODFromDistance(F32 distance, F32 radius)
+{
+	distance *= sDistanceFactor;
+
+	F32 rampDist = LLVOVolume::sLODFactor * 2;
+	
+	if (distance < rampDist)
+	{
+		// Boost LOD when you're REALLY close
+		distance *= 1.0f/rampDist;
+		distance *= distance;
+		distance *= rampDist;
+	}
+	
+	// DON'T Compensate for field of view changing on FOV zoom.
+	distance *= F_PI/3.f;
+
+	return computeLODDetail(llround(distance, 0.01f), 
+							llround(radius, 0.01f));
+}
+
+void LLVOVolume::prefetchMeshLOD(const LLVector3& pos_agent, F32 radius, S32 cur_detail)
+{
+	if (cur_detail >= mPrefetchLOD)
+	{ //caught up with the last prefetch
+		mPrefetchLOD = -1;
+	}
+
+	static LLCachedControl<F32> prefetch_time(gSavedSettings, "MeshPrefetchTime");
+	if (prefetch_time <= 0.f || !getVolume())
+	{
+		return;
+	}
+
+	LLVector3 velocity = gAgent.getVelocity();
+	if (velocity.lengthSquared() < 1.f)
+	{ //not moving fast enough for the LOD to change before a normal fetch completes
+		return;
+	}
+
+	LLViewerCamera* camera = LLViewerCamera::getInstance();
+	if ((pos_agent - camera->getOrigin()) * camera->getAtAxis() <= 0.f)
+	{ //behind the camera
+		return;
+	}
+
+	LLVector3 predicted_origin = camera->getOrigin() + velocity * (F32) prefetch_time;
+	S32 predicted_detail = computeLODFromDistance((pos_agent - predicted_origin).length(), radius);
+
+	if (predicted_detail > cur_detail && predicted_detail > mPrefetchLOD)
+	{
+		mPrefetchLOD = predicted_detail;
+		gMeshRepo.prefetchMesh(this, getVolume()->getParams(), predicted_detail);
+	}
+}
+
 BOOL LLVOVolume::calcLOD()
 {
 	if (mDrawable.isNull())
@@ -1215,39 +1304,39 @@ BOOL LLVOVolume::calcLOD()
 	
 	F32 radius;
 	F32 distance;
+	LLVector3 pos_agent;
 
 	if (mDrawable->isState(LLDrawable::RIGGED))
 	{
 		LLVOAvatar* avatar = getAvatar(); 
 		distance = avatar->mDrawable->mDistanceWRTCamera;
 		radius = avatar->getBinRadius();
+		pos_agent = avatar->mDrawable->getPositionAgent();
 	}
 	else
 	{
 		distance = mDrawable->mDistanceWRTCamera;
 		radius = getVolume()->mLODScaleBias.scaledVec(getScale()).length();
+		pos_agent = mDrawable->getPositionAgent();
 	}
 	
 	//hold onto unmodified distance for debugging
 	//F32 debug_distance = distance;
 	
-	distance *= sDistanceFactor;
+	cur_detail = computeLODFromDistance(distance, radius);
 
-	F32 rampDist = LLVOVolume::sLODFactor * 2;
-	
-	if (distance < rampDist)
-	{
-		// Boost LOD when you're REALLY close
-		distance *= 1.0f/rampDist;
-		distance *= distance;
-		distance *= rampDist;
+	static LLCachedControl<F32> lod_hysteresis(gSavedSettings, "RenderVolumeLODHysteresis");
+	if (cur_detail < mLOD && lod_hysteresis > 0.f)
+	{ //only drop detail once the object is clearly past the threshold, so camera jitter
+	  //around a LOD boundary doesn't flip it back and forth
+		S32 held_detail = computeLODFromDistance(distance / (1.f + lod_hysteresis), radius);
+		cur_detail = llmax(cur_detail, llmin(held_detail, mLOD));
 	}
-	
-	// DON'T Compensate for field of view changing on FOV zoom.
-	distance *= F_PI/3.f;
 
-	cur_detail = computeLODDetail(llround(distance, 0.01f), 
-									llround(radius, 0.01f));
+	if (isMesh())
+	{
+		prefetchMeshLOD(pos_agent, radius, cur_detail);
+	}
 
 
 	if (gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_LOD_INFO))
@@ -3346,6 +3435,8 @@ void LLVOVolume::setSelected(BOOL sel)
 	if (mDrawable.notNull())
 	{
 		markForUpdate(TRUE);
+		// selected lights are found at any distance
+		gPipeline.markLightMoved(mDrawable);
 	}
 }
 
@@ -3750,18 +3841,14 @@ void LLRiggedVolume::update(const LLMeshSkinInfo* skin, LLVOAvatar* avatar, cons
 		copyVolumeFaces(volume);	
 	}
 
-	//build matrix palette
+	//fetch matrix palette
 	LLMatrix4a mp[64];
-	LLMatrix4* mat = (LLMatrix4*) mp;
-	
-	for (U32 j = 0; j < skin->mJointNames.size(); ++j)
+	U32 palette_count = 0;
+	const LLMatrix4* palette = avatar->getSkinningMatrixPalette(skin, palette_count);
+
+	for (U32 j = 0; j < llmin(palette_count, (U32) 64); ++j)
 	{
-		LLJoint* joint = avatar->getJoint(skin->mJointNames[j]);
-		if (joint)
-		{
-			mat[j] = skin->mInvBindMatrix[j];
-			mat[j] *= joint->getWorldMatrix();
-		}
+		mp[j].loadu(palette[j]);
 	}
 
 	for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
@@ -4527,6 +4614,8 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 
 	bool batch_textures = LLViewerShaderMgr::instance()->getVertexShaderLevel(LLViewerShaderMgr::SHADER_OBJECT) > 1;
 
+	beginGeometryFill();
+
 	if (batch_textures)
 	{
 		bump_mask |= LLVertexBuffer::MAP_BINORMAL;
@@ -4542,6 +4631,8 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 		genDrawInfo(group, bump_mask, bump_faces, FALSE, TRUE);
 		genDrawInfo(group, alpha_mask, alpha_faces, TRUE);
 	}
+
+	finishGeometryFill();
 	
 
 	if (!LLPipeline::sDelayVBUpdate)
@@ -4574,6 +4665,85 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 
 static LLFastTimer::DeclareTimer FTM_VOLUME_GEOM("Volume Geometry");
 static LLFastTimer::DeclareTimer FTM_VOLUME_GEOM_PARTIAL("Terse Rebuild");
+static LLFastTimer::DeclareTimer FTM_VOLUME_GEOM_FILL("Geometry Fill");
+
+std::vector<LLFace::GeometryFill> LLVolumeGeometryManager::sGeometryFills;
+std::vector<LLPointer<LLVertexBuffer> > LLVolumeGeometryManager::sFillBuffers;
+
+//fewer vertices than this are filled on the render thread, handing them out costs more than it saves
+const S32 MIN_PARALLEL_FILL_VERTICES = 4096;
+
+class LLGeometryFillBody : public LLParallelFor::Body
+{
+public:
+	LLGeometryFillBody(const std::vector<LLFace::GeometryFill>& fills, U32 batch_size)
+		: mFills(fills), mBatchSize(batch_size) { }
+
+	/*virtual*/ void run(U32 index)
+	{
+		U32 end = llmin((U32) mFills.size(), (index+1)*mBatchSize);
+		for (U32 i = index*mBatchSize; i < end; ++i)
+		{
+			mFills[i].run();
+		}
+	}
+
+	const std::vector<LLFace::GeometryFill>& mFills;
+	U32 mBatchSize;
+};
+
+void LLVolumeGeometryManager::beginGeometryFill()
+{
+	if (gPipeline.getRenderWorkers() && !LLFace::sGeometryFills)
+	{
+		sGeometryFills.clear();
+		LLFace::sGeometryFills = &sGeometryFills;
+	}
+}
+
+void LLVolumeGeometryManager::finishGeometryFill()
+{
+	if (LLFace::sGeometryFills != &sGeometryFills)
+	{
+		return;
+	}
+
+	LLFace::sGeometryFills = NULL;
+
+	{
+		LLFastTimer t(FTM_VOLUME_GEOM_FILL);
+
+		S32 vertex_count = 0;
+		for (U32 i = 0; i < sGeometryFills.size(); ++i)
+		{
+			vertex_count += sGeometryFills[i].mNumVertices;
+		}
+
+		LLParallelFor* workers = gPipeline.getRenderWorkers();
+		if (workers && vertex_count >= MIN_PARALLEL_FILL_VERTICES)
+		{ //a few batches per thread so one large face doesn't leave the others idle
+			U32 batches = (workers->getNumThreads()+1)*4;
+			U32 batch_size = llmax((U32) 1, (U32) (sGeometryFills.size()+batches-1)/batches);
+			LLGeometryFillBody body(sGeometryFills, batch_size);
+			workers->run(body, (sGeometryFills.size()+batch_size-1)/batch_size);
+		}
+		else
+		{
+			for (U32 i = 0; i < sGeometryFills.size(); ++i)
+			{
+				sGeometryFills[i].run();
+			}
+		}
+	}
+
+	sGeometryFills.clear();
+
+	for (U32 i = 0; i < sFillBuffers.size(); ++i)
+	{
+		sFillBuffers[i]->flush();
+	}
+	sFillBuffers.clear();
+}
 
 void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 {
@@ -4587,6 +4757,8 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 		
 		std::set<LLVertexBuffer*> mapped_buffers;
 
+		beginGeometryFill();
+
 		for (LLSpatialGroup::element_iter drawable_iter = group->getData().begin(); drawable_iter != group->getData().end(); ++drawable_iter)
 		{
 			LLFastTimer t(FTM_VOLUME_GEOM_PARTIAL);
@@ -4620,6 +4792,8 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 				drawablep->clearState(LLDrawable::REBUILD_ALL);
 			}
 		}
+
+		finishGeometryFill();
 		
 		for (std::set<LLVertexBuffer*>::iterator iter = mapped_buffers.begin(); iter != mapped_buffers.end(); ++iter)
 		{
@@ -5078,7 +5252,14 @@ void LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, std::
 			++face_iter;
 		}
 
-		buffer->flush();
+		if (LLFace::sGeometryFills)
+		{ //unmapped by finishGeometryFill
+			sFillBuffers.push_back(buffer);
+		}
+		else
+		{
+			buffer->flush();
+		}
 	}
 
 	group->mBufferMap[mask].clear();
@@ -319,7 +319,9 @@ public:
 
 protected:
 	S32	computeLODDetail(F32	distance, F32 radius);
+	S32 computeLODFromDistance(F32 distance, F32 radius);
 	BOOL calcLOD();
+	void prefetchMeshLOD(const LLVector3& pos_agent, F32 radius, S32 cur_detail);
 	LLFace* addFace(S32 face_index);
 	void updateTEData();
 
@@ -344,6 +346,7 @@ private:
 	BOOL		mFaceMappingChanged;
 	LLFrameTimer mTextureUpdateTimer;
 	S32			mLOD;
+	S32			mPrefetchLOD; // highest mesh LOD prefetched ahead of camera motion
 	BOOL		mLODChanged;
 	BOOL		mSculptChanged;
 	F32			mSpotLightPriority;
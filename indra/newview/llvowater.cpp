@@ -155,16 +155,7 @@ BOOL LLVOWater::updateGeometry(LLDrawable *drawable)
 	LLStrider<U16> indicesp;
 	U16 index_offset;
 
-
-	// A quad is 4 vertices and 6 indices (making 2 triangles)
-	static const unsigned int vertices_per_quad = 4;
-	static const unsigned int indices_per_quad = 6;
-
-	const S32 size = gSavedSettings.getBOOL("RenderTransparentWater") && LLGLSLShader::sNoFixedFunction ? 16 : 1;
-
-	const S32 num_quads = size * size;
-	face->setSize(vertices_per_quad * num_quads,
-				  indices_per_quad * num_quads);
+	face->setSize(getGridVertexCount(), getGridIndexCount());
 	
 	LLVertexBuffer* buff = face->getVertexBuffer();
 	if (!buff || !buff->isWriteable())
@@ -187,6 +178,28 @@ BOOL LLVOWater::updateGeometry(LLDrawable *drawable)
 	face->mCenterAgent = position_agent;
 	face->mCenterLocal = position_agent;
 
+	getGeometry(verticesp, normalsp, texCoordsp, indicesp, index_offset);
+	
+	buff->flush();
+
+	mDrawable->movePartition();
+	LLPipeline::sCompiles++;
+	return TRUE;
+}
+
+//static
+S32 LLVOWater::getGridSize()
+{
+	static LLCachedControl<bool> transparent_water(gSavedSettings, "RenderTransparentWater");
+	return transparent_water && LLGLSLShader::sNoFixedFunction ? 16 : 1;
+}
+
+void LLVOWater::getGeometry(LLStrider<LLVector3>& verticesp, LLStrider<LLVector3>& normalsp,
+							LLStrider<LLVector2>& texCoordsp, LLStrider<U16>& indicesp, U16 index_offset) const
+{
+	const S32 size = getGridSize();
+	LLVector3 position_agent;
+
 	S32 x, y;
 	F32 step_x = getScale().mV[0] / size;
 	F32 step_y = getScale().mV[1] / size;
@@ -238,12 +251,6 @@ BOOL LLVOWater::updateGeometry(LLDrawable *drawable)
 			*indicesp++ = toffset + 2;
 		}
 	}
-	
-	buff->flush();
-
-	mDrawable->movePartition();
-	LLPipeline::sCompiles++;
-	return TRUE;
 }
 
 void LLVOWater::initClass()
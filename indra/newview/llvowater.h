@@ -63,6 +63,16 @@ public:
 	/*virtual*/ BOOL        updateGeometry(LLDrawable *drawable);
 	/*virtual*/ void		updateSpatialExtents(LLVector4a& newMin, LLVector4a& newMax);
 
+	// quads per side of the water grid, 1 unless transparent water is on
+	static S32 getGridSize();
+	// number of vertices and indices getGeometry() writes
+	static S32 getGridVertexCount() { return getGridSize() * getGridSize() * 4; }
+	static S32 getGridIndexCount() { return getGridSize() * getGridSize() * 6; }
+
+	// writes this patch's grid with vertex numbering starting at index_offset
+	void getGeometry(LLStrider<LLVector3>& verticesp, LLStrider<LLVector3>& normalsp,
+					LLStrider<LLVector2>& texCoordsp, LLStrider<U16>& indicesp, U16 index_offset) const;
+
 	/*virtual*/ void updateTextures();
 	/*virtual*/ void setPixelAreaAndAngle(LLAgent &agent); // generate accurate apparent angle and area
 
@@ -35,10 +35,12 @@
 extern LLControlGroup gSavedSettings;
 
 F64 LLWLAnimator::INTERP_TOTAL_SECONDS = 3.f;
+F32 LLWLAnimator::MIX_WEIGHT_THRESHOLD = 1.f / 1024.f;
 
 LLWLAnimator::LLWLAnimator() : mStartTime(0.f), mDayRate(1.f), mDayTime(0.f),
 							mIsRunning(FALSE), mIsInterpolating(FALSE), mTimeType(TIME_LINDEN),
-							mInterpStartTime(), mInterpEndTime()
+							mInterpStartTime(), mInterpEndTime(),
+							mLastMixValid(false), mLastMixWeight(0.f)
 {
 	mInterpBeginWL = new LLWLParamSet();
 	mInterpBeginWater = new LLWaterParamSet();
@@ -119,6 +121,7 @@ void LLWLAnimator::update(LLWLParamSet& curParams)
 		if(current >= mInterpEndTime)
 		{
 			mIsInterpolating = false;
+			mLastMixValid = false;
 			return;
 		}
 		
@@ -137,6 +140,17 @@ void LLWLAnimator::update(LLWLParamSet& curParams)
 	}
 	else
 	{
+		if (mLastMixValid && mFirstIt == mLastFirstIt && mSecondIt == mLastSecondIt
+			&& fabs(weight - mLastMixWeight) < MIX_WEIGHT_THRESHOLD)
+		{
+			// too little has changed since the last mix to be visible
+			return;
+		}
+		mLastMixValid = true;
+		mLastFirstIt = mFirstIt;
+		mLastSecondIt = mSecondIt;
+		mLastMixWeight = weight;
+
 	// do the interpolation and set the parameters
 		// *TODO: this will not work with lazy loading of sky presets.
 		curParams.mix(LLWLParamManager::getInstance()->mParamList[mFirstIt->second], LLWLParamManager::getInstance()->mParamList[mSecondIt->second], weight);
@@ -196,6 +210,7 @@ void LLWLAnimator::setDayTime(F64 dayTime)
 	//retroactively set start time;
 	mStartTime = LLTimer::getElapsedSeconds() - dayTime * mDayRate;
 	mDayTime = dayTime;
+	mLastMixValid = false;
 
 	// clamp it
 	if(mDayTime < 0)
@@ -213,6 +228,7 @@ void LLWLAnimator::setTrack(std::map<F32, LLWLParamKey>& curTrack,
 							F32 dayRate, F64 dayTime, bool run)
 {
 	mTimeTrack = curTrack;
+	mLastMixValid = false;
 	mDayRate = dayRate;
 	setDayTime(dayTime);
 
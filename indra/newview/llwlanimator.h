@@ -80,6 +80,7 @@ public:
 	void deactivate()
 	{
 		mIsRunning = false;
+		mLastMixValid = false;
 	}
 
 	void activate(ETime time)
@@ -133,7 +134,15 @@ private:
 	LLWaterParamSet *mInterpBeginWater, *mInterpEndWater;
 	clock_t mInterpStartTime, mInterpEndTime;
 
+	// The keyframes and weight of the last day cycle mix, so frames that
+	// would move the sky by less than MIX_WEIGHT_THRESHOLD skip the mix
+	// and leave the shader uniforms alone.
+	bool mLastMixValid;
+	std::map<F32, LLWLParamKey>::iterator mLastFirstIt, mLastSecondIt;
+	F32 mLastMixWeight;
+
 	static F64 INTERP_TOTAL_SECONDS;
+	static F32 MIX_WEIGHT_THRESHOLD;
 };
 
 #endif // LL_WL_ANIMATOR_H
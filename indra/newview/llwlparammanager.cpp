@@ -97,7 +97,12 @@ LLWLParamManager::LLWLParamManager() :
 
 	// sky dome
 	mDomeOffset(0.96f),
-	mDomeRadius(15000.f)
+	mDomeRadius(15000.f),
+
+	mPropagatedGeneration(0),
+	mPropagatedCamYaw(0.f),
+	mPropagatedSunDeltaYaw(0.f),
+	mPropagatedSceneLightStrength(0.f)
 {
 }
 
@@ -454,10 +459,25 @@ void LLWLParamManager::update(LLViewerCamera * cam)
 		mAnimator.update(mCurParams);
 	}
 
+	F32 camYaw = cam->getYaw();
+	if (mCurParams.getGeneration() == mPropagatedGeneration
+		&& !mCurParams.getEnableCloudScrollX() && !mCurParams.getEnableCloudScrollY()
+		&& camYaw == mPropagatedCamYaw
+		&& cam->getOrigin() == mPropagatedCamOrigin
+		&& mSunDeltaYaw == mPropagatedSunDeltaYaw
+		&& mSceneLightStrength == mPropagatedSceneLightStrength)
+	{
+		// nothing the shaders see has changed since last frame
+		return;
+	}
+	mPropagatedCamYaw = camYaw;
+	mPropagatedCamOrigin = cam->getOrigin();
+	mPropagatedSunDeltaYaw = mSunDeltaYaw;
+	mPropagatedSceneLightStrength = mSceneLightStrength;
+
 	// update the shaders and the menu
 	propagateParameters();
-	
-	F32 camYaw = cam->getYaw();
+	mPropagatedGeneration = mCurParams.getGeneration();
 
 	stop_glerror();
 
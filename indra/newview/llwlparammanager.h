@@ -330,6 +330,14 @@ public:
 	/// horizon
 	LLVector4 mClampedLightDir;
 
+	/// what the shader uniforms were last marked dirty for, so frames
+	/// where none of it changes leave them alone
+	U32 mPropagatedGeneration;
+	F32 mPropagatedCamYaw;
+	LLVector3 mPropagatedCamOrigin;
+	F32 mPropagatedSunDeltaYaw;
+	F32 mPropagatedSceneLightStrength;
+
 	// list of params and how they're cycled for days
 	LLWLDayCycle mDay;
 
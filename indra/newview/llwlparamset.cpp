@@ -40,9 +40,12 @@
 
 LLWLParamSet::LLWLParamSet(void) :
 	mName("Unnamed Preset"),
-	mCloudScrollXOffset(0.f), mCloudScrollYOffset(0.f)	
+	mCloudScrollXOffset(0.f), mCloudScrollYOffset(0.f),
+	mGeneration(++sNextGeneration)
 {}
 
+U32 LLWLParamSet::sNextGeneration = 0;
+
 static LLFastTimer::DeclareTimer FTM_WL_PARAM_UPDATE("WL Param Update");
 
 void LLWLParamSet::update(LLGLSLShader * shader) const 
@@ -131,6 +134,7 @@ void LLWLParamSet::update(LLGLSLShader * shader) const
 
 void LLWLParamSet::set(const std::string& paramName, float x) 
 {	
+	changed();
 	// handle case where no array
 	if(mParamValues[paramName].isReal()) 
 	{
@@ -147,12 +151,14 @@ void LLWLParamSet::set(const std::string& paramName, float x)
 
 void LLWLParamSet::set(const std::string& paramName, float x, float y)
 {
+	changed();
 	mParamValues[paramName][0] = x;
 	mParamValues[paramName][1] = y;
 }
 
 void LLWLParamSet::set(const std::string& paramName, float x, float y, float z) 
 {
+	changed();
 	mParamValues[paramName][0] = x;
 	mParamValues[paramName][1] = y;
 	mParamValues[paramName][2] = z;
@@ -160,6 +166,7 @@ void LLWLParamSet::set(const std::string& paramName, float x, float y, float z)
 
 void LLWLParamSet::set(const std::string& paramName, float x, float y, float z, float w) 
 {
+	changed();
 	mParamValues[paramName][0] = x;
 	mParamValues[paramName][1] = y;
 	mParamValues[paramName][2] = z;
@@ -168,6 +175,7 @@ void LLWLParamSet::set(const std::string& paramName, float x, float y, float z,
 
 void LLWLParamSet::set(const std::string& paramName, const float * val) 
 {
+	changed();
 	mParamValues[paramName][0] = val[0];
 	mParamValues[paramName][1] = val[1];
 	mParamValues[paramName][2] = val[2];
@@ -176,6 +184,7 @@ void LLWLParamSet::set(const std::string& paramName, const float * val)
 
 void LLWLParamSet::set(const std::string& paramName, const LLVector4 & val) 
 {
+	changed();
 	mParamValues[paramName][0] = val.mV[0];
 	mParamValues[paramName][1] = val.mV[1];
 	mParamValues[paramName][2] = val.mV[2];
@@ -184,6 +193,7 @@ void LLWLParamSet::set(const std::string& paramName, const LLVector4 & val)
 
 void LLWLParamSet::set(const std::string& paramName, const LLColor4 & val) 
 {
+	changed();
 	mParamValues[paramName][0] = val.mV[0];
 	mParamValues[paramName][1] = val.mV[1];
 	mParamValues[paramName][2] = val.mV[2];
@@ -232,6 +242,7 @@ F32 LLWLParamSet::getFloat(const std::string& paramName, bool& error)
 
 void LLWLParamSet::setSunAngle(float val) 
 {
+	changed();
 	// keep range 0 - 2pi
 	if(val > F_TWO_PI || val < 0)
 	{
@@ -246,6 +257,7 @@ void LLWLParamSet::setSunAngle(float val)
 
 void LLWLParamSet::setEastAngle(float val) 
 {
+	changed();
 	// keep range 0 - 2pi
 	if(val > F_TWO_PI || val < 0)
 	{
@@ -259,6 +271,7 @@ void LLWLParamSet::setEastAngle(float val)
 
 void LLWLParamSet::mix(LLWLParamSet& src, LLWLParamSet& dest, F32 weight)
 {
+	changed();
 	// set up the iterators
 
 	// keep cloud positions and coverage the same
@@ -50,6 +50,15 @@ private:
 	
 	float mCloudScrollXOffset, mCloudScrollYOffset;
 
+	// Bumped by every change to the parameter values (but not the cloud
+	// scroll offsets), so LLWLParamManager and LLVOSky can tell when what
+	// they derived from them is stale.  Numbers are unique across all sets,
+	// so a copy only matches the set it was copied from.
+	U32 mGeneration;
+	static U32 sNextGeneration;
+
+	void changed() { mGeneration = ++sNextGeneration; }
+
 public:
 
 	LLWLParamSet();
@@ -63,6 +72,9 @@ public:
 	/// get the total llsd
 	const LLSD& getAll();		
 	
+	/// changes whenever any parameter does
+	U32 getGeneration() const { return mGeneration; }
+	
 
 	/// Set a float parameter.
 	/// \param paramName	The name of the parameter to set.
@@ -176,6 +188,7 @@ inline void LLWLParamSet::setAll(const LLSD& val)
 {
 	if(val.isMap()) {
 		mParamValues = val;
+		changed();
 	}
 }
 
@@ -185,6 +198,7 @@ inline const LLSD& LLWLParamSet::getAll()
 }
 
 inline void LLWLParamSet::setStarBrightness(float val) {
+	changed();
 	mParamValues["star_brightness"] = val;
 }
 
@@ -202,6 +216,7 @@ inline F32 LLWLParamSet::getEastAngle() {
 
 
 inline void LLWLParamSet::setEnableCloudScrollX(bool val) {
+	changed();
 	mParamValues["enable_cloud_scroll"][0] = val;
 }
 
@@ -210,6 +225,7 @@ inline bool LLWLParamSet::getEnableCloudScrollX() {
 }
 
 inline void LLWLParamSet::setEnableCloudScrollY(bool val) {
+	changed();
 	mParamValues["enable_cloud_scroll"][1] = val;
 }
 
@@ -219,6 +235,7 @@ inline bool LLWLParamSet::getEnableCloudScrollY() {
 
 
 inline void LLWLParamSet::setCloudScrollX(F32 val) {
+	changed();
 	mParamValues["cloud_scroll_rate"][0] = val;
 }
 
@@ -227,6 +244,7 @@ inline F32 LLWLParamSet::getCloudScrollX() {
 }
 
 inline void LLWLParamSet::setCloudScrollY(F32 val) {
+	changed();
 	mParamValues["cloud_scroll_rate"][1] = val;
 }
 
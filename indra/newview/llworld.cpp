@@ -252,6 +252,7 @@ LLViewerRegion* LLWorld::addRegion(const U64 &region_handle, const LLHost &host)
 	mRegionList.push_back(regionp);
 	mActiveRegionList.push_back(regionp);
 	mCulledRegionList.push_back(regionp);
+	mRegionHandleMap[region_handle] = regionp;
 
 
 	// Find all the adjacent regions, and attach them.
@@ -339,6 +340,7 @@ void LLWorld::removeRegion(const LLHost &host)
 	mActiveRegionList.remove(regionp);
 	mCulledRegionList.remove(regionp);
 	mVisibleRegionList.remove(regionp);
+	mRegionHandleMap.erase(regionp->getHandle());
 	
 	delete regionp;
 
@@ -371,16 +373,11 @@ LLViewerRegion* LLWorld::getRegionFromPosAgent(const LLVector3 &pos)
 
 LLViewerRegion* LLWorld::getRegionFromPosGlobal(const LLVector3d &pos)
 {
-	for (region_list_t::iterator iter = mRegionList.begin();
-		 iter != mRegionList.end(); ++iter)
+	if (pos.mdV[VX] < 0.0 || pos.mdV[VY] < 0.0)
 	{
-		LLViewerRegion* regionp = *iter;
-		if (regionp->pointInRegionGlobal(pos))
-		{
-			return regionp;
-		}
+		return NULL;
 	}
-	return NULL;
+	return getRegionFromHandle(to_region_handle(pos));
 }
 
 
@@ -455,14 +452,10 @@ LLVector3d	LLWorld::clipToVisibleRegions(const LLVector3d &start_pos, const LLVe
 
 LLViewerRegion* LLWorld::getRegionFromHandle(const U64 &handle)
 {
-	for (region_list_t::iterator iter = mRegionList.begin();
-		 iter != mRegionList.end(); ++iter)
+	region_handle_map_t::const_iterator iter = mRegionHandleMap.find(handle);
+	if (iter != mRegionHandleMap.end())
 	{
-		LLViewerRegion* regionp = *iter;
-		if (regionp->getHandle() == handle)
-		{
-			return regionp;
-		}
+		return iter->second;
 	}
 	return NULL;
 }
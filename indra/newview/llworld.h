@@ -42,6 +42,8 @@
 #include "llviewertexture.h"
 #include "llvowater.h"
 
+#include <boost/unordered_map.hpp>
+
 class LLViewerRegion;
 class LLVector3d;
 class LLMessageSystem;
@@ -173,6 +175,11 @@ private:
 	region_list_t	mVisibleRegionList;
 	region_list_t	mCulledRegionList;
 
+	// Regions sit on a fixed 256m grid, so a position maps straight to the
+	// handle of the region containing it.
+	typedef boost::unordered_map<U64, LLViewerRegion*> region_handle_map_t;
+	region_handle_map_t mRegionHandleMap;
+
 	// Number of points on edge
 	static const U32 mWidth;
 
@@ -83,6 +83,21 @@ private:
 
 LLUUID LSLPreprocessor::findInventoryByName(std::string name)
 {
+	// Every save resolves every #include again, and each miss here walks
+	// the whole inventory; remember where we found each script and only
+	// search again if it has since been deleted or renamed.
+	static std::map<std::string, LLUUID> sIncludeItemIDs;
+	std::map<std::string, LLUUID>::iterator found = sIncludeItemIDs.find(name);
+	if (found != sIncludeItemIDs.end())
+	{
+		LLViewerInventoryItem* item = gInventory.getItem(found->second);
+		if (item && item->getName() == name && item->getType() == LLAssetType::AT_LSL_TEXT)
+		{
+			return found->second;
+		}
+		sIncludeItemIDs.erase(found);
+	}
+
 	LLInventoryModel::cat_array_t cats;
 	LLInventoryModel::item_array_t items;
 	ScriptMatches namematches(name);
@@ -93,6 +108,7 @@ LLUUID LSLPreprocessor::findInventoryByName(std::string name)
 		LLInventoryModel::item_array_t::iterator it = items.begin();
 		it = items.begin();
 		LLViewerInventoryItem* foo=it->get();
+		sIncludeItemIDs[name] = foo->getUUID();
 		return foo->getUUID();
 	}
 	return LLUUID::null;
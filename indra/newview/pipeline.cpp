@@ -35,6 +35,8 @@
 #include "llviewercontrol.h"
 #include "llfasttimer.h"
 #include "llfontgl.h"
+#include "llgputimer.h"
+#include "llframetimer.h"
 #include "llmemtype.h"
 #include "llnamevalue.h"
 #include "llpointer.h"
@@ -63,6 +65,7 @@
 #include "llfloatertelehub.h"
 #include "llfloaterreg.h"
 #include "llgldbg.h"
+#include "llhudlayer.h"
 #include "llhudmanager.h"
 #include "llhudnametag.h"
 #include "llhudtext.h"
@@ -80,6 +83,7 @@
 #include "llviewerobject.h"
 #include "llviewerobjectlist.h"
 #include "llviewerparcelmgr.h"
+#include "llviewerparceloverlay.h"
 #include "llviewerregion.h" // for audio debugging.
 #include "llviewerwindow.h" // For getSpinAxis
 #include "llvoavatarself.h"
@@ -124,11 +128,17 @@ BOOL LLPipeline::RenderDeferred;
 F32 LLPipeline::RenderDeferredSunWash;
 U32 LLPipeline::RenderFSAASamples;
 U32 LLPipeline::RenderResolutionDivisor;
+BOOL LLPipeline::RenderDynamicResolution;
+F32 LLPipeline::RenderDynamicResolutionTarget;
+F32 LLPipeline::RenderDynamicResolutionMinScale;
 BOOL LLPipeline::RenderUIBuffer;
+BOOL LLPipeline::RenderHUDBuffer;
 S32 LLPipeline::RenderShadowDetail;
 BOOL LLPipeline::RenderDeferredSSAO;
 F32 LLPipeline::RenderShadowResolutionScale;
 BOOL LLPipeline::RenderLocalLights;
+BOOL LLPipeline::RenderDeferredTiledLights;
+U32 LLPipeline::RenderDeferredLightTileSize;
 BOOL LLPipeline::RenderDelayCreation;
 BOOL LLPipeline::RenderAnimateRes;
 BOOL LLPipeline::FreezeTime;
@@ -179,6 +189,9 @@ LLVector3 LLPipeline::RenderShadowGaussian;
 F32 LLPipeline::RenderShadowBlurDistFactor;
 BOOL LLPipeline::RenderDeferredAtmospheric;
 S32 LLPipeline::RenderReflectionDetail;
+F32 LLPipeline::RenderReflectionDistance;
+F32 LLPipeline::RenderReflectionMinPixelArea;
+U32 LLPipeline::RenderReflectionUpdateInterval;
 F32 LLPipeline::RenderHighlightFadeTime;
 LLVector3 LLPipeline::RenderShadowClipPlanes;
 LLVector3 LLPipeline::RenderShadowOrthoClipPlanes;
@@ -187,6 +200,8 @@ F32 LLPipeline::RenderFarClip;
 LLVector3 LLPipeline::RenderShadowSplitExponent;
 F32 LLPipeline::RenderShadowErrorCutoff;
 F32 LLPipeline::RenderShadowFOVCutoff;
+U32 LLPipeline::RenderShadowCacheInterval;
+F32 LLPipeline::RenderShadowCacheDistance;
 BOOL LLPipeline::CameraOffset;
 F32 LLPipeline::CameraMaxCoF;
 F32 LLPipeline::CameraDoFResScale;
@@ -240,6 +255,7 @@ LLFastTimer::DeclareTimer FTM_RENDER_DEFERRED("Deferred Shading");
 
 static LLFastTimer::DeclareTimer FTM_STATESORT_DRAWABLE("Sort Drawables");
 static LLFastTimer::DeclareTimer FTM_STATESORT_POSTSORT("Post Sort");
+static LLFastTimer::DeclareTimer FTM_STATESORT_BATCHES("Sort Batches");
 
 //----------------------------------------
 std::string gPoolNames[] = 
@@ -250,7 +266,7 @@ std::string gPoolNames[] =
 	"POOL_GROUND",
 	"POOL_FULLBRIGHT",
 	"POOL_BUMP",
-	"POOL_TERRAIN,"	
+	"POOL_TERRAIN",
 	"POOL_SKY",
 	"POOL_WL_SKY",
 	"POOL_TREE",
@@ -263,6 +279,24 @@ std::string gPoolNames[] =
 	"POOL_ALPHA"
 };
 
+static LLGPUTimer GPU_SHADOWS("Shadows");
+static LLGPUTimer GPU_WATER_REFLECTION("Water Reflection");
+static LLGPUTimer GPU_DEFERRED_GEOMETRY("Deferred Geometry");
+static LLGPUTimer GPU_DEFERRED_LIGHTING("Deferred Lighting");
+static LLGPUTimer GPU_POST_DEFERRED("Post Deferred");
+static LLGPUTimer GPU_POST_PROCESS("Post Process");
+
+// one per draw pool type, created on first use
+static LLGPUTimer& gpu_pool_timer(U32 type)
+{
+	static LLGPUTimer* timers[LLDrawPool::NUM_POOL_TYPES] = { NULL };
+	if (!timers[type])
+	{
+		timers[type] = new LLGPUTimer(gPoolNames[type]);
+	}
+	return *timers[type];
+}
+
 void drawBox(const LLVector3& c, const LLVector3& r);
 void drawBoxOutline(const LLVector3& pos, const LLVector3& size);
 U32 nhpo2(U32 v);
@@ -398,6 +432,8 @@ LLPipeline::LLPipeline() :
 	mTrianglesDrawn(0),
 	mNumVisibleNodes(0),
 	mVerticesRelit(0),
+	mRenderWorkers(NULL),
+	mParallelCull(NULL),
 	mLightingChanges(0),
 	mGeometryChanges(0),
 	mNumVisibleFaces(0),
@@ -427,7 +463,13 @@ LLPipeline::LLPipeline() :
 	mLightMovingMask(0),
 	mLightingDetail(0),
 	mScreenWidth(0),
-	mScreenHeight(0)
+	mScreenHeight(0),
+	mResolutionScale(1.f),
+	mDynamicResFrameTime(0.f),
+	mDynamicResFrames(0),
+	mDynamicResize(false),
+	mWaterReflectionFrame(0),
+	mWaterReflectionUnderWater(FALSE)
 {
 	mNoiseMap = 0;
 	mTrueNoiseMap = 0;
@@ -445,11 +487,19 @@ void LLPipeline::init()
 	sRenderBump = gSavedSettings.getBOOL("RenderObjectBump");
 	sUseTriStrips = gSavedSettings.getBOOL("RenderUseTriStrips");
 	LLVertexBuffer::sUseStreamDraw = gSavedSettings.getBOOL("RenderUseStreamVBO");
+	LLVertexBuffer::sUseStreamRing = gSavedSettings.getBOOL("RenderUseStreamRing");
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBOOL("RenderUseVAO");
 	LLVertexBuffer::sPreferStreamDraw = gSavedSettings.getBOOL("RenderPreferStreamDraw");
 	sRenderAttachedLights = gSavedSettings.getBOOL("RenderAttachedLights");
 	sRenderAttachedParticles = gSavedSettings.getBOOL("RenderAttachedParticles");
 
+	U32 worker_threads = llmin(gSavedSettings.getU32("RenderWorkerThreads"), (U32) 16);
+	if (worker_threads > 0)
+	{
+		mRenderWorkers = new LLParallelFor("Render Worker", worker_threads);
+		mParallelCull = new LLParallelCull(*mRenderWorkers);
+	}
+
 	mInitialized = TRUE;
 	
 	stop_glerror();
@@ -529,11 +579,17 @@ void LLPipeline::init()
 	gSavedSettings.getControl("RenderDeferredSunWash")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderFSAASamples")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderResolutionDivisor")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderDynamicResolution")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderDynamicResolutionTarget")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderDynamicResolutionMinScale")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderUIBuffer")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderHUDBuffer")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderShadowDetail")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderDeferredSSAO")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderShadowResolutionScale")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderLocalLights")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderDeferredTiledLights")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderDeferredLightTileSize")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderDelayCreation")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderAnimateRes")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("FreezeTime")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
@@ -584,6 +640,9 @@ void LLPipeline::init()
 	gSavedSettings.getControl("RenderShadowBlurDistFactor")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderDeferredAtmospheric")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderReflectionDetail")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderReflectionDistance")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderReflectionMinPixelArea")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderReflectionUpdateInterval")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderHighlightFadeTime")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderShadowClipPlanes")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderShadowOrthoClipPlanes")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
@@ -592,6 +651,8 @@ void LLPipeline::init()
 	gSavedSettings.getControl("RenderShadowSplitExponent")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderShadowErrorCutoff")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("RenderShadowFOVCutoff")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderShadowCacheInterval")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	gSavedSettings.getControl("RenderShadowCacheDistance")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("CameraOffset")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("CameraMaxCoF")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
 	gSavedSettings.getControl("CameraDoFResScale")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
@@ -606,6 +667,11 @@ void LLPipeline::cleanup()
 {
 	assertInitialized();
 
+	delete mParallelCull;
+	mParallelCull = NULL;
+	delete mRenderWorkers;
+	mRenderWorkers = NULL;
+
 	mGroupQ1.clear() ;
 	mGroupQ2.clear() ;
 
@@ -726,6 +792,7 @@ void LLPipeline::resizeScreenTexture()
 	
 		allocateScreenBuffer(resX,resY);
 	}
+	mDynamicResize = false;
 }
 
 void LLPipeline::allocatePhysicsBuffer()
@@ -787,6 +854,57 @@ void LLPipeline::allocateScreenBuffer(U32 resX, U32 resY)
 	}
 }
 
+void LLPipeline::updateDynamicResolution(F32 frame_time)
+{
+	if (!RenderDynamicResolution || !sRenderDeferred)
+	{
+		if (mResolutionScale != 1.f)
+		{
+			mResolutionScale = 1.f;
+			gResizeScreenTexture = TRUE;
+		}
+		mDynamicResFrames = 0;
+		return;
+	}
+
+	//smooth out single hitches so they don't flip the resolution
+	mDynamicResFrameTime = mDynamicResFrames == 0 ? frame_time : lerp(mDynamicResFrameTime, frame_time, 0.1f);
+
+	//let the average settle at the current scale before changing it again
+	const U32 SETTLE_FRAMES = 30;
+	if (++mDynamicResFrames < SETTLE_FRAMES)
+	{
+		return;
+	}
+
+	const F32 SCALE_STEP = 0.1f;
+	F32 target = llmax(RenderDynamicResolutionTarget, 1.f) * 0.001f;
+	F32 min_scale = llclamp(RenderDynamicResolutionMinScale, 0.25f, 1.f);
+	F32 scale = mResolutionScale;
+
+	if (mDynamicResFrameTime > target * 1.05f)
+	{
+		scale = llmax(scale - SCALE_STEP, min_scale);
+	}
+	else if (scale < 1.f)
+	{ //fill cost goes with pixel count, only step up if the larger buffers should still fit the budget
+		F32 next = llmin(scale + SCALE_STEP, 1.f);
+		F32 ratio = next / scale;
+		if (mDynamicResFrameTime * ratio * ratio < target * 0.9f)
+		{
+			scale = next;
+		}
+	}
+
+	if (scale != mResolutionScale)
+	{
+		mResolutionScale = scale;
+		mDynamicResFrames = 0;
+		mDynamicResize = true;
+		gResizeScreenTexture = TRUE;
+	}
+}
+
 
 bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 {
@@ -804,6 +922,12 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 		resY /= res_mod;
 	}
 
+	if (mResolutionScale < 1.f)
+	{ //renderFinal stretches mScreen over the whole world view
+		resX = llmax((U32) (resX*mResolutionScale), 1U);
+		resY = llmax((U32) (resY*mResolutionScale), 1U);
+	}
+
 	if (RenderUIBuffer)
 	{
 		if (!mUIScreen.allocate(resX,resY, GL_RGBA, FALSE, FALSE, LLTexUnit::TT_RECT_TEXTURE, FALSE))
@@ -812,11 +936,31 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 		}
 	}	
 
+	// the HUD layer is drawn on top of the scaled up world, so it keeps the
+	// full window size; it needs an FBO since it is drawn to between frames
+	LLHUDLayer::getInstance()->invalidate();
+	if (RenderHUDBuffer && LLRenderTarget::sUseFBO)
+	{
+		if (!mHUDScreen.allocate(mScreenWidth, mScreenHeight, GL_RGBA, TRUE, FALSE, LLTexUnit::TT_TEXTURE, TRUE))
+		{
+			llwarns << "Could not allocate HUD layer, drawing HUDs directly." << llendl;
+			mHUDScreen.release();
+		}
+	}
+	else
+	{
+		mHUDScreen.release();
+	}
+
 	if (LLPipeline::sRenderDeferred)
 	{
 		// Set this flag in case we crash while resizing window or allocating space for deferred rendering targets
-		gSavedSettings.setBOOL("RenderInitError", TRUE);
-		gSavedSettings.saveToFile( gSavedSettings.getString("ClientSettingsFile"), TRUE );
+		// (dynamic resolution steps reallocate the same targets too often to write out settings every time)
+		if (!mDynamicResize)
+		{
+			gSavedSettings.setBOOL("RenderInitError", TRUE);
+			gSavedSettings.saveToFile( gSavedSettings.getString("ClientSettingsFile"), TRUE );
+		}
 
 		S32 shadow_detail = RenderShadowDetail;
 		BOOL ssao = RenderDeferredSSAO;
@@ -852,6 +996,7 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 			for (U32 i = 0; i < 4; i++)
 			{
 				if (!mShadow[i].allocate(U32(resX*scale),U32(resY*scale), 0, TRUE, FALSE, LLTexUnit::TT_RECT_TEXTURE)) return false;
+				mShadowCache[i].mValid = false;
 			}
 		}
 		else
@@ -881,8 +1026,11 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 		}
 
 		// don't disable shaders on next session
-		gSavedSettings.setBOOL("RenderInitError", FALSE);
-		gSavedSettings.saveToFile( gSavedSettings.getString("ClientSettingsFile"), TRUE );
+		if (!mDynamicResize)
+		{
+			gSavedSettings.setBOOL("RenderInitError", FALSE);
+			gSavedSettings.saveToFile( gSavedSettings.getString("ClientSettingsFile"), TRUE );
+		}
 	}
 	else
 	{
@@ -952,11 +1100,17 @@ void LLPipeline::refreshCachedSettings()
 	RenderDeferredSunWash = gSavedSettings.getF32("RenderDeferredSunWash");
 	RenderFSAASamples = gSavedSettings.getU32("RenderFSAASamples");
 	RenderResolutionDivisor = gSavedSettings.getU32("RenderResolutionDivisor");
+	RenderDynamicResolution = gSavedSettings.getBOOL("RenderDynamicResolution");
+	RenderDynamicResolutionTarget = gSavedSettings.getF32("RenderDynamicResolutionTarget");
+	RenderDynamicResolutionMinScale = gSavedSettings.getF32("RenderDynamicResolutionMinScale");
 	RenderUIBuffer = gSavedSettings.getBOOL("RenderUIBuffer");
+	RenderHUDBuffer = gSavedSettings.getBOOL("RenderHUDBuffer");
 	RenderShadowDetail = gSavedSettings.getS32("RenderShadowDetail");
 	RenderDeferredSSAO = gSavedSettings.getBOOL("RenderDeferredSSAO");
 	RenderShadowResolutionScale = gSavedSettings.getF32("RenderShadowResolutionScale");
 	RenderLocalLights = gSavedSettings.getBOOL("RenderLocalLights");
+	RenderDeferredTiledLights = gSavedSettings.getBOOL("RenderDeferredTiledLights");
+	RenderDeferredLightTileSize = gSavedSettings.getU32("RenderDeferredLightTileSize");
 	RenderDelayCreation = gSavedSettings.getBOOL("RenderDelayCreation");
 	RenderAnimateRes = gSavedSettings.getBOOL("RenderAnimateRes");
 	FreezeTime = gSavedSettings.getBOOL("FreezeTime");
@@ -1007,6 +1161,9 @@ void LLPipeline::refreshCachedSettings()
 	RenderShadowBlurDistFactor = gSavedSettings.getF32("RenderShadowBlurDistFactor");
 	RenderDeferredAtmospheric = gSavedSettings.getBOOL("RenderDeferredAtmospheric");
 	RenderReflectionDetail = gSavedSettings.getS32("RenderReflectionDetail");
+	RenderReflectionDistance = gSavedSettings.getF32("RenderReflectionDistance");
+	RenderReflectionMinPixelArea = gSavedSettings.getF32("RenderReflectionMinPixelArea");
+	RenderReflectionUpdateInterval = gSavedSettings.getU32("RenderReflectionUpdateInterval");
 	RenderHighlightFadeTime = gSavedSettings.getF32("RenderHighlightFadeTime");
 	RenderShadowClipPlanes = gSavedSettings.getVector3("RenderShadowClipPlanes");
 	RenderShadowOrthoClipPlanes = gSavedSettings.getVector3("RenderShadowOrthoClipPlanes");
@@ -1015,6 +1172,8 @@ void LLPipeline::refreshCachedSettings()
 	RenderShadowSplitExponent = gSavedSettings.getVector3("RenderShadowSplitExponent");
 	RenderShadowErrorCutoff = gSavedSettings.getF32("RenderShadowErrorCutoff");
 	RenderShadowFOVCutoff = gSavedSettings.getF32("RenderShadowFOVCutoff");
+	RenderShadowCacheInterval = gSavedSettings.getU32("RenderShadowCacheInterval");
+	RenderShadowCacheDistance = gSavedSettings.getF32("RenderShadowCacheDistance");
 	CameraOffset = gSavedSettings.getBOOL("CameraOffset");
 	CameraMaxCoF = gSavedSettings.getF32("CameraMaxCoF");
 	CameraDoFResScale = gSavedSettings.getF32("CameraDoFResScale");
@@ -1066,6 +1225,7 @@ void LLPipeline::releaseLUTBuffers()
 void LLPipeline::releaseScreenBuffers()
 {
 	mUIScreen.release();
+	mHUDScreen.release();
 	mScreen.release();
 	mFXAABuffer.release();
 	mPhysicsDisplay.release();
@@ -1097,6 +1257,7 @@ void LLPipeline::createGLBuffers()
 		mWaterRef.allocate(res,res,GL_RGBA,TRUE,FALSE);
 		//always use FBO for mWaterDis so it can be used for avatar texture bakes
 		mWaterDis.allocate(res,res,GL_RGBA,TRUE,FALSE,LLTexUnit::TT_TEXTURE, true);
+		mWaterReflectionFrame = 0;
 	}
 
 	mHighlight.allocate(256,256,GL_RGBA, FALSE, FALSE);
@@ -1599,6 +1760,8 @@ void LLPipeline::unlinkDrawable(LLDrawable *drawable)
 	{
 		LLFastTimer t(FTM_REMOVE_FROM_LIGHT_SET);
 		mLights.erase(drawablep);
+		mLightsToBin.erase(drawablep);
+		unbinLight(drawablep);
 
 		for (light_set_t::iterator iter = mNearbyLights.begin();
 					iter != mNearbyLights.end(); iter++)
@@ -1802,13 +1965,40 @@ void LLPipeline::updateMoveNormalAsync(LLDrawable* drawablep)
 	}
 }
 
-void LLPipeline::updateMovedList(LLDrawable::drawable_vector_t& moved_list)
+// Tiny, distant objects that are moving don't need their drawables touched
+// every frame, so they stay on the moved list and are only updated once
+// every few frames, staggered so they don't all land on the same frame.
+static BOOL is_low_relevance_move(LLDrawable* drawablep, U32 interval, F32 min_area)
 {
+	LLViewerObject* vobj = drawablep->getVObj();
+	if (!vobj || drawablep->isState(LLDrawable::MOVE_UNDAMPED) ||
+		vobj->isAvatar() || vobj->isAttachment() || vobj->isSelected() ||
+		vobj->getPixelArea() >= min_area)
+	{
+		return FALSE;
+	}
+
+	U32 slot = (U32) (((uintptr_t) drawablep) >> 4);
+	return (LLFrameTimer::getFrameCount() + slot) % interval != 0;
+}
+
+void LLPipeline::updateMovedList(LLDrawable::drawable_vector_t& moved_list, BOOL throttle)
+{
+	static LLCachedControl<U32> low_relevance_interval(gSavedSettings, "RenderLowRelevanceMoveInterval");
+	static LLCachedControl<F32> low_relevance_area(gSavedSettings, "RenderLowRelevancePixelArea");
+	throttle = throttle && low_relevance_interval > 1;
+
 	for (LLDrawable::drawable_vector_t::iterator iter = moved_list.begin();
 		 iter != moved_list.end(); )
 	{
 		LLDrawable::drawable_vector_t::iterator curiter = iter++;
 		LLDrawable *drawablep = *curiter;
+		if (throttle && !drawablep->isDead() && !drawablep->isState(LLDrawable::EARLY_MOVE) &&
+			is_low_relevance_move(drawablep, low_relevance_interval, low_relevance_area))
+		{
+			continue;
+		}
+
 		BOOL done = TRUE;
 		if (!drawablep->isDead() && (!drawablep->isState(LLDrawable::EARLY_MOVE)))
 		{
@@ -1857,7 +2047,7 @@ void LLPipeline::updateMove()
 	{
 		static LLFastTimer::DeclareTimer ftm("Moved List");
 		LLFastTimer t(ftm);
-		updateMovedList(mMovedList);
+		updateMovedList(mMovedList, TRUE);
 	}
 
 	//balance octrees
@@ -2178,6 +2368,7 @@ BOOL LLPipeline::getVisibleExtents(LLCamera& camera, LLVector3& min, LLVector3&
 }
 
 static LLFastTimer::DeclareTimer FTM_CULL("Object Culling");
+static LLFastTimer::DeclareTimer FTM_PARALLEL_CULL("Parallel Cull");
 
 void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_clip, LLPlane* planep)
 {
@@ -2260,6 +2451,17 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 		gOcclusionProgram.bind();
 	}
 	
+	//the world camera reads back occlusion queries and marks alpha groups for rebuild while traversing,
+	//other passes with occlusion off only touch the groups they visit and can cull partitions in parallel
+	bool parallel = mParallelCull &&
+					LLPipeline::sUseOcclusion <= 1 &&
+					LLViewerCamera::sCurCameraID != LLViewerCamera::CAMERA_WORLD;
+
+	static std::vector<LLSpatialPartition*> cull_partitions;
+	static std::vector<LLCamera> cull_cameras;
+	cull_partitions.clear();
+	cull_cameras.clear();
+
 	for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin(); 
 			iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
 	{
@@ -2281,12 +2483,34 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 			{
 				if (hasRenderType(part->mDrawableType))
 				{
-					part->cull(camera);
+					if (parallel)
+					{
+						cull_partitions.push_back(part);
+						cull_cameras.push_back(camera);
+					}
+					else
+					{
+						part->cull(camera);
+					}
 				}
 			}
 		}
 	}
 
+	if (!cull_partitions.empty())
+	{
+		LLFastTimer ftm(FTM_PARALLEL_CULL);
+		mParallelCull->cull(cull_partitions, cull_cameras);
+
+		//merge in partition order so the result matches a serial cull
+		for (U32 i = 0; i < cull_partitions.size(); ++i)
+		{
+			LLCullResult& fragment = mParallelCull->getResult(i);
+			mNumVisibleNodes += fragment.getVisibleGroupsSize() + fragment.getDrawableGroupsSize();
+			sCull->append(fragment);
+		}
+	}
+
 	if (bound_shader)
 	{
 		gOcclusionProgram.unbind();
@@ -2331,7 +2555,7 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 	}
 }
 
-void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
+void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera, LLCullResult* result)
 {
 	if (group->getData().empty())
 	{ 
@@ -2347,7 +2571,14 @@ void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
 	
 	const F32 MINIMUM_PIXEL_AREA = 16.f;
 
-	if (group->mPixelArea < MINIMUM_PIXEL_AREA)
+	//small objects barely register in the reflection, drop them sooner
+	F32 min_area = MINIMUM_PIXEL_AREA;
+	if (LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WATER0)
+	{
+		min_area = llmax(min_area, RenderReflectionMinPixelArea);
+	}
+
+	if (group->mPixelArea < min_area)
 	{
 		return;
 	}
@@ -2360,16 +2591,22 @@ void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
 
 	assertInitialized();
 	
+	//fragments culled on worker threads are merged and counted by updateCull
+	LLCullResult* cull = result ? result : sCull;
+
 	if (!group->mSpatialPartition->mRenderByGroup)
 	{ //render by drawable
-		sCull->pushDrawableGroup(group);
+		cull->pushDrawableGroup(group);
 	}
 	else
 	{   //render by group
-		sCull->pushVisibleGroup(group);
+		cull->pushVisibleGroup(group);
 	}
 
-	mNumVisibleNodes++;
+	if (!result)
+	{
+		mNumVisibleNodes++;
+	}
 }
 
 void LLPipeline::markOccluder(LLSpatialGroup* group)
@@ -2693,6 +2930,8 @@ void LLPipeline::markMoved(LLDrawable *drawablep, BOOL damped_motion)
 		llwarns << "Marking NULL or dead drawable moved!" << llendl;
 		return;
 	}
+
+	markLightMoved(drawablep);
 	
 	if (drawablep->getParent()) 
 	{
@@ -2786,6 +3025,11 @@ void LLPipeline::shiftObjects(const LLVector3 &offset)
 		}
 	}
 
+	// every binned position just changed, bin them all again
+	mLightGrid.clear();
+	mLightCells.clear();
+	mLightsToBin = mLights;
+
 	LLHUDText::shiftAll(offset);
 	LLHUDNameTag::shiftAll(offset);
 	display_update_camera();
@@ -3330,6 +3574,76 @@ void renderSoundHighlights(LLDrawable* drawablep)
 	}
 }
 
+// Sorts alpha groups back to front, starting from the order the previous call
+// left them in.  The camera rarely moves far in a frame, so the order is
+// nearly right already and an insertion sort fixes it up in about linear
+// time.  Only meant for one camera, since each call overwrites the order.
+static void sort_alpha_groups_coherent(LLCullResult::sg_list_t::iterator begin, LLCullResult::sg_list_t::iterator end)
+{
+	static U32 epoch = 1;
+	static U32 last_count = 0;
+	static std::vector<LLSpatialGroup*> slots;
+	static std::vector<LLSpatialGroup*> fresh;
+
+	const U32 count = end - begin;
+	const U32 last_epoch = epoch++;
+
+	//put groups sorted last time back in that order, followed by the new ones
+	slots.assign(last_count, NULL);
+	fresh.clear();
+	for (LLCullResult::sg_list_t::iterator iter = begin; iter != end; ++iter)
+	{
+		LLSpatialGroup* group = *iter;
+		if (group->mAlphaSortEpoch == last_epoch && group->mAlphaSortIndex < last_count && !slots[group->mAlphaSortIndex])
+		{
+			slots[group->mAlphaSortIndex] = group;
+		}
+		else
+		{
+			fresh.push_back(group);
+		}
+	}
+
+	LLCullResult::sg_list_t::iterator out = begin;
+	for (U32 i = 0; i < last_count; ++i)
+	{
+		if (slots[i])
+		{
+			*out++ = slots[i];
+		}
+	}
+	std::copy(fresh.begin(), fresh.end(), out);
+
+	//insertion sort, giving up on it when too much has changed (teleports, big camera jumps)
+	LLSpatialGroup::CompareDepthGreater greater;
+	const U32 max_shifts = count * 4 + 64;
+	U32 shifts = 0;
+	for (U32 i = 1; i < count && shifts <= max_shifts; ++i)
+	{
+		LLSpatialGroup* group = begin[i];
+		U32 j = i;
+		while (j > 0 && greater(group, begin[j-1]) && shifts <= max_shifts)
+		{
+			begin[j] = begin[j-1];
+			--j;
+			++shifts;
+		}
+		begin[j] = group;
+	}
+
+	if (shifts > max_shifts)
+	{
+		std::sort(begin, end, greater);
+	}
+
+	for (U32 i = 0; i < count; ++i)
+	{
+		begin[i]->mAlphaSortIndex = i;
+		begin[i]->mAlphaSortEpoch = epoch;
+	}
+	last_count = count;
+}
+
 void LLPipeline::postSort(LLCamera& camera)
 {
 	LLMemType mt(LLMemType::MTYPE_PIPELINE_POST_SORT);
@@ -3439,10 +3753,33 @@ void LLPipeline::postSort(LLCamera& camera)
 			}
 		}
 	}
+
+	static LLCachedControl<bool> sort_batches(gSavedSettings, "RenderSortBatches");
+	if (sort_batches)
+	{ //order each opaque pass by render state across groups so pools rebind less and can merge adjacent ranges
+		LLFastTimer t(FTM_STATESORT_BATCHES);
+		for (U32 i = LLRenderPass::PASS_SIMPLE; i < LLRenderPass::NUM_RENDER_TYPES; ++i)
+		{
+			if (i == LLRenderPass::PASS_ALPHA || i == LLRenderPass::PASS_ALPHA_INVISIBLE)
+			{ //alpha is drawn back to front
+				continue;
+			}
+
+			std::sort(sCull->beginRenderMap(i), sCull->endRenderMap(i), LLDrawInfo::CompareRenderState());
+		}
+	}
 		
 	if (!sShadowRender)
 	{
-		std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
+		static LLCachedControl<bool> coherent_alpha_sort(gSavedSettings, "RenderSortAlphaCoherent");
+		if (coherent_alpha_sort && LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WORLD)
+		{
+			sort_alpha_groups_coherent(sCull->beginAlphaGroups(), sCull->endAlphaGroups());
+		}
+		else
+		{
+			std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
+		}
 	}
 	llpushcallstacks ;
 	// only render if the flag is set. The flag is only set if we are in edit mode or the toggle is set in the menus
@@ -3877,6 +4214,7 @@ void LLPipeline::renderGeom(LLCamera& camera, BOOL forceVBOUpdate)
 			if (hasRenderType(poolp->getType()) && poolp->getNumPasses() > 0)
 			{
 				LLFastTimer t(FTM_POOLRENDER);
+				LLGPUTimer::Scope gpu_timer(gpu_pool_timer(cur_type));
 
 				gGLLastMatrix = NULL;
 				gGL.loadMatrix(gGLModelView);
@@ -4007,6 +4345,7 @@ void LLPipeline::renderGeomDeferred(LLCamera& camera)
 
 	LLMemType mt_rgd(LLMemType::MTYPE_PIPELINE_RENDER_GEOM_DEFFERRED);
 	LLFastTimer t(FTM_RENDER_GEOMETRY);
+	LLGPUTimer::Scope gpu_timer(GPU_DEFERRED_GEOMETRY);
 
 	LLFastTimer t2(FTM_POOLS);
 
@@ -4051,6 +4390,7 @@ void LLPipeline::renderGeomDeferred(LLCamera& camera)
 		if (hasRenderType(poolp->getType()) && poolp->getNumDeferredPasses() > 0)
 		{
 			LLFastTimer t(FTM_POOLRENDER);
+			LLGPUTimer::Scope gpu_timer(gpu_pool_timer(cur_type));
 
 			gGLLastMatrix = NULL;
 			gGL.loadMatrix(gGLModelView);
@@ -4104,6 +4444,7 @@ void LLPipeline::renderGeomPostDeferred(LLCamera& camera)
 {
 	LLMemType mt_rgpd(LLMemType::MTYPE_PIPELINE_RENDER_GEOM_POST_DEF);
 	LLFastTimer t(FTM_POOLS);
+	LLGPUTimer::Scope gpu_timer(GPU_POST_DEFERRED);
 	U32 cur_type = 0;
 
 	LLGLEnable cull(GL_CULL_FACE);
@@ -4138,6 +4479,7 @@ void LLPipeline::renderGeomPostDeferred(LLCamera& camera)
 		if (hasRenderType(poolp->getType()) && poolp->getNumPostDeferredPasses() > 0)
 		{
 			LLFastTimer t(FTM_POOLRENDER);
+			LLGPUTimer::Scope gpu_timer(gpu_pool_timer(cur_type));
 
 			gGLLastMatrix = NULL;
 			gGL.loadMatrix(gGLModelView);
@@ -5071,6 +5413,25 @@ void LLPipeline::setupAvatarLights(BOOL for_edit)
 	}
 }
 
+// lights are binned into cubes this many meters on a side
+const F32 LIGHT_GRID_CELL_SIZE = 64.f;
+// bucket for lights that are checked every frame wherever they are
+const U64 LIGHT_CELL_ALWAYS = ~(U64) 0;
+// a new light has to be this much closer than the farthest nearby light to
+// push it out, so two lights at about the same distance don't trade places
+const F32 LIGHT_SWAP_HYSTERESIS = 2.f;
+
+static S32 light_grid_coord(F32 pos)
+{
+	return (S32) floorf(pos / LIGHT_GRID_CELL_SIZE);
+}
+
+// 21 bits per axis is plenty for agent space, and never collides with LIGHT_CELL_ALWAYS
+static U64 light_grid_key(S32 x, S32 y, S32 z)
+{
+	return ((U64) (x & 0x1FFFFF) << 42) | ((U64) (y & 0x1FFFFF) << 21) | (U64) (z & 0x1FFFFF);
+}
+
 static F32 calc_light_dist(LLVOVolume* light, const LLVector3& cam_pos, F32 max_dist)
 {
 	F32 inten = light->getLightIntensity();
@@ -5152,35 +5513,75 @@ void LLPipeline::calcNearbyLights(LLCamera& camera)
 		mNearbyLights = cur_nearby_lights;
 				
 		// FIND NEW LIGHTS THAT ARE IN RANGE
-		light_set_t new_nearby_lights;
-		for (LLDrawable::drawable_set_t::iterator iter = mLights.begin();
-			 iter != mLights.end(); ++iter)
+		binPendingLights();
+
+		// only the cells a light in range could be binned in, plus the always bucket
+		static std::vector<LLDrawable::drawable_vector_t*> buckets;
+		buckets.clear();
+
+		light_grid_t::iterator always = mLightGrid.find(LIGHT_CELL_ALWAYS);
+		if (always != mLightGrid.end())
 		{
-			LLDrawable* drawable = *iter;
-			LLVOVolume* light = drawable->getVOVolume();
-			if (!light || drawable->isState(LLDrawable::NEARBY_LIGHT))
-			{
-				continue;
-			}
-			if (light->isHUDAttachment())
-			{
-				continue; // no lighting from HUD objects
-			}
-			F32 dist = calc_light_dist(light, cam_pos, max_dist);
-			if (dist >= max_dist)
-			{
-				continue;
-			}
-			if (!sRenderAttachedLights && light && light->isAttachment())
+			buckets.push_back(&always->second);
+		}
+
+		const F32 reach = max_dist + LIGHT_MAX_RADIUS;
+		S32 min_cell[3];
+		S32 max_cell[3];
+		for (U32 i = 0; i < 3; ++i)
+		{
+			min_cell[i] = light_grid_coord(cam_pos.mV[i] - reach);
+			max_cell[i] = light_grid_coord(cam_pos.mV[i] + reach);
+		}
+
+		for (S32 x = min_cell[0]; x <= max_cell[0]; ++x)
+		{
+			for (S32 y = min_cell[1]; y <= max_cell[1]; ++y)
 			{
-				continue;
+				for (S32 z = min_cell[2]; z <= max_cell[2]; ++z)
+				{
+					light_grid_t::iterator cell = mLightGrid.find(light_grid_key(x, y, z));
+					if (cell != mLightGrid.end())
+					{
+						buckets.push_back(&cell->second);
+					}
+				}
 			}
-			new_nearby_lights.insert(Light(drawable, dist, 0.f));
-			if (new_nearby_lights.size() > (U32)MAX_LOCAL_LIGHTS)
+		}
+
+		light_set_t new_nearby_lights;
+		for (U32 b = 0; b < buckets.size(); ++b)
+		{
+			LLDrawable::drawable_vector_t& bucket = *buckets[b];
+			for (LLDrawable::drawable_vector_t::iterator iter = bucket.begin();
+				 iter != bucket.end(); ++iter)
 			{
-				new_nearby_lights.erase(--new_nearby_lights.end());
-				const Light& last = *new_nearby_lights.rbegin();
-				max_dist = last.dist;
+				LLDrawable* drawable = *iter;
+				LLVOVolume* light = drawable->getVOVolume();
+				if (!light || drawable->isState(LLDrawable::NEARBY_LIGHT))
+				{
+					continue;
+				}
+				if (light->isHUDAttachment())
+				{
+					continue; // no lighting from HUD objects
+				}
+				F32 dist = calc_light_dist(light, cam_pos, max_dist);
+				if (dist >= max_dist)
+				{
+					continue;
+				}
+				if (!sRenderAttachedLights && light && light->isAttachment())
+				{
+					continue;
+				}
+				new_nearby_lights.insert(Light(drawable, dist, 0.f));
+				if (new_nearby_lights.size() > (U32)MAX_LOCAL_LIGHTS)
+				{
+					new_nearby_lights.erase(--new_nearby_lights.end());
+					const Light& last = *new_nearby_lights.rbegin();
+					max_dist = last.dist;
+				}
 			}
 		}
 
@@ -5200,7 +5601,7 @@ void LLPipeline::calcNearbyLights(LLCamera& camera)
 				// even though gcc enforces sets as const
 				// (fade value doesn't affect sort so this is safe)
 				Light* farthest_light = ((Light*) (&(*(mNearbyLights.rbegin()))));
-				if (light->dist < farthest_light->dist)
+				if (light->dist < farthest_light->dist - LIGHT_SWAP_HYSTERESIS)
 				{
 					if (farthest_light->fade >= 0.f)
 					{
@@ -5217,6 +5618,81 @@ void LLPipeline::calcNearbyLights(LLCamera& camera)
 	}
 }
 
+void LLPipeline::markLightMoved(LLDrawable* drawablep)
+{
+	if (!drawablep || !drawablep->isState(LLDrawable::LIGHT))
+	{
+		return;
+	}
+
+	LLFlatHashMap<LLDrawable*, U64>::iterator cell = mLightCells.find(drawablep);
+	if (cell != mLightCells.end() && cell->second == LIGHT_CELL_ALWAYS && drawablep->isActive())
+	{
+		return; // moving lights stay in the bucket checked every frame
+	}
+	mLightsToBin.insert(drawablep);
+}
+
+void LLPipeline::unbinLight(LLDrawable* drawablep)
+{
+	LLFlatHashMap<LLDrawable*, U64>::iterator cell = mLightCells.find(drawablep);
+	if (cell == mLightCells.end())
+	{
+		return;
+	}
+
+	light_grid_t::iterator bucket = mLightGrid.find(cell->second);
+	if (bucket != mLightGrid.end())
+	{
+		LLDrawable::drawable_vector_t& lights = bucket->second;
+		for (U32 i = 0; i < lights.size(); ++i)
+		{
+			if (lights[i] == drawablep)
+			{
+				lights[i] = lights.back();
+				lights.pop_back();
+				break;
+			}
+		}
+		if (lights.empty())
+		{
+			mLightGrid.erase(bucket);
+		}
+	}
+	mLightCells.erase(cell);
+}
+
+void LLPipeline::binPendingLights()
+{
+	for (LLDrawable::drawable_set_t::iterator iter = mLightsToBin.begin();
+		 iter != mLightsToBin.end(); ++iter)
+	{
+		LLDrawable* drawablep = *iter;
+		unbinLight(drawablep);
+
+		LLVOVolume* light = drawablep->getVOVolume();
+		if (!light || drawablep->isDead() || !drawablep->isState(LLDrawable::LIGHT))
+		{
+			continue;
+		}
+
+		// selected lights are picked at any distance, moving ones may not
+		// be where they were binned
+		U64 key = LIGHT_CELL_ALWAYS;
+		if (!drawablep->isActive() && !light->isAttachment() && !light->isSelected())
+		{
+			const LLVector3 pos = light->getRenderPosition();
+			key = light_grid_key(light_grid_coord(pos.mV[VX]),
+								 light_grid_coord(pos.mV[VY]),
+								 light_grid_coord(pos.mV[VZ]));
+		}
+
+		mLightGrid[key].push_back(drawablep);
+		mLightCells[drawablep] = key;
+	}
+	mLightsToBin.clear();
+}
+
 void LLPipeline::setupHWLights(LLDrawPool* pool)
 {
 	assertInitialized();
@@ -5773,11 +6249,14 @@ void LLPipeline::setLight(LLDrawable *drawablep, BOOL is_light)
 		{
 			mLights.insert(drawablep);
 			drawablep->setState(LLDrawable::LIGHT);
+			mLightsToBin.insert(drawablep);
 		}
 		else
 		{
 			drawablep->clearState(LLDrawable::LIGHT);
 			mLights.erase(drawablep);
+			mLightsToBin.erase(drawablep);
+			unbinLight(drawablep);
 		}
 	}
 }
@@ -6252,6 +6731,12 @@ void LLPipeline::doResetVertexBuffers()
 				part->resetVertexBuffers();
 			}
 		}
+
+		LLViewerParcelOverlay* overlay = region->getParcelOverlay();
+		if (overlay)
+		{
+			overlay->resetVertexBuffers();
+		}
 	}
 
 	resetDrawOrders();
@@ -6273,6 +6758,7 @@ void LLPipeline::doResetVertexBuffers()
 	sRenderBump = gSavedSettings.getBOOL("RenderObjectBump");
 	sUseTriStrips = gSavedSettings.getBOOL("RenderUseTriStrips");
 	LLVertexBuffer::sUseStreamDraw = gSavedSettings.getBOOL("RenderUseStreamVBO");
+	LLVertexBuffer::sUseStreamRing = gSavedSettings.getBOOL("RenderUseStreamRing");
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBOOL("RenderUseVAO");
 	LLVertexBuffer::sPreferStreamDraw = gSavedSettings.getBOOL("RenderPreferStreamDraw");
 	LLVertexBuffer::sEnableVBOs = gSavedSettings.getBOOL("RenderVBOEnable");
@@ -6366,6 +6852,8 @@ void LLPipeline::renderBloom(BOOL for_snapshot, F32 zoom_factor, int subfield)
 		return;
 	}
 
+	LLGPUTimer::Scope gpu_timer(GPU_POST_PROCESS);
+
 	LLVertexBuffer::unbind();
 	LLGLState::checkStates();
 	LLGLState::checkTextureChannels();
@@ -6981,7 +7469,7 @@ void LLPipeline::renderBloom(BOOL for_snapshot, F32 zoom_factor, int subfield)
 	if (LLRenderTarget::sUseFBO)
 	{ //copy depth buffer from mScreen to framebuffer
 		LLRenderTarget::copyContentsToFramebuffer(mScreen, 0, 0, mScreen.getWidth(), mScreen.getHeight(), 
-			0, 0, mScreen.getWidth(), mScreen.getHeight(), GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+			0, 0, mScreenWidth, mScreenHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 	}
 	
 
@@ -7214,6 +7702,7 @@ static LLFastTimer::DeclareTimer FTM_EDGE_DETECTION("Find Edges");
 static LLFastTimer::DeclareTimer FTM_LOCAL_LIGHTS("Local Lights");
 static LLFastTimer::DeclareTimer FTM_ATMOSPHERICS("Atmospherics");
 static LLFastTimer::DeclareTimer FTM_FULLSCREEN_LIGHTS("Fullscreen Lights");
+static LLFastTimer::DeclareTimer FTM_TILED_LIGHTS("Tiled Lights");
 static LLFastTimer::DeclareTimer FTM_PROJECTORS("Projectors");
 static LLFastTimer::DeclareTimer FTM_POST("Post");
 
@@ -7225,6 +7714,8 @@ void LLPipeline::renderDeferredLighting()
 		return;
 	}
 
+	LLGPUTimer::Scope gpu_timer(GPU_DEFERRED_LIGHTING);
+
 	{
 		LLFastTimer ftm(FTM_RENDER_DEFERRED);
 
@@ -7256,6 +7747,7 @@ void LLPipeline::renderDeferredLighting()
 		LLGLEnable blend(GL_BLEND);
 
 		glh::matrix4f mat = glh_copy_matrix(gGLModelView);
+		glh::matrix4f proj = glh_get_current_projection();
 
 		LLStrider<LLVector3> vert; 
 		mDeferredVB->getVertexStrider(vert);
@@ -7453,6 +7945,7 @@ void LLPipeline::renderDeferredLighting()
 		}
 
 		BOOL render_local = RenderLocalLights;
+		BOOL tiled_lights = RenderDeferredTiledLights;
 				
 		if (render_local)
 		{
@@ -7554,6 +8047,13 @@ void LLPipeline::renderDeferredLighting()
 								spot_lights.push_back(drawablep);
 								continue;
 							}
+
+							if (tiled_lights)
+							{ //binned with the fullscreen lights and shaded per tile below
+								fullscreen_lights.push_back(LLVector4(tc.v[0], tc.v[1], tc.v[2], s*s));
+								light_colors.push_back(LLVector4(col.mV[0], col.mV[1], col.mV[2], volume->getLightFalloff()*0.5f));
+								continue;
+							}
 							
 							LLFastTimer ftm(FTM_LOCAL_LIGHTS);
 							//glTexCoord4f(tc.v[0], tc.v[1], tc.v[2], s*s);
@@ -7673,6 +8173,14 @@ void LLPipeline::renderDeferredLighting()
 
 				F32 far_z = 0.f;
 
+				if (tiled_lights && !fullscreen_lights.empty())
+				{
+					LLFastTimer ftm(FTM_TILED_LIGHTS);
+					renderTiledLights(fullscreen_lights, light_colors, proj);
+					fullscreen_lights.clear();
+					light_colors.clear();
+				}
+
 				while (!fullscreen_lights.empty())
 				{
 					LLFastTimer ftm(FTM_FULLSCREEN_LIGHTS);
@@ -7794,6 +8302,130 @@ void LLPipeline::renderDeferredLighting()
 						
 }
 
+void LLPipeline::renderTiledLights(const std::list<LLVector4>& lights, const std::list<LLVector4>& colors, const glh::matrix4f& proj)
+{
+	//must match MAX_LIGHT_COUNT in multiPointLightF.glsl
+	const U32 max_count = 16;
+
+	std::vector<LLVector4> light_list(lights.begin(), lights.end());
+	std::vector<LLVector4> color_list(colors.begin(), colors.end());
+
+	const S32 width = mScreen.getWidth();
+	const S32 height = mScreen.getHeight();
+	const S32 tile_size = llmax((S32) RenderDeferredLightTileSize, 16);
+	const S32 tiles_x = (width + tile_size - 1) / tile_size;
+	const S32 tiles_y = (height + tile_size - 1) / tile_size;
+
+	if (tiles_x <= 0 || tiles_y <= 0)
+	{
+		return;
+	}
+
+	mLightTiles.resize(tiles_x*tiles_y);
+	for (U32 i = 0; i < mLightTiles.size(); ++i)
+	{
+		mLightTiles[i].clear();
+	}
+
+	const F32 near_z = -LLViewerCamera::getInstance()->getNear();
+
+	//bin each light into the tiles covered by the screen space bounds of its sphere
+	for (U32 i = 0; i < light_list.size(); ++i)
+	{
+		const LLVector4& l = light_list[i];
+		F32 r = sqrtf(l.mV[3]);
+
+		S32 x0 = 0;
+		S32 y0 = 0;
+		S32 x1 = tiles_x-1;
+		S32 y1 = tiles_y-1;
+
+		if (l.mV[2] + r < near_z)
+		{ //entirely in front of the near plane, bound the projected corners of the light's box
+			F32 min_x = 1.f;
+			F32 min_y = 1.f;
+			F32 max_x = -1.f;
+			F32 max_y = -1.f;
+
+			for (U32 j = 0; j < 8; ++j)
+			{
+				glh::vec4f p(l.mV[0] + ((j & 4) ? r : -r),
+							l.mV[1] + ((j & 2) ? r : -r),
+							l.mV[2] + ((j & 1) ? r : -r),
+							1.f);
+				proj.mult_matrix_vec(p);
+
+				F32 x = p.v[0]/p.v[3];
+				F32 y = p.v[1]/p.v[3];
+				min_x = llmin(min_x, x);
+				min_y = llmin(min_y, y);
+				max_x = llmax(max_x, x);
+				max_y = llmax(max_y, y);
+			}
+
+			if (max_x < -1.f || max_y < -1.f || min_x > 1.f || min_y > 1.f)
+			{
+				continue;
+			}
+
+			x0 = llclamp((S32) ((llmax(min_x, -1.f)*0.5f+0.5f)*width) / tile_size, 0, tiles_x-1);
+			x1 = llclamp((S32) ((llmin(max_x, 1.f)*0.5f+0.5f)*width) / tile_size, 0, tiles_x-1);
+			y0 = llclamp((S32) ((llmax(min_y, -1.f)*0.5f+0.5f)*height) / tile_size, 0, tiles_y-1);
+			y1 = llclamp((S32) ((llmin(max_y, 1.f)*0.5f+0.5f)*height) / tile_size, 0, tiles_y-1);
+		}
+
+		for (S32 y = y0; y <= y1; ++y)
+		{
+			for (S32 x = x0; x <= x1; ++x)
+			{
+				mLightTiles[y*tiles_x+x].push_back(i);
+			}
+		}
+	}
+
+	LLGLEnable scissor(GL_SCISSOR_TEST);
+
+	LLVector4 light[max_count];
+	LLVector4 col[max_count];
+
+	for (S32 y = 0; y < tiles_y; ++y)
+	{
+		for (S32 x = 0; x < tiles_x; ++x)
+		{
+			const std::vector<U32>& tile = mLightTiles[y*tiles_x+x];
+			if (tile.empty())
+			{
+				continue;
+			}
+
+			glScissor(x*tile_size, y*tile_size, tile_size, tile_size);
+
+			U32 count = 0;
+			F32 far_z = 0.f;
+
+			for (U32 i = 0; i < tile.size(); ++i)
+			{
+				light[count] = light_list[tile[i]];
+				col[count] = color_list[tile[i]];
+
+				far_z = llmin(light[count].mV[2]-sqrtf(light[count].mV[3]), far_z);
+
+				count++;
+				if (count == max_count || i == tile.size()-1)
+				{
+					gDeferredMultiLightProgram.uniform1i(LLShaderMgr::MULTI_LIGHT_COUNT, count);
+					gDeferredMultiLightProgram.uniform4fv(LLShaderMgr::MULTI_LIGHT, count, (GLfloat*) light);
+					gDeferredMultiLightProgram.uniform4fv(LLShaderMgr::MULTI_LIGHT_COL, count, (GLfloat*) col);
+					gDeferredMultiLightProgram.uniform1f(LLShaderMgr::MULTI_LIGHT_FAR_Z, far_z);
+					far_z = 0.f;
+					count = 0;
+					mDeferredVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+				}
+			}
+		}
+	}
+}
+
 void LLPipeline::setupSpotLight(LLGLSLShader& shader, LLDrawable* drawablep)
 {
 	//construct frustum
@@ -7988,6 +8620,26 @@ void LLPipeline::generateWaterReflection(LLCamera& camera_in)
 {	
 	if (LLPipeline::sWaterReflections && assertInitialized() && LLDrawPoolWater::sNeedsReflectionUpdate)
 	{
+		LLGPUTimer::Scope gpu_timer(GPU_WATER_REFLECTION);
+		glh::matrix4f mvp = glh_get_current_projection() * glh_get_current_modelview();
+		BOOL under_water = LLViewerCamera::getInstance()->cameraUnderWater();
+		U32 frame = LLFrameTimer::getFrameCount();
+
+		if (RenderReflectionUpdateInterval > 1 && mWaterReflectionFrame != 0 &&
+			frame - mWaterReflectionFrame < RenderReflectionUpdateInterval &&
+			under_water == mWaterReflectionUnderWater)
+		{ //reuse the maps from the last update, mapped from this frame's clip space into the one they were rendered with
+			mWaterReflectionReproject = mWaterReflectionMVP * mvp.inverse();
+			LLDrawPoolWater::sNeedsReflectionUpdate = FALSE;
+			LLDrawPoolWater::sNeedsDistortionUpdate = FALSE;
+			return;
+		}
+
+		mWaterReflectionFrame = frame;
+		mWaterReflectionUnderWater = under_water;
+		mWaterReflectionMVP = mvp;
+		mWaterReflectionReproject.make_identity();
+
 		BOOL skip_avatar_update = FALSE;
 		if (!isAgentAvatarValid() || gAgentCamera.getCameraAnimating() || gAgentCamera.getCameraMode() != CAMERA_MODE_MOUSELOOK || !LLVOAvatar::sVisibleInFirstPerson)
 		{
@@ -8005,7 +8657,7 @@ void LLPipeline::generateWaterReflection(LLCamera& camera_in)
 		LLGLState::checkClientArrays();
 
 		LLCamera camera = camera_in;
-		camera.setFar(camera.getFar()*0.87654321f);
+		camera.setFar(camera.getFar()*llclamp(RenderReflectionDistance, 0.1f, 1.f));
 		LLPipeline::sReflectionRender = TRUE;
 		
 		gPipeline.pushRenderTypeMask();
@@ -8231,6 +8883,10 @@ void LLPipeline::generateWaterReflection(LLCamera& camera_in)
 
 		LLViewerCamera::sCurCameraID = LLViewerCamera::CAMERA_WORLD;
 	}
+	else
+	{
+		mWaterReflectionReproject.make_identity();
+	}
 }
 
 glh::matrix4f look(const LLVector3 pos, const LLVector3 dir, const LLVector3 up)
@@ -8684,6 +9340,59 @@ void LLPipeline::generateHighlight(LLCamera& camera)
 	}
 }
 
+bool LLPipeline::canReuseSunShadow(U32 cascade, LLCamera& camera, const LLVector3& light_dir, F32 near_dist, F32 far_dist) const
+{
+	//only the far cascades are cheap enough to get away with stale depth,
+	//the near ones are where moving objects and self shadowing show up
+	if (RenderShadowCacheInterval == 0 || cascade < 2 || cascade >= 4)
+	{
+		return false;
+	}
+
+	const ShadowCacheEntry& entry = mShadowCache[cascade];
+	if (!entry.mValid || hasRenderDebugMask(RENDER_DEBUG_SHADOW_FRUSTA))
+	{
+		return false;
+	}
+
+	if (LLFrameTimer::getFrameCount() - entry.mFrame >= RenderShadowCacheInterval)
+	{
+		return false;
+	}
+
+	if (dist_vec(camera.getOrigin(), entry.mOrigin) > RenderShadowCacheDistance ||
+		camera.getAtAxis() * entry.mAt < 0.999f ||
+		light_dir * entry.mLightDir < 0.9999f)
+	{
+		return false;
+	}
+
+	//split distances move with the camera far clip and shadow settings
+	if (fabsf(near_dist - entry.mNear) > entry.mNear * 0.1f ||
+		fabsf(far_dist - entry.mFar) > entry.mFar * 0.1f)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void LLPipeline::updateSunShadowCache(U32 cascade, LLCamera& camera, const LLVector3& light_dir, F32 near_dist, F32 far_dist)
+{
+	if (cascade >= 4)
+	{
+		return;
+	}
+
+	ShadowCacheEntry& entry = mShadowCache[cascade];
+	entry.mValid = true;
+	entry.mFrame = LLFrameTimer::getFrameCount();
+	entry.mOrigin = camera.getOrigin();
+	entry.mAt = camera.getAtAxis();
+	entry.mLightDir = light_dir;
+	entry.mNear = near_dist;
+	entry.mFar = far_dist;
+}
 
 void LLPipeline::generateSunShadow(LLCamera& camera)
 {
@@ -8692,6 +9401,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 		return;
 	}
 
+	LLGPUTimer::Scope gpu_timer(GPU_SHADOWS);
+
 	BOOL skip_avatar_update = FALSE;
 	if (!isAgentAvatarValid() || gAgentCamera.getCameraAnimating() || gAgentCamera.getCameraMode() != CAMERA_MODE_MOUSELOOK || !LLVOAvatar::sVisibleInFirstPerson)
 	{
@@ -8874,6 +9585,11 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 	// convenience array of 4 near clip plane distances
 	F32 dist[] = { near_clip, mSunClipPlanes.mV[0], mSunClipPlanes.mV[1], mSunClipPlanes.mV[2], mSunClipPlanes.mV[3] };
 	
+	//translate and scale to from [-1, 1] to [0, 1]
+	glh::matrix4f trans(0.5f, 0.f, 0.f, 0.5f,
+					0.f, 0.5f, 0.f, 0.5f,
+					0.f, 0.f, 0.5f, 0.5f,
+					0.f, 0.f, 0.f, 1.f);
 
 	if (mSunDiffuse == LLColor4::black)
 	{ //sun diffuse is totally black, shadows don't matter
@@ -8884,12 +9600,19 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 			mShadow[j].bindTarget();
 			mShadow[j].clear();
 			mShadow[j].flush();
+			mShadowCache[j].mValid = false;
 		}
 	}
 	else
 	{
 		for (S32 j = 0; j < 4; j++)
 		{
+			if (canReuseSunShadow(j, camera, lightDir, dist[j], dist[j+1]))
+			{ //shadow map from an earlier frame still covers this split, just bring its matrix into the current eye space
+				mSunShadowMatrix[j] = trans*mShadowProjection[j]*mShadowModelview[j]*inv_view;
+				continue;
+			}
+
 			if (!hasRenderDebugMask(RENDER_DEBUG_SHADOW_FRUSTA))
 			{
 				mShadowFrustPoints[j].clear();
@@ -8958,6 +9681,7 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 
 				mShadowError.mV[j] = 0.f;
 				mShadowFOV.mV[j] = 0.f;
+				mShadowCache[j].mValid = false;
 
 				continue;
 			}
@@ -9220,12 +9944,6 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 			//shadow_cam.ignoreAgentFrustumPlane(LLCamera::AGENT_PLANE_NEAR);
 			shadow_cam.getAgentPlane(LLCamera::AGENT_PLANE_NEAR).set(shadow_near_clip);
 
-			//translate and scale to from [-1, 1] to [0, 1]
-			glh::matrix4f trans(0.5f, 0.f, 0.f, 0.5f,
-							0.f, 0.5f, 0.f, 0.5f,
-							0.f, 0.f, 0.5f, 0.5f,
-							0.f, 0.f, 0.f, 1.f);
-
 			glh_set_current_modelview(view[j]);
 			glh_set_current_projection(proj[j]);
 
@@ -9255,6 +9973,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 			}
 
 			mShadow[j].flush();
+
+			updateSunShadowCache(j, camera, lightDir, dist[j], dist[j+1]);
  
 			if (!gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_SHADOW_FRUSTA))
 			{
@@ -9584,7 +10304,39 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar)
 	U32 resY = llmin(nhpo2((U32) (fov*pa)), (U32) 512);
 	U32 resX = llmin(nhpo2((U32) (atanf(tdim.mV[0]/distance)*2.f*RAD_TO_DEG*pa)), (U32) 512);
 
-	if (!avatar->mImpostor.isComplete() || resX != avatar->mImpostor.getWidth() ||
+	static LLCachedControl<bool> use_impostor_atlas(gSavedSettings, "RenderAvatarImpostorAtlas");
+
+	S32 slot = -1;
+	U32 slot_x = 0;
+	U32 slot_y = 0;
+
+	if (use_impostor_atlas && LLGLSLShader::sNoFixedFunction && LLRenderTarget::sUseFBO)
+	{
+		if (!mImpostorAtlas.isComplete() && mImpostorAtlas.allocate() && LLPipeline::sRenderDeferred)
+		{
+			addDeferredAttachments(mImpostorAtlas.mTarget);
+		}
+
+		if (mImpostorAtlas.isComplete())
+		{
+			slot = mImpostorAtlas.allocateSlot(avatar, resX, resY);
+		}
+	}
+	else if (avatar->mImpostorSlot >= 0)
+	{
+		mImpostorAtlas.freeSlot(avatar->mImpostorSlot);
+	}
+
+	LLRenderTarget* target = &avatar->mImpostor;
+
+	if (slot >= 0)
+	{
+		U32 slot_size;
+		mImpostorAtlas.getSlotRect(slot, slot_x, slot_y, slot_size);
+		avatar->mImpostor.release();
+		target = &mImpostorAtlas.mTarget;
+	}
+	else if (!avatar->mImpostor.isComplete() || resX != avatar->mImpostor.getWidth() ||
 		resY != avatar->mImpostor.getHeight())
 	{
 		avatar->mImpostor.allocate(resX,resY,GL_RGBA,TRUE,FALSE);
@@ -9599,19 +10351,22 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar)
 		gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
 	}
 
-	avatar->mImpostor.bindTarget();
+	target->bindTarget();
+
+	//confine rendering to this impostor's slot when drawing into the atlas
+	glViewport(slot_x, slot_y, resX, resY);
+	LLGLEnable scissor(GL_SCISSOR_TEST);
+	glScissor(slot_x, slot_y, resX, resY);
 
 	if (LLPipeline::sRenderDeferred)
 	{
-		avatar->mImpostor.clear();
+		target->clear();
 		renderGeomDeferred(camera);
 		renderGeomPostDeferred(camera);
 	}
 	else
 	{
-		LLGLEnable scissor(GL_SCISSOR_TEST);
-		glScissor(0, 0, resX, resY);
-		avatar->mImpostor.clear();
+		target->clear();
 		renderGeom(camera);
 	}
 	
@@ -9671,7 +10426,14 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar)
 		gGL.popMatrix();
 	}
 
-	avatar->mImpostor.flush();
+	target->flush();
+
+	if (slot >= 0)
+	{
+		F32 atlas_size = (F32) LLImpostorAtlas::ATLAS_SIZE;
+		avatar->mImpostorTexCoords[0].set(slot_x/atlas_size, slot_y/atlas_size);
+		avatar->mImpostorTexCoords[1].set((slot_x+resX)/atlas_size, (slot_y+resY)/atlas_size);
+	}
 
 	avatar->setImpostorDim(tdim);
 
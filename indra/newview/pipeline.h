@@ -39,6 +39,8 @@
 #include "llgl.h"
 #include "lldrawable.h"
 #include "llrendertarget.h"
+#include "llimpostoratlas.h"
+#include "llflathashmap.h"
 
 #include <stack>
 
@@ -56,6 +58,8 @@ class LLTextureEntry;
 class LLRenderFunc;
 class LLCubeMap;
 class LLCullResult;
+class LLParallelCull;
+class LLParallelFor;
 class LLVOAvatar;
 class LLGLSLShader;
 class LLCurlRequest;
@@ -113,6 +117,11 @@ public:
 	void resetVertexBuffers();
 	void doResetVertexBuffers();
 	void resizeScreenTexture();
+	//adapt the screen buffer resolution to the time the last frame took to render
+	void updateDynamicResolution(F32 frame_time);
+	// drawables and spatial groups waiting on a geometry rebuild
+	S32 getBuildQueueSize() const { return (S32)(mBuildQ1.size() + mBuildQ2.size()); }
+	S32 getGroupQueueSize() const { return (S32)(mGroupQ1.size() + mGroupQ2.size()); }
 	void releaseGLBuffers();
 	void releaseLUTBuffers();
 	void releaseScreenBuffers();
@@ -132,6 +141,9 @@ public:
 	void cleanup();
 	BOOL isInit() { return mInitialized; };
 
+	//NULL when RenderWorkerThreads is 0
+	LLParallelFor* getRenderWorkers() { return mRenderWorkers; }
+
 	/// @brief Get a draw pool from pool type (POOL_SIMPLE, POOL_MEDIA) and texture.
 	/// @return Draw pool, or NULL if not found.
 	LLDrawPool *findPool(const U32 pool_type, LLViewerTexture *tex0 = NULL);
@@ -155,7 +167,7 @@ public:
 	void        markVisible(LLDrawable *drawablep, LLCamera& camera);
 	void		markOccluder(LLSpatialGroup* group);
 	void		doOcclusion(LLCamera& camera);
-	void		markNotCulled(LLSpatialGroup* group, LLCamera &camera);
+	void		markNotCulled(LLSpatialGroup* group, LLCamera &camera, LLCullResult* result = NULL);
 	void        markMoved(LLDrawable *drawablep, BOOL damped_motion = FALSE);
 	void        markShift(LLDrawable *drawablep);
 	void        markTextured(LLDrawable *drawablep);
@@ -209,7 +221,7 @@ public:
 
 	void updateMoveDampedAsync(LLDrawable* drawablep);
 	void updateMoveNormalAsync(LLDrawable* drawablep);
-	void updateMovedList(LLDrawable::drawable_vector_t& move_list);
+	void updateMovedList(LLDrawable::drawable_vector_t& move_list, BOOL throttle = FALSE);
 	void updateMove();
 	BOOL visibleObjectsInFrustum(LLCamera& camera);
 	BOOL getVisibleExtents(LLCamera& camera, LLVector3 &min, LLVector3& max);
@@ -256,9 +268,14 @@ public:
 
 	void unbindDeferredShader(LLGLSLShader& shader);
 	void renderDeferredLighting();
+	//shade point lights (eye space center and radius squared) one screen tile at a time with gDeferredMultiLightProgram
+	void renderTiledLights(const std::list<LLVector4>& lights, const std::list<LLVector4>& colors, const glh::matrix4f& proj);
 	
 	void generateWaterReflection(LLCamera& camera);
 	void generateSunShadow(LLCamera& camera);
+	//true if sun shadow cascade can be reused from an earlier frame instead of rendered again
+	bool canReuseSunShadow(U32 cascade, LLCamera& camera, const LLVector3& light_dir, F32 near_dist, F32 far_dist) const;
+	void updateSunShadowCache(U32 cascade, LLCamera& camera, const LLVector3& light_dir, F32 near_dist, F32 far_dist);
 	void generateHighlight(LLCamera& camera);
 	void renderHighlight(const LLViewerObject* obj, F32 fade);
 	void setHighlightObject(LLDrawable* obj) { mHighlightObject = obj; }
@@ -291,6 +308,8 @@ public:
 	void shiftObjects(const LLVector3 &offset);
 
 	void setLight(LLDrawable *drawablep, BOOL is_light);
+	// light moved, changed between active and static, or was (de)selected
+	void markLightMoved(LLDrawable* drawablep);
 	
 	BOOL hasRenderBatches(const U32 type) const;
 	LLCullResult::drawinfo_list_t::iterator beginRenderMap(U32 type);
@@ -529,9 +548,16 @@ public:
 	//screen texture
 	U32 					mScreenWidth;
 	U32 					mScreenHeight;
+
+	//fraction of mScreenWidth/mScreenHeight the screen buffers are allocated at by RenderDynamicResolution
+	F32						mResolutionScale;
+	F32						mDynamicResFrameTime;
+	U32						mDynamicResFrames;
+	bool					mDynamicResize;
 	
 	LLRenderTarget			mScreen;
 	LLRenderTarget			mUIScreen;
+	LLRenderTarget			mHUDScreen;		// cached HUD layer, see LLHUDLayer
 	LLRenderTarget			mDeferredScreen;
 	LLRenderTarget			mFXAABuffer;
 	LLRenderTarget			mEdgeMap;
@@ -554,6 +580,35 @@ public:
 	glh::matrix4f			mSunShadowMatrix[6];
 	glh::matrix4f			mShadowModelview[6];
 	glh::matrix4f			mShadowProjection[6];
+
+	//state of each sun shadow cascade when it was last rendered
+	struct ShadowCacheEntry
+	{
+		ShadowCacheEntry() : mValid(false), mFrame(0), mNear(0.f), mFar(0.f) {}
+
+		bool mValid;
+		U32 mFrame;
+		LLVector3 mOrigin;
+		LLVector3 mAt;
+		LLVector3 mLightDir;
+		F32 mNear;
+		F32 mFar;
+	};
+	ShadowCacheEntry		mShadowCache[4];
+
+	//indices of the lights touching each screen tile, rebuilt by renderTiledLights
+	std::vector<std::vector<U32> > mLightTiles;
+
+	//shared render target for avatar impostors
+	LLImpostorAtlas			mImpostorAtlas;
+
+	//water reflection/distortion maps are only regenerated every RenderReflectionUpdateInterval frames,
+	//in between the water shader reprojects them from the frame they were rendered in
+	U32						mWaterReflectionFrame;
+	BOOL					mWaterReflectionUnderWater;
+	glh::matrix4f			mWaterReflectionMVP;
+	glh::matrix4f			mWaterReflectionReproject;
+
 	glh::matrix4f			mGIMatrix;
 	glh::matrix4f			mGIMatrixProj;
 	glh::matrix4f			mGIModelview;
@@ -640,6 +695,17 @@ protected:
 	
 	LLDrawable::drawable_set_t		mLights;
 	light_set_t						mNearbyLights; // lights near camera
+
+	// mLights bucketed by position so calcNearbyLights only visits the
+	// cells around the camera.  Moving, attached and selected lights share
+	// one bucket that is checked every frame.
+	void binPendingLights();
+	void unbinLight(LLDrawable* drawablep);
+
+	typedef LLFlatHashMap<U64, LLDrawable::drawable_vector_t> light_grid_t;
+	light_grid_t					mLightGrid;
+	LLFlatHashMap<LLDrawable*, U64>	mLightCells;	// bucket each binned light is in
+	LLDrawable::drawable_set_t		mLightsToBin;	// added or moved since last binned
 	LLColor4						mHWLightColors[8];
 	
 	/////////////////////////////////////////////
@@ -658,6 +724,9 @@ protected:
 
 	bool mResetVertexBuffers; //if true, clear vertex buffers on next update
 
+	LLParallelFor*					mRenderWorkers; //threads helping the render thread with culling and geometry fills, NULL if disabled
+	LLParallelCull*					mParallelCull; //culls passes without occlusion queries on mRenderWorkers
+
 	LLViewerObject::vobj_list_t		mCreateQ;
 		
 	LLDrawable::drawable_set_t		mRetexturedList;
@@ -785,11 +854,17 @@ public:
 	static F32 RenderDeferredSunWash;
 	static U32 RenderFSAASamples;
 	static U32 RenderResolutionDivisor;
+	static BOOL RenderDynamicResolution;
+	static F32 RenderDynamicResolutionTarget;
+	static F32 RenderDynamicResolutionMinScale;
 	static BOOL RenderUIBuffer;
+	static BOOL RenderHUDBuffer;
 	static S32 RenderShadowDetail;
 	static BOOL RenderDeferredSSAO;
 	static F32 RenderShadowResolutionScale;
 	static BOOL RenderLocalLights;
+	static BOOL RenderDeferredTiledLights;
+	static U32 RenderDeferredLightTileSize;
 	static BOOL RenderDelayCreation;
 	static BOOL RenderAnimateRes;
 	static BOOL FreezeTime;
@@ -840,6 +915,9 @@ public:
 	static F32 RenderShadowBlurDistFactor;
 	static BOOL RenderDeferredAtmospheric;
 	static S32 RenderReflectionDetail;
+	static F32 RenderReflectionDistance;
+	static F32 RenderReflectionMinPixelArea;
+	static U32 RenderReflectionUpdateInterval;
 	static F32 RenderHighlightFadeTime;
 	static LLVector3 RenderShadowClipPlanes;
 	static LLVector3 RenderShadowOrthoClipPlanes;
@@ -848,6 +926,8 @@ public:
 	static LLVector3 RenderShadowSplitExponent;
 	static F32 RenderShadowErrorCutoff;
 	static F32 RenderShadowFOVCutoff;
+	static U32 RenderShadowCacheInterval;
+	static F32 RenderShadowCacheDistance;
 	static BOOL CameraOffset;
 	static F32 CameraMaxCoF;
 	static F32 CameraDoFResScale;
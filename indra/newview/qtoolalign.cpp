@@ -398,20 +398,28 @@ BOOL bbox_overlap(LLBBox bbox1, LLBBox bbox2)
 
 
 
+// one root object in the selection, with its bbox before and after packing
+struct AlignEntry
+{
+	LLPointer<LLViewerObject> mObject;
+	LLBBox mOriginalBBox;
+	LLBBox mNewBBox;
+};
+
 // used to sort bboxes before packing
 class BBoxCompare
 {
 public:
-	BBoxCompare(S32 axis, F32 direction, std::map<LLPointer<LLViewerObject>, LLBBox >& bboxes) :
-		mAxis(axis), mDirection(direction), mBBoxes(bboxes) {}
+	BBoxCompare(S32 axis, F32 direction) :
+		mAxis(axis), mDirection(direction) {}
 
-	BOOL operator() (LLViewerObject* object1, LLViewerObject* object2)
+	bool operator() (const AlignEntry& entry1, const AlignEntry& entry2) const
 	{
-		LLVector3 corner1 = mBBoxes[object1].getCenterAgent() -
-			mDirection * mBBoxes[object1].getExtentLocal()/2.0;
+		LLVector3 corner1 = entry1.mOriginalBBox.getCenterAgent() -
+			mDirection * entry1.mOriginalBBox.getExtentLocal()/2.0;
 
-		LLVector3 corner2 = mBBoxes[object2].getCenterAgent() -
-			mDirection * mBBoxes[object2].getExtentLocal()/2.0;
+		LLVector3 corner2 = entry2.mOriginalBBox.getCenterAgent() -
+			mDirection * entry2.mOriginalBBox.getExtentLocal()/2.0;
 
 		
 		return mDirection * corner1.mV[mAxis] < mDirection * corner2.mV[mAxis];
@@ -419,7 +427,6 @@ public:
 
 	S32 mAxis;
 	F32 mDirection;
-	std::map<LLPointer<LLViewerObject>, LLBBox >& mBBoxes;
 };
 
 
@@ -427,9 +434,12 @@ void QToolAlign::align()
 {
 	// no linkset parts, please
 	LLSelectMgr::getInstance()->promoteSelectionToRoot();
+
+	// one undo step for the whole alignment
+	LLSelectMgr::getInstance()->saveSelectedObjectTransform(SELECT_ACTION_TYPE_PICK);
 	
-	std::vector<LLPointer<LLViewerObject> > objects;
-	std::map<LLPointer<LLViewerObject>, LLBBox > original_bboxes;
+	std::vector<AlignEntry> entries;
+	entries.reserve(LLSelectMgr::getInstance()->getSelection()->getRootObjectCount());
 	
     // cycle over the nodes in selection and collect them into an array
 	for (LLObjectSelection::root_iterator selection_iter = LLSelectMgr::getInstance()->getSelection()->root_begin();
@@ -459,8 +469,12 @@ void QToolAlign::align()
 					bbox.addBBoxAgent(child->getBoundingBoxAgent());
 				}
 				
-				objects.push_back(object);
-				original_bboxes[object] = bbox;
+				AlignEntry entry;
+				entry.mObject = object;
+				entry.mOriginalBBox = bbox;
+				// start with original position first
+				entry.mNewBBox = bbox;
+				entries.push_back(entry);
 			}
 		}
 	}
@@ -469,24 +483,20 @@ void QToolAlign::align()
 	F32 direction = mHighlightedDirection;
 
 	// sort them into positional order for proper packing
-	BBoxCompare compare(axis, direction, original_bboxes);
-	sort(objects.begin(), objects.end(), compare);
-
-	// storage for their new position after alignment - start with original position first
-	std::map<LLPointer<LLViewerObject>, LLBBox > new_bboxes = original_bboxes;
+	std::sort(entries.begin(), entries.end(), BBoxCompare(axis, direction));
 
 	// find new positions
-	for (U32 i = 0; i < objects.size(); i++)
+	const LLVector3 first_target_corner = mBBox.getCenterAgent() - 
+		direction * mBBox.getExtentLocal() / 2.0;
+	for (U32 i = 0; i < entries.size(); i++)
 	{
-		LLBBox target_bbox = mBBox;
-		LLVector3 target_corner = target_bbox.getCenterAgent() - 
-			direction * target_bbox.getExtentLocal() / 2.0;
+		LLVector3 target_corner = first_target_corner;
 	
-		LLViewerObject* object = objects[i];
-
-		LLBBox this_bbox = original_bboxes[object];
-		LLVector3 this_corner = this_bbox.getCenterAgent() -
-			direction * this_bbox.getExtentLocal() / 2.0;
+		AlignEntry& entry = entries[i];
+		const LLBBox& this_bbox = entry.mOriginalBBox;
+		const LLVector3 this_center = this_bbox.getCenterAgent();
+		const LLVector3 this_extent = this_bbox.getExtentLocal();
+		LLVector3 this_corner = this_center - direction * this_extent / 2.0;
 
 		// for packing, we cycle over several possible positions, taking the smallest that does not overlap
 		F32 smallest = direction * 9999999;  // 999999 guarenteed not to be the smallest
@@ -499,34 +509,21 @@ void QToolAlign::align()
 			LLVector3 delta_one_axis = LLVector3(0,0,0);
 			delta_one_axis.mV[axis] = delta.mV[axis];
 			
-			LLVector3 new_position = this_bbox.getCenterAgent() + delta_one_axis;
+			LLVector3 new_position = this_center + delta_one_axis;
 
 			// construct the new bbox
 			LLBBox new_bbox = LLBBox(new_position, LLQuaternion(), LLVector3(), LLVector3());
-			new_bbox.addPointLocal(this_bbox.getExtentLocal() / 2.0);
-			new_bbox.addPointLocal(-1.0 * this_bbox.getExtentLocal() / 2.0);
+			new_bbox.addPointLocal(this_extent / 2.0);
+			new_bbox.addPointLocal(-1.0 * this_extent / 2.0);
 
 			// check to see if it overlaps the previously placed objects
 			BOOL overlap = FALSE;
 
-			llwarns << "i=" << i << " j=" << j << llendl;
-			
 			if (!mForce) // well, don't check if in force mode
 			{
-				for (U32 k = 0; k < i; k++)
+				for (U32 k = 0; k < i && !overlap; k++)
 				{
-					LLViewerObject* other_object = objects[k];
-					LLBBox other_bbox = new_bboxes[other_object];
-
-					BOOL overlaps_this = bbox_overlap(other_bbox, new_bbox);
-
-					if (overlaps_this)
-					{
-						llwarns << "overlap" << new_bbox.getCenterAgent() << other_bbox.getCenterAgent() << llendl;
-						llwarns << "extent" << new_bbox.getExtentLocal() << other_bbox.getExtentLocal() << llendl;
-					}
-
-					overlap = (overlap || overlaps_this);
+					overlap = bbox_overlap(entries[k].mNewBBox, new_bbox);
 				}
 			}
 
@@ -539,39 +536,36 @@ void QToolAlign::align()
 				{
 					smallest = this_value;
 					// store it
-					new_bboxes[object] = new_bbox;
+					entry.mNewBBox = new_bbox;
 				}
 			}
 
 			// update target for next time through the loop
-			if (j < objects.size())
-			{
-				LLBBox next_bbox = new_bboxes[objects[j]];
-				target_corner = next_bbox.getCenterAgent() +
-					direction * next_bbox.getExtentLocal() / 2.0;
-			}
+			const LLBBox& next_bbox = entries[j].mNewBBox;
+			target_corner = next_bbox.getCenterAgent() +
+				direction * next_bbox.getExtentLocal() / 2.0;
 		}
 	}
 
 	
-	// now move them
-	for (U32 i = 0; i < objects.size(); i++)
+	// now move them, locally first so they all go out in one update below
+	for (U32 i = 0; i < entries.size(); i++)
 	{
-		LLViewerObject* object = objects[i];
+		const AlignEntry& entry = entries[i];
 
-		LLBBox original_bbox = original_bboxes[object];
-		LLBBox new_bbox = new_bboxes[object];
-
-		LLVector3 delta = new_bbox.getCenterAgent() - original_bbox.getCenterAgent();
+		LLVector3 delta = entry.mNewBBox.getCenterAgent() - entry.mOriginalBBox.getCenterAgent();
+		if (delta.isExactlyZero())
+		{
+			continue;
+		}
 		
-		LLVector3 original_position = object->getPositionAgent();
+		LLVector3 original_position = entry.mObject->getPositionAgent();
 		LLVector3 new_position = original_position + delta;
 
-		object->setPosition(new_position);
+		entry.mObject->setPosition(new_position);
 	}
 	
 	
 	LLSelectMgr::getInstance()->sendMultipleUpdate(UPD_POSITION);
 }
 
-
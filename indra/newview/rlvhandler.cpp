@@ -122,21 +122,18 @@ void RlvHandler::addException(const LLUUID& idObj, ERlvBehaviour eBhvr, const Rl
 // Checked: 2009-10-04 (RLVa-1.0.4c) | Modified: RLVa-1.0.4c
 bool RlvHandler::isException(ERlvBehaviour eBhvr, const RlvExceptionOption& varOption, ERlvExceptionCheck typeCheck) const
 {
+	// Most checks are for behaviours nobody has added an exception to, so don't work out anything else until we know there is one
+	rlv_exception_map_t::const_iterator itException = m_Exceptions.lower_bound(eBhvr), endException = m_Exceptions.upper_bound(eBhvr);
+	if (itException == endException)
+		return false;
+
 	// We need to "strict check" exceptions only if: the restriction is actually in place *and* (isPermissive(eBhvr) == FALSE)
 	if (RLV_CHECK_DEFAULT == typeCheck)
 		typeCheck = ( (hasBehaviour(eBhvr)) && (!isPermissive(eBhvr)) ) ? RLV_CHECK_STRICT : RLV_CHECK_PERMISSIVE;
 
 	uuid_vec_t objList;
-	if (RLV_CHECK_STRICT == typeCheck)
-	{
-		// If we're "strict checking" then we need the UUID of every object that currently has 'eBhvr' restricted
-		for (rlv_object_map_t::const_iterator itObj = m_Objects.begin(); itObj != m_Objects.end(); ++itObj)
-			if (itObj->second.hasBehaviour(eBhvr, !hasBehaviour(RLV_BHVR_PERMISSIVE)))
-				objList.push_back(itObj->first);
-	}
-
-	for (rlv_exception_map_t::const_iterator itException = m_Exceptions.lower_bound(eBhvr), 
-			endException = m_Exceptions.upper_bound(eBhvr); itException != endException; ++itException)
+	bool fHaveObjList = false;
+	for (; itException != endException; ++itException)
 	{
 		if (itException->second.varOption == varOption)
 		{
@@ -144,6 +141,15 @@ bool RlvHandler::isException(ERlvBehaviour eBhvr, const RlvExceptionOption& varO
 			if (RLV_CHECK_PERMISSIVE == typeCheck)
 				return true;
 
+			if (!fHaveObjList)
+			{
+				// If we're "strict checking" then we need the UUID of every object that currently has 'eBhvr' restricted
+				for (rlv_object_map_t::const_iterator itObj = m_Objects.begin(); itObj != m_Objects.end(); ++itObj)
+					if (itObj->second.hasBehaviour(eBhvr, !hasBehaviour(RLV_BHVR_PERMISSIVE)))
+						objList.push_back(itObj->first);
+				fHaveObjList = true;
+			}
+
 			// For strict checks we don't return until the list is empty (every object with 'eBhvr' restricted also contains the exception)
 			uuid_vec_t::iterator itList = std::find(objList.begin(), objList.end(), itException->second.idObject);
 			if (itList != objList.end())
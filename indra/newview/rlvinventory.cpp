@@ -79,6 +79,10 @@ RlvInventory::~RlvInventory()
 // Checked: 2011-03-28 (RLVa-1.3.0g) | Added: RLVa-1.3.0g
 void RlvInventory::changed(U32 mask)
 {
+	// Any folder being added, removed, moved or renamed can change what a shared path resolves to
+	if (mask & (LLInventoryObserver::STRUCTURE | LLInventoryObserver::LABEL | LLInventoryObserver::ADD | LLInventoryObserver::REMOVE))
+		m_SharedPathCache.clear();
+
 	const LLInventoryModel::changed_items_t& idsChanged = gInventory.getChangedIDs();
 	if (std::find(idsChanged.begin(), idsChanged.end(), m_idRlvRoot) != idsChanged.end())
 	{
@@ -86,6 +90,7 @@ void RlvInventory::changed(U32 mask)
 
 		LLUUID idRlvRootPrev = m_idRlvRoot;
 		m_idRlvRoot.setNull();
+		m_SharedPathCache.clear();
 
 		if (idRlvRootPrev != getSharedRootID())
 			m_OnSharedRootIDChanged();
@@ -309,6 +314,16 @@ LLViewerInventoryCategory* RlvInventory::getSharedFolder(const std::string& strP
 	if (!pRlvRoot)
 		return NULL;
 
+	// Force wear/detach bursts resolve the same handful of paths over and over
+	shared_path_map_t::const_iterator itCached = m_SharedPathCache.find(strPath);
+	if (itCached != m_SharedPathCache.end())
+	{
+		if ( (pFolder = gInventory.getCategory(itCached->second)) != NULL )
+			return pFolder;
+		m_SharedPathCache.erase(strPath);
+		pFolder = pRlvRoot;
+	}
+
 	// Walk the path (starting at the root)
 	boost_tokenizer tokens(strPath, boost::char_separator<char>("/", "", boost::drop_empty_tokens));
 	for (boost_tokenizer::const_iterator itToken = tokens.begin(); itToken != tokens.end(); ++itToken)
@@ -318,6 +333,7 @@ LLViewerInventoryCategory* RlvInventory::getSharedFolder(const std::string& strP
 			return NULL;	// No such folder
 	}
 
+	m_SharedPathCache[strPath] = pFolder->getUUID();
 	return pFolder;			// If strPath was empty or just a bunch of //// then: pFolder == pRlvRoot
 }
 
@@ -92,6 +92,8 @@ protected:
 	bool				m_fFetchComplete;			// TRUE if everything was fetched
 	mutable LLUUID		m_idRlvRoot;
 	callback_signal_t	m_OnSharedRootIDChanged;
+	typedef std::map<std::string, LLUUID> shared_path_map_t;
+	mutable shared_path_map_t m_SharedPathCache;	// Resolved shared folder paths (cleared on any folder change)
 
 private:
 	static const std::string cstrSharedRoot;
@@ -780,4 +780,33 @@ ensure("implicit disconnect", ! connection.connected());
 heaptest.post(2);
 #endif // 0
 }
+
+bool disconnect_during_post(LLBoundListener* connection, const LLSD&)
+{
+	connection->disconnect();
+	return false;
+}
+
+template<> template<>
+void events_object::test<17>()
+{
+	set_test_name("listeners changed during post()");
+	LLEventPump& changes(pumps.obtain("changes"));
+	LLBoundListener second;
+	changes.listen("disconnect", boost::bind(disconnect_during_post, &second, _1));
+	second = listener1.listenTo(changes, &Listener::call, make<LLEventPump::NameList>(list_of("disconnect")));
+	listener0.listenTo(changes, &Listener::call, make<LLEventPump::NameList>(list_of(listener1.getName())));
+	listener0.reset(0);
+	listener1.reset(0);
+	changes.post(1);
+	check_listener("called after disconnect", listener0, 1);
+	check_listener("disconnected by earlier listener", listener1, 0);
+	// a listener that handles the event still stops the rest
+	LLEventPump& handled(pumps.obtain("handled"));
+	listener0.listenTo(handled, &Listener::callstop);
+	listener1.listenTo(handled, &Listener::call, make<LLEventPump::NameList>(list_of(listener0.getName())));
+	ensure("post() reports handled", handled.post(2));
+	check_listener("handled", listener0, 2);
+	check_listener("not called after handled", listener1, 0);
+}
 } // namespace tut